@@ -95,6 +95,7 @@ set(OGRE_MEMORY_TRACKER_RELEASE_MODE ${OGRE_CONFIG_MEMTRACK_RELEASE})
 set(OGRE_SET_ASSERT_MODE ${OGRE_ASSERT_MODE})
 set(OGRE_SET_THREADS ${OGRE_CONFIG_THREADS})
 set(OGRE_SET_THREAD_PROVIDER ${OGRE_THREAD_PROVIDER})
+set(OGRE_WORKQUEUE_STEALING ${OGRE_CONFIG_WORKQUEUE_STEALING})
 if (NOT OGRE_CONFIG_ENABLE_MESHLOD)
   set(OGRE_NO_MESHLOD 1)
 endif()
@@ -63,6 +63,9 @@ endif ()
 if (OGRE_BUILD_PLUGIN_BSP)
 	set(_plugins "${_plugins}  + BSP scene manager\n")
 endif ()
+if (OGRE_BUILD_PLUGIN_BVH)
+	set(_plugins "${_plugins}  + BVH scene manager\n")
+endif ()
 if (OGRE_BUILD_PLUGIN_CG)
 	set(_plugins "${_plugins}  + Cg program manager\n")
 endif ()
@@ -114,6 +117,9 @@ endif ()
 if (OGRE_BUILD_TESTS)
 	set(_programs "${_programs}  + Tests\n")
 endif ()
+if (OGRE_BUILD_BENCHMARKS)
+	set(_programs "${_programs}  + Benchmarks\n")
+endif ()
 if (OGRE_BUILD_TOOLS)
 	set(_programs "${_programs}  + Tools\n")
 endif ()
@@ -57,6 +57,7 @@ set(OGRE_CONFIG_THREAD_PROVIDER ${OGRE_THREAD_DEFAULT_PROVIDER} CACHE STRING
 	std   - STL thread library (requires compiler support)."
 )
 set_property(CACHE OGRE_CONFIG_THREAD_PROVIDER PROPERTY STRINGS boost poco tbb std)
+option(OGRE_CONFIG_WORKQUEUE_STEALING "Make Root use the work stealing WorkQueue instead of the provider's default one" FALSE)
 
 # sanitise threading choices
 if (NOT OGRE_CONFIG_THREADS)
@@ -290,6 +290,7 @@ namespace Ogre
         static const uint16 TERRAINGENERALINFO_CHUNK_VERSION;
 
         static const size_t LOD_MORPH_CUSTOM_PARAM;
+        static const size_t SHARED_GRID_OFFSET_CUSTOM_PARAM;
 
         typedef vector<Real>::type RealVector;
 
@@ -564,6 +565,25 @@ namespace Ogre
                 uint16 vdatasize, size_t vertexIncrement, uint16 xoffset, uint16 yoffset, uint16 numSkirtRowsCols, 
                 uint16 skirtRowColSkip) = 0;
 
+            /** Get a shared vertex buffer holding the grid of vertex indexes used
+                instead of vertex data of a given layout, see 
+                TerrainGlobalOptions::setUseSharedGridWhenAvailable.
+            @remarks
+                The buffer has the same vertex layout as the vertex data it replaces,
+                including skirts, so the shared index buffers can be used with it.
+                Each vertex is a short4 of the x / y offset in terrain vertexes from 
+                the start of the vertex data, 1 for skirt vertices or 0 otherwise, 
+                and the LOD level from which the vertex should be morphed. Like the
+                index buffers it is never owned by the caller.
+            @param forTerrain The terrain, which determines when vertices are morphed
+            @param vdatasize The size of the vertex data along one edge
+            @param vertexIncrement The number of terrain vertexes between each vertex
+            @param numSkirtRowsCols Number of rows and columns of skirts
+            @param skirtRowColSkip The number of rows / cols to skip in between skirts
+            */
+            virtual HardwareVertexBufferSharedPtr getSharedGridVertexBuffer(const Terrain* forTerrain, 
+                uint16 vdatasize, uint16 vertexIncrement, uint16 numSkirtRowsCols, uint16 skirtRowColSkip) = 0;
+
             /// Free any buffers we're holding
             virtual void freeAllBuffers() = 0;
 
@@ -579,6 +599,8 @@ namespace Ogre
             HardwareIndexBufferSharedPtr getSharedIndexBuffer(uint16 batchSize, 
                 uint16 vdatasize, size_t vertexIncrement, uint16 xoffset, uint16 yoffset, uint16 numSkirtRowsCols, 
                 uint16 skirtRowColSkip);
+            HardwareVertexBufferSharedPtr getSharedGridVertexBuffer(const Terrain* forTerrain, 
+                uint16 vdatasize, uint16 vertexIncrement, uint16 numSkirtRowsCols, uint16 skirtRowColSkip);
             void freeAllBuffers();
 
             /** 'Warm start' the allocator based on needing x instances of 
@@ -593,6 +615,8 @@ namespace Ogre
             VBufList mFreeDeltaBufList;
             typedef map<uint32, HardwareIndexBufferSharedPtr>::type IBufMap;
             IBufMap mSharedIBufMap;
+            typedef map<uint32, HardwareVertexBufferSharedPtr>::type VBufMap;
+            VBufMap mSharedGridVBufMap;
 
             uint32 hashIndexBuffer(uint16 batchSize, 
                 uint16 vdatasize, size_t vertexIncrement, uint16 xoffset, uint16 yoffset, uint16 numSkirtRowsCols, 
@@ -824,6 +848,18 @@ namespace Ogre
         */
         float getHeightAtWorldPosition(const Vector3& pos) const;
 
+        /** Get the height data for many world positions at once (projecting the
+        points down on to the terrain).
+        @remarks
+            Gives the same heights as getHeightAtWorldPosition, but evaluates several
+            positions together. This can be called from any thread as long as no 
+            parallel write to the heightmap data occurs.
+        @param positions Array of count positions in world space
+        @param count Number of positions
+        @param outHeights Array of count heights to be completed
+        */
+        void getHeightsAtWorldPositions(const Vector3* positions, size_t count, float* outHeights) const;
+
         /** Get a pointer to all the delta data for this terrain.
         @remarks
             The delta data is a measure at a given vertex of by how much vertically
@@ -1526,6 +1562,9 @@ namespace Ogre
 
         /// Whether we're using vertex compression or not
         bool _getUseVertexCompression() const; 
+
+        /// Whether we're rendering from shared grids rather than our own vertex data
+        bool _getUseSharedGrid() const; 
         
         /// WorkQueue::RequestHandler override
         bool canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
@@ -1553,6 +1592,11 @@ namespace Ogre
         /// Get the (global) normal map texture
         TexturePtr getTerrainNormalMap() const { return mTerrainNormalMap; }
 
+        /** Get the height / delta texture, which holds the height (r) and LOD 
+            morph delta (g) of every vertex if shared grid geometry is in use.
+        */
+        TexturePtr getHeightDeltaMap() const { return mHeightDeltaMap; }
+
         /** Retrieve the terrain's neighbour, or null if not present.
         @remarks
             Terrains only know about their neighbours if they are notified via
@@ -1671,6 +1715,9 @@ namespace Ogre
         void createOrDestroyGPUColourMap();
         void createOrDestroyGPULightmap();
         void createOrDestroyGPUCompositeMap();
+        void createOrDestroyGPUHeightDeltaMap();
+        /// Upload heights and deltas to the height / delta texture, if there is one
+        void updateGPUHeightDeltaMap(const Rect& rect);
         void waitForDerivedProcesses();
         void convertSpace(Space inSpace, const Vector3& inVec, Space outSpace, Vector3& outVec, bool translation) const;
         Vector3 convertWorldToTerrainAxes(const Vector3& inVec) const;
@@ -1860,6 +1907,8 @@ namespace Ogre
         bool mCompositeMapRequired;
         /// Texture storing normals for the whole terrrain
         TexturePtr mTerrainNormalMap;
+        /// Texture storing heights and deltas for shared grid geometry
+        TexturePtr mHeightDeltaMap;
 
         /// Pending data 
         PixelBox* mCpuTerrainNormalMap;
@@ -1926,6 +1975,8 @@ namespace Ogre
         Real mCompositeMapDistance;
         String mResourceGroup;
         bool mUseVertexCompressionWhenAvailable;
+        bool mUseSharedGridWhenAvailable;
+        size_t mNumWorkerThreads;
 
     public:
         TerrainGlobalOptions();
@@ -2106,6 +2157,43 @@ namespace Ogre
          */
         void setUseVertexCompressionWhenAvailable(bool enable) { mUseVertexCompressionWhenAvailable = enable; }
 
+        /** Get whether to allow shared grid geometry to be used when the material
+            generator states that it supports it.
+        */
+        bool getUseSharedGridWhenAvailable() const { return mUseSharedGridWhenAvailable; }
+
+        /** Set whether to allow shared grid geometry to be used when the material
+            generator states that it supports it.
+        @remarks
+            In this mode terrains don't build vertex buffers of their own. Every
+            terrain instance using the same GpuBufferAllocator, such as all the 
+            terrains in a TerrainGroup, renders from a few static grids of vertex 
+            indexes, and the vertex program reads heights and morph deltas from a 
+            float texture per terrain (see Terrain::getHeightDeltaMap). This cuts 
+            the GPU memory per terrain to that texture, at the cost of a texture 
+            fetch per vertex, which must be supported by the hardware.
+        @note You should only call this before creating any terrain instances.
+            The default is false.
+        */
+        void setUseSharedGridWhenAvailable(bool enable) { mUseSharedGridWhenAvailable = enable; }
+
+        /** Get the number of threads used to calculate derived data (height deltas, normals 
+            and lightmaps) and batched TerrainGroup queries.
+        */
+        size_t getNumWorkerThreads() const { return mNumWorkerThreads; }
+
+        /** Set the number of threads used to calculate derived data (height deltas, normals
+            and lightmaps) and batched TerrainGroup queries.
+        @remarks
+            The calculation of each derived data update is split over this many
+            threads, on top of the background request it already runs in, and so
+            are large batches of TerrainGroup::getHeightsAtWorldPositions and
+            TerrainGroup::rayIntersects queries.
+            0 (the default) calculates on the requesting thread only. Has no effect
+            if OGRE was built without thread support.
+        */
+        void setNumWorkerThreads(size_t numThreads) { mNumWorkerThreads = numThreads; }
+
         /** Override standard Singleton retrieval.
         @remarks
         Why do we do this? Well, it's because the Singleton
@@ -384,6 +384,8 @@ namespace Ogre
             /// Position at which the intersection occurred
             Vector3 position;
 
+            RayResult()
+                : hit(false), terrain(0), position(Vector3::ZERO) {}
             RayResult(bool _hit, Terrain* _terrain, const Vector3& _pos)
                 : hit(_hit), terrain(_terrain), position(_pos) {}
         };
@@ -416,6 +418,40 @@ namespace Ogre
          the terrain data occurs.
          */
         RayResult rayIntersects(const Ray& ray, Real distanceLimit = 0) const; 
+
+        /** Get the height data for many world positions at once.
+        @remarks
+            Gives the same results as calling getHeightAtWorldPosition for each
+            position, but positions are sorted by terrain slot first so that each
+            terrain is looked up once and resolves all its positions together
+            (@see Terrain::getHeightsAtWorldPositions). Large batches are split over
+            the threads set by TerrainGlobalOptions::setNumWorkerThreads.
+            This can be called from any thread as long as no parallel write to
+            the terrain data occurs.
+        @param positions Array of count positions in world space
+        @param count Number of positions
+        @param outHeights Array of count heights to be completed, 0 where no
+            loaded terrain is found
+        @param outTerrains Optional array of count pointers which will be completed
+            with the terrain that resolved each query, or null if none were
+        */
+        void getHeightsAtWorldPositions(const Vector3* positions, size_t count,
+            float* outHeights, Terrain** outTerrains = 0) const;
+
+        /** Test for intersection of many rays with any terrain in the group.
+        @remarks
+            Gives the same results as calling rayIntersects for each ray. Large 
+            batches are split over the threads set by 
+            TerrainGlobalOptions::setNumWorkerThreads. This can be called from any
+            thread as long as no parallel write to the terrain data occurs.
+        @param rays Array of count rays to test for intersection
+        @param count Number of rays
+        @param outResults Array of count results to be completed
+        @param distanceLimit The distance from the ray origin at which we will stop looking,
+            0 indicates no limit
+        */
+        void rayIntersects(const Ray* rays, size_t count, RayResult* outResults,
+            Real distanceLimit = 0) const;
         
         typedef vector<Terrain*>::type TerrainList; 
         /** Test intersection of a box with the terrain. 
@@ -98,7 +98,12 @@ namespace Ogre
         virtual void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ);
 
         void updateToLodLevel(int lodLevel, bool synchronous = false);
-        /// Save each LOD level separately compressed so seek is possible
+        /** Save each LOD level separately compressed so seek is possible
+          @remarks Each level is split into blocks of values which are delta coded and
+                compressed with a fast LZ coder independently of each other, after an
+                index of the compressed block sizes. Blocks are processed on the
+                terrain worker threads, see TerrainGlobalOptions::setNumWorkerThreads.
+          */
         static void saveLodData(StreamSerialiser& stream, Terrain* terrain);
 
         /** Copy geometry data from buffer to mHeightData/mDeltaData
@@ -111,8 +116,10 @@ namespace Ogre
         /** Read separated geometry data from file into allocated memory
           @param lowerLodBound Lower bound of LOD levels to load
           @param higherLodBound Upper bound of LOD levels to load
-          @remarks Geometry data are uncompressed using inflate() and stored into
-                allocated buffer
+          @remarks Only the chunks of the requested levels are read and decompressed
+                into an allocated buffer. If the stream is a MemoryDataStream, for
+                instance a memory mapped file, blocks are decompressed in place. Data
+                saved with the older format is uncompressed using inflate().
           */
         void readLodData(uint16 lowerLodBound, uint16 higherLodBound);
         void waitForDerivedProcesses();
@@ -130,6 +137,8 @@ namespace Ogre
     private:
         void init();
         void buildLodInfoTable();
+        /// Read the block index and blocks of the current LOD data chunk into data
+        void readLodBlocks(StreamSerialiser& stream, float* data, uint dataSize);
 
         /** Separate geometry data by LOD level
         @param data A geometry data to separate i.e. mHeightData/mDeltaData
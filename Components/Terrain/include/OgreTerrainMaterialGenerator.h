@@ -183,6 +183,8 @@ namespace Ogre
             const String& getDescription() const { return mDesc; }
             /// Compressed vertex format supported?
             virtual bool isVertexCompressionSupported() const = 0;      
+            /// Vertex heights fetched from a texture over shared grid geometry supported?
+            virtual bool isSharedGridSupported() const { return false; }
             /// Generate / reuse a material for the terrain
             virtual MaterialPtr generate(const Terrain* terrain) = 0;
             /// Generate / reuse a material for the terrain
@@ -280,6 +282,15 @@ namespace Ogre
             return getActiveProfile()->isVertexCompressionSupported();
         }
 
+        /** Return whether this material generator supports rendering shared grid
+            geometry, reading heights from Terrain::getHeightDeltaMap in the vertex
+            program. See TerrainGlobalOptions::setUseSharedGridWhenAvailable.
+        */
+        virtual bool isSharedGridSupported() const
+        {
+            return getActiveProfile()->isSharedGridSupported();
+        }
+
         /** Triggers the generator to request the options that it needs.
         */
         virtual void requestOptions(Terrain* terrain)
@@ -69,6 +69,7 @@ namespace Ogre
             void updateParamsForCompositeMap(const MaterialPtr& mat, const Terrain* terrain);
             void requestOptions(Terrain* terrain);
             bool isVertexCompressionSupported() const;
+            bool isSharedGridSupported() const;
 
             /** Whether to support normal mapping per layer in the shader (default true). 
             */
@@ -281,6 +282,8 @@ namespace Ogre
             String mShaderLanguage;
 
             bool isShadowingEnabled(TechniqueType tt, const Terrain* terrain) const;
+            /// Texture unit of the height / delta map used with shared grid geometry
+            uint getHeightDeltaMapUnit(const Terrain* terrain, TechniqueType tt) const;
         };
     };
     /** @} */
@@ -300,11 +300,13 @@ namespace Ogre
             uint16 skirtRowColSkip;
             /// Is the GPU vertex data out of date?
             bool gpuVertexDataDirty;
+            /// Does the GPU vertex data reference a shared grid rather than own its buffers?
+            bool sharedGrid;
 
             VertexDataRecord(uint16 res, uint16 sz, uint16 lvls) 
                 : cpuVertexData(0), gpuVertexData(0), resolution(res), size(sz),
                 treeLevels(lvls), numSkirtRowsCols(0),
-                skirtRowColSkip(0), gpuVertexDataDirty(false) {}
+                skirtRowColSkip(0), gpuVertexDataDirty(false), sharedGrid(false) {}
         };
         
         TerrainQuadTreeNode* mNodeWithVertexData;
@@ -393,6 +395,8 @@ namespace Ogre
             not the local vertex data (which may use a subset)
         */
         void updateVertexBuffer(HardwareVertexBufferSharedPtr& posbuf, HardwareVertexBufferSharedPtr& deltabuf, const Rect& rect);
+        /// Update just the bounds from the height data, when the vertices come from a shared grid
+        void updateBounds(const Rect& rect);
         void destroyCpuVertexData();
 
         void createGpuVertexData();
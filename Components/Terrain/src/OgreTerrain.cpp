@@ -48,6 +48,13 @@ THE SOFTWARE.
 #include "OgreMaterialManager.h"
 #include "OgreTimer.h"
 #include "OgreTerrainMaterialGeneratorA.h"
+#include "OgreTerrainBandJob.h"
+#include "Threading/OgreThreads.h"
+#include "OgrePlatformInformation.h"
+
+#if __OGRE_HAVE_SSE2
+#include <emmintrin.h>
+#endif
 
 #if OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS
 #include "macUtils.h"
@@ -80,6 +87,7 @@ namespace Ogre
     const uint64 Terrain::TERRAIN_GENERATE_MATERIAL_INTERVAL_MS = 400;
     const uint16 Terrain::WORKQUEUE_GENERATE_MATERIAL_REQUEST = 2;
     const size_t Terrain::LOD_MORPH_CUSTOM_PARAM = 1001;
+    const size_t Terrain::SHARED_GRID_OFFSET_CUSTOM_PARAM = 1002;
     const uint8 Terrain::DERIVED_DATA_DELTAS = 1;
     const uint8 Terrain::DERIVED_DATA_NORMALS = 2;
     const uint8 Terrain::DERIVED_DATA_LIGHTMAP = 4;
@@ -115,6 +123,8 @@ namespace Ogre
         , mCompositeMapDistance(4000)
         , mResourceGroup(ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME)
         , mUseVertexCompressionWhenAvailable(true)
+        , mUseSharedGridWhenAvailable(false)
+        , mNumWorkerThreads(0)
     {
     }
     //---------------------------------------------------------------------
@@ -1149,6 +1159,7 @@ namespace Ogre
         createOrDestroyGPUNormalMap();
         createOrDestroyGPULightmap();
         createOrDestroyGPUCompositeMap();
+        createOrDestroyGPUHeightDeltaMap();
         
         mMaterialGenerator->requestOptions(this);
 
@@ -1324,6 +1335,133 @@ namespace Ogre
         return getHeightAtWorldPosition(pos.x, pos.y, pos.z);
     }
     //---------------------------------------------------------------------
+    namespace
+    {
+        /** Height within a quad from its corners, using the same triangles
+            as getHeightAtTerrainPosition.
+        @param h Heights at the bottom left, bottom right, top right and top left corners
+        @param xParam, yParam Position within the quad
+        */
+        inline float interpolateQuadHeight(const float* h, float xParam, float yParam, bool oddRow)
+        {
+            if (oddRow)
+            {
+                if (1.0f - yParam > xParam)
+                    return h[0] + xParam * (h[1] - h[0]) + yParam * (h[3] - h[0]);
+                else
+                    return h[2] + (1.0f - xParam) * (h[3] - h[2]) + (1.0f - yParam) * (h[1] - h[2]);
+            }
+            else
+            {
+                if (yParam > xParam)
+                    return h[0] + xParam * (h[2] - h[3]) + yParam * (h[3] - h[0]);
+                else
+                    return h[0] + xParam * (h[1] - h[0]) + yParam * (h[2] - h[1]);
+            }
+        }
+
+#if __OGRE_HAVE_SSE2
+        inline __m128 select(__m128 mask, __m128 a, __m128 b)
+        {
+            return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+        }
+#endif
+    }
+    //---------------------------------------------------------------------
+    void Terrain::getHeightsAtWorldPositions(const Vector3* positions, size_t count, float* outHeights) const
+    {
+        if (mLodManager->getHighestLodPrepared() > 0)
+        {
+            // only some of the heights are available, see getHeightAtPoint
+            for (size_t i = 0; i < count; ++i)
+                outHeights[i] = getHeightAtWorldPosition(positions[i]);
+            return;
+        }
+
+        const float factor = static_cast<float>(mSize - 1);
+        const long maxIndex = mSize - 1;
+        size_t i = 0;
+#if __OGRE_HAVE_SSE2
+        // Heights are looked up one by one, but 4 positions at a time are
+        // interpolated together
+        for (; i + 4 <= count; i += 4)
+        {
+            OGRE_ALIGNED_DECL(float, gridX[4], 16);
+            OGRE_ALIGNED_DECL(float, gridY[4], 16);
+            OGRE_ALIGNED_DECL(int32, startX[4], 16);
+            OGRE_ALIGNED_DECL(int32, startY[4], 16);
+            OGRE_ALIGNED_DECL(float, h[4][4], 16);
+            for (int j = 0; j < 4; ++j)
+            {
+                Vector3 terrainPos;
+                getTerrainPosition(positions[i + j], &terrainPos);
+                gridX[j] = static_cast<float>(terrainPos.x) * factor;
+                gridY[j] = static_cast<float>(terrainPos.y) * factor;
+            }
+            __m128 x = _mm_load_ps(gridX);
+            __m128 y = _mm_load_ps(gridY);
+            __m128i sx = _mm_cvttps_epi32(x);
+            __m128i sy = _mm_cvttps_epi32(y);
+            _mm_store_si128(reinterpret_cast<__m128i*>(startX), sx);
+            _mm_store_si128(reinterpret_cast<__m128i*>(startY), sy);
+            for (int j = 0; j < 4; ++j)
+            {
+                long x0 = Math::Clamp<long>(startX[j], 0, maxIndex);
+                long x1 = Math::Clamp<long>(startX[j] + 1, 0, maxIndex);
+                long y0 = Math::Clamp<long>(startY[j], 0, maxIndex) * mSize;
+                long y1 = Math::Clamp<long>(startY[j] + 1, 0, maxIndex) * mSize;
+                h[0][j] = mHeightData[y0 + x0];
+                h[1][j] = mHeightData[y0 + x1];
+                h[2][j] = mHeightData[y1 + x1];
+                h[3][j] = mHeightData[y1 + x0];
+            }
+
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 h0 = _mm_load_ps(h[0]);
+            const __m128 h1 = _mm_load_ps(h[1]);
+            const __m128 h2 = _mm_load_ps(h[2]);
+            const __m128 h3 = _mm_load_ps(h[3]);
+            const __m128 xParam = _mm_sub_ps(x, _mm_cvtepi32_ps(sx));
+            const __m128 yParam = _mm_sub_ps(y, _mm_cvtepi32_ps(sy));
+            const __m128 invXParam = _mm_sub_ps(one, xParam);
+            const __m128 invYParam = _mm_sub_ps(one, yParam);
+
+            // see interpolateQuadHeight
+            __m128 evenFirst = _mm_add_ps(h0, _mm_add_ps(
+                _mm_mul_ps(xParam, _mm_sub_ps(h2, h3)), _mm_mul_ps(yParam, _mm_sub_ps(h3, h0))));
+            __m128 evenSecond = _mm_add_ps(h0, _mm_add_ps(
+                _mm_mul_ps(xParam, _mm_sub_ps(h1, h0)), _mm_mul_ps(yParam, _mm_sub_ps(h2, h1))));
+            __m128 oddFirst = _mm_add_ps(h0, _mm_add_ps(
+                _mm_mul_ps(xParam, _mm_sub_ps(h1, h0)), _mm_mul_ps(yParam, _mm_sub_ps(h3, h0))));
+            __m128 oddSecond = _mm_add_ps(h2, _mm_add_ps(
+                _mm_mul_ps(invXParam, _mm_sub_ps(h3, h2)), _mm_mul_ps(invYParam, _mm_sub_ps(h1, h2))));
+
+            __m128 even = select(_mm_cmpgt_ps(yParam, xParam), evenFirst, evenSecond);
+            __m128 odd = select(_mm_cmpgt_ps(invYParam, xParam), oddFirst, oddSecond);
+            __m128 oddRow = _mm_castsi128_ps(_mm_cmpeq_epi32(
+                _mm_and_si128(sy, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+            _mm_storeu_ps(outHeights + i, select(oddRow, odd, even));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            Vector3 terrainPos;
+            getTerrainPosition(positions[i], &terrainPos);
+            float x = static_cast<float>(terrainPos.x) * factor;
+            float y = static_cast<float>(terrainPos.y) * factor;
+            long startX = static_cast<long>(x);
+            long startY = static_cast<long>(y);
+
+            long x0 = Math::Clamp<long>(startX, 0, maxIndex);
+            long x1 = Math::Clamp<long>(startX + 1, 0, maxIndex);
+            long y0 = Math::Clamp<long>(startY, 0, maxIndex) * mSize;
+            long y1 = Math::Clamp<long>(startY + 1, 0, maxIndex) * mSize;
+            float h[4] = { mHeightData[y0 + x0], mHeightData[y0 + x1],
+                mHeightData[y1 + x1], mHeightData[y1 + x0] };
+            outHeights[i] = interpolateQuadHeight(h, x - startX, y - startY, (startY & 1) != 0);
+        }
+    }
+    //---------------------------------------------------------------------
     const float* Terrain::getDeltaData() const
     {
         return mDeltaData;
@@ -1920,6 +2058,7 @@ namespace Ogre
         if (!mDirtyGeometryRect.isNull())
         {
             mQuadTree->updateVertexData(true, false, mDirtyGeometryRect, false);
+            updateGPUHeightDeltaMap(mDirtyGeometryRect);
             mDirtyGeometryRect.setNull();
         }
 
@@ -1932,6 +2071,7 @@ namespace Ogre
         if (!mDirtyGeometryRect.isNull())
         {
             mQuadTree->updateVertexData(true, false, mDirtyGeometryRect, false);
+            updateGPUHeightDeltaMap(mDirtyGeometryRect);
             mDirtyGeometryRect.setNull();
         }
     }
@@ -2062,6 +2202,12 @@ namespace Ogre
                 tmgr->remove(mCompositeMap->getHandle());
                 mCompositeMap.setNull();
             }
+
+            if (!mHeightDeltaMap.isNull())
+            {
+                tmgr->remove(mHeightDeltaMap->getHandle());
+                mHeightDeltaMap.setNull();
+            }
         }
 
         if (!mMaterial.isNull())
@@ -2087,6 +2233,156 @@ namespace Ogre
         }
     }
     //---------------------------------------------------------------------
+#if OGRE_THREAD_SUPPORT
+    namespace
+    {
+        unsigned long terrainBandThread(ThreadHandle* threadHandle)
+        {
+            static_cast<TerrainBandJob*>(threadHandle->getUserParam())->processBand(
+                threadHandle->getThreadIdx());
+            return 0;
+        }
+        THREAD_DECLARE(terrainBandThread)
+    }
+#endif
+    //---------------------------------------------------------------------
+    void runTerrainBands(TerrainBandJob& job, size_t maxBands)
+    {
+        job.numBands = std::max<size_t>(1, std::min<size_t>(
+            TerrainGlobalOptions::getSingleton().getNumWorkerThreads(), maxBands));
+#if OGRE_THREAD_SUPPORT
+        if (job.numBands > 1)
+        {
+            ThreadHandleVec threads;
+            for (size_t i = 1; i < job.numBands; ++i)
+            {
+                threads.push_back(
+                    Threads::CreateThread(THREAD_GET(terrainBandThread), i, &job));
+            }
+            // The calling thread takes the first band
+            job.processBand(0);
+            Threads::WaitForThreads(threads);
+            return;
+        }
+#endif
+        for (size_t i = 0; i < job.numBands; ++i)
+            job.processBand(i);
+    }
+    //---------------------------------------------------------------------
+    namespace
+    {
+        /** Height deltas of a single LOD level.
+        @remarks
+            Quadtree nodes start and end on multiples of the maximum batch size, so
+            vertices sharing a 'bucket' (the same span between two of those
+            boundaries, or the same boundary) are in exactly the same nodes. Each band
+            keeps the worst delta per bucket, and the quadtree is told about those
+            afterwards on the calling thread, rather than once per vertex.
+        */
+        struct HeightDeltaJob : public TerrainBandJob
+        {
+            const float* heights;
+            float* deltas;
+            long size;
+            Rect lodRect;
+            long step;
+            /// Bucket index of each vertex coordinate
+            const vector<long>::type* buckets;
+            long bucketsPerSide;
+            /// Worst delta per bucket, one list per band
+            vector<Real>::type* bucketDeltas;
+
+            long getNumCellRows() const { return (lodRect.bottom - lodRect.top) / step - 1; }
+
+            void processBand(size_t band)
+            {
+                const long numCellRows = getNumCellRows();
+                const long firstRow = static_cast<long>(band * numCellRows / numBands);
+                const long lastRow = static_cast<long>((band + 1) * numCellRows / numBands);
+                const long halfStep = step / 2;
+                const Real invStep = 1.0f / step;
+                Real* worst = &bucketDeltas[band][0];
+                const long* bucket = &(*buckets)[0];
+
+                for (long j = lodRect.top + firstRow * step; j < lodRect.top + lastRow * step; j += step)
+                {
+                    // Odd or even in terms of target level, see calculateHeightDeltas
+                    const bool backwardTri = (j / step) % 2 != 0;
+                    // include the bottommost row of vertices if this is the last row
+                    const long yubound = (j == (size - step)? step : step - 1);
+                    for (long y = 0; y <= yubound; ++y)
+                    {
+                        const long fulldetaily = j + y;
+                        const Real ypct = y * invStep;
+                        const bool removedRow = (fulldetaily % step) == halfStep;
+                        const bool halfStepRow = (fulldetaily % halfStep) == 0;
+                        Real* worstRow = worst + bucket[fulldetaily] * bucketsPerSide;
+                        const float* actualRow = heights + fulldetaily * size;
+                        float* deltaRow = deltas + fulldetaily * size;
+
+                        for (long i = lodRect.left; i < lodRect.right - step; i += step)
+                        {
+                            const Real h0 = heights[j * size + i];
+                            const Real h1 = heights[j * size + i + step];
+                            const Real h2 = heights[(j + step) * size + i];
+                            const Real h3 = heights[(j + step) * size + i + step];
+
+                            // Height along the lower detail tris, at x = 0 and its
+                            // change per vertex for both halves of the cell
+                            Real firstBase, firstSlope, secondBase, secondSlope;
+                            long split;
+                            if (backwardTri)
+                            {
+                                // 0,1,2 up to the diagonal, 1,3,2 beyond
+                                firstBase = h0 + ypct * (h2 - h0);
+                                firstSlope = (h1 - h0) * invStep;
+                                secondBase = h2 + (1 - ypct) * (h1 - h3);
+                                secondSlope = (h3 - h2) * invStep;
+                                split = step - y;
+                            }
+                            else
+                            {
+                                // 0,3,2 up to the diagonal, 0,1,3 beyond
+                                firstBase = h0 + ypct * (h2 - h0);
+                                firstSlope = (h3 - h2) * invStep;
+                                secondBase = h0 + ypct * (h3 - h1);
+                                secondSlope = (h1 - h0) * invStep;
+                                split = y;
+                            }
+
+                            // include the rightmost col of vertices if this is the last col
+                            const long xubound = (i == (size - step)? step : step - 1);
+                            for (long x = 0; x <= xubound; ++x)
+                            {
+                                const long fulldetailx = i + x;
+                                if ((x == 0 || x == step) && (y == 0 || y == step))
+                                {
+                                    // Skip, this one is a vertex at this level
+                                    continue;
+                                }
+
+                                Real interp_h = x > split ?
+                                    secondBase + x * secondSlope : firstBase + x * firstSlope;
+                                Real delta = interp_h - actualRow[fulldetailx];
+
+                                Real& w = worstRow[bucket[fulldetailx]];
+                                w = std::max(w, delta);
+
+                                // Vertices removed at this LOD are halfway between
+                                // the steps, save the move they will need to make
+                                if (((fulldetailx % step) == halfStep && halfStepRow) ||
+                                    (removedRow && (fulldetailx % halfStep) == 0))
+                                {
+                                    deltaRow[fulldetailx] = delta;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        };
+    }
+    //---------------------------------------------------------------------
     Rect Terrain::calculateHeightDeltas(const Rect& rect)
     {
         Rect clampedRect(rect);
@@ -2099,13 +2395,31 @@ namespace Ogre
 
         mQuadTree->preDeltaCalculation(clampedRect);
 
+        // Vertices on a node boundary get even buckets, those between two
+        // boundaries odd ones
+        const long bucketStride = mMaxBatchSize - 1;
+        const long bucketsPerSide = 2 * ((mSize - 1) / bucketStride) + 1;
+        vector<long>::type buckets(mSize);
+        for (long i = 0; i < mSize; ++i)
+            buckets[i] = 2 * (i / bucketStride) + (i % bucketStride ? 1 : 0);
+
+        const Real noDelta = -std::numeric_limits<Real>::max();
+        size_t maxBands = std::max<size_t>(1, TerrainGlobalOptions::getSingleton().getNumWorkerThreads());
+        vector<vector<Real>::type >::type bucketDeltas(maxBands);
+
+        HeightDeltaJob job;
+        job.heights = mHeightData;
+        job.deltas = mDeltaData;
+        job.size = mSize;
+        job.buckets = &buckets;
+        job.bucketsPerSide = bucketsPerSide;
+        job.bucketDeltas = &bucketDeltas[0];
+
         /// Iterate over target levels, 
         for (int targetLevel = 1; targetLevel < mNumLodLevels; ++targetLevel)
         {
             int sourceLevel = targetLevel - 1;
             int step = 1 << targetLevel;
-            // The step of the next higher LOD
-//          int higherstep = step >> 1;
 
             // need to widen the dirty rectangle since change will affect surrounding
             // vertices at lower LOD
@@ -2129,113 +2443,48 @@ namespace Ogre
             if (lodRect.bottom % step)
                 lodRect.bottom += step - (lodRect.bottom % step);
 
-            for (long j = lodRect.top; j < lodRect.bottom - step; j += step )
-            {
-                for (long i = lodRect.left; i < lodRect.right - step; i += step )
-                {
-                    // Form planes relating to the lower detail tris to be produced
-                    // For even tri strip rows, they are this shape:
-                    // 2---3
-                    // | / |
-                    // 0---1
-                    // For odd tri strip rows, they are this shape:
-                    // 2---3
-                    // | \ |
-                    // 0---1
-
-                    Vector3 v0, v1, v2, v3;
-                    getPointAlign(i, j, ALIGN_X_Y, &v0);
-                    getPointAlign(i + step, j, ALIGN_X_Y, &v1);
-                    getPointAlign(i, j + step, ALIGN_X_Y, &v2);
-                    getPointAlign(i + step, j + step, ALIGN_X_Y, &v3);
-
-                    Plane t1, t2;
-                    bool backwardTri = false;
-                    // Odd or even in terms of target level
-                    if ((j / step) % 2 == 0)
-                    {
-                        t1.redefine(v0, v1, v3);
-                        t2.redefine(v0, v3, v2);
-                    }
-                    else
-                    {
-                        t1.redefine(v1, v3, v2);
-                        t2.redefine(v0, v1, v2);
-                        backwardTri = true;
-                    }
-
-                    // include the bottommost row of vertices if this is the last row
-                    int yubound = (j == (mSize - step)? step : step - 1);
-                    for ( int y = 0; y <= yubound; y++ )
-                    {
-                        // include the rightmost col of vertices if this is the last col
-                        int xubound = (i == (mSize - step)? step : step - 1);
-                        for ( int x = 0; x <= xubound; x++ )
-                        {
-                            int fulldetailx = static_cast<int>(i + x);
-                            int fulldetaily = static_cast<int>(j + y);
-                            if ( fulldetailx % step == 0 && 
-                                fulldetaily % step == 0 )
-                            {
-                                // Skip, this one is a vertex at this level
-                                continue;
-                            }
-
-                            Real ypct = (Real)y / (Real)step;
-                            Real xpct = (Real)x / (Real)step;
-
-                            //interpolated height
-                            Vector3 actualPos;
-                            getPointAlign(fulldetailx, fulldetaily, ALIGN_X_Y, &actualPos);
-                            Real interp_h;
-                            // Determine which tri we're on 
-                            if ((xpct > ypct && !backwardTri) ||
-                                (xpct > (1-ypct) && backwardTri))
-                            {
-                                // Solve for x/z
-                                interp_h = 
-                                    (-t1.normal.x * actualPos.x
-                                    - t1.normal.y * actualPos.y
-                                    - t1.d) / t1.normal.z;
-                            }
-                            else
-                            {
-                                // Second tri
-                                interp_h = 
-                                    (-t2.normal.x * actualPos.x
-                                    - t2.normal.y * actualPos.y
-                                    - t2.d) / t2.normal.z;
-                            }
-
-                            Real actual_h = actualPos.z;
-                            Real delta = interp_h - actual_h;
-
-                            // max(delta) is the worst case scenario at this LOD
-                            // compared to the original heightmap
-
-                            // tell the quadtree about this 
-                            mQuadTree->notifyDelta(fulldetailx, fulldetaily, sourceLevel, delta);
-
-
-                            // If this vertex is being removed at this LOD, 
-                            // then save the height difference since that's the move
-                            // it will need to make. Vertices to be removed at this LOD
-                            // are halfway between the steps, but exclude those that
-                            // would have been eliminated at earlier levels
-                            int halfStep = step / 2;
-                            if (
-                             ((fulldetailx % step) == halfStep && (fulldetaily % halfStep) == 0) ||
-                             ((fulldetaily % step) == halfStep && (fulldetailx % halfStep) == 0))
-                            {
-                                // Save height difference 
-                                mDeltaData[fulldetailx + (fulldetaily * mSize)] = delta;
-                            }
+            // Form planes relating to the lower detail tris to be produced
+            // For even tri strip rows, they are this shape:
+            // 2---3
+            // | / |
+            // 0---1
+            // For odd tri strip rows, they are this shape:
+            // 2---3
+            // | \ |
+            // 0---1
+            // and measure how far each full detail vertex is from them
+            job.lodRect = lodRect;
+            job.step = step;
+            long numCellRows = job.getNumCellRows();
+            if (numCellRows <= 0)
+                continue;
+            for (size_t b = 0; b < maxBands; ++b)
+                bucketDeltas[b].assign(bucketsPerSide * bucketsPerSide, noDelta);
 
-                        }
+            runTerrainBands(job, numCellRows);
 
-                    }
-                } // i
-            } // j
+            // max(delta) is the worst case scenario at this LOD
+            // compared to the original heightmap, tell the quadtree about it
+            vector<Real>::type& worst = bucketDeltas[0];
+            for (size_t b = 1; b < job.numBands; ++b)
+            {
+                for (size_t i = 0; i < worst.size(); ++i)
+                    worst[i] = std::max(worst[i], bucketDeltas[b][i]);
+            }
+            for (long by = 0; by < bucketsPerSide; ++by)
+            {
+                for (long bx = 0; bx < bucketsPerSide; ++bx)
+                {
+                    Real delta = worst[by * bucketsPerSide + bx];
+                    if (delta == noDelta)
+                        continue;
+                    // any vertex in the bucket will do
+                    mQuadTree->notifyDelta(
+                        static_cast<uint16>((bx / 2) * bucketStride + bx % 2),
+                        static_cast<uint16>((by / 2) * bucketStride + by % 2),
+                        sourceLevel, delta);
+                }
+            }
 
         } // targetLevel
 
@@ -2258,6 +2507,9 @@ namespace Ogre
         mQuadTree->finaliseDeltaValues(clampedRect);
         // delta vertex data
         mQuadTree->updateVertexData(false, true, clampedRect, cpuData);
+        // or the texture shared grids read them from
+        if (!cpuData)
+            updateGPUHeightDeltaMap(clampedRect);
 
     }
 
@@ -2340,6 +2592,27 @@ namespace Ogre
         }
     }
     //---------------------------------------------------------------------
+    namespace
+    {
+        /// Distance along a ray from a point inside a square to where it leaves it
+        Real getRayExitDistance(const Vector3& origin, const Vector3& dir,
+            long left, long top, long size, Real noExit)
+        {
+            Real xDist = Math::RealEqual(dir.x, 0.0) ? noExit :
+                ((dir.x > 0 ? left + size : left) - origin.x) / dir.x;
+            Real zDist = Math::RealEqual(dir.z, 0.0) ? noExit :
+                ((dir.z > 0 ? top + size : top) - origin.z) / dir.z;
+            return std::max<Real>(0, std::min(xDist, zDist));
+        }
+
+        /// Whether the heights of a ray between two points, widened by margin, overlap a range
+        bool rayHeightsOverlap(Real from, Real to, Real margin, Real minHeight, Real maxHeight)
+        {
+            return std::min(from, to) - margin <= maxHeight + 1e-3f &&
+                std::max(from, to) + margin >= minHeight - 1e-3f;
+        }
+    }
+    //---------------------------------------------------------------------
     std::pair<bool, Vector3> Terrain::rayIntersects(const Ray& ray, 
         bool cascadeToNeighbours /* = false */, Real distanceLimit /* = 0 */)
     {
@@ -2414,24 +2687,65 @@ namespace Ogre
         int xDir = (rayDirection.x < 0 ? -1 : 1);
         int zDir = (rayDirection.z < 0 ? -1 : 1);
 
-        Result result(true, Vector3::ZERO);
+        Result result(false, Vector3::ZERO);
         Real dummyHighValue = (Real)mSize * 10000.0f;
 
+        // Quads may report hits a little outside their bounds (see
+        // checkQuadIntersection), so ray and height ranges tested against
+        // quads and leaf nodes are widened to match
+        Real boundsMargin = 0.02f / std::max(std::max(Math::Abs(rayDirection.x),
+            Math::Abs(rayDirection.z)), (Real)1e-6f) * Math::Abs(rayDirection.y);
+        // Quadtree leaf the current quad is in, and whether the ray crosses it
+        // without getting between its lowest and highest points
+        long leafSize = mMaxBatchSize - 1;
+        long leafX = -1, leafZ = -1;
+        bool leafMissed = false;
 
         while (cur.y >= (minHeight - 1e-3) && cur.y <= (maxHeight + 1e-3))
         {
             if (quadX < 0 || quadX >= (int)mSize-1 || quadZ < 0 || quadZ >= (int)mSize-1)
                 break;
 
-            result = checkQuadIntersection(quadX, quadZ, localRay);
-            if (result.first)
-                break;
+            if (quadX / leafSize != leafX || quadZ / leafSize != leafZ)
+            {
+                leafX = quadX / leafSize;
+                leafZ = quadZ / leafSize;
+                const TerrainQuadTreeNode* leaf = mQuadTree;
+                while (!leaf->isLeaf())
+                {
+                    leaf = leaf->getChild((quadX >= leaf->getChild(1)->getXOffset() ? 1 : 0) +
+                        (quadZ >= leaf->getChild(2)->getYOffset() ? 2 : 0));
+                }
+                Real exitDist = getRayExitDistance(cur, rayDirection,
+                    leafX * leafSize, leafZ * leafSize, leafSize, dummyHighValue);
+                Real extrapolation = (leaf->getMaxHeight() - leaf->getMinHeight()) * 0.02f;
+                leafMissed = !rayHeightsOverlap(cur.y, cur.y + rayDirection.y * exitDist, boundsMargin,
+                    leaf->getMinHeight() - extrapolation, leaf->getMaxHeight() + extrapolation);
+            }
 
             // determine next quad to test
             Real xDist = Math::RealEqual(rayDirection.x, 0.0) ? dummyHighValue : 
                 (quadX - cur.x + flipX) / rayDirection.x;
             Real zDist = Math::RealEqual(rayDirection.z, 0.0) ? dummyHighValue : 
                 (quadZ - cur.z + flipZ) / rayDirection.z;
+
+            if (!leafMissed)
+            {
+                // only build the planes if the ray gets near the quad's heights
+                const float* h0 = getHeightData(quadX, quadZ);
+                const float* h1 = h0 + mSize;
+                Real minQuad = std::min(std::min(h0[0], h0[1]), std::min(h1[0], h1[1]));
+                Real maxQuad = std::max(std::max(h0[0], h0[1]), std::max(h1[0], h1[1]));
+                Real extrapolation = (maxQuad - minQuad) * 0.02f;
+                if (rayHeightsOverlap(cur.y, cur.y + rayDirection.y * std::min(xDist, zDist),
+                    boundsMargin, minQuad - extrapolation, maxQuad + extrapolation))
+                {
+                    result = checkQuadIntersection(quadX, quadZ, localRay);
+                    if (result.first)
+                        break;
+                }
+            }
+
             if (xDist < zDist)
             {
                 quadX += xDir;
@@ -3004,6 +3318,72 @@ namespace Ogre
             mTerrainNormalMap.setNull();
         }
 
+    }
+    //---------------------------------------------------------------------
+    void Terrain::createOrDestroyGPUHeightDeltaMap()
+    {
+        bool required = _getUseSharedGrid();
+        if (required && !mHeightDeltaMap.isNull() && mHeightDeltaMap->getWidth() != mSize)
+        {
+            // size changed
+            TextureManager::getSingleton().remove(mHeightDeltaMap->getHandle());
+            mHeightDeltaMap.setNull();
+        }
+
+        if (required && mHeightDeltaMap.isNull())
+        {
+            // create
+            mHeightDeltaMap = TextureManager::getSingleton().createManual(
+                mMaterialName + "/hd", _getDerivedResourceGroup(), 
+                TEX_TYPE_2D, mSize, mSize, 0, PF_FLOAT32_GR, TU_STATIC);
+
+            updateGPUHeightDeltaMap(Rect(0, 0, mSize, mSize));
+        }
+        else if (!required && !mHeightDeltaMap.isNull())
+        {
+            // destroy
+            TextureManager::getSingleton().remove(mHeightDeltaMap->getHandle());
+            mHeightDeltaMap.setNull();
+        }
+
+    }
+    //---------------------------------------------------------------------
+    void Terrain::updateGPUHeightDeltaMap(const Rect& rect)
+    {
+        if (mHeightDeltaMap.isNull())
+            return;
+
+        Rect clampedRect(rect);
+        clampedRect.left = std::max(0L, clampedRect.left);
+        clampedRect.top = std::max(0L, clampedRect.top);
+        clampedRect.right = std::min((long)mSize, clampedRect.right);
+        clampedRect.bottom = std::min((long)mSize, clampedRect.bottom);
+        if (clampedRect.width() <= 0 || clampedRect.height() <= 0)
+            return;
+
+        // Interleave into r = height, g = delta; row 0 of the texture is y = 0
+        // in terrain space, the same as the height data
+        size_t width = clampedRect.width();
+        size_t height = clampedRect.height();
+        float* pData = OGRE_ALLOC_T(float, width * height * 2, MEMCATEGORY_GENERAL);
+        float* pOut = pData;
+        for (long y = clampedRect.top; y < clampedRect.bottom; ++y)
+        {
+            const float* pHeight = getHeightData(clampedRect.left, y);
+            const float* pDelta = getDeltaData(clampedRect.left, y);
+            for (size_t x = 0; x < width; ++x)
+            {
+                *pOut++ = *pHeight++;
+                *pOut++ = *pDelta++;
+            }
+        }
+
+        PixelBox src(width, height, 1, PF_FLOAT32_GR, pData);
+        Image::Box dstBox(clampedRect.left, clampedRect.top, clampedRect.right, clampedRect.bottom);
+        mHeightDeltaMap->getBuffer()->blitFromMemory(src, dstBox);
+
+        OGRE_FREE(pData, MEMCATEGORY_GENERAL);
+
     }
     //---------------------------------------------------------------------
     void Terrain::freeTemporaryResources()
@@ -3123,6 +3503,12 @@ namespace Ogre
             TerrainGlobalOptions::getSingleton().getUseVertexCompressionWhenAvailable();
     }
     //---------------------------------------------------------------------
+    bool Terrain::_getUseSharedGrid() const
+    {
+        return TerrainGlobalOptions::getSingleton().getUseSharedGridWhenAvailable() &&
+            mMaterialGenerator->isSharedGridSupported();
+    }
+    //---------------------------------------------------------------------
     bool Terrain::canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
     {
         if(req->getType()==WORKQUEUE_DERIVED_DATA_REQUEST)
@@ -3331,6 +3717,186 @@ namespace Ogre
         return currentLod;
     }
     //---------------------------------------------------------------------
+    namespace
+    {
+        /// Add the unit normal of one of the tris around a vertex
+        inline void addNormal(float nx, float ny, float nz, float& sumx, float& sumy, float& sumz)
+        {
+            float invLength = 1.0f / std::sqrt(nx * nx + ny * ny + nz * nz);
+            sumx += nx * invLength;
+            sumy += ny * invLength;
+            sumz += nz * invLength;
+        }
+
+#if __OGRE_HAVE_SSE2
+        inline void addNormal(__m128 nx, __m128 ny, __m128 nz, __m128& sumx, __m128& sumy, __m128& sumz)
+        {
+            __m128 invLength = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), _mm_mul_ps(nz, nz))));
+            sumx = _mm_add_ps(sumx, _mm_mul_ps(nx, invLength));
+            sumy = _mm_add_ps(sumy, _mm_mul_ps(ny, invLength));
+            sumz = _mm_add_ps(sumz, _mm_mul_ps(nz, invLength));
+        }
+#endif
+
+        /// Normals of a rectangle of terrain vertices, encoded as RGB
+        struct NormalMapJob : public TerrainBandJob
+        {
+            const Terrain* terrain;
+            const float* heights;
+            long size;
+            float scale;
+            Rect rect;
+            uint8* data;
+
+            /// Encode as RGB, object space, inverting Y to deal with image space
+            void store(long x, long y, const Vector3& normal)
+            {
+                uint8* pStore = data + (((rect.bottom - y - 1) * rect.width()) + x - rect.left) * 3;
+                *pStore++ = static_cast<uint8>((normal.x + 1.0f) * 0.5f * 255.0f);
+                *pStore++ = static_cast<uint8>((normal.y + 1.0f) * 0.5f * 255.0f);
+                *pStore++ = static_cast<uint8>((normal.z + 1.0f) * 0.5f * 255.0f);
+            }
+
+            /// Normal from positions, which may come from neighbouring terrains
+            void calculateEdgeNormal(long x, long y)
+            {
+                // Build points to sample
+                Vector3 centrePoint;
+                Vector3 adjacentPoints[8];
+                terrain->getPointFromSelfOrNeighbour(x  , y,   &centrePoint);
+                terrain->getPointFromSelfOrNeighbour(x+1, y,   &adjacentPoints[0]);
+                terrain->getPointFromSelfOrNeighbour(x+1, y+1, &adjacentPoints[1]);
+                terrain->getPointFromSelfOrNeighbour(x,   y+1, &adjacentPoints[2]);
+                terrain->getPointFromSelfOrNeighbour(x-1, y+1, &adjacentPoints[3]);
+                terrain->getPointFromSelfOrNeighbour(x-1, y,   &adjacentPoints[4]);
+                terrain->getPointFromSelfOrNeighbour(x-1, y-1, &adjacentPoints[5]);
+                terrain->getPointFromSelfOrNeighbour(x,   y-1, &adjacentPoints[6]);
+                terrain->getPointFromSelfOrNeighbour(x+1, y-1, &adjacentPoints[7]);
+
+                Plane plane;
+                Vector3 cumulativeNormal = Vector3::ZERO;
+                for (int i = 0; i < 8; ++i)
+                {
+                    plane.redefine(centrePoint, adjacentPoints[i], adjacentPoints[(i+1)%8]);
+                    cumulativeNormal += plane.normal;
+                }
+
+                // normalise & store normal
+                cumulativeNormal.normalise();
+                store(x, y, cumulativeNormal);
+            }
+
+            /** Normal of a vertex whose neighbours are all in this terrain.
+            @remarks
+                In terrain space the tris share the centre point and are laid
+                out on a regular grid, so only the height differences vary and
+                the normal of each tri works out as below.
+            */
+            void calculateInnerNormals(long xbegin, long xend, long y)
+            {
+                const float* below = heights + (y - 1) * size;
+                const float* centre = heights + y * size;
+                const float* above = heights + (y + 1) * size;
+                long x = xbegin;
+#if __OGRE_HAVE_SSE2
+                const __m128 nz = _mm_set1_ps(scale);
+                for (; x + 4 <= xend; x += 4)
+                {
+                    const __m128 p = _mm_loadu_ps(centre + x);
+                    const __m128 c0 = _mm_sub_ps(_mm_loadu_ps(centre + x + 1), p);
+                    const __m128 c1 = _mm_sub_ps(_mm_loadu_ps(above + x + 1), p);
+                    const __m128 c2 = _mm_sub_ps(_mm_loadu_ps(above + x), p);
+                    const __m128 c3 = _mm_sub_ps(_mm_loadu_ps(above + x - 1), p);
+                    const __m128 c4 = _mm_sub_ps(_mm_loadu_ps(centre + x - 1), p);
+                    const __m128 c5 = _mm_sub_ps(_mm_loadu_ps(below + x - 1), p);
+                    const __m128 c6 = _mm_sub_ps(_mm_loadu_ps(below + x), p);
+                    const __m128 c7 = _mm_sub_ps(_mm_loadu_ps(below + x + 1), p);
+                    const __m128 zero = _mm_setzero_ps();
+
+                    __m128 sumx = zero, sumy = zero, sumz = zero;
+                    addNormal(_mm_sub_ps(zero, c0), _mm_sub_ps(c0, c1), nz, sumx, sumy, sumz);
+                    addNormal(_mm_sub_ps(c2, c1), _mm_sub_ps(zero, c2), nz, sumx, sumy, sumz);
+                    addNormal(_mm_sub_ps(c3, c2), _mm_sub_ps(zero, c2), nz, sumx, sumy, sumz);
+                    addNormal(c4, _mm_sub_ps(c4, c3), nz, sumx, sumy, sumz);
+                    addNormal(c4, _mm_sub_ps(c5, c4), nz, sumx, sumy, sumz);
+                    addNormal(_mm_sub_ps(c5, c6), c6, nz, sumx, sumy, sumz);
+                    addNormal(_mm_sub_ps(c6, c7), c6, nz, sumx, sumy, sumz);
+                    addNormal(_mm_sub_ps(zero, c0), _mm_sub_ps(c7, c0), nz, sumx, sumy, sumz);
+
+                    const __m128 invLength = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(
+                        _mm_mul_ps(sumx, sumx), _mm_mul_ps(sumy, sumy)), _mm_mul_ps(sumz, sumz))));
+                    OGRE_ALIGNED_DECL(float, nx[4], 16);
+                    OGRE_ALIGNED_DECL(float, ny[4], 16);
+                    OGRE_ALIGNED_DECL(float, nzOut[4], 16);
+                    _mm_store_ps(nx, _mm_mul_ps(sumx, invLength));
+                    _mm_store_ps(ny, _mm_mul_ps(sumy, invLength));
+                    _mm_store_ps(nzOut, _mm_mul_ps(sumz, invLength));
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        Vector3 normal;
+                        Terrain::convertTerrainToWorldAxes(terrain->getAlignment(),
+                            Vector3(nx[i], ny[i], nzOut[i]), &normal);
+                        store(x + i, y, normal);
+                    }
+                }
+#endif
+                for (; x < xend; ++x)
+                {
+                    const float p = centre[x];
+                    const float c0 = centre[x + 1] - p;
+                    const float c1 = above[x + 1] - p;
+                    const float c2 = above[x] - p;
+                    const float c3 = above[x - 1] - p;
+                    const float c4 = centre[x - 1] - p;
+                    const float c5 = below[x - 1] - p;
+                    const float c6 = below[x] - p;
+                    const float c7 = below[x + 1] - p;
+
+                    float sumx = 0, sumy = 0, sumz = 0;
+                    addNormal(-c0, c0 - c1, scale, sumx, sumy, sumz);
+                    addNormal(c2 - c1, -c2, scale, sumx, sumy, sumz);
+                    addNormal(c3 - c2, -c2, scale, sumx, sumy, sumz);
+                    addNormal(c4, c4 - c3, scale, sumx, sumy, sumz);
+                    addNormal(c4, c5 - c4, scale, sumx, sumy, sumz);
+                    addNormal(c5 - c6, c6, scale, sumx, sumy, sumz);
+                    addNormal(c6 - c7, c6, scale, sumx, sumy, sumz);
+                    addNormal(-c0, c7 - c0, scale, sumx, sumy, sumz);
+
+                    const float invLength = 1.0f / std::sqrt(sumx * sumx + sumy * sumy + sumz * sumz);
+                    Vector3 normal;
+                    Terrain::convertTerrainToWorldAxes(terrain->getAlignment(),
+                        Vector3(sumx * invLength, sumy * invLength, sumz * invLength), &normal);
+                    store(x, y, normal);
+                }
+            }
+
+            void processBand(size_t band)
+            {
+                const long height = rect.height();
+                const long top = rect.top + static_cast<long>(band * height / numBands);
+                const long bottom = rect.top + static_cast<long>((band + 1) * height / numBands);
+                const long innerLeft = std::max(1L, rect.left);
+                const long innerRight = std::max(innerLeft, std::min(size - 1, rect.right));
+                for (long y = top; y < bottom; ++y)
+                {
+                    if (y == 0 || y == size - 1)
+                    {
+                        for (long x = rect.left; x < rect.right; ++x)
+                            calculateEdgeNormal(x, y);
+                        continue;
+                    }
+
+                    for (long x = rect.left; x < innerLeft; ++x)
+                        calculateEdgeNormal(x, y);
+                    calculateInnerNormals(innerLeft, innerRight, y);
+                    for (long x = innerRight; x < rect.right; ++x)
+                        calculateEdgeNormal(x, y);
+                }
+            }
+        };
+    }
+    //---------------------------------------------------------------------
     PixelBox* Terrain::calculateNormals(const Rect &rect, Rect& finalRect)
     {
         // Widen the rectangle by 1 element in all directions since height
@@ -3354,49 +3920,15 @@ namespace Ogre
         //  4---P---0
         //  | / | \ |
         //  5---6---7
-
-        Plane plane;
-        for (long y = widenedRect.top; y < widenedRect.bottom; ++y)
-        {
-            for (long x = widenedRect.left; x < widenedRect.right; ++x)
-            {
-                Vector3 cumulativeNormal = Vector3::ZERO;
-
-                // Build points to sample
-                Vector3 centrePoint;
-                Vector3 adjacentPoints[8];
-                getPointFromSelfOrNeighbour(x  , y,   &centrePoint);
-                getPointFromSelfOrNeighbour(x+1, y,   &adjacentPoints[0]);
-                getPointFromSelfOrNeighbour(x+1, y+1, &adjacentPoints[1]);
-                getPointFromSelfOrNeighbour(x,   y+1, &adjacentPoints[2]);
-                getPointFromSelfOrNeighbour(x-1, y+1, &adjacentPoints[3]);
-                getPointFromSelfOrNeighbour(x-1, y,   &adjacentPoints[4]);
-                getPointFromSelfOrNeighbour(x-1, y-1, &adjacentPoints[5]);
-                getPointFromSelfOrNeighbour(x,   y-1, &adjacentPoints[6]);
-                getPointFromSelfOrNeighbour(x+1, y-1, &adjacentPoints[7]);
-
-                for (int i = 0; i < 8; ++i)
-                {
-                    plane.redefine(centrePoint, adjacentPoints[i], adjacentPoints[(i+1)%8]);
-                    cumulativeNormal += plane.normal;
-                }
-
-                // normalise & store normal
-                cumulativeNormal.normalise();
-
-                // encode as RGB, object space
-                // invert the Y to deal with image space
-                long storeX = x - widenedRect.left;
-                long storeY = widenedRect.bottom - y - 1;
-
-                uint8* pStore = pData + ((storeY * widenedRect.width()) + storeX) * 3;
-                *pStore++ = static_cast<uint8>((cumulativeNormal.x + 1.0f) * 0.5f * 255.0f);
-                *pStore++ = static_cast<uint8>((cumulativeNormal.y + 1.0f) * 0.5f * 255.0f);
-                *pStore++ = static_cast<uint8>((cumulativeNormal.z + 1.0f) * 0.5f * 255.0f);
-
-
-            }
-        }
+        NormalMapJob job;
+        job.terrain = this;
+        job.heights = mHeightData;
+        job.size = mSize;
+        job.scale = static_cast<float>(mScale);
+        job.rect = widenedRect;
+        job.data = pData;
+        if (!widenedRect.isNull())
+            runTerrainBands(job, widenedRect.height());
 
         finalRect = widenedRect;
 
@@ -3494,6 +4026,198 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
+    namespace
+    {
+        /// Bilinear height lookups across a terrain and its direct neighbours, in terrain space
+        class LightmapHeightSampler
+        {
+        public:
+            LightmapHeightSampler(const Terrain* terrain, Real edgeTolerance)
+                : mEdgeTolerance(edgeTolerance)
+            {
+                for (long oy = -1; oy <= 1; ++oy)
+                {
+                    for (long ox = -1; ox <= 1; ++ox)
+                    {
+                        const Terrain* t = terrain;
+                        if (ox || oy)
+                            t = terrain->getNeighbour(Terrain::getNeighbourIndex(ox, oy));
+                        if (t && !t->getHeightData())
+                            t = 0;
+
+                        mTerrains[oy + 1][ox + 1] = t;
+                        mOffsets[oy + 1][ox + 1] = 0;
+                        if (t)
+                        {
+                            Vector3 offset;
+                            Terrain::convertWorldToTerrainAxes(terrain->getAlignment(),
+                                t->getPosition() - terrain->getPosition(), &offset);
+                            mOffsets[oy + 1][ox + 1] = offset.z;
+                        }
+                    }
+                }
+            }
+
+            /// Whether any terrain exists next to this one on the given side of an axis
+            bool hasNeighbours(bool xAxis, long side) const
+            {
+                for (long i = 0; i < 3; ++i)
+                {
+                    if (xAxis ? mTerrains[i][side + 1] : mTerrains[side + 1][i])
+                        return true;
+                }
+                return false;
+            }
+
+            /// Gets the height at the given terrain space position, false if there's no terrain
+            bool sample(Real x, Real y, Real& height) const
+            {
+                if (x < -1 || x > 2 || y < -1 || y > 2)
+                    return false;
+
+                long ox = x < 0 ? -1 : (x > 1 ? 1 : 0);
+                long oy = y < 0 ? -1 : (y > 1 ? 1 : 0);
+                const Terrain* t = mTerrains[oy + 1][ox + 1];
+                if (!t)
+                {
+                    // just off an open edge, as lines through edge texels can be
+                    Real cx = Math::Clamp<Real>(x, 0, 1);
+                    Real cy = Math::Clamp<Real>(y, 0, 1);
+                    if (Math::Abs(x - cx) > mEdgeTolerance || Math::Abs(y - cy) > mEdgeTolerance)
+                        return false;
+                    x = cx;
+                    y = cy;
+                    ox = oy = 0;
+                    t = mTerrains[1][1];
+                }
+
+                const long size = t->getSize();
+                Real px = (x - ox) * (size - 1);
+                Real py = (y - oy) * (size - 1);
+                long ix = std::min(static_cast<long>(px), size - 2);
+                long iy = std::min(static_cast<long>(py), size - 2);
+                Real fx = px - ix;
+                Real fy = py - iy;
+
+                const float* row = t->getHeightData() + iy * size + ix;
+                height = mOffsets[oy + 1][ox + 1] +
+                    (row[0] * (1 - fx) + row[1] * fx) * (1 - fy) +
+                    (row[size] * (1 - fx) + row[size + 1] * fx) * fy;
+                return true;
+            }
+
+        private:
+            const Terrain* mTerrains[3][3];
+            Real mOffsets[3][3];
+            Real mEdgeTolerance;
+        };
+
+        /** Shadowing of a lightmap area by horizon sweeps.
+        @remarks
+            The area is covered by parallel lines running away from the light,
+            one texel apart, each walking a texel per step along the major axis of
+            the light direction. Along a line the highest horizon seen so far,
+            lowered by the rise of the light ray per step, tells whether a point
+            is in shadow, so the cost per texel is constant rather than a ray cast.
+            Each line shades one texel per step, so lines can run concurrently.
+        */
+        struct HorizonLightmapJob : public TerrainBandJob
+        {
+            const LightmapHeightSampler* sampler;
+            uint8* data;
+            Rect rect;
+            /// Lines step along x if true, along y otherwise
+            bool majorX;
+            /// Major axis step away from the light, 1 or -1
+            long step;
+            /// Minor axis change per step
+            Real slope;
+            /// Major coordinate the lines start at, upwind of the rect
+            long majorStart;
+            /// Range of lines, by their minor coordinate at the upwind edge of the rect
+            /// in units of 1 / subSteps texels
+            long firstLine;
+            long numLines;
+            /// Largest texel coordinate, i.e. the lightmap size - 1
+            Real texelExtent;
+            /// Drop of the horizon per step, i.e. the rise of the light ray
+            Real decay;
+            /// Height samples per step and lines per texel, to match the resolution
+            /// of the height data
+            long subSteps;
+            Real heightPad;
+
+            void processBand(size_t band);
+        };
+
+        void calculateHorizonLines(const HorizonLightmapJob& job, long firstLine, long lastLine)
+        {
+            const long majorBegin = job.majorX ? job.rect.left : job.rect.top;
+            const long majorEnd = job.majorX ? job.rect.right : job.rect.bottom;
+            const long minorBegin = job.majorX ? job.rect.top : job.rect.left;
+            const long minorEnd = job.majorX ? job.rect.bottom : job.rect.right;
+            const long upwindEdge = job.step > 0 ? majorBegin : majorEnd - 1;
+            const long majorStop = job.step > 0 ? majorEnd : majorBegin - 1;
+            const long width = job.rect.width();
+
+            for (long line = firstLine; line < lastLine; ++line)
+            {
+                Real horizon = -std::numeric_limits<Real>::max();
+                for (long u = job.majorStart; u != majorStop; u += job.step)
+                {
+                    const long steps = (u - upwindEdge) * job.step;
+                    const Real v = static_cast<Real>(line) / job.subSteps + steps * job.slope;
+
+                    Real height;
+                    for (long sub = job.subSteps - 1; sub > 0; --sub)
+                    {
+                        // heights in between texels, so no ridge is stepped over
+                        const Real f = static_cast<Real>(sub) / job.subSteps;
+                        const Real tu = (u - job.step * f) / job.texelExtent;
+                        const Real tv = (v - job.slope * f) / job.texelExtent;
+                        if (job.sampler->sample(job.majorX ? tu : tv, job.majorX ? tv : tu, height))
+                            horizon = std::max(horizon, height);
+                        horizon -= job.decay / job.subSteps;
+                    }
+
+                    const Real tu = u / job.texelExtent;
+                    const Real tv = v / job.texelExtent;
+                    if (!job.sampler->sample(job.majorX ? tu : tv, job.majorX ? tv : tu, height))
+                    {
+                        horizon -= job.decay / job.subSteps;
+                        continue;
+                    }
+
+                    if (steps >= 0 && horizon > height + job.heightPad)
+                    {
+                        const long nearest = static_cast<long>(Math::Floor(v + 0.5f));
+                        for (long texel = nearest - 1; texel <= nearest + 1; ++texel)
+                        {
+                            // each texel is shaded by the line passing closest to it only,
+                            // worked out the same way for every line so none is missed
+                            if (texel < minorBegin || texel >= minorEnd ||
+                                static_cast<long>(Math::Floor((texel - steps * job.slope) * job.subSteps + 0.5f)) != line)
+                                continue;
+
+                            const long x = job.majorX ? u : texel;
+                            const long y = job.majorX ? texel : u;
+                            // invert the Y to deal with image space
+                            job.data[(job.rect.bottom - y - 1) * width + (x - job.rect.left)] = 0;
+                        }
+                    }
+                    horizon = std::max(horizon, height) - job.decay / job.subSteps;
+                }
+            }
+        }
+
+        void HorizonLightmapJob::processBand(size_t band)
+        {
+            calculateHorizonLines(*this,
+                firstLine + static_cast<long>(band * numLines / numBands),
+                firstLine + static_cast<long>((band + 1) * numLines / numBands));
+        }
+    }
+    //---------------------------------------------------------------------
     PixelBox* Terrain::calculateLightmap(const Rect& rect, const Rect& extraTargetRect, Rect& outFinalRect)
     {
         // as well as calculating the lighting changes for the area that is
@@ -3534,41 +4258,59 @@ namespace Ogre
 
         Real heightPad = (getMaxHeight() - getMinHeight()) * 1.0e-3f;
 
-        for (long y = widenedRect.top; y < widenedRect.bottom; ++y)
-        {
-            for (long x = widenedRect.left; x < widenedRect.right; ++x)
-            {
-                float litVal = 1.0f;
-
-                // convert to terrain space (not points, allow this to go between points)
-                float Tx = (float)x / (float)(mLightmapSizeActual-1);
-                float Ty = (float)y / (float)(mLightmapSizeActual-1);
-
-                // get world space point
-                // add a little height padding to stop shadowing self
-                Vector3 wpos = Vector3::ZERO;
-                getPosition(Tx, Ty, getHeightAtTerrainPosition(Tx, Ty) + heightPad, &wpos);
-                wpos += getPosition();
-                // build ray, cast backwards along light direction
-                Ray ray(wpos, -lightVec);
-
-                // Cascade into neighbours when casting, but don't travel further
-                // than world size
-                std::pair<bool, Vector3> rayHit = rayIntersects(ray, true, mWorldSize);
-
-                if (rayHit.first)
-                    litVal = 0.0f;
-
-                // encode as L8
-                // invert the Y to deal with image space
-                long storeX = x - widenedRect.left;
-                long storeY = widenedRect.bottom - y - 1;
+        if (widenedRect.isNull())
+            return pixbox;
+
+        // everything is lit until a horizon says otherwise
+        memset(pData, 255, widenedRect.width() * widenedRect.height());
+
+        // direction towards the light, in terrain axes
+        Vector3 toLight = convertWorldToTerrainAxes(-lightVec);
+        Real horizontal = Math::Sqrt(toLight.x * toLight.x + toLight.y * toLight.y);
+        if (horizontal < 1e-6f)
+        {
+            // straight up can't hit anything, straight down always does
+            if (toLight.z <= 0)
+                memset(pData, 0, widenedRect.width() * widenedRect.height());
+            return pixbox;
+        }
+
+        LightmapHeightSampler sampler(this, 1.0f / (mLightmapSizeActual - 1));
+        HorizonLightmapJob job;
+        job.sampler = &sampler;
+        job.data = pData;
+        job.rect = widenedRect;
+        job.majorX = Math::Abs(toLight.x) >= Math::Abs(toLight.y);
+        Real major = job.majorX ? toLight.x : toLight.y;
+        Real minor = job.majorX ? toLight.y : toLight.x;
+        job.step = major > 0 ? -1 : 1;
+        job.slope = -minor / Math::Abs(major);
+        job.texelExtent = static_cast<Real>(mLightmapSizeActual - 1);
+        job.decay = toLight.z / horizontal * mWorldSize / job.texelExtent *
+            Math::Sqrt(1 + job.slope * job.slope);
+        job.heightPad = heightPad;
+        job.subSteps = std::max(1L, static_cast<long>(
+            Math::Ceil(static_cast<Real>(mSize - 1) / (mLightmapSizeActual - 1))));
+
+        // Start a terrain's width upwind when neighbours can cast shadows in,
+        // otherwise at our own edge
+        long majorBegin = job.majorX ? widenedRect.left : widenedRect.top;
+        long majorEnd = job.majorX ? widenedRect.right : widenedRect.bottom;
+        long upwindEdge = job.step > 0 ? majorBegin : majorEnd - 1;
+        if (sampler.hasNeighbours(job.majorX, -job.step))
+            job.majorStart = upwindEdge - job.step * (mLightmapSizeActual - 1);
+        else
+            job.majorStart = job.step > 0 ? 0 : mLightmapSizeActual - 1;
 
-                uint8* pStore = pData + ((storeY * widenedRect.width()) + storeX);
-                *pStore = (unsigned char)(litVal * 255.0);
+        // Lines reaching the rect anywhere along it
+        long minorBegin = job.majorX ? widenedRect.top : widenedRect.left;
+        long minorEnd = job.majorX ? widenedRect.bottom : widenedRect.right;
+        Real drift = (majorEnd - majorBegin - 1) * job.slope;
+        job.firstLine = static_cast<long>(Math::Floor((minorBegin - 0.5f - std::max<Real>(0, drift)) * job.subSteps));
+        job.numLines = static_cast<long>(Math::Ceil((minorEnd + 0.5f - std::min<Real>(0, drift)) * job.subSteps)) -
+            job.firstLine;
 
-            }
-        }
+        runTerrainBands(job, job.numLines);
 
         return pixbox;
 
@@ -4683,6 +5425,73 @@ namespace Ogre
         else
             return i->second;
 
+    }
+    //---------------------------------------------------------------------
+    HardwareVertexBufferSharedPtr Terrain::DefaultGpuBufferAllocator::getSharedGridVertexBuffer(
+        const Terrain* forTerrain, uint16 vdatasize, uint16 vertexIncrement, uint16 numSkirtRowsCols, 
+        uint16 skirtRowColSkip)
+    {
+        // LOD thresholds depend on the terrain size and min batch size too
+        uint32 hsh = 0;
+        hsh = HashCombine(hsh, forTerrain->getSize());
+        hsh = HashCombine(hsh, forTerrain->getMinBatchSize());
+        hsh = HashCombine(hsh, vdatasize);
+        hsh = HashCombine(hsh, vertexIncrement);
+        hsh = HashCombine(hsh, numSkirtRowsCols);
+        hsh = HashCombine(hsh, skirtRowColSkip);
+
+        VBufMap::iterator i = mSharedGridVBufMap.find(hsh);
+        if (i != mSharedGridVBufMap.end())
+            return i->second;
+
+        // main vertices, then row skirts, then column skirts (see _calcSkirtVertexIndex)
+        size_t numVertices = vdatasize * vdatasize + numSkirtRowsCols * vdatasize * 2;
+        HardwareVertexBufferSharedPtr ret = HardwareBufferManager::getSingleton()
+            .createVertexBuffer(sizeof(int16) * 4, numVertices, HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+        int16* pV = static_cast<int16*>(ret->lock(HardwareBuffer::HBL_DISCARD));
+
+        // Vertices in the same place in all vertex data of this layout are
+        // eliminated at the same LOD, since vertex data always starts at a 
+        // multiple of its own extent, so thresholds can be worked out locally
+        for (uint16 row = 0; row < vdatasize; ++row)
+        {
+            for (uint16 col = 0; col < vdatasize; ++col)
+            {
+                *pV++ = static_cast<int16>(col * vertexIncrement);
+                *pV++ = static_cast<int16>(row * vertexIncrement);
+                *pV++ = 0;
+                *pV++ = static_cast<int16>(forTerrain->getLODLevelWhenVertexEliminated(
+                    col * vertexIncrement, row * vertexIncrement) - 1);
+            }
+        }
+        // skirts are never morphed
+        for (uint16 s = 0; s < numSkirtRowsCols; ++s)
+        {
+            uint16 row = s * skirtRowColSkip;
+            for (uint16 col = 0; col < vdatasize; ++col)
+            {
+                *pV++ = static_cast<int16>(col * vertexIncrement);
+                *pV++ = static_cast<int16>(row * vertexIncrement);
+                *pV++ = 1;
+                *pV++ = 99;
+            }
+        }
+        for (uint16 s = 0; s < numSkirtRowsCols; ++s)
+        {
+            uint16 col = s * skirtRowColSkip;
+            for (uint16 row = 0; row < vdatasize; ++row)
+            {
+                *pV++ = static_cast<int16>(col * vertexIncrement);
+                *pV++ = static_cast<int16>(row * vertexIncrement);
+                *pV++ = 1;
+                *pV++ = 99;
+            }
+        }
+        ret->unlock();
+
+        mSharedGridVBufMap[hsh] = ret;
+        return ret;
+
     }
     //---------------------------------------------------------------------
     void Terrain::DefaultGpuBufferAllocator::freeAllBuffers()
@@ -4690,6 +5499,7 @@ namespace Ogre
         mFreePosBufList.clear();
         mFreeDeltaBufList.clear();
         mSharedIBufMap.clear();
+        mSharedGridVBufMap.clear();
     }
     //---------------------------------------------------------------------
     void Terrain::DefaultGpuBufferAllocator::warmStart(size_t numInstances, uint16 terrainSize, uint16 maxBatchSize, 
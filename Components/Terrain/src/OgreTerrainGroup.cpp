@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgreStreamSerialiser.h"
 #include "OgreLogManager.h"
 #include "OgreTerrainAutoUpdateLod.h"
+#include "OgreTerrainBandJob.h"
 #include <iomanip>
 
 namespace Ogre
@@ -580,6 +581,125 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
+    namespace
+    {
+        /// Height queries sorted by slot, with the terrain resolving each run of them
+        struct HeightQueryJob : public TerrainBandJob
+        {
+            struct Run
+            {
+                Terrain* terrain;
+                size_t begin, end;
+            };
+            typedef vector<Run>::type RunList;
+
+            RunList runs;
+            vector<Vector3>::type positions;
+            vector<float>::type heights;
+
+            void processBand(size_t band)
+            {
+                size_t begin = band * positions.size() / numBands;
+                size_t end = (band + 1) * positions.size() / numBands;
+                for (RunList::iterator i = runs.begin(); i != runs.end(); ++i)
+                {
+                    size_t first = std::max(begin, i->begin);
+                    size_t last = std::min(end, i->end);
+                    if (first >= last)
+                        continue;
+                    if (i->terrain)
+                        i->terrain->getHeightsAtWorldPositions(&positions[first], last - first, &heights[first]);
+                    else
+                        std::fill(heights.begin() + first, heights.begin() + last, 0.0f);
+                }
+            }
+        };
+
+        struct RayQueryJob : public TerrainBandJob
+        {
+            const TerrainGroup* group;
+            const Ray* rays;
+            size_t count;
+            TerrainGroup::RayResult* results;
+            Real distanceLimit;
+
+            void processBand(size_t band)
+            {
+                size_t end = (band + 1) * count / numBands;
+                for (size_t i = band * count / numBands; i < end; ++i)
+                    results[i] = group->rayIntersects(rays[i], distanceLimit);
+            }
+        };
+
+        /// Smallest number of queries worth handing to a thread of their own
+        const size_t MIN_HEIGHT_QUERIES_PER_THREAD = 1024;
+        const size_t MIN_RAY_QUERIES_PER_THREAD = 64;
+    }
+    //---------------------------------------------------------------------
+    void TerrainGroup::getHeightsAtWorldPositions(const Vector3* positions, size_t count,
+        float* outHeights, Terrain** outTerrains /* = 0 */) const
+    {
+        if (!count)
+            return;
+
+        typedef std::pair<uint32, size_t> SlotQuery;
+        vector<SlotQuery>::type order(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            long x, y;
+            convertWorldPositionToTerrainSlot(positions[i], &x, &y);
+            order[i] = SlotQuery(packIndex(x, y), i);
+        }
+        std::sort(order.begin(), order.end());
+
+        HeightQueryJob job;
+        job.positions.resize(count);
+        job.heights.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            job.positions[i] = positions[order[i].second];
+            if (i == 0 || order[i].first != order[i - 1].first)
+            {
+                // Look each slot up once only
+                TerrainSlotMap::const_iterator slot = mTerrainSlots.find(order[i].first);
+                HeightQueryJob::Run run;
+                run.terrain = 0;
+                if (slot != mTerrainSlots.end() && slot->second->instance && 
+                    slot->second->instance->isLoaded())
+                {
+                    run.terrain = slot->second->instance;
+                }
+                run.begin = i;
+                job.runs.push_back(run);
+            }
+            job.runs.back().end = i + 1;
+        }
+
+        runTerrainBands(job, count / MIN_HEIGHT_QUERIES_PER_THREAD);
+
+        size_t run = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (i == job.runs[run].end)
+                ++run;
+            outHeights[order[i].second] = job.heights[i];
+            if (outTerrains)
+                outTerrains[order[i].second] = job.runs[run].terrain;
+        }
+    }
+    //---------------------------------------------------------------------
+    void TerrainGroup::rayIntersects(const Ray* rays, size_t count, RayResult* outResults,
+        Real distanceLimit /* = 0 */) const
+    {
+        RayQueryJob job;
+        job.group = this;
+        job.rays = rays;
+        job.count = count;
+        job.results = outResults;
+        job.distanceLimit = distanceLimit;
+        runTerrainBands(job, count / MIN_RAY_QUERIES_PER_THREAD);
+    }
+    //---------------------------------------------------------------------
     void TerrainGroup::boxIntersects(const AxisAlignedBox& box, TerrainList* resultList) const
     {
         resultList->clear();
@@ -31,12 +31,273 @@ THE SOFTWARE.
 #include "OgreStreamSerialiser.h"
 #include "OgreLogManager.h"
 #include "OgreTerrain.h"
+#include "OgreTerrainBandJob.h"
 
 namespace Ogre
 {
     const uint16 TerrainLodManager::WORKQUEUE_LOAD_LOD_DATA_REQUEST = 1;
     const uint32 TerrainLodManager::TERRAINLODDATA_CHUNK_ID = StreamSerialiser::makeIdentifier("TLDA");
-    const uint16 TerrainLodManager::TERRAINLODDATA_CHUNK_VERSION = 1;
+    const uint16 TerrainLodManager::TERRAINLODDATA_CHUNK_VERSION = 2;
+
+    namespace
+    {
+        /// Number of height / delta values compressed together in one block
+        const uint32 LOD_DATA_BLOCK_SIZE = 16384;
+        const size_t LZ_MIN_MATCH = 4;
+        const size_t LZ_HASH_BITS = 12;
+        const size_t LZ_MAX_OFFSET = 0xFFFF;
+
+        typedef vector<uint8>::type ByteBuffer;
+        typedef vector<ByteBuffer>::type ByteBufferList;
+
+        /// Largest size lzCompress can produce from srcSize bytes
+        size_t lzCompressBound(size_t srcSize)
+        {
+            return srcSize + srcSize / 255 + 16;
+        }
+
+        uint32 readUnaligned32(const uint8* p)
+        {
+            uint32 v;
+            memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        uint8* writeLzLength(uint8* op, size_t len)
+        {
+            for (; len >= 255; len -= 255)
+                *op++ = 255;
+            *op++ = static_cast<uint8>(len);
+            return op;
+        }
+
+        bool readLzLength(const uint8*& ip, const uint8* iend, size_t& len)
+        {
+            uint8 b;
+            do
+            {
+                if (ip == iend)
+                    return false;
+                b = *ip++;
+                len += b;
+            } while (b == 255);
+            return true;
+        }
+
+        /** Write one sequence of literals followed by a back reference, or just
+            the literals when matchLen is 0, which ends the block.
+        */
+        uint8* writeLzSequence(uint8* op, const uint8* literals, size_t litLen,
+            size_t offset, size_t matchLen)
+        {
+            size_t matchCode = matchLen ? matchLen - LZ_MIN_MATCH : 0;
+            *op++ = static_cast<uint8>((std::min<size_t>(litLen, 15) << 4) |
+                std::min<size_t>(matchCode, 15));
+            if (litLen >= 15)
+                op = writeLzLength(op, litLen - 15);
+            memcpy(op, literals, litLen);
+            op += litLen;
+            if (matchLen)
+            {
+                *op++ = static_cast<uint8>(offset);
+                *op++ = static_cast<uint8>(offset >> 8);
+                if (matchCode >= 15)
+                    op = writeLzLength(op, matchCode - 15);
+            }
+            return op;
+        }
+
+        /** Byte oriented LZ compression in the style of LZ4: a greedy single
+            probe hash of 4 byte sequences, literal runs and back references of
+            up to 64K.
+        @return The number of bytes written to dest, at most lzCompressBound(srcSize)
+        */
+        size_t lzCompress(const uint8* src, size_t srcSize, uint8* dest)
+        {
+            // positions + 1 of the last occurrence of each hashed sequence, 0 is empty
+            uint32 table[1 << LZ_HASH_BITS];
+            memset(table, 0, sizeof(table));
+
+            const uint8* ip = src;
+            const uint8* anchor = src;
+            const uint8* end = src + srcSize;
+            uint8* op = dest;
+            while (end - ip >= (ptrdiff_t)LZ_MIN_MATCH)
+            {
+                uint32 seq = readUnaligned32(ip);
+                uint32 h = (seq * 2654435761U) >> (32 - LZ_HASH_BITS);
+                uint32 candidate = table[h];
+                table[h] = static_cast<uint32>(ip - src) + 1;
+                if (candidate)
+                {
+                    const uint8* ref = src + candidate - 1;
+                    if ((size_t)(ip - ref) <= LZ_MAX_OFFSET && readUnaligned32(ref) == seq)
+                    {
+                        const uint8* mp = ip + LZ_MIN_MATCH;
+                        const uint8* rp = ref + LZ_MIN_MATCH;
+                        while (mp < end && *mp == *rp)
+                        {
+                            ++mp;
+                            ++rp;
+                        }
+                        op = writeLzSequence(op, anchor, ip - anchor, ip - ref, mp - ip);
+                        ip = anchor = mp;
+                        continue;
+                    }
+                }
+                ++ip;
+            }
+            op = writeLzSequence(op, anchor, end - anchor, 0, 0);
+            return op - dest;
+        }
+
+        /** Inverse of lzCompress.
+        @return false if the data is corrupt or doesn't decompress to exactly destSize bytes
+        */
+        bool lzDecompress(const uint8* src, size_t srcSize, uint8* dest, size_t destSize)
+        {
+            const uint8* ip = src;
+            const uint8* iend = src + srcSize;
+            uint8* op = dest;
+            uint8* oend = dest + destSize;
+            while (ip < iend)
+            {
+                uint8 token = *ip++;
+                size_t len = token >> 4;
+                if (len == 15 && !readLzLength(ip, iend, len))
+                    return false;
+                if ((size_t)(iend - ip) < len || (size_t)(oend - op) < len)
+                    return false;
+                memcpy(op, ip, len);
+                ip += len;
+                op += len;
+                if (ip == iend)
+                    break;
+
+                if (iend - ip < 2)
+                    return false;
+                size_t offset = ip[0] | (ip[1] << 8);
+                ip += 2;
+                len = token & 15;
+                if (len == 15 && !readLzLength(ip, iend, len))
+                    return false;
+                len += LZ_MIN_MATCH;
+                if (offset == 0 || offset > (size_t)(op - dest) || (size_t)(oend - op) < len)
+                    return false;
+                const uint8* ref = op - offset;
+                if (offset >= len)
+                {
+                    memcpy(op, ref, len);
+                    op += len;
+                }
+                else
+                {
+                    // overlapping, repeats the last offset bytes
+                    while (len--)
+                        *op++ = *ref++;
+                }
+            }
+            return op == oend;
+        }
+
+        /** Replace each value by the zigzag coded difference of its bits to
+            those of the previous value, stored as 4 planes of the lowest to the
+            highest byte. Neighbouring heights are close so the high planes
+            are mostly zero and compress well.
+        */
+        void encodeValueDeltas(const float* values, size_t count, uint8* dest)
+        {
+            uint32 prev = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                uint32 bits;
+                memcpy(&bits, values + i, sizeof(bits));
+                uint32 d = bits - prev;
+                prev = bits;
+                uint32 z = (d << 1) ^ static_cast<uint32>(static_cast<int32>(d) >> 31);
+                dest[i] = static_cast<uint8>(z);
+                dest[count + i] = static_cast<uint8>(z >> 8);
+                dest[2 * count + i] = static_cast<uint8>(z >> 16);
+                dest[3 * count + i] = static_cast<uint8>(z >> 24);
+            }
+        }
+
+        void decodeValueDeltas(const uint8* src, size_t count, float* values)
+        {
+            uint32 prev = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                uint32 z = src[i] | (src[count + i] << 8) |
+                    (src[2 * count + i] << 16) | (static_cast<uint32>(src[3 * count + i]) << 24);
+                prev += (z >> 1) ^ (0u - (z & 1));
+                memcpy(values + i, &prev, sizeof(prev));
+            }
+        }
+
+        /// First value of a block
+        size_t getBlockStart(size_t block, size_t count)
+        {
+            return std::min<size_t>(block * LOD_DATA_BLOCK_SIZE, count);
+        }
+
+        /// Compresses the blocks of one LOD level
+        struct LodBlockCompressJob : public TerrainBandJob
+        {
+            const float* values;
+            size_t count;
+            ByteBufferList* blocks;
+
+            void processBand(size_t band)
+            {
+                size_t numBlocks = blocks->size();
+                size_t first = band * numBlocks / numBands;
+                size_t last = (band + 1) * numBlocks / numBands;
+                ByteBuffer deltas(LOD_DATA_BLOCK_SIZE * sizeof(float));
+                for (size_t b = first; b < last; ++b)
+                {
+                    size_t start = getBlockStart(b, count);
+                    size_t n = getBlockStart(b + 1, count) - start;
+                    encodeValueDeltas(values + start, n, &deltas[0]);
+
+                    ByteBuffer& block = (*blocks)[b];
+                    block.resize(lzCompressBound(n * sizeof(float)));
+                    block.resize(lzCompress(&deltas[0], n * sizeof(float), &block[0]));
+                }
+            }
+        };
+
+        /// Decompresses the blocks of one LOD level
+        struct LodBlockDecompressJob : public TerrainBandJob
+        {
+            const uint8* payload;
+            /// Start of each block in payload, plus the end of the last
+            const size_t* offsets;
+            size_t numBlocks;
+            float* values;
+            size_t count;
+            /// Set for each block which was corrupt
+            uint8* failed;
+
+            void processBand(size_t band)
+            {
+                size_t first = band * numBlocks / numBands;
+                size_t last = (band + 1) * numBlocks / numBands;
+                ByteBuffer deltas(LOD_DATA_BLOCK_SIZE * sizeof(float));
+                for (size_t b = first; b < last; ++b)
+                {
+                    size_t start = getBlockStart(b, count);
+                    size_t n = getBlockStart(b + 1, count) - start;
+                    if (!lzDecompress(payload + offsets[b], offsets[b + 1] - offsets[b],
+                            &deltas[0], n * sizeof(float)))
+                    {
+                        failed[b] = 1;
+                        continue;
+                    }
+                    decodeValueDeltas(&deltas[0], n, values + start);
+                }
+            }
+        };
+    }
 
     TerrainLodManager::TerrainLodManager(Terrain* t, DataStreamPtr& stream)
         : mTerrain(t)
@@ -314,10 +575,30 @@ namespace Ogre
 
         for (int level = numLodLevels - 1; level >=0; level--)
         {
+            const LodData& data = lods[level];
+            uint32 valueCount = static_cast<uint32>(data.size());
+            uint32 blockSize = LOD_DATA_BLOCK_SIZE;
+            uint32 numBlocks = (valueCount + blockSize - 1) / blockSize;
+
+            ByteBufferList blocks(numBlocks);
+            LodBlockCompressJob job;
+            job.values = &data[0];
+            job.count = valueCount;
+            job.blocks = &blocks;
+            runTerrainBands(job, numBlocks);
+
             stream.writeChunkBegin(TERRAINLODDATA_CHUNK_ID, TERRAINLODDATA_CHUNK_VERSION);
-            stream.startDeflate();
-            stream.write(&(lods[level][0]), lods[level].size());
-            stream.stopDeflate();
+            stream.write(&valueCount);
+            stream.write(&blockSize);
+            stream.write(&numBlocks);
+            // block index, then the blocks
+            for (uint32 b = 0; b < numBlocks; ++b)
+            {
+                uint32 blockBytes = static_cast<uint32>(blocks[b].size());
+                stream.write(&blockBytes);
+            }
+            for (uint32 b = 0; b < numBlocks; ++b)
+                stream.write(&blocks[b][0], blocks[b].size());
             stream.writeChunkEnd(TERRAINLODDATA_CHUNK_ID);
         }
     }
@@ -358,9 +639,14 @@ namespace Ogre
                 // reach and read the target lod data
                 const StreamSerialiser::Chunk *c = stream.readChunkBegin(TERRAINLODDATA_CHUNK_ID,
                         TERRAINLODDATA_CHUNK_VERSION);
-                stream.startDeflate(c->length);
-                stream.read(lodData, dataSize);
-                stream.stopDeflate();
+                if (c->version > 1)
+                    readLodBlocks(stream, lodData, dataSize);
+                else
+                {
+                    stream.startDeflate(c->length);
+                    stream.read(lodData, dataSize);
+                    stream.stopDeflate();
+                }
                 stream.readChunkEnd(TERRAINLODDATA_CHUNK_ID);
 
                 fillBufferAtLod(level, lodData, dataSize);
@@ -370,6 +656,66 @@ namespace Ogre
             OGRE_FREE(lodData, MEMCATEGORY_GENERAL);
         }
     }
+    void TerrainLodManager::readLodBlocks(StreamSerialiser& stream, float* data, uint dataSize)
+    {
+        uint32 valueCount, blockSize, numBlocks;
+        stream.read(&valueCount);
+        stream.read(&blockSize);
+        stream.read(&numBlocks);
+        if (valueCount != dataSize || blockSize != LOD_DATA_BLOCK_SIZE ||
+            numBlocks != (valueCount + blockSize - 1) / blockSize)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Terrain LOD data does not match the terrain size",
+                "TerrainLodManager::readLodBlocks");
+        }
+
+        vector<size_t>::type offsets(numBlocks + 1, 0);
+        for (uint32 b = 0; b < numBlocks; ++b)
+        {
+            uint32 blockBytes;
+            stream.read(&blockBytes);
+            offsets[b + 1] = offsets[b] + blockBytes;
+        }
+        size_t payloadSize = offsets[numBlocks];
+
+        // Decompress straight from the stream's memory if it has any (eg
+        // a memory mapped file), otherwise read just this level's blocks
+        ByteBuffer buffer;
+        const uint8* payload;
+        MemoryDataStream* memStream = dynamic_cast<MemoryDataStream*>(mDataStream.get());
+        if (memStream && memStream->size() - memStream->tell() >= payloadSize)
+        {
+            payload = memStream->getCurrentPtr();
+            memStream->skip(static_cast<long>(payloadSize));
+        }
+        else
+        {
+            buffer.resize(payloadSize + 1);
+            if (mDataStream->read(&buffer[0], payloadSize) != payloadSize)
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                    "Terrain LOD data is truncated", "TerrainLodManager::readLodBlocks");
+            }
+            payload = &buffer[0];
+        }
+
+        ByteBuffer failed(numBlocks, 0);
+        LodBlockDecompressJob job;
+        job.payload = payload;
+        job.offsets = &offsets[0];
+        job.numBlocks = numBlocks;
+        job.values = data;
+        job.count = valueCount;
+        job.failed = &failed[0];
+        runTerrainBands(job, numBlocks);
+
+        if (std::find(failed.begin(), failed.end(), 1) != failed.end())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Terrain LOD data is corrupt", "TerrainLodManager::readLodBlocks");
+        }
+    }
     void TerrainLodManager::fillBufferAtLod(uint lodLevel, const float* data, uint dataSize )
     {
         unsigned int inc = 1 << lodLevel;
@@ -137,6 +137,21 @@ namespace Ogre
             return true;
     }
     //---------------------------------------------------------------------
+    bool TerrainMaterialGeneratorA::SM2Profile::isSharedGridSupported() const
+    {
+        // Needs integer texel fetches in the vertex program, so only SM4 HLSL 
+        // and GLSL 1.50+; Cg and GLSL ES keep using per terrain vertex buffers
+        RenderSystem* rs = Root::getSingleton().getRenderSystem();
+        if (!rs || !rs->getCapabilities()->hasCapability(RSC_VERTEX_TEXTURE_FETCH))
+            return false;
+
+        GpuProgramManager& gmgr = GpuProgramManager::getSingleton();
+        if (mShaderLanguage == "hlsl")
+            return gmgr.isSyntaxSupported("vs_4_0") && gmgr.isSyntaxSupported("ps_4_0");
+        else
+            return mShaderLanguage == "glsl";
+    }
+    //---------------------------------------------------------------------
     void TerrainMaterialGeneratorA::SM2Profile::setLayerNormalMappingEnabled(bool enabled)
     {
         if (enabled != mLayerNormalMappingEnabled)
@@ -239,6 +254,9 @@ namespace Ogre
         // colourmap
         if (terrain->getGlobalColourMapEnabled())
             --freeTextureUnits;
+        // height / delta map
+        if (terrain->_getUseSharedGrid())
+            --freeTextureUnits;
         if (isShadowingEnabled(HIGH_LOD, terrain))
         {
             uint8 numShadowTextures = 1;
@@ -447,6 +465,48 @@ namespace Ogre
             }
         }
 
+        // Heights for shared grid geometry, read in the vertex program (after 
+        // the shadow textures so as not to move any fragment samplers)
+        if (terrain->_getUseSharedGrid() && tt != RENDER_COMPOSITE_MAP)
+        {
+            TextureUnitState* tu = pass->createTextureUnitState(terrain->getHeightDeltaMap()->getName());
+            tu->setBindingType(TextureUnitState::BT_VERTEX);
+            tu->setTextureFiltering(TFO_NONE);
+            tu->setTextureAddressingMode(TextureUnitState::TAM_CLAMP);
+        }
+
+    }
+    //---------------------------------------------------------------------
+    uint TerrainMaterialGeneratorA::SM2Profile::getHeightDeltaMapUnit(const Terrain* terrain, TechniqueType tt) const
+    {
+        uint unit = 0;
+        if (tt == LOW_LOD)
+        {
+            // composite map
+            ++unit;
+        }
+        else
+        {
+            // normal map, colour map, light map
+            ++unit;
+            if (terrain->getGlobalColourMapEnabled() && isGlobalColourMapEnabled())
+                ++unit;
+            if (isLightmapEnabled())
+                ++unit;
+            uint maxLayers = getMaxLayers(terrain);
+            unit += std::min(terrain->getBlendTextureCount(maxLayers), terrain->getBlendTextureCount());
+            unit += std::min(maxLayers, static_cast<uint>(terrain->getLayerCount())) * 2;
+        }
+
+        if (isShadowingEnabled(tt, terrain))
+        {
+            if (getReceiveDynamicShadowsPSSM())
+                unit += (uint)getReceiveDynamicShadowsPSSM()->getSplitCount();
+            else
+                ++unit;
+        }
+        return unit;
+
     }
     //---------------------------------------------------------------------
     bool TerrainMaterialGeneratorA::SM2Profile::isShadowingEnabled(TechniqueType tt, const Terrain* terrain) const
@@ -574,13 +634,22 @@ namespace Ogre
             }
         }
 
-        if (terrain->_getUseVertexCompression() && tt != RENDER_COMPOSITE_MAP)
+        if ((terrain->_getUseVertexCompression() || terrain->_getUseSharedGrid()) && tt != RENDER_COMPOSITE_MAP)
         {
             Matrix4 posIndexToObjectSpace;
             terrain->getPointTransform(&posIndexToObjectSpace);
             params->setNamedConstant("posIndexToObjectSpace", posIndexToObjectSpace);
         }
 
+        if (terrain->_getUseSharedGrid() && tt != RENDER_COMPOSITE_MAP)
+        {
+            params->setNamedAutoConstant("gridOffset", GpuProgramParameters::ACT_CUSTOM, 
+                Terrain::SHARED_GRID_OFFSET_CUSTOM_PARAM);
+            // Explicitly bind the sampler for GLSL
+            if (prof->_getShaderLanguage() == "glsl")
+                params->setNamedConstant("heightDeltaMap", (int)prof->getHeightDeltaMapUnit(terrain, tt));
+        }
+
         
         
     }
@@ -721,12 +790,17 @@ namespace Ogre
             params->setNamedConstant("uvMul_" + StringConverter::toString(i), uvMul);
         }
         
-        if (terrain->_getUseVertexCompression() && tt != RENDER_COMPOSITE_MAP)
+        if ((terrain->_getUseVertexCompression() || terrain->_getUseSharedGrid()) && tt != RENDER_COMPOSITE_MAP)
         {
             Real baseUVScale = 1.0f / (terrain->getSize() - 1);
             params->setNamedConstant("baseUVScale", baseUVScale);
         }
 
+        if (terrain->_getUseSharedGrid() && tt != RENDER_COMPOSITE_MAP)
+        {
+            params->setNamedConstant("skirtSize", terrain->getSkirtSize());
+        }
+
     }
     //---------------------------------------------------------------------
     void TerrainMaterialGeneratorA::SM2Profile::ShaderHelper::updateFpParams(
@@ -84,8 +84,14 @@ namespace Ogre
     {
         outStream << "#version " << Root::getSingleton().getRenderSystem()->getNativeShadingLanguageVersion() << "\n";
 
+        bool sharedGrid = terrain->_getUseSharedGrid() && tt != RENDER_COMPOSITE_MAP;
         bool compression = terrain->_getUseVertexCompression() && tt != RENDER_COMPOSITE_MAP;
-        if (compression)
+        if (sharedGrid)
+        {
+            // x, y relative to the vertex data, skirt, lodThreshold
+            outStream << "in vec4 vertex;\n";
+        }
+        else if (compression)
         {
             outStream <<
                 "in vec2 posIndex;\n"
@@ -97,7 +103,7 @@ namespace Ogre
                 "in vec4 position;\n"
                 "in vec2 uv0;\n";
         }
-        if (tt != RENDER_COMPOSITE_MAP)
+        if (tt != RENDER_COMPOSITE_MAP && !sharedGrid)
             outStream << "in vec2 delta;\n"; // lodDelta, lodThreshold
 
         outStream <<
@@ -105,12 +111,19 @@ namespace Ogre
             "uniform mat4 viewProjMatrix;\n"
             "uniform vec2 lodMorph;\n"; // morph amount, morph LOD target
 
-        if (compression)
+        if (compression || sharedGrid)
         {
             outStream <<
                 "uniform mat4 posIndexToObjectSpace;\n"
                 "uniform float baseUVScale;\n";
         }
+        if (sharedGrid)
+        {
+            outStream <<
+                "uniform vec2 gridOffset;\n"
+                "uniform float skirtSize;\n"
+                "uniform sampler2D heightDeltaMap;\n"; // height, lodDelta
+        }
         // uv multipliers
         uint maxLayers = prof->getMaxLayers(terrain);
         uint numLayers = std::min(maxLayers, static_cast<uint>(terrain->getLayerCount()));
@@ -167,7 +180,15 @@ namespace Ogre
         }
 
         outStream << "void main(void) {\n";
-        if (compression)
+        if (sharedGrid)
+        {
+            outStream <<
+                "    vec2 posIndex = vertex.xy + gridOffset;\n"
+                "    vec2 heightDelta = texelFetch(heightDeltaMap, ivec2(posIndex), 0).xy;\n"
+                "    float height = heightDelta.x - vertex.z * skirtSize;\n"
+                "    vec2 delta = vec2(heightDelta.y, vertex.w);\n";
+        }
+        if (compression || sharedGrid)
         {
             outStream <<
                 "    vec4 position = posIndexToObjectSpace * vec4(posIndex, height, 1);\n"
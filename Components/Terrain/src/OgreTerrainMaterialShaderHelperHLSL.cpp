@@ -158,10 +158,24 @@ namespace Ogre
         outStream << "};\n";
         //output/input structure finished
 
+        bool sharedGrid = terrain->_getUseSharedGrid() && tt != RENDER_COMPOSITE_MAP;
+        if (sharedGrid)
+        {
+            // height, lodDelta; D3D11 binds every pass texture to the vertex stage too
+            outStream << 
+                "Texture2D heightDeltaMap : register(t" << prof->getHeightDeltaMapUnit(terrain, tt) << ");\n";
+        }
+
         outStream << 
             "v2p main_vp(\n";
         bool compression = terrain->_getUseVertexCompression() && tt != RENDER_COMPOSITE_MAP;
-        if (compression)
+        if (sharedGrid)
+        {
+            // x, y relative to the vertex data, skirt, lodThreshold
+            outStream << 
+                "int4 gridPos : POSITION,\n";
+        }
+        else if (compression)
         {
             outStream << 
                 "float2 posIndex : POSITION,\n"
@@ -174,7 +188,7 @@ namespace Ogre
                 "float2 uv  : TEXCOORD0,\n";
 
         }
-        if (tt != RENDER_COMPOSITE_MAP)
+        if (tt != RENDER_COMPOSITE_MAP && !sharedGrid)
             outStream << "float2 delta  : TEXCOORD1,\n"; // lodDelta, lodThreshold
 
         outStream << 
@@ -182,12 +196,18 @@ namespace Ogre
             "uniform matrix viewProjMatrix,\n"
             "uniform float2   lodMorph,\n"; // morph amount, morph LOD target
 
-        if (compression)
+        if (compression || sharedGrid)
         {
             outStream << 
                 "uniform matrix   posIndexToObjectSpace,\n"
                 "uniform float    baseUVScale,\n";
         }
+        if (sharedGrid)
+        {
+            outStream << 
+                "uniform float2   gridOffset,\n"
+                "uniform float    skirtSize,\n";
+        }
 
         for (uint i = 0; i < numUVMultipliers - 1; ++i)
             outStream << "uniform float4 uvMul_" << i << ", \n";
@@ -215,7 +235,15 @@ namespace Ogre
         outStream <<
             ")\n"
             "{\n";
-        if (compression)
+        if (sharedGrid)
+        {
+            outStream <<
+                "   float2 posIndex = float2(gridPos.xy) + gridOffset;\n"
+                "   float2 heightDelta = heightDeltaMap.Load(int3(posIndex, 0)).xy;\n"
+                "   float height = heightDelta.x - gridPos.z * skirtSize;\n"
+                "   float2 delta = float2(heightDelta.y, gridPos.w);\n";
+        }
+        if (compression || sharedGrid)
         {
             outStream <<
                 "   float4 pos;\n"
@@ -268,6 +268,12 @@ namespace Ogre
     {
         createGpuVertexData();
         createGpuIndexData();
+        if (mTerrain->_getUseSharedGrid())
+        {
+            // where the shared grid is placed in the terrain
+            mRend->setCustomParameter(Terrain::SHARED_GRID_OFFSET_CUSTOM_PARAM, 
+                Vector4(mNodeWithVertexData->mOffsetX, mNodeWithVertexData->mOffsetY, 0, 0));
+        }
         if (!mLocalNode)
             mLocalNode = mTerrain->_getRootSceneNode()->createChildSceneNode(mLocalCentre);
 
@@ -522,7 +528,21 @@ namespace Ogre
             || rect.top <= mBoundaryY || rect.bottom > mOffsetY)
         {
             // Do we have vertex data?
-            if (mVertexDataRecord)
+            if (mVertexDataRecord && mTerrain->_getUseSharedGrid())
+            {
+                // Shared grid vertices are never updated, the terrain updates its
+                // height / delta texture instead
+                if (positions)
+                {
+                    Rect updateRect(mOffsetX, mOffsetY, mBoundaryX, mBoundaryY);
+                    updateRect.left = std::max(updateRect.left, rect.left);
+                    updateRect.right = std::min(updateRect.right, rect.right);
+                    updateRect.top = std::max(updateRect.top, rect.top);
+                    updateRect.bottom = std::min(updateRect.bottom, rect.bottom);
+                    updateBounds(updateRect);
+                }
+            }
+            else if (mVertexDataRecord)
             {
                 // Trim to our bounds
                 Rect updateRect(mOffsetX, mOffsetY, mBoundaryX, mBoundaryY);
@@ -585,7 +605,18 @@ namespace Ogre
     //---------------------------------------------------------------------
     void TerrainQuadTreeNode::createCpuVertexData()
     {
-        if (mVertexDataRecord)
+        if (mVertexDataRecord && mTerrain->_getUseSharedGrid())
+        {
+            destroyCpuVertexData();
+
+            // Vertices come from a grid shared by all vertex data of this layout,
+            // with heights from the terrain's height / delta texture, so there
+            // is nothing to build except the skirt layout and the bounds
+            mVertexDataRecord->numSkirtRowsCols = (uint16)(Math::Pow(2, mVertexDataRecord->treeLevels) + 1);
+            mVertexDataRecord->skirtRowColSkip = (mVertexDataRecord->size - 1) / (mVertexDataRecord->numSkirtRowsCols - 1);
+            updateBounds(Rect(mOffsetX, mOffsetY, mBoundaryX, mBoundaryY));
+        }
+        else if (mVertexDataRecord)
         {
             destroyCpuVertexData();
 
@@ -900,6 +931,30 @@ namespace Ogre
         
     }
     //---------------------------------------------------------------------
+    void TerrainQuadTreeNode::updateBounds(const Rect& rect)
+    {
+        resetBounds(rect);
+
+        uint16 inc = (mTerrain->getSize()-1) / (mVertexDataRecord->resolution-1);
+        // clamp to the vertices at this resolution (round up)
+        long startX = rect.left;
+        long startY = rect.top;
+        if ((startX - mOffsetX) % inc)
+            startX += inc - (startX - mOffsetX) % inc;
+        if ((startY - mOffsetY) % inc)
+            startY += inc - (startY - mOffsetY) % inc;
+        Vector3 pos;
+        for (long y = startY; y < rect.bottom; y += inc)
+        {
+            const float* pHeight = mTerrain->getHeightData(startX, y);
+            for (long x = startX; x < rect.right; x += inc, pHeight += inc)
+            {
+                mTerrain->getPoint(x, y, *pHeight, &pos);
+                mergeIntoBounds(x, y, pos);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
     void TerrainQuadTreeNode::writePosVertex(bool compress, uint16 x, uint16 y, float height, 
         const Vector3& pos, float uvScale, float** ppPos)
     {
@@ -1013,8 +1068,24 @@ namespace Ogre
     //---------------------------------------------------------------------
     void TerrainQuadTreeNode::createGpuVertexData()
     {
+        if (mVertexDataRecord && !mVertexDataRecord->gpuVertexData && mTerrain->_getUseSharedGrid())
+        {
+            uint16 inc = (mTerrain->getSize()-1) / (mVertexDataRecord->resolution-1);
+            HardwareVertexBufferSharedPtr gridBuf = mTerrain->getGpuBufferAllocator()->getSharedGridVertexBuffer(
+                mTerrain, mVertexDataRecord->size, inc, 
+                mVertexDataRecord->numSkirtRowsCols, mVertexDataRecord->skirtRowColSkip);
+
+            mVertexDataRecord->gpuVertexData = OGRE_NEW VertexData();
+            VertexData* destData = mVertexDataRecord->gpuVertexData;
+            // short4(x, y, skirt, deltaLODthreshold), x / y relative to this node's vertex data
+            destData->vertexDeclaration->addElement(POSITION_BUFFER, 0, VET_SHORT4, VES_POSITION);
+            destData->vertexBufferBinding->setBinding(POSITION_BUFFER, gridBuf);
+            destData->vertexStart = 0;
+            destData->vertexCount = gridBuf->getNumVertices();
+            mVertexDataRecord->sharedGrid = true;
+        }
         // TODO - mutex cpu data
-        if (mVertexDataRecord && mVertexDataRecord->cpuVertexData && !mVertexDataRecord->gpuVertexData)
+        else if (mVertexDataRecord && mVertexDataRecord->cpuVertexData && !mVertexDataRecord->gpuVertexData)
         {
             // copy data from CPU to GPU, but re-use vertex buffers (so don't use regular clone)
             mVertexDataRecord->gpuVertexData = OGRE_NEW VertexData();
@@ -1076,11 +1147,16 @@ namespace Ogre
         if (mVertexDataRecord && mVertexDataRecord->gpuVertexData)
         {
             // Before we delete, free up the vertex buffers for someone else
-            mTerrain->getGpuBufferAllocator()->freeVertexBuffers(
-                mVertexDataRecord->gpuVertexData->vertexBufferBinding->getBuffer(POSITION_BUFFER), 
-                mVertexDataRecord->gpuVertexData->vertexBufferBinding->getBuffer(DELTA_BUFFER));
+            // (a shared grid is owned by the allocator)
+            if (!mVertexDataRecord->sharedGrid)
+            {
+                mTerrain->getGpuBufferAllocator()->freeVertexBuffers(
+                    mVertexDataRecord->gpuVertexData->vertexBufferBinding->getBuffer(POSITION_BUFFER), 
+                    mVertexDataRecord->gpuVertexData->vertexBufferBinding->getBuffer(DELTA_BUFFER));
+            }
             OGRE_DELETE mVertexDataRecord->gpuVertexData;
             mVertexDataRecord->gpuVertexData = 0;
+            mVertexDataRecord->sharedGrid = false;
         }
 
 
@@ -1451,7 +1527,7 @@ namespace Ogre
     //---------------------------------------------------------------------
     void TerrainQuadTreeNode::getWorldTransforms(Matrix4* xform) const
     {
-        if (mTerrain->_getUseVertexCompression())
+        if (mTerrain->_getUseVertexCompression() || mTerrain->_getUseSharedGrid())
         {
             // vertex data is generated in terrain space
             *xform = Matrix4::IDENTITY;
@@ -461,6 +461,14 @@ namespace Ogre {
             global keyframe time list.
         */
         TimeIndex _getTimeIndex(Real timePos) const;
+
+        /** Internal method which builds the data otherwise derived lazily the first
+            time this animation is applied after a change.
+        @remarks
+            Once this is done, applying the animation only reads from it, so it can be
+            applied to several targets from different threads at once.
+        */
+        void _buildCachedData(void) const;
         
         /** Sets a base keyframe which for the skeletal / pose keyframes 
             in this animation. 
@@ -366,6 +366,10 @@ namespace Ogre
         /// @copydoc AnimationTrack::_keyFrameDataChanged
         void _keyFrameDataChanged(void) const;
 
+        /** Internal method which builds the interpolation splines right away if they
+            are out of date, instead of on the next getInterpolatedKeyFrame call. */
+        void _buildInterpolationSplines(void) const;
+
         /** Returns the KeyFrame at the specified index. */
         virtual TransformKeyFrame* getNodeKeyFrame(unsigned short index) const;
 
@@ -57,6 +57,31 @@ namespace Ogre {
     */
     class _OgreExport AutoParamDataSource : public SceneMgtAlloc
     {
+    public:
+        /** Groups of source data which auto constants are derived from.
+        @remarks
+            Every group carries a version which is renewed whenever data belonging to
+            it is set, so that GpuProgramParameters can skip recalculating constants
+            whose sources did not change since they were last written.
+        */
+        enum SourceGroup
+        {
+            /// The current renderable and its world matrices
+            SG_RENDERABLE,
+            /// The current camera and the bounds visible to it
+            SG_CAMERA,
+            /// The current light list, texture projectors and shadow extrusion distance
+            SG_LIGHTS,
+            /// The current pass and pass number
+            SG_PASS,
+            /// The scene manager, ambient light and fog
+            SG_SCENE,
+            /// The current render target and viewport
+            SG_VIEWPORT,
+            /// The controller time
+            SG_TIME,
+            SG_COUNT
+        };
     protected:
         const Light& getLight(size_t index) const;
         mutable Matrix4 mWorldMatrix[256];
@@ -123,6 +148,20 @@ namespace Ogre {
         const Pass* mCurrentPass;
 
         Light mBlankLight;
+
+        /// Whether the current renderable overrides the view and projection matrices
+        bool mIdentityView;
+        bool mIdentityProjection;
+
+        /// Current version of each group of source data
+        mutable uint64 mVersions[SG_COUNT];
+        /// Controller time the time version was last renewed for
+        mutable Real mVersionedTime;
+        /// Last version handed out, shared by all data sources
+        static uint64 msVersionCounter;
+
+        /// Renews the version of a group of source data
+        void renewVersion(SourceGroup group) const { mVersions[group] = ++msVersionCounter; }
     public:
         AutoParamDataSource();
         virtual ~AutoParamDataSource();
@@ -257,6 +296,20 @@ namespace Ogre {
         virtual void setPassNumber(const int passNumber);
         virtual void incPassNumber(void);
         virtual void updateLightCustomGpuParameter(const GpuProgramParameters::AutoConstantEntry& constantEntry, GpuProgramParameters *params) const;
+
+        /** Gets the current version of a group of source data.
+        @remarks
+            Versions are handed out from a counter shared by all data sources, so they
+            only ever grow. A value derived from the group is therefore still current as
+            long as the version has not grown past the point it was written at. The time
+            version is renewed lazily whenever the controller time has moved on.
+        */
+        uint64 getVersion(SourceGroup group) const;
+        /** Hands out a version greater than any handed out before.
+        @remarks
+            GpuProgramParameters stamps the auto constants it writes with these.
+        */
+        static uint64 _allocateVersion(void) { return ++msVersionCounter; }
     };
     /** @} */
     /** @} */
@@ -291,6 +291,8 @@ namespace Ogre {
         VertexData* mVertexData;
         /// Index data (to allow multiple unconnected chains)
         IndexData* mIndexData;
+        /// Index buffer owned by the chain, used when indexes are not streamed
+        HardwareIndexBufferSharedPtr mIndexBuffer;
         /// Is the vertex declaration dirty?
         bool mVertexDeclDirty;
         /// Do the buffers need recreating?
@@ -297,6 +297,10 @@ namespace Ogre {
         bool mAutoUpdate;
         /// True if the billboard data changed. Will cause vertex buffer update.
         bool mBillboardDataChanged;
+        /// Streaming buffer the current vertices were written to, 0 if mMainBuf is used.
+        HardwareStreamingBuffer* mStreamingBuffer;
+        /// First vertex of the current billboards in the bound vertex buffer.
+        size_t mVertexStart;
 
         /** Internal method creates vertex and index buffers.
         */
@@ -132,6 +132,15 @@ namespace Ogre {
         /// Stored number of visible batches in the last render
         unsigned int mVisBatchesLastRender;
 
+        /// Stored number of bytes of shader constants uploaded in the last render
+        size_t mConstantBytesLastRender;
+
+        /// Stored number of scene nodes which passed frustum culling in the last render
+        unsigned int mVisNodesLastRender;
+
+        /// Stored number of scene nodes rejected by frustum culling in the last render
+        unsigned int mCulledNodesLastRender;
+
         /// Shared class-level name for Movable type
         static String msMovableType;
 
@@ -355,6 +364,34 @@ namespace Ogre {
         */
         unsigned int _getNumRenderedBatches(void) const;
 
+        /** Internal method to notify camera of the shader constant bytes uploaded in the last render.
+        */
+        void _notifyUploadedConstantBytes(size_t numbytes) { mConstantBytesLastRender = numbytes; }
+
+        /** Internal method to retrieve the shader constant bytes uploaded in the last render.
+        */
+        size_t _getNumUploadedConstantBytes(void) const { return mConstantBytesLastRender; }
+
+        /** Internal method to notify camera of the frustum culling results in the last render.
+        */
+        void _notifyCulledNodes(unsigned int numVisible, unsigned int numCulled);
+
+        /** Internal method to retrieve the number of scene nodes which passed frustum
+            culling in the last render.
+        @note
+            Only maintained when the SceneManager uses batched culling, see
+            SceneManager::setBatchedCullingEnabled.
+        */
+        unsigned int _getNumVisibleNodes(void) const;
+
+        /** Internal method to retrieve the number of scene nodes rejected by frustum
+            culling in the last render.
+        @note
+            Only maintained when the SceneManager uses batched culling, see
+            SceneManager::setBatchedCullingEnabled.
+        */
+        unsigned int _getNumCulledNodes(void) const;
+
         /** Gets the derived orientation of the camera, including any
             rotation inherited from a node attachment and reflection matrix. */
         const Quaternion& getDerivedOrientation(void) const;
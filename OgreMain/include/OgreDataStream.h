@@ -474,6 +474,31 @@ namespace Ogre {
         void setFreeOnClose(bool free) { mFreeOnClose = free; }
     };
 
+    /** Subclass of MemoryDataStream which maps a file into memory instead of
+        reading it.
+    @remarks
+        The contents of the file are paged in by the operating system as they
+        are accessed, so the data can be used straight from getCurrentPtr without
+        first being copied into a heap buffer. The stream is always read-only and
+        the file must not be modified while the stream is open. On platforms
+        without memory mapping the file is read into memory instead.
+    */
+    class _OgreExport MemoryMappedDataStream : public MemoryDataStream
+    {
+    public:
+        /** Maps a file into memory.
+        @param name The name to give the stream
+        @param path The path of the file on disk
+        @param size The size of the file in bytes, must not be 0
+        */
+        MemoryMappedDataStream(const String& name, const String& path, size_t size);
+        ~MemoryMappedDataStream();
+
+        /** @copydoc DataStream::close
+        */
+        void close(void);
+    };
+
     /** Common subclass of DataStream for handling data from 
         std::basic_istream.
     */
@@ -156,6 +156,12 @@ namespace Ogre {
     */
     class _OgreExport DefaultHardwareBufferManagerBase : public HardwareBufferManagerBase
     {
+    protected:
+        /// Creates a streaming buffer in plain memory, nothing needs fencing
+        HardwareStreamingBuffer* createStreamingBufferImpl(size_t vertexSize, size_t numVertices);
+        /// Creates a streaming index buffer in plain memory
+        HardwareStreamingBuffer* createStreamingIndexBufferImpl(
+            HardwareIndexBuffer::IndexType itype, size_t numIndexes);
     public:
         DefaultHardwareBufferManagerBase();
         ~DefaultHardwareBufferManagerBase();
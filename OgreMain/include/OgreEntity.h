@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "OgreHardwareBufferManager.h"
 #include "OgreRenderable.h"
 #include "OgreResourceGroupManager.h"
+#include "OgreMesh.h"
 
 namespace Ogre {
     /** \addtogroup Core
@@ -182,6 +183,10 @@ namespace Ogre {
         /// Perform all the updates required for an animated entity.
         void updateAnimation(void);
 
+        /// Works out how the animation of this entity has to be performed this frame.
+        void getAnimationMode(bool& hwAnimation, bool& stencilShadows,
+            bool& softwareAnimation, bool& blendNormals);
+
         /// Records the last frame in which the bones was updated.
         /// It's a pointer because it can be shared between different entities with
         /// a shared skeleton.
@@ -752,6 +757,35 @@ namespace Ogre {
         */
         bool _isSkeletonAnimated(void) const;
 
+        /** Advanced method to start a skeletal animation update which is split
+            across threads by the SceneManager.
+        @remarks
+            Only entities with a skeleton of their own, no vertex animation, no
+            manual LOD and no objects attached to bones can be updated this way.
+            Must be called from the rendering thread.
+        @return
+            True if the animation needs updating this frame and the update can be
+            split, in which case _updateBoneMatricesConcurrent, _prepareSoftwareSkinning
+            and _finishConcurrentAnimation must follow. False if the update is left
+            to _updateAnimation.
+        */
+        bool _beginConcurrentAnimation(void);
+
+        /** Evaluates the animation states into the bone matrices. May be called
+            from a worker thread, concurrently with other entities.
+        */
+        void _updateBoneMatricesConcurrent(void);
+
+        /** Checks out the software skinning buffers and locks them, adding one
+            blend job per blended vertex data. Must be called from the rendering thread.
+        */
+        void _prepareSoftwareSkinning(Mesh::SoftwareVertexBlendJobList& jobs,
+            Mesh::LockedVertexBufferMap& lockedBuffers);
+
+        /** Marks the animation as up to date once the blend jobs have been run.
+        */
+        void _finishConcurrentAnimation(void);
+
         /** Advanced method to get the temporarily blended skeletal vertex information
             for entities which are software skinned.
         @remarks
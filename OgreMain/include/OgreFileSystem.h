@@ -119,7 +119,23 @@ namespace Ogre {
             return msIgnoreHidden;
         }
 
+        /// Set whether files opened read-only are mapped into memory rather than
+        /// read through a file stream, see MemoryMappedDataStream. This lets loaders
+        /// which handle MemoryDataStream specially, like the MeshSerializer, use the
+        /// file contents in place. The default is false.
+        static void setMemoryMapping(bool map)
+        {
+            msMemoryMapping = map;
+        }
+
+        /// Get whether files opened read-only are mapped into memory.
+        static bool getMemoryMapping()
+        {
+            return msMemoryMapping;
+        }
+
         static bool msIgnoreHidden;
+        static bool msMemoryMapping;
     };
 
     /** Specialisation of ArchiveFactory for FileSystem files. */
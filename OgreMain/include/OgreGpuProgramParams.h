@@ -1417,16 +1417,24 @@ namespace Ogre {
             };
             /// The variability of this parameter (see GpuParamVariability)
             uint16 variability;
+            /** Mask of the AutoParamDataSource::SourceGroup the value is derived from,
+                0 if it has to be recalculated on every update */
+            uint16 sourceGroups;
+            /** Version the value was last written at by _updateAutoParams, 0 if it
+                has not been written since the entry was set up */
+            uint64 updateStamp;
 
         AutoConstantEntry(AutoConstantType theType, size_t theIndex, size_t theData,
                           uint16 theVariability, size_t theElemCount = 4)
             : paramType(theType), physicalIndex(theIndex), elementCount(theElemCount),
-                data(theData), variability(theVariability) {}
+                data(theData), variability(theVariability),
+                sourceGroups(deriveSourceGroups(theType)), updateStamp(0) {}
 
         AutoConstantEntry(AutoConstantType theType, size_t theIndex, Real theData,
                           uint16 theVariability, size_t theElemCount = 4)
             : paramType(theType), physicalIndex(theIndex), elementCount(theElemCount),
-                fData(theData), variability(theVariability) {}
+                fData(theData), variability(theVariability),
+                sourceGroups(deriveSourceGroups(theType)), updateStamp(0) {}
 
         };
         // Auto parameter storage
@@ -1496,9 +1504,13 @@ namespace Ogre {
         bool mIgnoreMissingParams;
         /// physical index for active pass iteration parameter real constant entry;
         size_t mActivePassIterationIndex;
+        /// The data source the auto constants were last updated from
+        const AutoParamDataSource* mLastAutoParamSource;
 
         /// Return the variability for an auto constant
         uint16 deriveVariability(AutoConstantType act);
+        /// Return the mask of AutoParamDataSource::SourceGroup an auto constant is derived from
+        static uint16 deriveSourceGroups(AutoConstantType act);
 
         void copySharedParamSetUsage(const GpuSharedParamUsageList& srcList);
 
@@ -2029,6 +2041,10 @@ namespace Ogre {
         const AutoConstantEntry* _findRawAutoConstantEntryBool(size_t physicalIndex) const;
 
         /** Update automatic parameters.
+            @remarks
+                Parameters whose source data did not change since they were last
+                updated from the same source keep their value, which leaves their
+                updateStamp untouched so render systems can skip uploading them too.
             @param source The source of the parameters
             @param variabilityMask A mask of GpuParamVariability which identifies which autos will need updating
         */
@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include "OgreSingleton.h"
 #include "OgreHardwareCounterBuffer.h"
 #include "OgreHardwareIndexBuffer.h"
+#include "OgreHardwareStreamingBuffer.h"
 #include "OgreHardwareUniformBuffer.h"
 #include "OgreHardwareVertexBuffer.h"
 #include "Threading/OgreThreadHeaders.h"
@@ -215,6 +216,31 @@ namespace Ogre {
             const HardwareVertexBufferSharedPtr& source, 
             HardwareBuffer::Usage usage, bool useShadowBuffer);
 
+        /// Map from vertex size to the streaming buffer for it, 0 if not supported.
+        typedef map<size_t, HardwareStreamingBuffer*>::type StreamingBufferMap;
+        StreamingBufferMap mStreamingBuffers;
+        /// Map from index type to the streaming buffer for it, 0 if not supported.
+        StreamingBufferMap mStreamingIndexBuffers;
+        /// Size of newly created streaming buffers in bytes.
+        size_t mStreamingBufferSize;
+        OGRE_MUTEX(mStreamingBuffersMutex);
+
+        /** Creates a streaming buffer, may be overridden by rendering APIs which support them.
+        @return
+            The new streaming buffer, or 0 if not supported. The default
+            implementation returns 0.
+        */
+        virtual HardwareStreamingBuffer* createStreamingBufferImpl(size_t vertexSize, size_t numVertices);
+        /** Creates a streaming index buffer, may be overridden by rendering APIs which support them.
+        @return
+            The new streaming buffer, or 0 if not supported. The default
+            implementation returns 0.
+        */
+        virtual HardwareStreamingBuffer* createStreamingIndexBufferImpl(
+            HardwareIndexBuffer::IndexType itype, size_t numIndexes);
+        /// Internal method for destroys all streaming buffers.
+        void destroyAllStreamingBuffers(void);
+
     public:
         HardwareBufferManagerBase();
         virtual ~HardwareBufferManagerBase();
@@ -300,6 +326,37 @@ namespace Ogre {
                                                                    HardwareBuffer::Usage usage = HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE,
                                                                    bool useShadowBuffer = false, const String& name = "") = 0;
 
+        /** Returns the streaming buffer for vertices of a given size.
+        @remarks
+            Streaming buffers are rings of vertex memory which stay mapped,
+            for geometry which is rebuilt every frame. They are created on
+            first use and shared by every caller using the same vertex size.
+        @see HardwareStreamingBuffer
+        @param vertexSize
+            The size in bytes of each vertex.
+        @return
+            The streaming buffer, or 0 if the render system does not support them.
+        */
+        virtual HardwareStreamingBuffer* getStreamingBuffer(size_t vertexSize);
+        /** Returns the streaming buffer for indexes of a given type.
+        @remarks
+            Like getStreamingBuffer, for index data which is rebuilt every frame.
+        @param itype
+            The type of index.
+        @return
+            The streaming buffer, or 0 if the render system does not support them.
+        */
+        virtual HardwareStreamingBuffer* getStreamingIndexBuffer(HardwareIndexBuffer::IndexType itype);
+        /** Sets the size in bytes of streaming buffers created from now on. */
+        virtual void setStreamingBufferSize(size_t sizeInBytes) { mStreamingBufferSize = sizeInBytes; }
+        /** Gets the size in bytes of newly created streaming buffers. */
+        virtual size_t getStreamingBufferSize(void) const { return mStreamingBufferSize; }
+        /** Internal method for ending the current frame of all streaming buffers;
+            is called by OGRE.
+        @see HardwareStreamingBuffer::_endFrame
+        */
+        virtual void _endStreamingFrame(void);
+
         /** Creates a new vertex declaration. */
         virtual VertexDeclaration* createVertexDeclaration(void);
         /** Destroys a vertex declaration. */
@@ -469,6 +526,31 @@ namespace Ogre {
         {
             return mImpl->createCounterBuffer(sizeBytes, usage, useShadowBuffer, name);
         }
+        /** @copydoc HardwareBufferManagerBase::getStreamingBuffer */
+        virtual HardwareStreamingBuffer* getStreamingBuffer(size_t vertexSize)
+        {
+            return mImpl->getStreamingBuffer(vertexSize);
+        }
+        /** @copydoc HardwareBufferManagerBase::getStreamingIndexBuffer */
+        virtual HardwareStreamingBuffer* getStreamingIndexBuffer(HardwareIndexBuffer::IndexType itype)
+        {
+            return mImpl->getStreamingIndexBuffer(itype);
+        }
+        /** @copydoc HardwareBufferManagerBase::setStreamingBufferSize */
+        virtual void setStreamingBufferSize(size_t sizeInBytes)
+        {
+            mImpl->setStreamingBufferSize(sizeInBytes);
+        }
+        /** @copydoc HardwareBufferManagerBase::getStreamingBufferSize */
+        virtual size_t getStreamingBufferSize(void) const
+        {
+            return mImpl->getStreamingBufferSize();
+        }
+        /** @copydoc HardwareBufferManagerBase::_endStreamingFrame */
+        virtual void _endStreamingFrame(void)
+        {
+            mImpl->_endStreamingFrame();
+        }
 
         virtual VertexDeclaration* createVertexDeclaration(void)
         {
@@ -0,0 +1,172 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __HardwareStreamingBuffer__
+#define __HardwareStreamingBuffer__
+
+// Precompiler options
+#include "OgrePrerequisites.h"
+#include "OgreHardwareIndexBuffer.h"
+#include "OgreHardwareVertexBuffer.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup RenderSystem
+    *  @{
+    */
+    /** Ring of vertex or index memory for geometry which is rebuilt every frame.
+    @remarks
+        Geometry which is regenerated every frame, such as billboards, particles
+        and ribbon trails, normally locks its own vertex or index buffer with
+        HBL_DISCARD each time, which costs a map / unmap round trip and usually
+        a reallocation inside the driver. A streaming buffer instead hands out
+        ranges of one large buffer which stays mapped for its whole lifetime,
+        so the caller can write straight into it and render the range by
+        binding getVertexBuffer() with VertexData::vertexStart, or
+        getIndexBuffer() with IndexData::indexStart, set to the returned start.
+    @par
+        Ranges are reclaimed a frame at a time. All ranges allocated between
+        two calls to _endFrame() form one frame, which is handed back once the
+        render system reports that the GPU has finished reading it. The data
+        is therefore only valid for the frame it was allocated in, callers
+        must allocate and fill again every frame they render.
+    @par
+        Streaming buffers are obtained through
+        HardwareBufferManagerBase::getStreamingBuffer, one per vertex size, and
+        HardwareBufferManagerBase::getStreamingIndexBuffer, one per index type.
+        This base class does no synchronisation at all and is suitable for
+        memory the GPU never reads; render systems subclass it to fence the
+        frames.
+    */
+    class _OgreExport HardwareStreamingBuffer : public BufferAlloc
+    {
+    protected:
+        /** A frame of allocations which the GPU may still be reading. */
+        struct PendingFrame
+        {
+            /// Number of elements used by the frame, including padding at the end of the ring
+            size_t numElements;
+            /// Render system specific fence, 0 if there is nothing to wait for
+            void* fence;
+        };
+        typedef deque<PendingFrame>::type PendingFrameList;
+
+        /// Vertex buffer covering the whole ring, null for an index ring
+        HardwareVertexBufferSharedPtr mVertexBuffer;
+        /// Index buffer covering the whole ring, null for a vertex ring
+        HardwareIndexBufferSharedPtr mIndexBuffer;
+        /// CPU address of the first element of the ring
+        unsigned char* mData;
+        /// Size in bytes of one vertex or index
+        size_t mElementSize;
+        /// Number of vertices or indexes in the ring
+        size_t mNumElements;
+        /// Next element to allocate from
+        size_t mHead;
+        /// Elements in use, from the oldest pending frame up to mHead
+        size_t mUsedElements;
+        /// Elements allocated since the last call to _endFrame
+        size_t mFrameElements;
+        /// Frames waiting for the GPU, oldest first
+        PendingFrameList mPendingFrames;
+
+        /** Inserts a fence after the commands issued so far.
+        @return
+            An opaque handle passed back to waitFence, isFenceSignalled and
+            deleteFence, or 0 if the frame can be reused straight away.
+        */
+        virtual void* createFence(void) { return 0; }
+        /// Returns whether the GPU has passed the fence, without blocking.
+        virtual bool isFenceSignalled(void* fence) { return true; }
+        /// Blocks until the GPU has passed the fence.
+        virtual void waitFence(void* fence) {}
+        /// Releases a fence returned by createFence.
+        virtual void deleteFence(void* fence) {}
+
+        /// Hands the oldest pending frame back to the ring, waiting for it if needed.
+        void retireOldestFrame(bool wait);
+
+    public:
+        /** Constructor for a ring of vertices.
+        @note
+            Subclasses which create fences must release the ones still
+            pending in their own destructor.
+        @param buffer
+            The vertex buffer the ring lives in.
+        @param data
+            CPU address the buffer is mapped at for the lifetime of this object.
+        */
+        HardwareStreamingBuffer(const HardwareVertexBufferSharedPtr& buffer, void* data);
+        /** Constructor for a ring of indexes.
+        @copydetails HardwareStreamingBuffer::HardwareStreamingBuffer(const HardwareVertexBufferSharedPtr&, void*)
+        */
+        HardwareStreamingBuffer(const HardwareIndexBufferSharedPtr& buffer, void* data);
+        virtual ~HardwareStreamingBuffer();
+
+        /** Reserves a range of vertices or indexes for this frame.
+        @remarks
+            Ranges are never split across the end of the ring, and are never
+            taken from a frame the GPU may still be reading. If the ring is
+            too small to satisfy the request without overwriting data of the
+            current frame 0 is returned, callers should then fall back to
+            their own buffer.
+        @param numElements
+            Number of vertices or indexes to reserve.
+        @param start
+            Receives the index of the first reserved element in the buffer.
+        @return
+            Write pointer to the first reserved element, or 0 on failure.
+        */
+        void* allocate(size_t numElements, size_t& start);
+
+        /** Marks the end of a frame.
+        @remarks
+            Everything allocated since the last call is fenced and reused once
+            the GPU has finished with it. Called by the HardwareBufferManager
+            once per frame.
+        */
+        void _endFrame(void);
+
+        /// Returns the vertex buffer to bind when rendering allocated ranges, null for an index ring.
+        const HardwareVertexBufferSharedPtr& getVertexBuffer(void) const { return mVertexBuffer; }
+        /// Returns the index buffer to bind when rendering allocated ranges, null for a vertex ring.
+        const HardwareIndexBufferSharedPtr& getIndexBuffer(void) const { return mIndexBuffer; }
+        /// Returns the size of one vertex or index in bytes.
+        size_t getElementSize(void) const { return mElementSize; }
+        /// Returns the capacity of the ring in vertices or indexes.
+        size_t getNumElements(void) const { return mNumElements; }
+        /// Returns the number of elements which cannot be allocated at the moment.
+        size_t getUsedElements(void) const { return mUsedElements; }
+    };
+
+    /** @} */
+    /** @} */
+}
+
+#endif
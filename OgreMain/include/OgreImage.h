@@ -422,7 +422,29 @@ namespace Ogre {
         
         /** Resize a 2D image, applying the appropriate filter. */
         void resize(ushort width, ushort height, Filter filter = FILTER_BILINEAR);
-        
+
+        /** Generates the complete mipmap chain of the image, down to 1x1.
+            @remarks
+                The top level of every face is kept, any mipmaps the image
+                had are replaced. Faces and levels end up in a single buffer,
+                laid out as getPixelBox expects, so the image can be uploaded
+                as it is.
+            @par
+                The box filter, which FILTER_LINEAR and FILTER_BILINEAR also
+                select, averages 2x2 pixels. For 2D images with 8 bits per
+                channel or 32-bit float channels it runs on all threads
+                PixelUtil::setNumWorkerThreads allows. Other filters, formats
+                and volume images go through scale().
+            @param gammaCorrected
+                Average the colour channels of 8 bit per channel formats in
+                linear space, for images holding sRGB data. Alpha stays linear.
+            @param filter
+                Filter to build each level from the one above it with.
+            @return
+                False if the image is compressed, true otherwise.
+        */
+        bool generateMipmaps(bool gammaCorrected = false, Filter filter = FILTER_BOX);
+
         /// Static function to calculate size in bytes from the number of mipmaps, faces and the dimensions
         static size_t calculateSize(size_t mipmaps, size_t faces, uint32 width, uint32 height, uint32 depth, PixelFormat format);
 
@@ -30,6 +30,7 @@ THE SOFTWARE.
 
 #include "OgrePrerequisites.h"
 #include "OgreRenderOperation.h"
+#include "Threading/OgreLightweightMutex.h"
 
 namespace Ogre
 {
@@ -105,6 +106,8 @@ namespace Ogre
         size_t                  mIdCount;
 
         InstanceBatchVec        mDirtyBatches;
+        /// Batches can be flagged dirty from the SceneManager worker threads
+        LightweightMutex        mDirtyBatchesMutex;
 
         RenderOperation         mSharedRenderOperation;
 
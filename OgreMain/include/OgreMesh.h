@@ -795,6 +795,53 @@ namespace Ogre {
             const Matrix4* const* blendMatrices, size_t numMatrices,
             bool blendNormals);
 
+        /// Locked data of a software vertex blend, see _prepareSoftwareVertexBlend
+        struct SoftwareVertexBlendJob
+        {
+            const float* srcPos;
+            const float* srcNorm;
+            float* destPos;
+            float* destNorm;
+            const float* blendWeights;
+            const unsigned char* blendIndices;
+            size_t srcPosStride;
+            size_t srcNormStride;
+            size_t destPosStride;
+            size_t destNormStride;
+            size_t blendWeightStride;
+            size_t blendIdxStride;
+            unsigned short numWeightsPerVertex;
+            size_t vertexCount;
+            /// Matrices indexed by the blend indices, see prepareMatricesForVertexBlend
+            const Matrix4* blendMatrices[256];
+        };
+        typedef vector<SoftwareVertexBlendJob>::type SoftwareVertexBlendJobList;
+        /// Buffers locked by _prepareSoftwareVertexBlend, with their locked data
+        typedef map<HardwareVertexBuffer*, void*>::type LockedVertexBufferMap;
+
+        /** Splits softwareVertexBlend so that the blend itself can be run on
+            other threads.
+        @remarks
+            This locks the buffers softwareVertexBlend would (any already in
+            lockedBuffers are not locked again, so source data shared between
+            several blends is fine) and fills in job apart from its blend matrices.
+            The job can then be blended with _applySoftwareVertexBlend, from any
+            thread, after which the buffers must be unlocked with
+            _unlockVertexBlendBuffers on the thread which locked them.
+        */
+        static void _prepareSoftwareVertexBlend(const VertexData* sourceVertexData,
+            const VertexData* targetVertexData, bool blendNormals,
+            SoftwareVertexBlendJob& job, LockedVertexBufferMap& lockedBuffers);
+
+        /** Blends count vertices of a job prepared with _prepareSoftwareVertexBlend,
+            starting at the given vertex. Disjoint ranges of the same job can be blended
+            concurrently. */
+        static void _applySoftwareVertexBlend(const SoftwareVertexBlendJob& job,
+            size_t start, size_t count);
+
+        /** Unlocks and forgets the buffers locked by _prepareSoftwareVertexBlend. */
+        static void _unlockVertexBlendBuffers(LockedVertexBufferMap& lockedBuffers);
+
         /** Performs a software vertex morph, of the kind used for
             morph animation although it can be used for other purposes. 
         @remarks
@@ -155,6 +155,15 @@ namespace Ogre {
         */
         void importMesh(DataStreamPtr& stream, Mesh* pDest);
 
+        /** Gets the number of vertex and index buffers the last importMesh uploaded
+            straight from the memory of the stream.
+        @remarks
+            Memory streams, such as files opened with FileSystemArchive::setMemoryMapping,
+            are uploaded without an intermediate copy unless the data needs endian
+            conversion. Other buffers are read into a locked buffer.
+        */
+        size_t getNumDirectBufferReads(void) const { return mNumDirectBufferReads; }
+
         /// Sets the listener for this serializer
         void setListener(MeshSerializerListener *listener);
         /// Returns the current listener
@@ -181,6 +190,7 @@ namespace Ogre {
 
         MeshSerializerListener *mListener;
 
+        size_t mNumDirectBufferReads;
     };
 
     /** 
@@ -82,6 +82,9 @@ namespace Ogre {
         */
         void importMesh(DataStreamPtr& stream, Mesh* pDest, MeshSerializerListener *listener);
 
+        /// Number of buffers the last importMesh filled straight from the stream memory
+        size_t getNumDirectBufferReads(void) const { return mNumDirectBufferReads; }
+
     protected:
 
         // Internal methods
@@ -175,6 +178,13 @@ namespace Ogre {
         virtual void readExtremes(DataStreamPtr& stream, Mesh *pMesh);
 
 
+        /** Fills a whole hardware buffer with the next bytes of the stream, straight
+            from the stream memory when it is a MemoryDataStream (e.g. a memory mapped
+            file) and no endian conversion is needed.
+        @return False if nothing was read, the data must then go through a lock
+        */
+        bool readBufferDataDirect(DataStreamPtr& stream, HardwareBuffer& buffer);
+
         /// Flip an entire vertex buffer from little endian
         virtual void flipFromLittleEndian(void* pData, size_t vertexCount, size_t vertexSize, const VertexDeclaration::VertexElementList& elems);
         /// Flip an entire vertex buffer to little endian
@@ -187,6 +197,7 @@ namespace Ogre {
         virtual void enableValidation();
 
         ushort exportedLodCount; // Needed to limit exported Edge data, when exporting
+        size_t mNumDirectBufferReads; // Counted by readBufferDataDirect
     };
 
 
@@ -139,14 +139,26 @@ namespace Ogre {
         /// Incremented count for next name extension
         static NameGenerator msNameGenerator;
 
-        /// Stores the orientation of the node relative to it's parent.
-        Quaternion mOrientation;
+        /** Points at the orientation of the node relative to it's parent.
+        @remarks
+            The local transform lives in mOwnOrientation, mOwnPosition and
+            mOwnScale, or in the node's slot while it is registered with a
+            TransformStorage, so that it is only ever stored once.
+        */
+        Quaternion* mOrientation;
 
-        /// Stores the position/translation of the node relative to its parent.
-        Vector3 mPosition;
+        /// Points at the position/translation of the node relative to its parent.
+        Vector3* mPosition;
 
-        /// Stores the scaling factor applied to this node
-        Vector3 mScale;
+        /// Points at the scaling factor applied to this node
+        Vector3* mScale;
+
+        /// Local orientation while not registered with a TransformStorage
+        Quaternion mOwnOrientation;
+        /// Local position while not registered with a TransformStorage
+        Vector3 mOwnPosition;
+        /// Local scale while not registered with a TransformStorage
+        Vector3 mOwnScale;
 
         /// Stores whether this node inherits orientation from it's parent
         bool mInheritOrientation;
@@ -229,6 +241,14 @@ namespace Ogre {
         /// User objects binding.
         UserObjectBindings mUserObjectBindings;
 
+        friend class TransformStorage;
+        /// Transform storage holding this node's local transform, if any
+        TransformStorage* mTransformStorage;
+        /// Depth of this node's slot in mTransformStorage
+        uint16 mTransformDepth;
+        /// Index of this node's slot in mTransformStorage
+        size_t mTransformIndex;
+
     public:
         /** Constructor, should only be called by parent, not directly.
         @remarks
@@ -252,7 +272,7 @@ namespace Ogre {
 
         /** Returns a quaternion representing the nodes orientation.
         */
-        const Quaternion & getOrientation() const { return mOrientation; }
+        const Quaternion & getOrientation() const { return *mOrientation; }
 
         /** Sets the orientation of this node via a quaternion.
         @remarks
@@ -296,7 +316,7 @@ namespace Ogre {
 
         /** Gets the position of the node relative to it's parent.
         */
-        const Vector3 & getPosition(void) const { return mPosition; }
+        const Vector3 & getPosition(void) const { return *mPosition; }
 
         /** Sets the scaling factor applied to this node.
         @remarks
@@ -317,7 +337,7 @@ namespace Ogre {
 
         /** Gets the scaling factor of this node.
         */
-        const Vector3& getScale(void) const { return mScale; }
+        const Vector3& getScale(void) const { return *mScale; }
 
         /** Tells the node whether it should inherit orientation from it's parent node.
         @remarks
@@ -72,6 +72,21 @@ namespace Ogre {
         */
         static OptimisedUtil* getImplementation(void) { return msImplementation; }
 
+        /// Implementations which may be built in
+        enum ImplementationType
+        {
+            IMPL_GENERAL,
+            IMPL_SSE,
+            IMPL_AVX2
+        };
+
+        /** Gets a specific implementation, regardless of the one picked by 
+            getImplementation. For testing and benchmarking.
+        @return The implementation, or NULL if it isn't built in or the CPU 
+            doesn't support it.
+        */
+        static OptimisedUtil* _getImplementation(ImplementationType type);
+
         /** Performs software vertex skinning.
         @param srcPosPtr Pointer to source position buffer.
         @param destPosPtr Pointer to destination position buffer.
@@ -203,6 +218,27 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices) = 0;
+
+        /** Tests axis aligned boxes against a set of planes, as used for frustum culling.
+        @remarks
+            A box is rejected if it lies entirely on the negative side of any of the
+            planes, following Plane::getSide(const Vector3&, const Vector3&).
+        @param planes The planes to test against.
+        @param numPlanes Number of planes.
+        @param boxes Pointer to six consecutive arrays of boxStride values holding
+            the centre x, y, z and half size x, y, z of the boxes. Must be aligned
+            to SIMD alignment.
+        @param boxStride Number of values in each array, must be a multiple of 4.
+        @param visibility Array of flags to store the results, the result flag is
+            1 if the box is visible, 0 otherwise. No alignment requirement.
+        @param numBoxes Number of boxes to test.
+        @return The number of visible boxes.
+        */
+        virtual size_t cullAxisAlignedBoxes(
+            const Plane* planes, size_t numPlanes,
+            const Real* boxes, size_t boxStride,
+            unsigned char* visibility,
+            size_t numBoxes) = 0;
     };
 
     /** Returns raw offseted of the given pointer.
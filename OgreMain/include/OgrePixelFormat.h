@@ -634,6 +634,31 @@ namespace Ogre {
             @remarks Non consecutive pixel boxes are supported.
          */
         static void bulkPixelVerticalFlip(const PixelBox &box);
+
+        /** Sets the number of threads large images are converted and scaled with.
+        @remarks
+            bulkPixelConversion and the bilinear filter of Image::scale split 2D
+            images of more than a few hundred thousand pixels into bands of rows
+            and process each band on its own thread. The calling thread does the
+            first band and waits for the others.
+        @note
+            Has no effect if OGRE was built without thread support.
+        @param numThreads Number of threads, 0 (the default) converts serially.
+        */
+        static void setNumWorkerThreads(size_t numThreads);
+        /** Gets the number of threads large images are converted and scaled with. */
+        static size_t getNumWorkerThreads(void);
+
+        /// Function processing the rows [rowBegin, rowEnd) of an image for _parallelForRows
+        typedef void (*RowFunction)(size_t rowBegin, size_t rowEnd, void* userData);
+        /** Calls func for bands of rows covering [0, numRows), on the worker
+            threads if there are enough pixels to be worth it. Internal use only.
+        @param numRows Number of rows to process
+        @param pixelsPerRow Pixels in a row, used to decide how many bands to make
+        @param func Function processing a band, must be safe to call concurrently
+        @param userData Passed on to func
+        */
+        static void _parallelForRows(size_t numRows, size_t pixelsPerRow, RowFunction func, void* userData);
     };
     /** @} */
     /** @} */
@@ -120,6 +120,15 @@ namespace Ogre {
 #   define __OGRE_HAVE_SSE  0
 #endif
 
+/* Define whether or not SSE2 integer instructions may be used without
+   special compiler flags, which is always the case on x86-64.
+*/
+#if __OGRE_HAVE_SSE && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#   define __OGRE_HAVE_SSE2  1
+#else
+#   define __OGRE_HAVE_SSE2  0
+#endif
+
 #ifndef __OGRE_HAVE_VFP
 #   define __OGRE_HAVE_VFP  0
 #endif
@@ -176,6 +185,9 @@ namespace Ogre {
             CPU_FEATURE_FPU             = 1 << 12,
             CPU_FEATURE_PRO             = 1 << 13,
             CPU_FEATURE_HTT             = 1 << 14,
+            CPU_FEATURE_AVX             = 1 << 18,
+            CPU_FEATURE_AVX2            = 1 << 19,
+            CPU_FEATURE_FMA             = 1 << 20,
 #elif OGRE_CPU == OGRE_CPU_ARM          
             CPU_FEATURE_VFP             = 1 << 15,
             CPU_FEATURE_NEON            = 1 << 16,
@@ -181,6 +181,7 @@ namespace Ogre {
     class GpuProgramUsage;
     class HardwareIndexBuffer;
     class HardwareOcclusionQuery;
+    class HardwareStreamingBuffer;
     class HardwareVertexBuffer;
     class HardwarePixelBuffer;
     class HardwarePixelBufferSharedPtr;
@@ -306,7 +307,9 @@ namespace Ogre {
     class TextureUnitState;
     class Texture;
     class TextureManager;
+    class TextureStreamer;
     class TransformKeyFrame;
+    class TransformStorage;
     class Timer;
     class UserObjectBindings;
     class Vector2;
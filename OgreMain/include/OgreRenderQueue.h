@@ -140,6 +140,7 @@ namespace Ogre {
         bool mSplitPassesByLightingType;
         bool mSplitNoShadowPasses;
         bool mShadowCastersCannotBeReceivers;
+        bool mRetainedMode;
 
         RenderableListener* mRenderableListener;
     public:
@@ -274,6 +275,22 @@ namespace Ogre {
         */
         bool getShadowCastersCannotBeReceivers(void) const;
 
+        /** Sets whether the queue keeps its contents between fills.
+        @remarks
+            In retained mode renderables stay in the queue across clear(), each
+            renderable / pass pair with a packed sort key. Refilling the queue
+            with mostly the same renderables then only marks them present and
+            sorting is skipped while the keys remain in order, which suits
+            largely static scenes. Queues which alternate between very different
+            contents (e.g. when shared with shadow texture renders) gain little.
+        @par
+            You can only do this when the queue is empty, ie after clearing it.
+        @see QueuedRenderableCollection::setRetainedMode
+        */
+        void setRetainedMode(bool retained);
+        /** Gets whether the queue keeps its contents between fills. */
+        bool getRetainedMode(void) const { return mRetainedMode; }
+
         /** Set a renderable listener on the queue.
         @remarks
             There can only be a single renderable listener on the queue, since
@@ -131,6 +131,24 @@ namespace Ogre {
         };
 
     protected:
+        /// Hashes a renderable / pass pair for the retained mode lookup
+        struct RenderablePassHash
+        {
+            size_t operator()(const RenderablePass& rp) const
+            {
+                size_t h = reinterpret_cast<size_t>(rp.renderable);
+                return h ^ (reinterpret_cast<size_t>(rp.pass) + 0x9e3779b9 + (h << 6) + (h >> 2));
+            }
+        };
+        /// Equality of renderable / pass pairs for the retained mode lookup
+        struct RenderablePassEqual
+        {
+            bool operator()(const RenderablePass& a, const RenderablePass& b) const
+            {
+                return a.renderable == b.renderable && a.pass == b.pass;
+            }
+        };
+
         /// Comparator to order pass groups
         struct PassGroupLess
         {
@@ -228,6 +246,46 @@ namespace Ogre {
         /// Radix sorter for sort value 2 (distance)
         static RadixSort<RenderablePassList, RenderablePass, float> msRadixSorter2;
 
+        /// Renderable / pass pair kept between fills in retained mode
+        struct RetainedEntry
+        {
+            RenderablePass renderablePass;
+            /// Fill the pair was last queued in
+            uint32 frame;
+
+            RetainedEntry(Renderable* rend, Pass* p, uint32 f) : renderablePass(rend, p), frame(f) {}
+        };
+        typedef vector<RetainedEntry>::type RetainedEntryList;
+        /** Packed sort key of a retained entry, the order in which entries are visited.
+            Carries the pair itself so that sorting and visiting walk one array. */
+        struct RetainedSortItem
+        {
+            uint64 key;
+            RenderablePass renderablePass;
+            /// Index in mRetainedEntries
+            uint32 index;
+            /// Whether the depth part of the key has to be computed at the next sort
+            bool newKey;
+
+            RetainedSortItem(const RenderablePass& rp, uint32 i)
+                : key(0), renderablePass(rp), index(i), newKey(true) {}
+            bool operator<(const RetainedSortItem& rhs) const { return key < rhs.key; }
+        };
+        typedef vector<RetainedSortItem>::type RetainedSortList;
+        typedef OGRE_HashMap<RenderablePass, uint32, RenderablePassHash, RenderablePassEqual> RetainedEntryMap;
+
+        /// Functor for accessing the packed key of a retained entry
+        struct RadixSortFunctorKey
+        {
+            uint64 operator()(const RetainedSortItem& item) const
+            {
+                return item.key;
+            }
+        };
+
+        /// Radix sorter for the packed keys of retained entries
+        static RadixSort<RetainedSortList, RetainedSortItem, uint64> msRadixSorterKey;
+
         /// Bitmask of the organisation modes requested
         uint8 mOrganisationMode;
 
@@ -236,6 +294,37 @@ namespace Ogre {
         /// Sorted descending (can iterate backwards to get ascending)
         RenderablePassList mSortedDescending;
 
+        /// Whether entries are kept between fills and ordered by packed keys
+        bool mRetainedMode;
+        /// Retained entries, in the order they were first queued
+        RetainedEntryList mRetainedEntries;
+        /// Retained entries in key order
+        RetainedSortList mRetainedOrder;
+        /// Renderable / pass pair to index in mRetainedEntries
+        RetainedEntryMap mRetainedLookup;
+        /// Current fill, incremented by clear
+        uint32 mRetainedFrame;
+        /// Number of entries queued in the current fill
+        size_t mRetainedQueued;
+        /// Entry expected next if renderables are queued in the same order as last fill
+        size_t mRetainedCursor;
+        /// Camera and position the depth of pass grouped entries was last computed for
+        const Camera* mRetainedCamera;
+        Vector3 mRetainedCameraPosition;
+
+        /// Internal retained mode implementation
+        void addRetainedRenderable(Pass* pass, Renderable* rend);
+        /// Internal retained mode implementation
+        void sortRetained(const Camera* cam);
+        /// Drops the entries which were not queued in the current fill
+        void compactRetained(void);
+        /// Internal visitor implementation
+        void acceptVisitorRetainedGrouped(QueuedRenderableVisitor* visitor) const;
+        /// Internal visitor implementation
+        void acceptVisitorRetainedDescending(QueuedRenderableVisitor* visitor) const;
+        /// Internal visitor implementation
+        void acceptVisitorRetainedAscending(QueuedRenderableVisitor* visitor) const;
+
         /// Internal visitor implementation
         void acceptVisitorGrouped(QueuedRenderableVisitor* visitor) const;
         /// Internal visitor implementation
@@ -277,6 +366,32 @@ namespace Ogre {
             mOrganisationMode |= om; 
         }
 
+        /** Sets whether the collection keeps its contents between fills.
+        @remarks
+            In retained mode every renderable / pass pair is stored once in a flat
+            list which survives clear(). Queueing a pair that was queued in the
+            previous fill just marks it as present again, which is a position
+            check when renderables are queued in the same order as before. Each
+            pair carries a packed 64 bit key, pass hash then depth bucket when
+            grouping by pass and depth then pass hash when sorting by depth; sort()
+            refreshes the keys and only runs a radix sort when they are out of
+            order. When grouping by pass, depth only orders the renderables of a
+            pass and is recomputed for new pairs, changed pass hashes or when the
+            camera moved, not when a renderable moved. This is cheaper than rebuilding the pass groups and sorting
+            from scratch whenever most of the scene is queued again unchanged.
+        @par
+            Pairs queued more than once in the same fill are only visited once.
+            When depth sorting is requested pass groups are visited in depth
+            order, with a pass visit whenever the pass changes; the same happens
+            to distinct passes which share a hash.
+        @par
+            You can only do this when the collection is empty.
+        */
+        void setRetainedMode(bool retained);
+
+        /// Gets whether the collection keeps its contents between fills
+        bool getRetainedMode(void) const { return mRetainedMode; }
+
         /// Add a renderable to the collection using a given pass
         void addRenderable(Pass* pass, Renderable* rend);
         
@@ -444,6 +559,11 @@ namespace Ogre {
             mShadowCastersNotReceivers = ind;
         }
 
+        /** Sets whether the collections of this group keep their contents between fills.
+        @see QueuedRenderableCollection::setRetainedMode
+        */
+        void setRetainedMode(bool retained);
+
         /** Merge group of renderables. 
         */
         void merge( const RenderPriorityGroup* rhs );
@@ -474,8 +594,12 @@ namespace Ogre {
         PriorityMap mPriorityGroups;
         /// Whether shadows are enabled for this queue
         bool mShadowsEnabled;
+        /// Whether compatible renderables are drawn with one multi draw call
+        bool mMultiDrawEnabled;
         /// Bitmask of the organisation modes requested (for new priority groups)
         uint8 mOrganisationMode;
+        /// Whether the priority groups keep their contents between fills
+        bool mRetainedMode;
 
 
     public:
@@ -488,7 +612,9 @@ namespace Ogre {
             , mSplitNoShadowPasses(splitNoShadowPasses)
             , mShadowCastersNotReceivers(shadowCastersNotReceivers)
             , mShadowsEnabled(true)
+            , mMultiDrawEnabled(false)
             , mOrganisationMode(0)
+            , mRetainedMode(false)
         {
         }
 
@@ -531,6 +657,8 @@ namespace Ogre {
                     pPriorityGrp->resetOrganisationModes();
                     pPriorityGrp->addOrganisationMode((QueuedRenderableCollection::OrganisationMode)mOrganisationMode);
                 }
+                if (mRetainedMode)
+                    pPriorityGrp->setRetainedMode(true);
 
                 mPriorityGroups.insert(PriorityMap::value_type(priority, pPriorityGrp));
             }
@@ -585,6 +713,25 @@ namespace Ogre {
         /** Are shadows enabled for this queue? */
         bool getShadowsEnabled(void) const { return mShadowsEnabled; }
 
+        /** Enables multi draw batching of this queue.
+        @remarks
+            When enabled, and the render system has RSC_MULTI_DRAW_INDIRECT,
+            consecutive renderables of a pass group which share their vertex
+            declaration, vertex buffers and index buffer, and which have one
+            world matrix each, are drawn with a single call to
+            RenderSystem::_renderMultiDraw. The GPU program parameters are set
+            up from the first renderable of each batch, the world matrices of
+            all of them are handed to the render system, so the vertex
+            programs of the materials in this group must read the world
+            matrix from the per draw data instead of an auto constant.
+            Renderables which cannot be batched are rendered as usual.
+        @see RenderSystem::_renderMultiDraw
+        */
+        void setMultiDrawEnabled(bool enabled) { mMultiDrawEnabled = enabled; }
+
+        /** Is multi draw batching enabled for this queue? */
+        bool getMultiDrawEnabled(void) const { return mMultiDrawEnabled; }
+
         /** Sets whether or not the queue will split passes by their lighting type,
         ie ambient, per-light and decal. 
         */
@@ -679,6 +826,27 @@ namespace Ogre {
             }
         }
 
+        /** Sets whether the priority groups keep their contents between fills.
+        @remarks
+            You can only do this when the group is empty, ie after clearing the 
+            queue.
+        @see QueuedRenderableCollection::setRetainedMode
+        */
+        void setRetainedMode(bool retained)
+        {
+            mRetainedMode = retained;
+
+            PriorityMap::iterator i, iend;
+            iend = mPriorityGroups.end();
+            for (i = mPriorityGroups.begin(); i != iend; ++i)
+            {
+                i->second->setRetainedMode(retained);
+            }
+        }
+
+        /** Gets whether the priority groups keep their contents between fills. */
+        bool getRetainedMode(void) const { return mRetainedMode; }
+
         /** Merge group of renderables. 
         */
         void merge( const RenderQueueGroup* rhs )
@@ -705,6 +873,8 @@ namespace Ogre {
                         pDstPriorityGrp->resetOrganisationModes();
                         pDstPriorityGrp->addOrganisationMode((QueuedRenderableCollection::OrganisationMode)mOrganisationMode);
                     }
+                    if (mRetainedMode)
+                        pDstPriorityGrp->setRetainedMode(true);
 
                     mPriorityGroups.insert(PriorityMap::value_type(priority, pDstPriorityGrp));
                 }
@@ -1048,6 +1048,13 @@ namespace Ogre
         virtual unsigned int _getBatchCount(void) const;
         /** Reports the number of vertices passed to the renderer since the last _beginGeometryCount call. */
         virtual unsigned int _getVertexCount(void) const;
+        /** Reports the number of bytes of shader constants uploaded since the last _beginGeometryCount call. */
+        virtual size_t _getConstantBytesCount(void) const;
+        /** Adds to the number of bytes of shader constants uploaded.
+        @remarks
+            Called by render system implementations whenever they upload program parameters.
+        */
+        void _notifyConstantBytesUploaded(size_t bytes) { mConstantBytesCount += bytes; }
 
         /** Generates a packed data version of the passed in ColourValue suitable for
         use as with this RenderSystem.
@@ -1236,6 +1243,26 @@ namespace Ogre
         */
         virtual void _render(const RenderOperation& op);
 
+        /**
+        Render several operations with a single draw call.
+
+        Only used by the SceneManager when the render system reports
+        RSC_MULTI_DRAW_INDIRECT. All operations must have the same operation
+        type, vertex declaration, vertex buffer bindings and index buffer,
+        they may differ in their vertex and index ranges only. Instancing is
+        not supported.
+
+        The base implementation only updates the statistics, counting all
+        operations as one batch; render systems call it first like _render.
+
+        @param ops The rendering operations.
+        @param worldMatrices One world matrix per operation, made available to
+        the bound GPU programs as per draw data. How it is exposed depends on
+        the render system.
+        @param count Number of operations.
+        */
+        virtual void _renderMultiDraw(const RenderOperation* ops, const Matrix4* worldMatrices, size_t count);
+
         virtual void _renderUsingReadBackAsTexture(unsigned int secondPass,Ogre::String variableName,unsigned int StartSlot);
 
         /** Gets the capabilities of the render system. */
@@ -1593,6 +1620,7 @@ namespace Ogre
         size_t mBatchCount;
         size_t mFaceCount;
         size_t mVertexCount;
+        size_t mConstantBytesCount;
 
         /// Saved manual colour blends
         ColourValue mManualBlendColours[OGRE_MAX_TEXTURE_LAYERS][2];
@@ -88,6 +88,8 @@ namespace Ogre {
             size_t triangleCount;
             /// number of batches rendered in the last update() call.
             size_t batchCount;
+            /// number of bytes of shader constants uploaded in the last update() call.
+            size_t constantBytes;
             int vBlankMissCount; // -1 means that the value is not applicable
         };
 
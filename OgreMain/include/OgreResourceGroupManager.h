@@ -369,6 +369,8 @@ namespace Ogre {
             Called as part of initialiseResourceGroup
         */
         void parseResourceGroupScripts(ResourceGroup* grp) const;
+        /// Opens a script file found by parseResourceGroupScripts, notifying the loading listener
+        DataStreamPtr openResourceGroupScript(const FileInfo& file, ResourceGroup* grp) const;
         /** Create all the pre-declared resources.
         @remarks
             Called as part of initialiseResourceGroup
@@ -424,6 +426,17 @@ namespace Ogre {
 
         /// Stored current group - optimisation for when bulk loading a group
         ResourceGroup* mCurrentGroup;
+
+        /// Number of threads preparing resources in prepare/loadResourceGroup
+        size_t mNumWorkerThreads;
+
+        /** Prepares the main resources of a group on worker threads.
+        @remarks
+            Called by prepareResourceGroup and loadResourceGroup before they
+            lock the group, since preparing a resource opens its stream through
+            this class. Failures are left for the serial pass to report.
+        */
+        void prepareResourceGroupConcurrently(const String& name);
     public:
         ResourceGroupManager();
         virtual ~ResourceGroupManager();
@@ -554,6 +567,35 @@ namespace Ogre {
         void loadResourceGroup(const String& name, bool loadMainResources = true, 
             bool loadWorldGeom = true);
 
+        /** Sets the number of worker threads used to prepare resource groups.
+        @remarks
+            When non-zero, prepareResourceGroup and loadResourceGroup first prepare
+            (read and decode, see Resource::prepare) all the main resources of the
+            group on this many threads, then do their usual pass on the calling
+            thread, which is left with loading, i.e. the upload to the GPU.
+        @par
+            Resources are handed out in the loading order of their types, so
+            textures and skeletons are picked up before the materials and meshes
+            using them. A resource which cascade prepares another one already being
+            prepared by a worker waits for it. Preparing has to be thread safe for
+            every resource type in the group, which it is for the built-in types.
+            ResourceLoadingListener callbacks may be called from the worker threads,
+            the ResourceGroupListener events are still fired by the calling thread.
+        @par
+            The same threads are offered to the script loaders when a group is
+            initialised, see ScriptLoader::beginPreparingScripts. Scripts are opened
+            once ResourceGroupListener::scriptParseStarted has been fired for them, so
+            skipped scripts are never opened, and only a few per thread are kept open
+            ahead of the one being parsed. They are still parsed in their usual order,
+            the built-in compiler only lexes and parses ahead.
+        @note
+            Has no effect if OGRE was built without thread support.
+        @param numThreads Number of threads, 0 (the default) prepares serially.
+        */
+        void setNumWorkerThreads(size_t numThreads) { mNumWorkerThreads = numThreads; }
+        /** Gets the number of worker threads used to prepare resource groups. */
+        size_t getNumWorkerThreads(void) const { return mNumWorkerThreads; }
+
         /** Unloads a resource group.
         @remarks
             This method unloads all the resources that have been declared as
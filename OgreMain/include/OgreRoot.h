@@ -100,6 +100,7 @@ namespace Ogre
         
         ResourceGroupManager* mResourceGroupManager;
         ResourceBackgroundQueue* mResourceBackgroundQueue;
+        TextureStreamer* mTextureStreamer;
         ShadowTextureManager* mShadowTextureManager;
         RenderSystemCapabilitiesManager* mRenderSystemCapabilitiesManager;
         ScriptCompilerManager *mCompilerManager;
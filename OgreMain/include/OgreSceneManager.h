@@ -48,6 +48,10 @@ Torus Knot Software Ltd.
 #include "OgreRenderSystem.h"
 #include "OgreLodListener.h"
 #include "OgreNameGenerator.h"
+#include "OgreSceneNode.h"
+#include "OgreMesh.h"
+#include "Threading/OgreThreads.h"
+#include "Threading/OgreLightweightMutex.h"
 
 namespace Ogre {
     /** \addtogroup Core
@@ -69,6 +73,7 @@ namespace Ogre {
     class InstancedGeometry;
     class Rectangle2D;
     class LodListener;
+    class Barrier;
     struct MovableObjectLodChangedEvent;
     struct EntityMeshLodChangedEvent;
     struct EntityMaterialLodChangedEvent;
@@ -344,6 +349,8 @@ namespace Ogre {
                         { (void)source; }
         };
 
+        typedef vector<Renderable*>::type MultiDrawRenderableList;
+
         /** Inner helper class to implement the visitor pattern for rendering objects
             in a queue. 
         */
@@ -352,13 +359,17 @@ namespace Ogre {
         protected:
             /// Pass that was actually used at the grouping level
             const Pass* mUsedPass;
+            /// Renderables of mUsedPass waiting to be drawn with one multi draw call
+            MultiDrawRenderableList mMultiDrawBatch;
         public:
             SceneMgrQueuedRenderableVisitor() 
-                :transparentShadowCastersMode(false) {}
+                :transparentShadowCastersMode(false), multiDraw(false) {}
             ~SceneMgrQueuedRenderableVisitor() {}
             void visit(Renderable* r);
             bool visit(const Pass* p);
             void visit(RenderablePass* rp);
+            /// Renders the renderables collected for multi draw so far
+            void flushMultiDraw(void);
 
             /// Target SM to send renderables to
             SceneManager* targetSceneMgr;
@@ -370,6 +381,8 @@ namespace Ogre {
             const LightList* manualLightList;
             /// Scissoring if requested?
             bool scissoring;
+            /// Collect compatible renderables into multi draw batches?
+            bool multiDraw;
 
         };
         /// Allow visitor helper to access protected methods
@@ -471,6 +484,12 @@ namespace Ogre {
         
         unsigned long mLastFrameNumber;
         Matrix4 mTempXform[256];
+        /// Renderables the next _issueRenderOp draws together, see renderMultiDrawObjects
+        const MultiDrawRenderableList* mMultiDrawRenderables;
+        /// Render operations of a multi draw call, kept to save allocations
+        vector<RenderOperation>::type mMultiDrawOps;
+        /// World matrices of a multi draw call, kept to save allocations
+        vector<Matrix4>::type mMultiDrawWorldMatrices;
         bool mResetIdentityView;
         bool mResetIdentityProj;
 
@@ -708,6 +727,28 @@ namespace Ogre {
         virtual void renderSingleObject(Renderable* rend, const Pass* pass, 
             bool lightScissoringClipping, bool doLightIteration, const LightList* manualLightList = 0);
 
+        /** Internal utility method for rendering several objects with one draw call.
+        @remarks
+            Render state, lights and GPU program parameters are set up from the
+            first renderable as in renderSingleObject, then the render operations
+            and world matrices of all renderables are issued together through
+            RenderSystem::_renderMultiDraw. The renderables must be compatible,
+            see isMultiDrawCandidate and isMultiDrawCompatible.
+        */
+        virtual void renderMultiDrawObjects(const MultiDrawRenderableList& rends, const Pass* pass,
+            bool lightScissoringClipping, bool doLightIteration, const LightList* manualLightList = 0);
+
+        /** Returns whether a renderable may be drawn as part of a multi draw call
+            with the given pass.
+        */
+        virtual bool isMultiDrawCandidate(const Pass* pass, const Renderable* rend) const;
+
+        /** Returns whether two multi draw candidates can be drawn with the same
+            multi draw call using the given pass.
+        */
+        virtual bool isMultiDrawCompatible(const Pass* pass, Renderable* first, Renderable* rend,
+            bool doLightIteration) const;
+
         /** Internal method for creating the AutoParamDataSource instance. */
         virtual AutoParamDataSource* createAutoParamDataSource(void) const
         {
@@ -791,6 +832,8 @@ namespace Ogre {
         typedef vector<InstanceManager*>::type      InstanceManagerVec;
         InstanceManagerVec mDirtyInstanceManagers;
         InstanceManagerVec mDirtyInstanceMgrsTmp;
+        /// Instance managers can be flagged dirty from the worker threads
+        LightweightMutex mDirtyInstanceManagersMutex;
 
         /** Updates all instance managaers with dirty instance batches. @see _addDirtyInstanceManager */
         void updateDirtyInstanceManagers(void);
@@ -1021,6 +1064,120 @@ namespace Ogre {
         typedef vector<EntityMaterialLodChangedEvent>::type EntityMaterialLodChangedEventList;
         EntityMaterialLodChangedEventList mEntityMaterialLodChangedEvents;
 
+        /// Work the worker threads are asked to do by fireWorkerThreadsAndWait
+        enum RequestType
+        {
+            UPDATE_SCENE_GRAPH,
+            CULL_FRUSTUM,
+            UPDATE_BONE_MATRICES,
+            APPLY_SOFTWARE_SKINNING
+        };
+
+        size_t mNumWorkerThreads;
+        ThreadHandleVec mWorkerThreads;
+        /// Synchronises the worker threads with the thread calling fireWorkerThreadsAndWait
+        Barrier* mWorkerThreadsBarrier;
+        bool mExitWorkerThreads;
+        RequestType mRequestType;
+
+        /// Depth below the root node at which the scene graph is split among worker threads
+        uint16 mParallelUpdateDepth;
+        /// Subtrees left to the worker threads by the current parallel scene graph update
+        SceneNode::DeferredUpdateList mDeferredSubtrees;
+        /// Nodes above mParallelUpdateDepth whose bounds await the worker threads
+        SceneNode::SceneNodeList mPendingBoundsNodes;
+
+        /// Creates mNumWorkerThreads worker threads
+        void startWorkerThreads(void);
+        /// Makes the worker threads exit and waits for them
+        void stopWorkerThreads(void);
+        /** Wakes up the worker threads to process mRequestType and blocks
+            until all of them are done. */
+        void fireWorkerThreadsAndWait(void);
+
+        /** Returns whether the SceneNodes of this SceneManager can be brought up to
+            date from several threads at once.
+        @remarks
+            The default SceneNode only touches its own state and its descendants' while
+            updating. Subclasses whose nodes notify a shared structure (e.g. a spatial
+            partition) from _update or _updateBounds must return false, which makes
+            _updateSceneGraph stay on the calling thread.
+        */
+        virtual bool isParallelUpdateSafe(void) const { return true; }
+
+        /** Brings the scene graph up to date using the worker threads.
+        @see setParallelUpdateDepth
+        */
+        virtual void updateSceneGraphParallel(void);
+
+        /// Part of the UPDATE_SCENE_GRAPH request processed by the given worker thread
+        void updateSceneGraphThread(size_t threadIdx);
+
+        /// Structure-of-arrays transform storage for the scene graph, if enabled
+        TransformStorage* mTransformStorage;
+
+        /// Whether _findVisibleObjects culls all nodes in one batch, see setBatchedCullingEnabled
+        bool mBatchedCulling;
+        /// Scene nodes gathered by the current batched culling request
+        SceneNode::SceneNodeList mCullingNodes;
+        /// World bounds of mCullingNodes, laid out for OptimisedUtil::cullAxisAlignedBoxes
+        Real* mCullingBoxes;
+        /// Number of boxes mCullingBoxes has room for
+        size_t mCullingBoxesCapacity;
+        /// Indices of the null and infinite boxes in mCullingNodes, resolved without planes
+        vector<size_t>::type mCullingSpecialBoxes;
+        /// Visibility of each of mCullingNodes
+        vector<unsigned char>::type mCullingResults;
+        /// Frustum planes used by the current batched culling request
+        Plane mCullingPlanes[6];
+        size_t mNumCullingPlanes;
+
+        /** Finds the visible objects by testing the bounds of all scene nodes at once.
+        @see setBatchedCullingEnabled
+        */
+        void findVisibleObjectsBatched(Camera* cam,
+            VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters);
+
+        /// Whether _updateAnimations uses the worker threads, see setParallelAnimationEnabled
+        bool mParallelAnimation;
+        /// Skeletally animated entities of this frame, which _updateAnimations picks from
+        vector<Entity*>::type mAnimationCandidates;
+        /// Frame mAnimationCandidates were collected in, reset when entities are added or removed
+        unsigned long mAnimationCandidatesFrame;
+        /// Entities animated by the current _updateAnimations call
+        vector<Entity*>::type mAnimatedEntities;
+        /// Software skinning of the animated entities, blended by the worker threads
+        Mesh::SoftwareVertexBlendJobList mSoftwareSkinningJobs;
+        /// Buffers locked by mSoftwareSkinningJobs
+        Mesh::LockedVertexBufferMap mLockedSkinningBuffers;
+        /// Vertices of a job blended by one worker thread at a time
+        struct SoftwareSkinningRange
+        {
+            size_t job;
+            size_t start;
+            size_t count;
+        };
+        /// mSoftwareSkinningJobs cut into pieces of similar size
+        vector<SoftwareSkinningRange>::type mSoftwareSkinningRanges;
+
+        /** Collects the entities _updateAnimations may animate into mAnimationCandidates.
+        @remarks
+            Called at most once per frame, the per camera visibility tests only
+            run over the candidates. The default picks the entities with a skeleton.
+        */
+        virtual void collectAnimationCandidates(void);
+        /// Makes the next _updateAnimations call collect its candidates again
+        void dirtyAnimationCandidates(void)
+        { mAnimationCandidatesFrame = std::numeric_limits<unsigned long>::max(); }
+
+        /// Part of the UPDATE_BONE_MATRICES request processed by the given worker thread
+        void updateBoneMatricesThread(size_t threadIdx);
+        /// Part of the APPLY_SOFTWARE_SKINNING request processed by the given worker thread
+        void applySoftwareSkinningThread(size_t threadIdx);
+
+        /// Part of the CULL_FRUSTUM request processed by the given worker thread
+        void cullFrustumThread(size_t threadIdx);
+
     public:
         /** Constructor.
         */
@@ -1759,6 +1916,19 @@ namespace Ogre {
         */
         virtual void _updateSceneGraph(Camera* cam);
 
+        /** Internal method for updating the animation of the entities seen by a camera
+            on the worker threads.
+            @remarks
+                Called after _updateSceneGraph. Does nothing unless worker threads are in
+                use (see setNumWorkerThreads and setParallelAnimationEnabled). The animation
+                states of the skeletally animated entities visible from the camera are applied
+                and their bone matrices and software skinning computed on the worker threads,
+                so that Entity::_updateAnimation has nothing left to do this frame.
+                Entities which cannot be updated this way are left to be animated on the
+                rendering thread as usual.
+        */
+        virtual void _updateAnimations(Camera* cam);
+
         /** Internal method which parses the scene to find visible objects to render.
             @remarks
                 If you're implementing a custom scene manager, this is the most important method to
@@ -3387,6 +3557,98 @@ namespace Ogre {
         /** Handle LOD events. */
         void _handleLodEvents();
 
+        /** Sets the number of worker threads this SceneManager uses to process
+            the scene concurrently.
+        @remarks
+            The threads are created right away and sleep between frames until this
+            method is called again or the SceneManager is destroyed. The default of 0
+            processes everything on the thread that renders the scene.
+        @see setParallelUpdateDepth
+        */
+        void setNumWorkerThreads(size_t numThreads);
+
+        /** Gets the number of worker threads used by this SceneManager. */
+        size_t getNumWorkerThreads(void) const { return mNumWorkerThreads; }
+
+        /** Sets the depth of the scene graph at which _updateSceneGraph hands
+            subtrees over to the worker threads.
+        @remarks
+            With worker threads available, the nodes down to this many levels below
+            the root node are updated as usual, the subtrees found at that level are
+            split among the worker threads and the world bounds of the upper levels
+            are merged once all threads are done. Choose a depth at which there are
+            many more subtrees than threads, of roughly similar size.
+        @par
+            The pre and post update scene graph events are still raised on the
+            rendering thread, but Node::Listener and MovableObject::Listener
+            callbacks made while updating the subtrees come from the worker threads.
+        @param depth The depth of the split, the default of 1 hands over each child
+            of the root node. 0 disables the parallel update.
+        */
+        void setParallelUpdateDepth(uint16 depth) { mParallelUpdateDepth = depth; }
+
+        /** Gets the depth at which the scene graph update is split among the worker threads. */
+        uint16 getParallelUpdateDepth(void) const { return mParallelUpdateDepth; }
+
+        /** Main loop of the worker threads.
+        @remarks
+            Internal use only, this is the entry point of every worker thread created
+            by setNumWorkerThreads.
+        */
+        unsigned long _updateWorkerThread(ThreadHandle* threadHandle);
+
+        /** Sets whether scene node transforms are derived in bulk from contiguous storage.
+        @remarks
+            When enabled, every SceneNode attached to the root node keeps its
+            local transform in a TransformStorage, and _updateSceneGraph derives the
+            world transforms of all moved nodes level by level, several nodes at
+            a time, before the usual traversal updates bounds and attached objects.
+            This pays off for large hierarchies with many moving nodes. Disabled
+            by default.
+        @note
+            Not available when OGRE_NODE_INHERIT_TRANSFORM is enabled.
+        */
+        void setTransformStorageEnabled(bool enabled);
+
+        /** Gets whether scene node transforms are derived in bulk from contiguous storage. */
+        bool isTransformStorageEnabled(void) const { return mTransformStorage != 0; }
+
+        /** Sets whether the default _findVisibleObjects tests all scene nodes in one batch.
+        @remarks
+            Instead of walking down the scene graph and testing one node at a time,
+            the world bounds of all nodes are gathered into packed arrays and tested
+            against the camera frustum several at a time using SIMD instructions,
+            split over the worker threads for large scenes (see setNumWorkerThreads).
+            Visible objects are then added to the render queue as usual. Subtrees
+            are no longer rejected as a whole, so this pays off for scenes with many
+            nodes in a rather flat hierarchy. The number of visible and culled nodes
+            is reported to the camera, see Camera::_getNumVisibleNodes. Disabled by
+            default.
+        @note
+            SceneManager subclasses that provide their own _findVisibleObjects are
+            not affected.
+        */
+        void setBatchedCullingEnabled(bool enabled) { mBatchedCulling = enabled; }
+
+        /** Gets whether the default _findVisibleObjects tests all scene nodes in one batch. */
+        bool isBatchedCullingEnabled(void) const { return mBatchedCulling; }
+
+        /** Sets whether the skeletal animation of visible entities is evaluated on the
+            worker threads.
+        @remarks
+            Only has an effect when worker threads are in use, see setNumWorkerThreads.
+            Bone matrices are computed and software skinning blended on the worker
+            threads, while hardware buffers are still locked and unlocked on the
+            rendering thread. AnimationTrack::Listener callbacks made while applying
+            the animations of these entities then come from the worker threads.
+            Disabled by default.
+        @see _updateAnimations
+        */
+        void setParallelAnimationEnabled(bool enabled) { mParallelAnimation = enabled; }
+
+        /** Gets whether the skeletal animation of visible entities is evaluated on the worker threads. */
+        bool isParallelAnimationEnabled(void) const { return mParallelAnimation; }
+
         IlluminationRenderStage _getCurrentRenderStage() {return mIlluminationStage;}
     };
 
@@ -60,6 +60,15 @@ namespace Ogre {
         typedef MapIterator<ObjectMap> ObjectIterator;
         typedef ConstMapIterator<ObjectMap> ConstObjectIterator;
 
+        /// A subtree left out by _updateSplit, to be brought up to date with _update
+        struct DeferredUpdate
+        {
+            SceneNode* node;
+            bool parentHasChanged;
+        };
+        typedef vector<DeferredUpdate>::type DeferredUpdateList;
+        typedef vector<SceneNode*>::type SceneNodeList;
+
     protected:
         ObjectMap mObjectsByName;
 
@@ -181,6 +190,25 @@ namespace Ogre {
         */
         void _update(bool updateChildren, bool parentHasChanged);
 
+        /** Internal method to update the top levels of the Node hierarchy only.
+            @remarks
+                Does the same as _update(true, parentHasChanged) for this node and its
+                descendants down to the given depth, but instead of updating the subtrees
+                found at that depth it adds them to deferredSubtrees along with the
+                parentHasChanged flag _update would have passed them. This lets a
+                SceneManager update the subtrees concurrently, since they share no state.
+            @par
+                The world bounds of the nodes visited here depend on the deferred subtrees,
+                so they are not updated either; the nodes are appended to pendingBounds in
+                depth-first order instead, and _updateBounds must be called on them in
+                reverse order once all deferred subtrees are up to date.
+            @param
+                depth Number of levels below this node to update before deferring; must
+                be at least 1.
+        */
+        void _updateSplit(uint16 depth, bool parentHasChanged,
+            DeferredUpdateList& deferredSubtrees, SceneNodeList& pendingBounds);
+
         /** Tells the SceneNode to update the world bound info it stores.
         */
         virtual void _updateBounds(void);
@@ -207,6 +235,15 @@ namespace Ogre {
             VisibleObjectsBoundsInfo* visibleBounds, 
             bool includeChildren = true, bool displayNodes = false, bool onlyShadowCasters = false);
 
+        /** Internal method which adds the objects attached to this node to the passed in queue,
+            without any visibility test.
+            @remarks
+                Used by SceneManager implementations which determine the visibility of nodes
+                themselves. Children are not included.
+        */
+        virtual void _addToRenderQueue(Camera* cam, RenderQueue* queue, bool onlyShadowCasters,
+            VisibleObjectsBoundsInfo* visibleBounds);
+
         /** Gets the axis-aligned bounding box of this node (and hence all subnodes).
         @remarks
             Recommended only if you are extending a SceneManager, because the bounding box returned
@@ -306,6 +343,14 @@ namespace Ogre {
         */
         bool getShowBoundingBox() const { return mShowBoundingBox; }
 
+        /** Whether the node's bounding box is hidden regardless of the 
+            SceneManager's setting, see hideBoundingBox.
+        @remarks
+            Scene Managers that implement their own _findVisibleObjects should check
+            this as well as getShowBoundingBox before adding the bounding box.
+        */
+        bool getHideBoundingBox() const { return mHideBoundingBox; }
+
         /** Creates an unnamed new SceneNode as a child of this node.
         @param
             translate Initial translation offset of child relative to parent
@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "OgreGpuProgram.h"
 #include "OgreAny.h"
 #include "Threading/OgreThreadHeaders.h"
+#include "Threading/OgreThreads.h"
 
 namespace Ogre
 {
@@ -200,6 +201,9 @@ namespace Ogre
         typedef SharedPtr<Error> ErrorPtr;
         typedef list<ErrorPtr>::type ErrorList;
 
+        /// Hash and length of the text of each script, by script name
+        typedef map<String, std::pair<uint32, uint32> >::type ScriptHashMap;
+
         // These are the built-in error codes
         enum{
             CE_STRINGEXPECTED,
@@ -232,6 +236,11 @@ namespace Ogre
         bool compile(const ConcreteNodeListPtr &nodes, const String &group);
         /// Generates the AST from the given string script
         AbstractNodeListPtr _generateAST(const String &str, const String &source, bool doImports = false, bool doObjects = false, bool doVariables = false);
+        /** Compiles the given script text, reusing its processed tree from the script cache when enabled.
+        @param nodes The script text already parsed, or null to parse it here
+        @note Internal method used by ScriptCompilerManager::parseScript.
+        */
+        bool _compileScript(const String &str, const String &source, const ConcreteNodeListPtr &nodes, const String &group);
         /// Compiles the given abstract syntax tree
         bool _compile(AbstractNodeListPtr nodes, const String &group, bool doImports = true, bool doObjects = true, bool doVariables = true);
         /// Adds the given error to the compiler's list of errors
@@ -268,6 +277,16 @@ namespace Ogre
 		uint32 registerCustomWordId(const String &word);
 
     private: // Tree processing
+        /// Resets the errors and environment before compiling into the given group
+        void resetContext(const String &group);
+        /// Converts the nodes to an AST and resolves its imports and object inheritance
+        AbstractNodeListPtr buildTree(const ConcreteNodeListPtr &nodes);
+        /// Expands the variables in a tree from buildTree and translates it
+        bool translateTree(const AbstractNodeListPtr &ast);
+        /// Writes a tree from buildTree and the environment into the script cache format
+        bool writeCachedTree(const AbstractNodeList &nodes, String &data) const;
+        /// Restores a tree and the environment written by writeCachedTree
+        AbstractNodeListPtr readCachedTree(const String &data);
         AbstractNodeListPtr convertToAST(const ConcreteNodeListPtr &nodes);
         /// This built-in function processes import nodes
         void processImports(AbstractNodeListPtr &nodes);
@@ -305,6 +324,8 @@ namespace Ogre
 
         // This stores the imports of the scripts, so they are separated and can be treated specially
         AbstractNodeList mImportTable;
+        // The text of each loaded import, which the cached tree of the script depends on
+        ScriptHashMap mImportHashes;
 
         // Error list
         ErrorList mErrors;
@@ -417,6 +438,53 @@ namespace Ogre
 
         // A pointer to the specific compiler instance used
         OGRE_THREAD_POINTER(ScriptCompiler, mScriptCompiler);
+
+        /// Parsed form of a script held in the script cache
+        struct CachedScript
+        {
+            CachedScript() : hash(0), length(0) {}
+
+            /// Hash and length of the script text the nodes were parsed from
+            uint32 hash;
+            uint32 length;
+            /// The concrete node tree in its compact binary form, empty if not cached
+            String nodes;
+            /// The abstract tree after import and inheritance processing, empty if not cached
+            String tree;
+            /// The imported scripts the abstract tree was built with
+            ScriptCompiler::ScriptHashMap imports;
+        };
+        typedef map<String, CachedScript>::type CachedScriptMap;
+
+        // Parsed scripts by script name, and the file they persist in
+        CachedScriptMap mScriptCache;
+        String mScriptCacheFile;
+        bool mScriptCacheDirty;
+        OGRE_MUTEX(mScriptCacheMutex);
+
+        /// Script queued by prepareScript, kept until parseScript is called for its stream
+        struct PreparedScript
+        {
+            DataStreamPtr stream;
+            String name;
+            String text;
+            ConcreteNodeListPtr nodes;
+            bool done;
+        };
+        typedef map<DataStream*, PreparedScript>::type PreparedScriptMap;
+        PreparedScriptMap mPreparedScripts;
+        /// Scripts of mPreparedScripts no worker has picked up yet, in queued order
+        deque<DataStream*>::type mScriptsToPrepare;
+        /// Threads started by beginPreparingScripts
+        ThreadHandleVec mPrepareThreads;
+        bool mStopPreparing;
+        OGRE_MUTEX(mPrepareMutex);
+        /// Signalled when a script is queued or the workers have to stop
+        OGRE_THREAD_SYNCHRONISER(mScriptQueuedSync);
+        /// Signalled when a worker is done with a script
+        OGRE_THREAD_SYNCHRONISER(mScriptPreparedSync);
+
+        void loadScriptCache();
     public:
         ScriptCompilerManager();
         virtual ~ScriptCompilerManager();
@@ -454,9 +522,60 @@ namespace Ogre
         const StringVector& getScriptPatterns(void) const;
         /// @copydoc ScriptLoader::parseScript
         void parseScript(DataStreamPtr& stream, const String& groupName);
+        /** Starts the threads which lex and parse the queued scripts.
+        @remarks
+            Translation is left to parseScript, which waits for the parsed tree of
+            its script and still runs on the calling thread in the usual order.
+            @copydetails ScriptLoader::beginPreparingScripts
+        */
+        void beginPreparingScripts(const String& groupName, size_t numThreads);
+        /** Queues a script for the threads started by beginPreparingScripts.
+        @remarks
+            The script is read on the calling thread, the threads only see its text.
+            @copydetails ScriptLoader::prepareScript
+        */
+        void prepareScript(const DataStreamPtr& stream, const String& groupName);
+        /// @copydoc ScriptLoader::endPreparingScripts
+        void endPreparingScripts(void);
+        /** Main loop of the threads started by beginPreparingScripts.
+        @remarks
+            Internal use only.
+        */
+        unsigned long _prepareScriptsThread(ThreadHandle* threadHandle);
         /// @copydoc ScriptLoader::getLoadingOrder
         Real getLoadingOrder(void) const;
 
+        /** Sets the file in which parsed scripts are cached between runs.
+        @remarks
+            Scripts whose text has not changed since they were cached are restored
+            from the cache rather than run through the ScriptLexer and ScriptParser
+            again. Compiled scripts also keep their abstract tree after imports and
+            object inheritance are resolved, which is reused as long as the script
+            and every script it imports are unchanged. A script whose text changed
+            is parsed as usual and replaces its stale entry. Trees are not cached
+            while a ScriptCompilerListener is set, since it may alter them. Existing cache contents are read as soon as the file is set,
+            and written back by saveScriptCache or when the manager is destroyed.
+            The cache is disabled by default; pass an empty string to disable it again.
+        */
+        void setScriptCacheFile(const String& filename);
+        /// Gets the file in which parsed scripts are cached, empty if disabled
+        const String& getScriptCacheFile(void) const;
+        /// Writes the script cache to its file, if anything changed since it was read
+        void saveScriptCache(void);
+
+        /** Parses the given script text, using the script cache when enabled.
+        @note Internal method used by the compilers to parse scripts and imports.
+        */
+        ConcreteNodeListPtr _parseScript(const String& str, const String& source);
+        /** Gets the cached abstract tree of the given script text.
+        @return false if there is none, or the script or one of its imports in the given group changed
+        @note Internal method used by the compilers, the tree is in the ScriptCompiler cache format.
+        */
+        bool _getCachedTree(const String& str, const String& source, const String& group, String& tree);
+        /// Stores the abstract tree of the given script text, see _getCachedTree
+        void _cacheTree(const String& str, const String& source, const String& tree,
+            const ScriptCompiler::ScriptHashMap& imports);
+
         /// @copydoc Singleton::getSingleton()
         static ScriptCompilerManager& getSingleton(void);
         /// @copydoc Singleton::getSingleton()
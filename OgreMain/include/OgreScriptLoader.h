@@ -76,6 +76,36 @@ namespace Ogre {
         */
         virtual void parseScript(DataStreamPtr& stream, const String& groupName) = 0;
 
+        /** Starts preparing the scripts of a resource group ahead of parsing them.
+        @remarks
+            Called once before the scripts of a group are passed to prepareScript,
+            when the ResourceGroupManager has worker threads to offer. Loaders which
+            can do part of the parsing of independent files concurrently may start
+            their threads here. The default does nothing.
+        @param groupName The name of the resource group the scripts belong to
+        @param numThreads The number of threads the work may be spread over
+        */
+        virtual void beginPreparingScripts(const String& groupName, size_t numThreads) {}
+
+        /** Queues a script file to be prepared ahead of parsing it.
+        @remarks
+            Called between beginPreparingScripts and endPreparingScripts, in the
+            order the scripts are parsed, a few scripts ahead of parseScript being
+            called for them. Preparing must leave creating anything to parseScript
+            so the results do not depend on thread timing. Scripts a listener chose
+            to skip are not passed. The default does nothing.
+        @param stream The script which is about to be parsed
+        @param groupName The name of the resource group the script belongs to
+        */
+        virtual void prepareScript(const DataStreamPtr& stream, const String& groupName) {}
+
+        /** Stops preparing scripts, once the last script of the group was parsed.
+        @remarks
+            Also called if parsing failed, so scripts which were prepared but not
+            parsed have to be dropped here. The default does nothing.
+        */
+        virtual void endPreparingScripts(void) {}
+
         /** Gets the relative loading order of scripts of this type.
         @remarks
             There are dependencies between some kinds of scripts, and to enforce
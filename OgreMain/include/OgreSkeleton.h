@@ -253,6 +253,12 @@ namespace Ogre {
         */
         virtual void setAnimationState(const AnimationStateSet& animSet);
 
+        /** Internal method which prepares the animations enabled in the passed in set
+            to be applied from several threads at once.
+        @see Animation::_buildCachedData
+        */
+        void _buildCachedAnimationData(const AnimationStateSet& animSet) const;
+
 
         /** Initialise an animation set suitable for use with this skeleton. 
         @remarks
@@ -437,6 +443,9 @@ namespace Ogre {
         /// List of references to other skeletons to use animations from 
         mutable LinkedSkeletonAnimSourceList mLinkedSkeletonAnimSourceList;
 
+        /// Skeleton file read by prepareImpl, parsed by loadImpl
+        DataStreamPtr mFreshFromDisk;
+
         /** Internal method which parses the bones to derive the root bone. 
         @remarks
             Must be const because called in getRootBone but mRootBone is mutable
@@ -447,6 +456,13 @@ namespace Ogre {
         /// Debugging method
         void _dumpContents(const String& filename);
 
+        /** Loads the skeleton file into memory, so it can be read ahead
+            of loadImpl, e.g. by a background thread.
+        */
+        void prepareImpl(void);
+        /** Destroys data cached by prepareImpl.
+        */
+        void unprepareImpl(void);
         /** @copydoc Resource::loadImpl
         */
         void loadImpl(void);
@@ -145,6 +145,9 @@ namespace Ogre {
         unsigned short mNextTagPointAutoHandle;
 
         void cloneBoneAndChildren(Bone* source, Bone* parent);
+        /** Overridden from Skeleton, an instance has no file to read
+        */
+        void prepareImpl(void) {}
         /** Overridden from Skeleton
         */
         void loadImpl(void);
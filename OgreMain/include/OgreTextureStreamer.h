@@ -0,0 +1,231 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __TextureStreamer_H__
+#define __TextureStreamer_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreSingleton.h"
+#include "OgreResource.h"
+#include "OgreTexture.h"
+#include "OgreWorkQueue.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Resources
+    *  @{
+    */
+    /** Streams the detailed mip levels of textures in the background.
+    @remarks
+        A streamed texture is loaded with its mip tail only, i.e. the levels
+        no larger than getMipTailSize(). While the scene is rendered the
+        render queue reports how large each visible object is on screen,
+        from which the streamer works out the most detailed level each
+        texture needs. Missing levels are decoded from the source file on
+        the WorkQueue and uploaded on the main thread once they arrive.
+    @par
+        The total size of all streamed textures is kept under
+        getMemoryBudget(). When a texture needs more detail than the budget
+        allows, the textures used least recently are dropped back towards
+        their mip tail first.
+    @par
+        Only 2D textures whose file holds a full mip chain, such as DDS or
+        KTX files, can be streamed. Other textures created through
+        createStreamedTexture are loaded in full as usual. Since a texture
+        changes size as levels come and go, the hardware texture is
+        recreated whenever its resident levels change; the Texture object
+        itself, and so every material using it, stays the same.
+    */
+    class _OgreExport TextureStreamer : public Singleton<TextureStreamer>, public ResourceAlloc,
+        public ManualResourceLoader, public WorkQueue::RequestHandler, public WorkQueue::ResponseHandler
+    {
+    protected:
+        /** Bookkeeping for one streamed texture. */
+        struct StreamedTexture
+        {
+            TexturePtr texture;
+            /// Whether the source file has a mip chain the texture can be streamed from
+            bool streamable;
+            /// Size of the top level of the source file
+            uint32 width;
+            uint32 height;
+            /// Number of mipmaps in the source file
+            uint8 numMipmaps;
+            /// Format of the hardware texture
+            PixelFormat format;
+            /// Source level which is the top level of the texture at the moment
+            uint8 residentMip;
+            /// First level of the mip tail, which always stays resident
+            uint8 tailMip;
+            /// Most detailed level requested by the render queue in mLastUsedFrame
+            uint8 demandMip;
+            /// Last frame the texture was reported visible in
+            unsigned long lastUsedFrame;
+            /// Request in flight for this texture, 0 if none
+            WorkQueue::RequestID pendingRequest;
+            /// Top level the request in flight will make resident
+            uint8 pendingMip;
+        };
+        typedef map<ResourceHandle, StreamedTexture>::type StreamedTextureMap;
+
+        /** Request to decode a range of levels on a worker thread. */
+        struct StreamRequest
+        {
+            ResourceHandle handle;
+            String name;
+            String group;
+            /// First level to extract from the source file
+            uint8 topMip;
+            /// Levels topMip and below, set by the worker
+            Image* image;
+
+            friend std::ostream& operator<<(std::ostream& o, const StreamRequest& r)
+            { (void)r; return o; }
+        };
+
+        StreamedTextureMap mStreamedTextures;
+        uint16 mWorkQueueChannel;
+        size_t mMemoryBudget;
+        uint32 mMipTailSize;
+        unsigned long mFrameCount;
+
+        /// Memory the levels topMip and below of the texture take
+        size_t calculateMemory(const StreamedTexture& st, uint8 topMip) const;
+        /// Memory the texture takes once the request in flight, if any, is applied
+        size_t getCommittedMemory(const StreamedTexture& st) const;
+        /// Queues decoding of the levels topMip and below
+        void requestMips(StreamedTexture& st, uint8 topMip);
+        /// Recreates the hardware texture from the given mip chain
+        void applyMips(StreamedTexture& st, const Image& image, uint8 topMip);
+        /** Drops textures not needed this frame towards their mip tail, least
+            recently used first, until committed memory is at most target.
+        @return Committed memory of all streamed textures afterwards
+        */
+        size_t evict(size_t committed, size_t target);
+
+        /// Copies the levels topMip and below of a 2D image into dest
+        static void extractMipChain(const Image& src, uint8 topMip, Image& dest);
+
+    public:
+        TextureStreamer();
+        virtual ~TextureStreamer();
+
+        /** Registers with the WorkQueue.
+        @note Called automatically by Root.
+        */
+        void initialise(void);
+        /** Aborts pending requests and releases all streamed textures.
+        @note Called automatically by Root::shutdown.
+        */
+        void shutdown(void);
+
+        /** Creates a texture whose detailed mip levels are streamed on demand.
+        @remarks
+            The texture is a manually loaded resource with this object as
+            its loader; its name is the file the levels are read from. Load
+            it like any other texture, or let a material do so.
+        */
+        TexturePtr createStreamedTexture(const String& name, const String& group);
+        /** Stops streaming the given texture.
+        @remarks
+            The texture keeps the levels it has, and is no longer kept alive
+            by the streamer.
+        */
+        void removeStreamedTexture(const TexturePtr& texture);
+        /// Returns whether the texture was created by createStreamedTexture.
+        bool isStreamedTexture(const Texture* texture) const;
+        /// Returns whether any streamed textures exist.
+        bool hasStreamedTextures(void) const { return !mStreamedTextures.empty(); }
+
+        /** Returns the level of the source file which is the top level of
+            the texture at the moment, 0 meaning fully resident.
+        */
+        uint8 getResidentMip(const TexturePtr& texture) const;
+
+        /** Sets the memory streamed textures may take in total, in bytes.
+        @remarks
+            Mip tails are always resident, so the budget only limits the
+            detailed levels. 0 disables the limit. The default is 256MB.
+        */
+        void setMemoryBudget(size_t bytes) { mMemoryBudget = bytes; }
+        /// Gets the memory streamed textures may take in total, in bytes.
+        size_t getMemoryBudget(void) const { return mMemoryBudget; }
+        /// Returns the memory streamed textures take at the moment, in bytes.
+        size_t getResidentMemory(void) const;
+
+        /** Sets the largest level, in texels along its longest side, which
+            is loaded straight away and never evicted.
+        @note Only affects textures loaded afterwards. The default is 64.
+        */
+        void setMipTailSize(uint32 size) { mMipTailSize = size; }
+        /// Gets the size of the levels which are always resident.
+        uint32 getMipTailSize(void) const { return mMipTailSize; }
+
+        /** Reports that a texture covers about pixelSize pixels on screen.
+        @remarks
+            The level whose size is closest to pixelSize without being
+            smaller is considered needed this frame.
+        */
+        void _notifyTextureDemand(const Texture* texture, Real pixelSize);
+        /** Reports the textures of a visible object.
+        @remarks
+            Called by RenderQueue::processVisibleObject. Estimates the size
+            of the object on screen from its bounding sphere and reports it
+            for every texture the object renders with.
+        */
+        void _notifyObjectVisible(MovableObject* mo, const Camera* cam);
+        /** Requests, evicts or schedules levels according to the demand
+            reported since the last call.
+        @note Called by Root once per frame.
+        */
+        void _update(void);
+
+        /// @copydoc ManualResourceLoader::loadResource
+        void loadResource(Resource* resource);
+        /// @copydoc WorkQueue::RequestHandler::canHandleRequest
+        bool canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
+        /// @copydoc WorkQueue::RequestHandler::handleRequest
+        WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
+        /// @copydoc WorkQueue::ResponseHandler::canHandleResponse
+        bool canHandleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ);
+        /// @copydoc WorkQueue::ResponseHandler::handleResponse
+        void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ);
+
+        /// @copydoc Singleton::getSingleton()
+        static TextureStreamer& getSingleton(void);
+        /// @copydoc Singleton::getSingleton()
+        static TextureStreamer* getSingletonPtr(void);
+    };
+
+    /** @} */
+    /** @} */
+}
+
+#endif
@@ -0,0 +1,137 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __TransformStorage_H__
+#define __TransformStorage_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreAtomicScalar.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Structure-of-arrays storage for the transforms of a node hierarchy.
+    @remarks
+        Nodes registered with a TransformStorage keep their local position,
+        orientation and scale in a slot of a contiguous block, one block per
+        depth in the hierarchy, and read and write it there directly. update()
+        then derives the world transforms and the cached 4x4 matrices of every
+        changed slot a whole level at a time, four nodes per iteration when SSE
+        is available, instead of chasing Node pointers across the heap.
+    @par
+        The Node API is unchanged: a node fetches the precomputed derived
+        state from its slot when _updateFromParent is called after update().
+        If any registered node is modified after update() the storage stops
+        serving results until the next update() call, so nodes fall back to
+        the regular per-node path and stay correct.
+    @par
+        Modifying different registered nodes from several threads at once is
+        safe, adding or removing nodes is not.
+    @note
+        Storage is normally owned by the SceneManager, see
+        SceneManager::setTransformStorageEnabled. Not supported when
+        OGRE_NODE_INHERIT_TRANSFORM is enabled.
+    */
+    class _OgreExport TransformStorage : public NodeAlloc
+    {
+    public:
+        TransformStorage();
+        ~TransformStorage();
+
+        /** Registers a node and all of its descendants.
+        @remarks
+            The node is placed one level below its parent, which must already
+            be registered with this storage; a node without a parent goes on
+            the top level.
+        */
+        void _addNode(Node* node);
+
+        /** Unregisters a node and all of its descendants. */
+        void _removeNode(Node* node);
+
+        /** Flags the slot of a registered node for update after its local
+            transform or inheritance flags changed.
+        */
+        void _notifyLocalChanged(const Node* node);
+
+        /** Recomputes the derived transforms of all changed slots. */
+        void update(void);
+
+        /** Returns whether derived transforms are available for all registered
+            nodes, i.e. nothing changed since the last update().
+        */
+        bool _isUpToDate(void) const { return mUpToDate.get(); }
+
+        /** Copies the derived transform computed by update() for a registered node.
+        @note
+            Only valid if _isUpToDate() returns true.
+        */
+        void _getDerivedTransform(const Node* node, Vector3& position,
+            Quaternion& orientation, Vector3& scale, Matrix4& transform) const;
+
+        /** Returns the number of registered nodes. */
+        size_t getNumNodes(void) const;
+
+        /** Returns the number of hierarchy levels currently holding slots. */
+        size_t getNumLevels(void) const { return mLevels.size(); }
+
+    protected:
+        struct Level;
+        typedef vector<Level*>::type LevelList;
+        /// Slot blocks, indexed by hierarchy depth
+        LevelList mLevels;
+        /// Whether every slot holds its current derived transform
+        AtomicScalar<bool> mUpToDate;
+        /// Whether the SSE code path can be used on this CPU
+        bool mUseSSE;
+
+        /// Appends a single node at the given depth
+        void addSlot(Node* node, uint16 depth, size_t parentIndex);
+        /// Swap-removes a single node from its level
+        void removeSlot(Node* node);
+        /// Points the owner of a slot at the local transform in it
+        void attachSlot(Level& level, size_t index);
+        /// Copies the local transform of a slot back into its owner and unregisters it
+        void detachSlot(Level& level, size_t index);
+        /// Derives the transforms of all slots of the given level
+        void updateLevel(uint16 depth);
+        /// Scalar version of updateLevel for four slots starting at the given one
+        void updateBlockGeneral(Level& level, const Level* parentLevel, size_t first);
+        /// SSE version of updateLevel for four slots starting at the given one
+        void updateBlockSSE(Level& level, const Level* parentLevel, size_t first);
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#endif
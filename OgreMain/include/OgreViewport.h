@@ -294,6 +294,10 @@ namespace Ogre {
         */
         unsigned int _getNumRenderedBatches(void) const;
 
+        /** Gets the number of bytes of shader constants uploaded in the last update.
+        */
+        size_t _getNumUploadedConstantBytes(void) const;
+
         /** Tells this viewport whether it should display Overlay objects.
         @remarks
             Overlay objects are layers which appear on top of the scene. They are created via
@@ -0,0 +1,289 @@
+/*-------------------------------------------------------------------------
+This source file is a part of OGRE
+(Object-oriented Graphics Rendering Engine)
+
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE
+-------------------------------------------------------------------------*/
+#ifndef __OgreWorkStealingQueue_H__
+#define __OgreWorkStealingQueue_H__
+
+#include "../OgreWorkQueue.h"
+#include "../OgreAtomicScalar.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+    /** Request / response work queue which hands requests out through lock free
+        queues owned by the worker threads.
+    @remarks
+        DefaultWorkQueue funnels every request through one mutex protected queue and
+        one condition variable, which serialises the workers once several
+        subsystems (terrain, paging, LOD generation...) submit at the same time.
+        Here each worker owns a set of bounded lock free queues, one per priority
+        lane. Requests are spread over the workers round robin, a worker drains its
+        own queue first and steals from the others when it runs dry, always taking
+        higher priority lanes first. Responses travel back to the main thread
+        through another lock free queue.
+    @par
+        Every channel is processed in the PRIORITY_NORMAL lane unless
+        setChannelPriority says otherwise. Idle thread requests, paused state and
+        request handlers behave as in DefaultWorkQueue. Requests only wait behind
+        a mutex when all the queues are full.
+    @par
+        Root uses this queue instead of DefaultWorkQueue if OGRE was built with
+        OGRE_CONFIG_WORKQUEUE_STEALING, otherwise install it with Root::setWorkQueue.
+    */
+    class _OgreExport WorkStealingQueue : public DefaultWorkQueueBase
+    {
+    public:
+        /// Lanes requests are processed in, lower values first
+        enum Priority
+        {
+            PRIORITY_HIGH = 0,
+            PRIORITY_NORMAL = 1,
+            PRIORITY_LOW = 2,
+            PRIORITY_COUNT = 3
+        };
+
+        WorkStealingQueue(const String& name = BLANKSTRING);
+        virtual ~WorkStealingQueue();
+
+        /** Sets the lane the requests of a channel are processed in.
+        @remarks
+            Takes effect for requests added after the call.
+        */
+        void setChannelPriority(uint16 channel, Priority priority);
+        /// Gets the lane the requests of a channel are processed in
+        Priority getChannelPriority(uint16 channel) const;
+
+        /// Main function for each thread spawned.
+        virtual void _threadMain();
+
+        /// @copydoc WorkQueue::shutdown
+        virtual void shutdown();
+
+        /// @copydoc WorkQueue::startup
+        virtual void startup(bool forceRestart = true);
+
+        /// @copydoc DefaultWorkQueueBase::_processNextRequest
+        virtual void _processNextRequest();
+
+        /// @copydoc WorkQueue::addRequest
+        virtual RequestID addRequest(uint16 channel, uint16 requestType, const Any& rData, uint8 retryCount = 0,
+            bool forceSynchronous = false, bool idleThread = false);
+        /// @copydoc WorkQueue::abortRequest
+        virtual void abortRequest(RequestID id);
+        /// @copydoc WorkQueue::abortRequestsByChannel
+        virtual void abortRequestsByChannel(uint16 channel);
+        /// @copydoc WorkQueue::abortPendingRequestsByChannel
+        virtual void abortPendingRequestsByChannel(uint16 channel);
+        /// @copydoc WorkQueue::abortAllRequests
+        virtual void abortAllRequests();
+        /// @copydoc WorkQueue::processResponses
+        virtual void processResponses();
+
+    protected:
+        /** Bounded multiple producer / multiple consumer queue.
+        @remarks
+            Each cell carries a sequence number telling whether it is ready to be
+            written or read for the current turn, so producers and consumers only
+            race on their own position with compare and swap.
+        */
+        template <typename T> class LockFreeRing : public UtilityAlloc
+        {
+        public:
+            /// @param capacity Must be a power of two
+            LockFreeRing(size_t capacity)
+                : mCells(OGRE_ALLOC_T(Cell, capacity, MEMCATEGORY_GENERAL)), mMask(capacity - 1),
+                mPushPos(0), mPopPos(0)
+            {
+                for (size_t i = 0; i < capacity; ++i)
+                    new (&mCells[i]) Cell(i);
+            }
+            ~LockFreeRing()
+            {
+                OGRE_FREE(mCells, MEMCATEGORY_GENERAL);
+            }
+
+            /// Returns false if the ring is full
+            bool push(const T& value)
+            {
+                size_t pos = mPushPos.get();
+                Cell* cell;
+                for (;;)
+                {
+                    cell = &mCells[pos & mMask];
+                    const ptrdiff_t diff = (ptrdiff_t)cell->sequence.get() - (ptrdiff_t)pos;
+                    if (diff == 0)
+                    {
+                        if (mPushPos.cas(pos, pos + 1))
+                            break;
+                        pos = mPushPos.get();
+                    }
+                    else if (diff < 0)
+                        return false;
+                    else
+                        pos = mPushPos.get();
+                }
+                cell->value = value;
+                // Publish with a full barrier, the value has to be visible first
+                cell->sequence.cas(pos, pos + 1);
+                return true;
+            }
+
+            /// Returns false if the ring is empty
+            bool pop(T& value)
+            {
+                size_t pos = mPopPos.get();
+                Cell* cell;
+                for (;;)
+                {
+                    cell = &mCells[pos & mMask];
+                    const ptrdiff_t diff = (ptrdiff_t)cell->sequence.get() - (ptrdiff_t)(pos + 1);
+                    if (diff == 0)
+                    {
+                        if (mPopPos.cas(pos, pos + 1))
+                            break;
+                        pos = mPopPos.get();
+                    }
+                    else if (diff < 0)
+                        return false;
+                    else
+                        pos = mPopPos.get();
+                }
+                value = cell->value;
+                // Hand the cell back to the producers one turn later
+                cell->sequence.cas(pos + 1, pos + mMask + 1);
+                return true;
+            }
+
+        private:
+            struct Cell
+            {
+                Cell(size_t seq) : sequence(seq), value() {}
+                AtomicScalar<size_t> sequence;
+                T value;
+            };
+            Cell* mCells;
+            const size_t mMask;
+            // Keep producers and consumers off each other's cache line
+            char mPad0[64];
+            AtomicScalar<size_t> mPushPos;
+            char mPad1[64];
+            AtomicScalar<size_t> mPopPos;
+        };
+        typedef LockFreeRing<Request*> RequestRing;
+        typedef LockFreeRing<Response*> ResponseRing;
+
+        /// Queues and in flight request of one worker thread
+        struct WorkerQueues : public UtilityAlloc
+        {
+            WorkerQueues(size_t idx);
+            ~WorkerQueues();
+
+            size_t index;
+            RequestRing* lanes[PRIORITY_COUNT];
+            /// Request being processed, so it can be flagged as aborted
+            Request* current;
+            OGRE_MUTEX(currentMutex);
+        };
+        typedef vector<WorkerQueues*>::type WorkerQueuesList;
+        WorkerQueuesList mWorkerQueues;
+
+        /// Lane of every channel
+        vector<uint8>::type mChannelPriorities;
+        ResponseRing* mResponseRing;
+        AtomicScalar<RequestID> mLastRequestID;
+        /// Requests in the rings or the overflow queue
+        AtomicScalar<size_t> mQueuedRequests;
+        /// Round robin counter to spread new requests over the workers
+        AtomicScalar<size_t> mNextWorker;
+        /// Hands out the worker indices when the threads start
+        AtomicScalar<size_t> mNextThreadIndex;
+
+        /// Workers sleep on this when there is nothing to process or steal
+        AtomicScalar<size_t> mSleepingWorkers;
+        OGRE_MUTEX(mWakeMutex);
+        OGRE_THREAD_SYNCHRONISER(mWakeCondition);
+
+        /** Aborts cannot walk the lock free rings, they are recorded here and
+            applied when a request or response leaves its ring.
+        @remarks
+            Only requests up to mAbortWatermark, i.e. which existed when the last
+            abort happened, have to look at the records.
+        */
+        AtomicScalar<RequestID> mAbortWatermark;
+        OGRE_MUTEX(mAbortMutex);
+        set<RequestID>::type mAbortedRequests;
+        /// Channel to last aborted request ID, for pending requests and responses
+        map<uint16, RequestID>::type mAbortedChannels;
+        /// Channel to last aborted request ID, for pending requests only
+        map<uint16, RequestID>::type mAbortedPendingChannels;
+        RequestID mAbortedAllUpTo;
+
+        size_t mNumThreadsRegisteredWithRS;
+        /// Init notification mutex (must lock before waiting on initCondition)
+        OGRE_MUTEX(mInitMutex);
+        /// Synchroniser token to wait / notify on thread init
+        OGRE_THREAD_SYNCHRONISER(mInitSync);
+#if OGRE_THREAD_SUPPORT
+        typedef vector<OGRE_THREAD_TYPE*>::type WorkerThreadList;
+        WorkerThreadList mWorkers;
+#endif
+
+        /// Queues a request, to the given worker if possible
+        void queueRequest(Request* req, size_t workerIdx);
+        /// Takes the highest priority request, own lanes first then stealing
+        Request* takeRequest(size_t workerIdx);
+        /** Processes the next request, returns false if there was none.
+        @param ownsQueue Whether the caller is the worker owning the queue
+        */
+        bool processNextRequest(size_t workerIdx, bool ownsQueue);
+        /// Runs the handlers, queues the response or processes it right away if synchronous
+        void processRequestResponse(Request* r, WorkerQueues* queues, bool synchronous);
+        /// Flags a request if an abort was recorded for it
+        void applyAborts(const Request* r, bool pending);
+        /// Records the end of an abort and flags the in flight requests matching
+        void abortInFlightRequests(uint16 channel, RequestID id, bool allChannels);
+        /// Suspends the worker until there is something to process
+        void waitForNextRequest();
+        /// Whether an idle request is waiting for the idle thread
+        bool hasIdleRequests();
+        void deleteQueues();
+
+        /// @copydoc DefaultWorkQueueBase::addRequestWithRID
+        virtual void addRequestWithRID(RequestID rid, uint16 channel, uint16 requestType, const Any& rData, uint8 retryCount);
+        virtual void notifyWorkers();
+        /// Notify that a thread has registered itself with the render system
+        void notifyThreadRegistered();
+    };
+    /** @} */
+    /** @} */
+
+}
+
+#endif
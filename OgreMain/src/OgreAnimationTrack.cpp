@@ -571,6 +571,14 @@ namespace Ogre {
         mSplineBuildNeeded = true;
     }
     //---------------------------------------------------------------------
+    void NodeAnimationTrack::_buildInterpolationSplines(void) const
+    {
+        if (mSplineBuildNeeded)
+        {
+            buildInterpolationSplines();
+        }
+    }
+    //---------------------------------------------------------------------
     bool NodeAnimationTrack::hasNonZeroKeyFrames(void) const
     {
         KeyFrameList::const_iterator i = mKeyFrames.begin();
@@ -52,6 +52,7 @@ namespace Ogre {
     AutoParamDataSource::AutoParamDataSource()
         : mWorldMatrixCount(0),
          mWorldMatrixArray(0),
+         mDirLightExtrusionDistance(10000),
          mWorldMatrixDirty(true),
          mViewMatrixDirty(true),
          mProjMatrixDirty(true),
@@ -65,6 +66,9 @@ namespace Ogre {
          mInverseTransposeWorldViewMatrixDirty(true),
          mCameraPositionDirty(true),
          mCameraPositionObjectSpaceDirty(true),
+         mAmbientLight(ColourValue::Black),
+         mFogColour(ColourValue::White),
+         mFogParams(Vector4::ZERO),
          mPassNumber(0),
          mSceneDepthRangeDirty(true),
          mLodCameraPositionDirty(true),
@@ -77,7 +81,9 @@ namespace Ogre {
          mCurrentViewport(0), 
          mCurrentSceneManager(0),
          mMainCamBoundsInfo(0),
-         mCurrentPass(0)
+         mCurrentPass(0),
+         mIdentityView(false),
+         mIdentityProjection(false)
     {
         mBlankLight.setDiffuseColour(ColourValue::Black);
         mBlankLight.setSpecularColour(ColourValue::Black);
@@ -92,11 +98,31 @@ namespace Ogre {
             mShadowCamDepthRangesDirty[i] = false;
         }
 
+        // Fresh versions can't be mistaken for those of a previous data source
+        for (int i = 0; i < SG_COUNT; ++i)
+            renewVersion(static_cast<SourceGroup>(i));
+        mVersionedTime = 0;
     }
     //-----------------------------------------------------------------------------
+    uint64 AutoParamDataSource::msVersionCounter = 0;
+    //-----------------------------------------------------------------------------
     AutoParamDataSource::~AutoParamDataSource()
     {
     }
+    //-----------------------------------------------------------------------------
+    uint64 AutoParamDataSource::getVersion(SourceGroup group) const
+    {
+        if (group == SG_TIME)
+        {
+            Real time = getTime();
+            if (time != mVersionedTime)
+            {
+                mVersionedTime = time;
+                renewVersion(SG_TIME);
+            }
+        }
+        return mVersions[group];
+    }
     //-----------------------------------------------------------------------------
 	const Camera* AutoParamDataSource::getCurrentCamera() const
 	{
@@ -118,6 +144,16 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentRenderable(const Renderable* rend)
     {
+        renewVersion(SG_RENDERABLE);
+        // The view and projection only follow the renderable when it overrides them
+        bool identityView = rend && rend->getUseIdentityView();
+        bool identityProjection = rend && rend->getUseIdentityProjection();
+        if (identityView != mIdentityView || identityProjection != mIdentityProjection)
+        {
+            mIdentityView = identityView;
+            mIdentityProjection = identityProjection;
+            renewVersion(SG_CAMERA);
+        }
         mCurrentRenderable = rend;
         mWorldMatrixDirty = true;
         mViewMatrixDirty = true;
@@ -142,6 +178,10 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentCamera(const Camera* cam, bool useCameraRelative)
     {
+        renewVersion(SG_CAMERA);
+        // Lights are read straight from the Light objects, which may have changed since
+        // the last render even if the light list itself is still the same
+        renewVersion(SG_LIGHTS);
         mCurrentCamera = cam;
         mCameraRelativeRendering = useCameraRelative;
         mCameraRelativePosition = cam->getDerivedPosition();
@@ -161,6 +201,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentLightList(const LightList* ll)
     {
+        renewVersion(SG_LIGHTS);
         mCurrentLightList = ll;
         for(size_t i = 0; i < ll->size() && i < OGRE_MAX_SIMULTANEOUS_LIGHTS; ++i)
         {
@@ -265,17 +306,20 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setMainCamBoundsInfo(VisibleObjectsBoundsInfo* info)
     {
+        renewVersion(SG_CAMERA);
         mMainCamBoundsInfo = info;
         mSceneDepthRangeDirty = true;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentSceneManager(const SceneManager* sm)
     {
+        renewVersion(SG_SCENE);
         mCurrentSceneManager = sm;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setWorldMatrices(const Matrix4* m, size_t count)
     {
+        renewVersion(SG_RENDERABLE);
         mWorldMatrixArray = m;
         mWorldMatrixCount = count;
         mWorldMatrixDirty = false;
@@ -521,7 +565,11 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setAmbientLightColour(const ColourValue& ambient)
     {
-        mAmbientLight = ambient;
+        if (ambient != mAmbientLight)
+        {
+            mAmbientLight = ambient;
+            renewVersion(SG_SCENE);
+        }
     }
     //---------------------------------------------------------------------
     float AutoParamDataSource::getLightCount() const
@@ -542,6 +590,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentPass(const Pass* pass)
     {
+        renewVersion(SG_PASS);
         mCurrentPass = pass;
     }
     //-----------------------------------------------------------------------------
@@ -627,11 +676,15 @@ namespace Ogre {
         Real expDensity, Real linearStart, Real linearEnd)
     {
         (void)mode; // ignored
-        mFogColour = colour;
-        mFogParams.x = expDensity;
-        mFogParams.y = linearStart;
-        mFogParams.z = linearEnd;
-        mFogParams.w = linearEnd != linearStart ? 1 / (linearEnd - linearStart) : 0;
+        Vector4 params(expDensity, linearStart, linearEnd,
+            linearEnd != linearStart ? 1 / (linearEnd - linearStart) : 0);
+        // Fog is set for every pass, only renew the version on an actual change
+        if (colour != mFogColour || params != mFogParams)
+        {
+            mFogColour = colour;
+            mFogParams = params;
+            renewVersion(SG_SCENE);
+        }
     }
     //-----------------------------------------------------------------------------
     const ColourValue& AutoParamDataSource::getFogColour(void) const
@@ -646,6 +699,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setTextureProjector(const Frustum* frust, size_t index = 0)
     {
+        renewVersion(SG_LIGHTS);
         if (index < OGRE_MAX_SIMULTANEOUS_LIGHTS)
         {
             mCurrentTextureProjector[index] = frust;
@@ -801,6 +855,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentRenderTarget(const RenderTarget* target)
     {
+        renewVersion(SG_VIEWPORT);
         mCurrentRenderTarget = target;
     }
     //-----------------------------------------------------------------------------
@@ -811,12 +866,17 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentViewport(const Viewport* viewport)
     {
+        renewVersion(SG_VIEWPORT);
         mCurrentViewport = viewport;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setShadowDirLightExtrusionDistance(Real dist)
     {
-        mDirLightExtrusionDistance = dist;
+        if (dist != mDirLightExtrusionDistance)
+        {
+            mDirLightExtrusionDistance = dist;
+            renewVersion(SG_LIGHTS);
+        }
     }
     //-----------------------------------------------------------------------------
     Real AutoParamDataSource::getShadowExtrusionDistance(void) const
@@ -1056,11 +1116,16 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setPassNumber(const int passNumber)
     {
-        mPassNumber = passNumber;
+        if (passNumber != mPassNumber)
+        {
+            mPassNumber = passNumber;
+            renewVersion(SG_PASS);
+        }
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::incPassNumber(void)
     {
+        renewVersion(SG_PASS);
         ++mPassNumber;
     }
     //-----------------------------------------------------------------------------
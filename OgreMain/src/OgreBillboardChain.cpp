@@ -172,11 +172,12 @@ namespace Ogre {
             // Any existing buffer will lose its reference count and be destroyed
             mVertexData->vertexBufferBinding->setBinding(0, pBuffer);
 
-            mIndexData->indexBuffer =
+            mIndexBuffer =
                 HardwareBufferManager::getSingleton().createIndexBuffer(
                     HardwareIndexBuffer::IT_16BIT,
                     mChainCount * mMaxElementsPerChain * 6, // max we can use
                     mDynamic? HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY : HardwareBuffer::HBU_STATIC_WRITE_ONLY);
+            mIndexData->indexBuffer = mIndexBuffer;
             // NB we don't set the indexCount on IndexData here since we will
             // probably use less than the maximum number of indices
 
@@ -643,11 +644,56 @@ namespace Ogre {
     {
 
         setupBuffers();
-        if (mIndexContentDirty)
+
+        // Dynamic chains change their indexes all the time, so they are written
+        // to a streaming buffer if there is one. Streamed indexes only last a
+        // frame and have to be written again on every update.
+        HardwareStreamingBuffer* streamingBuffer = 0;
+        if (mDynamic)
         {
+            streamingBuffer = HardwareBufferManager::getSingleton().getStreamingIndexBuffer(
+                HardwareIndexBuffer::IT_16BIT);
+        }
+
+        if (mIndexContentDirty || streamingBuffer)
+        {
+            // Count the indexes first, to reserve exactly that many
+            size_t indexCount = 0;
+            for (ChainSegmentList::iterator segi = mChainSegmentList.begin();
+                segi != mChainSegmentList.end(); ++segi)
+            {
+                ChainSegment& seg = *segi;
+                if (seg.head != SEGMENT_EMPTY && seg.head != seg.tail)
+                {
+                    size_t numElements = seg.tail >= seg.head ?
+                        seg.tail - seg.head : seg.tail + mMaxElementsPerChain - seg.head;
+                    indexCount += numElements * 6;
+                }
+            }
+
+            uint16* pShort = 0;
+            size_t indexStart = 0;
+            if (streamingBuffer && indexCount)
+                pShort = static_cast<uint16*>(streamingBuffer->allocate(indexCount, indexStart));
 
-            uint16* pShort = static_cast<uint16*>(
-                mIndexData->indexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+            bool locked = false;
+            if (pShort)
+            {
+                mIndexData->indexBuffer = streamingBuffer->getIndexBuffer();
+            }
+            else
+            {
+                // Fall back to our own buffer if the streaming buffer is full
+                mIndexData->indexBuffer = mIndexBuffer;
+                indexStart = 0;
+                if (indexCount)
+                {
+                    pShort = static_cast<uint16*>(
+                        mIndexBuffer->lock(HardwareBuffer::HBL_DISCARD));
+                    locked = true;
+                }
+            }
+            mIndexData->indexStart = indexStart;
             mIndexData->indexCount = 0;
             // indexes
             for (ChainSegmentList::iterator segi = mChainSegmentList.begin();
@@ -690,7 +736,8 @@ namespace Ogre {
                 }
 
             }
-            mIndexData->indexBuffer->unlock();
+            if (locked)
+                mIndexBuffer->unlock();
 
             mIndexContentDirty = false;
         }
@@ -68,7 +68,9 @@ namespace Ogre {
         mPoolSize(0),
         mExternalData(false),
         mAutoUpdate(true),
-        mBillboardDataChanged(true)
+        mBillboardDataChanged(true),
+        mStreamingBuffer(0),
+        mVertexStart(0)
     {
         setDefaultDimensions( 100, 100 );
         mMaterial = MaterialManager::getSingleton().getDefaultMaterial();
@@ -103,7 +105,9 @@ namespace Ogre {
         mPoolSize(poolSize),
         mExternalData(externalData),
         mAutoUpdate(true),
-        mBillboardDataChanged(true)
+        mBillboardDataChanged(true),
+        mStreamingBuffer(0),
+        mVertexStart(0)
     {
         setDefaultDimensions( 100, 100 );
         mMaterial = MaterialManager::getSingleton().getDefaultMaterial();
@@ -443,8 +447,35 @@ namespace Ogre {
         // Init num visible
         mNumVisibleBillboards = 0;
 
+        // Billboards rebuilt every frame are written straight into a mapped
+        // streaming buffer if the render system has one, saving the lock
+        mLockPtr = 0;
+        mStreamingBuffer = 0;
+        mVertexStart = 0;
+        if (mAutoUpdate)
+        {
+            size_t numVertices = numBillboards ? std::min(mPoolSize, numBillboards) : mPoolSize;
+            if (!mPointRendering)
+                numVertices *= 4;
+
+            HardwareStreamingBuffer* streamingBuffer =
+                HardwareBufferManager::getSingleton().getStreamingBuffer(mMainBuf->getVertexSize());
+            if (streamingBuffer)
+            {
+                mLockPtr = static_cast<float*>(streamingBuffer->allocate(numVertices, mVertexStart));
+                if (mLockPtr)
+                    mStreamingBuffer = streamingBuffer;
+            }
+        }
+        mVertexData->vertexBufferBinding->setBinding(0,
+            mStreamingBuffer ? mStreamingBuffer->getVertexBuffer() : mMainBuf);
+
         // Lock the buffer
-        if (numBillboards) // optimal lock
+        if (mStreamingBuffer)
+        {
+            // Already have somewhere to write to
+        }
+        else if (numBillboards) // optimal lock
         {
             // clamp to max
             numBillboards = std::min(mPoolSize, numBillboards);
@@ -537,7 +568,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void BillboardSet::endBillboards(void)
     {
-        mMainBuf->unlock();
+        if (!mStreamingBuffer)
+            mMainBuf->unlock();
     }
     //-----------------------------------------------------------------------
     void BillboardSet::setBounds(const AxisAlignedBox& box, Real radius)
@@ -665,7 +697,7 @@ namespace Ogre {
     void BillboardSet::getRenderOperation(RenderOperation& op)
     {
         op.vertexData = mVertexData;
-        op.vertexData->vertexStart = 0;
+        op.vertexData->vertexStart = mVertexStart;
 
         if (mPointRendering)
         {
@@ -873,6 +905,8 @@ namespace Ogre {
         }
 
         mMainBuf.setNull();
+        mStreamingBuffer = 0;
+        mVertexStart = 0;
 
         mBuffersCreated = false;
 
@@ -46,6 +46,9 @@ namespace Ogre {
         mOrientation(Quaternion::IDENTITY),
         mPosition(Vector3::ZERO),
         mSceneDetail(PM_SOLID),
+        mConstantBytesLastRender(0),
+        mVisNodesLastRender(0),
+        mCulledNodesLastRender(0),
         mAutoTrackTarget(0),
         mAutoTrackOffset(Vector3::ZERO),
         mSceneLodFactor(1.0f),
@@ -495,6 +498,22 @@ namespace Ogre {
         return mVisBatchesLastRender;
     }
     //-----------------------------------------------------------------------
+    void Camera::_notifyCulledNodes(unsigned int numVisible, unsigned int numCulled)
+    {
+        mVisNodesLastRender = numVisible;
+        mCulledNodesLastRender = numCulled;
+    }
+    //-----------------------------------------------------------------------
+    unsigned int Camera::_getNumVisibleNodes(void) const
+    {
+        return mVisNodesLastRender;
+    }
+    //-----------------------------------------------------------------------
+    unsigned int Camera::_getNumCulledNodes(void) const
+    {
+        return mCulledNodesLastRender;
+    }
+    //-----------------------------------------------------------------------
     const Quaternion& Camera::getOrientation(void) const
     {
         return mOrientation;
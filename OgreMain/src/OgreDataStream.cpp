@@ -30,6 +30,23 @@ THE SOFTWARE.
 #include "OgreLogManager.h"
 #include "OgreException.h"
 
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  if !defined(NOMINMAX) && defined(_MSC_VER)
+#   define NOMINMAX // required to stop windows.h messing up std::min
+#  endif
+#  include <windows.h>
+#  define OGRE_MEMORY_MAPPED_FILES 1
+#elif OGRE_PLATFORM == OGRE_PLATFORM_LINUX || OGRE_PLATFORM == OGRE_PLATFORM_APPLE || \
+    OGRE_PLATFORM == OGRE_PLATFORM_APPLE_IOS || OGRE_PLATFORM == OGRE_PLATFORM_ANDROID
+#  include <sys/mman.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#  define OGRE_MEMORY_MAPPED_FILES 1
+#else
+#  define OGRE_MEMORY_MAPPED_FILES 0
+#endif
+
 namespace Ogre {
 
     //-----------------------------------------------------------------------
@@ -467,6 +484,79 @@ namespace Ogre {
             mData = 0;
         }
 
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    MemoryMappedDataStream::MemoryMappedDataStream(const String& name,
+        const String& path, size_t size)
+        : MemoryDataStream(name, 0, 0, false, true)
+    {
+        assert(size > 0 && "Empty files cannot be mapped");
+        void* data = 0;
+#if OGRE_MEMORY_MAPPED_FILES && OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file != INVALID_HANDLE_VALUE)
+        {
+            // The view keeps the mapping alive, no need for the handles afterwards
+            HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (mapping)
+            {
+                data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+                CloseHandle(mapping);
+            }
+            CloseHandle(file);
+        }
+#elif OGRE_MEMORY_MAPPED_FILES
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd != -1)
+        {
+            data = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED)
+                data = 0;
+            ::close(fd);
+        }
+#else
+        std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+        if (file)
+        {
+            data = OGRE_ALLOC_T(uchar, size, MEMCATEGORY_GENERAL);
+            file.read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+            mFreeOnClose = true;
+        }
+#endif
+        if (!data)
+        {
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND,
+                "Cannot map file: " + path,
+                "MemoryMappedDataStream::MemoryMappedDataStream");
+        }
+
+        mData = mPos = static_cast<uchar*>(data);
+        mSize = size;
+        mEnd = mData + mSize;
+    }
+    //-----------------------------------------------------------------------
+    MemoryMappedDataStream::~MemoryMappedDataStream()
+    {
+        close();
+    }
+    //-----------------------------------------------------------------------
+    void MemoryMappedDataStream::close(void)
+    {
+#if OGRE_MEMORY_MAPPED_FILES
+        if (mData)
+        {
+#   if OGRE_PLATFORM == OGRE_PLATFORM_WIN32
+            UnmapViewOfFile(mData);
+#   else
+            munmap(mData, mSize);
+#   endif
+            mData = 0;
+        }
+#else
+        MemoryDataStream::close();
+#endif
     }
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
@@ -271,6 +271,28 @@ namespace Ogre {
         return HardwareVertexBufferSharedPtr(vb);
     }
     //-----------------------------------------------------------------------
+    HardwareStreamingBuffer*
+        DefaultHardwareBufferManagerBase::createStreamingBufferImpl(size_t vertexSize, size_t numVertices)
+    {
+        HardwareVertexBufferSharedPtr vb = createVertexBuffer(vertexSize, numVertices,
+            HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+        // Locking is free and the memory never moves, so keep the address
+        void* data = vb->lock(HardwareBuffer::HBL_NORMAL);
+        vb->unlock();
+        return OGRE_NEW HardwareStreamingBuffer(vb, data);
+    }
+    //-----------------------------------------------------------------------
+    HardwareStreamingBuffer*
+        DefaultHardwareBufferManagerBase::createStreamingIndexBufferImpl(
+        HardwareIndexBuffer::IndexType itype, size_t numIndexes)
+    {
+        HardwareIndexBufferSharedPtr ib = createIndexBuffer(itype, numIndexes,
+            HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE);
+        void* data = ib->lock(HardwareBuffer::HBL_NORMAL);
+        ib->unlock();
+        return OGRE_NEW HardwareStreamingBuffer(ib, data);
+    }
+    //-----------------------------------------------------------------------
     HardwareIndexBufferSharedPtr 
         DefaultHardwareBufferManagerBase::createIndexBuffer(HardwareIndexBuffer::IndexType itype, 
         size_t numIndexes, HardwareBuffer::Usage usage, bool useShadowBuffer)
@@ -874,24 +874,31 @@ namespace Ogre {
         return true;
     }
     //-----------------------------------------------------------------------
-    void Entity::updateAnimation(void)
+    void Entity::getAnimationMode(bool& hwAnimation, bool& stencilShadows,
+        bool& softwareAnimation, bool& blendNormals)
     {
-        // Do nothing if not initialised yet
-        if (!mInitialised)
-            return;
-
         Root& root = Root::getSingleton();
-        bool hwAnimation = isHardwareAnimationEnabled();
-        bool isNeedUpdateHardwareAnim = hwAnimation && !mCurrentHWAnimationState;
+        hwAnimation = isHardwareAnimationEnabled();
         bool forcedSwAnimation = getSoftwareAnimationRequests()>0;
         bool forcedNormals = getSoftwareAnimationNormalsRequests()>0;
-        bool stencilShadows = false;
+        stencilShadows = false;
         if (getCastShadows() && hasEdgeList() && root._getCurrentSceneManager())
             stencilShadows =  root._getCurrentSceneManager()->isShadowTechniqueStencilBased();
-        bool softwareAnimation = !hwAnimation || stencilShadows || forcedSwAnimation;
+        softwareAnimation = !hwAnimation || stencilShadows || forcedSwAnimation;
         // Blend normals in s/w only if we're not using h/w animation,
         // since shadows only require positions
-        bool blendNormals = !hwAnimation || forcedNormals;
+        blendNormals = !hwAnimation || forcedNormals;
+    }
+    //-----------------------------------------------------------------------
+    void Entity::updateAnimation(void)
+    {
+        // Do nothing if not initialised yet
+        if (!mInitialised)
+            return;
+
+        bool hwAnimation, stencilShadows, softwareAnimation, blendNormals;
+        getAnimationMode(hwAnimation, stencilShadows, softwareAnimation, blendNormals);
+        bool isNeedUpdateHardwareAnim = hwAnimation && !mCurrentHWAnimationState;
         // Animation dirty if animation state modified or manual bones modified
         bool animationDirty =
             (mFrameAnimationLastUpdated != mAnimationState->getDirtyFrameNumber()) ||
@@ -1416,6 +1423,95 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    bool Entity::_beginConcurrentAnimation(void)
+    {
+        if (!mInitialised || !hasSkeleton() || hasVertexAnimation() ||
+            mSharedSkeletonEntities || !mChildObjectList.empty())
+            return false;
+#if !OGRE_NO_MESHLOD
+        if (!mLodEntityList.empty())
+            return false;
+#endif
+
+        bool hwAnimation, stencilShadows, softwareAnimation, blendNormals;
+        getAnimationMode(hwAnimation, stencilShadows, softwareAnimation, blendNormals);
+        bool animationDirty =
+            (mFrameAnimationLastUpdated != mAnimationState->getDirtyFrameNumber()) ||
+            getSkeleton()->getManualBonesDirty();
+        if (!animationDirty &&
+            !(softwareAnimation && !tempSkelAnimBuffersBound(blendNormals)))
+            return false;
+
+        // Everything updateAnimation would do besides the bone matrices and the
+        // blend, so that it has nothing left to do when called later this frame
+        mCurrentHWAnimationState = hwAnimation;
+        mLastParentXform = _getParentNodeFullTransform();
+        if (hwAnimation && _isSkeletonAnimated() && !mBoneWorldMatrices)
+        {
+            mBoneWorldMatrices =
+                static_cast<Matrix4*>(OGRE_MALLOC_SIMD(sizeof(Matrix4) * mNumBoneMatrices, MEMCATEGORY_ANIMATION));
+        }
+
+        // Lazily built animation data is shared with other entities
+        mSkeletonInstance->_buildCachedAnimationData(*mAnimationState);
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void Entity::_updateBoneMatricesConcurrent(void)
+    {
+        cacheBoneMatrices();
+
+        if (mCurrentHWAnimationState && _isSkeletonAnimated())
+        {
+            OptimisedUtil::getImplementation()->concatenateAffineMatrices(
+                mLastParentXform,
+                mBoneMatrices,
+                mBoneWorldMatrices,
+                mNumBoneMatrices);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Entity::_prepareSoftwareSkinning(Mesh::SoftwareVertexBlendJobList& jobs,
+        Mesh::LockedVertexBufferMap& lockedBuffers)
+    {
+        bool hwAnimation, stencilShadows, softwareAnimation, blendNormals;
+        getAnimationMode(hwAnimation, stencilShadows, softwareAnimation, blendNormals);
+        if (!softwareAnimation)
+            return;
+
+        if (mSkelAnimVertexData)
+        {
+            mTempSkelAnimInfo.checkoutTempCopies(true, blendNormals);
+            mTempSkelAnimInfo.bindTempCopies(mSkelAnimVertexData, hwAnimation);
+            jobs.push_back(Mesh::SoftwareVertexBlendJob());
+            Mesh::prepareMatricesForVertexBlend(jobs.back().blendMatrices,
+                mBoneMatrices, mMesh->sharedBlendIndexToBoneIndexMap);
+            Mesh::_prepareSoftwareVertexBlend(mMesh->sharedVertexData, mSkelAnimVertexData,
+                blendNormals, jobs.back(), lockedBuffers);
+        }
+        SubEntityList::iterator i, iend;
+        iend = mSubEntityList.end();
+        for (i = mSubEntityList.begin(); i != iend; ++i)
+        {
+            SubEntity* se = *i;
+            if (se->isVisible() && se->mSkelAnimVertexData)
+            {
+                se->mTempSkelAnimInfo.checkoutTempCopies(true, blendNormals);
+                se->mTempSkelAnimInfo.bindTempCopies(se->mSkelAnimVertexData, hwAnimation);
+                jobs.push_back(Mesh::SoftwareVertexBlendJob());
+                Mesh::prepareMatricesForVertexBlend(jobs.back().blendMatrices,
+                    mBoneMatrices, se->mSubMesh->blendIndexToBoneIndexMap);
+                Mesh::_prepareSoftwareVertexBlend(se->mSubMesh->vertexData,
+                    se->mSkelAnimVertexData, blendNormals, jobs.back(), lockedBuffers);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Entity::_finishConcurrentAnimation(void)
+    {
+        mFrameAnimationLastUpdated = mAnimationState->getDirtyFrameNumber();
+    }
+    //-----------------------------------------------------------------------
     bool Entity::_isAnimated(void) const
     {
         return (mAnimationState && mAnimationState->hasEnabledAnimationState()) ||
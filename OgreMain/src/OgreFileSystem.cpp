@@ -55,6 +55,7 @@ THE SOFTWARE.
 namespace Ogre {
 
     bool FileSystemArchive::msIgnoreHidden = true;
+    bool FileSystemArchive::msMemoryMapping = false;
 
     //-----------------------------------------------------------------------
     FileSystemArchive::FileSystemArchive(const String& name, const String& archType, bool readOnly )
@@ -225,6 +226,13 @@ namespace Ogre {
                         "FileSystemArchive::open");
         }
 
+        // Empty files cannot be mapped, they are cheap to stream anyway
+        if (readOnly && msMemoryMapping && tagStat.st_size > 0)
+        {
+            return DataStreamPtr(OGRE_NEW MemoryMappedDataStream(filename,
+                full_path, (size_t)tagStat.st_size));
+        }
+
         if (!readOnly)
         {
             mode |= std::ios::out;
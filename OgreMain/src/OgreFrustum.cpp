@@ -549,10 +549,13 @@ namespace Ogre {
 #endif
 
         RenderSystem* renderSystem = Root::getSingleton().getRenderSystem();
-        // API specific
-        renderSystem->_convertProjectionMatrix(mProjMatrix, mProjMatrixRS);
-        // API specific for Gpu Programs
-        renderSystem->_convertProjectionMatrix(mProjMatrix, mProjMatrixRSDepth, true);
+        if (renderSystem)
+        {
+            // API specific
+            renderSystem->_convertProjectionMatrix(mProjMatrix, mProjMatrixRS);
+            // API specific for Gpu Programs
+            renderSystem->_convertProjectionMatrix(mProjMatrix, mProjMatrixRSDepth, true);
+        }
 
 
         // Calculate bounding box (local)
@@ -581,7 +584,9 @@ namespace Ogre {
         }
         mBoundingBox.setExtents(min, max);
 
-        mRecalcFrustum = false;
+        // Without a render system yet (e.g. culling only) the API specific
+        // matrices can't be derived, so stay out of date until there is one
+        mRecalcFrustum = (renderSystem == 0);
 
         // Signal to update frustum clipping planes
         mRecalcFrustumPlanes = true;
@@ -33,6 +33,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreDualQuaternion.h"
 #include "OgreRoot.h"
 #include "OgreRenderTarget.h"
+#include "OgreAutoParamDataSource.h"
 
 namespace Ogre
 {
@@ -932,6 +933,7 @@ namespace Ogre
         , mTransposeMatrices(false)
         , mIgnoreMissingParams(false)
         , mActivePassIterationIndex(std::numeric_limits<size_t>::max())
+        , mLastAutoParamSource(0)
     {
     }
     //-----------------------------------------------------------------------------
@@ -964,6 +966,7 @@ namespace Ogre
         mTransposeMatrices = oth.mTransposeMatrices;
         mIgnoreMissingParams  = oth.mIgnoreMissingParams;
         mActivePassIterationIndex = oth.mActivePassIterationIndex;
+        mLastAutoParamSource = oth.mLastAutoParamSource;
 
         return *this;
     }
@@ -1514,6 +1517,192 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
+    uint16 GpuProgramParameters::deriveSourceGroups(GpuProgramParameters::AutoConstantType act)
+    {
+        const uint16 renderable = 1 << AutoParamDataSource::SG_RENDERABLE;
+        const uint16 camera = 1 << AutoParamDataSource::SG_CAMERA;
+        const uint16 lights = 1 << AutoParamDataSource::SG_LIGHTS;
+        const uint16 pass = 1 << AutoParamDataSource::SG_PASS;
+        const uint16 scene = 1 << AutoParamDataSource::SG_SCENE;
+        const uint16 viewport = 1 << AutoParamDataSource::SG_VIEWPORT;
+        const uint16 time = 1 << AutoParamDataSource::SG_TIME;
+
+        switch(act)
+        {
+        case ACT_WORLD_MATRIX:
+        case ACT_INVERSE_WORLD_MATRIX:
+        case ACT_TRANSPOSE_WORLD_MATRIX:
+        case ACT_INVERSE_TRANSPOSE_WORLD_MATRIX:
+        case ACT_WORLD_MATRIX_ARRAY_3x4:
+        case ACT_WORLD_MATRIX_ARRAY:
+        case ACT_WORLD_DUALQUATERNION_ARRAY_2x4:
+        case ACT_WORLD_SCALE_SHEAR_MATRIX_ARRAY_3x4:
+        case ACT_CUSTOM:
+        case ACT_ANIMATION_PARAMETRIC:
+            return renderable;
+
+        case ACT_VIEW_MATRIX:
+        case ACT_INVERSE_VIEW_MATRIX:
+        case ACT_TRANSPOSE_VIEW_MATRIX:
+        case ACT_INVERSE_TRANSPOSE_VIEW_MATRIX:
+        case ACT_PROJECTION_MATRIX:
+        case ACT_INVERSE_PROJECTION_MATRIX:
+        case ACT_TRANSPOSE_PROJECTION_MATRIX:
+        case ACT_INVERSE_TRANSPOSE_PROJECTION_MATRIX:
+        case ACT_VIEWPROJ_MATRIX:
+        case ACT_INVERSE_VIEWPROJ_MATRIX:
+        case ACT_TRANSPOSE_VIEWPROJ_MATRIX:
+        case ACT_INVERSE_TRANSPOSE_VIEWPROJ_MATRIX:
+            // The projection is adjusted for the render target
+            return camera | viewport;
+
+        case ACT_WORLDVIEW_MATRIX:
+        case ACT_INVERSE_WORLDVIEW_MATRIX:
+        case ACT_TRANSPOSE_WORLDVIEW_MATRIX:
+        case ACT_INVERSE_TRANSPOSE_WORLDVIEW_MATRIX:
+        case ACT_WORLDVIEWPROJ_MATRIX:
+        case ACT_INVERSE_WORLDVIEWPROJ_MATRIX:
+        case ACT_TRANSPOSE_WORLDVIEWPROJ_MATRIX:
+        case ACT_INVERSE_TRANSPOSE_WORLDVIEWPROJ_MATRIX:
+            return renderable | camera | viewport;
+
+        case ACT_CAMERA_POSITION:
+        case ACT_LOD_CAMERA_POSITION:
+        case ACT_VIEW_DIRECTION:
+        case ACT_VIEW_SIDE_VECTOR:
+        case ACT_VIEW_UP_VECTOR:
+        case ACT_FOV:
+        case ACT_NEAR_CLIP_DISTANCE:
+        case ACT_FAR_CLIP_DISTANCE:
+        case ACT_SCENE_DEPTH_RANGE:
+            return camera;
+
+        case ACT_CAMERA_POSITION_OBJECT_SPACE:
+        case ACT_LOD_CAMERA_POSITION_OBJECT_SPACE:
+            return renderable | camera;
+
+        case ACT_LIGHT_COUNT:
+        case ACT_LIGHT_DIFFUSE_COLOUR:
+        case ACT_LIGHT_SPECULAR_COLOUR:
+        case ACT_LIGHT_ATTENUATION:
+        case ACT_SPOTLIGHT_PARAMS:
+        case ACT_LIGHT_POWER_SCALE:
+        case ACT_LIGHT_DIFFUSE_COLOUR_POWER_SCALED:
+        case ACT_LIGHT_SPECULAR_COLOUR_POWER_SCALED:
+        case ACT_LIGHT_DIFFUSE_COLOUR_ARRAY:
+        case ACT_LIGHT_SPECULAR_COLOUR_ARRAY:
+        case ACT_LIGHT_DIFFUSE_COLOUR_POWER_SCALED_ARRAY:
+        case ACT_LIGHT_SPECULAR_COLOUR_POWER_SCALED_ARRAY:
+        case ACT_LIGHT_ATTENUATION_ARRAY:
+        case ACT_LIGHT_POWER_SCALE_ARRAY:
+        case ACT_SPOTLIGHT_PARAMS_ARRAY:
+        case ACT_LIGHT_NUMBER:
+        case ACT_LIGHT_CASTS_SHADOWS:
+        case ACT_LIGHT_CASTS_SHADOWS_ARRAY:
+        case ACT_LIGHT_CUSTOM:
+            return lights;
+
+        case ACT_LIGHT_POSITION:
+        case ACT_LIGHT_DIRECTION:
+        case ACT_LIGHT_POSITION_VIEW_SPACE:
+        case ACT_LIGHT_DIRECTION_VIEW_SPACE:
+        case ACT_LIGHT_POSITION_ARRAY:
+        case ACT_LIGHT_DIRECTION_ARRAY:
+        case ACT_LIGHT_POSITION_VIEW_SPACE_ARRAY:
+        case ACT_LIGHT_DIRECTION_VIEW_SPACE_ARRAY:
+        case ACT_TEXTURE_VIEWPROJ_MATRIX:
+        case ACT_TEXTURE_VIEWPROJ_MATRIX_ARRAY:
+        case ACT_SPOTLIGHT_VIEWPROJ_MATRIX:
+        case ACT_SPOTLIGHT_VIEWPROJ_MATRIX_ARRAY:
+            // Positions are relative to the camera with camera relative rendering
+            return lights | camera;
+
+        case ACT_LIGHT_POSITION_OBJECT_SPACE:
+        case ACT_LIGHT_DIRECTION_OBJECT_SPACE:
+        case ACT_LIGHT_DISTANCE_OBJECT_SPACE:
+        case ACT_LIGHT_POSITION_OBJECT_SPACE_ARRAY:
+        case ACT_LIGHT_DIRECTION_OBJECT_SPACE_ARRAY:
+        case ACT_LIGHT_DISTANCE_OBJECT_SPACE_ARRAY:
+        case ACT_TEXTURE_WORLDVIEWPROJ_MATRIX:
+        case ACT_TEXTURE_WORLDVIEWPROJ_MATRIX_ARRAY:
+        case ACT_SPOTLIGHT_WORLDVIEWPROJ_MATRIX:
+        case ACT_SPOTLIGHT_WORLDVIEWPROJ_MATRIX_ARRAY:
+        case ACT_SHADOW_EXTRUSION_DISTANCE:
+            return renderable | lights | camera;
+
+        case ACT_SHADOW_SCENE_DEPTH_RANGE:
+        case ACT_SHADOW_SCENE_DEPTH_RANGE_ARRAY:
+            return lights | camera | scene;
+
+        case ACT_DERIVED_LIGHT_DIFFUSE_COLOUR:
+        case ACT_DERIVED_LIGHT_SPECULAR_COLOUR:
+        case ACT_DERIVED_LIGHT_DIFFUSE_COLOUR_ARRAY:
+        case ACT_DERIVED_LIGHT_SPECULAR_COLOUR_ARRAY:
+            return lights | pass;
+
+        case ACT_AMBIENT_LIGHT_COLOUR:
+        case ACT_FOG_COLOUR:
+        case ACT_FOG_PARAMS:
+        case ACT_SHADOW_COLOUR:
+            return scene;
+
+        case ACT_DERIVED_AMBIENT_LIGHT_COLOUR:
+        case ACT_DERIVED_SCENE_COLOUR:
+            return scene | pass;
+
+        case ACT_SURFACE_AMBIENT_COLOUR:
+        case ACT_SURFACE_DIFFUSE_COLOUR:
+        case ACT_SURFACE_SPECULAR_COLOUR:
+        case ACT_SURFACE_EMISSIVE_COLOUR:
+        case ACT_SURFACE_SHININESS:
+        case ACT_SURFACE_ALPHA_REJECTION_VALUE:
+        case ACT_TEXTURE_SIZE:
+        case ACT_INVERSE_TEXTURE_SIZE:
+        case ACT_PACKED_TEXTURE_SIZE:
+        case ACT_PASS_NUMBER:
+            return pass;
+
+        case ACT_TEXTURE_MATRIX:
+            // Texture transforms can be animated by controllers
+            return pass | time;
+
+        case ACT_RENDER_TARGET_FLIPPING:
+        case ACT_VIEWPORT_WIDTH:
+        case ACT_VIEWPORT_HEIGHT:
+        case ACT_INVERSE_VIEWPORT_WIDTH:
+        case ACT_INVERSE_VIEWPORT_HEIGHT:
+        case ACT_VIEWPORT_SIZE:
+            return viewport;
+
+        case ACT_TIME:
+        case ACT_TIME_0_X:
+        case ACT_COSTIME_0_X:
+        case ACT_SINTIME_0_X:
+        case ACT_TANTIME_0_X:
+        case ACT_TIME_0_X_PACKED:
+        case ACT_TIME_0_1:
+        case ACT_COSTIME_0_1:
+        case ACT_SINTIME_0_1:
+        case ACT_TANTIME_0_1:
+        case ACT_TIME_0_1_PACKED:
+        case ACT_TIME_0_2PI:
+        case ACT_COSTIME_0_2PI:
+        case ACT_SINTIME_0_2PI:
+        case ACT_TANTIME_0_2PI:
+        case ACT_TIME_0_2PI_PACKED:
+        case ACT_FRAME_TIME:
+            return time;
+
+        case ACT_FPS:
+            return time | viewport;
+
+        default:
+            // Render system state and pass iterations are not tracked by the
+            // data source, these are recalculated on every update
+            return 0;
+        };
+    }
+    //---------------------------------------------------------------------
     GpuLogicalIndexUse* GpuProgramParameters::_getFloatConstantLogicalIndexUse(
         size_t logicalIndex, size_t requestedSize, uint16 variability)
     {
@@ -2261,6 +2450,8 @@ namespace Ogre
                 i->data = extraInfo;
                 i->elementCount = elementSize;
                 i->variability = variability;
+                i->sourceGroups = deriveSourceGroups(acType);
+                i->updateStamp = 0;
                 found = true;
                 break;
             }
@@ -2311,6 +2502,8 @@ namespace Ogre
                 i->fData = rData;
                 i->elementCount = elementSize;
                 i->variability = variability;
+                i->sourceGroups = deriveSourceGroups(acType);
+                i->updateStamp = 0;
                 found = true;
                 break;
             }
@@ -2419,12 +2612,35 @@ namespace Ogre
 
         mActivePassIterationIndex = std::numeric_limits<size_t>::max();
 
+        // Values written from another data source can't be compared against the versions of this one
+        const bool sameSource = source == mLastAutoParamSource;
+        mLastAutoParamSource = source;
+        // Versions are fetched on demand, the time version has to query the controllers
+        uint64 versions[AutoParamDataSource::SG_COUNT] = { 0 };
+
         // Autoconstant index is not a physical index
-        for (AutoConstantList::const_iterator i = mAutoConstants.begin(); i != mAutoConstants.end(); ++i)
+        for (AutoConstantList::iterator i = mAutoConstants.begin(); i != mAutoConstants.end(); ++i)
         {
             // Only update needed slots
             if (i->variability & mask)
             {
+                // Skip values whose sources did not change since they were written
+                if (sameSource && i->updateStamp && i->sourceGroups)
+                {
+                    uint64 latest = 0;
+                    for (int g = 0; g < AutoParamDataSource::SG_COUNT; ++g)
+                    {
+                        if (i->sourceGroups & (1 << g))
+                        {
+                            if (!versions[g])
+                                versions[g] = source->getVersion(static_cast<AutoParamDataSource::SourceGroup>(g));
+                            latest = std::max(latest, versions[g]);
+                        }
+                    }
+                    if (latest < i->updateStamp)
+                        continue;
+                }
+                i->updateStamp = AutoParamDataSource::_allocateVersion();
 
                 switch(i->paramType)
                 {
@@ -3435,6 +3651,7 @@ namespace Ogre
         mUnsignedIntConstants = source.getUnsignedIntConstantList();
         // mBoolConstants = source.getBoolConstantList();
         mAutoConstants = source.getAutoConstantList();
+        mLastAutoParamSource = source.mLastAutoParamSource;
         mCombinedVariability = source.mCombinedVariability;
         copySharedParamSetUsage(source.mSharedParamSets);
     }
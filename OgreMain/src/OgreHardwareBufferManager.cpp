@@ -62,6 +62,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     HardwareBufferManagerBase::HardwareBufferManagerBase()
         : mUnderUsedFrameCount(0)
+        , mStreamingBufferSize(4 * 1024 * 1024)
     {
     }
     //-----------------------------------------------------------------------
@@ -75,6 +76,7 @@ namespace Ogre {
         mCounterBuffers.clear();
 
         // Destroy everything
+        destroyAllStreamingBuffers();
         destroyAllDeclarations();
         destroyAllBindings();
         // No need to destroy main buffers - they will be destroyed by removal of bindings
@@ -154,6 +156,82 @@ namespace Ogre {
         mVertexBufferBindings.clear();
     }
     //-----------------------------------------------------------------------
+    HardwareStreamingBuffer* HardwareBufferManagerBase::createStreamingBufferImpl(
+        size_t vertexSize, size_t numVertices)
+    {
+        return 0;
+    }
+    //-----------------------------------------------------------------------
+    HardwareStreamingBuffer* HardwareBufferManagerBase::createStreamingIndexBufferImpl(
+        HardwareIndexBuffer::IndexType itype, size_t numIndexes)
+    {
+        return 0;
+    }
+    //-----------------------------------------------------------------------
+    void HardwareBufferManagerBase::destroyAllStreamingBuffers(void)
+    {
+        OGRE_LOCK_MUTEX(mStreamingBuffersMutex);
+        StreamingBufferMap::iterator i;
+        for (i = mStreamingBuffers.begin(); i != mStreamingBuffers.end(); ++i)
+        {
+            OGRE_DELETE i->second;
+        }
+        mStreamingBuffers.clear();
+        for (i = mStreamingIndexBuffers.begin(); i != mStreamingIndexBuffers.end(); ++i)
+        {
+            OGRE_DELETE i->second;
+        }
+        mStreamingIndexBuffers.clear();
+    }
+    //-----------------------------------------------------------------------
+    HardwareStreamingBuffer* HardwareBufferManagerBase::getStreamingBuffer(size_t vertexSize)
+    {
+        OGRE_LOCK_MUTEX(mStreamingBuffersMutex);
+        StreamingBufferMap::iterator i = mStreamingBuffers.find(vertexSize);
+        if (i != mStreamingBuffers.end())
+            return i->second;
+
+        // Remember unsupported sizes as well, so we only ask once
+        HardwareStreamingBuffer* buf = 0;
+        size_t numVertices = mStreamingBufferSize / vertexSize;
+        if (numVertices)
+            buf = createStreamingBufferImpl(vertexSize, numVertices);
+        mStreamingBuffers.insert(StreamingBufferMap::value_type(vertexSize, buf));
+        return buf;
+    }
+    //-----------------------------------------------------------------------
+    HardwareStreamingBuffer* HardwareBufferManagerBase::getStreamingIndexBuffer(
+        HardwareIndexBuffer::IndexType itype)
+    {
+        OGRE_LOCK_MUTEX(mStreamingBuffersMutex);
+        StreamingBufferMap::iterator i = mStreamingIndexBuffers.find(itype);
+        if (i != mStreamingIndexBuffers.end())
+            return i->second;
+
+        HardwareStreamingBuffer* buf = 0;
+        size_t numIndexes = mStreamingBufferSize / (itype == HardwareIndexBuffer::IT_32BIT ? 4 : 2);
+        if (numIndexes)
+            buf = createStreamingIndexBufferImpl(itype, numIndexes);
+        mStreamingIndexBuffers.insert(StreamingBufferMap::value_type(itype, buf));
+        return buf;
+    }
+    //-----------------------------------------------------------------------
+    void HardwareBufferManagerBase::_endStreamingFrame(void)
+    {
+        OGRE_LOCK_MUTEX(mStreamingBuffersMutex);
+        StreamingBufferMap::iterator i;
+        for (i = mStreamingBuffers.begin(); i != mStreamingBuffers.end(); ++i)
+        {
+            if (i->second)
+                i->second->_endFrame();
+        }
+        for (i = mStreamingIndexBuffers.begin(); i != mStreamingIndexBuffers.end(); ++i)
+        {
+            if (i->second)
+                i->second->_endFrame();
+        }
+    }
+    //-----------------------------------------------------------------------
     void HardwareBufferManagerBase::registerVertexBufferSourceAndCopy(
             const HardwareVertexBufferSharedPtr& sourceBuffer,
             const HardwareVertexBufferSharedPtr& copy)
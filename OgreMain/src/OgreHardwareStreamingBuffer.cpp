@@ -0,0 +1,153 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreHardwareStreamingBuffer.h"
+
+namespace Ogre {
+
+    //-----------------------------------------------------------------------
+    HardwareStreamingBuffer::HardwareStreamingBuffer(const HardwareVertexBufferSharedPtr& buffer, void* data)
+        : mVertexBuffer(buffer)
+        , mData(static_cast<unsigned char*>(data))
+        , mElementSize(buffer->getVertexSize())
+        , mNumElements(buffer->getNumVertices())
+        , mHead(0)
+        , mUsedElements(0)
+        , mFrameElements(0)
+    {
+    }
+    //-----------------------------------------------------------------------
+    HardwareStreamingBuffer::HardwareStreamingBuffer(const HardwareIndexBufferSharedPtr& buffer, void* data)
+        : mIndexBuffer(buffer)
+        , mData(static_cast<unsigned char*>(data))
+        , mElementSize(buffer->getIndexSize())
+        , mNumElements(buffer->getNumIndexes())
+        , mHead(0)
+        , mUsedElements(0)
+        , mFrameElements(0)
+    {
+    }
+    //-----------------------------------------------------------------------
+    HardwareStreamingBuffer::~HardwareStreamingBuffer()
+    {
+    }
+    //-----------------------------------------------------------------------
+    void HardwareStreamingBuffer::retireOldestFrame(bool wait)
+    {
+        PendingFrame& frame = mPendingFrames.front();
+        if (frame.fence)
+        {
+            if (wait)
+                waitFence(frame.fence);
+            deleteFence(frame.fence);
+        }
+        mUsedElements -= frame.numElements;
+        mPendingFrames.pop_front();
+    }
+    //-----------------------------------------------------------------------
+    void* HardwareStreamingBuffer::allocate(size_t numElements, size_t& start)
+    {
+        if (numElements == 0 || numElements > mNumElements)
+            return 0;
+
+        while (true)
+        {
+            if (mUsedElements == 0)
+            {
+                // Nothing in flight, start over at the beginning of the ring
+                mHead = 0;
+            }
+
+            // Elements in use form one run which ends at mHead and may wrap
+            size_t tail = (mHead + mNumElements - mUsedElements) % mNumElements;
+            bool wrapped = mUsedElements != 0 && tail >= mHead;
+            size_t consumed = 0;
+            size_t first = 0;
+
+            if (mUsedElements == mNumElements)
+            {
+                // Full
+            }
+            else if (!wrapped)
+            {
+                // Free space runs from mHead to the end, then from 0 to tail
+                if (mHead + numElements <= mNumElements)
+                {
+                    first = mHead;
+                    consumed = numElements;
+                }
+                else if (numElements <= tail)
+                {
+                    // Skip the end of the ring, the padding belongs to this frame
+                    first = 0;
+                    consumed = mNumElements - mHead + numElements;
+                }
+            }
+            else if (mHead + numElements <= tail)
+            {
+                first = mHead;
+                consumed = numElements;
+            }
+
+            if (consumed)
+            {
+                mHead = (first + numElements) % mNumElements;
+                mUsedElements += consumed;
+                mFrameElements += consumed;
+                start = first;
+                return mData + first * mElementSize;
+            }
+
+            // Only the current frame is left, it must not be overwritten
+            if (mPendingFrames.empty())
+                return 0;
+
+            retireOldestFrame(true);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void HardwareStreamingBuffer::_endFrame(void)
+    {
+        if (mFrameElements)
+        {
+            PendingFrame frame;
+            frame.numElements = mFrameElements;
+            frame.fence = createFence();
+            mPendingFrames.push_back(frame);
+            mFrameElements = 0;
+        }
+
+        // Hand back whatever the GPU has finished with, so fences don't pile up
+        while (!mPendingFrames.empty() &&
+               (!mPendingFrames.front().fence || isFenceSignalled(mPendingFrames.front().fence)))
+        {
+            retireOldestFrame(false);
+        }
+    }
+
+}
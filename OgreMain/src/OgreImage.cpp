@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgreImageCodec.h"
 #include "OgreColourValue.h"
 #include "OgreMath.h"
+#include "OgreSIMDHelper.h"
 #include "OgreImageResampler.h"
 #include "OgreResourceGroupManager.h"
 
@@ -578,6 +579,120 @@ namespace Ogre {
         Image::scale(temp.getPixelBox(), getPixelBox(), filter);
     }
     //-----------------------------------------------------------------------
+    namespace
+    {
+        /// Halves src into dst with BoxDownsampler, returns false if the format isn't supported
+        bool boxDownsample(const PixelBox& src, const PixelBox& dst, BoxDownsampleJob& job)
+        {
+            if (src.getDepth() > 1)
+                return false;
+
+            job.src = &src;
+            job.dst = &dst;
+            PixelUtil::RowFunction func = 0;
+            switch (src.format)
+            {
+            case PF_L8: case PF_A8: case PF_BYTE_LA:
+            case PF_R8G8B8: case PF_B8G8R8:
+            case PF_R8G8B8A8: case PF_B8G8R8A8:
+            case PF_A8B8G8R8: case PF_A8R8G8B8:
+            case PF_X8B8G8R8: case PF_X8R8G8B8:
+                switch (PixelUtil::getNumElemBytes(src.format))
+                {
+                case 1: func = BoxDownsampler_Byte<1>::downsampleRows; break;
+                case 2: func = BoxDownsampler_Byte<2>::downsampleRows; break;
+                case 3: func = BoxDownsampler_Byte<3>::downsampleRows; break;
+                case 4: func = BoxDownsampler_Byte<4>::downsampleRows; break;
+                }
+                break;
+            case PF_FLOAT32_R: func = BoxDownsampler_Float32<1>::downsampleRows; break;
+            case PF_FLOAT32_GR: func = BoxDownsampler_Float32<2>::downsampleRows; break;
+            case PF_FLOAT32_RGB: func = BoxDownsampler_Float32<3>::downsampleRows; break;
+            case PF_FLOAT32_RGBA: func = BoxDownsampler_Float32<4>::downsampleRows; break;
+            default:
+                return false;
+            }
+
+            PixelUtil::_parallelForRows(dst.getHeight(), dst.getWidth(), func, &job);
+            return true;
+        }
+    }
+    //-----------------------------------------------------------------------
+    bool Image::generateMipmaps(bool gammaCorrected, Filter filter)
+    {
+        if (PixelUtil::isCompressed(mFormat))
+            return false;
+
+        uint32 numMips = 0;
+        for (uint32 w = mWidth, h = mHeight, d = mDepth; w > 1 || h > 1 || d > 1; ++numMips)
+        {
+            w = std::max<uint32>(w / 2, 1);
+            h = std::max<uint32>(h / 2, 1);
+            d = std::max<uint32>(d / 2, 1);
+        }
+
+        const size_t numFaces = getNumFaces();
+        Image result;
+        result.loadDynamicImage(
+            OGRE_ALLOC_T(uchar, calculateSize(numMips, numFaces, mWidth, mHeight, mDepth, mFormat), MEMCATEGORY_GENERAL),
+            mWidth, mHeight, mDepth, mFormat, true, numFaces, numMips);
+
+        BoxDownsampleJob job = { 0, 0, 0, 0, -1 };
+        float toLinear[256];
+        uchar fromLinear[4096];
+        if (gammaCorrected)
+        {
+            // sRGB transfer function
+            for (int i = 0; i < 256; ++i)
+            {
+                float c = i / 255.0f;
+                toLinear[i] = c <= 0.04045f ? c / 12.92f : Math::Pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            for (int i = 0; i < 4096; ++i)
+            {
+                float c = i / 4095.0f;
+                c = c <= 0.0031308f ? c * 12.92f : 1.055f * Math::Pow(c, 1.0f / 2.4f) - 0.055f;
+                fromLinear[i] = static_cast<uchar>(c * 255.0f + 0.5f);
+            }
+            job.toLinear = toLinear;
+            job.fromLinear = fromLinear;
+
+            // Find the byte holding alpha, if any
+            if (PixelUtil::hasAlpha(mFormat))
+            {
+                uchar pixel[4] = { 0, 0, 0, 0 };
+                PixelUtil::packColour(0.0f, 0.0f, 0.0f, 1.0f, mFormat, pixel);
+                for (int k = 0; k < 4; ++k)
+                {
+                    if (pixel[k])
+                        job.alphaChannel = k;
+                }
+            }
+        }
+
+        const bool box = filter == FILTER_BOX || filter == FILTER_LINEAR || filter == FILTER_BILINEAR;
+        for (size_t face = 0; face < numFaces; ++face)
+        {
+            PixelUtil::bulkPixelConversion(getPixelBox(face, 0), result.getPixelBox(face, 0));
+            for (uint32 mip = 1; mip <= numMips; ++mip)
+            {
+                PixelBox src = result.getPixelBox(face, mip - 1);
+                PixelBox dst = result.getPixelBox(face, mip);
+                if (!box || !boxDownsample(src, dst, job))
+                    Image::scale(src, dst, filter == FILTER_BOX ? FILTER_BILINEAR : filter);
+            }
+        }
+
+        // Take over the buffer of the result
+        freeMemory();
+        mBuffer = result.mBuffer;
+        mBufSize = result.mBufSize;
+        mNumMipmaps = numMips;
+        mAutoDelete = true;
+        result.mBuffer = NULL;
+        return true;
+    }
+    //-----------------------------------------------------------------------
     void Image::scale(const PixelBox &src, const PixelBox &scaled, Filter filter) 
     {
         assert(PixelUtil::isAccessible(src.format));
@@ -280,7 +280,47 @@ struct LinearResampler_Float32 {
 // 2D only; punts 3D pixelboxes to default LinearResampler (slow).
 // templated on bytes-per-pixel to allow compiler optimizations, such
 // as unrolling loops and replacing multiplies with bitshifts
+#if __OGRE_HAVE_SSE2
+// blends four 4-byte pixels with the same fixed-point math as the scalar
+// loop below. the 24-bit weights are split into a high and a low 12-bit part
+// so all products fit into the 16x16->32 bit multiply-adds.
+inline void bilinearPixel_SSE2(const uchar* p11, const uchar* p21, const uchar* p12, const uchar* p22,
+    unsigned int sxf, unsigned int syf, uchar* pdst)
+{
+    const __m128i zero = _mm_setzero_si128();
+    unsigned int sxfsyf = sxf*syf;
+    unsigned int w11 = 0x1000000-(sxf<<12)-(syf<<12)+sxfsyf;
+    unsigned int w21 = (sxf<<12)-sxfsyf;
+    unsigned int w12 = (syf<<12)-sxfsyf;
+    unsigned int w22 = sxfsyf;
+
+    // channels of the two pixels of a row interleaved as 16-bit values
+    __m128i top = _mm_unpacklo_epi8(_mm_unpacklo_epi8(
+        _mm_cvtsi32_si128(*(const int*)p11), _mm_cvtsi32_si128(*(const int*)p21)), zero);
+    __m128i bottom = _mm_unpacklo_epi8(_mm_unpacklo_epi8(
+        _mm_cvtsi32_si128(*(const int*)p12), _mm_cvtsi32_si128(*(const int*)p22)), zero);
+
+    __m128i high = _mm_add_epi32(
+        _mm_madd_epi16(top, _mm_set1_epi32((int)((w11 >> 12) | ((w21 >> 12) << 16)))),
+        _mm_madd_epi16(bottom, _mm_set1_epi32((int)((w12 >> 12) | ((w22 >> 12) << 16)))));
+    __m128i low = _mm_add_epi32(
+        _mm_madd_epi16(top, _mm_set1_epi32((int)((w11 & 0xFFF) | ((w21 & 0xFFF) << 16)))),
+        _mm_madd_epi16(bottom, _mm_set1_epi32((int)((w12 & 0xFFF) | ((w22 & 0xFFF) << 16)))));
+
+    // accum may use all 32 bits, the logical shift treats it as unsigned
+    __m128i accum = _mm_add_epi32(_mm_add_epi32(_mm_slli_epi32(high, 12), low), _mm_set1_epi32(0x800000));
+    accum = _mm_srli_epi32(accum, 24);
+    accum = _mm_packus_epi16(_mm_packs_epi32(accum, zero), zero);
+    *(int*)pdst = _mm_cvtsi128_si32(accum);
+}
+#endif
+
 template<unsigned int channels> struct LinearResampler_Byte {
+    struct Job {
+        const PixelBox* src;
+        const PixelBox* dst;
+    };
+
     static void scale(const PixelBox& src, const PixelBox& dst) {
         // assert(src.format == dst.format);
 
@@ -290,17 +330,26 @@ template<unsigned int channels> struct LinearResampler_Byte {
             return;
         }
 
+        // rows are independent, large images are split up between threads
+        Job job = { &src, &dst };
+        PixelUtil::_parallelForRows(dst.getHeight(), dst.getWidth(), scaleRows, &job);
+    }
+
+    static void scaleRows(size_t rowBegin, size_t rowEnd, void* userData) {
+        const PixelBox& src = *static_cast<Job*>(userData)->src;
+        const PixelBox& dst = *static_cast<Job*>(userData)->dst;
+
         // srcdata stays at beginning of slice, pdst is a moving pointer
         uchar* srcdata = (uchar*)src.getTopLeftFrontPixelPtr();
-        uchar* pdst = (uchar*)dst.getTopLeftFrontPixelPtr();
+        uchar* pdst = (uchar*)dst.getTopLeftFrontPixelPtr() + rowBegin*dst.rowPitch*channels;
 
         // sx_48,sy_48 represent current position in source
         // using 16/48-bit fixed precision, incremented by steps
         uint64 stepx = ((uint64)src.getWidth() << 48) / dst.getWidth();
         uint64 stepy = ((uint64)src.getHeight() << 48) / dst.getHeight();
         
-        uint64 sy_48 = (stepy >> 1) - 1;
-        for (size_t y = dst.top; y < dst.bottom; y++, sy_48+=stepy) {
+        uint64 sy_48 = (stepy >> 1) - 1 + rowBegin*stepy;
+        for (size_t y = rowBegin; y < rowEnd; y++, sy_48+=stepy) {
             // bottom 28 bits of temp are 16/12 bit fixed precision, used to
             // adjust a source coordinate backwards by half a pixel so that the
             // integer bits represent the first sample (eg, sx1) and the
@@ -321,6 +370,14 @@ template<unsigned int channels> struct LinearResampler_Byte {
                 uint32 sx1 = temp >> 12;
                 uint32 sx2 = std::min(sx1+1, src.right-src.left-1);
 
+#if __OGRE_HAVE_SSE2
+                if (channels == 4) {
+                    bilinearPixel_SSE2(&srcdata[(sx1 + syoff1)*4], &srcdata[(sx2 + syoff1)*4],
+                        &srcdata[(sx1 + syoff2)*4], &srcdata[(sx2 + syoff2)*4], sxf, syf, pdst);
+                    pdst += 4;
+                    continue;
+                }
+#endif
                 unsigned int sxfsyf = sxf*syf;
                 for (unsigned int k = 0; k < channels; k++) {
                     unsigned int accum =
@@ -337,6 +394,90 @@ template<unsigned int channels> struct LinearResampler_Byte {
         }
     }
 };
+// 2x2 box filter halving an image, used to build mipmaps. each destination
+// pixel averages source pixels 2x,2x+1 of rows 2y,2y+1; a trailing odd row or
+// column of the source is dropped, a source dimension of 1 is reused.
+// 2D only, source and destination have the same format.
+struct BoxDownsampleJob {
+    const PixelBox* src;
+    const PixelBox* dst;
+    // byte formats only: sRGB to linear table, null to average the bytes as they are
+    const float* toLinear;
+    // linear value quantised to 12 bits to sRGB
+    const uchar* fromLinear;
+    // channel left linear by the gamma correction, -1 if none
+    int alphaChannel;
+};
+
+template<unsigned int channels> struct BoxDownsampler_Byte {
+    static void downsampleRows(size_t rowBegin, size_t rowEnd, void* userData) {
+        const BoxDownsampleJob& job = *static_cast<BoxDownsampleJob*>(userData);
+        const PixelBox& src = *job.src;
+        const PixelBox& dst = *job.dst;
+        const uchar* srcdata = (const uchar*)src.getTopLeftFrontPixelPtr();
+        const size_t srcWidth = src.getWidth(), srcHeight = src.getHeight();
+
+        for (size_t y = rowBegin; y < rowEnd; y++) {
+            const uchar* row1 = srcdata + std::min(2*y, srcHeight-1)*src.rowPitch*channels;
+            const uchar* row2 = srcdata + std::min(2*y+1, srcHeight-1)*src.rowPitch*channels;
+            uchar* pdst = (uchar*)dst.getTopLeftFrontPixelPtr() + y*dst.rowPitch*channels;
+            size_t x = 0;
+#if __OGRE_HAVE_SSE2
+            if (channels == 4 && !job.toLinear) {
+                // two destination pixels from four source pixels of each row
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i rounding = _mm_set1_epi16(2);
+                for (; 2*x + 4 <= srcWidth; x += 2, pdst += 8) {
+                    __m128i a = _mm_loadu_si128((const __m128i*)(row1 + 2*x*4));
+                    __m128i b = _mm_loadu_si128((const __m128i*)(row2 + 2*x*4));
+                    __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+                    __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+                    __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+                    sum = _mm_srli_epi16(_mm_add_epi16(sum, rounding), 2);
+                    _mm_storel_epi64((__m128i*)pdst, _mm_packus_epi16(sum, sum));
+                }
+            }
+#endif
+            for (; x < dst.getWidth(); x++) {
+                size_t sx1 = std::min(2*x, srcWidth-1)*channels;
+                size_t sx2 = std::min(2*x+1, srcWidth-1)*channels;
+                for (unsigned int k = 0; k < channels; k++) {
+                    if (job.toLinear && (int)k != job.alphaChannel) {
+                        float sum = job.toLinear[row1[sx1+k]] + job.toLinear[row1[sx2+k]] +
+                            job.toLinear[row2[sx1+k]] + job.toLinear[row2[sx2+k]];
+                        *pdst++ = job.fromLinear[(unsigned int)(sum * (4095.0f / 4.0f) + 0.5f)];
+                    }
+                    else {
+                        *pdst++ = static_cast<uchar>(
+                            (row1[sx1+k] + row1[sx2+k] + row2[sx1+k] + row2[sx2+k] + 2) >> 2);
+                    }
+                }
+            }
+        }
+    }
+};
+
+template<unsigned int channels> struct BoxDownsampler_Float32 {
+    static void downsampleRows(size_t rowBegin, size_t rowEnd, void* userData) {
+        const BoxDownsampleJob& job = *static_cast<BoxDownsampleJob*>(userData);
+        const PixelBox& src = *job.src;
+        const PixelBox& dst = *job.dst;
+        const float* srcdata = (const float*)src.getTopLeftFrontPixelPtr();
+        const size_t srcWidth = src.getWidth(), srcHeight = src.getHeight();
+
+        for (size_t y = rowBegin; y < rowEnd; y++) {
+            const float* row1 = srcdata + std::min(2*y, srcHeight-1)*src.rowPitch*channels;
+            const float* row2 = srcdata + std::min(2*y+1, srcHeight-1)*src.rowPitch*channels;
+            float* pdst = (float*)dst.getTopLeftFrontPixelPtr() + y*dst.rowPitch*channels;
+            for (size_t x = 0; x < dst.getWidth(); x++) {
+                size_t sx1 = std::min(2*x, srcWidth-1)*channels;
+                size_t sx2 = std::min(2*x+1, srcWidth-1)*channels;
+                for (unsigned int k = 0; k < channels; k++)
+                    *pdst++ = (row1[sx1+k] + row1[sx2+k] + row2[sx1+k] + row2[sx2+k]) * 0.25f;
+            }
+        }
+    }
+};
 /** @} */
 /** @} */
 
@@ -491,10 +491,14 @@ namespace Ogre
     //-----------------------------------------------------------------------
     void InstanceManager::_addDirtyBatch( InstanceBatch *dirtyBatch )
     {
+        mDirtyBatchesMutex.lock();
+
         if( mDirtyBatches.empty() )
             mSceneManager->_addDirtyInstanceManager( this );
 
         mDirtyBatches.push_back( dirtyBatch );
+
+        mDirtyBatchesMutex.unlock();
     }
     //-----------------------------------------------------------------------
     void InstanceManager::_updateDirtyBatches(void)
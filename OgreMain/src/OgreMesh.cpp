@@ -211,8 +211,10 @@ namespace Ogre {
             ResourceGroupManager::getSingleton().openResource(
                 mName, mGroup, true, this);
  
-        // fully prebuffer into host RAM
-        mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
+        // fully prebuffer into host RAM, unless the archive already provided
+        // the data in memory (e.g. a memory mapped file)
+        if (!dynamic_cast<MemoryDataStream*>(mFreshFromDisk.get()))
+            mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
     }
     //-----------------------------------------------------------------------
     void Mesh::unprepareImpl()
@@ -1848,20 +1850,33 @@ namespace Ogre {
         const Matrix4* const* blendMatrices, size_t numMatrices,
         bool blendNormals)
     {
-        float *pSrcPos = 0;
-        float *pSrcNorm = 0;
-        float *pDestPos = 0;
-        float *pDestNorm = 0;
-        float *pBlendWeight = 0;
-        unsigned char* pBlendIdx = 0;
-        size_t srcPosStride = 0;
-        size_t srcNormStride = 0;
-        size_t destPosStride = 0;
-        size_t destNormStride = 0;
-        size_t blendWeightStride = 0;
-        size_t blendIdxStride = 0;
+        SoftwareVertexBlendJob job;
+        LockedVertexBufferMap lockedBuffers;
+        _prepareSoftwareVertexBlend(sourceVertexData, targetVertexData, blendNormals,
+            job, lockedBuffers);
+        std::copy(blendMatrices, blendMatrices + numMatrices, job.blendMatrices);
 
+        _applySoftwareVertexBlend(job, 0, job.vertexCount);
 
+        _unlockVertexBlendBuffers(lockedBuffers);
+    }
+    //---------------------------------------------------------------------
+    static void* lockVertexBlendBuffer(const HardwareVertexBufferSharedPtr& buf,
+        HardwareBuffer::LockOptions options, Mesh::LockedVertexBufferMap& lockedBuffers)
+    {
+        Mesh::LockedVertexBufferMap::iterator i = lockedBuffers.find(buf.get());
+        if (i == lockedBuffers.end())
+        {
+            i = lockedBuffers.insert(Mesh::LockedVertexBufferMap::value_type(
+                buf.get(), buf->lock(options))).first;
+        }
+        return i->second;
+    }
+    //---------------------------------------------------------------------
+    void Mesh::_prepareSoftwareVertexBlend(const VertexData* sourceVertexData,
+        const VertexData* targetVertexData, bool blendNormals,
+        SoftwareVertexBlendJob& job, LockedVertexBufferMap& lockedBuffers)
+    {
         // Get elements for source
         const VertexElement* srcElemPos =
             sourceVertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
@@ -1889,102 +1904,116 @@ namespace Ogre {
         HardwareVertexBufferSharedPtr srcWeightBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemBlendWeights->getSource());
         HardwareVertexBufferSharedPtr srcNormBuf;
 
-        srcPosStride = srcPosBuf->getVertexSize();
-        
-        blendIdxStride = srcIdxBuf->getVertexSize();
-        
-        blendWeightStride = srcWeightBuf->getVertexSize();
+        job.srcPosStride = srcPosBuf->getVertexSize();
+        job.srcNormStride = 0;
+        job.blendIdxStride = srcIdxBuf->getVertexSize();
+        job.blendWeightStride = srcWeightBuf->getVertexSize();
         if (includeNormals)
         {
             srcNormBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemNorm->getSource());
-            srcNormStride = srcNormBuf->getVertexSize();
+            job.srcNormStride = srcNormBuf->getVertexSize();
         }
         // Get buffers for target
         HardwareVertexBufferSharedPtr destPosBuf = targetVertexData->vertexBufferBinding->getBuffer(destElemPos->getSource());
         HardwareVertexBufferSharedPtr destNormBuf;
-        destPosStride = destPosBuf->getVertexSize();
+        job.destPosStride = destPosBuf->getVertexSize();
+        job.destNormStride = 0;
         if (includeNormals)
         {
             destNormBuf = targetVertexData->vertexBufferBinding->getBuffer(destElemNorm->getSource());
-            destNormStride = destNormBuf->getVertexSize();
+            job.destNormStride = destNormBuf->getVertexSize();
         }
 
         void* pBuffer;
+        float* pFloat;
+        unsigned char* pBlendIdx;
 
         // Lock source buffers for reading
-        pBuffer = srcPosBuf->lock(HardwareBuffer::HBL_READ_ONLY);
-        srcElemPos->baseVertexPointerToElement(pBuffer, &pSrcPos);
+        pBuffer = lockVertexBlendBuffer(srcPosBuf, HardwareBuffer::HBL_READ_ONLY, lockedBuffers);
+        srcElemPos->baseVertexPointerToElement(pBuffer, &pFloat);
+        job.srcPos = pFloat;
+        job.srcNorm = 0;
         if (includeNormals)
         {
-            if (srcNormBuf != srcPosBuf)
-            {
-                // Different buffer
-                pBuffer = srcNormBuf->lock(HardwareBuffer::HBL_READ_ONLY);
-            }
-            srcElemNorm->baseVertexPointerToElement(pBuffer, &pSrcNorm);
+            pBuffer = lockVertexBlendBuffer(srcNormBuf, HardwareBuffer::HBL_READ_ONLY, lockedBuffers);
+            srcElemNorm->baseVertexPointerToElement(pBuffer, &pFloat);
+            job.srcNorm = pFloat;
         }
 
         // Indices must be 4 bytes
         assert(srcElemBlendIndices->getType() == VET_UBYTE4 &&
                "Blend indices must be VET_UBYTE4");
-        pBuffer = srcIdxBuf->lock(HardwareBuffer::HBL_READ_ONLY);
+        pBuffer = lockVertexBlendBuffer(srcIdxBuf, HardwareBuffer::HBL_READ_ONLY, lockedBuffers);
         srcElemBlendIndices->baseVertexPointerToElement(pBuffer, &pBlendIdx);
-        if (srcWeightBuf != srcIdxBuf)
-        {
-            // Lock buffer
-            pBuffer = srcWeightBuf->lock(HardwareBuffer::HBL_READ_ONLY);
-        }
-        srcElemBlendWeights->baseVertexPointerToElement(pBuffer, &pBlendWeight);
-        unsigned short numWeightsPerVertex =
+        job.blendIndices = pBlendIdx;
+        pBuffer = lockVertexBlendBuffer(srcWeightBuf, HardwareBuffer::HBL_READ_ONLY, lockedBuffers);
+        srcElemBlendWeights->baseVertexPointerToElement(pBuffer, &pFloat);
+        job.blendWeights = pFloat;
+        job.numWeightsPerVertex =
             VertexElement::getTypeCount(srcElemBlendWeights->getType());
 
 
         // Lock destination buffers for writing
-        pBuffer = destPosBuf->lock(
+        pBuffer = lockVertexBlendBuffer(destPosBuf,
             (destNormBuf != destPosBuf && destPosBuf->getVertexSize() == destElemPos->getSize()) ||
             (destNormBuf == destPosBuf && destPosBuf->getVertexSize() == destElemPos->getSize() + destElemNorm->getSize()) ?
-            HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL);
-        destElemPos->baseVertexPointerToElement(pBuffer, &pDestPos);
+            HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL, lockedBuffers);
+        destElemPos->baseVertexPointerToElement(pBuffer, &pFloat);
+        job.destPos = pFloat;
+        job.destNorm = 0;
         if (includeNormals)
         {
-            if (destNormBuf != destPosBuf)
-            {
-                pBuffer = destNormBuf->lock(
-                    destNormBuf->getVertexSize() == destElemNorm->getSize() ?
-                    HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL);
-            }
-            destElemNorm->baseVertexPointerToElement(pBuffer, &pDestNorm);
+            pBuffer = lockVertexBlendBuffer(destNormBuf,
+                destNormBuf->getVertexSize() == destElemNorm->getSize() ?
+                HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL, lockedBuffers);
+            destElemNorm->baseVertexPointerToElement(pBuffer, &pFloat);
+            job.destNorm = pFloat;
         }
 
+        job.vertexCount = targetVertexData->vertexCount;
+    }
+    //---------------------------------------------------------------------
+    void Mesh::_applySoftwareVertexBlend(const SoftwareVertexBlendJob& job,
+        size_t start, size_t count)
+    {
+        // Offset every stream to the first vertex of the range
+        const float* pSrcPos = reinterpret_cast<const float*>(
+            reinterpret_cast<const char*>(job.srcPos) + start * job.srcPosStride);
+        float* pDestPos = reinterpret_cast<float*>(
+            reinterpret_cast<char*>(job.destPos) + start * job.destPosStride);
+        const float* pSrcNorm = 0;
+        float* pDestNorm = 0;
+        if (job.destNorm)
+        {
+            pSrcNorm = reinterpret_cast<const float*>(
+                reinterpret_cast<const char*>(job.srcNorm) + start * job.srcNormStride);
+            pDestNorm = reinterpret_cast<float*>(
+                reinterpret_cast<char*>(job.destNorm) + start * job.destNormStride);
+        }
+        const float* pBlendWeight = reinterpret_cast<const float*>(
+            reinterpret_cast<const char*>(job.blendWeights) + start * job.blendWeightStride);
+        const unsigned char* pBlendIdx = job.blendIndices + start * job.blendIdxStride;
+
         OptimisedUtil::getImplementation()->softwareVertexSkinning(
-            pSrcPos, pDestPos,
-            pSrcNorm, pDestNorm,
+            pSrcPos, pDestPos, pSrcNorm, pDestNorm,
             pBlendWeight, pBlendIdx,
-            blendMatrices,
-            srcPosStride, destPosStride,
-            srcNormStride, destNormStride,
-            blendWeightStride, blendIdxStride,
-            numWeightsPerVertex,
-            targetVertexData->vertexCount);
-
-        // Unlock source buffers
-        srcPosBuf->unlock();
-        srcIdxBuf->unlock();
-        if (srcWeightBuf != srcIdxBuf)
-        {
-            srcWeightBuf->unlock();
-        }
-        if (includeNormals && srcNormBuf != srcPosBuf)
-        {
-            srcNormBuf->unlock();
-        }
-        // Unlock destination buffers
-        destPosBuf->unlock();
-        if (includeNormals && destNormBuf != destPosBuf)
+            job.blendMatrices,
+            job.srcPosStride, job.destPosStride,
+            job.srcNormStride, job.destNormStride,
+            job.blendWeightStride, job.blendIdxStride,
+            job.numWeightsPerVertex,
+            count);
+    }
+    //---------------------------------------------------------------------
+    void Mesh::_unlockVertexBlendBuffers(LockedVertexBufferMap& lockedBuffers)
+    {
+        LockedVertexBufferMap::iterator i, iend;
+        iend = lockedBuffers.end();
+        for (i = lockedBuffers.begin(); i != iend; ++i)
         {
-            destNormBuf->unlock();
+            i->first->unlock();
         }
-
+        lockedBuffers.clear();
     }
     //---------------------------------------------------------------------
     void Mesh::softwareVertexMorph(Real t,
@@ -38,7 +38,7 @@ namespace Ogre {
     const unsigned short HEADER_CHUNK_ID = 0x1000;
     //---------------------------------------------------------------------
     MeshSerializer::MeshSerializer()
-        :mListener(0)
+        :mListener(0), mNumDirectBufferReads(0)
     {
         // Init implementations
         // String identifiers have not always been 100% unified with OGRE version
@@ -187,6 +187,7 @@ namespace Ogre {
         
         // Call implementation
         impl->importMesh(stream, pDest, mListener);
+        mNumDirectBufferReads = impl->getNumDirectBufferReads();
         // Warn on old version of mesh
         if (ver != mVersionData[0]->versionString)
         {
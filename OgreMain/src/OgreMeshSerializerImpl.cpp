@@ -54,6 +54,7 @@ namespace Ogre {
     const long MSTREAM_OVERHEAD_SIZE = sizeof(uint16) + sizeof(uint32);
     //---------------------------------------------------------------------
     MeshSerializerImpl::MeshSerializerImpl()
+        : mNumDirectBufferReads(0)
     {
         // Version number
         mVersion = "[MeshSerializer_v1.100]";
@@ -103,6 +104,7 @@ namespace Ogre {
     {
         // Determine endianness (must be the first thing we do!)
         determineEndianness(stream);
+        mNumDirectBufferReads = 0;
 
 #if OGRE_SERIALIZER_VALIDATE_CHUNKSIZE
         enableValidation();
@@ -822,16 +824,19 @@ namespace Ogre {
             dest->vertexCount,
             pMesh->mVertexBufferUsage,
             pMesh->mVertexBufferShadowBuffer);
-        void* pBuf = vbuf->lock(HardwareBuffer::HBL_DISCARD);
-        stream->read(pBuf, dest->vertexCount * vertexSize);
-
-        // endian conversion for OSX
-        flipFromLittleEndian(
-            pBuf,
-            dest->vertexCount,
-            vertexSize,
-            dest->vertexDeclaration->findElementsBySource(bindIndex));
-        vbuf->unlock();
+        if (!readBufferDataDirect(stream, *vbuf))
+        {
+            void* pBuf = vbuf->lock(HardwareBuffer::HBL_DISCARD);
+            stream->read(pBuf, dest->vertexCount * vertexSize);
+
+            // endian conversion for OSX
+            flipFromLittleEndian(
+                pBuf,
+                dest->vertexCount,
+                vertexSize,
+                dest->vertexDeclaration->findElementsBySource(bindIndex));
+            vbuf->unlock();
+        }
 
         // Set binding
         dest->vertexBufferBinding->setBinding(bindIndex, vbuf);
@@ -1027,11 +1032,14 @@ namespace Ogre {
                         pMesh->mIndexBufferUsage,
                         pMesh->mIndexBufferShadowBuffer);
                 // unsigned int* faceVertexIndices
-                unsigned int* pIdx = static_cast<unsigned int*>(
-                    ibuf->lock(HardwareBuffer::HBL_DISCARD)
-                    );
-                readInts(stream, pIdx, sm->indexData->indexCount);
-                ibuf->unlock();
+                if (!readBufferDataDirect(stream, *ibuf))
+                {
+                    unsigned int* pIdx = static_cast<unsigned int*>(
+                        ibuf->lock(HardwareBuffer::HBL_DISCARD)
+                        );
+                    readInts(stream, pIdx, sm->indexData->indexCount);
+                    ibuf->unlock();
+                }
 
             }
             else // 16-bit
@@ -1043,11 +1051,14 @@ namespace Ogre {
                         pMesh->mIndexBufferUsage,
                         pMesh->mIndexBufferShadowBuffer);
                 // unsigned short* faceVertexIndices
-                unsigned short* pIdx = static_cast<unsigned short*>(
-                    ibuf->lock(HardwareBuffer::HBL_DISCARD)
-                    );
-                readShorts(stream, pIdx, sm->indexData->indexCount);
-                ibuf->unlock();
+                if (!readBufferDataDirect(stream, *ibuf))
+                {
+                    unsigned short* pIdx = static_cast<unsigned short*>(
+                        ibuf->lock(HardwareBuffer::HBL_DISCARD)
+                        );
+                    readShorts(stream, pIdx, sm->indexData->indexCount);
+                    ibuf->unlock();
+                }
             }
         }
         sm->indexData->indexBuffer = ibuf;
@@ -1606,19 +1617,22 @@ namespace Ogre {
                 indexData->indexBuffer = HardwareBufferManager::getSingleton().
                     createIndexBuffer(idx32Bit ? HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT,
                     buffIndexCount, pMesh->mIndexBufferUsage, pMesh->mIndexBufferShadowBuffer);
-                void* pIdx = static_cast<unsigned int*>(indexData->indexBuffer->lock(
-                    0, indexData->indexBuffer->getSizeInBytes(), HardwareBuffer::HBL_DISCARD));
 
                 // unsigned short*/int* faceIndexes;  ((v1, v2, v3) * numFaces)
-                if (idx32Bit)
+                if (!readBufferDataDirect(stream, *indexData->indexBuffer))
                 {
-                    readInts(stream, (uint32*)pIdx, buffIndexCount);
-                }
-                else
-                {
-                    readShorts(stream, (uint16*)pIdx, buffIndexCount);
+                    void* pIdx = static_cast<unsigned int*>(indexData->indexBuffer->lock(
+                        0, indexData->indexBuffer->getSizeInBytes(), HardwareBuffer::HBL_DISCARD));
+                    if (idx32Bit)
+                    {
+                        readInts(stream, (uint32*)pIdx, buffIndexCount);
+                    }
+                    else
+                    {
+                        readShorts(stream, (uint16*)pIdx, buffIndexCount);
+                    }
+                    indexData->indexBuffer->unlock();
                 }
-                indexData->indexBuffer->unlock();
             }
         }
     }
@@ -1642,6 +1656,24 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    bool MeshSerializerImpl::readBufferDataDirect(DataStreamPtr& stream, HardwareBuffer& buffer)
+    {
+        // Data needing endian conversion is flipped in the locked buffer
+        if (mFlipEndian)
+            return false;
+
+        MemoryDataStream* memStream = dynamic_cast<MemoryDataStream*>(stream.get());
+        const size_t size = buffer.getSizeInBytes();
+        if (!memStream || memStream->size() - memStream->tell() < size)
+            return false;
+
+        // Upload from the stream memory, no intermediate copy
+        buffer.writeData(0, size, memStream->getCurrentPtr(), true);
+        memStream->skip(static_cast<long>(size));
+        ++mNumDirectBufferReads;
+        return true;
+    }
+    //---------------------------------------------------------------------
     void MeshSerializerImpl::flipEndian(void* pData, size_t vertexCount,
         size_t vertexSize, const VertexDeclaration::VertexElementList& elems)
     {
@@ -40,6 +40,7 @@ THE SOFTWARE.
 #include "OgreManualObject.h"
 #include "OgreNameGenerator.h"
 #include "OgreMesh.h"
+#include "OgreTransformStorage.h"
 
 namespace Ogre {
 
@@ -52,9 +53,12 @@ namespace Ogre {
         mNeedChildUpdate(false),
         mParentNotified(false),
         mQueuedForUpdate(false),
-        mOrientation(Quaternion::IDENTITY),
-        mPosition(Vector3::ZERO),
-        mScale(Vector3::UNIT_SCALE),
+        mOrientation(&mOwnOrientation),
+        mPosition(&mOwnPosition),
+        mScale(&mOwnScale),
+        mOwnOrientation(Quaternion::IDENTITY),
+        mOwnPosition(Vector3::ZERO),
+        mOwnScale(Vector3::UNIT_SCALE),
         mInheritOrientation(true),
         mInheritScale(true),
         mDerivedOrientation(Quaternion::IDENTITY),
@@ -65,7 +69,10 @@ namespace Ogre {
         mInitialScale(Vector3::UNIT_SCALE),
         mCachedTransformOutOfDate(true),
         mListener(0), 
-        mDebug(0)
+        mDebug(0),
+        mTransformStorage(0),
+        mTransformDepth(0),
+        mTransformIndex(0)
     {
         // Generate a name
         mName = msNameGenerator.generate();
@@ -82,9 +89,12 @@ namespace Ogre {
         mParentNotified(false),
         mQueuedForUpdate(false),
         mName(name),
-        mOrientation(Quaternion::IDENTITY),
-        mPosition(Vector3::ZERO),
-        mScale(Vector3::UNIT_SCALE),
+        mOrientation(&mOwnOrientation),
+        mPosition(&mOwnPosition),
+        mScale(&mOwnScale),
+        mOwnOrientation(Quaternion::IDENTITY),
+        mOwnPosition(Vector3::ZERO),
+        mOwnScale(Vector3::UNIT_SCALE),
         mInheritOrientation(true),
         mInheritScale(true),
         mDerivedOrientation(Quaternion::IDENTITY),
@@ -95,7 +105,10 @@ namespace Ogre {
         mInitialScale(Vector3::UNIT_SCALE),
         mCachedTransformOutOfDate(true),
         mListener(0), 
-        mDebug(0)
+        mDebug(0),
+        mTransformStorage(0),
+        mTransformDepth(0),
+        mTransformIndex(0)
 
     {
 
@@ -118,6 +131,8 @@ namespace Ogre {
         removeAllChildren();
         if(mParent)
             mParent->removeChild(this);
+        if (mTransformStorage)
+            mTransformStorage->_removeNode(this);
 
         if (mQueuedForUpdate)
         {
@@ -140,7 +155,14 @@ namespace Ogre {
     {
         bool different = (parent != mParent);
 
+        // Re-slot this subtree below the new parent
+        if (mTransformStorage)
+            mTransformStorage->_removeNode(this);
+
         mParent = parent;
+
+        if (mParent && mParent->mTransformStorage)
+            mParent->mTransformStorage->_addNode(this);
         // Request update from parent
         mParentNotified = false ;
         needUpdate();
@@ -163,7 +185,7 @@ namespace Ogre {
         {
 #if OGRE_NODE_INHERIT_TRANSFORM
             Ogre::Matrix4 tr;
-            tr.makeTransform(mPosition, mScale, mOrientation);
+            tr.makeTransform(*mPosition, *mScale, *mOrientation);
 
             if(mParent == NULL)
             {
@@ -256,6 +278,18 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Node::updateFromParentImpl(void) const
     {
+#if !OGRE_NODE_INHERIT_TRANSFORM
+        if (mTransformStorage && mTransformStorage->_isUpToDate())
+        {
+            // Already derived in bulk by the storage, just fetch it
+            mTransformStorage->_getDerivedTransform(this, mDerivedPosition,
+                mDerivedOrientation, mDerivedScale, mCachedTransform);
+            mCachedTransformOutOfDate = false;
+            mNeedParentUpdate = false;
+            return;
+        }
+#endif
+
         mCachedTransformOutOfDate = true;
 
         if (mParent)
@@ -269,12 +303,12 @@ namespace Ogre {
             if (mInheritOrientation)
             {
                 // Combine orientation with that of parent
-                mDerivedOrientation = parentOrientation * mOrientation;
+                mDerivedOrientation = parentOrientation * (*mOrientation);
             }
             else
             {
                 // No inheritance
-                mDerivedOrientation = mOrientation;
+                mDerivedOrientation = *mOrientation;
             }
 
             // Update scale
@@ -283,16 +317,16 @@ namespace Ogre {
             {
                 // Scale own position by parent scale, NB just combine
                 // as equivalent axes, no shearing
-                mDerivedScale = parentScale * mScale;
+                mDerivedScale = parentScale * (*mScale);
             }
             else
             {
                 // No inheritance
-                mDerivedScale = mScale;
+                mDerivedScale = *mScale;
             }
 
             // Change position vector based on parent's orientation & scale
-            mDerivedPosition = parentOrientation * (parentScale * mPosition);
+            mDerivedPosition = parentOrientation * (parentScale * (*mPosition));
 
             // Add altered position vector to parents
             mDerivedPosition += mParent->_getDerivedPosition();
@@ -301,9 +335,9 @@ namespace Ogre {
         else
         {
             // Root node, no parent
-            mDerivedOrientation = mOrientation;
-            mDerivedPosition = mPosition;
-            mDerivedScale = mScale;
+            mDerivedOrientation = *mOrientation;
+            mDerivedPosition = *mPosition;
+            mDerivedScale = *mScale;
         }
 
         mNeedParentUpdate = false;
@@ -403,8 +437,8 @@ namespace Ogre {
     void Node::setOrientation( const Quaternion & q )
     {
         OgreAssertDbg(!q.isNaN(), "Invalid orientation supplied as parameter");
-        mOrientation = q;
-        mOrientation.normalise();
+        *mOrientation = q;
+        mOrientation->normalise();
         needUpdate();
     }
     //-----------------------------------------------------------------------
@@ -415,7 +449,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Node::resetOrientation(void)
     {
-        mOrientation = Quaternion::IDENTITY;
+        *mOrientation = Quaternion::IDENTITY;
         needUpdate();
     }
 
@@ -423,7 +457,7 @@ namespace Ogre {
     void Node::setPosition(const Vector3& pos)
     {
         assert(!pos.isNaN() && "Invalid vector supplied as parameter");
-        mPosition = pos;
+        *mPosition = pos;
         needUpdate();
     }
 
@@ -442,9 +476,9 @@ namespace Ogre {
         Vector3 axisY = Vector3::UNIT_Y;
         Vector3 axisZ = Vector3::UNIT_Z;
 
-        axisX = mOrientation * axisX;
-        axisY = mOrientation * axisY;
-        axisZ = mOrientation * axisZ;
+        axisX = (*mOrientation) * axisX;
+        axisY = (*mOrientation) * axisY;
+        axisZ = (*mOrientation) * axisZ;
 
         return Matrix3(axisX.x, axisY.x, axisZ.x,
                        axisX.y, axisY.y, axisZ.y,
@@ -458,21 +492,21 @@ namespace Ogre {
         {
         case TS_LOCAL:
             // position is relative to parent so transform downwards
-            mPosition += mOrientation * d;
+            *mPosition += (*mOrientation) * d;
             break;
         case TS_WORLD:
             // position is relative to parent so transform upwards
             if (mParent)
             {
-                mPosition += mParent->convertWorldToLocalDirection(d, true);
+                *mPosition += mParent->convertWorldToLocalDirection(d, true);
             }
             else
             {
-                mPosition += d;
+                *mPosition += d;
             }
             break;
         case TS_PARENT:
-            mPosition += d;
+            *mPosition += d;
             break;
         }
         needUpdate();
@@ -527,21 +561,21 @@ namespace Ogre {
         {
         case TS_PARENT:
             // Rotations are normally relative to local axes, transform up
-            mOrientation = q * mOrientation;
+            *mOrientation = q * (*mOrientation);
             break;
         case TS_WORLD:
             // Rotations are normally relative to local axes, transform up
-            mOrientation = mOrientation * _getDerivedOrientation().Inverse()
+            *mOrientation = (*mOrientation) * _getDerivedOrientation().Inverse()
                 * q * _getDerivedOrientation();
             break;
         case TS_LOCAL:
             // Note the order of the mult, i.e. q comes after
-            mOrientation = mOrientation * q;
+            *mOrientation = (*mOrientation) * q;
             break;
         }
 
         // Normalise quaternion to avoid drift
-        mOrientation.normalise();
+        mOrientation->normalise();
 
         needUpdate();
     }
@@ -674,7 +708,7 @@ namespace Ogre {
     void Node::setScale(const Vector3& inScale)
     {
         assert(!inScale.isNaN() && "Invalid vector supplied as parameter");
-        mScale = inScale;
+        *mScale = inScale;
         needUpdate();
     }
     //-----------------------------------------------------------------------
@@ -698,32 +732,32 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Node::scale(const Vector3& inScale)
     {
-        mScale = mScale * inScale;
+        *mScale = (*mScale) * inScale;
         needUpdate();
 
     }
     //-----------------------------------------------------------------------
     void Node::scale(Real x, Real y, Real z)
     {
-        mScale.x *= x;
-        mScale.y *= y;
-        mScale.z *= z;
+        mScale->x *= x;
+        mScale->y *= y;
+        mScale->z *= z;
         needUpdate();
 
     }
     //-----------------------------------------------------------------------
     void Node::setInitialState(void)
     {
-        mInitialPosition = mPosition;
-        mInitialOrientation = mOrientation;
-        mInitialScale = mScale;
+        mInitialPosition = *mPosition;
+        mInitialOrientation = *mOrientation;
+        mInitialScale = *mScale;
     }
     //-----------------------------------------------------------------------
     void Node::resetToInitialState(void)
     {
-        mPosition = mInitialPosition;
-        mOrientation = mInitialOrientation;
-        mScale = mInitialScale;
+        *mPosition = mInitialPosition;
+        *mOrientation = mInitialOrientation;
+        *mScale = mInitialScale;
 
         needUpdate();
     }
@@ -788,6 +822,9 @@ namespace Ogre {
         mNeedChildUpdate = true;
         mCachedTransformOutOfDate = true;
 
+        if (mTransformStorage)
+            mTransformStorage->_notifyLocalChanged(this);
+
         // Make sure we're not root and parent hasn't been notified before
         if (mParent && (!mParentNotified || forceParentUpdate))
         {
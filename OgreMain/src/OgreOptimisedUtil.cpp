@@ -43,6 +43,8 @@ namespace Ogre {
     extern OptimisedUtil* _getOptimisedUtilGeneral(void);
 #if __OGRE_HAVE_SSE
     extern OptimisedUtil* _getOptimisedUtilSSE(void);
+    // Returns NULL if the compiler can't generate AVX2 code
+    extern OptimisedUtil* _getOptimisedUtilAVX(void);
 //#elif __OGRE_HAVE_NEON
 //    extern OptimisedUtil* _getOptimisedUtilNEON(void);
 //#elif __OGRE_HAVE_VFP
@@ -52,6 +54,16 @@ namespace Ogre {
     extern OptimisedUtil* _getOptimisedUtilDirectXMath(void);
 #endif
 
+#if __OGRE_HAVE_SSE
+    //---------------------------------------------------------------------
+    static bool _hasAVX2(void)
+    {
+        const uint avx2Features =
+            PlatformInformation::CPU_FEATURE_AVX2 | PlatformInformation::CPU_FEATURE_FMA;
+        return (PlatformInformation::getCpuFeatures() & avx2Features) == avx2Features;
+    }
+#endif
+
 #ifdef __DO_PROFILE__
     //---------------------------------------------------------------------
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
@@ -86,6 +98,7 @@ namespace Ogre {
             IMPL_DEFAULT,
 #if __OGRE_HAVE_SSE
             IMPL_SSE,
+            IMPL_AVX,
 //#elif __OGRE_HAVE_NEON
 //            IMPL_NEON,
 //#elif __OGRE_HAVE_VFP
@@ -137,6 +150,10 @@ namespace Ogre {
             {
                 mOptimisedUtils.push_back(_getOptimisedUtilSSE());
             }
+            if (_hasAVX2() && _getOptimisedUtilAVX())
+            {
+                mOptimisedUtils.push_back(_getOptimisedUtilAVX());
+            }
 //#elif __OGRE_HAVE_VFP
 //            if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_VFP)
 //            {
@@ -348,6 +365,32 @@ namespace Ogre {
             ++index;    // So we can put break point here even if in release build
         }
 
+        virtual size_t cullAxisAlignedBoxes(
+            const Plane* planes, size_t numPlanes,
+            const Real* boxes, size_t boxStride,
+            unsigned char* visibility,
+            size_t numBoxes)
+        {
+            static ProfileItems results;
+            static size_t index;
+            index = Root::getSingleton().getNextFrameNumber() % mOptimisedUtils.size();
+            OptimisedUtil* impl = mOptimisedUtils[index];
+            ProfileItem& profile = results[index];
+
+            profile.begin();
+            size_t numVisible = impl->cullAxisAlignedBoxes(
+                planes, numPlanes,
+                boxes, boxStride,
+                visibility,
+                numBoxes);
+            profile.end();
+
+            // You can put break point here while running test application, to
+            // watch profile results.
+            ++index;    // So we can put break point here even if in release build
+            return numVisible;
+        }
+
     };
 #endif // __DO_PROFILE__
 
@@ -402,7 +445,11 @@ namespace Ogre {
 #else   // !__DO_PROFILE__
 
 #if __OGRE_HAVE_SSE
-        if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE)
+        if (_hasAVX2() && _getOptimisedUtilAVX())
+        {
+            return _getOptimisedUtilAVX();
+        }
+        else if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE)
         {
             return _getOptimisedUtilSSE();
         }
@@ -430,5 +477,27 @@ namespace Ogre {
 
 #endif  // __DO_PROFILE__
     }
+    //---------------------------------------------------------------------
+    OptimisedUtil* OptimisedUtil::_getImplementation(ImplementationType type)
+    {
+        switch (type)
+        {
+        case IMPL_GENERAL:
+            return _getOptimisedUtilGeneral();
+#if __OGRE_HAVE_SSE
+        case IMPL_SSE:
+            if (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE)
+                return _getOptimisedUtilSSE();
+            break;
+        case IMPL_AVX2:
+            if (_hasAVX2())
+                return _getOptimisedUtilAVX();
+            break;
+#endif
+        default:
+            break;
+        }
+        return 0;
+    }
 
 }
@@ -0,0 +1,653 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+
+#include "OgreOptimisedUtil.h"
+#include "OgrePlatformInformation.h"
+
+// Only the kernels below are compiled for AVX2 and FMA, through a target
+// attribute, so nothing else in this file (in particular inline functions
+// of the Ogre headers, which may be shared with other translation units)
+// is built for an instruction set the CPU may not have. The backend is only
+// picked at run time if the CPU supports it. MSVC accepts the intrinsics
+// without any flags.
+#if __OGRE_HAVE_SSE && OGRE_COMPILER == OGRE_COMPILER_MSVC && OGRE_COMP_VER >= 1800 && OGRE_ARCH_TYPE == OGRE_ARCHITECTURE_64
+#   define __OGRE_HAVE_AVX2 1
+#   define OGRE_AVX2_TARGET
+#elif __OGRE_HAVE_SSE && ((OGRE_COMPILER == OGRE_COMPILER_GNUC && OGRE_COMP_VER >= 490) || \
+    (OGRE_COMPILER == OGRE_COMPILER_CLANG && OGRE_COMP_VER >= 380))
+#   define __OGRE_HAVE_AVX2 1
+#   define OGRE_AVX2_TARGET __attribute__((target("avx2,fma")))
+#else
+#   define __OGRE_HAVE_AVX2 0
+#endif
+
+#if __OGRE_HAVE_AVX2
+
+#include "OgreMatrix4.h"
+#include "OgrePlane.h"
+
+#include <immintrin.h>
+
+namespace Ogre {
+
+    extern OptimisedUtil* _getOptimisedUtilGeneral(void);
+
+//-------------------------------------------------------------------------
+// Local classes
+//-------------------------------------------------------------------------
+
+    /** AVX2/FMA implementation of OptimisedUtil.
+    @remarks
+        All kernels work on eight vertices, triangles or matrices rows per
+        iteration, in structure-of-arrays form where the data is interleaved.
+        Remaining elements are processed by the general implementation.
+    @note
+        Don't use this class directly, use OptimisedUtil instead.
+    */
+    class _OgrePrivate OptimisedUtilAVX : public OptimisedUtil
+    {
+    public:
+        /// @copydoc OptimisedUtil::softwareVertexSkinning
+        virtual void softwareVertexSkinning(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const Matrix4* const* blendMatrices,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices);
+
+        /// @copydoc OptimisedUtil::softwareVertexMorph
+        virtual void softwareVertexMorph(
+            Real t,
+            const float *srcPos1, const float *srcPos2,
+            float *dstPos,
+            size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+            size_t numVertices,
+            bool morphNormals);
+
+        /// @copydoc OptimisedUtil::concatenateAffineMatrices
+        virtual void concatenateAffineMatrices(
+            const Matrix4& baseMatrix,
+            const Matrix4* srcMatrices,
+            Matrix4* dstMatrices,
+            size_t numMatrices);
+
+        /// @copydoc OptimisedUtil::calculateFaceNormals
+        virtual void calculateFaceNormals(
+            const float *positions,
+            const EdgeData::Triangle *triangles,
+            Vector4 *faceNormals,
+            size_t numTriangles);
+
+        /// @copydoc OptimisedUtil::calculateLightFacing
+        virtual void calculateLightFacing(
+            const Vector4& lightPos,
+            const Vector4* faceNormals,
+            char* lightFacings,
+            size_t numFaces);
+
+        /// @copydoc OptimisedUtil::extrudeVertices
+        virtual void extrudeVertices(
+            const Vector4& lightPos,
+            Real extrudeDist,
+            const float* srcPositions,
+            float* destPositions,
+            size_t numVertices);
+
+        /// @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        virtual size_t cullAxisAlignedBoxes(
+            const Plane* planes, size_t numPlanes,
+            const Real* boxes, size_t boxStride,
+            unsigned char* visibility,
+            size_t numBoxes);
+    };
+
+//---------------------------------------------------------------------
+// Some useful helpers for structure-of-arrays processing.
+//---------------------------------------------------------------------
+
+    /// Byte offsets of eight consecutive elements of the given stride
+    static OGRE_AVX2_TARGET OGRE_FORCE_INLINE __m256i _strideOffsets(size_t stride)
+    {
+        assert(stride * 7 <= 0x7fffffff);
+        return _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+            _mm256_set1_epi32((int)stride));
+    }
+
+    /// Loads eight xyz vectors found at the given byte offsets
+    static OGRE_AVX2_TARGET OGRE_FORCE_INLINE void _gatherVector3(const float* p, __m256i offsets,
+        __m256& x, __m256& y, __m256& z)
+    {
+        x = _mm256_i32gather_ps(p, offsets, 1);
+        y = _mm256_i32gather_ps(p + 1, offsets, 1);
+        z = _mm256_i32gather_ps(p + 2, offsets, 1);
+    }
+
+    /// Stores eight xyz vectors with the given stride in bytes
+    static OGRE_AVX2_TARGET OGRE_FORCE_INLINE void _scatterVector3(float* p, size_t stride,
+        __m256 x, __m256 y, __m256 z)
+    {
+        float xs[8], ys[8], zs[8];
+        _mm256_storeu_ps(xs, x);
+        _mm256_storeu_ps(ys, y);
+        _mm256_storeu_ps(zs, z);
+        for (size_t i = 0; i < 8; ++i)
+        {
+            p[0] = xs[i];
+            p[1] = ys[i];
+            p[2] = zs[i];
+            advanceRawPointer(p, stride);
+        }
+    }
+
+    /// Normalises eight vectors, leaving zero length ones unchanged as Vector3::normalise
+    static OGRE_AVX2_TARGET OGRE_FORCE_INLINE void _normaliseVector3(__m256& x, __m256& y, __m256& z)
+    {
+        const __m256 one = _mm256_set1_ps(1.0f);
+        __m256 length = _mm256_sqrt_ps(
+            _mm256_fmadd_ps(x, x, _mm256_fmadd_ps(y, y, _mm256_mul_ps(z, z))));
+        __m256 invLength = _mm256_blendv_ps(one, _mm256_div_ps(one, length),
+            _mm256_cmp_ps(length, _mm256_setzero_ps(), _CMP_GT_OQ));
+        x = _mm256_mul_ps(x, invLength);
+        y = _mm256_mul_ps(y, invLength);
+        z = _mm256_mul_ps(z, invLength);
+    }
+
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET void OptimisedUtilAVX::softwareVertexSkinning(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Matrix4* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        const __m256i srcPosOffsets = _strideOffsets(srcPosStride);
+        const __m256i srcNormOffsets = _strideOffsets(srcNormStride);
+        // Rows of the collapsed matrices are 12 floats apart
+        const __m256i matrixIndices = _mm256_mullo_epi32(
+            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(12));
+
+        for ( ; numVertices >= 8; numVertices -= 8)
+        {
+            // Collapse the weighted blend matrices of each vertex into a
+            // single 3x4 matrix, rows 0 and 1 are one 256-bit register
+            float collapsed[8][12];
+            for (size_t i = 0; i < 8; ++i)
+            {
+                __m256 row01 = _mm256_setzero_ps();
+                __m128 row2 = _mm_setzero_ps();
+                for (size_t blendIdx = 0; blendIdx < numWeightsPerVertex; ++blendIdx)
+                {
+                    float weight = pBlendWeight[blendIdx];
+                    if (weight)
+                    {
+                        const Matrix4& mat = *blendMatrices[pBlendIndex[blendIdx]];
+                        row01 = _mm256_fmadd_ps(_mm256_set1_ps(weight), _mm256_loadu_ps(mat[0]), row01);
+                        row2 = _mm_fmadd_ps(_mm_set1_ps(weight), _mm_loadu_ps(mat[2]), row2);
+                    }
+                }
+                _mm256_storeu_ps(collapsed[i], row01);
+                _mm_storeu_ps(collapsed[i] + 8, row2);
+
+                advanceRawPointer(pBlendWeight, blendWeightStride);
+                advanceRawPointer(pBlendIndex, blendIndexStride);
+            }
+
+            // Transpose to one register per matrix element
+            __m256 m[12];
+            for (int e = 0; e < 12; ++e)
+                m[e] = _mm256_i32gather_ps(&collapsed[0][e], matrixIndices, 4);
+
+            __m256 x, y, z;
+            _gatherVector3(pSrcPos, srcPosOffsets, x, y, z);
+            _scatterVector3(pDestPos, destPosStride,
+                _mm256_fmadd_ps(m[0], x, _mm256_fmadd_ps(m[1], y, _mm256_fmadd_ps(m[2], z, m[3]))),
+                _mm256_fmadd_ps(m[4], x, _mm256_fmadd_ps(m[5], y, _mm256_fmadd_ps(m[6], z, m[7]))),
+                _mm256_fmadd_ps(m[8], x, _mm256_fmadd_ps(m[9], y, _mm256_fmadd_ps(m[10], z, m[11]))));
+            advanceRawPointer(pSrcPos, 8 * srcPosStride);
+            advanceRawPointer(pDestPos, 8 * destPosStride);
+
+            if (pSrcNorm)
+            {
+                // Rotational part only, see the general implementation
+                _gatherVector3(pSrcNorm, srcNormOffsets, x, y, z);
+                __m256 nx = _mm256_fmadd_ps(m[0], x, _mm256_fmadd_ps(m[1], y, _mm256_mul_ps(m[2], z)));
+                __m256 ny = _mm256_fmadd_ps(m[4], x, _mm256_fmadd_ps(m[5], y, _mm256_mul_ps(m[6], z)));
+                __m256 nz = _mm256_fmadd_ps(m[8], x, _mm256_fmadd_ps(m[9], y, _mm256_mul_ps(m[10], z)));
+                _normaliseVector3(nx, ny, nz);
+                _scatterVector3(pDestNorm, destNormStride, nx, ny, nz);
+                advanceRawPointer(pSrcNorm, 8 * srcNormStride);
+                advanceRawPointer(pDestNorm, 8 * destNormStride);
+            }
+        }
+
+        if (numVertices)
+        {
+            _getOptimisedUtilGeneral()->softwareVertexSkinning(
+                pSrcPos, pDestPos,
+                pSrcNorm, pDestNorm,
+                pBlendWeight, pBlendIndex,
+                blendMatrices,
+                srcPosStride, destPosStride,
+                srcNormStride, destNormStride,
+                blendWeightStride, blendIndexStride,
+                numWeightsPerVertex,
+                numVertices);
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET void OptimisedUtilAVX::softwareVertexMorph(
+        Real t,
+        const float *pSrc1, const float *pSrc2,
+        float *pDst,
+        size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+        size_t numVertices,
+        bool morphNormals)
+    {
+        const __m256 t8 = _mm256_set1_ps(t);
+
+        if (!morphNormals && pos1VSize == 12 && pos2VSize == 12 && dstVSize == 12)
+        {
+            // Packed positions, interpolate as a flat array
+            size_t numFloats = numVertices * 3;
+            size_t i = 0;
+            for ( ; i + 8 <= numFloats; i += 8)
+            {
+                __m256 src1 = _mm256_loadu_ps(pSrc1 + i);
+                __m256 src2 = _mm256_loadu_ps(pSrc2 + i);
+                _mm256_storeu_ps(pDst + i, _mm256_fmadd_ps(t8, _mm256_sub_ps(src2, src1), src1));
+            }
+            for ( ; i < numFloats; ++i)
+            {
+                pDst[i] = pSrc1[i] + t * (pSrc2[i] - pSrc1[i]);
+            }
+            return;
+        }
+
+        const __m256i src1Offsets = _strideOffsets(pos1VSize);
+        const __m256i src2Offsets = _strideOffsets(pos2VSize);
+
+        for ( ; numVertices >= 8; numVertices -= 8)
+        {
+            __m256 x1, y1, z1, x2, y2, z2;
+            _gatherVector3(pSrc1, src1Offsets, x1, y1, z1);
+            _gatherVector3(pSrc2, src2Offsets, x2, y2, z2);
+            _scatterVector3(pDst, dstVSize,
+                _mm256_fmadd_ps(t8, _mm256_sub_ps(x2, x1), x1),
+                _mm256_fmadd_ps(t8, _mm256_sub_ps(y2, y1), y1),
+                _mm256_fmadd_ps(t8, _mm256_sub_ps(z2, z1), z1));
+
+            if (morphNormals)
+            {
+                // Normals follow the positions in the same buffer, nlerp them
+                _gatherVector3(pSrc1 + 3, src1Offsets, x1, y1, z1);
+                _gatherVector3(pSrc2 + 3, src2Offsets, x2, y2, z2);
+                __m256 nx = _mm256_fmadd_ps(t8, _mm256_sub_ps(x2, x1), x1);
+                __m256 ny = _mm256_fmadd_ps(t8, _mm256_sub_ps(y2, y1), y1);
+                __m256 nz = _mm256_fmadd_ps(t8, _mm256_sub_ps(z2, z1), z1);
+                _normaliseVector3(nx, ny, nz);
+                _scatterVector3(pDst + 3, dstVSize, nx, ny, nz);
+            }
+
+            advanceRawPointer(pSrc1, 8 * pos1VSize);
+            advanceRawPointer(pSrc2, 8 * pos2VSize);
+            advanceRawPointer(pDst, 8 * dstVSize);
+        }
+
+        if (numVertices)
+        {
+            _getOptimisedUtilGeneral()->softwareVertexMorph(
+                t, pSrc1, pSrc2, pDst,
+                pos1VSize, pos2VSize, dstVSize,
+                numVertices, morphNormals);
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET void OptimisedUtilAVX::concatenateAffineMatrices(
+        const Matrix4& baseMatrix,
+        const Matrix4* pSrcMat,
+        Matrix4* pDstMat,
+        size_t numMatrices)
+    {
+        const Matrix4& m = baseMatrix;
+
+        // Rows 0 and 1 of the result are computed together, each half of
+        // these registers holding the coefficients of one base matrix row
+        const __m256 m01c0 = _mm256_setr_ps(
+            m[0][0], m[0][0], m[0][0], m[0][0], m[1][0], m[1][0], m[1][0], m[1][0]);
+        const __m256 m01c1 = _mm256_setr_ps(
+            m[0][1], m[0][1], m[0][1], m[0][1], m[1][1], m[1][1], m[1][1], m[1][1]);
+        const __m256 m01c2 = _mm256_setr_ps(
+            m[0][2], m[0][2], m[0][2], m[0][2], m[1][2], m[1][2], m[1][2], m[1][2]);
+        const __m256 m01c3 = _mm256_setr_ps(0, 0, 0, m[0][3], 0, 0, 0, m[1][3]);
+        const __m128 m2c0 = _mm_set1_ps(m[2][0]);
+        const __m128 m2c1 = _mm_set1_ps(m[2][1]);
+        const __m128 m2c2 = _mm_set1_ps(m[2][2]);
+        const __m128 m2c3 = _mm_setr_ps(0, 0, 0, m[2][3]);
+        const __m128 row3 = _mm_setr_ps(0, 0, 0, 1);
+
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            const Matrix4& s = *pSrcMat;
+            Matrix4& d = *pDstMat;
+
+            __m256 s0 = _mm256_broadcast_ps((const __m128*)s[0]);
+            __m256 s1 = _mm256_broadcast_ps((const __m128*)s[1]);
+            __m256 s2 = _mm256_broadcast_ps((const __m128*)s[2]);
+
+            __m256 d01 = _mm256_fmadd_ps(m01c0, s0,
+                _mm256_fmadd_ps(m01c1, s1, _mm256_fmadd_ps(m01c2, s2, m01c3)));
+            __m128 d2 = _mm_fmadd_ps(m2c0, _mm256_castps256_ps128(s0),
+                _mm_fmadd_ps(m2c1, _mm256_castps256_ps128(s1),
+                _mm_fmadd_ps(m2c2, _mm256_castps256_ps128(s2), m2c3)));
+
+            _mm256_storeu_ps(d[0], d01);
+            _mm_storeu_ps(d[2], d2);
+            _mm_storeu_ps(d[3], row3);
+
+            ++pSrcMat;
+            ++pDstMat;
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET void OptimisedUtilAVX::calculateFaceNormals(
+        const float *positions,
+        const EdgeData::Triangle *triangles,
+        Vector4 *faceNormals,
+        size_t numTriangles)
+    {
+        for ( ; numTriangles >= 8; numTriangles -= 8)
+        {
+            const EdgeData::Triangle* t = triangles;
+            __m256i offsets[3];
+            for (int v = 0; v < 3; ++v)
+            {
+                offsets[v] = _mm256_setr_epi32(
+                    (int)t[0].vertIndex[v], (int)t[1].vertIndex[v],
+                    (int)t[2].vertIndex[v], (int)t[3].vertIndex[v],
+                    (int)t[4].vertIndex[v], (int)t[5].vertIndex[v],
+                    (int)t[6].vertIndex[v], (int)t[7].vertIndex[v]);
+                // Positions are packed, three floats per vertex
+                offsets[v] = _mm256_mullo_epi32(offsets[v], _mm256_set1_epi32(3));
+            }
+
+            __m256 x1 = _mm256_i32gather_ps(positions + 0, offsets[0], 4);
+            __m256 y1 = _mm256_i32gather_ps(positions + 1, offsets[0], 4);
+            __m256 z1 = _mm256_i32gather_ps(positions + 2, offsets[0], 4);
+            __m256 x2 = _mm256_i32gather_ps(positions + 0, offsets[1], 4);
+            __m256 y2 = _mm256_i32gather_ps(positions + 1, offsets[1], 4);
+            __m256 z2 = _mm256_i32gather_ps(positions + 2, offsets[1], 4);
+            __m256 x3 = _mm256_i32gather_ps(positions + 0, offsets[2], 4);
+            __m256 y3 = _mm256_i32gather_ps(positions + 1, offsets[2], 4);
+            __m256 z3 = _mm256_i32gather_ps(positions + 2, offsets[2], 4);
+
+            // normal = (v2 - v1) x (v3 - v1), as Math::calculateFaceNormalWithoutNormalize
+            __m256 ax = _mm256_sub_ps(x2, x1), ay = _mm256_sub_ps(y2, y1), az = _mm256_sub_ps(z2, z1);
+            __m256 bx = _mm256_sub_ps(x3, x1), by = _mm256_sub_ps(y3, y1), bz = _mm256_sub_ps(z3, z1);
+            __m256 nx = _mm256_fmsub_ps(ay, bz, _mm256_mul_ps(az, by));
+            __m256 ny = _mm256_fmsub_ps(az, bx, _mm256_mul_ps(ax, bz));
+            __m256 nz = _mm256_fmsub_ps(ax, by, _mm256_mul_ps(ay, bx));
+            // w = -(normal . v1)
+            __m256 nw = _mm256_fnmsub_ps(nx, x1,
+                _mm256_fmadd_ps(ny, y1, _mm256_mul_ps(nz, z1)));
+
+            // Transpose back to eight Vector4
+            __m256 t0 = _mm256_unpacklo_ps(nx, ny);
+            __m256 t1 = _mm256_unpackhi_ps(nx, ny);
+            __m256 t2 = _mm256_unpacklo_ps(nz, nw);
+            __m256 t3 = _mm256_unpackhi_ps(nz, nw);
+            __m256 n04 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 n15 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 n26 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 n37 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+
+            float* pDst = faceNormals[0].ptr();
+            _mm256_storeu_ps(pDst + 0, _mm256_permute2f128_ps(n04, n15, 0x20));
+            _mm256_storeu_ps(pDst + 8, _mm256_permute2f128_ps(n26, n37, 0x20));
+            _mm256_storeu_ps(pDst + 16, _mm256_permute2f128_ps(n04, n15, 0x31));
+            _mm256_storeu_ps(pDst + 24, _mm256_permute2f128_ps(n26, n37, 0x31));
+
+            triangles += 8;
+            faceNormals += 8;
+        }
+
+        if (numTriangles)
+        {
+            _getOptimisedUtilGeneral()->calculateFaceNormals(
+                positions, triangles, faceNormals, numTriangles);
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET void OptimisedUtilAVX::calculateLightFacing(
+        const Vector4& lightPos,
+        const Vector4* faceNormals,
+        char* lightFacings,
+        size_t numFaces)
+    {
+        const __m256 light = _mm256_broadcast_ps((const __m128*)lightPos.ptr());
+        // Undoes the lane interleaving of the horizontal adds below
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+        for ( ; numFaces >= 8; numFaces -= 8)
+        {
+            const float* pSrc = faceNormals[0].ptr();
+            __m256 p01 = _mm256_mul_ps(light, _mm256_loadu_ps(pSrc + 0));
+            __m256 p23 = _mm256_mul_ps(light, _mm256_loadu_ps(pSrc + 8));
+            __m256 p45 = _mm256_mul_ps(light, _mm256_loadu_ps(pSrc + 16));
+            __m256 p67 = _mm256_mul_ps(light, _mm256_loadu_ps(pSrc + 24));
+
+            // Lanes hold the dot products of faces 0 2 4 6 | 1 3 5 7
+            __m256 dots = _mm256_hadd_ps(_mm256_hadd_ps(p01, p23), _mm256_hadd_ps(p45, p67));
+            dots = _mm256_permutevar8x32_ps(dots, order);
+
+            int mask = _mm256_movemask_ps(_mm256_cmp_ps(dots, _mm256_setzero_ps(), _CMP_GT_OQ));
+            for (int i = 0; i < 8; ++i)
+            {
+                lightFacings[i] = (char)((mask >> i) & 1);
+            }
+
+            faceNormals += 8;
+            lightFacings += 8;
+        }
+
+        if (numFaces)
+        {
+            _getOptimisedUtilGeneral()->calculateLightFacing(
+                lightPos, faceNormals, lightFacings, numFaces);
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET void OptimisedUtilAVX::extrudeVertices(
+        const Vector4& lightPos,
+        Real extrudeDist,
+        const float* pSrcPos,
+        float* pDestPos,
+        size_t numVertices)
+    {
+        if (lightPos.w == 0.0f)
+        {
+            // Directional light, the same offset for every vertex
+            Vector3 extrusionDir(
+                -lightPos.x,
+                -lightPos.y,
+                -lightPos.z);
+            extrusionDir.normalise();
+            extrusionDir *= extrudeDist;
+            const float dx = extrusionDir.x, dy = extrusionDir.y, dz = extrusionDir.z;
+
+            // Eight packed vertices are three registers, the xyz pattern
+            // starts at a different component in each of them
+            const __m256 dir0 = _mm256_setr_ps(dx, dy, dz, dx, dy, dz, dx, dy);
+            const __m256 dir1 = _mm256_setr_ps(dz, dx, dy, dz, dx, dy, dz, dx);
+            const __m256 dir2 = _mm256_setr_ps(dy, dz, dx, dy, dz, dx, dy, dz);
+
+            for ( ; numVertices >= 8; numVertices -= 8)
+            {
+                _mm256_storeu_ps(pDestPos + 0, _mm256_add_ps(_mm256_loadu_ps(pSrcPos + 0), dir0));
+                _mm256_storeu_ps(pDestPos + 8, _mm256_add_ps(_mm256_loadu_ps(pSrcPos + 8), dir1));
+                _mm256_storeu_ps(pDestPos + 16, _mm256_add_ps(_mm256_loadu_ps(pSrcPos + 16), dir2));
+                pSrcPos += 24;
+                pDestPos += 24;
+            }
+
+            for ( ; numVertices; --numVertices)
+            {
+                *pDestPos++ = *pSrcPos++ + dx;
+                *pDestPos++ = *pSrcPos++ + dy;
+                *pDestPos++ = *pSrcPos++ + dz;
+            }
+        }
+        else
+        {
+            // Point light, calculate extrusionDir for every vertex
+            assert(lightPos.w == 1.0f);
+
+            const __m256i offsets = _strideOffsets(3 * sizeof(float));
+            const __m256 lx = _mm256_set1_ps(lightPos.x);
+            const __m256 ly = _mm256_set1_ps(lightPos.y);
+            const __m256 lz = _mm256_set1_ps(lightPos.z);
+            const __m256 dist = _mm256_set1_ps(extrudeDist);
+
+            for ( ; numVertices >= 8; numVertices -= 8)
+            {
+                __m256 x, y, z;
+                _gatherVector3(pSrcPos, offsets, x, y, z);
+                __m256 dx = _mm256_sub_ps(x, lx);
+                __m256 dy = _mm256_sub_ps(y, ly);
+                __m256 dz = _mm256_sub_ps(z, lz);
+                _normaliseVector3(dx, dy, dz);
+                _scatterVector3(pDestPos, 3 * sizeof(float),
+                    _mm256_fmadd_ps(dx, dist, x),
+                    _mm256_fmadd_ps(dy, dist, y),
+                    _mm256_fmadd_ps(dz, dist, z));
+                pSrcPos += 24;
+                pDestPos += 24;
+            }
+
+            if (numVertices)
+            {
+                _getOptimisedUtilGeneral()->extrudeVertices(
+                    lightPos, extrudeDist, pSrcPos, pDestPos, numVertices);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    OGRE_AVX2_TARGET size_t OptimisedUtilAVX::cullAxisAlignedBoxes(
+        const Plane* planes, size_t numPlanes,
+        const Real* boxes, size_t boxStride,
+        unsigned char* visibility,
+        size_t numBoxes)
+    {
+        const float* centreX = boxes;
+        const float* centreY = centreX + boxStride;
+        const float* centreZ = centreY + boxStride;
+        const float* halfX = centreZ + boxStride;
+        const float* halfY = halfX + boxStride;
+        const float* halfZ = halfY + boxStride;
+
+        // Sign bit only, cleared with andnot for absolute values
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+        size_t numVisible = 0;
+        size_t i = 0;
+        for ( ; numBoxes - i >= 8; i += 8)
+        {
+            __m256 cx = _mm256_loadu_ps(centreX + i);
+            __m256 cy = _mm256_loadu_ps(centreY + i);
+            __m256 cz = _mm256_loadu_ps(centreZ + i);
+            __m256 hx = _mm256_loadu_ps(halfX + i);
+            __m256 hy = _mm256_loadu_ps(halfY + i);
+            __m256 hz = _mm256_loadu_ps(halfZ + i);
+
+            int visibleMask = 0xff;
+            for (size_t p = 0; p < numPlanes && visibleMask; ++p)
+            {
+                const Plane& plane = planes[p];
+                __m256 nx = _mm256_set1_ps(plane.normal.x);
+                __m256 ny = _mm256_set1_ps(plane.normal.y);
+                __m256 nz = _mm256_set1_ps(plane.normal.z);
+
+                // Same test as Plane::getSide
+                __m256 dist = _mm256_fmadd_ps(nx, cx, _mm256_fmadd_ps(ny, cy,
+                    _mm256_fmadd_ps(nz, cz, _mm256_set1_ps(plane.d))));
+                __m256 maxAbsDist = _mm256_add_ps(_mm256_add_ps(
+                    _mm256_andnot_ps(signMask, _mm256_mul_ps(nx, hx)),
+                    _mm256_andnot_ps(signMask, _mm256_mul_ps(ny, hy))),
+                    _mm256_andnot_ps(signMask, _mm256_mul_ps(nz, hz)));
+                __m256 outside = _mm256_cmp_ps(dist, _mm256_xor_ps(maxAbsDist, signMask), _CMP_LT_OQ);
+                visibleMask &= ~_mm256_movemask_ps(outside);
+            }
+
+            for (size_t j = 0; j < 8; ++j)
+            {
+                unsigned char visible = (visibleMask >> j) & 1;
+                visibility[i + j] = visible;
+                numVisible += visible;
+            }
+        }
+
+        if (i < numBoxes)
+        {
+            numVisible += _getOptimisedUtilGeneral()->cullAxisAlignedBoxes(
+                planes, numPlanes, boxes + i, boxStride, visibility + i, numBoxes - i);
+        }
+
+        return numVisible;
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    extern OptimisedUtil* _getOptimisedUtilAVX(void)
+    {
+        static OptimisedUtilAVX msOptimisedUtilAVX;
+        return &msOptimisedUtilAVX;
+    }
+
+}
+
+#else // !__OGRE_HAVE_AVX2
+
+namespace Ogre {
+
+    extern OptimisedUtil* _getOptimisedUtilAVX(void)
+    {
+        // Not built with AVX2 code generation
+        return 0;
+    }
+
+}
+
+#endif // __OGRE_HAVE_AVX2
@@ -31,6 +31,7 @@ THE SOFTWARE.
 
 #include "OgreVector3.h"
 #include "OgreMatrix4.h"
+#include "OgrePlane.h"
 
 namespace Ogre {
 
@@ -94,6 +95,12 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+        /// @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        virtual size_t cullAxisAlignedBoxes(
+            const Plane* planes, size_t numPlanes,
+            const Real* boxes, size_t boxStride,
+            unsigned char* visibility,
+            size_t numBoxes);
     };
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
@@ -392,6 +399,41 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    size_t OptimisedUtilGeneral::cullAxisAlignedBoxes(
+        const Plane* planes, size_t numPlanes,
+        const Real* boxes, size_t boxStride,
+        unsigned char* visibility,
+        size_t numBoxes)
+    {
+        const Real* centreX = boxes;
+        const Real* centreY = centreX + boxStride;
+        const Real* centreZ = centreY + boxStride;
+        const Real* halfX = centreZ + boxStride;
+        const Real* halfY = halfX + boxStride;
+        const Real* halfZ = halfY + boxStride;
+
+        size_t numVisible = 0;
+        for (size_t i = 0; i < numBoxes; ++i)
+        {
+            Vector3 centre(centreX[i], centreY[i], centreZ[i]);
+            Vector3 halfSize(halfX[i], halfY[i], halfZ[i]);
+
+            unsigned char visible = 1;
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                if (planes[p].getSide(centre, halfSize) == Plane::NEGATIVE_SIDE)
+                {
+                    visible = 0;
+                    break;
+                }
+            }
+            visibility[i] = visible;
+            numVisible += visible;
+        }
+
+        return numVisible;
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilGeneral(void)
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #if __OGRE_HAVE_SSE
 
 #include "OgreMatrix4.h"
+#include "OgrePlane.h"
 
 // Should keep this includes at latest to avoid potential "xmmintrin.h" included by
 // other header file on some platform for some reason.
@@ -132,6 +133,12 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices);
+        /// @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        virtual size_t __OGRE_SIMD_ALIGN_ATTRIBUTE cullAxisAlignedBoxes(
+            const Plane* planes, size_t numPlanes,
+            const Real* boxes, size_t boxStride,
+            unsigned char* visibility,
+            size_t numBoxes);
     };
 
 #if defined(__OGRE_SIMD_ALIGN_STACK)
@@ -271,6 +278,22 @@ namespace Ogre {
                 destPositions,
                 numVertices);
         }
+
+        /// @copydoc OptimisedUtil::cullAxisAlignedBoxes
+        virtual size_t cullAxisAlignedBoxes(
+            const Plane* planes, size_t numPlanes,
+            const Real* boxes, size_t boxStride,
+            unsigned char* visibility,
+            size_t numBoxes)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            return mImpl->cullAxisAlignedBoxes(
+                planes, numPlanes,
+                boxes, boxStride,
+                visibility,
+                numBoxes);
+        }
     };
 #endif  // !defined(__OGRE_SIMD_ALIGN_STACK)
 
@@ -1500,14 +1523,14 @@ namespace Ogre {
                 __m128 tmp = _mm_mul_ps(norm, norm);
                 // Add - for this we want this effect:
                 // orig   3 | 2 | 1 | 0
-                // add1   0 | 0 | 0 | 2
-                // add2   2 | 3 | 0 | 3
+                // add1   0 | 0 | 0 | 3
+                // add2   2 | 3 | 0 | 2
                 // This way elements 0, 2 and 3 have the sum of all entries (except 1 which is unused)
-                
-                tmp = _mm_add_ps(tmp, _mm_shuffle_ps(tmp, tmp, _MM_SHUFFLE(0,0,0,2)));
+                // Both shuffles read the squares, adding the first sum again would count z twice
+                __m128 sum = _mm_add_ps(tmp, _mm_shuffle_ps(tmp, tmp, _MM_SHUFFLE(0,0,0,3)));
                 // Add final combination & sqrt 
                 // bottom 3 elements of l will have length, we don't care about 4
-                tmp = _mm_add_ps(tmp, _mm_shuffle_ps(tmp, tmp, _MM_SHUFFLE(2,3,0,3)));
+                tmp = _mm_add_ps(sum, _mm_shuffle_ps(tmp, tmp, _MM_SHUFFLE(2,3,0,2)));
                 // Then divide to normalise
                 norm = _mm_div_ps(norm, _mm_sqrt_ps(tmp));
                 
@@ -2136,6 +2159,70 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    size_t OptimisedUtilSSE::cullAxisAlignedBoxes(
+        const Plane* planes, size_t numPlanes,
+        const Real* boxes, size_t boxStride,
+        unsigned char* visibility,
+        size_t numBoxes)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        assert(_isAlignedForSSE(boxes) && (boxStride & 3) == 0);
+
+        const float* centreX = boxes;
+        const float* centreY = centreX + boxStride;
+        const float* centreZ = centreY + boxStride;
+        const float* halfX = centreZ + boxStride;
+        const float* halfY = halfX + boxStride;
+        const float* halfZ = halfY + boxStride;
+
+        // Sign bit only, cleared with andnot for absolute values
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+
+        size_t numVisible = 0;
+        for (size_t i = 0; i < numBoxes; i += 4)
+        {
+            __m128 cx = _mm_load_ps(centreX + i);
+            __m128 cy = _mm_load_ps(centreY + i);
+            __m128 cz = _mm_load_ps(centreZ + i);
+            __m128 hx = _mm_load_ps(halfX + i);
+            __m128 hy = _mm_load_ps(halfY + i);
+            __m128 hz = _mm_load_ps(halfZ + i);
+
+            // Four boxes per iteration, a lane drops out as soon as it is
+            // entirely behind one plane
+            int visibleMask = 0xf;
+            for (size_t p = 0; p < numPlanes && visibleMask; ++p)
+            {
+                const Plane& plane = planes[p];
+                __m128 nx = _mm_set1_ps(plane.normal.x);
+                __m128 ny = _mm_set1_ps(plane.normal.y);
+                __m128 nz = _mm_set1_ps(plane.normal.z);
+
+                // Same operations as Plane::getSide: distance of the centre
+                // compared against the projected half size
+                __m128 dist = _mm_add_ps(__MM_DOT3x3_PS(nx, ny, nz, cx, cy, cz),
+                    _mm_set1_ps(plane.d));
+                __m128 maxAbsDist = _mm_add_ps(_mm_add_ps(
+                    _mm_andnot_ps(signMask, _mm_mul_ps(nx, hx)),
+                    _mm_andnot_ps(signMask, _mm_mul_ps(ny, hy))),
+                    _mm_andnot_ps(signMask, _mm_mul_ps(nz, hz)));
+                __m128 outside = _mm_cmplt_ps(dist, _mm_sub_ps(_mm_setzero_ps(), maxAbsDist));
+                visibleMask &= ~_mm_movemask_ps(outside);
+            }
+
+            size_t count = std::min(numBoxes - i, (size_t)4);
+            for (size_t j = 0; j < count; ++j)
+            {
+                unsigned char visible = (visibleMask >> j) & 1;
+                visibility[i + j] = visible;
+                numVisible += visible;
+            }
+        }
+
+        return numVisible;
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilSSE(void)
@@ -0,0 +1,295 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+/** Internal include file -- do not use externally */
+// Included by OgrePixelFormat.cpp after OgrePixelConversions.h, which
+// provides FMTCONVERTERID. The results are bit identical to the scalar
+// conversions, so they can be picked whenever the formats match.
+
+#if __OGRE_HAVE_SSE2 && OGRE_ENDIAN == OGRE_ENDIAN_LITTLE
+/** \addtogroup Core
+*  @{
+*/
+/** \addtogroup Image
+*  @{
+*/
+
+/**
+ * Convert a box of pixels one row at a time. Unlike PixelBoxConverter the
+ * policy class works on whole rows, so it can process several pixels per
+ * instruction: it has a static method convertRow(src, dst, width) taking
+ * byte pointers to the first pixel of a row.
+ */
+template <class U> struct PixelBoxRowConverter
+{
+    static void conversion(const Ogre::PixelBox &src, const Ogre::PixelBox &dst)
+    {
+        const size_t srcPixelSize = Ogre::PixelUtil::getNumElemBytes(src.format);
+        const size_t dstPixelSize = Ogre::PixelUtil::getNumElemBytes(dst.format);
+        const Ogre::uint8 *srcptr = static_cast<const Ogre::uint8*>(src.getTopLeftFrontPixelPtr());
+        Ogre::uint8 *dstptr = static_cast<Ogre::uint8*>(dst.getTopLeftFrontPixelPtr());
+        const size_t width = src.getWidth();
+        for(size_t z=0; z<src.getDepth(); z++)
+        {
+            const Ogre::uint8 *srcrow = srcptr + z * src.slicePitch * srcPixelSize;
+            Ogre::uint8 *dstrow = dstptr + z * dst.slicePitch * dstPixelSize;
+            for(size_t y=0; y<src.getHeight(); y++)
+            {
+                U::convertRow(srcrow, dstrow, width);
+                srcrow += src.rowPitch * srcPixelSize;
+                dstrow += dst.rowPitch * dstPixelSize;
+            }
+        }
+    }
+};
+
+/** Rearranges the bytes of native 32-bit pixels, byte k of the result is
+    byte sk of the source. Shifts and masks only, as byte shuffles need SSSE3.
+*/
+template <int s0, int s1, int s2, int s3> struct Swizzle32
+{
+    template <int s, int k> static inline __m128i moveByte(__m128i v)
+    {
+        if (s > k)
+            v = _mm_srli_epi32(v, (s > k ? s - k : 0) * 8);
+        else if (s < k)
+            v = _mm_slli_epi32(v, (k > s ? k - s : 0) * 8);
+        return _mm_and_si128(v, _mm_set1_epi32(static_cast<int>(0xFFu << (k * 8))));
+    }
+    static inline __m128i swizzle(__m128i v)
+    {
+        if (s0 == 0 && s1 == 1 && s2 == 2 && s3 == 3)
+            return v;
+        return _mm_or_si128(_mm_or_si128(moveByte<s0, 0>(v), moveByte<s1, 1>(v)),
+                            _mm_or_si128(moveByte<s2, 2>(v), moveByte<s3, 3>(v)));
+    }
+
+    template <int s, int k> static inline Ogre::uint32 moveByte(Ogre::uint32 v)
+    {
+        v = s > k ? v >> ((s > k ? s - k : 0) * 8) : v << ((k > s ? k - s : 0) * 8);
+        return v & (0xFFu << (k * 8));
+    }
+    static inline Ogre::uint32 swizzle(Ogre::uint32 v)
+    {
+        return moveByte<s0, 0>(v) | moveByte<s1, 1>(v) | moveByte<s2, 2>(v) | moveByte<s3, 3>(v);
+    }
+
+    static void convertRow(const Ogre::uint8 *src, Ogre::uint8 *dst, size_t width)
+    {
+        size_t x = 0;
+        for (; x + 4 <= width; x += 4)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), swizzle(v));
+        }
+        for (; x < width; x++)
+        {
+            Ogre::uint32 v;
+            memcpy(&v, src + x * 4, 4);
+            v = swizzle(v);
+            memcpy(dst + x * 4, &v, 4);
+        }
+    }
+};
+
+/** Expands 24-bit pixels to 32 bits with an opaque alpha, then swizzles them.
+    The expanded pixel has the bytes of the source in the order they are in
+    memory, i.e. PF_R8G8B8 becomes PF_A8R8G8B8 and PF_B8G8R8 PF_A8B8G8R8.
+*/
+template <int s0, int s1, int s2, int s3> struct Expand24
+{
+    static void convertRow(const Ogre::uint8 *src, Ogre::uint8 *dst, size_t width)
+    {
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+        size_t x = 0;
+        // Four pixels take 12 bytes but 16 are loaded, stop early enough to stay inside the row
+        for (; x + 6 <= width; x += 4)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 3));
+            __m128i p01 = _mm_unpacklo_epi32(v, _mm_srli_si128(v, 3));
+            __m128i p23 = _mm_unpacklo_epi32(_mm_srli_si128(v, 6), _mm_srli_si128(v, 9));
+            v = _mm_or_si128(_mm_unpacklo_epi64(p01, p23), alpha);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), Swizzle32<s0, s1, s2, s3>::swizzle(v));
+        }
+        for (; x < width; x++)
+        {
+            const Ogre::uint8 *p = src + x * 3;
+            Ogre::uint32 v = p[0] | (p[1] << 8) | (p[2] << 16) | 0xFF000000;
+            v = Swizzle32<s0, s1, s2, s3>::swizzle(v);
+            memcpy(dst + x * 4, &v, 4);
+        }
+    }
+};
+
+/** Converts float32 channels to float16, rounding like Bitwise::floatToHalf.
+    Groups of values with denormal, overflowing or NaN results go through
+    Bitwise, which is rare in image data.
+*/
+template <int channels> struct FloatToHalf
+{
+    static void convertRow(const Ogre::uint8 *srcbytes, Ogre::uint8 *dstbytes, size_t width)
+    {
+        const float *src = reinterpret_cast<const float*>(srcbytes);
+        Ogre::uint16 *dst = reinterpret_cast<Ogre::uint16*>(dstbytes);
+        const size_t count = width * channels;
+        const __m128i absMask = _mm_set1_epi32(0x7FFFFFFF);
+        const __m128i signMask = _mm_set1_epi32(static_cast<int>(0x80000000));
+        // Exponents below 102 become zero, 113 to 142 are normal halfs
+        const __m128i minDenormal = _mm_set1_epi32(102 << 23);
+        const __m128i minNormal = _mm_set1_epi32(113 << 23);
+        const __m128i maxNormal = _mm_set1_epi32(143 << 23);
+        const __m128i rebias = _mm_set1_epi32(112 << 10);
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i absv = _mm_and_si128(v, absMask);
+            __m128i tiny = _mm_cmplt_epi32(absv, minDenormal);
+            __m128i special = _mm_or_si128(
+                _mm_andnot_si128(tiny, _mm_cmplt_epi32(absv, minNormal)),
+                _mm_cmpeq_epi32(_mm_cmplt_epi32(absv, maxNormal), _mm_setzero_si128()));
+            if (_mm_movemask_epi8(special))
+            {
+                for (size_t k = i; k < i + 4; k++)
+                    dst[k] = Ogre::Bitwise::floatToHalf(src[k]);
+                continue;
+            }
+            __m128i h = _mm_or_si128(_mm_srli_epi32(_mm_and_si128(v, signMask), 16),
+                                     _mm_sub_epi32(_mm_srli_epi32(absv, 13), rebias));
+            h = _mm_andnot_si128(tiny, h);
+            // Sign extend, so the saturating pack keeps the low 16 bits as they are
+            h = _mm_srai_epi32(_mm_slli_epi32(h, 16), 16);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(h, h));
+        }
+        for (; i < count; i++)
+            dst[i] = Ogre::Bitwise::floatToHalf(src[i]);
+    }
+};
+
+/** Converts float16 channels to float32, exactly like Bitwise::halfToFloat.
+    Groups of values holding denormals, infinities or NaNs go through Bitwise.
+*/
+template <int channels> struct HalfToFloat
+{
+    static void convertRow(const Ogre::uint8 *srcbytes, Ogre::uint8 *dstbytes, size_t width)
+    {
+        const Ogre::uint16 *src = reinterpret_cast<const Ogre::uint16*>(srcbytes);
+        float *dst = reinterpret_cast<float*>(dstbytes);
+        const size_t count = width * channels;
+        const __m128i absMask = _mm_set1_epi32(0x7FFF);
+        const __m128i expMask = _mm_set1_epi32(0x7C00);
+        const __m128i rebias = _mm_set1_epi32(112 << 23);
+        const __m128i zero = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i v = _mm_unpacklo_epi16(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)), zero);
+            __m128i absv = _mm_and_si128(v, absMask);
+            __m128i e = _mm_and_si128(v, expMask);
+            __m128i isZero = _mm_cmpeq_epi32(absv, zero);
+            __m128i special = _mm_or_si128(_mm_cmpeq_epi32(e, expMask),
+                _mm_andnot_si128(isZero, _mm_cmpeq_epi32(e, zero)));
+            if (_mm_movemask_epi8(special))
+            {
+                for (size_t k = i; k < i + 4; k++)
+                    dst[k] = Ogre::Bitwise::halfToFloat(src[k]);
+                continue;
+            }
+            __m128i f = _mm_andnot_si128(isZero, _mm_add_epi32(_mm_slli_epi32(absv, 13), rebias));
+            f = _mm_or_si128(f, _mm_slli_epi32(_mm_xor_si128(v, absv), 16));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), f);
+        }
+        for (; i < count; i++)
+            dst[i] = Ogre::Bitwise::halfToFloat(src[i]);
+    }
+};
+
+typedef Swizzle32<2,1,0,3> SwapBytes02;
+typedef Swizzle32<0,3,2,1> SwapBytes13;
+typedef Swizzle32<3,2,1,0> ReverseBytes;
+typedef Swizzle32<3,0,1,2> RotateBytesLeft;
+typedef Swizzle32<1,2,3,0> RotateBytesRight;
+typedef Expand24<0,1,2,3> Expand24Copy;
+typedef Expand24<2,1,0,3> Expand24SwapBytes02;
+typedef Expand24<3,2,1,0> Expand24ReverseBytes;
+typedef Expand24<3,0,1,2> Expand24RotateBytesLeft;
+
+#define SSE2CONVERTER(from, to, type) \
+    case FMTCONVERTERID(from, to): PixelBoxRowConverter<type >::conversion(src, dst); return 1;
+
+/** Runs the SSE2 conversion between the formats of the boxes, if there is one.
+@return 1 if the pixels were converted, 0 if there is no such conversion
+*/
+inline int doSSE2Conversion(const Ogre::PixelBox &src, const Ogre::PixelBox &dst)
+{
+    using namespace Ogre;
+    switch(FMTCONVERTERID(src.format, dst.format))
+    {
+        // 32-bit swizzles
+        SSE2CONVERTER(PF_A8R8G8B8, PF_A8B8G8R8, SwapBytes02);
+        SSE2CONVERTER(PF_A8R8G8B8, PF_B8G8R8A8, ReverseBytes);
+        SSE2CONVERTER(PF_A8R8G8B8, PF_R8G8B8A8, RotateBytesLeft);
+        SSE2CONVERTER(PF_A8B8G8R8, PF_A8R8G8B8, SwapBytes02);
+        SSE2CONVERTER(PF_A8B8G8R8, PF_B8G8R8A8, RotateBytesLeft);
+        SSE2CONVERTER(PF_A8B8G8R8, PF_R8G8B8A8, ReverseBytes);
+        SSE2CONVERTER(PF_B8G8R8A8, PF_A8R8G8B8, ReverseBytes);
+        SSE2CONVERTER(PF_B8G8R8A8, PF_A8B8G8R8, RotateBytesRight);
+        SSE2CONVERTER(PF_B8G8R8A8, PF_R8G8B8A8, SwapBytes13);
+        SSE2CONVERTER(PF_R8G8B8A8, PF_A8R8G8B8, RotateBytesRight);
+        SSE2CONVERTER(PF_R8G8B8A8, PF_A8B8G8R8, ReverseBytes);
+        SSE2CONVERTER(PF_R8G8B8A8, PF_B8G8R8A8, SwapBytes13);
+
+        // 24 to 32-bit
+        SSE2CONVERTER(PF_R8G8B8, PF_A8R8G8B8, Expand24Copy);
+        SSE2CONVERTER(PF_R8G8B8, PF_A8B8G8R8, Expand24SwapBytes02);
+        SSE2CONVERTER(PF_R8G8B8, PF_B8G8R8A8, Expand24ReverseBytes);
+        SSE2CONVERTER(PF_R8G8B8, PF_R8G8B8A8, Expand24RotateBytesLeft);
+        SSE2CONVERTER(PF_B8G8R8, PF_A8B8G8R8, Expand24Copy);
+        SSE2CONVERTER(PF_B8G8R8, PF_A8R8G8B8, Expand24SwapBytes02);
+        SSE2CONVERTER(PF_B8G8R8, PF_B8G8R8A8, Expand24RotateBytesLeft);
+        SSE2CONVERTER(PF_B8G8R8, PF_R8G8B8A8, Expand24ReverseBytes);
+
+        // Float precision, both store the channels in the same order
+        SSE2CONVERTER(PF_FLOAT32_R, PF_FLOAT16_R, FloatToHalf<1>);
+        SSE2CONVERTER(PF_FLOAT32_GR, PF_FLOAT16_GR, FloatToHalf<2>);
+        SSE2CONVERTER(PF_FLOAT32_RGB, PF_FLOAT16_RGB, FloatToHalf<3>);
+        SSE2CONVERTER(PF_FLOAT32_RGBA, PF_FLOAT16_RGBA, FloatToHalf<4>);
+        SSE2CONVERTER(PF_FLOAT16_R, PF_FLOAT32_R, HalfToFloat<1>);
+        SSE2CONVERTER(PF_FLOAT16_GR, PF_FLOAT32_GR, HalfToFloat<2>);
+        SSE2CONVERTER(PF_FLOAT16_RGB, PF_FLOAT32_RGB, HalfToFloat<3>);
+        SSE2CONVERTER(PF_FLOAT16_RGBA, PF_FLOAT32_RGBA, HalfToFloat<4>);
+
+    default:
+        return 0;
+    }
+}
+#undef SSE2CONVERTER
+/** @} */
+/** @} */
+
+#endif
@@ -31,9 +31,12 @@ THE SOFTWARE.
 #include "OgreColourValue.h"
 #include "OgreException.h"
 #include "OgrePixelFormatDescriptions.h"
+#include "Threading/OgreThreads.h"
+#include "OgreSIMDHelper.h"
 
 namespace {
 #include "OgrePixelConversions.h"
+#include "OgrePixelConversionsSSE2.h"
 }
 
 namespace Ogre {
@@ -690,33 +693,9 @@ namespace Ogre {
         bulkPixelConversion(src, dst);
     }
     //-----------------------------------------------------------------------
-    void PixelUtil::bulkPixelConversion(const PixelBox &src, const PixelBox &dst)
+    /* Converts the pixels of a box on the calling thread */
+    static void convertPixelBox(const PixelBox &src, const PixelBox &dst)
     {
-        assert(src.getWidth() == dst.getWidth() &&
-               src.getHeight() == dst.getHeight() &&
-               src.getDepth() == dst.getDepth());
-
-        // Check for compressed formats, we don't support decompression, compression or recoding
-        if(PixelUtil::isCompressed(src.format) || PixelUtil::isCompressed(dst.format))
-        {
-            if(src.format == dst.format && src.left == 0 && src.top == 0 && dst.left == 0 && dst.top == 0)
-            {
-                // we can copy with slice granularity, useful for Tex2DArray handling
-                uint32 bytesPerSlice = getMemorySize(src.getWidth(), src.getHeight(), 1, src.format);
-                memcpy(
-                    (uint8*)dst.data + bytesPerSlice * dst.front,
-                    (uint8*)src.data + bytesPerSlice * src.front,
-                    bytesPerSlice * src.getDepth());
-                return;
-            }
-            else
-            {
-                OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
-                    "This method can not be used to compress or decompress images",
-                    "PixelUtil::bulkPixelConversion");
-            }
-        }
-
         // The easy case
         if(src.format == dst.format) {
             // Everything consecutive?
@@ -765,20 +744,28 @@ namespace Ogre {
             // optimized conversions
             PixelBox tempdst = dst;
             tempdst.format = dst.format==PF_X8R8G8B8?PF_A8R8G8B8:PF_A8B8G8R8;
-            bulkPixelConversion(src, tempdst);
+            convertPixelBox(src, tempdst);
             return;
         }
         // Converting from PF_X8R8G8B8 is exactly the same as converting from
         // PF_A8R8G8B8, given that the destination format does not have alpha.
-        if((src.format == PF_X8R8G8B8||src.format == PF_X8B8G8R8) && !hasAlpha(dst.format))
+        if((src.format == PF_X8R8G8B8||src.format == PF_X8B8G8R8) && !PixelUtil::hasAlpha(dst.format))
         {
             // Do the same conversion, with PF_A8R8G8B8, which has a lot of
             // optimized conversions
             PixelBox tempsrc = src;
             tempsrc.format = src.format==PF_X8R8G8B8?PF_A8R8G8B8:PF_A8B8G8R8;
-            bulkPixelConversion(tempsrc, dst);
+            convertPixelBox(tempsrc, dst);
+            return;
+        }
+
+#if __OGRE_HAVE_SSE2 && OGRE_ENDIAN == OGRE_ENDIAN_LITTLE
+        // Is there a conversion handling several pixels at once?
+        if(doSSE2Conversion(src, dst))
+        {
             return;
         }
+#endif
 
 // NB VC6 can't handle the templates required for optimised conversion, tough
 #if OGRE_COMPILER != OGRE_COMPILER_MSVC || OGRE_COMP_VER >= 1300
@@ -814,8 +801,8 @@ namespace Ogre {
             {
                 for(size_t x=src.left; x<src.right; x++)
                 {
-                    unpackColour(&r, &g, &b, &a, src.format, srcptr);
-                    packColour(r, g, b, a, dst.format, dstptr);
+                    PixelUtil::unpackColour(&r, &g, &b, &a, src.format, srcptr);
+                    PixelUtil::packColour(r, g, b, a, dst.format, dstptr);
                     srcptr += srcPixelSize;
                     dstptr += dstPixelSize;
                 }
@@ -827,6 +814,63 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    namespace
+    {
+        struct ConversionBands
+        {
+            const PixelBox* src;
+            const PixelBox* dst;
+        };
+    }
+    static void convertRows(size_t rowBegin, size_t rowEnd, void* userData)
+    {
+        const ConversionBands* bands = static_cast<const ConversionBands*>(userData);
+        PixelBox src = *bands->src, dst = *bands->dst;
+        src.top = bands->src->top + rowBegin;
+        src.bottom = bands->src->top + rowEnd;
+        dst.top = bands->dst->top + rowBegin;
+        dst.bottom = bands->dst->top + rowEnd;
+        convertPixelBox(src, dst);
+    }
+    //-----------------------------------------------------------------------
+    void PixelUtil::bulkPixelConversion(const PixelBox &src, const PixelBox &dst)
+    {
+        assert(src.getWidth() == dst.getWidth() &&
+               src.getHeight() == dst.getHeight() &&
+               src.getDepth() == dst.getDepth());
+
+        // Check for compressed formats, we don't support decompression, compression or recoding
+        if(PixelUtil::isCompressed(src.format) || PixelUtil::isCompressed(dst.format))
+        {
+            if(src.format == dst.format && src.left == 0 && src.top == 0 && dst.left == 0 && dst.top == 0)
+            {
+                // we can copy with slice granularity, useful for Tex2DArray handling
+                uint32 bytesPerSlice = getMemorySize(src.getWidth(), src.getHeight(), 1, src.format);
+                memcpy(
+                    (uint8*)dst.data + bytesPerSlice * dst.front,
+                    (uint8*)src.data + bytesPerSlice * src.front,
+                    bytesPerSlice * src.getDepth());
+                return;
+            }
+            else
+            {
+                OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+                    "This method can not be used to compress or decompress images",
+                    "PixelUtil::bulkPixelConversion");
+            }
+        }
+
+        // Split large images into bands of rows, unless a single memcpy does the job
+        if(src.getDepth() == 1 && !(src.format == dst.format && src.isConsecutive() && dst.isConsecutive()))
+        {
+            ConversionBands bands = { &src, &dst };
+            _parallelForRows(src.getHeight(), src.getWidth(), convertRows, &bands);
+            return;
+        }
+
+        convertPixelBox(src, dst);
+    }
+    //-----------------------------------------------------------------------
     void PixelUtil::bulkPixelVerticalFlip(const PixelBox &box)
     {
         // Check for compressed formats, we don't support decompression, compression or recoding
@@ -888,5 +932,65 @@ namespace Ogre {
         size_t pixelOffset = pixelSize * (z * slicePitch + y * rowPitch + x);
         PixelUtil::packColour(cv, format, (unsigned char *)data + pixelOffset);
     }
+    //-----------------------------------------------------------------------
+    /// Pixels a band has to have at least to be worth a thread of its own
+    static const size_t MIN_PIXELS_PER_BAND = 128 * 1024;
+    static size_t msNumWorkerThreads = 0;
+    //-----------------------------------------------------------------------
+    void PixelUtil::setNumWorkerThreads(size_t numThreads)
+    {
+        msNumWorkerThreads = numThreads;
+    }
+    //-----------------------------------------------------------------------
+    size_t PixelUtil::getNumWorkerThreads(void)
+    {
+        return msNumWorkerThreads;
+    }
+    //-----------------------------------------------------------------------
+#if OGRE_THREAD_SUPPORT
+    namespace
+    {
+        struct RowBands
+        {
+            PixelUtil::RowFunction func;
+            void* userData;
+            size_t numRows;
+            size_t numBands;
+        };
+
+        unsigned long pixelRowsThread(ThreadHandle* threadHandle)
+        {
+            const RowBands* bands = static_cast<const RowBands*>(threadHandle->getUserParam());
+            const size_t band = threadHandle->getThreadIdx();
+            bands->func(band * bands->numRows / bands->numBands,
+                (band + 1) * bands->numRows / bands->numBands, bands->userData);
+            return 0;
+        }
+        THREAD_DECLARE(pixelRowsThread)
+    }
+#endif
+    //-----------------------------------------------------------------------
+    void PixelUtil::_parallelForRows(size_t numRows, size_t pixelsPerRow, RowFunction func, void* userData)
+    {
+#if OGRE_THREAD_SUPPORT
+        size_t numBands = std::min(msNumWorkerThreads, numRows);
+        numBands = std::min(numBands, numRows * pixelsPerRow / MIN_PIXELS_PER_BAND);
+        if (numBands > 1)
+        {
+            RowBands bands = { func, userData, numRows, numBands };
+            ThreadHandleVec threads;
+            for (size_t i = 1; i < numBands; ++i)
+            {
+                threads.push_back(
+                    Threads::CreateThread(THREAD_GET(pixelRowsThread), i, &bands));
+            }
+            // The calling thread takes the first band
+            func(0, numRows / numBands, userData);
+            Threads::WaitForThreads(threads);
+            return;
+        }
+#endif
+        func(0, numRows, userData);
+    }
 
 }
@@ -154,7 +154,15 @@ namespace Ogre {
     static uint _performCpuid(int query, CpuidResult& result)
     {
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
-    #if _MSC_VER >= 1400 
+    #if _MSC_VER >= 1500
+        int CPUInfo[4];
+        __cpuidex(CPUInfo, query, 0);
+        result._eax = CPUInfo[0];
+        result._ebx = CPUInfo[1];
+        result._ecx = CPUInfo[2];
+        result._edx = CPUInfo[3];
+        return result._eax;
+    #elif _MSC_VER >= 1400
         int CPUInfo[4];
         __cpuid(CPUInfo, query);
         result._eax = CPUInfo[0];
@@ -167,6 +175,7 @@ namespace Ogre {
         {
             mov     edi, result
             mov     eax, query
+            xor     ecx, ecx
             cpuid
             mov     [edi]._eax, eax
             mov     [edi]._ebx, ebx
@@ -179,7 +188,7 @@ namespace Ogre {
         #if OGRE_ARCH_TYPE == OGRE_ARCHITECTURE_64
         __asm__
         (
-            "cpuid": "=a" (result._eax), "=b" (result._ebx), "=c" (result._ecx), "=d" (result._edx) : "a" (query)
+            "cpuid": "=a" (result._eax), "=b" (result._ebx), "=c" (result._ecx), "=d" (result._edx) : "a" (query), "c" (0)
         );
         #else
         __asm__
@@ -189,7 +198,7 @@ namespace Ogre {
             "movl   %%ebx, %%edi    \n\t"
             "popl   %%ebx           \n\t"
             : "=a" (result._eax), "=D" (result._ebx), "=c" (result._ecx), "=d" (result._edx)
-            : "a" (query)
+            : "a" (query), "c" (0)
         );
        #endif // OGRE_ARCHITECTURE_64
         return result._eax;
@@ -276,10 +285,66 @@ namespace Ogre {
 #endif
     }
 
+    //---------------------------------------------------------------------
+    // Detect whether or not os saves the AVX (YMM) registers on context switch.
+    // Only valid if CPUID reports OSXSAVE.
+    static bool _checkOperatingSystemSupportAVX(void)
+    {
+#if OGRE_COMPILER == OGRE_COMPILER_MSVC && (_MSC_FULL_VER >= 160040219)
+        // XCR0 bits 1 and 2: XMM and YMM state enabled
+        return (_xgetbv(0) & 6) == 6;
+#elif (OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG) && OGRE_PLATFORM != OGRE_PLATFORM_NACL && OGRE_PLATFORM != OGRE_PLATFORM_EMSCRIPTEN
+        uint xcr0, xcr0High;
+        // xgetbv, spelled out for assemblers which don't know it
+        __asm__ __volatile__
+        (
+            ".byte 0x0f, 0x01, 0xd0" : "=a" (xcr0), "=d" (xcr0High) : "c" (0)
+        );
+        (void)xcr0High;
+        return (xcr0 & 6) == 6;
+#else
+        // TODO: Supports other compiler, assumed is not supported by default
+        return false;
+#endif
+    }
+
     //---------------------------------------------------------------------
     // Compiler-independent routines
     //---------------------------------------------------------------------
 
+    static uint queryAvxFeatures(uint maxStandardFunctionSupport, uint standardFeaturesEcx)
+    {
+#define CPUID_FUNC_STRUCTURED_EXTENDED_FEATURES 0x7
+
+#define CPUID_STD_FMA               (1<<12)     // ECX[12] - Bit 12 of standard function 1 indicate FMA3 supported
+#define CPUID_STD_OSXSAVE           (1<<27)     // ECX[27] - Bit 27 of standard function 1 indicate XGETBV enabled by OS
+#define CPUID_STD_AVX               (1<<28)     // ECX[28] - Bit 28 of standard function 1 indicate AVX supported
+#define CPUID_SEF_AVX2              (1<<5)      // EBX[5]  - Bit 5 of function 7 indicate AVX2 supported
+
+        uint features = 0;
+
+        // AVX instructions fault unless the OS saves the YMM registers too
+        if ((standardFeaturesEcx & CPUID_STD_AVX) && (standardFeaturesEcx & CPUID_STD_OSXSAVE) &&
+            _checkOperatingSystemSupportAVX())
+        {
+            features |= PlatformInformation::CPU_FEATURE_AVX;
+            if (standardFeaturesEcx & CPUID_STD_FMA)
+                features |= PlatformInformation::CPU_FEATURE_FMA;
+
+            if (maxStandardFunctionSupport >= CPUID_FUNC_STRUCTURED_EXTENDED_FEATURES)
+            {
+                CpuidResult result;
+                _performCpuid(CPUID_FUNC_STRUCTURED_EXTENDED_FEATURES, result);
+
+                if (result._ebx & CPUID_SEF_AVX2)
+                    features |= PlatformInformation::CPU_FEATURE_AVX2;
+            }
+        }
+
+        return features;
+    }
+    //---------------------------------------------------------------------
+
     static uint queryCpuFeatures(void)
     {
 
@@ -323,6 +388,8 @@ namespace Ogre {
             if (_performCpuid(CPUID_FUNC_VENDOR_ID, result))
             {
                 // Check vendor strings
+                const uint maxStandardFunctionSupport = result._eax;
+
                 if (memcmp(&result._ebx, "GenuineIntel", 12) == 0)
                 {
                     if (result._eax > 2)
@@ -359,6 +426,8 @@ namespace Ogre {
                             features |= PlatformInformation::CPU_FEATURE_HTT;
                     }
 
+                    features |= queryAvxFeatures(maxStandardFunctionSupport, result._ecx);
+
 
                     const uint maxExtensionFunctionSupport = _performCpuid(CPUID_FUNC_EXTENSION_QUERY, result);
                     if (maxExtensionFunctionSupport >= CPUID_FUNC_ADVANCED_POWER_MANAGEMENT)
@@ -392,6 +461,8 @@ namespace Ogre {
                     if (result._ecx & CPUID_STD_SSE3)
                         features |= PlatformInformation::CPU_FEATURE_SSE3;
 
+                    features |= queryAvxFeatures(maxStandardFunctionSupport, result._ecx);
+
                     // Has extended feature ?
                     const uint maxExtensionFunctionSupport = _performCpuid(CPUID_FUNC_EXTENSION_QUERY, result);
                     if (maxExtensionFunctionSupport >= CPUID_FUNC_EXTENDED_FEATURES)
@@ -433,9 +504,14 @@ namespace Ogre {
             | PlatformInformation::CPU_FEATURE_SSE41
             | PlatformInformation::CPU_FEATURE_SSE42;
 
+        const uint avx_features = 0
+            | PlatformInformation::CPU_FEATURE_AVX
+            | PlatformInformation::CPU_FEATURE_AVX2
+            | PlatformInformation::CPU_FEATURE_FMA;
+
         if ((features & sse_features) && !_checkOperatingSystemSupportSSE())
         {
-            features &= ~sse_features;
+            features &= ~(sse_features | avx_features);
         }
 
         return features;
@@ -699,6 +775,12 @@ namespace Ogre {
                 " *        SSE41: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_SSE41), true));
             pLog->logMessage(
                 " *        SSE42: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_SSE42), true));
+            pLog->logMessage(
+                " *          AVX: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_AVX), true));
+            pLog->logMessage(
+                " *         AVX2: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_AVX2), true));
+            pLog->logMessage(
+                " *          FMA: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_FMA), true));
             pLog->logMessage(
                 " *          MMX: " + StringConverter::toString(hasCpuFeature(CPU_FEATURE_MMX), true));
             pLog->logMessage(
@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "OgreMovableObject.h"
 #include "OgreSceneManagerEnumerator.h"
 #include "OgreTechnique.h"
+#include "OgreTextureStreamer.h"
 
 
 namespace Ogre {
@@ -46,6 +47,7 @@ namespace Ogre {
         : mSplitPassesByLightingType(false)
         , mSplitNoShadowPasses(false)
         , mShadowCastersCannotBeReceivers(false)
+        , mRetainedMode(false)
         , mRenderableListener(0)
     {
         // Create the 'main' queue up-front since we'll always need that
@@ -211,6 +213,8 @@ namespace Ogre {
                 mSplitPassesByLightingType,
                 mSplitNoShadowPasses,
                 mShadowCastersCannotBeReceivers);
+            if (mRetainedMode)
+                pGroup->setRetainedMode(true);
             mGroups.insert(RenderQueueGroupMap::value_type(groupID, pGroup));
         }
         else
@@ -276,6 +280,19 @@ namespace Ogre {
         return mShadowCastersCannotBeReceivers;
     }
     //-----------------------------------------------------------------------
+    void RenderQueue::setRetainedMode(bool retained)
+    {
+        mRetainedMode = retained;
+
+        RenderQueueGroupMap::iterator i, iend;
+        i = mGroups.begin();
+        iend = mGroups.end();
+        for (; i != iend; ++i)
+        {
+            i->second->setRetainedMode(retained);
+        }
+    }
+    //-----------------------------------------------------------------------
     void RenderQueue::merge( const RenderQueue* rhs )
     {
         ConstQueueGroupIterator it = rhs->_getQueueGroupIterator( );
@@ -305,6 +322,12 @@ namespace Ogre {
             if (!onlyShadowCasters || mo->getCastShadows())
             {
                 mo -> _updateRenderQueue( this );
+
+                // Let streamed textures know how much detail they need
+                TextureStreamer* streamer = TextureStreamer::getSingletonPtr();
+                if (!onlyShadowCasters && streamer && streamer->hasStreamedTextures())
+                    streamer->_notifyObjectVisible(mo, cam);
+
                 if (visibleBounds)
                 {
                     visibleBounds->merge(mo->getWorldBoundingBox(true), 
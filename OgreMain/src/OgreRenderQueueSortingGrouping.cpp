@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreRenderQueueSortingGrouping.h"
 #include "OgreException.h"
 #include "OgreTechnique.h"
+#include "OgreCamera.h"
 
 namespace Ogre {
     // Init statics
@@ -36,6 +37,40 @@ namespace Ogre {
         RenderablePass, uint32> QueuedRenderableCollection::msRadixSorter1;
     RadixSort<QueuedRenderableCollection::RenderablePassList,
         RenderablePass, float> QueuedRenderableCollection::msRadixSorter2;
+    RadixSort<QueuedRenderableCollection::RetainedSortList,
+        QueuedRenderableCollection::RetainedSortItem, uint64> QueuedRenderableCollection::msRadixSorterKey;
+
+    namespace {
+        /// Integer with the same order as a non negative view depth
+        uint32 depthSortBits(Real depth)
+        {
+            float f = static_cast<float>(depth);
+            if (!(f > 0))
+                return 0;
+            uint32 bits;
+            memcpy(&bits, &f, sizeof(bits));
+            return bits;
+        }
+
+        /** Mantissa bits dropped from the depth of pass grouped entries, so that
+            small movements do not reorder them */
+        const int DEPTH_BUCKET_SHIFT = 16;
+
+        /// Queues everything visited into another collection
+        class MergeVisitor : public QueuedRenderableVisitor
+        {
+        public:
+            MergeVisitor(QueuedRenderableCollection* dest) : mDest(dest), mPass(0) {}
+
+            void visit(RenderablePass* rp) { mDest->addRenderable(rp->pass, rp->renderable); }
+            bool visit(const Pass* p) { mPass = const_cast<Pass*>(p); return true; }
+            void visit(Renderable* r) { mDest->addRenderable(mPass, r); }
+
+        private:
+            QueuedRenderableCollection* mDest;
+            Pass* mPass;
+        };
+    }
 
 
     //-----------------------------------------------------------------------
@@ -263,6 +298,16 @@ namespace Ogre {
         mTransparents.sort(cam);
     }
     //-----------------------------------------------------------------------
+    void RenderPriorityGroup::setRetainedMode(bool retained)
+    {
+        mSolidsBasic.setRetainedMode(retained);
+        mSolidsDiffuseSpecular.setRetainedMode(retained);
+        mSolidsDecal.setRetainedMode(retained);
+        mSolidsNoShadowReceive.setRetainedMode(retained);
+        mTransparentsUnsorted.setRetainedMode(retained);
+        mTransparents.setRetainedMode(retained);
+    }
+    //-----------------------------------------------------------------------
     void RenderPriorityGroup::merge( const RenderPriorityGroup* rhs )
     {
         mSolidsBasic.merge( rhs->mSolidsBasic );
@@ -275,6 +320,12 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     QueuedRenderableCollection::QueuedRenderableCollection(void)
         :mOrganisationMode(0)
+        , mRetainedMode(false)
+        , mRetainedFrame(0)
+        , mRetainedQueued(0)
+        , mRetainedCursor(0)
+        , mRetainedCamera(0)
+        , mRetainedCameraPosition(Vector3::ZERO)
     {
     }
     //-----------------------------------------------------------------------
@@ -303,6 +354,25 @@ namespace Ogre {
 
         // Clear sorted list
         mSortedDescending.clear();
+
+        if (mRetainedMode)
+        {
+            // Keep the entries, those not queued again are dropped by the next sort
+            ++mRetainedFrame;
+            mRetainedQueued = 0;
+            mRetainedCursor = 0;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void QueuedRenderableCollection::setRetainedMode(bool retained)
+    {
+        mRetainedMode = retained;
+        mRetainedEntries.clear();
+        mRetainedOrder.clear();
+        mRetainedLookup.clear();
+        mRetainedQueued = 0;
+        mRetainedCursor = 0;
+        mRetainedCamera = 0;
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::removePassGroup(Pass* p)
@@ -317,10 +387,34 @@ namespace Ogre {
             // erase from map
             mGrouped.erase(i);
         }
+
+        if (mRetainedMode)
+        {
+            bool found = false;
+            RetainedEntryList::iterator e, eend = mRetainedEntries.end();
+            for (e = mRetainedEntries.begin(); e != eend; ++e)
+            {
+                if (e->renderablePass.pass == p && e->frame == mRetainedFrame)
+                {
+                    // Leave it out of the current fill
+                    e->frame = mRetainedFrame - 1;
+                    --mRetainedQueued;
+                    found = true;
+                }
+            }
+            if (found)
+                compactRetained();
+        }
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::sort(const Camera* cam)
     {
+        if (mRetainedMode)
+        {
+            sortRetained(cam);
+            return;
+        }
+
         // ascending and descending sort both set bit 1
         // We always sort descending, because the only difference is in the
         // acceptVisitor method, where we iterate in reverse in ascending mode
@@ -359,6 +453,12 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::addRenderable(Pass* pass, Renderable* rend)
     {
+        if (mRetainedMode)
+        {
+            addRetainedRenderable(pass, rend);
+            return;
+        }
+
         // ascending and descending sort both set bit 1
         if (mOrganisationMode & OM_SORT_DESCENDING)
         {
@@ -408,6 +508,23 @@ namespace Ogre {
                     "QueuedRenderableCollection::acceptVisitor");
         }
 
+        if (mRetainedMode)
+        {
+            switch(om)
+            {
+            case OM_PASS_GROUP:
+                acceptVisitorRetainedGrouped(visitor);
+                break;
+            case OM_SORT_DESCENDING:
+                acceptVisitorRetainedDescending(visitor);
+                break;
+            case OM_SORT_ASCENDING:
+                acceptVisitorRetainedAscending(visitor);
+                break;
+            }
+            return;
+        }
+
         switch(om)
         {
         case OM_PASS_GROUP:
@@ -478,6 +595,18 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::merge( const QueuedRenderableCollection& rhs )
     {
+        if (mRetainedMode || rhs.mRetainedMode)
+        {
+            // Different layouts, queue the pairs one by one
+            if (rhs.mOrganisationMode)
+            {
+                MergeVisitor visitor(this);
+                rhs.acceptVisitor(&visitor, (rhs.mOrganisationMode & OM_PASS_GROUP) ?
+                    OM_PASS_GROUP : OM_SORT_DESCENDING);
+            }
+            return;
+        }
+
         mSortedDescending.insert( mSortedDescending.end(), rhs.mSortedDescending.begin(), rhs.mSortedDescending.end() );
 
         PassGroupRenderableMap::const_iterator srcGroup;
@@ -503,7 +632,176 @@ namespace Ogre {
             dstGroup->second->insert( dstGroup->second->end(), srcGroup->second->begin(), srcGroup->second->end() );
         }
     }
+    //-----------------------------------------------------------------------
+    void QueuedRenderableCollection::addRetainedRenderable(Pass* pass, Renderable* rend)
+    {
+        uint32 index;
+        if (mRetainedCursor < mRetainedEntries.size() &&
+            mRetainedEntries[mRetainedCursor].renderablePass.renderable == rend &&
+            mRetainedEntries[mRetainedCursor].renderablePass.pass == pass)
+        {
+            // Queued in the same order as last time
+            index = static_cast<uint32>(mRetainedCursor);
+        }
+        else
+        {
+            RenderablePass rp(rend, pass);
+            RetainedEntryMap::iterator i = mRetainedLookup.find(rp);
+            if (i != mRetainedLookup.end())
+            {
+                index = i->second;
+            }
+            else
+            {
+                // New pair, the next sort moves it into place
+                index = static_cast<uint32>(mRetainedEntries.size());
+                mRetainedEntries.push_back(RetainedEntry(rend, pass, mRetainedFrame - 1));
+                mRetainedLookup.insert(RetainedEntryMap::value_type(rp, index));
+                mRetainedOrder.push_back(RetainedSortItem(rp, index));
+            }
+        }
+        mRetainedCursor = index + 1;
+
+        RetainedEntry& entry = mRetainedEntries[index];
+        if (entry.frame != mRetainedFrame)
+        {
+            entry.frame = mRetainedFrame;
+            ++mRetainedQueued;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void QueuedRenderableCollection::sortRetained(const Camera* cam)
+    {
+        if (mRetainedQueued < mRetainedEntries.size())
+            compactRetained();
+
+        // Depth decides the order of depth sorted entries, it has to be fresh.
+        // Pass grouped entries only need it again once the camera moved.
+        const bool sortByDepth = (mOrganisationMode & OM_SORT_DESCENDING) != 0;
+        const Vector3& camPos = cam->getDerivedPosition();
+        const bool viewChanged = cam != mRetainedCamera || camPos != mRetainedCameraPosition;
+        mRetainedCamera = cam;
+        mRetainedCameraPosition = camPos;
+
+        // Refresh the keys in their previous order, which mostly still holds
+        bool sorted = true;
+        uint64 prevKey = 0;
+        RetainedSortList::iterator i, iend = mRetainedOrder.end();
+        for (i = mRetainedOrder.begin(); i != iend; ++i)
+        {
+            const RenderablePass& rp = i->renderablePass;
+            uint64 hash = rp.pass->getHash();
+            if (sortByDepth)
+            {
+                // Far objects first, then by pass
+                uint64 depth = depthSortBits(rp.renderable->getSquaredViewDepth(cam));
+                i->key = ((~depth & 0xFFFFFFFF) << 32) | hash;
+            }
+            else if (viewChanged || i->newKey || (i->key >> 32) != hash)
+            {
+                // By pass, then near objects first
+                uint64 depth = depthSortBits(rp.renderable->getSquaredViewDepth(cam));
+                i->key = (hash << 32) | (depth >> DEPTH_BUCKET_SHIFT);
+            }
+            i->newKey = false;
+            sorted = sorted && i->key >= prevKey;
+            prevKey = i->key;
+        }
 
+        if (sorted)
+            return;
+
+        // Same tipping point as the depth sort of the rebuilt lists
+        if (mRetainedOrder.size() > 2000)
+            msRadixSorterKey.sort(mRetainedOrder, RadixSortFunctorKey());
+        else
+            std::stable_sort(mRetainedOrder.begin(), mRetainedOrder.end());
+    }
+    //-----------------------------------------------------------------------
+    void QueuedRenderableCollection::compactRetained(void)
+    {
+        const uint32 removed = ~0u;
+        vector<uint32>::type remap(mRetainedEntries.size(), removed);
+        mRetainedLookup.clear();
+
+        uint32 numKept = 0;
+        for (size_t i = 0; i < mRetainedEntries.size(); ++i)
+        {
+            if (mRetainedEntries[i].frame != mRetainedFrame)
+                continue;
+
+            remap[i] = numKept;
+            mRetainedEntries[numKept] = mRetainedEntries[i];
+            mRetainedLookup.insert(RetainedEntryMap::value_type(
+                mRetainedEntries[i].renderablePass, numKept));
+            ++numKept;
+        }
+        mRetainedEntries.erase(mRetainedEntries.begin() + numKept, mRetainedEntries.end());
+
+        // Keep the order of the survivors, it is still the best guess
+        RetainedSortList::iterator src, dst = mRetainedOrder.begin();
+        for (src = mRetainedOrder.begin(); src != mRetainedOrder.end(); ++src)
+        {
+            if (remap[src->index] != removed)
+            {
+                *dst = *src;
+                dst->index = remap[src->index];
+                ++dst;
+            }
+        }
+        mRetainedOrder.erase(dst, mRetainedOrder.end());
+
+        mRetainedQueued = mRetainedEntries.size();
+        mRetainedCursor = 0;
+    }
+    //-----------------------------------------------------------------------
+    void QueuedRenderableCollection::acceptVisitorRetainedGrouped(
+        QueuedRenderableVisitor* visitor) const
+    {
+        // Entries not queued again since the last clear are only dropped by sort
+        const bool checkQueued = mRetainedQueued < mRetainedEntries.size();
+        const Pass* currentPass = 0;
+        bool skipPass = false;
+        RetainedSortList::const_iterator i, iend = mRetainedOrder.end();
+        for (i = mRetainedOrder.begin(); i != iend; ++i)
+        {
+            if (checkQueued && mRetainedEntries[i->index].frame != mRetainedFrame)
+                continue;
+
+            if (i->renderablePass.pass != currentPass)
+            {
+                // Visit Pass - allow skip
+                currentPass = i->renderablePass.pass;
+                skipPass = !visitor->visit(currentPass);
+            }
+            if (!skipPass)
+                visitor->visit(i->renderablePass.renderable);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void QueuedRenderableCollection::acceptVisitorRetainedDescending(
+        QueuedRenderableVisitor* visitor) const
+    {
+        const bool checkQueued = mRetainedQueued < mRetainedEntries.size();
+        RetainedSortList::const_iterator i, iend = mRetainedOrder.end();
+        for (i = mRetainedOrder.begin(); i != iend; ++i)
+        {
+            if (!checkQueued || mRetainedEntries[i->index].frame == mRetainedFrame)
+                visitor->visit(const_cast<RenderablePass*>(&i->renderablePass));
+        }
+    }
+    //-----------------------------------------------------------------------
+    void QueuedRenderableCollection::acceptVisitorRetainedAscending(
+        QueuedRenderableVisitor* visitor) const
+    {
+        const bool checkQueued = mRetainedQueued < mRetainedEntries.size();
+        RetainedSortList::const_reverse_iterator i, iend = mRetainedOrder.rend();
+        for (i = mRetainedOrder.rbegin(); i != iend; ++i)
+        {
+            if (!checkQueued || mRetainedEntries[i->index].frame == mRetainedFrame)
+                visitor->visit(const_cast<RenderablePass*>(&i->renderablePass));
+        }
+    }
 
 }
 
@@ -61,6 +61,7 @@ namespace Ogre {
         , mBatchCount(0)
         , mFaceCount(0)
         , mVertexCount(0)
+        , mConstantBytesCount(0)
         , mInvertVertexWinding(false)
         , mDisabledTexUnitsFrom(0)
         , mCurrentPassIterationCount(0)
@@ -716,7 +717,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void RenderSystem::_beginGeometryCount(void)
     {
-        mBatchCount = mFaceCount = mVertexCount = 0;
+        mBatchCount = mFaceCount = mVertexCount = mConstantBytesCount = 0;
 
     }
     //-----------------------------------------------------------------------
@@ -735,6 +736,11 @@ namespace Ogre {
         return static_cast< unsigned int >( mVertexCount );
     }
     //-----------------------------------------------------------------------
+    size_t RenderSystem::_getConstantBytesCount(void) const
+    {
+        return mConstantBytesCount;
+    }
+    //-----------------------------------------------------------------------
     void RenderSystem::convertColourValue(const ColourValue& colour, uint32* pDest)
     {
         *pDest = VertexElement::convertColourValue(colour, getColourVertexElementType());
@@ -826,6 +832,17 @@ namespace Ogre {
             mClipPlanesDirty = false;
         }
     }
+    //-----------------------------------------------------------------------
+    void RenderSystem::_renderMultiDraw(const RenderOperation* ops, const Matrix4* worldMatrices, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            RenderSystem::_render(ops[i]);
+
+        // Only one call reaches the GPU
+        if (count > 1)
+            mBatchCount -= (count - 1) * mCurrentPassIterationCount;
+    }
+    //-----------------------------------------------------------------------
     void RenderSystem::_renderUsingReadBackAsTexture(unsigned int secondPass,Ogre::String variableName,unsigned int StartSlot)
     {
         OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, 
@@ -171,6 +171,7 @@ namespace Ogre {
 
         mStats.triangleCount = 0;
         mStats.batchCount = 0;
+        mStats.constantBytes = 0;
     }
 
     void RenderTarget::_updateAutoUpdatedViewports(bool updateStatistics)
@@ -210,6 +211,7 @@ namespace Ogre {
         {
             mStats.triangleCount += viewport->_getNumRenderedFaces();
             mStats.batchCount += viewport->_getNumRenderedBatches();
+            mStats.constantBytes += viewport->_getNumUploadedConstantBytes();
         }
         fireViewportPostUpdate(viewport);
     }
@@ -338,6 +340,7 @@ namespace Ogre {
         mStats.worstFPS = 999.0;
         mStats.triangleCount = 0;
         mStats.batchCount = 0;
+        mStats.constantBytes = 0;
         mStats.bestFrameTime = 999999;
         mStats.worstFrameTime = 0;
         mStats.vBlankMissCount = -1;
@@ -34,6 +34,8 @@ THE SOFTWARE.
 #include "OgreScriptLoader.h"
 #include "OgreSceneManager.h"
 #include "OgreResourceManager.h"
+#include "OgreAtomicScalar.h"
+#include "Threading/OgreThreads.h"
 
 namespace Ogre {
 
@@ -53,10 +55,24 @@ namespace Ogre {
     // A reference count of 3 means that only RGM and RM have references
     // RGM has one (this one) and RM has 2 (by name and by handle)
     size_t ResourceGroupManager::RESOURCE_SYSTEM_NUM_REFERENCE_COUNTS = 3;
+    // Scripts opened ahead per worker thread when parsing concurrently, this
+    // bounds the number of script streams held open at once
+    static const size_t SCRIPTS_PER_WORKER_THREAD = 4;
+    namespace
+    {
+        /// Script opened, or skipped, but not parsed yet
+        struct PendingScript
+        {
+            const FileInfo* file;
+            DataStreamPtr stream;
+            bool skipped;
+        };
+        typedef deque<PendingScript>::type PendingScriptList;
+    }
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     ResourceGroupManager::ResourceGroupManager()
-        : mLoadingListener(0), mCurrentGroup(0)
+        : mLoadingListener(0), mCurrentGroup(0), mNumWorkerThreads(0)
     {
         // Create the 'General' group
         createResourceGroup(DEFAULT_RESOURCE_GROUP_NAME, true); // the "General" group is synonymous to global pool
@@ -160,6 +176,9 @@ namespace Ogre {
     void ResourceGroupManager::prepareResourceGroup(const String& name, 
         bool prepareMainResources, bool prepareWorldGeom)
     {
+        if (prepareMainResources)
+            prepareResourceGroupConcurrently(name);
+
         // Can only bulk-load one group at a time (reasonable limitation I think)
         OGRE_LOCK_AUTO_MUTEX;
 
@@ -257,6 +276,10 @@ namespace Ogre {
     void ResourceGroupManager::loadResourceGroup(const String& name, 
         bool loadMainResources, bool loadWorldGeom)
     {
+        // Do the I/O and decoding up front, the loop below then only uploads
+        if (loadMainResources)
+            prepareResourceGroupConcurrently(name);
+
         // Can only bulk-load one group at a time (reasonable limitation I think)
         OGRE_LOCK_AUTO_MUTEX;
 
@@ -354,6 +377,98 @@ namespace Ogre {
         LogManager::getSingleton().logMessage("Finished loading resource group " + name);
     }
     //-----------------------------------------------------------------------
+#if OGRE_THREAD_SUPPORT
+    namespace
+    {
+        struct ConcurrentPrepareRequest
+        {
+            ConcurrentPrepareRequest() : nextResource(0) {}
+
+            vector<ResourcePtr>::type resources;
+            AtomicScalar<size_t> nextResource;
+        };
+
+        unsigned long resourcePrepareThread(ThreadHandle* threadHandle)
+        {
+            ConcurrentPrepareRequest* request =
+                static_cast<ConcurrentPrepareRequest*>(threadHandle->getUserParam());
+            const size_t numResources = request->resources.size();
+            for (;;)
+            {
+                // Hand out in order, dependencies come first in the list
+                size_t i = ++request->nextResource - 1;
+                if (i >= numResources)
+                    break;
+
+                try
+                {
+                    request->resources[i]->prepare();
+                }
+                catch (...)
+                {
+                    // The resource is unloaded again, the serial pass retries
+                    // it and reports the error on the calling thread
+                }
+            }
+            return 0;
+        }
+        THREAD_DECLARE(resourcePrepareThread)
+    }
+#endif
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::prepareResourceGroupConcurrently(const String& name)
+    {
+#if OGRE_THREAD_SUPPORT
+        if (!mNumWorkerThreads)
+            return;
+
+        ConcurrentPrepareRequest request;
+        {
+            OGRE_LOCK_AUTO_MUTEX;
+            ResourceGroup* grp = getResourceGroup(name);
+            if (!grp)
+                return; // the caller reports it
+
+            OGRE_LOCK_MUTEX(grp->OGRE_AUTO_MUTEX_NAME);
+            // The map is sorted by loading order, i.e. dependencies first
+            ResourceGroup::LoadResourceOrderMap::iterator oi;
+            for (oi = grp->loadResourceOrderMap.begin(); 
+                oi != grp->loadResourceOrderMap.end(); ++oi)
+            {
+                for (LoadUnloadResourceList::iterator l = oi->second.begin();
+                    l != oi->second.end(); ++l)
+                {
+                    // Background loaded ones are left to their queue
+                    if ((*l)->getLoadingState() == Resource::LOADSTATE_UNLOADED &&
+                        !(*l)->isBackgroundLoaded())
+                    {
+                        request.resources.push_back(*l);
+                    }
+                }
+            }
+        }
+
+        const size_t numThreads = std::min(mNumWorkerThreads, request.resources.size());
+        if (numThreads < 2)
+            return; // nothing to gain over the serial pass
+
+        LogManager::getSingleton().stream()
+            << "Preparing " << request.resources.size() << " resources of group '"
+            << name << "' on " << numThreads << " threads";
+
+        // The group must not be locked meanwhile, workers open their streams
+        // through this class
+        ThreadHandleVec threads;
+        threads.reserve(numThreads);
+        for (size_t i = 0; i < numThreads; ++i)
+        {
+            threads.push_back(
+                Threads::CreateThread(THREAD_GET(resourcePrepareThread), i, &request));
+        }
+        Threads::WaitForThreads(threads);
+#endif
+    }
+    //-----------------------------------------------------------------------
     void ResourceGroupManager::unloadResourceGroup(const String& name, bool reloadableOnly)
     {
         // Can only bulk-unload one group at a time (reasonable limitation I think)
@@ -1018,42 +1133,69 @@ namespace Ogre {
             slfli != scriptLoaderFileList.end(); ++slfli)
         {
             ScriptLoader* su = slfli->first;
-            // Iterate over each list
+            // Flatten the lists, the scripts are handled in batches below
+            vector<const FileInfo*>::type files;
             for (FileListList::iterator flli = slfli->second->begin(); flli != slfli->second->end(); ++flli)
             {
-                // Iterate over each item in the list
                 for (FileInfoList::iterator fii = (*flli)->begin(); fii != (*flli)->end(); ++fii)
+                    files.push_back(&*fii);
+            }
+
+            // With worker threads, a window of scripts is kept open ahead of the one
+            // being parsed so the loader can prepare them concurrently. Without, the
+            // window is a single script.
+            const bool prepare = mNumWorkerThreads > 1;
+            const size_t window = prepare ? mNumWorkerThreads * SCRIPTS_PER_WORKER_THREAD : 1;
+            if (prepare)
+                su->beginPreparingScripts(grp->name, mNumWorkerThreads);
+            try
+            {
+                PendingScriptList pending;
+                for (size_t i = 0; i <= files.size(); ++i)
                 {
-                    bool skipScript = false;
-                    fireScriptStarted(fii->filename, skipScript);
-                    if(skipScript)
+                    if (i < files.size())
                     {
-                        LogManager::getSingleton().logMessage(
-                            "Skipping script " + fii->filename);
-                    }
-                    else
-                    {
-                        LogManager::getSingleton().logMessage(
-                            "Parsing script " + fii->filename);
-                        DataStreamPtr stream = fii->archive->open(fii->filename);
-                        if (!stream.isNull())
+                        // Ask the listeners first, skipped scripts are never opened
+                        PendingScript script;
+                        script.file = files[i];
+                        script.skipped = false;
+                        fireScriptStarted(script.file->filename, script.skipped);
+                        if(script.skipped)
+                        {
+                            LogManager::getSingleton().logMessage(
+                                "Skipping script " + script.file->filename);
+                        }
+                        else
                         {
-                            if (mLoadingListener)
-                                mLoadingListener->resourceStreamOpened(fii->filename, grp->name, 0, stream);
-
-                            if(fii->archive->getType() == "FileSystem" && stream->size() <= 1024 * 1024)
-                            {
-                                DataStreamPtr cachedCopy;
-                                cachedCopy.bind(OGRE_NEW MemoryDataStream(stream->getName(), stream));
-                                su->parseScript(cachedCopy, grp->name);
-                            }
-                            else
-                                su->parseScript(stream, grp->name);
+                            LogManager::getSingleton().logMessage(
+                                "Parsing script " + script.file->filename);
+                            script.stream = openResourceGroupScript(*script.file, grp);
+                            if (prepare && !script.stream.isNull())
+                                su->prepareScript(script.stream, grp->name);
                         }
+                        pending.push_back(script);
+                    }
+
+                    // Parse in the original order, once the window is full or
+                    // there are no more scripts to open
+                    while (!pending.empty() && (pending.size() >= window || i == files.size()))
+                    {
+                        PendingScript& script = pending.front();
+                        if (!script.stream.isNull())
+                            su->parseScript(script.stream, grp->name);
+                        fireScriptEnded(script.file->filename, script.skipped);
+                        pending.pop_front();
                     }
-                    fireScriptEnded(fii->filename, skipScript);
                 }
             }
+            catch (...)
+            {
+                if (prepare)
+                    su->endPreparingScripts();
+                throw;
+            }
+            if (prepare)
+                su->endPreparingScripts();
         }
 
         fireResourceGroupScriptingEnded(grp->name);
@@ -1061,6 +1203,24 @@ namespace Ogre {
             "Finished parsing scripts for resource group " + grp->name);
     }
     //-----------------------------------------------------------------------
+    DataStreamPtr ResourceGroupManager::openResourceGroupScript(const FileInfo& file, ResourceGroup* grp) const
+    {
+        DataStreamPtr stream = file.archive->open(file.filename);
+        if (!stream.isNull())
+        {
+            if (mLoadingListener)
+                mLoadingListener->resourceStreamOpened(file.filename, grp->name, 0, stream);
+
+            if(file.archive->getType() == "FileSystem" && stream->size() <= 1024 * 1024)
+            {
+                DataStreamPtr cachedCopy;
+                cachedCopy.bind(OGRE_NEW MemoryDataStream(stream->getName(), stream));
+                return cachedCopy;
+            }
+        }
+        return stream;
+    }
+    //-----------------------------------------------------------------------
     void ResourceGroupManager::createDeclaredResources(ResourceGroup* grp)
     {
 
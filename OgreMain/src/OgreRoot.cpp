@@ -51,6 +51,7 @@ THE SOFTWARE.
 #include "OgreFileSystem.h"
 #include "OgreShadowVolumeExtrudeProgram.h"
 #include "OgreResourceBackgroundQueue.h"
+#include "OgreTextureStreamer.h"
 #include "OgreEntity.h"
 #include "OgreBillboardSet.h"
 #include "OgreBillboardChain.h"
@@ -64,6 +65,7 @@ THE SOFTWARE.
 #include "OgreFrameListener.h"
 #include "OgreLodStrategyManager.h"
 #include "Threading/OgreDefaultWorkQueue.h"
+#include "Threading/OgreWorkStealingQueue.h"
 
 #if OGRE_NO_FREEIMAGE == 0
 #include "OgreFreeImageCodec.h"
@@ -167,7 +169,11 @@ namespace Ogre {
         mResourceGroupManager = OGRE_NEW ResourceGroupManager();
 
         // WorkQueue (note: users can replace this if they want)
-        DefaultWorkQueue* defaultQ = OGRE_NEW DefaultWorkQueue("Root");
+#if OGRE_WORKQUEUE_STEALING
+        DefaultWorkQueueBase* defaultQ = OGRE_NEW WorkStealingQueue("Root");
+#else
+        DefaultWorkQueueBase* defaultQ = OGRE_NEW DefaultWorkQueue("Root");
+#endif
         // never process responses in main thread for longer than 10ms by default
         defaultQ->setResponseProcessingTimeLimit(10);
         // match threads to hardware
@@ -188,6 +194,9 @@ namespace Ogre {
         // ResourceBackgroundQueue
         mResourceBackgroundQueue = OGRE_NEW ResourceBackgroundQueue();
 
+        // TextureStreamer
+        mTextureStreamer = OGRE_NEW TextureStreamer();
+
         // Create SceneManager enumerator (note - will be managed by singleton)
         mSceneManagerEnum = OGRE_NEW SceneManagerEnumerator();
 
@@ -338,6 +347,7 @@ namespace Ogre {
         unloadPlugins();
         OGRE_DELETE mMaterialManager;
         Pass::processPendingPassUpdates(); // make sure passes are cleaned
+        OGRE_DELETE mTextureStreamer;
         OGRE_DELETE mResourceBackgroundQueue;
         OGRE_DELETE mResourceGroupManager;
 
@@ -888,9 +898,16 @@ namespace Ogre {
             }
         }
 
-        // Tell buffer manager to free temp buffers used this frame
+        // Tell buffer manager to free temp buffers used this frame, and to
+        // fence what was streamed so it can be reused once the GPU is done
         if (HardwareBufferManager::getSingletonPtr())
+        {
             HardwareBufferManager::getSingleton()._releaseBufferCopies();
+            HardwareBufferManager::getSingleton()._endStreamingFrame();
+        }
+
+        // Stream texture levels according to what was rendered this frame
+        mTextureStreamer->_update();
 
         // Tell the queue to process responses
         mWorkQueue->processResponses();
@@ -1034,6 +1051,7 @@ namespace Ogre {
         // Since background thread might be access resources,
         // ensure shutdown before destroying resource manager.
         mResourceBackgroundQueue->shutdown();
+        mTextureStreamer->shutdown();
         mWorkQueue->shutdown();
 
         SceneManagerEnumerator::getSingleton().shutdownAll();
@@ -1422,6 +1440,7 @@ namespace Ogre {
         {
             // Background loader
             mResourceBackgroundQueue->initialise();
+            mTextureStreamer->initialise();
             mWorkQueue->startup();
             // Initialise material manager
             mMaterialManager->initialise();
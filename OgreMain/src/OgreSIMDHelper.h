@@ -75,6 +75,9 @@ THE SOFTWARE.
 // We don't support gcc 3.x anymore anyway, although that had SSE it was a bit flaky?
 #include <xmmintrin.h>
 
+#if __OGRE_HAVE_SSE2
+#include <emmintrin.h>
+#endif
 
 #endif // OGRE_DOUBLE_PRECISION == 0 && OGRE_CPU == OGRE_CPU_X86
 
@@ -64,6 +64,9 @@ THE SOFTWARE.
 #include "OgreLodListener.h"
 #include "OgreInstancedGeometry.h"
 #include "OgreUnifiedHighLevelGpuProgram.h"
+#include "OgreTransformStorage.h"
+#include "OgreOptimisedUtil.h"
+#include "Threading/OgreBarrier.h"
 
 // This class implements the most basic scene manager
 
@@ -104,6 +107,7 @@ mFogDensity(0),
 mSpecialCaseQueueMode(SCRQM_EXCLUDE),
 mWorldGeometryRenderQueue(RENDER_QUEUE_WORLD_GEOMETRY_1),
 mLastFrameNumber(0),
+mMultiDrawRenderables(0),
 mResetIdentityView(false),
 mResetIdentityProj(false),
 mNormaliseNormalsOnScale(true),
@@ -151,7 +155,19 @@ mCameraRelativeRendering(false),
 mLastLightHash(0),
 mLastLightLimit(0),
 mLastLightHashGpuProgram(0),
-mGpuParamsDirty((uint16)GPV_ALL)
+mGpuParamsDirty((uint16)GPV_ALL),
+mNumWorkerThreads(0),
+mWorkerThreadsBarrier(0),
+mExitWorkerThreads(false),
+mRequestType(UPDATE_SCENE_GRAPH),
+mParallelUpdateDepth(1),
+mTransformStorage(0),
+mBatchedCulling(false),
+mCullingBoxes(0),
+mCullingBoxesCapacity(0),
+mNumCullingPlanes(0),
+mParallelAnimation(false),
+mAnimationCandidatesFrame(std::numeric_limits<unsigned long>::max())
 {
 
     // init sky
@@ -187,6 +203,8 @@ mGpuParamsDirty((uint16)GPV_ALL)
 //-----------------------------------------------------------------------
 SceneManager::~SceneManager()
 {
+    stopWorkerThreads();
+
     fireSceneManagerDestroyed();
     destroyShadowTextures();
     clearScene();
@@ -207,6 +225,8 @@ SceneManager::~SceneManager()
 
     OGRE_DELETE mShadowCasterQueryListener;
     OGRE_DELETE mSceneRoot;
+    OGRE_DELETE mTransformStorage;
+    OGRE_FREE_SIMD(mCullingBoxes, MEMCATEGORY_SCENE_CONTROL);
     OGRE_DELETE mFullScreenQuad;
     OGRE_DELETE mShadowCasterSphereQuery;
     OGRE_DELETE mShadowCasterAABBQuery;
@@ -343,7 +363,8 @@ void SceneManager::destroyCamera(const String& name)
             mShadowCamLightMapping.erase( camLightIt );
 
         // Notify render system
-        mDestRenderSystem->_notifyCameraRemoved(i->second);
+        if (mDestRenderSystem)
+            mDestRenderSystem->_notifyCameraRemoved(i->second);
         OGRE_DELETE i->second;
         mCameras.erase(i);
     }
@@ -1433,6 +1454,12 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
             camera->_autoTrack();
         }
 
+        if (mFindVisibleObjects)
+        {
+            OgreProfileGroup("_updateAnimations", OGREPROF_GENERAL);
+            _updateAnimations(camera);
+        }
+
         if (mIlluminationStage != IRS_RENDER_TO_TEXTURE && mFindVisibleObjects)
         {
             // Locate any lights which could be affecting the frustum
@@ -1583,6 +1610,9 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
     // Notify camera of vis batches
     camera->_notifyRenderedBatches(mDestRenderSystem->_getBatchCount());
 
+    // Notify camera of uploaded shader constants
+    camera->_notifyUploadedConstantBytes(mDestRenderSystem->_getConstantBytesCount());
+
     Root::getSingleton()._popCurrentSceneManager(this);
 }
 //-----------------------------------------------------------------------
@@ -2285,24 +2315,322 @@ void SceneManager::_updateSceneGraph(Camera* cam)
     // Process queued needUpdate calls 
     Node::processQueuedUpdates();
 
-    // Cascade down the graph updating transforms & world bounds
-    // In this implementation, just update from the root
-    // Smarter SceneManager subclasses may choose to update only
-    //   certain scene graph branches
-    getRootSceneNode()->_update(true, false);
+    // Derive the transforms of all moved nodes in bulk, the traversal
+    // below then only fetches them
+    if (mTransformStorage)
+        mTransformStorage->update();
+
+    if (mNumWorkerThreads && mParallelUpdateDepth && isParallelUpdateSafe())
+    {
+        updateSceneGraphParallel();
+    }
+    else
+    {
+        // Cascade down the graph updating transforms & world bounds
+        // In this implementation, just update from the root
+        // Smarter SceneManager subclasses may choose to update only
+        //   certain scene graph branches
+        getRootSceneNode()->_update(true, false);
+    }
 
     firePostUpdateSceneGraph(cam);
 }
 //-----------------------------------------------------------------------
+void SceneManager::updateSceneGraphParallel(void)
+{
+    mDeferredSubtrees.clear();
+    mPendingBoundsNodes.clear();
+
+    // Update the top of the graph, collecting the subtrees below the split
+    getRootSceneNode()->_updateSplit(mParallelUpdateDepth, false,
+        mDeferredSubtrees, mPendingBoundsNodes);
+
+    if (!mDeferredSubtrees.empty())
+    {
+        mRequestType = UPDATE_SCENE_GRAPH;
+        fireWorkerThreadsAndWait();
+    }
+
+    // Nodes were collected parent first, so walk backwards to merge
+    // the bounds of every child before those of its parent
+    SceneNode::SceneNodeList::reverse_iterator it, itend;
+    itend = mPendingBoundsNodes.rend();
+    for (it = mPendingBoundsNodes.rbegin(); it != itend; ++it)
+    {
+        (*it)->_updateBounds();
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::updateSceneGraphThread(size_t threadIdx)
+{
+    // Interleave the subtrees so neighbouring (often similar) subtrees
+    // end up on different threads
+    const size_t numSubtrees = mDeferredSubtrees.size();
+    for (size_t i = threadIdx; i < numSubtrees; i += mNumWorkerThreads)
+    {
+        const SceneNode::DeferredUpdate& update = mDeferredSubtrees[i];
+        update.node->_update(true, update.parentHasChanged);
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::_updateAnimations(Camera* cam)
+{
+    if (!mNumWorkerThreads || !mParallelAnimation)
+        return;
+
+    // Scanning all entities is only done once per frame, not once per camera
+    const unsigned long frame = Root::getSingleton().getNextFrameNumber();
+    if (mAnimationCandidatesFrame != frame)
+    {
+        mAnimationCandidates.clear();
+        collectAnimationCandidates();
+        mAnimationCandidatesFrame = frame;
+    }
+
+    mAnimatedEntities.clear();
+    vector<Entity*>::type::iterator c, cend = mAnimationCandidates.end();
+    for (c = mAnimationCandidates.begin(); c != cend; ++c)
+    {
+        Entity* entity = *c;
+        // Same test as SceneNode::_findVisibleObjects, so that only the
+        // entities which are about to be rendered get animated
+        if (entity->isInScene() && !entity->isParentTagPoint() && entity->isVisible() &&
+            cam->isVisible(entity->getWorldBoundingBox(true)) &&
+            entity->_beginConcurrentAnimation())
+        {
+            mAnimatedEntities.push_back(entity);
+        }
+    }
+
+    if (mAnimatedEntities.empty())
+        return;
+
+    mRequestType = UPDATE_BONE_MATRICES;
+    fireWorkerThreadsAndWait();
+
+    // Buffers can only be locked on the rendering thread
+    mSoftwareSkinningJobs.clear();
+    vector<Entity*>::type::iterator e, eend = mAnimatedEntities.end();
+    for (e = mAnimatedEntities.begin(); e != eend; ++e)
+    {
+        (*e)->_prepareSoftwareSkinning(mSoftwareSkinningJobs, mLockedSkinningBuffers);
+    }
+
+    if (!mSoftwareSkinningJobs.empty())
+    {
+        // Split large meshes so that a single character does not end up on one thread
+        static const size_t VERTICES_PER_RANGE = 2048;
+        mSoftwareSkinningRanges.clear();
+        for (size_t job = 0; job < mSoftwareSkinningJobs.size(); ++job)
+        {
+            const size_t vertexCount = mSoftwareSkinningJobs[job].vertexCount;
+            for (size_t start = 0; start < vertexCount; start += VERTICES_PER_RANGE)
+            {
+                SoftwareSkinningRange range;
+                range.job = job;
+                range.start = start;
+                range.count = std::min(VERTICES_PER_RANGE, vertexCount - start);
+                mSoftwareSkinningRanges.push_back(range);
+            }
+        }
+
+        mRequestType = APPLY_SOFTWARE_SKINNING;
+        fireWorkerThreadsAndWait();
+
+        Mesh::_unlockVertexBlendBuffers(mLockedSkinningBuffers);
+    }
+
+    for (e = mAnimatedEntities.begin(); e != eend; ++e)
+    {
+        (*e)->_finishConcurrentAnimation();
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::collectAnimationCandidates(void)
+{
+    MovableObjectCollection* entities =
+        getMovableObjectCollection(EntityFactory::FACTORY_TYPE_NAME);
+    OGRE_LOCK_MUTEX(entities->mutex);
+
+    MovableObjectMap::iterator i, iend;
+    iend = entities->map.end();
+    for (i = entities->map.begin(); i != iend; ++i)
+    {
+        Entity* entity = static_cast<Entity*>(i->second);
+        if (entity->hasSkeleton())
+            mAnimationCandidates.push_back(entity);
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::updateBoneMatricesThread(size_t threadIdx)
+{
+    const size_t numEntities = mAnimatedEntities.size();
+    for (size_t i = threadIdx; i < numEntities; i += mNumWorkerThreads)
+    {
+        mAnimatedEntities[i]->_updateBoneMatricesConcurrent();
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::applySoftwareSkinningThread(size_t threadIdx)
+{
+    const size_t numRanges = mSoftwareSkinningRanges.size();
+    for (size_t i = threadIdx; i < numRanges; i += mNumWorkerThreads)
+    {
+        const SoftwareSkinningRange& range = mSoftwareSkinningRanges[i];
+        Mesh::_applySoftwareVertexBlend(mSoftwareSkinningJobs[range.job],
+            range.start, range.count);
+    }
+}
+//-----------------------------------------------------------------------
 void SceneManager::_findVisibleObjects(
     Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
 {
+    if (mBatchedCulling)
+    {
+        findVisibleObjectsBatched(cam, visibleBounds, onlyShadowCasters);
+        return;
+    }
+
     // Tell nodes to find, cascade down all nodes
     getRootSceneNode()->_findVisibleObjects(cam, getRenderQueue(), visibleBounds, true, 
         mDisplayNodes, onlyShadowCasters);
 
 }
 //-----------------------------------------------------------------------
+namespace
+{
+    /// Below this many boxes per worker thread, batched culling stays on the calling thread
+    const size_t MIN_BOXES_PER_CULLING_THREAD = 512;
+
+    bool hasNothingToRender(const SceneNode* node)
+    {
+        return !node->numAttachedObjects() && !node->getShowBoundingBox();
+    }
+}
+//-----------------------------------------------------------------------
+void SceneManager::findVisibleObjectsBatched(
+    Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
+{
+    // Gather the nodes which may add something to the queue
+    mCullingNodes.clear();
+    mCullingSpecialBoxes.clear();
+    mCullingNodes.push_back(getRootSceneNode());
+    for (size_t i = 0; i < mCullingNodes.size(); ++i)
+    {
+        Node::ChildNodeIterator it = mCullingNodes[i]->getChildIterator();
+        while (it.hasMoreElements())
+            mCullingNodes.push_back(static_cast<SceneNode*>(it.getNext()));
+    }
+    if (!mDisplayNodes && !mShowBoundingBoxes)
+    {
+        SceneNode::SceneNodeList::iterator end = std::remove_if(
+            mCullingNodes.begin(), mCullingNodes.end(), hasNothingToRender);
+        mCullingNodes.erase(end, mCullingNodes.end());
+    }
+
+    const size_t numBoxes = mCullingNodes.size();
+    if (numBoxes > mCullingBoxesCapacity)
+    {
+        OGRE_FREE_SIMD(mCullingBoxes, MEMCATEGORY_SCENE_CONTROL);
+        // Keep every array SIMD aligned
+        mCullingBoxesCapacity = (numBoxes * 3 / 2 + 3) & ~size_t(3);
+        mCullingBoxes = static_cast<Real*>(OGRE_MALLOC_SIMD(
+            sizeof(Real) * 6 * mCullingBoxesCapacity, MEMCATEGORY_SCENE_CONTROL));
+    }
+    mCullingResults.resize(numBoxes);
+
+    Real* centreX = mCullingBoxes;
+    Real* centreY = centreX + mCullingBoxesCapacity;
+    Real* centreZ = centreY + mCullingBoxesCapacity;
+    Real* halfX = centreZ + mCullingBoxesCapacity;
+    Real* halfY = halfX + mCullingBoxesCapacity;
+    Real* halfZ = halfY + mCullingBoxesCapacity;
+    for (size_t i = 0; i < numBoxes; ++i)
+    {
+        const AxisAlignedBox& box = mCullingNodes[i]->_getWorldAABB();
+        if (box.isFinite())
+        {
+            const Vector3 centre = box.getCenter();
+            const Vector3 halfSize = box.getHalfSize();
+            centreX[i] = centre.x; centreY[i] = centre.y; centreZ[i] = centre.z;
+            halfX[i] = halfSize.x; halfY[i] = halfSize.y; halfZ[i] = halfSize.z;
+        }
+        else
+        {
+            centreX[i] = centreY[i] = centreZ[i] = 0;
+            halfX[i] = halfY[i] = halfZ[i] = 0;
+            mCullingSpecialBoxes.push_back(i);
+        }
+    }
+
+    // Same planes as Frustum::isVisible, honouring the culling frustum
+    const Frustum* frustum = cam->getCullingFrustum();
+    if (!frustum)
+        frustum = cam;
+    mNumCullingPlanes = 0;
+    for (unsigned short plane = 0; plane < 6; ++plane)
+    {
+        // Skip far plane if infinite view frustum
+        if (plane == FRUSTUM_PLANE_FAR && frustum->getFarClipDistance() == 0)
+            continue;
+        mCullingPlanes[mNumCullingPlanes++] = frustum->getFrustumPlane(plane);
+    }
+
+    if (mNumWorkerThreads && numBoxes >= mNumWorkerThreads * MIN_BOXES_PER_CULLING_THREAD)
+    {
+        mRequestType = CULL_FRUSTUM;
+        fireWorkerThreadsAndWait();
+    }
+    else
+    {
+        OptimisedUtil::getImplementation()->cullAxisAlignedBoxes(
+            mCullingPlanes, mNumCullingPlanes, mCullingBoxes, mCullingBoxesCapacity,
+            numBoxes ? &mCullingResults[0] : 0, numBoxes);
+    }
+
+    // Null boxes are never visible, infinite ones always
+    vector<size_t>::type::const_iterator special, specialEnd = mCullingSpecialBoxes.end();
+    for (special = mCullingSpecialBoxes.begin(); special != specialEnd; ++special)
+    {
+        mCullingResults[*special] = mCullingNodes[*special]->_getWorldAABB().isInfinite();
+    }
+
+    RenderQueue* queue = getRenderQueue();
+    unsigned int numVisible = 0;
+    for (size_t i = 0; i < numBoxes; ++i)
+    {
+        if (mCullingResults[i])
+        {
+            SceneNode* node = mCullingNodes[i];
+            node->_addToRenderQueue(cam, queue, onlyShadowCasters, visibleBounds);
+            if (mDisplayNodes)
+                queue->addRenderable(node->getDebugRenderable());
+            if (!node->getHideBoundingBox() &&
+                (node->getShowBoundingBox() || mShowBoundingBoxes))
+                node->_addBoundingBoxToQueue(queue);
+            ++numVisible;
+        }
+    }
+    cam->_notifyCulledNodes(numVisible, static_cast<unsigned int>(numBoxes - numVisible));
+}
+//-----------------------------------------------------------------------
+void SceneManager::cullFrustumThread(size_t threadIdx)
+{
+    // Contiguous ranges starting on a SIMD boundary
+    const size_t numBoxes = mCullingNodes.size();
+    size_t perThread = (numBoxes + mNumWorkerThreads - 1) / mNumWorkerThreads;
+    perThread = (perThread + 3) & ~size_t(3);
+
+    const size_t first = std::min(threadIdx * perThread, numBoxes);
+    const size_t last = std::min(first + perThread, numBoxes);
+    if (first < last)
+    {
+        OptimisedUtil::getImplementation()->cullAxisAlignedBoxes(
+            mCullingPlanes, mNumCullingPlanes, mCullingBoxes + first, mCullingBoxesCapacity,
+            &mCullingResults[first], last - first);
+    }
+}
+//-----------------------------------------------------------------------
 void SceneManager::_renderVisibleObjects(void)
 {
     RenderQueueInvocationSequence* invocationSequence = 
@@ -2966,13 +3294,47 @@ void SceneManager::SceneMgrQueuedRenderableVisitor::visit(Renderable* r)
     // Give SM a chance to eliminate
     if (targetSceneMgr->validateRenderableForRendering(mUsedPass, r))
     {
+        if (multiDraw && targetSceneMgr->isMultiDrawCandidate(mUsedPass, r))
+        {
+            // Collect for a multi draw call, starting a new one if it doesn't fit
+            if (!mMultiDrawBatch.empty() &&
+                !targetSceneMgr->isMultiDrawCompatible(mUsedPass, mMultiDrawBatch.front(), r, autoLights))
+            {
+                flushMultiDraw();
+            }
+            mMultiDrawBatch.push_back(r);
+            return;
+        }
+
+        flushMultiDraw();
         // Render a single object, this will set up auto params if required
         targetSceneMgr->renderSingleObject(r, mUsedPass, scissoring, autoLights, manualLightList);
     }
 }
 //-----------------------------------------------------------------------
+void SceneManager::SceneMgrQueuedRenderableVisitor::flushMultiDraw(void)
+{
+    if (mMultiDrawBatch.empty())
+        return;
+
+    if (mMultiDrawBatch.size() == 1)
+    {
+        targetSceneMgr->renderSingleObject(mMultiDrawBatch.front(), mUsedPass, scissoring,
+            autoLights, manualLightList);
+    }
+    else
+    {
+        targetSceneMgr->renderMultiDrawObjects(mMultiDrawBatch, mUsedPass, scissoring,
+            autoLights, manualLightList);
+    }
+    mMultiDrawBatch.clear();
+}
+//-----------------------------------------------------------------------
 bool SceneManager::SceneMgrQueuedRenderableVisitor::visit(const Pass* p)
 {
+    // Batches never span passes
+    flushMultiDraw();
+
     // Give SM a chance to eliminate this pass
     if (!targetSceneMgr->validatePassForRendering(p))
         return false;
@@ -2989,6 +3351,8 @@ void SceneManager::SceneMgrQueuedRenderableVisitor::visit(RenderablePass* rp)
     // Skip this one if we're in transparency cast shadows mode & it doesn't
     // Don't need to implement this one in the other visit methods since
     // transparents are never grouped, always sorted
+    flushMultiDraw();
+
     if (transparentShadowCastersMode && 
         !rp->pass->getParent()->getParent()->getTransparencyCastsShadows())
         return;
@@ -3069,6 +3433,7 @@ void SceneManager::renderObjects(const QueuedRenderableCollection& objs,
     mActiveQueuedRenderableVisitor->scissoring = lightScissoringClipping;
     // Use visitor
     objs.acceptVisitor(mActiveQueuedRenderableVisitor, om);
+    mActiveQueuedRenderableVisitor->flushMultiDraw();
 }
 //-----------------------------------------------------------------------
 void SceneManager::_renderQueueGroupObjects(RenderQueueGroup* pGroup, 
@@ -3079,6 +3444,9 @@ void SceneManager::_renderQueueGroupObjects(RenderQueueGroup* pGroup,
         mCurrentViewport->getShadowsEnabled() && 
         !mSuppressShadows && !mSuppressRenderStateChanges;
     
+    mActiveQueuedRenderableVisitor->multiDraw = pGroup->getMultiDrawEnabled() &&
+        mDestRenderSystem->getCapabilities()->hasCapability(RSC_MULTI_DRAW_INDIRECT);
+
     if (doShadows && mShadowTechnique == SHADOWTYPE_STENCIL_ADDITIVE)
     {
         // Additive stencil shadows in use
@@ -3128,7 +3496,7 @@ void SceneManager::_renderQueueGroupObjects(RenderQueueGroup* pGroup,
         renderBasicQueueGroupObjects(pGroup, om);
     }
 
-
+    mActiveQueuedRenderableVisitor->multiDraw = false;
 }
 //-----------------------------------------------------------------------
 void SceneManager::renderBasicQueueGroupObjects(RenderQueueGroup* pGroup, 
@@ -3617,6 +3985,81 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
     OgreProfileEndGPUEvent("Material: " + pass->getParent()->getParent()->getName());
 }
 //-----------------------------------------------------------------------
+void SceneManager::renderMultiDrawObjects(const MultiDrawRenderableList& rends, const Pass* pass,
+                                          bool lightScissoringClipping, bool doLightIteration,
+                                          const LightList* manualLightList)
+{
+    // Set everything up for the first one, _issueRenderOp then draws them all
+    mMultiDrawRenderables = &rends;
+    renderSingleObject(rends.front(), pass, lightScissoringClipping, doLightIteration, manualLightList);
+    mMultiDrawRenderables = 0;
+}
+//-----------------------------------------------------------------------
+bool SceneManager::isMultiDrawCandidate(const Pass* pass, const Renderable* rend) const
+{
+    // Per draw data only reaches GPU programs, and everything which would make
+    // renderSingleObject issue the operation several times or with different
+    // state is left to it
+    if (mSuppressRenderStateChanges || !pass->hasVertexProgram())
+        return false;
+    if (pass->getIteratePerLight() || pass->getPassIterationCount() != 1 ||
+        pass->getLightScissoringEnabled() || pass->getLightClipPlanesEnabled())
+        return false;
+
+    return rend->getNumWorldTransforms() == 1 &&
+        !rend->getUseIdentityView() && !rend->getUseIdentityProjection();
+}
+//-----------------------------------------------------------------------
+bool SceneManager::isMultiDrawCompatible(const Pass* pass, Renderable* first, Renderable* rend,
+                                         bool doLightIteration) const
+{
+    if (first->getPolygonModeOverrideable() != rend->getPolygonModeOverrideable())
+        return false;
+
+    RenderOperation firstOp, op;
+    first->getRenderOperation(firstOp);
+    rend->getRenderOperation(op);
+
+    // Same buffers, only the ranges may differ
+    if (firstOp.operationType != op.operationType || firstOp.useIndexes != op.useIndexes ||
+        firstOp.numberOfInstances > 1 || op.numberOfInstances > 1 ||
+        firstOp.useGlobalInstancingVertexBufferIsAvailable != op.useGlobalInstancingVertexBufferIsAvailable)
+        return false;
+    if (firstOp.vertexData != op.vertexData)
+    {
+        if (!(*firstOp.vertexData->vertexDeclaration == *op.vertexData->vertexDeclaration) ||
+            firstOp.vertexData->vertexBufferBinding->getBindings() !=
+            op.vertexData->vertexBufferBinding->getBindings())
+            return false;
+    }
+    if (firstOp.vertexData->vertexBufferBinding->getHasInstanceData())
+        return false;
+    if (firstOp.useIndexes && firstOp.indexData->indexBuffer != op.indexData->indexBuffer)
+        return false;
+
+    // Culling is flipped per object on negative scale
+    if (mFlipCullingOnNegativeScale)
+    {
+        Matrix4 firstXform, xform;
+        first->getWorldTransforms(&firstXform);
+        rend->getWorldTransforms(&xform);
+        if (firstXform.hasNegativeScale() != xform.hasNegativeScale())
+            return false;
+    }
+
+    // Light parameters are set up once for the whole batch
+    if (doLightIteration)
+    {
+        const LightList& firstLights = first->getLights();
+        const LightList& lights = rend->getLights();
+        if (firstLights.size() != lights.size() ||
+            !std::equal(firstLights.begin(), firstLights.end(), lights.begin()))
+            return false;
+    }
+
+    return true;
+}
+//-----------------------------------------------------------------------
 void SceneManager::setAmbientLight(const ColourValue& colour)
 {
     mAmbientLight = colour;
@@ -6746,7 +7189,9 @@ void SceneManager::destroyInstancedEntity( InstancedEntity *instancedEntity )
 //---------------------------------------------------------------------
 void SceneManager::_addDirtyInstanceManager( InstanceManager *dirtyManager )
 {
+    mDirtyInstanceManagersMutex.lock();
     mDirtyInstanceManagers.push_back( dirtyManager );
+    mDirtyInstanceManagersMutex.unlock();
 }
 //---------------------------------------------------------------------
 void SceneManager::updateDirtyInstanceManagers(void)
@@ -6901,6 +7346,7 @@ MovableObject* SceneManager::createMovableObject(const String& name,
 
         MovableObject* newObj = factory->createInstance(name, this, params);
         objectMap->map[name] = newObj;
+        dirtyAnimationCandidates();
         return newObj;
     }
 
@@ -6932,6 +7378,7 @@ void SceneManager::destroyMovableObject(const String& name, const String& typeNa
         {
             factory->destroyInstance(mi->second);
             objectMap->map.erase(mi);
+            dirtyAnimationCandidates();
         }
     }
 }
@@ -6960,6 +7407,7 @@ void SceneManager::destroyAllMovableObjectsByType(const String& typeName)
             }
         }
         objectMap->map.clear();
+        dirtyAnimationCandidates();
     }
 }
 //---------------------------------------------------------------------
@@ -6993,6 +7441,7 @@ void SceneManager::destroyAllMovableObjects(void)
         }
         coll->map.clear();
     }
+    dirtyAnimationCandidates();
 
 }
 //---------------------------------------------------------------------
@@ -7064,6 +7513,7 @@ void SceneManager::injectMovableObject(MovableObject* m)
             OGRE_LOCK_MUTEX(objectMap->mutex);
 
         objectMap->map[m->getName()] = m;
+        dirtyAnimationCandidates();
     }
 }
 //---------------------------------------------------------------------
@@ -7077,6 +7527,7 @@ void SceneManager::extractMovableObject(const String& name, const String& typeNa
         {
             // no delete
             objectMap->map.erase(mi);
+            dirtyAnimationCandidates();
         }
     }
 
@@ -7094,6 +7545,7 @@ void SceneManager::extractAllMovableObjectsByType(const String& typeName)
             OGRE_LOCK_MUTEX(objectMap->mutex);
         // no deletion
         objectMap->map.clear();
+        dirtyAnimationCandidates();
     }
 }
 //---------------------------------------------------------------------
@@ -7259,6 +7711,118 @@ void SceneManager::_handleLodEvents()
     mEntityMaterialLodChangedEvents.clear();
 }
 //---------------------------------------------------------------------
+void SceneManager::setTransformStorageEnabled(bool enabled)
+{
+    if (enabled == isTransformStorageEnabled())
+        return;
+
+    if (enabled)
+    {
+#if OGRE_NODE_INHERIT_TRANSFORM
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
+            "Transform storage is not supported with OGRE_NODE_INHERIT_TRANSFORM",
+            "SceneManager::setTransformStorageEnabled");
+#endif
+        mTransformStorage = OGRE_NEW TransformStorage();
+        mTransformStorage->_addNode(getRootSceneNode());
+    }
+    else
+    {
+        // Unregisters all nodes, they go back to deriving their own transforms
+        OGRE_DELETE mTransformStorage;
+        mTransformStorage = 0;
+    }
+}
+//---------------------------------------------------------------------
+void SceneManager::setNumWorkerThreads(size_t numThreads)
+{
+    if (numThreads == mNumWorkerThreads)
+        return;
+
+    stopWorkerThreads();
+    mNumWorkerThreads = numThreads;
+    startWorkerThreads();
+}
+//---------------------------------------------------------------------
+namespace
+{
+    unsigned long sceneManagerWorkerThread(ThreadHandle* threadHandle)
+    {
+        SceneManager* sceneManager = static_cast<SceneManager*>(threadHandle->getUserParam());
+        return sceneManager->_updateWorkerThread(threadHandle);
+    }
+    THREAD_DECLARE(sceneManagerWorkerThread)
+}
+//---------------------------------------------------------------------
+void SceneManager::startWorkerThreads(void)
+{
+    if (!mNumWorkerThreads)
+        return;
+
+    mExitWorkerThreads = false;
+    mWorkerThreadsBarrier = OGRE_NEW Barrier(mNumWorkerThreads + 1);
+    mWorkerThreads.reserve(mNumWorkerThreads);
+    for (size_t i = 0; i < mNumWorkerThreads; ++i)
+    {
+        mWorkerThreads.push_back(
+            Threads::CreateThread(THREAD_GET(sceneManagerWorkerThread), i, this));
+    }
+}
+//---------------------------------------------------------------------
+void SceneManager::stopWorkerThreads(void)
+{
+    if (mWorkerThreads.empty())
+        return;
+
+    // Wake the threads up so they see the exit flag
+    mExitWorkerThreads = true;
+    mWorkerThreadsBarrier->sync();
+    Threads::WaitForThreads(mWorkerThreads);
+    mWorkerThreads.clear();
+
+    OGRE_DELETE mWorkerThreadsBarrier;
+    mWorkerThreadsBarrier = 0;
+}
+//---------------------------------------------------------------------
+void SceneManager::fireWorkerThreadsAndWait(void)
+{
+    mWorkerThreadsBarrier->sync(); // Fire the threads
+    mWorkerThreadsBarrier->sync(); // Wait for them to complete
+}
+//---------------------------------------------------------------------
+unsigned long SceneManager::_updateWorkerThread(ThreadHandle* threadHandle)
+{
+    const size_t threadIdx = threadHandle->getThreadIdx();
+    for (;;)
+    {
+        // Only test the exit flag once woken up, stopWorkerThreads may set it
+        // between two requests and then waits for every thread at the barrier
+        mWorkerThreadsBarrier->sync();
+        if (mExitWorkerThreads)
+            break;
+
+        switch (mRequestType)
+        {
+        case UPDATE_SCENE_GRAPH:
+            updateSceneGraphThread(threadIdx);
+            break;
+        case CULL_FRUSTUM:
+            cullFrustumThread(threadIdx);
+            break;
+        case UPDATE_BONE_MATRICES:
+            updateBoneMatricesThread(threadIdx);
+            break;
+        case APPLY_SOFTWARE_SKINNING:
+            applySoftwareSkinningThread(threadIdx);
+            break;
+        }
+
+        mWorkerThreadsBarrier->sync();
+    }
+
+    return 0;
+}
+//---------------------------------------------------------------------
 void SceneManager::setViewMatrix(const Matrix4& m)
 {
     mDestRenderSystem->_setViewMatrix(m);
@@ -7365,6 +7929,41 @@ void SceneManager::updateGpuProgramParameters(const Pass* pass)
 //---------------------------------------------------------------------
 void SceneManager::_issueRenderOp(Renderable* rend, const Pass* pass)
 {
+    if (mMultiDrawRenderables)
+    {
+        // Issue the whole batch set up by renderMultiDrawObjects
+        mMultiDrawOps.clear();
+        mMultiDrawWorldMatrices.clear();
+        MultiDrawRenderableList::const_iterator i, iend = mMultiDrawRenderables->end();
+        for (i = mMultiDrawRenderables->begin(); i != iend; ++i)
+        {
+            if ((*i)->preRender(this, mDestRenderSystem))
+            {
+                mMultiDrawOps.push_back(RenderOperation());
+                mMultiDrawOps.back().srcRenderable = *i;
+                (*i)->getRenderOperation(mMultiDrawOps.back());
+
+                Matrix4 xform;
+                (*i)->getWorldTransforms(&xform);
+                if (mCameraRelativeRendering)
+                    xform.setTrans(xform.getTrans() - mCameraRelativePosition);
+                mMultiDrawWorldMatrices.push_back(xform);
+            }
+        }
+
+        if (!mMultiDrawOps.empty())
+        {
+            if (pass)
+                updateGpuProgramParameters(pass);
+            mDestRenderSystem->_renderMultiDraw(&mMultiDrawOps[0], &mMultiDrawWorldMatrices[0],
+                mMultiDrawOps.size());
+        }
+
+        for (i = mMultiDrawRenderables->begin(); i != iend; ++i)
+            (*i)->postRender(this, mDestRenderSystem);
+        return;
+    }
+
     if(rend->preRender(this, mDestRenderSystem))
     {
         // Finalise GPU parameter bindings
@@ -84,6 +84,55 @@ namespace Ogre {
         _updateBounds();
     }
     //-----------------------------------------------------------------------
+    void SceneNode::_updateSplit(uint16 depth, bool parentHasChanged,
+        DeferredUpdateList& deferredSubtrees, SceneNodeList& pendingBounds)
+    {
+        assert(depth > 0);
+
+        // Same sequence as Node::_update, see there
+        mParentNotified = false;
+
+        if (mNeedParentUpdate || parentHasChanged)
+        {
+            _updateFromParent();
+        }
+
+        pendingBounds.push_back(this);
+
+        DeferredUpdate update;
+        if (mNeedChildUpdate || parentHasChanged)
+        {
+            update.parentHasChanged = true;
+            ChildNodeMap::iterator it, itend;
+            itend = mChildren.end();
+            for (it = mChildren.begin(); it != itend; ++it)
+            {
+                update.node = static_cast<SceneNode*>(it->second);
+                if (depth == 1)
+                    deferredSubtrees.push_back(update);
+                else
+                    update.node->_updateSplit(depth - 1, true, deferredSubtrees, pendingBounds);
+            }
+        }
+        else
+        {
+            update.parentHasChanged = false;
+            ChildUpdateSet::iterator it, itend;
+            itend = mChildrenToUpdate.end();
+            for (it = mChildrenToUpdate.begin(); it != itend; ++it)
+            {
+                update.node = static_cast<SceneNode*>(*it);
+                if (depth == 1)
+                    deferredSubtrees.push_back(update);
+                else
+                    update.node->_updateSplit(depth - 1, false, deferredSubtrees, pendingBounds);
+            }
+        }
+
+        mChildrenToUpdate.clear();
+        mNeedChildUpdate = false;
+    }
+    //-----------------------------------------------------------------------
     void SceneNode::setParent(Node* parent)
     {
         Node::setParent(parent);
@@ -317,6 +366,18 @@ namespace Ogre {
 
     }
 
+    //-----------------------------------------------------------------------
+    void SceneNode::_addToRenderQueue(Camera* cam, RenderQueue* queue,
+        bool onlyShadowCasters, VisibleObjectsBoundsInfo* visibleBounds)
+    {
+        ObjectMap::iterator iobj;
+        ObjectMap::iterator iobjend = mObjectsByName.end();
+        for (iobj = mObjectsByName.begin(); iobj != iobjend; ++iobj)
+        {
+            queue->processVisibleObject(iobj->second, cam, onlyShadowCasters, visibleBounds);
+        }
+    }
+    //-----------------------------------------------------------------------
     Node::DebugRenderable* SceneNode::getDebugRenderable()
     {
         Vector3 hs = mWorldAABB.getHalfSize();
@@ -569,7 +630,7 @@ namespace Ogre {
             origin = _getDerivedPosition();
             break;
         case TS_PARENT:
-            origin = mPosition;
+            origin = *mPosition;
             break;
         case TS_LOCAL:
             origin = Vector3::ZERO;
@@ -32,6 +32,10 @@ THE SOFTWARE.
 #include "OgreScriptTranslator.h"
 #include "OgreLogManager.h"
 #include "OgreResourceGroupManager.h"
+#include "OgreStreamSerialiser.h"
+#include "OgreRoot.h"
+#include "OgreAtomicScalar.h"
+#include "Threading/OgreThreads.h"
 
 namespace Ogre
 {
@@ -282,10 +286,41 @@ namespace Ogre
 
     bool ScriptCompiler::compile(const String &str, const String &source, const String &group)
     {
-        ScriptLexer lexer;
-        ScriptParser parser;
-        ConcreteNodeListPtr nodes = parser.parse(lexer.tokenize(str, source));
-        return compile(nodes, group);
+        return _compileScript(str, source, ConcreteNodeListPtr(), group);
+    }
+
+    bool ScriptCompiler::_compileScript(const String &str, const String &source, const ConcreteNodeListPtr &nodes, const String &group)
+    {
+        resetContext(group);
+
+        // Listeners may intercept the trees and the imports, so trees are only cached without one
+        ScriptCompilerManager *manager = ScriptCompilerManager::getSingletonPtr();
+        bool useCache = manager && !mListener && !manager->getScriptCacheFile().empty();
+
+        AbstractNodeListPtr ast;
+        String tree;
+        if(useCache && manager->_getCachedTree(str, source, group, tree))
+            ast = readCachedTree(tree);
+
+        if(ast.isNull())
+        {
+            ConcreteNodeListPtr cst = nodes;
+            if(cst.isNull() && manager)
+            {
+                cst = manager->_parseScript(str, source);
+            }
+            else if(cst.isNull())
+            {
+                ScriptLexer lexer;
+                ScriptParser parser;
+                cst = parser.parse(lexer.tokenize(str, source));
+            }
+
+            ast = buildTree(cst);
+            if(useCache && mErrors.empty() && writeCachedTree(*ast, tree))
+                manager->_cacheTree(str, source, tree, mImportHashes);
+        }
+        return translateTree(ast);
     }
 
 //  static void logAST(int tabs, const AbstractNodePtr &node)
@@ -341,6 +376,12 @@ namespace Ogre
 //  }
 
     bool ScriptCompiler::compile(const ConcreteNodeListPtr &nodes, const String &group)
+    {
+        resetContext(group);
+        return translateTree(buildTree(nodes));
+    }
+
+    void ScriptCompiler::resetContext(const String &group)
     {
         // Set up the compilation context
         mGroup = group;
@@ -350,7 +391,11 @@ namespace Ogre
 
         // Clear the environment
         mEnv.clear();
+        mImportHashes.clear();
+    }
 
+    AbstractNodeListPtr ScriptCompiler::buildTree(const ConcreteNodeListPtr &nodes)
+    {
         if(mListener)
             mListener->preConversion(this, nodes);
 
@@ -360,6 +405,11 @@ namespace Ogre
         processImports(ast);
         // Process object inheritance
         processObjects(ast.get(), ast);
+        return ast;
+    }
+
+    bool ScriptCompiler::translateTree(const AbstractNodeListPtr &ast)
+    {
         // Process variable expansion
         processVariables(ast.get());
 
@@ -594,10 +644,20 @@ namespace Ogre
             DataStreamPtr stream = ResourceGroupManager::getSingleton().openResource(name, mGroup);
             if(!stream.isNull())
             {
-                ScriptLexer lexer;
-                ScriptTokenListPtr tokens = lexer.tokenize(stream->getAsString(), name);
-                ScriptParser parser;
-                nodes = parser.parse(tokens);
+                String str = stream->getAsString();
+                mImportHashes[name] = std::make_pair(
+                    FastHash(str.data(), static_cast<int>(str.size())), static_cast<uint32>(str.size()));
+                if(ScriptCompilerManager::getSingletonPtr())
+                {
+                    nodes = ScriptCompilerManager::getSingleton()._parseScript(str, name);
+                }
+                else
+                {
+                    ScriptLexer lexer;
+                    ScriptTokenListPtr tokens = lexer.tokenize(str, name);
+                    ScriptParser parser;
+                    nodes = parser.parse(tokens);
+                }
             }
         }
 
@@ -1586,7 +1646,8 @@ namespace Ogre
     }
     //-----------------------------------------------------------------------
     ScriptCompilerManager::ScriptCompilerManager()
-        :mListener(0), OGRE_THREAD_POINTER_INIT(mScriptCompiler)
+        :mListener(0), OGRE_THREAD_POINTER_INIT(mScriptCompiler), mScriptCacheDirty(false),
+        mStopPreparing(false)
     {
             OGRE_LOCK_AUTO_MUTEX;
         mScriptPatterns.push_back("*.program");
@@ -1604,6 +1665,15 @@ namespace Ogre
     //-----------------------------------------------------------------------
     ScriptCompilerManager::~ScriptCompilerManager()
     {
+        endPreparingScripts();
+        try
+        {
+            saveScriptCache();
+        }
+        catch(Exception& e)
+        {
+            LogManager::getSingleton().logMessage("Unable to save the script cache: " + e.getDescription());
+        }
         OGRE_THREAD_POINTER_DELETE(mScriptCompiler);
         OGRE_DELETE mBuiltinTranslatorManager;
     }
@@ -1698,7 +1768,690 @@ namespace Ogre
                     OGRE_LOCK_AUTO_MUTEX;
             OGRE_THREAD_POINTER_GET(mScriptCompiler)->setListener(mListener);
         }
-        OGRE_THREAD_POINTER_GET(mScriptCompiler)->compile(stream->getAsString(), stream->getName(), groupName);
+
+        ConcreteNodeListPtr nodes;
+#if OGRE_THREAD_SUPPORT
+        {
+                    OGRE_LOCK_MUTEX_NAMED(mPrepareMutex, prepareLock);
+            PreparedScriptMap::iterator i = mPreparedScripts.find(stream.get());
+            if(i != mPreparedScripts.end())
+            {
+                while(!i->second.done)
+                    OGRE_THREAD_WAIT(mScriptPreparedSync, mPrepareMutex, prepareLock);
+                nodes = i->second.nodes;
+                mPreparedScripts.erase(i);
+            }
+        }
+#endif
+        OGRE_THREAD_POINTER_GET(mScriptCompiler)->_compileScript(stream->getAsString(), stream->getName(),
+            nodes, groupName);
+    }
+    //-----------------------------------------------------------------------
+#if OGRE_THREAD_SUPPORT
+    namespace
+    {
+        unsigned long scriptPrepareThread(ThreadHandle* threadHandle)
+        {
+            ScriptCompilerManager* manager =
+                static_cast<ScriptCompilerManager*>(threadHandle->getUserParam());
+            return manager->_prepareScriptsThread(threadHandle);
+        }
+        THREAD_DECLARE(scriptPrepareThread)
+    }
+#endif
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::beginPreparingScripts(const String& groupName, size_t numThreads)
+    {
+#if OGRE_THREAD_SUPPORT
+        // Threads left over from a group which failed to end cleanly
+        endPreparingScripts();
+
+        if(numThreads < 2)
+            return;
+
+        mPrepareThreads.reserve(numThreads);
+        for(size_t i = 0; i < numThreads; ++i)
+        {
+            mPrepareThreads.push_back(
+                Threads::CreateThread(THREAD_GET(scriptPrepareThread), i, this));
+        }
+#endif
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::prepareScript(const DataStreamPtr& stream, const String& groupName)
+    {
+#if OGRE_THREAD_SUPPORT
+        if(mPrepareThreads.empty() || stream.isNull())
+            return;
+
+        // Streams are read here, the threads only see the script text
+        String name = stream->getName();
+        String text = stream->getAsString();
+        // Rewind in case parseScript has to read it after all
+        stream->seek(0);
+
+        OGRE_LOCK_MUTEX(mPrepareMutex);
+        PreparedScript& script = mPreparedScripts[stream.get()];
+        script.stream = stream;
+        script.name.swap(name);
+        script.text.swap(text);
+        script.nodes.setNull();
+        script.done = false;
+        mScriptsToPrepare.push_back(stream.get());
+        OGRE_THREAD_NOTIFY_ONE(mScriptQueuedSync);
+#endif
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::endPreparingScripts(void)
+    {
+#if OGRE_THREAD_SUPPORT
+        {
+                    OGRE_LOCK_MUTEX(mPrepareMutex);
+            mStopPreparing = true;
+            OGRE_THREAD_NOTIFY_ALL(mScriptQueuedSync);
+        }
+        Threads::WaitForThreads(mPrepareThreads);
+        mPrepareThreads.clear();
+
+        OGRE_LOCK_MUTEX(mPrepareMutex);
+        // Scripts prepared but never parsed, e.g. because parsing failed
+        mScriptsToPrepare.clear();
+        mPreparedScripts.clear();
+        mStopPreparing = false;
+#endif
+    }
+    //-----------------------------------------------------------------------
+    unsigned long ScriptCompilerManager::_prepareScriptsThread(ThreadHandle* threadHandle)
+    {
+#if OGRE_THREAD_SUPPORT
+        OGRE_LOCK_MUTEX_NAMED(mPrepareMutex, prepareLock);
+        for(;;)
+        {
+            while(mScriptsToPrepare.empty() && !mStopPreparing)
+                OGRE_THREAD_WAIT(mScriptQueuedSync, mPrepareMutex, prepareLock);
+            if(mStopPreparing)
+                break;
+
+            PreparedScript& script = mPreparedScripts[mScriptsToPrepare.front()];
+            mScriptsToPrepare.pop_front();
+
+            // Entries stay put until done is set, parseScript waits for it
+            prepareLock.unlock();
+            ConcreteNodeListPtr nodes;
+            try
+            {
+                nodes = _parseScript(script.text, script.name);
+            }
+            catch(...)
+            {
+                // Left unparsed, parseScript parses it again and reports
+                // the error on the calling thread
+            }
+            prepareLock.lock();
+
+            script.nodes = nodes;
+            script.text.clear();
+            script.done = true;
+            OGRE_THREAD_NOTIFY_ALL(mScriptPreparedSync);
+        }
+#endif
+        return 0;
+    }
+    //-----------------------------------------------------------------------
+    namespace
+    {
+        const uint32 SCRIPT_CACHE_CHUNK_ID = StreamSerialiser::makeIdentifier("SCCH");
+        const uint16 SCRIPT_CACHE_CHUNK_VERSION = 2;
+
+        // Cached node trees are stored as a flat byte string, with all numbers
+        // written as 7 bit varints so the cache does not depend on endianness
+        void writeCachedNumber(String& out, uint32 value)
+        {
+            while(value >= 0x80)
+            {
+                out += static_cast<char>((value & 0x7F) | 0x80);
+                value >>= 7;
+            }
+            out += static_cast<char>(value);
+        }
+
+        void writeCachedString(String& out, const String& str)
+        {
+            writeCachedNumber(out, static_cast<uint32>(str.size()));
+            out.append(str);
+        }
+
+        bool writeCachedNodes(String& out, const ConcreteNodeList& nodes, const String& file)
+        {
+            writeCachedNumber(out, static_cast<uint32>(nodes.size()));
+            for(ConcreteNodeList::const_iterator i = nodes.begin(); i != nodes.end(); ++i)
+            {
+                const ConcreteNode& node = **i;
+                // Only the script name is stored, once for the whole tree
+                if(node.file != file)
+                    return false;
+
+                out += static_cast<char>(node.type);
+                writeCachedNumber(out, node.line);
+                writeCachedString(out, node.token);
+                if(!writeCachedNodes(out, node.children, file))
+                    return false;
+            }
+            return true;
+        }
+
+        /// Reads the numbers and strings of the cached node trees
+        class CachedReader
+        {
+        public:
+            CachedReader(const String& data)
+                :mPos(data.data()), mEnd(data.data() + data.size()) {}
+
+            bool readNumber(uint32& value)
+            {
+                value = 0;
+                for(uint32 shift = 0; shift < 32 && mPos != mEnd; shift += 7)
+                {
+                    unsigned char byte = static_cast<unsigned char>(*mPos++);
+                    value |= static_cast<uint32>(byte & 0x7F) << shift;
+                    if(!(byte & 0x80))
+                        return true;
+                }
+                return false;
+            }
+
+            bool readString(String& str)
+            {
+                uint32 length;
+                if(!readNumber(length) || length > static_cast<size_t>(mEnd - mPos))
+                    return false;
+                str.assign(mPos, length);
+                mPos += length;
+                return true;
+            }
+
+            bool atEnd() const { return mPos == mEnd; }
+        protected:
+            const char* mPos;
+            const char* mEnd;
+        };
+
+        /// Rebuilds the node trees written by writeCachedNodes
+        class CachedNodeReader : public CachedReader
+        {
+        public:
+            CachedNodeReader(const String& data, const String& file)
+                :CachedReader(data), mFile(file) {}
+
+            bool readNodes(ConcreteNodeList& nodes, ConcreteNode* parent)
+            {
+                uint32 count;
+                if(!readNumber(count))
+                    return false;
+
+                for(uint32 i = 0; i < count; ++i)
+                {
+                    ConcreteNodePtr node(OGRE_NEW ConcreteNode());
+                    if(mPos == mEnd)
+                        return false;
+                    node->type = static_cast<ConcreteNodeType>(static_cast<unsigned char>(*mPos++));
+                    if(!readNumber(node->line) || !readString(node->token))
+                        return false;
+                    node->file = mFile;
+                    node->parent = parent;
+                    if(!readNodes(node->children, node.get()))
+                        return false;
+                    nodes.push_back(node);
+                }
+                return true;
+            }
+        private:
+            const String& mFile;
+        };
+
+        /// Writes abstract trees, whose nodes may come from several scripts through imports
+        class CachedTreeWriter
+        {
+        public:
+            CachedTreeWriter(String& out) :mOut(out) {}
+
+            bool writeNodes(const AbstractNodeList& nodes)
+            {
+                writeCachedNumber(mOut, static_cast<uint32>(nodes.size()));
+                for(AbstractNodeList::const_iterator i = nodes.begin(); i != nodes.end(); ++i)
+                {
+                    const AbstractNode* node = (*i).get();
+                    mOut += static_cast<char>(node->type);
+                    writeFile(node->file);
+                    writeCachedNumber(mOut, static_cast<uint32>(node->line));
+                    switch(node->type)
+                    {
+                    case ANT_ATOM:
+                        {
+                            const AtomAbstractNode* atom = static_cast<const AtomAbstractNode*>(node);
+                            writeCachedString(mOut, atom->value);
+                            writeCachedNumber(mOut, atom->id != 0);
+                        }
+                        break;
+                    case ANT_OBJECT:
+                        {
+                            const ObjectAbstractNode* obj = static_cast<const ObjectAbstractNode*>(node);
+                            writeCachedString(mOut, obj->name);
+                            writeCachedString(mOut, obj->cls);
+                            writeCachedNumber(mOut, static_cast<uint32>(obj->bases.size()));
+                            for(vector<String>::type::const_iterator j = obj->bases.begin(); j != obj->bases.end(); ++j)
+                                writeCachedString(mOut, *j);
+                            writeCachedNumber(mOut, (obj->abstract ? 1 : 0) | (obj->id != 0 ? 2 : 0));
+                            writeVariables(obj->getVariables());
+                            // The overrides are already part of the children at this point
+                            if(!writeNodes(obj->children) || !writeNodes(obj->values))
+                                return false;
+                        }
+                        break;
+                    case ANT_PROPERTY:
+                        {
+                            const PropertyAbstractNode* prop = static_cast<const PropertyAbstractNode*>(node);
+                            writeCachedString(mOut, prop->name);
+                            writeCachedNumber(mOut, prop->id != 0);
+                            if(!writeNodes(prop->values))
+                                return false;
+                        }
+                        break;
+                    case ANT_VARIABLE_ACCESS:
+                        writeCachedString(mOut, static_cast<const VariableAccessAbstractNode*>(node)->name);
+                        break;
+                    default:
+                        // Imports are resolved before the tree is cached
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            void writeVariables(const map<String,String>::type& vars)
+            {
+                writeCachedNumber(mOut, static_cast<uint32>(vars.size()));
+                for(map<String,String>::type::const_iterator i = vars.begin(); i != vars.end(); ++i)
+                {
+                    writeCachedString(mOut, i->first);
+                    writeCachedString(mOut, i->second);
+                }
+            }
+        private:
+            void writeFile(const String& file)
+            {
+                // Each file name is written once and referred to by index afterwards
+                std::pair<map<String,uint32>::type::iterator, bool> i =
+                    mFiles.insert(std::make_pair(file, static_cast<uint32>(mFiles.size())));
+                if(i.second)
+                {
+                    writeCachedNumber(mOut, 0);
+                    writeCachedString(mOut, file);
+                }
+                else
+                {
+                    writeCachedNumber(mOut, i.first->second + 1);
+                }
+            }
+
+            String& mOut;
+            map<String,uint32>::type mFiles;
+        };
+
+        /// Rebuilds the abstract trees written by CachedTreeWriter
+        class CachedTreeReader : public CachedReader
+        {
+        public:
+            CachedTreeReader(const String& data, const ScriptCompiler::IdMap& ids)
+                :CachedReader(data), mIds(ids) {}
+
+            bool readNodes(AbstractNodeList& nodes, AbstractNode* parent)
+            {
+                uint32 count;
+                if(!readNumber(count))
+                    return false;
+
+                for(uint32 i = 0; i < count; ++i)
+                {
+                    if(mPos == mEnd)
+                        return false;
+                    AbstractNodeType type = static_cast<AbstractNodeType>(static_cast<unsigned char>(*mPos++));
+                    String file;
+                    uint32 line, flags;
+                    if(!readFile(file) || !readNumber(line))
+                        return false;
+
+                    AbstractNodePtr node;
+                    switch(type)
+                    {
+                    case ANT_ATOM:
+                        {
+                            AtomAbstractNode* atom = OGRE_NEW AtomAbstractNode(parent);
+                            node = AbstractNodePtr(atom);
+                            if(!readString(atom->value) || !readNumber(flags) ||
+                                (flags && !readId(atom->value, atom->id)))
+                                return false;
+                        }
+                        break;
+                    case ANT_OBJECT:
+                        {
+                            ObjectAbstractNode* obj = OGRE_NEW ObjectAbstractNode(parent);
+                            node = AbstractNodePtr(obj);
+                            uint32 numBases;
+                            if(!readString(obj->name) || !readString(obj->cls) || !readNumber(numBases))
+                                return false;
+                            for(uint32 j = 0; j < numBases; ++j)
+                            {
+                                obj->bases.push_back(BLANKSTRING);
+                                if(!readString(obj->bases.back()))
+                                    return false;
+                            }
+                            map<String,String>::type vars;
+                            if(!readNumber(flags) || ((flags & 2) && !readId(obj->cls, obj->id)) ||
+                                !readVariables(vars))
+                                return false;
+                            obj->abstract = (flags & 1) != 0;
+                            for(map<String,String>::type::const_iterator j = vars.begin(); j != vars.end(); ++j)
+                                obj->setVariable(j->first, j->second);
+                            if(!readNodes(obj->children, obj) || !readNodes(obj->values, obj))
+                                return false;
+                        }
+                        break;
+                    case ANT_PROPERTY:
+                        {
+                            PropertyAbstractNode* prop = OGRE_NEW PropertyAbstractNode(parent);
+                            node = AbstractNodePtr(prop);
+                            if(!readString(prop->name) || !readNumber(flags) ||
+                                (flags && !readId(prop->name, prop->id)) ||
+                                !readNodes(prop->values, prop))
+                                return false;
+                        }
+                        break;
+                    case ANT_VARIABLE_ACCESS:
+                        {
+                            VariableAccessAbstractNode* var = OGRE_NEW VariableAccessAbstractNode(parent);
+                            node = AbstractNodePtr(var);
+                            if(!readString(var->name))
+                                return false;
+                        }
+                        break;
+                    default:
+                        return false;
+                    }
+                    node->file = file;
+                    node->line = static_cast<int>(line);
+                    nodes.push_back(node);
+                }
+                return true;
+            }
+
+            bool readVariables(map<String,String>::type& vars)
+            {
+                uint32 count;
+                if(!readNumber(count))
+                    return false;
+                for(uint32 i = 0; i < count; ++i)
+                {
+                    String name;
+                    if(!readString(name) || !readString(vars[name]))
+                        return false;
+                }
+                return true;
+            }
+        private:
+            bool readFile(String& file)
+            {
+                uint32 index;
+                if(!readNumber(index))
+                    return false;
+                if(index == 0)
+                {
+                    mFiles.push_back(BLANKSTRING);
+                    if(!readString(mFiles.back()))
+                        return false;
+                    index = static_cast<uint32>(mFiles.size());
+                }
+                if(index > mFiles.size())
+                    return false;
+                file = mFiles[index - 1];
+                return true;
+            }
+
+            bool readId(const String& word, uint32& id)
+            {
+                // Ids are looked up again, custom word ids may differ between runs
+                ScriptCompiler::IdMap::const_iterator i = mIds.find(word);
+                if(i == mIds.end())
+                    return false;
+                id = i->second;
+                return true;
+            }
+
+            const ScriptCompiler::IdMap& mIds;
+            StringVector mFiles;
+        };
+    }
+    //-----------------------------------------------------------------------
+    bool ScriptCompiler::writeCachedTree(const AbstractNodeList &nodes, String &data) const
+    {
+        data.clear();
+        CachedTreeWriter writer(data);
+        writer.writeVariables(mEnv);
+        return writer.writeNodes(nodes);
+    }
+    //-----------------------------------------------------------------------
+    AbstractNodeListPtr ScriptCompiler::readCachedTree(const String &data)
+    {
+        AbstractNodeListPtr nodes(OGRE_NEW_T(AbstractNodeList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+        CachedTreeReader reader(data, mIds);
+        if(reader.readVariables(mEnv) && reader.readNodes(*nodes, 0) && reader.atEnd())
+            return nodes;
+
+        mEnv.clear();
+        return AbstractNodeListPtr();
+    }
+    //-----------------------------------------------------------------------
+    ConcreteNodeListPtr ScriptCompilerManager::_parseScript(const String& str, const String& source)
+    {
+        ConcreteNodeListPtr nodes;
+        uint32 hash = FastHash(str.data(), static_cast<int>(str.size()));
+        uint32 length = static_cast<uint32>(str.size());
+        bool cacheEnabled;
+        String cached;
+        {
+            OGRE_LOCK_MUTEX(mScriptCacheMutex);
+            cacheEnabled = !mScriptCacheFile.empty();
+            CachedScriptMap::const_iterator i = mScriptCache.find(source);
+            if(i != mScriptCache.end() && i->second.hash == hash && i->second.length == length)
+                cached = i->second.nodes;
+        }
+
+        if(!cached.empty())
+        {
+            nodes = ConcreteNodeListPtr(OGRE_NEW_T(ConcreteNodeList, MEMCATEGORY_GENERAL)(), SPFM_DELETE_T);
+            CachedNodeReader reader(cached, source);
+            if(reader.readNodes(*nodes, 0) && reader.atEnd())
+                return nodes;
+        }
+
+        ScriptLexer lexer;
+        ScriptParser parser;
+        nodes = parser.parse(lexer.tokenize(str, source));
+
+        String written;
+        if(cacheEnabled && writeCachedNodes(written, *nodes, source))
+        {
+            OGRE_LOCK_MUTEX(mScriptCacheMutex);
+            CachedScript& entry = mScriptCache[source];
+            if(entry.hash != hash || entry.length != length)
+            {
+                // Anything cached for the old text is stale
+                entry = CachedScript();
+                entry.hash = hash;
+                entry.length = length;
+            }
+            entry.nodes.swap(written);
+            mScriptCacheDirty = true;
+        }
+        return nodes;
+    }
+    //-----------------------------------------------------------------------
+    bool ScriptCompilerManager::_getCachedTree(const String& str, const String& source,
+        const String& group, String& tree)
+    {
+        uint32 hash = FastHash(str.data(), static_cast<int>(str.size()));
+        uint32 length = static_cast<uint32>(str.size());
+        ScriptCompiler::ScriptHashMap imports;
+        {
+            OGRE_LOCK_MUTEX(mScriptCacheMutex);
+            CachedScriptMap::const_iterator i = mScriptCache.find(source);
+            if(i == mScriptCache.end() || i->second.hash != hash || i->second.length != length ||
+                i->second.tree.empty())
+                return false;
+            tree = i->second.tree;
+            imports = i->second.imports;
+        }
+
+        // The tree holds what it took from the imported scripts, so they must be unchanged too
+        for(ScriptCompiler::ScriptHashMap::const_iterator i = imports.begin(); i != imports.end(); ++i)
+        {
+            try
+            {
+                DataStreamPtr stream = ResourceGroupManager::getSingleton().openResource(i->first, group);
+                String text = stream->getAsString();
+                if(FastHash(text.data(), static_cast<int>(text.size())) != i->second.first ||
+                    text.size() != i->second.second)
+                    return false;
+            }
+            catch(Exception&)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::_cacheTree(const String& str, const String& source, const String& tree,
+        const ScriptCompiler::ScriptHashMap& imports)
+    {
+        uint32 hash = FastHash(str.data(), static_cast<int>(str.size()));
+        uint32 length = static_cast<uint32>(str.size());
+
+        OGRE_LOCK_MUTEX(mScriptCacheMutex);
+        CachedScript& entry = mScriptCache[source];
+        if(entry.hash != hash || entry.length != length)
+        {
+            entry = CachedScript();
+            entry.hash = hash;
+            entry.length = length;
+        }
+        entry.tree = tree;
+        entry.imports = imports;
+        mScriptCacheDirty = true;
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::setScriptCacheFile(const String& filename)
+    {
+        OGRE_LOCK_MUTEX(mScriptCacheMutex);
+        mScriptCache.clear();
+        mScriptCacheDirty = false;
+        mScriptCacheFile = filename;
+        if(!mScriptCacheFile.empty())
+            loadScriptCache();
+    }
+    //-----------------------------------------------------------------------
+    const String& ScriptCompilerManager::getScriptCacheFile(void) const
+    {
+        return mScriptCacheFile;
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::loadScriptCache()
+    {
+        DataStreamPtr stream;
+        try
+        {
+            stream = Root::openFileStream(mScriptCacheFile, ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+        }
+        catch(FileNotFoundException&)
+        {
+            // Nothing cached yet
+            return;
+        }
+
+        try
+        {
+            StreamSerialiser ser(stream);
+            const StreamSerialiser::Chunk* chunk = ser.readChunkBegin(SCRIPT_CACHE_CHUNK_ID, SCRIPT_CACHE_CHUNK_VERSION);
+            // Caches written by older versions are rebuilt from scratch
+            if(!chunk || chunk->version != SCRIPT_CACHE_CHUNK_VERSION)
+                return;
+
+            uint32 count;
+            ser.read(&count);
+            for(uint32 i = 0; i < count; ++i)
+            {
+                String name;
+                CachedScript entry;
+                ser.read(&name);
+                ser.read(&entry.hash);
+                ser.read(&entry.length);
+                ser.read(&entry.nodes);
+                ser.read(&entry.tree);
+                uint32 numImports;
+                ser.read(&numImports);
+                for(uint32 j = 0; j < numImports; ++j)
+                {
+                    String import;
+                    std::pair<uint32, uint32> text;
+                    ser.read(&import);
+                    ser.read(&text.first);
+                    ser.read(&text.second);
+                    entry.imports[import] = text;
+                }
+                mScriptCache[name] = entry;
+            }
+            ser.readChunkEnd(SCRIPT_CACHE_CHUNK_ID);
+        }
+        catch(Exception& e)
+        {
+            // A damaged cache only costs a reparse
+            mScriptCache.clear();
+            LogManager::getSingleton().logMessage("Ignoring script cache '" + mScriptCacheFile +
+                "': " + e.getDescription());
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ScriptCompilerManager::saveScriptCache(void)
+    {
+        OGRE_LOCK_MUTEX(mScriptCacheMutex);
+        if(mScriptCacheFile.empty() || !mScriptCacheDirty)
+            return;
+
+        DataStreamPtr stream = Root::createFileStream(mScriptCacheFile,
+            ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true);
+        StreamSerialiser ser(stream);
+        ser.writeChunkBegin(SCRIPT_CACHE_CHUNK_ID, SCRIPT_CACHE_CHUNK_VERSION);
+        uint32 count = static_cast<uint32>(mScriptCache.size());
+        ser.write(&count);
+        for(CachedScriptMap::const_iterator i = mScriptCache.begin(); i != mScriptCache.end(); ++i)
+        {
+            ser.write(&i->first);
+            ser.write(&i->second.hash);
+            ser.write(&i->second.length);
+            ser.write(&i->second.nodes);
+            ser.write(&i->second.tree);
+            uint32 numImports = static_cast<uint32>(i->second.imports.size());
+            ser.write(&numImports);
+            for(ScriptCompiler::ScriptHashMap::const_iterator j = i->second.imports.begin();
+                j != i->second.imports.end(); ++j)
+            {
+                ser.write(&j->first);
+                ser.write(&j->second.first);
+                ser.write(&j->second.second);
+            }
+        }
+        ser.writeChunkEnd(SCRIPT_CACHE_CHUNK_ID);
+        mScriptCacheDirty = false;
     }
 
     //-------------------------------------------------------------------------
@@ -68,15 +68,40 @@ namespace Ogre {
         unload(); 
     }
     //---------------------------------------------------------------------
+    void Skeleton::prepareImpl(void)
+    {
+        mFreshFromDisk =
+            ResourceGroupManager::getSingleton().openResource(
+                mName, mGroup, true, this);
+
+        // fully prebuffer into host RAM, unless the archive already provided
+        // the data in memory (e.g. a memory mapped file)
+        if (!dynamic_cast<MemoryDataStream*>(mFreshFromDisk.get()))
+            mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName, mFreshFromDisk));
+    }
+    //---------------------------------------------------------------------
+    void Skeleton::unprepareImpl(void)
+    {
+        mFreshFromDisk.setNull();
+    }
+    //---------------------------------------------------------------------
     void Skeleton::loadImpl(void)
     {
         SkeletonSerializer serializer;
         LogManager::getSingleton().stream()
             << "Skeleton: Loading " << mName;
 
-        DataStreamPtr stream = 
-            ResourceGroupManager::getSingleton().openResource(
-                mName, mGroup, true, this);
+        // If the only copy is local on the stack, it will be cleaned
+        // up reliably in case of exceptions, etc
+        DataStreamPtr stream(mFreshFromDisk);
+        mFreshFromDisk.setNull();
+
+        if (stream.isNull())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE,
+                "Data doesn't appear to have been prepared in " + mName,
+                "Skeleton::loadImpl");
+        }
 
         serializer.importSkeleton(stream, this);
 
@@ -263,6 +288,20 @@ namespace Ogre {
         }
 
 
+    }
+    //---------------------------------------------------------------------
+    void Skeleton::_buildCachedAnimationData(const AnimationStateSet& animSet) const
+    {
+        ConstEnabledAnimationStateIterator stateIt = 
+            animSet.getEnabledAnimationStateIterator();
+        while (stateIt.hasMoreElements())
+        {
+            Animation* anim = _getAnimationImpl(stateIt.getNext()->getAnimationName());
+            if (anim)
+            {
+                anim->_buildCachedData();
+            }
+        }
     }
     //---------------------------------------------------------------------
     void Skeleton::setBindingPose(void)
@@ -32,6 +32,8 @@ THE SOFTWARE.
 #include "OgreTexture.h"
 #include "OgreException.h"
 #include "OgreTextureManager.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
 
 namespace Ogre {
     const char* Texture::CUBEMAP_SUFFIXES[] = {"_rt", "_lf", "_up", "_dn", "_fr", "_bk"};
@@ -216,12 +218,37 @@ namespace Ogre {
         // The custom mipmaps in the image have priority over everything
         uint32 imageMips = images[0]->getNumMipmaps();
 
+        // Levels built on the CPU when the hardware can't, see below
+        vector<Image>::type generated;
+        ConstImagePtrList generatedPtrs;
+        const ConstImagePtrList* sources = &images;
+
         if(imageMips > 0)
         {
             mNumMipmaps = mNumRequestedMipmaps = images[0]->getNumMipmaps();
             // Disable flag for auto mip generation
             mUsage &= ~TU_AUTOMIPMAP;
         }
+        else if(mNumRequestedMipmaps > 0 && (mUsage & TU_AUTOMIPMAP) && !PixelUtil::isCompressed(mSrcFormat))
+        {
+            RenderSystem* rs = Root::getSingleton().getRenderSystem();
+            if(!rs || !rs->getCapabilities()->hasCapability(RSC_AUTOMIPMAP))
+            {
+                // Generate the mipmaps on the CPU and upload them like custom ones,
+                // rather than leaving it to the render system's software path
+                generated.resize(images.size());
+                for(size_t i = 0; i < images.size(); ++i)
+                {
+                    generated[i] = *images[i];
+                    generated[i].generateMipmaps(mHwGamma);
+                    generatedPtrs.push_back(&generated[i]);
+                }
+                sources = &generatedPtrs;
+                imageMips = std::min(mNumRequestedMipmaps, generated[0].getNumMipmaps());
+                mNumMipmaps = mNumRequestedMipmaps = imageMips;
+                mUsage &= ~TU_AUTOMIPMAP;
+            }
+        }
 
         // Create the texture
         createInternalResources();
@@ -293,12 +320,12 @@ namespace Ogre {
                 if(multiImage)
                 {
                     // Load from multiple images
-                    src = images[i]->getPixelBox(0, mip);
+                    src = (*sources)[i]->getPixelBox(0, mip);
                 }
                 else
                 {
                     // Load from faces of images[0]
-                    src = images[0]->getPixelBox(i, mip);
+                    src = (*sources)[0]->getPixelBox(i, mip);
                 }
     
                 // Sets to treated format in case is difference
@@ -0,0 +1,492 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreTextureStreamer.h"
+#include "OgreTextureManager.h"
+#include "OgreTextureUnitState.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreMovableObject.h"
+#include "OgreCamera.h"
+#include "OgreViewport.h"
+#include "OgreImage.h"
+#include "OgreLogManager.h"
+#include "OgreRoot.h"
+
+namespace Ogre {
+
+    namespace {
+        /// Tells the streamer about every texture a visible object renders with
+        class TextureDemandVisitor : public Renderable::Visitor
+        {
+        public:
+            TextureDemandVisitor(TextureStreamer* streamer, Real pixelSize)
+                : mStreamer(streamer), mPixelSize(pixelSize) {}
+
+            void visit(Renderable* rend, ushort lodIndex, bool isDebug, Any* pAny = 0)
+            {
+                if (isDebug)
+                    return;
+
+                Technique* tech = rend->getTechnique();
+                if (!tech)
+                    return;
+
+                for (unsigned short p = 0; p < tech->getNumPasses(); ++p)
+                {
+                    Pass* pass = tech->getPass(p);
+                    for (unsigned short t = 0; t < pass->getNumTextureUnitStates(); ++t)
+                    {
+                        const TexturePtr& tex = pass->getTextureUnitState(t)->_getTexturePtr();
+                        if (!tex.isNull() && tex->isManuallyLoaded())
+                            mStreamer->_notifyTextureDemand(tex.get(), mPixelSize);
+                    }
+                }
+            }
+
+        private:
+            TextureStreamer* mStreamer;
+            Real mPixelSize;
+        };
+
+        struct LeastRecentlyUsed
+        {
+            template <typename T>
+            bool operator()(const T* a, const T* b) const
+            {
+                return a->lastUsedFrame < b->lastUsedFrame;
+            }
+        };
+    }
+
+    //-----------------------------------------------------------------------
+    template<> TextureStreamer* Singleton<TextureStreamer>::msSingleton = 0;
+    TextureStreamer* TextureStreamer::getSingletonPtr(void)
+    {
+        return msSingleton;
+    }
+    TextureStreamer& TextureStreamer::getSingleton(void)
+    {
+        assert( msSingleton );  return ( *msSingleton );
+    }
+    //-----------------------------------------------------------------------
+    TextureStreamer::TextureStreamer()
+        : mWorkQueueChannel(0)
+        , mMemoryBudget(256 * 1024 * 1024)
+        , mMipTailSize(64)
+        , mFrameCount(1)
+    {
+    }
+    //-----------------------------------------------------------------------
+    TextureStreamer::~TextureStreamer()
+    {
+        shutdown();
+    }
+    //-----------------------------------------------------------------------
+    void TextureStreamer::initialise(void)
+    {
+        WorkQueue* wq = Root::getSingleton().getWorkQueue();
+        mWorkQueueChannel = wq->getChannel("Ogre/TextureStreamer");
+        wq->addResponseHandler(mWorkQueueChannel, this);
+        wq->addRequestHandler(mWorkQueueChannel, this);
+    }
+    //-----------------------------------------------------------------------
+    void TextureStreamer::shutdown(void)
+    {
+        WorkQueue* wq = Root::getSingleton().getWorkQueue();
+        wq->abortRequestsByChannel(mWorkQueueChannel);
+        wq->removeRequestHandler(mWorkQueueChannel, this);
+        wq->removeResponseHandler(mWorkQueueChannel, this);
+
+        mStreamedTextures.clear();
+    }
+    //-----------------------------------------------------------------------
+    TexturePtr TextureStreamer::createStreamedTexture(const String& name, const String& group)
+    {
+        TexturePtr tex = TextureManager::getSingleton().create(name, group, true, this);
+        tex->setTextureType(TEX_TYPE_2D);
+
+        StreamedTexture& st = mStreamedTextures[tex->getHandle()];
+        st.texture = tex;
+        st.streamable = false;
+        st.width = st.height = 0;
+        st.numMipmaps = 0;
+        st.format = PF_UNKNOWN;
+        st.residentMip = st.tailMip = st.demandMip = 0;
+        st.lastUsedFrame = 0;
+        st.pendingRequest = 0;
+        st.pendingMip = 0;
+
+        return tex;
+    }
+    //-----------------------------------------------------------------------
+    void TextureStreamer::removeStreamedTexture(const TexturePtr& texture)
+    {
+        StreamedTextureMap::iterator i = mStreamedTextures.find(texture->getHandle());
+        if (i == mStreamedTextures.end())
+            return;
+
+        // The response, if any, gets dropped since the texture is no longer known
+        if (i->second.pendingRequest)
+            Root::getSingleton().getWorkQueue()->abortRequest(i->second.pendingRequest);
+        mStreamedTextures.erase(i);
+    }
+    //-----------------------------------------------------------------------
+    bool TextureStreamer::isStreamedTexture(const Texture* texture) const
+    {
+        return mStreamedTextures.find(texture->getHandle()) != mStreamedTextures.end();
+    }
+    //-----------------------------------------------------------------------
+    uint8 TextureStreamer::getResidentMip(const TexturePtr& texture) const
+    {
+        StreamedTextureMap::const_iterator i = mStreamedTextures.find(texture->getHandle());
+        if (i == mStreamedTextures.end())
+            return 0;
+        return i->second.residentMip;
+    }
+    //-----------------------------------------------------------------------
+    size_t TextureStreamer::calculateMemory(const StreamedTexture& st, uint8 topMip) const
+    {
+        size_t size = 0;
+        for (uint8 mip = topMip; mip <= st.numMipmaps; ++mip)
+        {
+            size += PixelUtil::getMemorySize(std::max<uint32>(st.width >> mip, 1),
+                std::max<uint32>(st.height >> mip, 1), 1, st.format);
+        }
+        return size;
+    }
+    //-----------------------------------------------------------------------
+    size_t TextureStreamer::getCommittedMemory(const StreamedTexture& st) const
+    {
+        if (!st.texture->isLoaded())
+            return 0;
+        return calculateMemory(st, st.pendingRequest ? st.pendingMip : st.residentMip);
+    }
+    //-----------------------------------------------------------------------
+    size_t TextureStreamer::getResidentMemory(void) const
+    {
+        size_t size = 0;
+        for (StreamedTextureMap::const_iterator i = mStreamedTextures.begin();
+            i != mStreamedTextures.end(); ++i)
+        {
+            if (i->second.texture->isLoaded())
+                size += calculateMemory(i->second, i->second.residentMip);
+        }
+        return size;
+    }
+    //-----------------------------------------------------------------------
+    void TextureStreamer::_notifyTextureDemand(const Texture* texture, Real pixelSize)
+    {
+        StreamedTextureMap::iterator i = mStreamedTextures.find(texture->getHandle());
+        if (i == mStreamedTextures.end())
+            return;
+
+        StreamedTexture& st = i->second;
+        if (!st.streamable)
+            return;
+
+        uint8 mip = 0;
+        Real texels = static_cast<Real>(std::max(st.width, st.height));
+        if (pixelSize < texels)
+        {
+            // Level whose size is the first one not smaller than the object
+            Real level = pixelSize > 0 ? Math::Log2(texels / pixelSize) : st.tailMip;
+            mip = static_cast<uint8>(std::min<Real>(Math::Floor(level), st.tailMip));
+        }
+
+        if (st.lastUsedFrame != mFrameCount || mip < st.demandMip)
+            st.demandMip = mip;
+        st.lastUsedFrame = mFrameCount;
+    }
+    //-----------------------------------------------------------------------
+    void TextureStreamer::_notifyObjectVisible(MovableObject* mo, const Camera* cam)
+    {
+        Viewport* vp = cam->getViewport();
+        if (!vp)
+            return;
+
+        const Sphere& sphere = mo->getWorldBoundingSphere(true);
+        Real viewportHeight = static_cast<Real>(vp->getActualHeight());
+        Real pixelSize;
+        if (cam->getProjectionType() == PT_ORTHOGRAPHIC)
+        {
+            pixelSize = viewportHeight * 2 * sphere.getRadius() / cam->getOrthoWindowHeight();
+        }
+        else
+        {
+            Real distance = cam->getDerivedPosition().distance(sphere.getCenter());
+            if (distance <= sphere.getRadius())
+                pixelSize = Math::POS_INFINITY;
+            else
+                pixelSize = viewportHeight * sphere.getRadius() /
+                    (distance * Math::Tan(cam->getFOVy() * 0.5f));
+        }
+
+        TextureDemandVisitor visitor(this, pixelSize);
+        mo->visitRenderables(&visitor);
+    }
+    //-----------------------------------------------------------------------
+    void TextureStreamer::requestMips(StreamedTexture& st, uint8 topMip)
+    {
+        StreamRequest req;
+        req.handle = st.texture->getHandle();
+        req.name = st.texture->getName();
+        req.group = st.texture->getGroup();
+        req.topMip = topMip;
+        req.image = 0;
+
+        st.pendingMip = topMip;
+        st.pendingRequest = Root::getSingleton().getWorkQueue()->addRequest(
+            mWorkQueueChannel, 0, Any(req));
+    }
+    //-----------------------------------------------------------------------
+    size_t TextureStreamer::evict(size_t committed, size_t target)
+    {
+        typedef vector<StreamedTexture*>::type StreamedTextureList;
+        StreamedTextureList candidates;
+        for (StreamedTextureMap::iterator i = mStreamedTextures.begin();
+            i != mStreamedTextures.end(); ++i)
+        {
+            StreamedTexture& st = i->second;
+            if (!st.streamable || st.pendingRequest || !st.texture->isLoaded())
+                continue;
+            uint8 needed = st.lastUsedFrame == mFrameCount ? st.demandMip : st.tailMip;
+            if (st.residentMip < needed)
+                candidates.push_back(&st);
+        }
+        std::sort(candidates.begin(), candidates.end(), LeastRecentlyUsed());
+
+        for (StreamedTextureList::iterator i = candidates.begin();
+            i != candidates.end() && committed > target; ++i)
+        {
+            StreamedTexture& st = **i;
+            uint8 needed = st.lastUsedFrame == mFrameCount ? st.demandMip : st.tailMip;
+            committed -= calculateMemory(st, st.residentMip) - calculateMemory(st, needed);
+            requestMips(st, needed);
+        }
+        return committed;
+    }
+    //-----------------------------------------------------------------------
+    void TextureStreamer::_update(void)
+    {
+        size_t committed = 0;
+        for (StreamedTextureMap::iterator i = mStreamedTextures.begin();
+            i != mStreamedTextures.end(); ++i)
+        {
+            committed += getCommittedMemory(i->second);
+        }
+
+        if (mMemoryBudget && committed > mMemoryBudget)
+            committed = evict(committed, mMemoryBudget);
+
+        for (StreamedTextureMap::iterator i = mStreamedTextures.begin();
+            i != mStreamedTextures.end(); ++i)
+        {
+            StreamedTexture& st = i->second;
+            if (!st.streamable || st.pendingRequest || !st.texture->isLoaded() ||
+                st.lastUsedFrame != mFrameCount || st.demandMip >= st.residentMip)
+            {
+                continue;
+            }
+
+            // Get as close to the demand as the budget allows
+            size_t resident = calculateMemory(st, st.residentMip);
+            uint8 mip = st.demandMip;
+            for (; mip < st.residentMip; ++mip)
+            {
+                size_t extra = calculateMemory(st, mip) - resident;
+                if (!mMemoryBudget || committed + extra <= mMemoryBudget)
+                    break;
+                if (extra <= mMemoryBudget)
+                    committed = evict(committed, mMemoryBudget - extra);
+                if (committed + extra <= mMemoryBudget)
+                    break;
+            }
+
+            if (mip < st.residentMip)
+            {
+                committed += calculateMemory(st, mip) - resident;
+                requestMips(st, mip);
+            }
+        }
+
+        ++mFrameCount;
+    }
+    //-----------------------------------------------------------------------
+    void TextureStreamer::extractMipChain(const Image& src, uint8 topMip, Image& dest)
+    {
+        PixelBox top = src.getPixelBox(0, topMip);
+        size_t offset = static_cast<const uchar*>(top.data) - src.getData();
+        size_t size = src.getSize() - offset;
+
+        uchar* data = OGRE_ALLOC_T(uchar, size, MEMCATEGORY_GENERAL);
+        memcpy(data, src.getData() + offset, size);
+        dest.loadDynamicImage(data, static_cast<uint32>(top.getWidth()), static_cast<uint32>(top.getHeight()),
+            1, src.getFormat(), true, 1, src.getNumMipmaps() - topMip);
+    }
+    //-----------------------------------------------------------------------
+    void TextureStreamer::applyMips(StreamedTexture& st, const Image& image, uint8 topMip)
+    {
+        Texture* tex = st.texture.get();
+        ResourceManager* creator = tex->getCreator();
+
+        // The size of the resource changes, keep the manager's budget in step
+        if (creator)
+            creator->_notifyResourceUnloaded(tex);
+
+        {
+            OGRE_LOCK_MUTEX(tex->OGRE_AUTO_MUTEX_NAME);
+            ConstImagePtrList imagePtrs;
+            imagePtrs.push_back(&image);
+            tex->freeInternalResources();
+            tex->setNumMipmaps(image.getNumMipmaps());
+            tex->_loadImages(imagePtrs);
+        }
+
+        if (creator)
+            creator->_notifyResourceLoaded(tex);
+
+        st.residentMip = topMip;
+        st.format = tex->getFormat();
+    }
+    //-----------------------------------------------------------------------
+    void TextureStreamer::loadResource(Resource* resource)
+    {
+        Texture* tex = static_cast<Texture*>(resource);
+        StreamedTextureMap::iterator i = mStreamedTextures.find(tex->getHandle());
+        if (i == mStreamedTextures.end())
+        {
+            OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND,
+                "Texture " + tex->getName() + " was not created by the TextureStreamer",
+                "TextureStreamer::loadResource");
+        }
+        StreamedTexture& st = i->second;
+
+        Image image;
+        image.load(tex->getName(), tex->getGroup());
+
+        st.width = image.getWidth();
+        st.height = image.getHeight();
+        st.numMipmaps = static_cast<uint8>(image.getNumMipmaps());
+        st.streamable = st.numMipmaps > 0 && image.getNumFaces() == 1 && image.getDepth() == 1;
+        st.pendingRequest = 0;
+
+        if (!st.streamable)
+        {
+            ConstImagePtrList imagePtrs;
+            imagePtrs.push_back(&image);
+            tex->_loadImages(imagePtrs);
+            st.format = tex->getFormat();
+            st.residentMip = st.tailMip = 0;
+            return;
+        }
+
+        st.tailMip = 0;
+        while (st.tailMip < st.numMipmaps &&
+            std::max(st.width >> st.tailMip, st.height >> st.tailMip) > mMipTailSize)
+        {
+            ++st.tailMip;
+        }
+
+        Image tail;
+        extractMipChain(image, st.tailMip, tail);
+        ConstImagePtrList imagePtrs;
+        imagePtrs.push_back(&tail);
+        tex->setNumMipmaps(tail.getNumMipmaps());
+        tex->_loadImages(imagePtrs);
+
+        st.residentMip = st.demandMip = st.tailMip;
+        st.format = tex->getFormat();
+    }
+    //-----------------------------------------------------------------------
+    bool TextureStreamer::canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+    {
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    WorkQueue::Response* TextureStreamer::handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+    {
+        StreamRequest sreq = any_cast<StreamRequest>(req->getData());
+        if (req->getAborted())
+            return OGRE_NEW WorkQueue::Response(req, true, Any(sreq));
+
+        try
+        {
+            Image image;
+            image.load(sreq.name, sreq.group);
+            if (sreq.topMip > image.getNumMipmaps())
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                    "Texture " + sreq.name + " has fewer mipmaps than when it was loaded",
+                    "TextureStreamer::handleRequest");
+            }
+
+            sreq.image = OGRE_NEW Image();
+            extractMipChain(image, sreq.topMip, *sreq.image);
+        }
+        catch (Exception& e)
+        {
+            OGRE_DELETE sreq.image;
+            sreq.image = 0;
+            return OGRE_NEW WorkQueue::Response(req, false, Any(sreq), e.getFullDescription());
+        }
+
+        return OGRE_NEW WorkQueue::Response(req, true, Any(sreq));
+    }
+    //-----------------------------------------------------------------------
+    bool TextureStreamer::canHandleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
+    {
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void TextureStreamer::handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
+    {
+        StreamRequest sreq = any_cast<StreamRequest>(res->getData());
+
+        StreamedTextureMap::iterator i = mStreamedTextures.find(sreq.handle);
+        if (i != mStreamedTextures.end() && i->second.pendingRequest == res->getRequest()->getID())
+        {
+            StreamedTexture& st = i->second;
+            st.pendingRequest = 0;
+
+            if (!res->succeeded())
+            {
+                LogManager::getSingleton().logMessage(
+                    "TextureStreamer: streaming " + sreq.name + " failed: " + res->getMessages(), LML_CRITICAL);
+                // Stop trying, the file is not going to get any better
+                st.streamable = false;
+            }
+            else if (sreq.image && st.texture->isLoaded())
+            {
+                applyMips(st, *sreq.image, sreq.topMip);
+            }
+        }
+
+        OGRE_DELETE sreq.image;
+    }
+}
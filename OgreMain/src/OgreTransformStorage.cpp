@@ -0,0 +1,618 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreTransformStorage.h"
+#include "OgreNode.h"
+#include "OgrePlatformInformation.h"
+
+// Should keep this include last to avoid potential "xmmintrin.h" included by
+// other header files on some platforms
+#include "OgreSIMDHelper.h"
+
+namespace Ogre {
+
+    namespace
+    {
+        /// Indices of the derived arrays of a level, each holding one Real per slot
+        enum SlotArray
+        {
+            DERIVED_POS_X, DERIVED_POS_Y, DERIVED_POS_Z,
+            DERIVED_ORIENT_W, DERIVED_ORIENT_X, DERIVED_ORIENT_Y, DERIVED_ORIENT_Z,
+            DERIVED_SCALE_X, DERIVED_SCALE_Y, DERIVED_SCALE_Z,
+            // Top three rows of the derived 4x4 transform, row major
+            XFORM_00, XFORM_01, XFORM_02, XFORM_03,
+            XFORM_10, XFORM_11, XFORM_12, XFORM_13,
+            XFORM_20, XFORM_21, XFORM_22, XFORM_23,
+
+            NUM_SLOT_ARRAYS
+        };
+
+        enum SlotFlags
+        {
+            SF_INHERIT_ORIENTATION = 1 << 0,
+            SF_INHERIT_SCALE = 1 << 1,
+            /// Local transform changed since the last update
+            SF_DIRTY = 1 << 2,
+            /// Derived transform was recomputed by the current update
+            SF_CHANGED = 1 << 3
+        };
+
+        /// Slots are processed in blocks of this size
+        const size_t BLOCK_SIZE = 4;
+    }
+    //-----------------------------------------------------------------------
+    struct TransformStorage::Level : public NodeAlloc
+    {
+        /// Number of slots in use
+        size_t size;
+        /// Number of slots allocated, always a multiple of BLOCK_SIZE
+        size_t capacity;
+        /// NUM_SLOT_ARRAYS arrays of capacity Reals each, SIMD aligned
+        Real* data;
+        /** Local transforms, owned by the nodes in the slots which read and
+            write them in place. One SIMD aligned block holding capacity
+            positions, then orientations, then scales.
+        */
+        Real* local;
+        Vector3* positions;
+        Quaternion* orientations;
+        Vector3* scales;
+        /// Index of the parent slot in the level above
+        vector<size_t>::type parents;
+        vector<uint8>::type flags;
+        vector<Node*>::type owners;
+
+        Level() : size(0), capacity(0), data(0), local(0), positions(0), orientations(0), scales(0) {}
+        ~Level()
+        {
+            OGRE_FREE_SIMD(data, MEMCATEGORY_SCENE_CONTROL);
+            OGRE_FREE_SIMD(local, MEMCATEGORY_SCENE_CONTROL);
+        }
+
+        Real* array(size_t which) { return data + which * capacity; }
+        const Real* array(size_t which) const { return data + which * capacity; }
+
+        /// Resets slots to an identity transform without parent
+        void reset(size_t first, size_t last)
+        {
+            std::fill(positions + first, positions + last, Vector3::ZERO);
+            std::fill(orientations + first, orientations + last, Quaternion::IDENTITY);
+            std::fill(scales + first, scales + last, Vector3::UNIT_SCALE);
+            for (size_t a = 0; a < NUM_SLOT_ARRAYS; ++a)
+            {
+                Real value = 0;
+                switch (a)
+                {
+                case DERIVED_ORIENT_W: case DERIVED_SCALE_X: case DERIVED_SCALE_Y: case DERIVED_SCALE_Z:
+                case XFORM_00: case XFORM_11: case XFORM_22:
+                    value = 1;
+                    break;
+                default:
+                    break;
+                }
+                std::fill(array(a) + first, array(a) + last, value);
+            }
+            std::fill(parents.begin() + first, parents.begin() + last, 0);
+            std::fill(flags.begin() + first, flags.begin() + last, 0);
+            std::fill(owners.begin() + first, owners.begin() + last, (Node*)0);
+        }
+
+        void grow(void)
+        {
+            size_t newCapacity = std::max(capacity * 2, BLOCK_SIZE * 4);
+            Real* newData = static_cast<Real*>(OGRE_MALLOC_SIMD(
+                sizeof(Real) * NUM_SLOT_ARRAYS * newCapacity, MEMCATEGORY_SCENE_CONTROL));
+            for (size_t a = 0; a < NUM_SLOT_ARRAYS; ++a)
+            {
+                if (size)
+                    memcpy(newData + a * newCapacity, array(a), sizeof(Real) * size);
+            }
+            OGRE_FREE_SIMD(data, MEMCATEGORY_SCENE_CONTROL);
+            data = newData;
+
+            // Vector3 and Quaternion are plain arrays of Reals, a multiple of
+            // BLOCK_SIZE of them keeps every block SIMD aligned
+            Real* newLocal = static_cast<Real*>(OGRE_MALLOC_SIMD(
+                sizeof(Real) * 10 * newCapacity, MEMCATEGORY_SCENE_CONTROL));
+            Vector3* newPositions = reinterpret_cast<Vector3*>(newLocal);
+            Quaternion* newOrientations = reinterpret_cast<Quaternion*>(newLocal + 3 * newCapacity);
+            Vector3* newScales = reinterpret_cast<Vector3*>(newLocal + 7 * newCapacity);
+            std::copy(positions, positions + size, newPositions);
+            std::copy(orientations, orientations + size, newOrientations);
+            std::copy(scales, scales + size, newScales);
+            OGRE_FREE_SIMD(local, MEMCATEGORY_SCENE_CONTROL);
+            local = newLocal;
+            positions = newPositions;
+            orientations = newOrientations;
+            scales = newScales;
+
+            capacity = newCapacity;
+            parents.resize(capacity);
+            flags.resize(capacity);
+            owners.resize(capacity);
+            reset(size, capacity);
+        }
+
+        /// Copies slot src over slot dest
+        void move(size_t src, size_t dest)
+        {
+            for (size_t a = 0; a < NUM_SLOT_ARRAYS; ++a)
+                array(a)[dest] = array(a)[src];
+            positions[dest] = positions[src];
+            orientations[dest] = orientations[src];
+            scales[dest] = scales[src];
+            parents[dest] = parents[src];
+            flags[dest] = flags[src];
+            owners[dest] = owners[src];
+        }
+    };
+    //-----------------------------------------------------------------------
+    TransformStorage::TransformStorage()
+        : mUpToDate(false)
+        , mUseSSE(false)
+    {
+#if __OGRE_HAVE_SSE
+        mUseSSE = (PlatformInformation::getCpuFeatures() & PlatformInformation::CPU_FEATURE_SSE) != 0;
+#endif
+    }
+    //-----------------------------------------------------------------------
+    TransformStorage::~TransformStorage()
+    {
+        for (LevelList::iterator i = mLevels.begin(); i != mLevels.end(); ++i)
+        {
+            Level* level = *i;
+            // Hand the local transforms back to any remaining nodes
+            for (size_t s = 0; s < level->size; ++s)
+                detachSlot(*level, s);
+            OGRE_DELETE level;
+        }
+        mLevels.clear();
+    }
+    //-----------------------------------------------------------------------
+    void TransformStorage::_addNode(Node* node)
+    {
+        uint16 depth = 0;
+        size_t parentIndex = 0;
+        Node* parent = node->getParent();
+        if (parent)
+        {
+            assert(parent->mTransformStorage == this &&
+                "Parent node must be registered with the same storage");
+            depth = parent->mTransformDepth + 1;
+            parentIndex = parent->mTransformIndex;
+        }
+
+        addSlot(node, depth, parentIndex);
+
+        Node::ChildNodeIterator it = node->getChildIterator();
+        while (it.hasMoreElements())
+        {
+            _addNode(it.getNext());
+        }
+    }
+    //-----------------------------------------------------------------------
+    void TransformStorage::_removeNode(Node* node)
+    {
+        if (node->mTransformStorage != this)
+            return;
+
+        // Children first, so that no slot is left pointing at a removed parent
+        Node::ChildNodeIterator it = node->getChildIterator();
+        while (it.hasMoreElements())
+        {
+            _removeNode(it.getNext());
+        }
+
+        removeSlot(node);
+
+        // Drop empty levels from the bottom
+        while (!mLevels.empty() && mLevels.back()->size == 0)
+        {
+            OGRE_DELETE mLevels.back();
+            mLevels.pop_back();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void TransformStorage::addSlot(Node* node, uint16 depth, size_t parentIndex)
+    {
+        while (mLevels.size() <= depth)
+        {
+            mLevels.push_back(OGRE_NEW Level());
+        }
+
+        Level& level = *mLevels[depth];
+        if (level.size == level.capacity)
+        {
+            level.grow();
+            // Slots moved, so repoint their owners
+            for (size_t s = 0; s < level.size; ++s)
+                attachSlot(level, s);
+        }
+
+        size_t index = level.size++;
+        level.parents[index] = parentIndex;
+        level.owners[index] = node;
+        level.positions[index] = *node->mPosition;
+        level.orientations[index] = *node->mOrientation;
+        level.scales[index] = *node->mScale;
+
+        node->mTransformStorage = this;
+        node->mTransformDepth = depth;
+        node->mTransformIndex = index;
+        attachSlot(level, index);
+
+        _notifyLocalChanged(node);
+    }
+    //-----------------------------------------------------------------------
+    void TransformStorage::removeSlot(Node* node)
+    {
+        Level& level = *mLevels[node->mTransformDepth];
+        size_t index = node->mTransformIndex;
+        size_t last = level.size - 1;
+
+        detachSlot(level, index);
+
+        if (index != last)
+        {
+            // Move the last slot into the gap and repoint its owner and the
+            // children of its owner
+            level.move(last, index);
+            Node* moved = level.owners[index];
+            moved->mTransformIndex = index;
+            attachSlot(level, index);
+
+            Node::ChildNodeIterator it = moved->getChildIterator();
+            while (it.hasMoreElements())
+            {
+                Node* child = it.getNext();
+                if (child->mTransformStorage == this)
+                    mLevels[child->mTransformDepth]->parents[child->mTransformIndex] = index;
+            }
+        }
+
+        level.reset(last, last + 1);
+        --level.size;
+    }
+    //-----------------------------------------------------------------------
+    void TransformStorage::attachSlot(Level& level, size_t index)
+    {
+        Node* node = level.owners[index];
+        node->mPosition = &level.positions[index];
+        node->mOrientation = &level.orientations[index];
+        node->mScale = &level.scales[index];
+    }
+    //-----------------------------------------------------------------------
+    void TransformStorage::detachSlot(Level& level, size_t index)
+    {
+        Node* node = level.owners[index];
+        node->mOwnPosition = level.positions[index];
+        node->mOwnOrientation = level.orientations[index];
+        node->mOwnScale = level.scales[index];
+        node->mPosition = &node->mOwnPosition;
+        node->mOrientation = &node->mOwnOrientation;
+        node->mScale = &node->mOwnScale;
+        node->mTransformStorage = 0;
+    }
+    //-----------------------------------------------------------------------
+    void TransformStorage::_notifyLocalChanged(const Node* node)
+    {
+        // The transform itself is already in place. Only the node's own slot
+        // and an atomic flag are written, so different nodes may be changed
+        // from several threads at once, e.g. by listeners during a parallel
+        // scene graph update.
+        uint8 flags = SF_DIRTY;
+        if (node->getInheritOrientation())
+            flags |= SF_INHERIT_ORIENTATION;
+        if (node->getInheritScale())
+            flags |= SF_INHERIT_SCALE;
+        mLevels[node->mTransformDepth]->flags[node->mTransformIndex] = flags;
+
+        // Avoid bouncing the cache line between threads when already stale
+        if (mUpToDate.get())
+            mUpToDate.set(false);
+    }
+    //-----------------------------------------------------------------------
+    void TransformStorage::update(void)
+    {
+        // Parents always live one level up, so a top-down sweep is enough
+        for (size_t depth = 0; depth < mLevels.size(); ++depth)
+        {
+            updateLevel(static_cast<uint16>(depth));
+        }
+        mUpToDate.set(true);
+    }
+    //-----------------------------------------------------------------------
+    void TransformStorage::updateLevel(uint16 depth)
+    {
+        Level& level = *mLevels[depth];
+        const Level* parentLevel = depth ? mLevels[depth - 1] : 0;
+
+        for (size_t first = 0; first < level.size; first += BLOCK_SIZE)
+        {
+            size_t end = std::min(first + BLOCK_SIZE, level.size);
+            bool blockChanged = false;
+            for (size_t i = first; i < end; ++i)
+            {
+                uint8 flags = level.flags[i];
+                bool changed = (flags & SF_DIRTY) ||
+                    (parentLevel && (parentLevel->flags[level.parents[i]] & SF_CHANGED));
+                flags &= ~(SF_DIRTY | SF_CHANGED);
+                if (changed)
+                    flags |= SF_CHANGED;
+                level.flags[i] = flags;
+                blockChanged |= changed;
+            }
+
+            // Unused slots of the last block hold identity transforms, so
+            // the block can always be processed as a whole
+            if (blockChanged)
+            {
+                if (mUseSSE && parentLevel)
+                    updateBlockSSE(level, parentLevel, first);
+                else
+                    updateBlockGeneral(level, parentLevel, first);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void TransformStorage::updateBlockGeneral(Level& level, const Level* parentLevel, size_t first)
+    {
+        for (size_t i = first; i < first + BLOCK_SIZE; ++i)
+        {
+            Vector3 position = level.positions[i];
+            Quaternion orientation = level.orientations[i];
+            Vector3 scale = level.scales[i];
+
+            if (parentLevel)
+            {
+                // Same sequence of operations as Node::updateFromParentImpl
+                size_t p = level.parents[i];
+                Vector3 parentPosition(parentLevel->array(DERIVED_POS_X)[p],
+                    parentLevel->array(DERIVED_POS_Y)[p], parentLevel->array(DERIVED_POS_Z)[p]);
+                Quaternion parentOrientation(parentLevel->array(DERIVED_ORIENT_W)[p],
+                    parentLevel->array(DERIVED_ORIENT_X)[p], parentLevel->array(DERIVED_ORIENT_Y)[p],
+                    parentLevel->array(DERIVED_ORIENT_Z)[p]);
+                Vector3 parentScale(parentLevel->array(DERIVED_SCALE_X)[p],
+                    parentLevel->array(DERIVED_SCALE_Y)[p], parentLevel->array(DERIVED_SCALE_Z)[p]);
+
+                if (level.flags[i] & SF_INHERIT_ORIENTATION)
+                    orientation = parentOrientation * orientation;
+                if (level.flags[i] & SF_INHERIT_SCALE)
+                    scale = parentScale * scale;
+                position = parentOrientation * (parentScale * position);
+                position += parentPosition;
+            }
+
+            level.array(DERIVED_POS_X)[i] = position.x;
+            level.array(DERIVED_POS_Y)[i] = position.y;
+            level.array(DERIVED_POS_Z)[i] = position.z;
+            level.array(DERIVED_ORIENT_W)[i] = orientation.w;
+            level.array(DERIVED_ORIENT_X)[i] = orientation.x;
+            level.array(DERIVED_ORIENT_Y)[i] = orientation.y;
+            level.array(DERIVED_ORIENT_Z)[i] = orientation.z;
+            level.array(DERIVED_SCALE_X)[i] = scale.x;
+            level.array(DERIVED_SCALE_Y)[i] = scale.y;
+            level.array(DERIVED_SCALE_Z)[i] = scale.z;
+
+            Matrix4 xform;
+            xform.makeTransform(position, scale, orientation);
+            for (size_t r = 0; r < 3; ++r)
+            {
+                for (size_t c = 0; c < 4; ++c)
+                    level.array(XFORM_00 + r * 4 + c)[i] = xform[r][c];
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+#if __OGRE_HAVE_SSE
+    namespace
+    {
+        /// Gathers one component of the four parent slots
+        inline __m128 gatherParent(const Real* parentArray, const size_t* parents)
+        {
+            return _mm_set_ps(parentArray[parents[3]], parentArray[parents[2]],
+                parentArray[parents[1]], parentArray[parents[0]]);
+        }
+        /// Per-lane mask set where the given flag is present
+        inline __m128 flagMask(const uint8* flags, uint8 flag)
+        {
+            return _mm_cmpneq_ps(_mm_set_ps(
+                (flags[3] & flag) ? 1.0f : 0.0f, (flags[2] & flag) ? 1.0f : 0.0f,
+                (flags[1] & flag) ? 1.0f : 0.0f, (flags[0] & flag) ? 1.0f : 0.0f),
+                _mm_setzero_ps());
+        }
+        /// Picks a where the mask is set, b elsewhere
+        inline __m128 selectMask(__m128 mask, __m128 a, __m128 b)
+        {
+            return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+        }
+    }
+    //-----------------------------------------------------------------------
+    void TransformStorage::updateBlockSSE(Level& level, const Level* parentLevel, size_t first)
+    {
+        // Operations are laid out in the same order as the scalar Quaternion,
+        // Vector3 and Matrix4 code so that both paths give identical results
+        const size_t* parents = &level.parents[first];
+        const uint8* flags = &level.flags[first];
+
+        __m128 ppx = gatherParent(parentLevel->array(DERIVED_POS_X), parents);
+        __m128 ppy = gatherParent(parentLevel->array(DERIVED_POS_Y), parents);
+        __m128 ppz = gatherParent(parentLevel->array(DERIVED_POS_Z), parents);
+        __m128 pqw = gatherParent(parentLevel->array(DERIVED_ORIENT_W), parents);
+        __m128 pqx = gatherParent(parentLevel->array(DERIVED_ORIENT_X), parents);
+        __m128 pqy = gatherParent(parentLevel->array(DERIVED_ORIENT_Y), parents);
+        __m128 pqz = gatherParent(parentLevel->array(DERIVED_ORIENT_Z), parents);
+        __m128 psx = gatherParent(parentLevel->array(DERIVED_SCALE_X), parents);
+        __m128 psy = gatherParent(parentLevel->array(DERIVED_SCALE_Y), parents);
+        __m128 psz = gatherParent(parentLevel->array(DERIVED_SCALE_Z), parents);
+
+        // Local transforms are stored per node, transpose them into lanes
+        const float* positions = level.positions[first].ptr();
+        __m128 lpx = _mm_load_ps(positions);
+        __m128 lpy = _mm_load_ps(positions + 4);
+        __m128 lpz = _mm_load_ps(positions + 8);
+        __MM_TRANSPOSE4x3_PS(lpx, lpy, lpz);
+        const float* orientations = level.orientations[first].ptr();
+        __m128 lqw = _mm_load_ps(orientations);
+        __m128 lqx = _mm_load_ps(orientations + 4);
+        __m128 lqy = _mm_load_ps(orientations + 8);
+        __m128 lqz = _mm_load_ps(orientations + 12);
+        __MM_TRANSPOSE4x4_PS(lqw, lqx, lqy, lqz);
+        const float* scales = level.scales[first].ptr();
+        __m128 lsx = _mm_load_ps(scales);
+        __m128 lsy = _mm_load_ps(scales + 4);
+        __m128 lsz = _mm_load_ps(scales + 8);
+        __MM_TRANSPOSE4x3_PS(lsx, lsy, lsz);
+
+        // Orientation
+        __m128 inheritOrientation = flagMask(flags, SF_INHERIT_ORIENTATION);
+        __m128 qw = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(pqw, lqw),
+            _mm_mul_ps(pqx, lqx)), _mm_mul_ps(pqy, lqy)), _mm_mul_ps(pqz, lqz));
+        __m128 qx = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(pqw, lqx),
+            _mm_mul_ps(pqx, lqw)), _mm_mul_ps(pqy, lqz)), _mm_mul_ps(pqz, lqy));
+        __m128 qy = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(pqw, lqy),
+            _mm_mul_ps(pqy, lqw)), _mm_mul_ps(pqz, lqx)), _mm_mul_ps(pqx, lqz));
+        __m128 qz = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(pqw, lqz),
+            _mm_mul_ps(pqz, lqw)), _mm_mul_ps(pqx, lqy)), _mm_mul_ps(pqy, lqx));
+        qw = selectMask(inheritOrientation, qw, lqw);
+        qx = selectMask(inheritOrientation, qx, lqx);
+        qy = selectMask(inheritOrientation, qy, lqy);
+        qz = selectMask(inheritOrientation, qz, lqz);
+
+        // Scale
+        __m128 inheritScale = flagMask(flags, SF_INHERIT_SCALE);
+        __m128 sx = selectMask(inheritScale, _mm_mul_ps(psx, lsx), lsx);
+        __m128 sy = selectMask(inheritScale, _mm_mul_ps(psy, lsy), lsy);
+        __m128 sz = selectMask(inheritScale, _mm_mul_ps(psz, lsz), lsz);
+
+        // Position: parentOrientation * (parentScale * position) + parentPosition
+        __m128 vx = _mm_mul_ps(psx, lpx);
+        __m128 vy = _mm_mul_ps(psy, lpy);
+        __m128 vz = _mm_mul_ps(psz, lpz);
+        __m128 uvx = _mm_sub_ps(_mm_mul_ps(pqy, vz), _mm_mul_ps(pqz, vy));
+        __m128 uvy = _mm_sub_ps(_mm_mul_ps(pqz, vx), _mm_mul_ps(pqx, vz));
+        __m128 uvz = _mm_sub_ps(_mm_mul_ps(pqx, vy), _mm_mul_ps(pqy, vx));
+        __m128 uuvx = _mm_sub_ps(_mm_mul_ps(pqy, uvz), _mm_mul_ps(pqz, uvy));
+        __m128 uuvy = _mm_sub_ps(_mm_mul_ps(pqz, uvx), _mm_mul_ps(pqx, uvz));
+        __m128 uuvz = _mm_sub_ps(_mm_mul_ps(pqx, uvy), _mm_mul_ps(pqy, uvx));
+        __m128 two = _mm_set1_ps(2.0f);
+        __m128 twoW = _mm_mul_ps(two, pqw);
+        uvx = _mm_mul_ps(uvx, twoW);
+        uvy = _mm_mul_ps(uvy, twoW);
+        uvz = _mm_mul_ps(uvz, twoW);
+        uuvx = _mm_mul_ps(uuvx, two);
+        uuvy = _mm_mul_ps(uuvy, two);
+        uuvz = _mm_mul_ps(uuvz, two);
+        __m128 px = _mm_add_ps(_mm_add_ps(_mm_add_ps(vx, uvx), uuvx), ppx);
+        __m128 py = _mm_add_ps(_mm_add_ps(_mm_add_ps(vy, uvy), uuvy), ppy);
+        __m128 pz = _mm_add_ps(_mm_add_ps(_mm_add_ps(vz, uvz), uuvz), ppz);
+
+        _mm_store_ps(level.array(DERIVED_POS_X) + first, px);
+        _mm_store_ps(level.array(DERIVED_POS_Y) + first, py);
+        _mm_store_ps(level.array(DERIVED_POS_Z) + first, pz);
+        _mm_store_ps(level.array(DERIVED_ORIENT_W) + first, qw);
+        _mm_store_ps(level.array(DERIVED_ORIENT_X) + first, qx);
+        _mm_store_ps(level.array(DERIVED_ORIENT_Y) + first, qy);
+        _mm_store_ps(level.array(DERIVED_ORIENT_Z) + first, qz);
+        _mm_store_ps(level.array(DERIVED_SCALE_X) + first, sx);
+        _mm_store_ps(level.array(DERIVED_SCALE_Y) + first, sy);
+        _mm_store_ps(level.array(DERIVED_SCALE_Z) + first, sz);
+
+        // Transform matrix, see Quaternion::ToRotationMatrix and Matrix4::makeTransform
+        __m128 tx = _mm_add_ps(qx, qx);
+        __m128 ty = _mm_add_ps(qy, qy);
+        __m128 tz = _mm_add_ps(qz, qz);
+        __m128 twx = _mm_mul_ps(tx, qw);
+        __m128 twy = _mm_mul_ps(ty, qw);
+        __m128 twz = _mm_mul_ps(tz, qw);
+        __m128 txx = _mm_mul_ps(tx, qx);
+        __m128 txy = _mm_mul_ps(ty, qx);
+        __m128 txz = _mm_mul_ps(tz, qx);
+        __m128 tyy = _mm_mul_ps(ty, qy);
+        __m128 tyz = _mm_mul_ps(tz, qy);
+        __m128 tzz = _mm_mul_ps(tz, qz);
+        __m128 one = _mm_set1_ps(1.0f);
+
+        _mm_store_ps(level.array(XFORM_00) + first,
+            _mm_mul_ps(sx, _mm_sub_ps(one, _mm_add_ps(tyy, tzz))));
+        _mm_store_ps(level.array(XFORM_01) + first, _mm_mul_ps(sy, _mm_sub_ps(txy, twz)));
+        _mm_store_ps(level.array(XFORM_02) + first, _mm_mul_ps(sz, _mm_add_ps(txz, twy)));
+        _mm_store_ps(level.array(XFORM_03) + first, px);
+        _mm_store_ps(level.array(XFORM_10) + first, _mm_mul_ps(sx, _mm_add_ps(txy, twz)));
+        _mm_store_ps(level.array(XFORM_11) + first,
+            _mm_mul_ps(sy, _mm_sub_ps(one, _mm_add_ps(txx, tzz))));
+        _mm_store_ps(level.array(XFORM_12) + first, _mm_mul_ps(sz, _mm_sub_ps(tyz, twx)));
+        _mm_store_ps(level.array(XFORM_13) + first, py);
+        _mm_store_ps(level.array(XFORM_20) + first, _mm_mul_ps(sx, _mm_sub_ps(txz, twy)));
+        _mm_store_ps(level.array(XFORM_21) + first, _mm_mul_ps(sy, _mm_add_ps(tyz, twx)));
+        _mm_store_ps(level.array(XFORM_22) + first,
+            _mm_mul_ps(sz, _mm_sub_ps(one, _mm_add_ps(txx, tyy))));
+        _mm_store_ps(level.array(XFORM_23) + first, pz);
+    }
+#else
+    //-----------------------------------------------------------------------
+    void TransformStorage::updateBlockSSE(Level& level, const Level* parentLevel, size_t first)
+    {
+        updateBlockGeneral(level, parentLevel, first);
+    }
+#endif
+    //-----------------------------------------------------------------------
+    void TransformStorage::_getDerivedTransform(const Node* node, Vector3& position,
+        Quaternion& orientation, Vector3& scale, Matrix4& transform) const
+    {
+        const Level& level = *mLevels[node->mTransformDepth];
+        size_t i = node->mTransformIndex;
+
+        position.x = level.array(DERIVED_POS_X)[i];
+        position.y = level.array(DERIVED_POS_Y)[i];
+        position.z = level.array(DERIVED_POS_Z)[i];
+        orientation.w = level.array(DERIVED_ORIENT_W)[i];
+        orientation.x = level.array(DERIVED_ORIENT_X)[i];
+        orientation.y = level.array(DERIVED_ORIENT_Y)[i];
+        orientation.z = level.array(DERIVED_ORIENT_Z)[i];
+        scale.x = level.array(DERIVED_SCALE_X)[i];
+        scale.y = level.array(DERIVED_SCALE_Y)[i];
+        scale.z = level.array(DERIVED_SCALE_Z)[i];
+
+        for (size_t r = 0; r < 3; ++r)
+        {
+            for (size_t c = 0; c < 4; ++c)
+                transform[r][c] = level.array(XFORM_00 + r * 4 + c)[i];
+        }
+        transform[3][0] = 0; transform[3][1] = 0; transform[3][2] = 0; transform[3][3] = 1;
+    }
+    //-----------------------------------------------------------------------
+    size_t TransformStorage::getNumNodes(void) const
+    {
+        size_t count = 0;
+        for (LevelList::const_iterator i = mLevels.begin(); i != mLevels.end(); ++i)
+            count += (*i)->size;
+        return count;
+    }
+
+}
@@ -362,6 +362,11 @@ namespace Ogre {
         return mCamera ? mCamera->_getNumRenderedBatches() : 0;
     }
     //---------------------------------------------------------------------
+    size_t Viewport::_getNumUploadedConstantBytes(void) const
+    {
+        return mCamera ? mCamera->_getNumUploadedConstantBytes() : 0;
+    }
+    //---------------------------------------------------------------------
     void Viewport::setCamera(Camera* cam)
     {
         if (cam != NULL && mCamera != NULL && mCamera->getViewport() == this)
@@ -0,0 +1,593 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "Threading/OgreWorkStealingQueue.h"
+#include "OgreLogManager.h"
+#include "OgreRoot.h"
+#include "OgreRenderSystem.h"
+#include "OgreTimer.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        /// Requests each worker can hold per lane before spilling to the overflow queue
+        const size_t REQUEST_RING_CAPACITY = 1024;
+        /// Responses waiting for the main thread before spilling to the overflow queue
+        const size_t RESPONSE_RING_CAPACITY = 4096;
+    }
+    //---------------------------------------------------------------------
+    WorkStealingQueue::WorkerQueues::WorkerQueues(size_t idx)
+        : index(idx), current(0)
+    {
+        for (int i = 0; i < PRIORITY_COUNT; ++i)
+            lanes[i] = OGRE_NEW RequestRing(REQUEST_RING_CAPACITY);
+    }
+    //---------------------------------------------------------------------
+    WorkStealingQueue::WorkerQueues::~WorkerQueues()
+    {
+        for (int i = 0; i < PRIORITY_COUNT; ++i)
+        {
+            Request* req;
+            while (lanes[i]->pop(req))
+                OGRE_DELETE req;
+            OGRE_DELETE lanes[i];
+        }
+    }
+    //---------------------------------------------------------------------
+    WorkStealingQueue::WorkStealingQueue(const String& name)
+        : DefaultWorkQueueBase(name)
+        , mChannelPriorities(65536, PRIORITY_NORMAL)
+        , mResponseRing(OGRE_NEW ResponseRing(RESPONSE_RING_CAPACITY))
+        , mLastRequestID(0)
+        , mQueuedRequests(0)
+        , mNextWorker(0)
+        , mNextThreadIndex(0)
+        , mSleepingWorkers(0)
+        , mAbortWatermark(0)
+        , mAbortedAllUpTo(0)
+        , mNumThreadsRegisteredWithRS(0)
+    {
+    }
+    //---------------------------------------------------------------------
+    WorkStealingQueue::~WorkStealingQueue()
+    {
+        shutdown();
+        deleteQueues();
+
+        Response* response;
+        while (mResponseRing->pop(response))
+            OGRE_DELETE response;
+        OGRE_DELETE mResponseRing;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::setChannelPriority(uint16 channel, Priority priority)
+    {
+        mChannelPriorities[channel] = (uint8)priority;
+    }
+    //---------------------------------------------------------------------
+    WorkStealingQueue::Priority WorkStealingQueue::getChannelPriority(uint16 channel) const
+    {
+        return (Priority)mChannelPriorities[channel];
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::startup(bool forceRestart)
+    {
+        if (mIsRunning)
+        {
+            if (forceRestart)
+                shutdown();
+            else
+                return;
+        }
+
+        mShuttingDown = false;
+
+        mWorkerFunc = OGRE_NEW_T(WorkerFunc(this), MEMCATEGORY_GENERAL);
+
+        LogManager::getSingleton().stream() <<
+            "WorkStealingQueue('" << mName << "') initialising on thread " <<
+#if OGRE_THREAD_SUPPORT
+            OGRE_THREAD_CURRENT_ID
+#else
+            "main"
+#endif
+            << ".";
+
+#if OGRE_THREAD_SUPPORT
+        // The rings are only touched by the workers, which do not run yet.
+        // Keep one even without threads for users calling _processNextRequest.
+        deleteQueues();
+        const size_t numQueues = std::max(mWorkerThreadCount, (size_t)1);
+        for (size_t i = 0; i < numQueues; ++i)
+            mWorkerQueues.push_back(OGRE_NEW WorkerQueues(i));
+        {
+            // Requests added before startup wait in the overflow queue
+            OGRE_LOCK_MUTEX(mRequestMutex);
+            mQueuedRequests = mRequestQueue.size();
+        }
+
+        if (mWorkerRenderSystemAccess)
+            Root::getSingleton().getRenderSystem()->preExtraThreadsStarted();
+
+        mNumThreadsRegisteredWithRS = 0;
+        mNextThreadIndex = 0;
+        for (size_t i = 0; i < mWorkerThreadCount; ++i)
+        {
+            OGRE_THREAD_CREATE(t, *mWorkerFunc);
+            mWorkers.push_back(t);
+        }
+
+        if (mWorkerRenderSystemAccess)
+        {
+            OGRE_LOCK_MUTEX_NAMED(mInitMutex, initLock);
+            // have to wait until all threads are registered with the render system
+            while (mNumThreadsRegisteredWithRS < mWorkerThreadCount)
+                OGRE_THREAD_WAIT(mInitSync, mInitMutex, initLock);
+
+            Root::getSingleton().getRenderSystem()->postExtraThreadsStarted();
+        }
+#endif
+
+        mIsRunning = true;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::notifyThreadRegistered()
+    {
+        OGRE_LOCK_MUTEX(mInitMutex);
+
+        ++mNumThreadsRegisteredWithRS;
+
+        // wake up main thread
+        OGRE_THREAD_NOTIFY_ALL(mInitSync);
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::shutdown()
+    {
+        if (!mIsRunning)
+            return;
+
+        LogManager::getSingleton().stream() <<
+            "WorkStealingQueue('" << mName << "') shutting down on thread " <<
+#if OGRE_THREAD_SUPPORT
+            OGRE_THREAD_CURRENT_ID
+#else
+            "main"
+#endif
+            << ".";
+
+        mShuttingDown = true;
+        abortAllRequests();
+#if OGRE_THREAD_SUPPORT
+        {
+            // wake all threads, they check the shutting down flag after waiting
+            OGRE_LOCK_MUTEX(mWakeMutex);
+            OGRE_THREAD_NOTIFY_ALL(mWakeCondition);
+        }
+
+        for (WorkerThreadList::iterator i = mWorkers.begin(); i != mWorkers.end(); ++i)
+        {
+            (*i)->join();
+            OGRE_THREAD_DESTROY(*i);
+        }
+        mWorkers.clear();
+#endif
+
+        OGRE_DELETE_T(mWorkerFunc, WorkerFunc, MEMCATEGORY_GENERAL);
+        mWorkerFunc = 0;
+
+        mIsRunning = false;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::deleteQueues()
+    {
+        // Deletes the requests left over by shutdown, the base class
+        // takes care of the overflow queue
+        for (WorkerQueuesList::iterator i = mWorkerQueues.begin(); i != mWorkerQueues.end(); ++i)
+            OGRE_DELETE *i;
+        mWorkerQueues.clear();
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::RequestID WorkStealingQueue::addRequest(uint16 channel, uint16 requestType,
+        const Any& rData, uint8 retryCount, bool forceSynchronous, bool idleThread)
+    {
+        if (!mAcceptRequests || mShuttingDown)
+            return 0;
+
+        RequestID rid = ++mLastRequestID;
+        Request* req = OGRE_NEW Request(channel, requestType, rData, retryCount, rid);
+
+#if OGRE_THREAD_SUPPORT
+        if (idleThread)
+        {
+            {
+                OGRE_LOCK_MUTEX(mIdleMutex);
+                mIdleRequestQueue.push_back(req);
+            }
+            notifyWorkers();
+            return rid;
+        }
+        if (!forceSynchronous)
+        {
+            queueRequest(req, mNextWorker++);
+            return rid;
+        }
+#endif
+        processRequestResponse(req, 0, true);
+        return rid;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::addRequestWithRID(RequestID rid, uint16 channel,
+        uint16 requestType, const Any& rData, uint8 retryCount)
+    {
+        if (mShuttingDown)
+            return;
+
+        Request* req = OGRE_NEW Request(channel, requestType, rData, retryCount, rid);
+#if OGRE_THREAD_SUPPORT
+        queueRequest(req, mNextWorker++);
+#else
+        processRequestResponse(req, 0, true);
+#endif
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::queueRequest(Request* req, size_t workerIdx)
+    {
+        const size_t numWorkers = mWorkerQueues.size();
+        const uint8 lane = mChannelPriorities[req->getChannel()];
+        bool queued = false;
+        // Another worker's ring will do if this one is full
+        for (size_t i = 0; i < numWorkers && !queued; ++i)
+            queued = mWorkerQueues[(workerIdx + i) % numWorkers]->lanes[lane]->push(req);
+
+        if (!queued)
+        {
+            // All full (or not started yet), the workers look here last
+            OGRE_LOCK_MUTEX(mRequestMutex);
+            mRequestQueue.push_back(req);
+        }
+
+        ++mQueuedRequests;
+        notifyWorkers();
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::Request* WorkStealingQueue::takeRequest(size_t workerIdx)
+    {
+        const size_t numWorkers = mWorkerQueues.size();
+        Request* req = 0;
+        for (int lane = 0; lane < PRIORITY_COUNT; ++lane)
+        {
+            // Own ring first, then steal going round the others
+            for (size_t i = 0; i < numWorkers; ++i)
+            {
+                if (mWorkerQueues[(workerIdx + i) % numWorkers]->lanes[lane]->pop(req))
+                {
+                    --mQueuedRequests;
+                    return req;
+                }
+            }
+        }
+
+        OGRE_LOCK_MUTEX(mRequestMutex);
+        if (!mRequestQueue.empty())
+        {
+            req = mRequestQueue.front();
+            mRequestQueue.pop_front();
+            --mQueuedRequests;
+        }
+        return req;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::_processNextRequest()
+    {
+        // Called by a thread of the user's, which owns no queue
+        processNextRequest(mNextWorker++, false);
+    }
+    //---------------------------------------------------------------------
+    bool WorkStealingQueue::processNextRequest(size_t workerIdx, bool ownsQueue)
+    {
+        if (processIdleRequests())
+            return true;
+
+        if (mWorkerQueues.empty())
+            return false;
+        workerIdx %= mWorkerQueues.size();
+
+        Request* request = takeRequest(workerIdx);
+        if (!request)
+            return false;
+
+        applyAborts(request, true);
+        processRequestResponse(request, ownsQueue ? mWorkerQueues[workerIdx] : 0, false);
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::processRequestResponse(Request* r, WorkerQueues* queues, bool synchronous)
+    {
+        if (queues)
+        {
+            OGRE_LOCK_MUTEX(queues->currentMutex);
+            queues->current = r;
+        }
+
+        Response* response = 0;
+        RequestHandlerList handlers;
+        {
+            // Only copy the handlers of this channel, so that they can be
+            // removed while the request is processed
+            OGRE_LOCK_RW_MUTEX_READ(mRequestHandlerMutex);
+            RequestHandlerListByChannel::iterator i = mRequestHandlers.find(r->getChannel());
+            if (i != mRequestHandlers.end())
+                handlers = i->second;
+        }
+        for (RequestHandlerList::reverse_iterator j = handlers.rbegin(); j != handlers.rend(); ++j)
+        {
+            // threadsafe call which tests canHandleRequest and calls it if so
+            response = (*j)->handleRequest(r, this);
+            if (response)
+                break;
+        }
+
+        if (queues)
+        {
+            OGRE_LOCK_MUTEX(queues->currentMutex);
+            queues->current = 0;
+        }
+
+        if (!response)
+        {
+            if (!r->getAborted())
+            {
+                LogManager::getSingleton().stream() <<
+                    "WorkStealingQueue('" << mName << "') warning: no handler processed request "
+                    << r->getID() << ", channel " << r->getChannel()
+                    << ", type " << r->getType();
+            }
+            OGRE_DELETE r;
+            return;
+        }
+
+        if (!response->succeeded() && r->getRetryCount())
+        {
+            // Same ID, the retry goes back to this worker's ring if it has one
+            Request* retry = OGRE_NEW Request(r->getChannel(), r->getType(), r->getData(),
+                r->getRetryCount() - 1, r->getID());
+            // discard response (this also deletes request)
+            OGRE_DELETE response;
+            if (mShuttingDown)
+                OGRE_DELETE retry;
+            else
+                queueRequest(retry, queues ? queues->index : mNextWorker++);
+            return;
+        }
+
+        if (!synchronous)
+        {
+            if (response->getRequest()->getAborted())
+            {
+                // destroy response user data
+                response->abortRequest();
+            }
+            if (!mResponseRing->push(response))
+            {
+                OGRE_LOCK_MUTEX(mResponseMutex);
+                mResponseQueue.push_back(response);
+            }
+            // no need to wake thread, this is processed by the main thread
+            return;
+        }
+
+        processResponse(response);
+        OGRE_DELETE response;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::processResponses()
+    {
+        unsigned long msStart = Root::getSingleton().getTimer()->getMilliseconds();
+
+        // keep going until we run out of responses or out of time
+        for (;;)
+        {
+            Response* response = 0;
+            if (!mResponseRing->pop(response))
+            {
+                // Overflow, or responses of the idle thread
+                OGRE_LOCK_MUTEX(mResponseMutex);
+                if (mResponseQueue.empty())
+                    break;
+                response = mResponseQueue.front();
+                mResponseQueue.pop_front();
+            }
+
+            if (!response->getRequest()->getAborted())
+            {
+                applyAborts(response->getRequest(), false);
+                if (response->getRequest()->getAborted())
+                    response->abortRequest();
+            }
+
+            processResponse(response);
+            OGRE_DELETE response;
+
+            // time limit
+            if (mResposeTimeLimitMS)
+            {
+                unsigned long msCurrent = Root::getSingleton().getTimer()->getMilliseconds();
+                if (msCurrent - msStart > mResposeTimeLimitMS)
+                    break;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::applyAborts(const Request* r, bool pending)
+    {
+        // Requests created after the last abort never need the lock
+        if (r->getID() > mAbortWatermark.get())
+            return;
+
+        OGRE_LOCK_MUTEX(mAbortMutex);
+        bool aborted = r->getID() <= mAbortedAllUpTo;
+
+        map<uint16, RequestID>::type::iterator c = mAbortedChannels.find(r->getChannel());
+        aborted |= c != mAbortedChannels.end() && r->getID() <= c->second;
+        if (pending)
+        {
+            c = mAbortedPendingChannels.find(r->getChannel());
+            aborted |= c != mAbortedPendingChannels.end() && r->getID() <= c->second;
+        }
+
+        set<RequestID>::type::iterator i = mAbortedRequests.find(r->getID());
+        if (i != mAbortedRequests.end())
+        {
+            aborted = true;
+            // Retries keep the ID, so only forget it once the response is out
+            if (!pending)
+                mAbortedRequests.erase(i);
+        }
+
+        if (aborted)
+            r->abortRequest();
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::abortInFlightRequests(uint16 channel, RequestID id, bool allChannels)
+    {
+        // Called with mAbortMutex held, once the abort has been recorded
+        mAbortWatermark = mLastRequestID.get();
+
+        for (WorkerQueuesList::iterator i = mWorkerQueues.begin(); i != mWorkerQueues.end(); ++i)
+        {
+            OGRE_LOCK_MUTEX((*i)->currentMutex);
+            Request* current = (*i)->current;
+            if (current && (allChannels || current->getChannel() == channel || current->getID() == id))
+                current->abortRequest();
+        }
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::abortRequest(RequestID id)
+    {
+        // Overflow and idle queues
+        DefaultWorkQueueBase::abortRequest(id);
+
+        OGRE_LOCK_MUTEX(mAbortMutex);
+        mAbortedRequests.insert(id);
+        abortInFlightRequests(0, id, false);
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::abortRequestsByChannel(uint16 channel)
+    {
+        DefaultWorkQueueBase::abortRequestsByChannel(channel);
+
+        OGRE_LOCK_MUTEX(mAbortMutex);
+        mAbortedChannels[channel] = mLastRequestID.get();
+        // 0 is never handed out as an ID
+        abortInFlightRequests(channel, 0, false);
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::abortPendingRequestsByChannel(uint16 channel)
+    {
+        DefaultWorkQueueBase::abortPendingRequestsByChannel(channel);
+
+        OGRE_LOCK_MUTEX(mAbortMutex);
+        mAbortedPendingChannels[channel] = mLastRequestID.get();
+        mAbortWatermark = mLastRequestID.get();
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::abortAllRequests()
+    {
+        DefaultWorkQueueBase::abortAllRequests();
+
+        OGRE_LOCK_MUTEX(mAbortMutex);
+        mAbortedAllUpTo = mLastRequestID.get();
+        // Everything older is covered now
+        mAbortedRequests.clear();
+        mAbortedChannels.clear();
+        mAbortedPendingChannels.clear();
+        abortInFlightRequests(0, 0, true);
+    }
+    //---------------------------------------------------------------------
+    bool WorkStealingQueue::hasIdleRequests()
+    {
+        OGRE_LOCK_MUTEX(mIdleMutex);
+        return !mIdleRequestQueue.empty() && !mIdleThreadRunning;
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::notifyWorkers()
+    {
+        // Only pay for the lock if somebody sleeps. The request was queued
+        // before, so a worker going to sleep concurrently sees it when it
+        // checks again under the lock.
+        if (mSleepingWorkers.get())
+        {
+            OGRE_LOCK_MUTEX(mWakeMutex);
+            OGRE_THREAD_NOTIFY_ONE(mWakeCondition);
+        }
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::waitForNextRequest()
+    {
+#if OGRE_THREAD_SUPPORT
+        OGRE_LOCK_MUTEX_NAMED(mWakeMutex, wakeLock);
+        ++mSleepingWorkers;
+        if (!mQueuedRequests.get() && !hasIdleRequests() && !isShuttingDown())
+        {
+            // frees lock and suspends the thread
+            OGRE_THREAD_WAIT(mWakeCondition, mWakeMutex, wakeLock);
+        }
+        --mSleepingWorkers;
+#endif
+    }
+    //---------------------------------------------------------------------
+    void WorkStealingQueue::_threadMain()
+    {
+#if OGRE_THREAD_SUPPORT
+        const size_t workerIdx = mNextThreadIndex++;
+
+        LogManager::getSingleton().stream() <<
+            "WorkStealingQueue('" << getName() << "')::WorkerFunc - thread "
+            << OGRE_THREAD_CURRENT_ID << " starting.";
+
+        // Initialise the thread for RS if necessary
+        if (mWorkerRenderSystemAccess)
+        {
+            Root::getSingleton().getRenderSystem()->registerThread();
+            notifyThreadRegistered();
+        }
+
+        // Spin forever until we're told to shut down
+        while (!isShuttingDown())
+        {
+            if (!processNextRequest(workerIdx, true))
+                waitForNextRequest();
+        }
+
+        LogManager::getSingleton().stream() <<
+            "WorkStealingQueue('" << getName() << "')::WorkerFunc - thread "
+            << OGRE_THREAD_CURRENT_ID << " stopped.";
+#endif
+    }
+}
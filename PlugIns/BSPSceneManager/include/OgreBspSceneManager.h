@@ -113,6 +113,9 @@ namespace Ogre {
         /** @copydoc SceneManager::clearScene */
         void clearScene(void);
 
+        /** BspSceneNodes notify the level of their movement while updating. */
+        bool isParallelUpdateSafe(void) const { return false; }
+
         // Overridden so we can manually render world geometry
         bool fireRenderQueueEnded(uint8 id, const String& invocation);
 
@@ -0,0 +1,182 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __Bvh_H__
+#define __Bvh_H__
+
+#include "OgreBvhPrerequisites.h"
+#include "OgreAxisAlignedBox.h"
+
+namespace Ogre
+{
+    /** \addtogroup Plugins
+    *  @{
+    */
+    /** \addtogroup BVHSceneManager
+    *  @{
+    */
+    /** Dynamic bounding volume hierarchy over axis aligned boxes.
+    @remarks
+        Every proxy is a leaf of a binary tree whose interior nodes bound their
+        two children. Leaves store a 'fat' box, grown by a margin relative to
+        the size of the real box, so small movements do not touch the tree.
+    @par
+        New leaves are inserted next to the sibling that increases the surface
+        area heuristic (SAH) cost the least. Whenever boxes change along a path
+        the ancestors are refitted and rotated (children swapped with
+        grandchildren when that shrinks the rotated node), which keeps the tree
+        close to a fresh build without rebuilding it. rebuild() performs a full
+        binned SAH build for when the whole scene has changed at once.
+    @par
+        All queries are const and use no shared scratch state, so they may be
+        run from several threads as long as nothing modifies the tree.
+    */
+    class _OgreBvhPluginExport Bvh : public SceneMgtAlloc
+    {
+    public:
+        typedef vector<int>::type ProxyList;
+
+        /// Invalid proxy / tree node index
+        static const int NULL_NODE = -1;
+
+        Bvh();
+        ~Bvh();
+
+        /** Adds a leaf for a finite, non-null box.
+        @return The proxy id, which remains valid until destroyProxy.
+        */
+        int createProxy(const AxisAlignedBox& box, void* userData);
+
+        /** Removes a leaf previously returned by createProxy. */
+        void destroyProxy(int proxy);
+
+        /** Updates the box of a leaf.
+        @remarks
+            Nothing changes while the box stays inside the fat box of the
+            leaf. If the new fat box still fits the parent bounds the leaf is
+            refitted in place, otherwise it is reinserted.
+        @return true if the tree was modified.
+        */
+        bool moveProxy(int proxy, const AxisAlignedBox& box);
+
+        /** Gets the user data given to createProxy. */
+        void* getUserData(int proxy) const { return mNodes[proxy].userData; }
+
+        /** Gets the fat box stored for a proxy. */
+        AxisAlignedBox getFatBox(int proxy) const;
+
+        /** Removes all proxies. */
+        void clear(void);
+
+        /** Rebuilds the interior of the tree top-down using binned SAH.
+        @remarks
+            Proxy ids are unchanged.
+        */
+        void rebuild(void);
+
+        /** Sets how much leaf boxes are grown on each side, as a fraction of
+            their size. Applies to proxies created or moved afterwards.
+        */
+        void setMargin(Real margin) { mMargin = margin; }
+        /** Gets the margin set by setMargin. */
+        Real getMargin(void) const { return mMargin; }
+
+        /** Gets the number of proxies. */
+        size_t getNumProxies(void) const { return mNumProxies; }
+
+        /** Gets the height of the tree, 0 for a single leaf. */
+        int getHeight(void) const;
+
+        /** Gets the SAH cost of the tree, i.e. the summed surface area of the
+            interior nodes relative to that of the root.
+        */
+        Real getCost(void) const;
+
+        /** Appends the proxies whose fat box intersects the given box. */
+        void findIntersecting(const AxisAlignedBox& box, ProxyList& results) const;
+        /** Appends the proxies whose fat box intersects the given sphere. */
+        void findIntersecting(const Sphere& sphere, ProxyList& results) const;
+        /** Appends the proxies whose fat box intersects the given volume. */
+        void findIntersecting(const PlaneBoundedVolume& volume, ProxyList& results) const;
+        /** Appends the proxies whose fat box is hit by the given ray. */
+        void findIntersecting(const Ray& ray, ProxyList& results) const;
+
+        /** Appends the proxies whose fat box is not fully on the negative side
+            of any of the given planes, as for frustum culling.
+        @remarks
+            Subtrees found fully on the positive side of a plane are not tested
+            against that plane again.
+        */
+        void findVisible(const Plane* planes, size_t numPlanes, ProxyList& results) const;
+
+    protected:
+        struct TreeNode
+        {
+            Vector3 minimum;
+            Vector3 maximum;
+            void* userData;
+            /// Parent node, or next free node when in the free list
+            int parent;
+            int child1;
+            int child2;
+            /// 0 for leaves, -1 for free nodes
+            int height;
+
+            bool isLeaf(void) const { return child1 == NULL_NODE; }
+        };
+        typedef vector<TreeNode>::type TreeNodeList;
+
+        TreeNodeList mNodes;
+        int mRoot;
+        int mFreeList;
+        size_t mNumProxies;
+        Real mMargin;
+
+        int allocateNode(void);
+        void freeNode(int index);
+
+        /// Links a detached leaf into the tree next to its best SAH sibling
+        void insertLeaf(int leaf);
+        /// Unlinks a leaf from the tree and frees its parent
+        void removeLeaf(int leaf);
+        /// Recomputes boxes and heights from the given node up to the root
+        void refit(int index);
+        /// Swaps a child with a grandchild of the given node if that lowers the cost
+        void rotate(int index);
+        /// Builds a subtree over the given leaves, returning its root
+        int build(int* leaves, size_t count, const Vector3* centres);
+        /// Appends all leaves below the given node
+        void collectLeaves(int index, ProxyList& results) const;
+        /// Runs a query with the given box test
+        template <typename Test>
+        void query(const Test& test, ProxyList& results) const;
+    };
+    /** @} */
+    /** @} */
+}
+
+#endif
@@ -0,0 +1,151 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BvhSceneManager_H__
+#define __BvhSceneManager_H__
+
+#include "OgreBvhPrerequisites.h"
+#include "OgreSceneManager.h"
+#include "OgreBvh.h"
+
+namespace Ogre
+{
+    /** \addtogroup Plugins
+    *  @{
+    */
+    /** \addtogroup BVHSceneManager
+    *  @{
+    */
+    class BvhSceneNode;
+
+    /** Specialised SceneManager that keeps its nodes in a dynamic bounding
+        volume hierarchy to accelerate culling and scene queries.
+    @remarks
+        Each BvhSceneNode with attached objects is a leaf of a Bvh. Leaves are
+        refitted as their nodes move during _updateSceneGraph, so the tree
+        follows the scene without having to fit a fixed world size like the
+        octree does. Camera culling and all scene queries (ray, sphere, box,
+        plane bounded volume and intersection) only visit the subtrees that
+        can overlap the query volume.
+    @par
+        Options are:
+        "BvhMargin", Real * : fraction of their size by which leaf boxes are grown
+        "RebuildBvh", bool * : rebuilds the tree from scratch (set only)
+        "BvhHeight", int * : height of the tree (get only)
+        "BvhCost", Real * : SAH cost of the tree relative to its root (get only)
+    */
+    class _OgreBvhPluginExport BvhSceneManager : public SceneManager
+    {
+    public:
+        BvhSceneManager(const String& name);
+        ~BvhSceneManager();
+
+        /// @copydoc SceneManager::getTypeName
+        const String& getTypeName(void) const;
+
+        /** Creates a specialised BvhSceneNode */
+        SceneNode* createSceneNodeImpl(void);
+        /** Creates a specialised BvhSceneNode */
+        SceneNode* createSceneNodeImpl(const String& name);
+
+        /** Walks the Bvh, adding the objects of all visible nodes to the render queue. */
+        void _findVisibleObjects(Camera* cam, VisibleObjectsBoundsInfo* visibleBounds,
+            bool onlyShadowCasters);
+
+        /** Inserts, moves or removes the leaf of a node after its bounds changed. */
+        void _updateBvhNode(BvhSceneNode* node);
+        /** Removes a node from the Bvh. */
+        void _removeBvhNode(BvhSceneNode* node);
+
+        /** Appends the nodes whose bounds may intersect the given box. */
+        void findNodesIn(const AxisAlignedBox& box, SceneNode::SceneNodeList& list);
+        /** Appends the nodes whose bounds may intersect the given sphere. */
+        void findNodesIn(const Sphere& sphere, SceneNode::SceneNodeList& list);
+        /** Appends the nodes whose bounds may intersect the given volume. */
+        void findNodesIn(const PlaneBoundedVolume& volume, SceneNode::SceneNodeList& list);
+        /** Appends the nodes whose bounds may be hit by the given ray. */
+        void findNodesIn(const Ray& ray, SceneNode::SceneNodeList& list);
+
+        /** Gets the hierarchy, for inspection. */
+        const Bvh& getBvh(void) const { return mBvh; }
+
+        /** Rebuilds the hierarchy from scratch.
+        @remarks
+            Refitting keeps the tree in good shape under regular movement, but
+            after loading a level or teleporting most of the scene a full build
+            gives better culling.
+        */
+        void rebuildBvh(void) { mBvh.rebuild(); }
+
+        /** Overridden from SceneManager, see the class description for the options. */
+        bool setOption(const String& key, const void* value);
+        /** Overridden from SceneManager, see the class description for the options. */
+        bool getOption(const String& key, void* destValue);
+        bool getOptionKeys(StringVector& refKeys);
+
+        /** Overridden from SceneManager */
+        void clearScene(void);
+
+        AxisAlignedBoxSceneQuery* createAABBQuery(const AxisAlignedBox& box, uint32 mask);
+        SphereSceneQuery* createSphereQuery(const Sphere& sphere, uint32 mask);
+        PlaneBoundedVolumeListSceneQuery* createPlaneBoundedVolumeQuery(
+            const PlaneBoundedVolumeList& volumes, uint32 mask);
+        RaySceneQuery* createRayQuery(const Ray& ray, uint32 mask);
+        IntersectionSceneQuery* createIntersectionQuery(uint32 mask);
+
+    protected:
+        /** BvhSceneNodes move their leaves in the shared tree while updating. */
+        bool isParallelUpdateSafe(void) const { return false; }
+
+        /// Appends the nodes owning the given proxies and all infinite nodes
+        void addNodes(const Bvh::ProxyList& proxies, SceneNode::SceneNodeList& list) const;
+
+        Bvh mBvh;
+        /// Nodes with infinite bounds, which are not stored in the tree
+        SceneNode::SceneNodeList mInfiniteNodes;
+        /// Scratch list for culling
+        Bvh::ProxyList mVisibleProxies;
+    };
+
+    /// Factory for BvhSceneManager
+    class BvhSceneManagerFactory : public SceneManagerFactory
+    {
+    protected:
+        void initMetaData(void) const;
+    public:
+        BvhSceneManagerFactory() {}
+        ~BvhSceneManagerFactory() {}
+        /// Factory type name
+        static const String FACTORY_TYPE_NAME;
+        SceneManager* createInstance(const String& instanceName);
+        void destroyInstance(SceneManager* instance);
+    };
+    /** @} */
+    /** @} */
+}
+
+#endif
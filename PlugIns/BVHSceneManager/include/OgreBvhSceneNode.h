@@ -0,0 +1,88 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __BvhSceneNode_H__
+#define __BvhSceneNode_H__
+
+#include "OgreBvhPrerequisites.h"
+#include "OgreSceneNode.h"
+#include "OgreBvh.h"
+
+namespace Ogre
+{
+    /** \addtogroup Plugins
+    *  @{
+    */
+    /** \addtogroup BVHSceneManager
+    *  @{
+    */
+    /** Specialised SceneNode that is stored in the hierarchy of a BvhSceneManager.
+    @remarks
+        Like OctreeNode, the world bounds of this node only cover its own
+        attached objects, not its children, so that each node is a tight leaf of
+        the tree. Nodes without attached objects are not stored at all.
+    */
+    class _OgreBvhPluginExport BvhSceneNode : public SceneNode
+    {
+    public:
+        BvhSceneNode(SceneManager* creator);
+        BvhSceneNode(SceneManager* creator, const String& name);
+        ~BvhSceneNode();
+
+        /** Gets the leaf of this node in the Bvh, or Bvh::NULL_NODE. */
+        int _getProxy(void) const { return mProxy; }
+        /** Sets the leaf of this node in the Bvh. */
+        void _setProxy(int proxy) { mProxy = proxy; }
+
+        /** Gets whether the node is kept apart from the tree because its
+            bounds are infinite.
+        */
+        bool _isInfinite(void) const { return mInfinite; }
+        /** Sets whether the node is kept apart from the tree. */
+        void _setInfinite(bool infinite) { mInfinite = infinite; }
+
+    protected:
+        /** Internal method for updating the bounds for this BvhSceneNode.
+        @remarks
+            The bounds only include the attached objects; the node then
+            notifies the scene manager, which moves its leaf if needed.
+        */
+        void _updateBounds(void);
+
+        /** Overridden to drop the node from the Bvh when it leaves the scene graph. */
+        void setInSceneGraph(bool inGraph);
+
+        /// Leaf in the Bvh, Bvh::NULL_NODE if none
+        int mProxy;
+        /// Whether the node is in the infinite list of the scene manager
+        bool mInfinite;
+    };
+    /** @} */
+    /** @} */
+}
+
+#endif
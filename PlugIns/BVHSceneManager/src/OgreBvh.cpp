@@ -0,0 +1,720 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBvh.h"
+#include "OgrePlaneBoundedVolume.h"
+#include "OgreRay.h"
+#include "OgreSphere.h"
+
+#include <algorithm>
+
+namespace Ogre
+{
+    const int Bvh::NULL_NODE;
+
+    namespace
+    {
+        /// Number of centroid bins evaluated per split in rebuild()
+        const size_t NUM_BINS = 16;
+
+        Real halfArea(const Vector3& minimum, const Vector3& maximum)
+        {
+            const Vector3 d = maximum - minimum;
+            return d.x * d.y + d.y * d.z + d.z * d.x;
+        }
+
+        Real mergedHalfArea(const Vector3& min1, const Vector3& max1,
+            const Vector3& min2, const Vector3& max2)
+        {
+            Vector3 minimum = min1, maximum = max1;
+            minimum.makeFloor(min2);
+            maximum.makeCeil(max2);
+            return halfArea(minimum, maximum);
+        }
+
+        bool contains(const Vector3& outerMin, const Vector3& outerMax,
+            const Vector3& innerMin, const Vector3& innerMax)
+        {
+            return outerMin.x <= innerMin.x && outerMin.y <= innerMin.y && outerMin.z <= innerMin.z &&
+                innerMax.x <= outerMax.x && innerMax.y <= outerMax.y && innerMax.z <= outerMax.z;
+        }
+
+        struct BoxTest
+        {
+            const AxisAlignedBox& box;
+            explicit BoxTest(const AxisAlignedBox& b) : box(b) {}
+            bool operator()(const Vector3& minimum, const Vector3& maximum) const
+            {
+                const Vector3& bmin = box.getMinimum();
+                const Vector3& bmax = box.getMaximum();
+                return minimum.x <= bmax.x && bmin.x <= maximum.x &&
+                    minimum.y <= bmax.y && bmin.y <= maximum.y &&
+                    minimum.z <= bmax.z && bmin.z <= maximum.z;
+            }
+        };
+
+        struct SphereTest
+        {
+            const Sphere& sphere;
+            explicit SphereTest(const Sphere& s) : sphere(s) {}
+            bool operator()(const Vector3& minimum, const Vector3& maximum) const
+            {
+                return Math::intersects(sphere, AxisAlignedBox(minimum, maximum));
+            }
+        };
+
+        struct VolumeTest
+        {
+            const PlaneBoundedVolume& volume;
+            explicit VolumeTest(const PlaneBoundedVolume& v) : volume(v) {}
+            bool operator()(const Vector3& minimum, const Vector3& maximum) const
+            {
+                return volume.intersects(AxisAlignedBox(minimum, maximum));
+            }
+        };
+
+        struct RayTest
+        {
+            const Ray& ray;
+            explicit RayTest(const Ray& r) : ray(r) {}
+            bool operator()(const Vector3& minimum, const Vector3& maximum) const
+            {
+                return Math::intersects(ray, AxisAlignedBox(minimum, maximum)).first;
+            }
+        };
+
+        /// Orders leaves by their centre along one axis
+        struct CentreLess
+        {
+            const Vector3* centres;
+            int axis;
+            CentreLess(const Vector3* c, int a) : centres(c), axis(a) {}
+            bool operator()(int a, int b) const { return centres[a][axis] < centres[b][axis]; }
+        };
+
+        /// Selects leaves whose centre falls in a bin below the split
+        struct BinBelow
+        {
+            const Vector3* centres;
+            int axis;
+            Real minimum;
+            Real scale;
+            size_t split;
+            BinBelow(const Vector3* c, int a, Real m, Real s, size_t sp)
+                : centres(c), axis(a), minimum(m), scale(s), split(sp) {}
+            bool operator()(int leaf) const
+            {
+                size_t bin = static_cast<size_t>((centres[leaf][axis] - minimum) * scale);
+                return std::min(bin, NUM_BINS - 1) < split;
+            }
+        };
+    }
+    //-----------------------------------------------------------------------
+    Bvh::Bvh()
+        : mRoot(NULL_NODE)
+        , mFreeList(NULL_NODE)
+        , mNumProxies(0)
+        , mMargin(0.1f)
+    {
+    }
+    //-----------------------------------------------------------------------
+    Bvh::~Bvh()
+    {
+    }
+    //-----------------------------------------------------------------------
+    int Bvh::allocateNode(void)
+    {
+        int index;
+        if (mFreeList != NULL_NODE)
+        {
+            index = mFreeList;
+            mFreeList = mNodes[index].parent;
+        }
+        else
+        {
+            index = static_cast<int>(mNodes.size());
+            mNodes.push_back(TreeNode());
+        }
+
+        TreeNode& node = mNodes[index];
+        node.userData = 0;
+        node.parent = NULL_NODE;
+        node.child1 = NULL_NODE;
+        node.child2 = NULL_NODE;
+        node.height = 0;
+        return index;
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::freeNode(int index)
+    {
+        mNodes[index].parent = mFreeList;
+        mNodes[index].height = -1;
+        mFreeList = index;
+    }
+    //-----------------------------------------------------------------------
+    int Bvh::createProxy(const AxisAlignedBox& box, void* userData)
+    {
+        assert(box.isFinite() && "Only finite boxes can be stored in a Bvh");
+
+        int proxy = allocateNode();
+        TreeNode& node = mNodes[proxy];
+        const Vector3 margin = box.getSize() * mMargin;
+        node.minimum = box.getMinimum() - margin;
+        node.maximum = box.getMaximum() + margin;
+        node.userData = userData;
+
+        insertLeaf(proxy);
+        ++mNumProxies;
+        return proxy;
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::destroyProxy(int proxy)
+    {
+        assert(mNodes[proxy].isLeaf() && mNodes[proxy].height == 0);
+
+        removeLeaf(proxy);
+        freeNode(proxy);
+        --mNumProxies;
+    }
+    //-----------------------------------------------------------------------
+    bool Bvh::moveProxy(int proxy, const AxisAlignedBox& box)
+    {
+        assert(box.isFinite() && "Only finite boxes can be stored in a Bvh");
+
+        TreeNode& node = mNodes[proxy];
+        if (contains(node.minimum, node.maximum, box.getMinimum(), box.getMaximum()))
+            return false;
+
+        const Vector3 margin = box.getSize() * mMargin;
+        const Vector3 minimum = box.getMinimum() - margin;
+        const Vector3 maximum = box.getMaximum() + margin;
+
+        int parent = node.parent;
+        if (parent != NULL_NODE &&
+            contains(mNodes[parent].minimum, mNodes[parent].maximum, minimum, maximum))
+        {
+            // Still local to its subtree, just shrink the ancestors where possible
+            node.minimum = minimum;
+            node.maximum = maximum;
+            refit(parent);
+        }
+        else
+        {
+            removeLeaf(proxy);
+            node.minimum = minimum;
+            node.maximum = maximum;
+            insertLeaf(proxy);
+        }
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    AxisAlignedBox Bvh::getFatBox(int proxy) const
+    {
+        return AxisAlignedBox(mNodes[proxy].minimum, mNodes[proxy].maximum);
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::clear(void)
+    {
+        mNodes.clear();
+        mRoot = NULL_NODE;
+        mFreeList = NULL_NODE;
+        mNumProxies = 0;
+    }
+    //-----------------------------------------------------------------------
+    int Bvh::getHeight(void) const
+    {
+        return mRoot == NULL_NODE ? 0 : mNodes[mRoot].height;
+    }
+    //-----------------------------------------------------------------------
+    Real Bvh::getCost(void) const
+    {
+        if (mRoot == NULL_NODE)
+            return 0;
+
+        Real rootArea = halfArea(mNodes[mRoot].minimum, mNodes[mRoot].maximum);
+        if (rootArea <= 0)
+            return 0;
+
+        Real totalArea = 0;
+        TreeNodeList::const_iterator i, iend = mNodes.end();
+        for (i = mNodes.begin(); i != iend; ++i)
+        {
+            if (i->height > 0)
+                totalArea += halfArea(i->minimum, i->maximum);
+        }
+        return totalArea / rootArea;
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::insertLeaf(int leaf)
+    {
+        if (mRoot == NULL_NODE)
+        {
+            mRoot = leaf;
+            mNodes[leaf].parent = NULL_NODE;
+            return;
+        }
+
+        const Vector3 leafMin = mNodes[leaf].minimum;
+        const Vector3 leafMax = mNodes[leaf].maximum;
+
+        // Descend towards the sibling with the lowest SAH cost increase
+        int index = mRoot;
+        while (!mNodes[index].isLeaf())
+        {
+            const TreeNode& node = mNodes[index];
+            Real area = halfArea(node.minimum, node.maximum);
+            Real combinedArea = mergedHalfArea(node.minimum, node.maximum, leafMin, leafMax);
+
+            // Cost of making the leaf a sibling of this node
+            Real cost = 2 * combinedArea;
+            // Cost pushed down to the children by growing this node
+            Real inheritanceCost = 2 * (combinedArea - area);
+
+            Real childCost[2];
+            int children[2] = { node.child1, node.child2 };
+            for (int c = 0; c < 2; ++c)
+            {
+                const TreeNode& child = mNodes[children[c]];
+                Real merged = mergedHalfArea(child.minimum, child.maximum, leafMin, leafMax);
+                if (child.isLeaf())
+                    childCost[c] = merged + inheritanceCost;
+                else
+                    childCost[c] = merged - halfArea(child.minimum, child.maximum) + inheritanceCost;
+            }
+
+            if (cost < childCost[0] && cost < childCost[1])
+                break;
+
+            index = childCost[0] < childCost[1] ? children[0] : children[1];
+        }
+
+        // Pair the leaf with the sibling under a new parent
+        int sibling = index;
+        int oldParent = mNodes[sibling].parent;
+        int newParent = allocateNode();
+        TreeNode& parentNode = mNodes[newParent];
+        parentNode.parent = oldParent;
+        parentNode.child1 = sibling;
+        parentNode.child2 = leaf;
+        parentNode.height = mNodes[sibling].height + 1;
+        parentNode.minimum = mNodes[sibling].minimum;
+        parentNode.maximum = mNodes[sibling].maximum;
+        parentNode.minimum.makeFloor(leafMin);
+        parentNode.maximum.makeCeil(leafMax);
+
+        if (oldParent != NULL_NODE)
+        {
+            if (mNodes[oldParent].child1 == sibling)
+                mNodes[oldParent].child1 = newParent;
+            else
+                mNodes[oldParent].child2 = newParent;
+        }
+        else
+        {
+            mRoot = newParent;
+        }
+        mNodes[sibling].parent = newParent;
+        mNodes[leaf].parent = newParent;
+
+        refit(oldParent);
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::removeLeaf(int leaf)
+    {
+        if (leaf == mRoot)
+        {
+            mRoot = NULL_NODE;
+            return;
+        }
+
+        int parent = mNodes[leaf].parent;
+        int grandParent = mNodes[parent].parent;
+        int sibling = mNodes[parent].child1 == leaf ? mNodes[parent].child2 : mNodes[parent].child1;
+
+        // The sibling takes the place of the parent
+        if (grandParent != NULL_NODE)
+        {
+            if (mNodes[grandParent].child1 == parent)
+                mNodes[grandParent].child1 = sibling;
+            else
+                mNodes[grandParent].child2 = sibling;
+            mNodes[sibling].parent = grandParent;
+            freeNode(parent);
+            refit(grandParent);
+        }
+        else
+        {
+            mRoot = sibling;
+            mNodes[sibling].parent = NULL_NODE;
+            freeNode(parent);
+        }
+        mNodes[leaf].parent = NULL_NODE;
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::refit(int index)
+    {
+        while (index != NULL_NODE)
+        {
+            TreeNode& node = mNodes[index];
+            const TreeNode& child1 = mNodes[node.child1];
+            const TreeNode& child2 = mNodes[node.child2];
+
+            node.minimum = child1.minimum;
+            node.maximum = child1.maximum;
+            node.minimum.makeFloor(child2.minimum);
+            node.maximum.makeCeil(child2.maximum);
+            node.height = 1 + std::max(child1.height, child2.height);
+
+            rotate(index);
+            index = mNodes[index].parent;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::rotate(int index)
+    {
+        // Try swapping each child with one of the other child's children. The
+        // node itself keeps the same leaves, only the swapped-into child changes.
+        const TreeNode& node = mNodes[index];
+        int bestChild = NULL_NODE, bestGrandChild = NULL_NODE;
+        Real bestGain = 0;
+
+        int children[2] = { node.child1, node.child2 };
+        for (int c = 0; c < 2; ++c)
+        {
+            int moved = children[c];
+            int other = children[1 - c];
+            const TreeNode& otherNode = mNodes[other];
+            if (otherNode.isLeaf())
+                continue;
+
+            Real otherArea = halfArea(otherNode.minimum, otherNode.maximum);
+            int grandChildren[2] = { otherNode.child1, otherNode.child2 };
+            for (int g = 0; g < 2; ++g)
+            {
+                // 'moved' replaces grandChildren[g] under 'other'
+                const TreeNode& kept = mNodes[grandChildren[1 - g]];
+                Real gain = otherArea - mergedHalfArea(kept.minimum, kept.maximum,
+                    mNodes[moved].minimum, mNodes[moved].maximum);
+                if (gain > bestGain)
+                {
+                    bestGain = gain;
+                    bestChild = moved;
+                    bestGrandChild = grandChildren[g];
+                }
+            }
+        }
+
+        if (bestChild == NULL_NODE)
+            return;
+
+        int other = mNodes[bestGrandChild].parent;
+        TreeNode& otherNode = mNodes[other];
+
+        // Exchange bestChild and bestGrandChild
+        if (mNodes[index].child1 == bestChild)
+            mNodes[index].child1 = bestGrandChild;
+        else
+            mNodes[index].child2 = bestGrandChild;
+        if (otherNode.child1 == bestGrandChild)
+            otherNode.child1 = bestChild;
+        else
+            otherNode.child2 = bestChild;
+        mNodes[bestGrandChild].parent = index;
+        mNodes[bestChild].parent = other;
+
+        const TreeNode& child1 = mNodes[otherNode.child1];
+        const TreeNode& child2 = mNodes[otherNode.child2];
+        otherNode.minimum = child1.minimum;
+        otherNode.maximum = child1.maximum;
+        otherNode.minimum.makeFloor(child2.minimum);
+        otherNode.maximum.makeCeil(child2.maximum);
+        otherNode.height = 1 + std::max(child1.height, child2.height);
+
+        TreeNode& rotated = mNodes[index];
+        rotated.height = 1 + std::max(mNodes[rotated.child1].height, mNodes[rotated.child2].height);
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::rebuild(void)
+    {
+        if (mNumProxies < 3)
+            return;
+
+        ProxyList leaves;
+        leaves.reserve(mNumProxies);
+        vector<Vector3>::type centres(mNodes.size());
+        for (size_t i = 0; i < mNodes.size(); ++i)
+        {
+            TreeNode& node = mNodes[i];
+            if (node.height == 0)
+            {
+                leaves.push_back(static_cast<int>(i));
+                centres[i] = (node.minimum + node.maximum) * 0.5f;
+            }
+            else if (node.height > 0)
+            {
+                freeNode(static_cast<int>(i));
+            }
+        }
+
+        mRoot = build(&leaves[0], leaves.size(), &centres[0]);
+        mNodes[mRoot].parent = NULL_NODE;
+    }
+    //-----------------------------------------------------------------------
+    int Bvh::build(int* leaves, size_t count, const Vector3* centres)
+    {
+        if (count == 1)
+            return leaves[0];
+
+        // Bin the leaf centres along the longest axis of their bounds
+        Vector3 centreMin = centres[leaves[0]], centreMax = centreMin;
+        for (size_t i = 1; i < count; ++i)
+        {
+            centreMin.makeFloor(centres[leaves[i]]);
+            centreMax.makeCeil(centres[leaves[i]]);
+        }
+        const Vector3 extent = centreMax - centreMin;
+        int axis = 0;
+        if (extent.y > extent[axis]) axis = 1;
+        if (extent.z > extent[axis]) axis = 2;
+
+        size_t split = 0;
+        if (extent[axis] > 0)
+        {
+            const Real scale = NUM_BINS / extent[axis];
+            size_t binCount[NUM_BINS] = { 0 };
+            Vector3 binMin[NUM_BINS], binMax[NUM_BINS];
+            for (size_t b = 0; b < NUM_BINS; ++b)
+            {
+                binMin[b] = Vector3(Math::POS_INFINITY, Math::POS_INFINITY, Math::POS_INFINITY);
+                binMax[b] = Vector3(Math::NEG_INFINITY, Math::NEG_INFINITY, Math::NEG_INFINITY);
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                const TreeNode& leaf = mNodes[leaves[i]];
+                size_t b = std::min(static_cast<size_t>(
+                    (centres[leaves[i]][axis] - centreMin[axis]) * scale), NUM_BINS - 1);
+                ++binCount[b];
+                binMin[b].makeFloor(leaf.minimum);
+                binMax[b].makeCeil(leaf.maximum);
+            }
+
+            // Sweep from the right, then evaluate every split from the left
+            Real rightCost[NUM_BINS];
+            Vector3 sweepMin = binMin[NUM_BINS - 1], sweepMax = binMax[NUM_BINS - 1];
+            size_t sweepCount = 0;
+            for (size_t b = NUM_BINS - 1; b > 0; --b)
+            {
+                sweepMin.makeFloor(binMin[b]);
+                sweepMax.makeCeil(binMax[b]);
+                sweepCount += binCount[b];
+                rightCost[b] = sweepCount ? halfArea(sweepMin, sweepMax) * sweepCount : 0;
+            }
+
+            Real bestCost = Math::POS_INFINITY;
+            sweepMin = binMin[0];
+            sweepMax = binMax[0];
+            sweepCount = 0;
+            for (size_t b = 1; b < NUM_BINS; ++b)
+            {
+                sweepMin.makeFloor(binMin[b - 1]);
+                sweepMax.makeCeil(binMax[b - 1]);
+                sweepCount += binCount[b - 1];
+                if (sweepCount == 0 || sweepCount == count)
+                    continue;
+                Real cost = halfArea(sweepMin, sweepMax) * sweepCount + rightCost[b];
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    split = b;
+                }
+            }
+
+            if (split)
+            {
+                int* middle = std::partition(leaves, leaves + count,
+                    BinBelow(centres, axis, centreMin[axis], scale, split));
+                split = static_cast<size_t>(middle - leaves);
+            }
+        }
+
+        // All centres in one bin: fall back to a median split
+        if (split == 0 || split == count)
+        {
+            split = count / 2;
+            std::nth_element(leaves, leaves + split, leaves + count, CentreLess(centres, axis));
+        }
+
+        int index = allocateNode();
+        int child1 = build(leaves, split, centres);
+        int child2 = build(leaves + split, count - split, centres);
+
+        TreeNode& node = mNodes[index];
+        node.child1 = child1;
+        node.child2 = child2;
+        node.minimum = mNodes[child1].minimum;
+        node.maximum = mNodes[child1].maximum;
+        node.minimum.makeFloor(mNodes[child2].minimum);
+        node.maximum.makeCeil(mNodes[child2].maximum);
+        node.height = 1 + std::max(mNodes[child1].height, mNodes[child2].height);
+        mNodes[child1].parent = index;
+        mNodes[child2].parent = index;
+        return index;
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::collectLeaves(int index, ProxyList& results) const
+    {
+        ProxyList stack;
+        stack.push_back(index);
+        while (!stack.empty())
+        {
+            const int current = stack.back();
+            stack.pop_back();
+            const TreeNode& node = mNodes[current];
+            if (node.isLeaf())
+            {
+                results.push_back(current);
+            }
+            else
+            {
+                stack.push_back(node.child2);
+                stack.push_back(node.child1);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    template <typename Test>
+    void Bvh::query(const Test& test, ProxyList& results) const
+    {
+        if (mRoot == NULL_NODE)
+            return;
+
+        ProxyList stack;
+        stack.reserve(64);
+        stack.push_back(mRoot);
+        while (!stack.empty())
+        {
+            const int current = stack.back();
+            stack.pop_back();
+            const TreeNode& node = mNodes[current];
+            if (!test(node.minimum, node.maximum))
+                continue;
+
+            if (node.isLeaf())
+            {
+                results.push_back(current);
+            }
+            else
+            {
+                stack.push_back(node.child2);
+                stack.push_back(node.child1);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::findIntersecting(const AxisAlignedBox& box, ProxyList& results) const
+    {
+        if (box.isNull() || mRoot == NULL_NODE)
+            return;
+        if (box.isInfinite())
+        {
+            collectLeaves(mRoot, results);
+            return;
+        }
+        query(BoxTest(box), results);
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::findIntersecting(const Sphere& sphere, ProxyList& results) const
+    {
+        query(SphereTest(sphere), results);
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::findIntersecting(const PlaneBoundedVolume& volume, ProxyList& results) const
+    {
+        query(VolumeTest(volume), results);
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::findIntersecting(const Ray& ray, ProxyList& results) const
+    {
+        query(RayTest(ray), results);
+    }
+    //-----------------------------------------------------------------------
+    void Bvh::findVisible(const Plane* planes, size_t numPlanes, ProxyList& results) const
+    {
+        if (mRoot == NULL_NODE)
+            return;
+
+        assert(numPlanes <= 32);
+        // Each entry carries the planes its subtree still has to be tested against
+        typedef std::pair<int, uint32> Entry;
+        vector<Entry>::type stack;
+        stack.reserve(64);
+        stack.push_back(Entry(mRoot, numPlanes < 32 ? (1u << numPlanes) - 1 : 0xFFFFFFFF));
+        while (!stack.empty())
+        {
+            const Entry entry = stack.back();
+            stack.pop_back();
+            const TreeNode& node = mNodes[entry.first];
+
+            uint32 mask = entry.second;
+            const Vector3 centre = (node.minimum + node.maximum) * 0.5f;
+            const Vector3 halfSize = (node.maximum - node.minimum) * 0.5f;
+            bool culled = false;
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                const uint32 bit = 1u << p;
+                if (!(mask & bit))
+                    continue;
+
+                Plane::Side side = planes[p].getSide(centre, halfSize);
+                if (side == Plane::NEGATIVE_SIDE)
+                {
+                    culled = true;
+                    break;
+                }
+                if (side == Plane::POSITIVE_SIDE)
+                    mask &= ~bit;
+            }
+            if (culled)
+                continue;
+
+            if (node.isLeaf())
+            {
+                results.push_back(entry.first);
+            }
+            else if (mask == 0)
+            {
+                // Fully inside, everything below is visible
+                collectLeaves(entry.first, results);
+            }
+            else
+            {
+                stack.push_back(Entry(node.child2, mask));
+                stack.push_back(Entry(node.child1, mask));
+            }
+        }
+    }
+}
@@ -0,0 +1,324 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBvhSceneManager.h"
+#include "OgreBvhSceneNode.h"
+#include "OgreBvhSceneQuery.h"
+#include "OgreCamera.h"
+#include "OgreRenderQueue.h"
+
+namespace Ogre
+{
+    //-----------------------------------------------------------------------
+    BvhSceneManager::BvhSceneManager(const String& name)
+        : SceneManager(name)
+    {
+    }
+    //-----------------------------------------------------------------------
+    BvhSceneManager::~BvhSceneManager()
+    {
+        // The base class destroys the nodes after our members, make sure they
+        // no longer refer to the tree by then
+        SceneNodeList::iterator i, iend = mSceneNodes.end();
+        for (i = mSceneNodes.begin(); i != iend; ++i)
+        {
+            BvhSceneNode* node = static_cast<BvhSceneNode*>(i->second);
+            node->_setProxy(Bvh::NULL_NODE);
+            node->_setInfinite(false);
+        }
+        if (mSceneRoot)
+        {
+            static_cast<BvhSceneNode*>(mSceneRoot)->_setProxy(Bvh::NULL_NODE);
+            static_cast<BvhSceneNode*>(mSceneRoot)->_setInfinite(false);
+        }
+    }
+    //-----------------------------------------------------------------------
+    const String& BvhSceneManager::getTypeName(void) const
+    {
+        return BvhSceneManagerFactory::FACTORY_TYPE_NAME;
+    }
+    //-----------------------------------------------------------------------
+    SceneNode* BvhSceneManager::createSceneNodeImpl(void)
+    {
+        return OGRE_NEW BvhSceneNode(this);
+    }
+    //-----------------------------------------------------------------------
+    SceneNode* BvhSceneManager::createSceneNodeImpl(const String& name)
+    {
+        return OGRE_NEW BvhSceneNode(this, name);
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::_updateBvhNode(BvhSceneNode* node)
+    {
+        const AxisAlignedBox& box = node->_getWorldAABB();
+        if (!box.isFinite())
+        {
+            _removeBvhNode(node);
+            if (box.isInfinite())
+            {
+                mInfiniteNodes.push_back(node);
+                node->_setInfinite(true);
+            }
+            return;
+        }
+
+        if (node->_isInfinite())
+            _removeBvhNode(node);
+
+        if (node->_getProxy() == Bvh::NULL_NODE)
+            node->_setProxy(mBvh.createProxy(box, node));
+        else
+            mBvh.moveProxy(node->_getProxy(), box);
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::_removeBvhNode(BvhSceneNode* node)
+    {
+        if (node->_getProxy() != Bvh::NULL_NODE)
+        {
+            mBvh.destroyProxy(node->_getProxy());
+            node->_setProxy(Bvh::NULL_NODE);
+        }
+        if (node->_isInfinite())
+        {
+            SceneNode::SceneNodeList::iterator i =
+                std::find(mInfiniteNodes.begin(), mInfiniteNodes.end(), node);
+            if (i != mInfiniteNodes.end())
+            {
+                *i = mInfiniteNodes.back();
+                mInfiniteNodes.pop_back();
+            }
+            node->_setInfinite(false);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::_findVisibleObjects(Camera* cam,
+        VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
+    {
+        // Same planes as Frustum::isVisible, honouring the culling frustum
+        const Frustum* frustum = cam->getCullingFrustum();
+        if (!frustum)
+            frustum = cam;
+        Plane planes[6];
+        size_t numPlanes = 0;
+        for (unsigned short plane = 0; plane < 6; ++plane)
+        {
+            // Skip far plane if infinite view frustum
+            if (plane == FRUSTUM_PLANE_FAR && frustum->getFarClipDistance() == 0)
+                continue;
+            planes[numPlanes++] = frustum->getFrustumPlane(plane);
+        }
+
+        mVisibleProxies.clear();
+        mBvh.findVisible(planes, numPlanes, mVisibleProxies);
+
+        RenderQueue* queue = getRenderQueue();
+        unsigned int numVisible = 0;
+        const size_t numCandidates = mVisibleProxies.size() + mInfiniteNodes.size();
+        for (size_t i = 0; i < numCandidates; ++i)
+        {
+            SceneNode* node;
+            if (i < mVisibleProxies.size())
+            {
+                node = static_cast<BvhSceneNode*>(mBvh.getUserData(mVisibleProxies[i]));
+                // The tree only holds fat boxes, check the real bounds too
+                if (!cam->isVisible(node->_getWorldAABB()))
+                    continue;
+            }
+            else
+            {
+                node = mInfiniteNodes[i - mVisibleProxies.size()];
+            }
+
+            node->_addToRenderQueue(cam, queue, onlyShadowCasters, visibleBounds);
+            if (mDisplayNodes)
+                queue->addRenderable(node->getDebugRenderable());
+            if (!node->getHideBoundingBox() &&
+                (node->getShowBoundingBox() || mShowBoundingBoxes))
+                node->_addBoundingBoxToQueue(queue);
+            ++numVisible;
+        }
+        cam->_notifyCulledNodes(numVisible, static_cast<unsigned int>(
+            mBvh.getNumProxies() + mInfiniteNodes.size() - numVisible));
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::addNodes(const Bvh::ProxyList& proxies, SceneNode::SceneNodeList& list) const
+    {
+        Bvh::ProxyList::const_iterator i, iend = proxies.end();
+        for (i = proxies.begin(); i != iend; ++i)
+        {
+            list.push_back(static_cast<BvhSceneNode*>(mBvh.getUserData(*i)));
+        }
+        list.insert(list.end(), mInfiniteNodes.begin(), mInfiniteNodes.end());
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::findNodesIn(const AxisAlignedBox& box, SceneNode::SceneNodeList& list)
+    {
+        Bvh::ProxyList proxies;
+        mBvh.findIntersecting(box, proxies);
+        addNodes(proxies, list);
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::findNodesIn(const Sphere& sphere, SceneNode::SceneNodeList& list)
+    {
+        Bvh::ProxyList proxies;
+        mBvh.findIntersecting(sphere, proxies);
+        addNodes(proxies, list);
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::findNodesIn(const PlaneBoundedVolume& volume, SceneNode::SceneNodeList& list)
+    {
+        Bvh::ProxyList proxies;
+        mBvh.findIntersecting(volume, proxies);
+        addNodes(proxies, list);
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::findNodesIn(const Ray& ray, SceneNode::SceneNodeList& list)
+    {
+        Bvh::ProxyList proxies;
+        mBvh.findIntersecting(ray, proxies);
+        addNodes(proxies, list);
+    }
+    //-----------------------------------------------------------------------
+    bool BvhSceneManager::setOption(const String& key, const void* value)
+    {
+        if (key == "BvhMargin")
+        {
+            mBvh.setMargin(*static_cast<const Real*>(value));
+            return true;
+        }
+        else if (key == "RebuildBvh")
+        {
+            if (*static_cast<const bool*>(value))
+                rebuildBvh();
+            return true;
+        }
+
+        return SceneManager::setOption(key, value);
+    }
+    //-----------------------------------------------------------------------
+    bool BvhSceneManager::getOption(const String& key, void* destValue)
+    {
+        if (key == "BvhMargin")
+        {
+            *static_cast<Real*>(destValue) = mBvh.getMargin();
+            return true;
+        }
+        else if (key == "BvhHeight")
+        {
+            *static_cast<int*>(destValue) = mBvh.getHeight();
+            return true;
+        }
+        else if (key == "BvhCost")
+        {
+            *static_cast<Real*>(destValue) = mBvh.getCost();
+            return true;
+        }
+
+        return SceneManager::getOption(key, destValue);
+    }
+    //-----------------------------------------------------------------------
+    bool BvhSceneManager::getOptionKeys(StringVector& refKeys)
+    {
+        SceneManager::getOptionKeys(refKeys);
+        refKeys.push_back("BvhMargin");
+        refKeys.push_back("RebuildBvh");
+        refKeys.push_back("BvhHeight");
+        refKeys.push_back("BvhCost");
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManager::clearScene(void)
+    {
+        SceneManager::clearScene();
+        // The root is never detached, so it is not removed by the above
+        if (mSceneRoot)
+            _removeBvhNode(static_cast<BvhSceneNode*>(mSceneRoot));
+        assert(mBvh.getNumProxies() == 0 && mInfiniteNodes.empty());
+        mBvh.clear();
+    }
+    //-----------------------------------------------------------------------
+    AxisAlignedBoxSceneQuery* BvhSceneManager::createAABBQuery(const AxisAlignedBox& box, uint32 mask)
+    {
+        BvhAxisAlignedBoxSceneQuery* q = OGRE_NEW BvhAxisAlignedBoxSceneQuery(this);
+        q->setBox(box);
+        q->setQueryMask(mask);
+        return q;
+    }
+    //-----------------------------------------------------------------------
+    SphereSceneQuery* BvhSceneManager::createSphereQuery(const Sphere& sphere, uint32 mask)
+    {
+        BvhSphereSceneQuery* q = OGRE_NEW BvhSphereSceneQuery(this);
+        q->setSphere(sphere);
+        q->setQueryMask(mask);
+        return q;
+    }
+    //-----------------------------------------------------------------------
+    PlaneBoundedVolumeListSceneQuery* BvhSceneManager::createPlaneBoundedVolumeQuery(
+        const PlaneBoundedVolumeList& volumes, uint32 mask)
+    {
+        BvhPlaneBoundedVolumeListSceneQuery* q = OGRE_NEW BvhPlaneBoundedVolumeListSceneQuery(this);
+        q->setVolumes(volumes);
+        q->setQueryMask(mask);
+        return q;
+    }
+    //-----------------------------------------------------------------------
+    RaySceneQuery* BvhSceneManager::createRayQuery(const Ray& ray, uint32 mask)
+    {
+        BvhRaySceneQuery* q = OGRE_NEW BvhRaySceneQuery(this);
+        q->setRay(ray);
+        q->setQueryMask(mask);
+        return q;
+    }
+    //-----------------------------------------------------------------------
+    IntersectionSceneQuery* BvhSceneManager::createIntersectionQuery(uint32 mask)
+    {
+        BvhIntersectionSceneQuery* q = OGRE_NEW BvhIntersectionSceneQuery(this);
+        q->setQueryMask(mask);
+        return q;
+    }
+    //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    const String BvhSceneManagerFactory::FACTORY_TYPE_NAME = "BvhSceneManager";
+    //-----------------------------------------------------------------------
+    void BvhSceneManagerFactory::initMetaData(void) const
+    {
+        mMetaData.typeName = FACTORY_TYPE_NAME;
+        mMetaData.description = "Scene manager organising the scene in a dynamic bounding volume hierarchy.";
+        mMetaData.sceneTypeMask = 0xFFFF; // support all types
+        mMetaData.worldGeometrySupported = false;
+    }
+    //-----------------------------------------------------------------------
+    SceneManager* BvhSceneManagerFactory::createInstance(const String& instanceName)
+    {
+        return OGRE_NEW BvhSceneManager(instanceName);
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneManagerFactory::destroyInstance(SceneManager* instance)
+    {
+        OGRE_DELETE instance;
+    }
+}
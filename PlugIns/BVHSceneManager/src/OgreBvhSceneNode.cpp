@@ -0,0 +1,83 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBvhSceneNode.h"
+#include "OgreBvhSceneManager.h"
+
+namespace Ogre
+{
+    //-----------------------------------------------------------------------
+    BvhSceneNode::BvhSceneNode(SceneManager* creator)
+        : SceneNode(creator)
+        , mProxy(Bvh::NULL_NODE)
+        , mInfinite(false)
+    {
+    }
+    //-----------------------------------------------------------------------
+    BvhSceneNode::BvhSceneNode(SceneManager* creator, const String& name)
+        : SceneNode(creator, name)
+        , mProxy(Bvh::NULL_NODE)
+        , mInfinite(false)
+    {
+    }
+    //-----------------------------------------------------------------------
+    BvhSceneNode::~BvhSceneNode()
+    {
+        // Nodes are normally taken out when they leave the scene graph, but
+        // the root never does
+        if (mProxy != Bvh::NULL_NODE || mInfinite)
+        {
+            static_cast<BvhSceneManager*>(mCreator)->_removeBvhNode(this);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneNode::_updateBounds(void)
+    {
+        mWorldAABB.setNull();
+
+        // Update bounds from own attached objects only
+        ObjectMap::iterator i, iend = mObjectsByName.end();
+        for (i = mObjectsByName.begin(); i != iend; ++i)
+        {
+            mWorldAABB.merge(i->second->getWorldBoundingBox(true));
+        }
+
+        if (mIsInSceneGraph)
+        {
+            static_cast<BvhSceneManager*>(mCreator)->_updateBvhNode(this);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void BvhSceneNode::setInSceneGraph(bool inGraph)
+    {
+        if (!inGraph && (mProxy != Bvh::NULL_NODE || mInfinite))
+        {
+            static_cast<BvhSceneManager*>(mCreator)->_removeBvhNode(this);
+        }
+        SceneNode::setInSceneGraph(inGraph);
+    }
+}
@@ -0,0 +1,266 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreBvhSceneQuery.h"
+#include "OgreBvhSceneManager.h"
+#include "OgreEntity.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        /** Reports the objects of the given nodes, and the objects attached to
+            their entities, which pass the masks and intersect the volume.
+        @return false if the listener asked to stop.
+        */
+        template <typename Volume>
+        bool reportObjects(const SceneNode::SceneNodeList& nodes, const Volume& volume,
+            uint32 queryMask, uint32 typeMask, set<MovableObject*>::type* reported,
+            SceneQueryListener* listener)
+        {
+            SceneNode::SceneNodeList::const_iterator it, itend = nodes.end();
+            for (it = nodes.begin(); it != itend; ++it)
+            {
+                SceneNode::ObjectIterator oit = (*it)->getAttachedObjectIterator();
+                while (oit.hasMoreElements())
+                {
+                    MovableObject* m = oit.getNext();
+                    if (!(m->getQueryFlags() & queryMask) ||
+                        !(m->getTypeFlags() & typeMask) ||
+                        !m->isInScene() ||
+                        !volume.intersects(m->getWorldBoundingBox()))
+                        continue;
+
+                    if (!reported || reported->insert(m).second)
+                    {
+                        if (!listener->queryResult(m))
+                            return false;
+                    }
+
+                    // deal with attached objects, since they are not directly attached to nodes
+                    if (m->getMovableType() == "Entity")
+                    {
+                        Entity* e = static_cast<Entity*>(m);
+                        Entity::ChildObjectListIterator childIt = e->getAttachedObjectIterator();
+                        while (childIt.hasMoreElements())
+                        {
+                            MovableObject* c = childIt.getNext();
+                            if ((c->getQueryFlags() & queryMask) &&
+                                volume.intersects(c->getWorldBoundingBox()) &&
+                                (!reported || reported->insert(c).second))
+                            {
+                                if (!listener->queryResult(c))
+                                    return false;
+                            }
+                        }
+                    }
+                }
+            }
+            return true;
+        }
+    }
+    //-----------------------------------------------------------------------
+    BvhIntersectionSceneQuery::BvhIntersectionSceneQuery(SceneManager* creator)
+        : DefaultIntersectionSceneQuery(creator)
+    {
+    }
+    //-----------------------------------------------------------------------
+    BvhIntersectionSceneQuery::~BvhIntersectionSceneQuery()
+    {
+    }
+    //-----------------------------------------------------------------------
+    void BvhIntersectionSceneQuery::execute(IntersectionSceneQueryListener* listener)
+    {
+        BvhSceneManager* sceneMgr = static_cast<BvhSceneManager*>(mParentSceneMgr);
+
+        SceneNode::SceneNodeList nodes, candidates;
+        sceneMgr->findNodesIn(AxisAlignedBox::BOX_INFINITE, nodes);
+
+        // Every overlapping pair of nodes is found from both sides, only handle
+        // it from the node visited first. Ordering by address instead would make
+        // the order of the objects within a pair change from run to run.
+        typedef map<SceneNode*, size_t>::type NodeOrderMap;
+        NodeOrderMap order;
+        for (size_t i = 0; i < nodes.size(); ++i)
+            order[nodes[i]] = i;
+
+        for (size_t ai = 0; ai < nodes.size(); ++ai)
+        {
+            SceneNode* a = nodes[ai];
+            candidates.clear();
+            sceneMgr->findNodesIn(a->_getWorldAABB(), candidates);
+
+            SceneNode::SceneNodeList::iterator b, bend = candidates.end();
+            for (b = candidates.begin(); b != bend; ++b)
+            {
+                if (order[*b] < ai)
+                    continue;
+
+                SceneNode::ObjectIterator oitA = a->getAttachedObjectIterator();
+                while (oitA.hasMoreElements())
+                {
+                    MovableObject* ma = oitA.getNext();
+                    if (!(ma->getQueryFlags() & mQueryMask) ||
+                        !(ma->getTypeFlags() & mQueryTypeMask) ||
+                        !ma->isInScene())
+                        continue;
+
+                    SceneNode::ObjectIterator oitB = (*b)->getAttachedObjectIterator();
+                    if (a == *b)
+                    {
+                        // Within a node, only pair each object with the ones after it
+                        while (oitB.hasMoreElements() && oitB.peekNextValue() != ma)
+                            oitB.moveNext();
+                        oitB.moveNext();
+                    }
+                    while (oitB.hasMoreElements())
+                    {
+                        MovableObject* mb = oitB.getNext();
+                        if ((mb->getQueryFlags() & mQueryMask) &&
+                            (mb->getTypeFlags() & mQueryTypeMask) &&
+                            mb->isInScene() &&
+                            ma->getWorldBoundingBox().intersects(mb->getWorldBoundingBox()))
+                        {
+                            if (!listener->queryResult(ma, mb))
+                                return;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    BvhAxisAlignedBoxSceneQuery::BvhAxisAlignedBoxSceneQuery(SceneManager* creator)
+        : DefaultAxisAlignedBoxSceneQuery(creator)
+    {
+    }
+    //-----------------------------------------------------------------------
+    BvhAxisAlignedBoxSceneQuery::~BvhAxisAlignedBoxSceneQuery()
+    {
+    }
+    //-----------------------------------------------------------------------
+    void BvhAxisAlignedBoxSceneQuery::execute(SceneQueryListener* listener)
+    {
+        SceneNode::SceneNodeList nodes;
+        static_cast<BvhSceneManager*>(mParentSceneMgr)->findNodesIn(mAABB, nodes);
+        reportObjects(nodes, mAABB, mQueryMask, mQueryTypeMask, 0, listener);
+    }
+    //-----------------------------------------------------------------------
+    BvhSphereSceneQuery::BvhSphereSceneQuery(SceneManager* creator)
+        : DefaultSphereSceneQuery(creator)
+    {
+    }
+    //-----------------------------------------------------------------------
+    BvhSphereSceneQuery::~BvhSphereSceneQuery()
+    {
+    }
+    //-----------------------------------------------------------------------
+    void BvhSphereSceneQuery::execute(SceneQueryListener* listener)
+    {
+        SceneNode::SceneNodeList nodes;
+        static_cast<BvhSceneManager*>(mParentSceneMgr)->findNodesIn(mSphere, nodes);
+        reportObjects(nodes, mSphere, mQueryMask, mQueryTypeMask, 0, listener);
+    }
+    //-----------------------------------------------------------------------
+    BvhPlaneBoundedVolumeListSceneQuery::BvhPlaneBoundedVolumeListSceneQuery(SceneManager* creator)
+        : DefaultPlaneBoundedVolumeListSceneQuery(creator)
+    {
+    }
+    //-----------------------------------------------------------------------
+    BvhPlaneBoundedVolumeListSceneQuery::~BvhPlaneBoundedVolumeListSceneQuery()
+    {
+    }
+    //-----------------------------------------------------------------------
+    void BvhPlaneBoundedVolumeListSceneQuery::execute(SceneQueryListener* listener)
+    {
+        // An object inside several volumes is only reported once
+        set<MovableObject*>::type reported;
+        SceneNode::SceneNodeList nodes;
+
+        PlaneBoundedVolumeList::iterator pi, piend = mVolumes.end();
+        for (pi = mVolumes.begin(); pi != piend; ++pi)
+        {
+            nodes.clear();
+            static_cast<BvhSceneManager*>(mParentSceneMgr)->findNodesIn(*pi, nodes);
+            if (!reportObjects(nodes, *pi, mQueryMask, mQueryTypeMask, &reported, listener))
+                return;
+        }
+    }
+    //-----------------------------------------------------------------------
+    BvhRaySceneQuery::BvhRaySceneQuery(SceneManager* creator)
+        : DefaultRaySceneQuery(creator)
+    {
+    }
+    //-----------------------------------------------------------------------
+    BvhRaySceneQuery::~BvhRaySceneQuery()
+    {
+    }
+    //-----------------------------------------------------------------------
+    void BvhRaySceneQuery::execute(RaySceneQueryListener* listener)
+    {
+        SceneNode::SceneNodeList nodes;
+        static_cast<BvhSceneManager*>(mParentSceneMgr)->findNodesIn(mRay, nodes);
+
+        SceneNode::SceneNodeList::iterator it, itend = nodes.end();
+        for (it = nodes.begin(); it != itend; ++it)
+        {
+            SceneNode::ObjectIterator oit = (*it)->getAttachedObjectIterator();
+            while (oit.hasMoreElements())
+            {
+                MovableObject* m = oit.getNext();
+                if (!(m->getQueryFlags() & mQueryMask) ||
+                    !(m->getTypeFlags() & mQueryTypeMask) ||
+                    !m->isInScene())
+                    continue;
+
+                std::pair<bool, Real> result = mRay.intersects(m->getWorldBoundingBox());
+                if (!result.first)
+                    continue;
+
+                if (!listener->queryResult(m, result.second))
+                    return;
+
+                // deal with attached objects, since they are not directly attached to nodes
+                if (m->getMovableType() == "Entity")
+                {
+                    Entity* e = static_cast<Entity*>(m);
+                    Entity::ChildObjectListIterator childIt = e->getAttachedObjectIterator();
+                    while (childIt.hasMoreElements())
+                    {
+                        MovableObject* c = childIt.getNext();
+                        if (c->getQueryFlags() & mQueryMask)
+                        {
+                            result = mRay.intersects(c->getWorldBoundingBox());
+                            if (result.first && !listener->queryResult(c, result.second))
+                                return;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -187,7 +187,8 @@ public:
     IntersectionSceneQuery* createIntersectionQuery(uint32 mask);
 
 protected:
-
+    /** OctreeNodes relocate themselves in the octree while updating. */
+    bool isParallelUpdateSafe(void) const { return false; }
 
     Octree::NodeList mVisible;
 
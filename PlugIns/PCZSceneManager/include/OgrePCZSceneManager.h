@@ -331,6 +331,9 @@ namespace Ogre
         virtual void prepareShadowTextures(Camera* cam, Viewport* vp, const LightList* lightList = 0);
 
     protected:
+        /** PCZSceneNodes track their movement in _update, which the split update bypasses. */
+        bool isParallelUpdateSafe(void) const { return false; }
+
         /// Type of default zone to be used
         String mDefaultZoneTypeName;
 
@@ -47,6 +47,14 @@ namespace Ogre {
 
         UniformBufferList mShaderStorageBuffers;
 
+        /// Creates a persistently mapped ring, needs GL 4.4 or GL_ARB_buffer_storage
+        HardwareStreamingBuffer* createStreamingBufferImpl(size_t vertexSize, size_t numVertices);
+        /// Creates a persistently mapped index ring, with the same requirements
+        HardwareStreamingBuffer* createStreamingIndexBufferImpl(
+            HardwareIndexBuffer::IndexType itype, size_t numIndexes);
+        /// Respecifies the storage of a buffer as persistently mapped, returns the mapping or 0 on failure
+        void* mapPersistentStorage(GLenum target, GLuint bufferId, size_t sizeInBytes);
+
     public:
         GL3PlusHardwareBufferManagerBase();
         ~GL3PlusHardwareBufferManagerBase();
@@ -0,0 +1,62 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __GL3PlusHardwareStreamingBuffer_H__
+#define __GL3PlusHardwareStreamingBuffer_H__
+
+#include "OgreGL3PlusPrerequisites.h"
+#include "OgreHardwareStreamingBuffer.h"
+
+namespace Ogre {
+
+    /** Streaming buffer backed by persistently mapped buffer storage.
+    @remarks
+        The ring is allocated with glBufferStorage and mapped once with
+        GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT, each frame is fenced
+        with glFenceSync. Requires GL 4.4 or GL_ARB_buffer_storage.
+    */
+    class _OgreGL3PlusExport GL3PlusHardwareStreamingBuffer : public HardwareStreamingBuffer
+    {
+    protected:
+        void* createFence(void);
+        bool isFenceSignalled(void* fence);
+        void waitFence(void* fence);
+        void deleteFence(void* fence);
+
+        /// Buffer binding point and name of the ring, to unmap it again
+        GLenum mTarget;
+        GLuint mBufferId;
+
+    public:
+        GL3PlusHardwareStreamingBuffer(const HardwareVertexBufferSharedPtr& buffer, void* data);
+        GL3PlusHardwareStreamingBuffer(const HardwareIndexBufferSharedPtr& buffer, void* data);
+        ~GL3PlusHardwareStreamingBuffer();
+    };
+
+}
+
+#endif
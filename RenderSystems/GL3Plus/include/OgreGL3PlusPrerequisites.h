@@ -93,6 +93,8 @@ namespace Ogre {
 // Convenience macro from ARB_vertex_buffer_object spec
 #define GL_BUFFER_OFFSET(i) ((char *)NULL + (i))
 
+#define getGL3PlusSupportRef() static_cast<GL3PlusRenderSystem*>(Root::getSingleton().getRenderSystem())->getGLSupportRef()
+
 #if OGRE_COMPILER == OGRE_COMPILER_MSVC
 #   define __PRETTY_FUNCTION__ __FUNCTION__
 #endif
@@ -35,6 +35,12 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreGLSLShader.h"
 #include "OgreRenderWindow.h"
 #include "OgreGLRenderSystemCommon.h"
+#include "OgreGL3PlusStateCacheManager.h"
+
+// Shader storage buffer binding of the per draw data of multi draw calls
+#ifndef OGRE_GL3PLUS_MULTI_DRAW_BINDING
+#   define OGRE_GL3PLUS_MULTI_DRAW_BINDING 0
+#endif
 
 namespace Ogre {
     /** \addtogroup RenderSystems RenderSystems
@@ -58,8 +64,6 @@ namespace Ogre {
         /// Rendering loop control
         bool mStopRendering;
 
-        typedef OGRE_HashMap<GLenum, GLuint>  BindBufferMap;
-
         /// View matrix to set world against
         Matrix4 mViewMatrix;
         Matrix4 mWorldMatrix;
@@ -129,12 +133,14 @@ namespace Ogre {
         */
         GL3PlusRTTManager *mRTTManager;
 
-        /** These variables are used for caching RenderSystem state.
-            They are cached because OpenGL state changes can be quite expensive,
-            which is especially important on mobile or embedded systems.
+        /** One cache of the OpenGL state per context. The state is
+            cached because OpenGL state changes can be quite expensive.
         */
-        GLenum mActiveTextureUnit;
-        BindBufferMap mActiveBufferMap;
+        typedef map<GL3PlusContext*, GL3PlusStateCacheManager>::type CachesMap;
+        CachesMap mCaches;
+
+        /// State cache of the current context
+        GL3PlusStateCacheManager* mStateCacheManager;
 
         /// Check if the GL system has already been initialised
         bool mGLInitialised;
@@ -150,6 +156,15 @@ namespace Ogre {
         vector<GLuint>::type mRenderAttribsBound;
         vector<GLuint>::type mRenderInstanceAttribsBound;
 
+        /// Shader storage buffer holding the world matrices of the last multi draw call
+        GLuint mMultiDrawDataBuffer;
+        /// Indirect buffer holding the draw commands of the last multi draw call
+        GLuint mMultiDrawIndirectBuffer;
+        /// Staging for mMultiDrawDataBuffer
+        vector<float>::type mMultiDrawData;
+        /// Staging for mMultiDrawIndirectBuffer
+        vector<GLuint>::type mMultiDrawCommands;
+
 #if OGRE_NO_QUAD_BUFFER_STEREO == 0
 		/// @copydoc RenderSystem::setDrawBuffer
 		virtual bool setDrawBuffer(ColourBufferType colourBuffer);
@@ -172,13 +187,22 @@ namespace Ogre {
         GLint getTextureAddressingMode(TextureUnitState::TextureAddressingMode tam) const;
         GLenum getBlendMode(SceneBlendFactor ogreBlend) const;
 
-        bool activateGLTextureUnit(size_t unit);
         void bindVertexElementToGpu( const VertexElement &elem, HardwareVertexBufferSharedPtr vertexBuffer,
                                      const size_t vertexStart,
                                      vector<GLuint>::type &attribsBound,
                                      vector<GLuint>::type &instanceAttribsBound,
                                      bool updateVAO);
 
+        /** Binds the VAO of the active program and the vertex buffers of op to it.
+            Returns whether the VAO is being set up, to be passed to unbindVertexData
+            after drawing.
+        */
+        bool bindVertexData(const RenderOperation& op, size_t vertexStart, bool bindGlobalInstanceData);
+        /// Finishes the binding done by bindVertexData
+        void unbindVertexData(bool updateVAO);
+        /// Returns the primitive to draw an operation type with
+        GLint getGLPrimitiveType(RenderOperation::OperationType type) const;
+
     public:
         // Default constructor / destructor
         GL3PlusRenderSystem();
@@ -356,6 +380,21 @@ namespace Ogre {
 
         void _render(const RenderOperation& op);
 
+        /** See
+            RenderSystem
+        @remarks
+            The world matrices are bound as a shader storage buffer to binding
+            point OGRE_GL3PLUS_MULTI_DRAW_BINDING, column major, and the base
+            instance of every draw is its index:
+        @code
+            #extension GL_ARB_shader_draw_parameters : require
+            layout(std430, binding = 0) buffer OgreMultiDrawData { mat4 worldMatrices[]; };
+            ...
+            gl_Position = viewProjMatrix * (worldMatrices[gl_DrawIDARB] * vertex);
+        @endcode
+        */
+        void _renderMultiDraw(const RenderOperation* ops, const Matrix4* worldMatrices, size_t count);
+
         void setScissorTest(bool enabled, size_t left = 0, size_t top = 0, size_t right = 800, size_t bottom = 600);
 
         void clearFrameBuffer(unsigned int buffers,
@@ -374,6 +413,8 @@ namespace Ogre {
         // ----------------------------------
         /** Returns the main context */
         GL3PlusContext* _getMainContext() { return mMainContext; }
+        /** Returns the GL support class */
+        GL3PlusSupport* getGLSupportRef() { return mGLSupport; }
         /** Unregister a render target->context mapping. If the context of target
             is the current context, change the context to the main context so it
             can be destroyed safely.
@@ -385,6 +426,12 @@ namespace Ogre {
         /** Switch GL context, dealing with involved internal cached states too
          */
         void _switchContext(GL3PlusContext *context);
+        /** Returns the state cache of the current context */
+        GL3PlusStateCacheManager* _getStateCacheManager() { return mStateCacheManager; }
+        /** Select the state cache of a context, creating it if needed */
+        void switchContextCache(GL3PlusContext* context);
+        /** Drop the state cache of a context that is being destroyed */
+        void unregisterContextCache(GL3PlusContext* context);
         /** One time initialization for the RenderState of a context. Things that
             only need to be set once, like the LightingModel can be defined here.
         */
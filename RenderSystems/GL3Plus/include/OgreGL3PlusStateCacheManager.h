@@ -0,0 +1,427 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __GL3PlusStateCacheManager_H__
+#define __GL3PlusStateCacheManager_H__
+
+#include "OgreGL3PlusPrerequisites.h"
+
+typedef Ogre::GeneralAllocatedObject StateCacheAlloc;
+
+namespace Ogre
+{
+    /** An in memory cache of the OpenGL state of one context.
+     @remarks
+     State changes can be particularly expensive time wise. This is because
+     a change requires OpenGL to re-evaluate and update the state machine.
+     Because of the general purpose nature of OGRE we often set the state for
+     a specific texture, material, buffer, etc. But this may be the same as the
+     current status of the state machine and is therefore redundant and causes
+     unnecessary work to be performed by OpenGL.
+     @par
+     Instead we are caching the state so that we can check whether it actually
+     does need to be updated. GL objects are per context, so the render system
+     keeps one cache per context and switches it together with the context.
+     All binds of the tracked kinds have to go through the cache, otherwise the
+     cached values no longer match the GL state.
+     @par
+     When built without OGRE_CONFIG_ENABLE_GL_STATE_CACHE_SUPPORT every call is
+     forwarded to GL; the statistics then only count the issued calls.
+     */
+    class _OgreGL3PlusExport GL3PlusStateCacheManager : public StateCacheAlloc
+    {
+    public:
+        /// Kinds of state the redundant call statistics are gathered for
+        enum StateCategory
+        {
+            SCC_BUFFER,
+            SCC_VERTEX_ARRAY,
+            SCC_TEXTURE,
+            SCC_SAMPLER,
+            SCC_PROGRAM,
+            SCC_BLEND,
+            SCC_DEPTH,
+            SCC_STENCIL,
+            SCC_VIEWPORT,
+            SCC_RASTER,
+            SCC_COUNT
+        };
+
+        /// Number of GL calls routed through the cache, per state category
+        struct Stats
+        {
+            /// Calls that reached GL
+            size_t issuedCalls[SCC_COUNT];
+            /// Calls that were skipped because GL already had the requested state
+            size_t redundantCalls[SCC_COUNT];
+        };
+
+    protected:
+        typedef OGRE_HashMap<GLenum, GLuint> BindBufferMap;
+        typedef OGRE_HashMap<GLenum, GLint> TexParameteriMap;
+        typedef OGRE_HashMap<GLenum, GLfloat> TexParameterfMap;
+        typedef OGRE_HashMap<GLenum, bool> GLbooleanStateMap;
+
+        struct TextureUnitParams
+        {
+            TexParameteriMap mTexParameteriMap;
+            TexParameterfMap mTexParameterfMap;
+        };
+
+        typedef OGRE_HashMap<GLuint, TextureUnitParams> TexUnitsMap;
+
+        /// Texture bound to a texture unit
+        struct TextureBinding
+        {
+            GLenum target;
+            GLuint texture;
+        };
+
+        /// Stencil state of one face
+        struct StencilFaceState
+        {
+            GLenum func;
+            GLint ref;
+            GLuint valueMask;
+            GLuint writeMask;
+            GLenum stencilFail;
+            GLenum depthFail;
+            GLenum depthPass;
+        };
+
+        /// A map of different buffer types and the currently bound buffer for each type
+        BindBufferMap mActiveBufferMap;
+        /// A map of texture parameters for each texture id
+        TexUnitsMap mTexUnitsMap;
+        /// The texture bound on each texture unit
+        vector<TextureBinding>::type mBoundTextures;
+        /// Stores whether each OpenGL feature is enabled i.e. blending, depth test, etc.
+        GLbooleanStateMap mBoolStateMap;
+        /// Stores the current clear colour
+        GLclampf mClearColour[4];
+        /// Stores the current colour write mask
+        GLboolean mColourMask[4];
+        /// Stores the current depth write mask
+        GLboolean mDepthMask;
+        /// Stores the current polygon rendering mode
+        GLenum mPolygonMode;
+        /// Stores the current blend equations
+        GLenum mBlendEquationRGB;
+        GLenum mBlendEquationAlpha;
+        /// Stores the current blend functions
+        GLenum mBlendFuncSource;
+        GLenum mBlendFuncDest;
+        GLenum mBlendFuncSourceAlpha;
+        GLenum mBlendFuncDestAlpha;
+        /// Stores the current face culling setting
+        GLenum mCullFace;
+        /// Stores the current depth test function
+        GLenum mDepthFunc;
+        /// Stores the current polygon offset
+        GLfloat mPolygonOffsetFactor;
+        GLfloat mPolygonOffsetUnits;
+        /// Stores the stencil state, front face first
+        StencilFaceState mStencilFaces[2];
+        /// Stores the currently bound vertex array object
+        GLuint mVertexArray;
+        /// Stores the program in use
+        GLuint mProgram;
+        /// Stores the bound program pipeline
+        GLuint mProgramPipeline;
+        /// Stores the currently active texture unit
+        size_t mActiveTextureUnit;
+        /// Stores the current depth clearing value
+        GLclampd mClearDepth;
+        /// Stores the current viewport and scissor box
+        GLint mViewport[4];
+        GLint mScissor[4];
+        /// Call statistics
+        Stats mStats;
+
+        /// Records a call that was issued to GL
+        void notifyIssued(StateCategory category) { ++mStats.issuedCalls[category]; }
+        /// Records a call that was skipped
+        void notifyRedundant(StateCategory category) { ++mStats.redundantCalls[category]; }
+    public:
+        GL3PlusStateCacheManager(void);
+        ~GL3PlusStateCacheManager(void);
+
+        /** Initialize our cache variables and sets the
+            GL states on the current context.
+        */
+        void initializeCache();
+
+        /** Clears all cached values
+        */
+        void clearCache();
+
+        /** Bind an OpenGL buffer of any type.
+         @param target The buffer target.
+         @param buffer The buffer ID.
+         @param force Optional parameter to force an update.
+         */
+        void bindGLBuffer(GLenum target, GLuint buffer, bool force = false);
+
+        /** Bind an OpenGL buffer to an indexed binding point.
+         @remarks
+            Indexed binds are not cached, but they replace the generic binding
+            of the target, which the cache has to know about.
+         @param target The buffer target.
+         @param index The binding point.
+         @param buffer The buffer ID.
+         */
+        void bindGLBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+        /** Delete an OpenGL buffer of any type.
+         @param target The buffer target.
+         @param buffer The buffer ID.
+         */
+        void deleteGLBuffer(GLenum target, GLuint buffer);
+
+        /** Bind an OpenGL vertex array object.
+         @param vao The vertex array object ID.
+         */
+        void bindGLVertexArray(GLuint vao);
+
+        /** Delete an OpenGL vertex array object.
+         @param vao The vertex array object ID.
+         */
+        void deleteGLVertexArray(GLuint vao);
+
+        /** Bind an OpenGL texture of any type to the active texture unit.
+         @param target The texture target.
+         @param texture The texture ID.
+         */
+        void bindGLTexture(GLenum target, GLuint texture);
+
+        /** Delete an OpenGL texture and the state associated with it.
+         @param texture The texture ID.
+         */
+        void deleteGLTexture(GLuint texture);
+
+        /** Invalidates the state associated with a particular texture ID.
+         @param texture The texture ID.
+         */
+        void invalidateStateForTexture(GLuint texture);
+
+        /** Sets an integer parameter value of the texture bound on the active unit.
+         @param target The texture target.
+         @param pname The parameter name.
+         @param param The parameter value.
+         */
+        void setTexParameteri(GLenum target, GLenum pname, GLint param);
+
+        /** Sets a float parameter value of the texture bound on the active unit.
+         @param target The texture target.
+         @param pname The parameter name.
+         @param param The parameter value.
+         */
+        void setTexParameterf(GLenum target, GLenum pname, GLfloat param);
+
+        /** Activate an OpenGL texture unit.
+         @param unit The texture unit to activate.
+         @return Whether or not the texture unit was successfully activated.
+         */
+        bool activateGLTextureUnit(size_t unit);
+
+        /** Gets the currently active texture unit.
+         */
+        size_t getActiveTextureUnit(void) const { return mActiveTextureUnit; }
+
+        /** Use a linked program object.
+         @param program The program ID.
+         */
+        void bindGLProgram(GLuint program);
+
+        /** Bind a program pipeline object.
+         @param pipeline The program pipeline ID.
+         */
+        void bindGLProgramPipeline(GLuint pipeline);
+
+        /** Delete a program pipeline object.
+         @param pipeline The program pipeline ID.
+         */
+        void deleteGLProgramPipeline(GLuint pipeline);
+
+        /** Sets the current blend equation setting.
+         @param eq The blend equation to use.
+         */
+        void setBlendEquation(GLenum eq);
+
+        /** Sets the current blend equation setting for colour and alpha.
+         @param eqRGB The blend equation to use for the colour channels.
+         @param eqAlpha The blend equation to use for the alpha channel.
+         */
+        void setBlendEquation(GLenum eqRGB, GLenum eqAlpha);
+
+        /** Sets the blending function.
+         @param source The blend mode for the source.
+         @param dest The blend mode for the destination
+         */
+        void setBlendFunc(GLenum source, GLenum dest);
+
+        /** Sets the blending function for colour and alpha.
+         @param source The blend mode for the colour source.
+         @param dest The blend mode for the colour destination
+         @param sourceAlpha The blend mode for the alpha source.
+         @param destAlpha The blend mode for the alpha destination
+         */
+        void setBlendFunc(GLenum source, GLenum dest, GLenum sourceAlpha, GLenum destAlpha);
+
+        /** Gets the current depth mask setting.
+         @return The current depth mask.
+         */
+        GLboolean getDepthMask(void) const { return mDepthMask; }
+
+        /** Sets the current depth mask setting.
+         @param mask The depth mask to use.
+         */
+        void setDepthMask(GLboolean mask);
+
+        /** Gets the current depth test function.
+         @return The current depth test function.
+         */
+        GLenum getDepthFunc(void) const { return mDepthFunc; }
+
+        /** Sets the current depth test function.
+         @param func The depth test function to use.
+         */
+        void setDepthFunc(GLenum func);
+
+        /** Gets the clear depth in the range from [0..1].
+         @return The current clearing depth.
+         */
+        GLclampd getClearDepth(void) const { return mClearDepth; }
+
+        /** Sets the clear depth in the range from [0..1].
+         @param depth The clear depth to use.
+         */
+        void setClearDepth(GLclampd depth);
+
+        /** Sets the polygon offset used when GL_POLYGON_OFFSET_* is enabled.
+         @param factor The slope scaled bias.
+         @param units The constant bias.
+         */
+        void setPolygonOffset(GLfloat factor, GLfloat units);
+
+        /** Sets the color to clear to.
+         @param red The red component.
+         @param green The green component.
+         @param blue The blue component.
+         @param alpha The alpha component.
+         */
+        void setClearColour(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha);
+
+        /** Gets the current colour mask setting.
+         @return An array containing the mask in RGBA order.
+         */
+        const GLboolean* getColourMask(void) const { return mColourMask; }
+
+        /** Sets the current colour mask.
+         @param red The red component.
+         @param green The green component.
+         @param blue The blue component.
+         @param alpha The alpha component.
+         */
+        void setColourMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
+
+        /** Sets the stencil write mask.
+         @param mask The stencil mask to use
+         @param face GL_FRONT, GL_BACK or GL_FRONT_AND_BACK.
+         */
+        void setStencilMask(GLuint mask, GLenum face = GL_FRONT_AND_BACK);
+
+        /** Sets the stencil test function.
+         @param func The comparison function.
+         @param ref The reference value.
+         @param mask The mask applied to the reference and stored values.
+         @param face GL_FRONT, GL_BACK or GL_FRONT_AND_BACK.
+         */
+        void setStencilFunc(GLenum func, GLint ref, GLuint mask, GLenum face = GL_FRONT_AND_BACK);
+
+        /** Sets the stencil operations.
+         @param stencilFail Action when the stencil test fails.
+         @param depthFail Action when the stencil test passes and the depth test fails.
+         @param depthPass Action when both tests pass.
+         @param face GL_FRONT, GL_BACK or GL_FRONT_AND_BACK.
+         */
+        void setStencilOp(GLenum stencilFail, GLenum depthFail, GLenum depthPass, GLenum face = GL_FRONT_AND_BACK);
+
+        /** Enables or disables a piece of OpenGL functionality.
+         @param flag The function to enable or disable.
+         @param enabled The new state.
+         */
+        void setEnabled(GLenum flag, bool enabled);
+
+        /** Gets the current polygon rendering mode, fill, wireframe, points, etc.
+         @return The current polygon rendering mode.
+         */
+        GLenum getPolygonMode(void) const { return mPolygonMode; }
+
+        /** Sets the current polygon rendering mode.
+         @param mode The polygon mode to use.
+         */
+        void setPolygonMode(GLenum mode);
+
+        /** Sets the face culling mode.
+         @return The current face culling mode
+         */
+        GLenum getCullFace(void) const { return mCullFace; }
+
+        /** Sets the face culling setting.
+         @param face The face culling mode to use.
+         */
+        void setCullFace(GLenum face);
+
+        /** Sets the viewport.
+         */
+        void setViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+        /** Gets the current viewport as x, y, width and height.
+         */
+        const GLint* getViewport(void) const { return mViewport; }
+
+        /** Sets the scissor box.
+         */
+        void setScissor(GLint x, GLint y, GLsizei width, GLsizei height);
+
+        /** Gets the current scissor box as x, y, width and height.
+         */
+        const GLint* getScissor(void) const { return mScissor; }
+
+        /** Gets the call statistics gathered since the last reset.
+         */
+        const Stats& getStats(void) const { return mStats; }
+
+        /** Resets the call statistics.
+         */
+        void resetStats(void);
+    };
+}
+
+#endif
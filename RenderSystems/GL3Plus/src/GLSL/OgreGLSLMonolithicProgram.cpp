@@ -36,6 +36,8 @@
 #include "OgreLogManager.h"
 #include "OgreGpuProgramManager.h"
 #include "OgreStringConverter.h"
+#include "OgreRoot.h"
+#include "OgreGL3PlusSupport.h"
 
 namespace Ogre {
 
@@ -105,7 +107,7 @@ namespace Ogre {
     {
         if (mLinked)
         {
-            OGRE_CHECK_GL_ERROR(glUseProgram(mGLProgramHandle));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLProgram(mGLProgramHandle);
         }
     }
 
@@ -310,6 +312,8 @@ namespace Ogre {
             transpose = GL_FALSE;
         }
 
+        size_t uploadedBytes = 0;
+
         for (;currentUniform != endUniform; ++currentUniform)
         {
             // Only pull values from buffer it's supposed to be in (vertex or fragment)
@@ -320,6 +324,11 @@ namespace Ogre {
                 const GpuConstantDefinition* def = currentUniform->mConstantDef;
                 if (def->variability & mask)
                 {
+                    // The program keeps uniform values, skip auto constants which weren't rewritten
+                    if (isUniformUpToDate(*currentUniform, params.get()))
+                        continue;
+
+                    uploadedBytes += getUniformBytes(def);
                     GLsizei glArraySize = (GLsizei)def->arraySize;
 
                     // Get the index in the parameter real list
@@ -487,6 +496,9 @@ namespace Ogre {
             } // fromProgType == currentUniform->mSourceProgType
 
         } // End for
+
+        if (uploadedBytes)
+            Root::getSingleton().getRenderSystem()->_notifyConstantBytesUploaded(uploadedBytes);
     }
 
 
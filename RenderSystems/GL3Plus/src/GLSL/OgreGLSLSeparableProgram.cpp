@@ -33,6 +33,9 @@
 #include "OgreGpuProgramManager.h"
 #include "OgreGLUtil.h"
 #include "OgreLogManager.h"
+#include "OgreRoot.h"
+#include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusSupport.h"
 
 namespace Ogre
 {
@@ -54,13 +57,13 @@ namespace Ogre
 
     GLSLSeparableProgram::~GLSLSeparableProgram()
     {
-        OGRE_CHECK_GL_ERROR(glDeleteProgramPipelines(1, &mGLProgramPipelineHandle));
+        getGL3PlusSupportRef()->getStateCacheManager()->deleteGLProgramPipeline(mGLProgramPipelineHandle);
     }
 
     void GLSLSeparableProgram::compileAndLink()
     {
         // Ensure no monolithic programs are in use.
-        OGRE_CHECK_GL_ERROR(glUseProgram(0));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLProgram(0);
 
         OGRE_CHECK_GL_ERROR(glGenProgramPipelines(1, &mGLProgramPipelineHandle));
         //OGRE_CHECK_GL_ERROR(glBindProgramPipeline(mGLProgramPipelineHandle));
@@ -298,7 +301,7 @@ namespace Ogre
 
         if (mLinked)
         {
-            OGRE_CHECK_GL_ERROR(glBindProgramPipeline(mGLProgramPipelineHandle));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLProgramPipeline(mGLProgramPipelineHandle);
         }
     }
 
@@ -406,6 +409,10 @@ namespace Ogre
             progID = mComputeShader->getGLProgramHandle();
         }
 
+        // Shader program objects are shared between pipelines, so unlike monolithic programs
+        // the uniform references here can't tell which values a program object still holds
+        size_t uploadedBytes = 0;
+
         for (; currentUniform != endUniform; ++currentUniform)
         {
             // Only pull values from buffer it's supposed to be in (vertex or fragment)
@@ -415,6 +422,7 @@ namespace Ogre
                 const GpuConstantDefinition* def = currentUniform->mConstantDef;
                 if (def->variability & mask)
                 {
+                    uploadedBytes += getUniformBytes(def);
                     GLsizei glArraySize = (GLsizei)def->arraySize;
 
                     // Get the index in the parameter real list
@@ -581,6 +589,9 @@ namespace Ogre
             } // fromProgType == currentUniform->mSourceProgType
 
         } // End for
+
+        if (uploadedBytes)
+            Root::getSingleton().getRenderSystem()->_notifyConstantBytesUploaded(uploadedBytes);
     }
 
 
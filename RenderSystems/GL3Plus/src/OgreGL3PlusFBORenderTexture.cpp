@@ -33,6 +33,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreGL3PlusHardwarePixelBuffer.h"
 #include "OgreGL3PlusFBOMultiRenderTarget.h"
 #include "OgreGL3PlusSupport.h"
+#include "OgreGL3PlusStateCacheManager.h"
 
 namespace Ogre {
     static const size_t TEMP_FBOS = 2;
@@ -159,19 +160,19 @@ namespace Ogre {
         if (fmt != GL_NONE)
         {
             if (tid)
-                OGRE_CHECK_GL_ERROR(glDeleteTextures(1, &tid));
+                mGLSupport.getStateCacheManager()->deleteGLTexture(tid);
 
             // Create and attach texture
             OGRE_CHECK_GL_ERROR(glGenTextures(1, &tid));
-            OGRE_CHECK_GL_ERROR(glBindTexture(GL_TEXTURE_2D, tid));
+            mGLSupport.getStateCacheManager()->bindGLTexture(GL_TEXTURE_2D, tid);
 
             // Set some default parameters
-            OGRE_CHECK_GL_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0));
-            OGRE_CHECK_GL_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
-            OGRE_CHECK_GL_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
-            OGRE_CHECK_GL_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
-            OGRE_CHECK_GL_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-            OGRE_CHECK_GL_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+            mGLSupport.getStateCacheManager()->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+            mGLSupport.getStateCacheManager()->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+            mGLSupport.getStateCacheManager()->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            mGLSupport.getStateCacheManager()->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            mGLSupport.getStateCacheManager()->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            mGLSupport.getStateCacheManager()->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
             OGRE_CHECK_GL_ERROR(glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, PROBE_SIZE, PROBE_SIZE, 0, fmt, dataType, 0));
 
@@ -414,7 +415,7 @@ namespace Ogre {
                 OGRE_CHECK_GL_ERROR(glDeleteFramebuffers(1, &fb));
 
                 if (internalFormat != GL_NONE) {
-                    OGRE_CHECK_GL_ERROR(glDeleteTextures(1, &tid));
+                    mGLSupport.getStateCacheManager()->deleteGLTexture(tid);
                     tid = 0;
                 }
             }
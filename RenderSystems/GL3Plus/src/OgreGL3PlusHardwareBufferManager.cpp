@@ -31,9 +31,13 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreGL3PlusHardwareIndexBuffer.h"
 #include "OgreGL3PlusHardwareUniformBuffer.h"
 #include "OgreGL3PlusHardwareShaderStorageBuffer.h"
+#include "OgreGL3PlusHardwareStreamingBuffer.h"
 #include "OgreGL3PlusHardwareVertexBuffer.h"
 #include "OgreGL3PlusRenderToVertexBuffer.h"
 #include "OgreRoot.h"
+#include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusSupport.h"
+#include "OgreGL3PlusStateCacheManager.h"
 
 namespace Ogre {
 
@@ -66,6 +70,8 @@ namespace Ogre {
     {
         mShaderStorageBuffers.clear();
 
+        // The rings unmap themselves, so release them while the context is still around
+        destroyAllStreamingBuffers();
         destroyAllDeclarations();
         destroyAllBindings();
 
@@ -87,6 +93,57 @@ namespace Ogre {
         return HardwareVertexBufferSharedPtr(buf);
     }
 
+    void* GL3PlusHardwareBufferManagerBase::mapPersistentStorage(GLenum target, GLuint bufferId,
+                                                                 size_t sizeInBytes)
+    {
+        GL3PlusSupport* support = getGL3PlusSupportRef();
+
+        // Respecify the storage as immutable so it can stay mapped while drawing
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        support->getStateCacheManager()->bindGLBuffer(target, bufferId);
+        OGRE_CHECK_GL_ERROR(glBufferStorage(target, sizeInBytes, NULL, flags));
+        void* data;
+        OGRE_CHECK_GL_ERROR(data = glMapBufferRange(target, 0, sizeInBytes, flags));
+        support->getStateCacheManager()->bindGLBuffer(target, 0);
+        return data;
+    }
+
+    HardwareStreamingBuffer*
+    GL3PlusHardwareBufferManagerBase::createStreamingBufferImpl(size_t vertexSize,
+                                                                size_t numVertices)
+    {
+        GL3PlusSupport* support = getGL3PlusSupportRef();
+        if (!support->hasMinGLVersion(4, 4) && !support->checkExtension("GL_ARB_buffer_storage"))
+            return 0;
+
+        HardwareVertexBufferSharedPtr vbuf = createVertexBuffer(vertexSize, numVertices,
+            HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
+        GLuint bufferId = static_cast<GL3PlusHardwareVertexBuffer*>(vbuf.get())->getGLBufferId();
+        void* data = mapPersistentStorage(GL_ARRAY_BUFFER, bufferId, vbuf->getSizeInBytes());
+        if (!data)
+            return 0;
+
+        return OGRE_NEW GL3PlusHardwareStreamingBuffer(vbuf, data);
+    }
+
+    HardwareStreamingBuffer*
+    GL3PlusHardwareBufferManagerBase::createStreamingIndexBufferImpl(HardwareIndexBuffer::IndexType itype,
+                                                                     size_t numIndexes)
+    {
+        GL3PlusSupport* support = getGL3PlusSupportRef();
+        if (!support->hasMinGLVersion(4, 4) && !support->checkExtension("GL_ARB_buffer_storage"))
+            return 0;
+
+        HardwareIndexBufferSharedPtr ibuf = createIndexBuffer(itype, numIndexes,
+            HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
+        GLuint bufferId = static_cast<GL3PlusHardwareIndexBuffer*>(ibuf.get())->getGLBufferId();
+        void* data = mapPersistentStorage(GL_ELEMENT_ARRAY_BUFFER, bufferId, ibuf->getSizeInBytes());
+        if (!data)
+            return 0;
+
+        return OGRE_NEW GL3PlusHardwareStreamingBuffer(ibuf, data);
+    }
+
     HardwareIndexBufferSharedPtr GL3PlusHardwareBufferManagerBase::createIndexBuffer(HardwareIndexBuffer::IndexType itype,
                                                                                      size_t numIndexes,
                                                                                      HardwareBuffer::Usage usage,
@@ -30,6 +30,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreGL3PlusHardwareCounterBuffer.h"
 #include "OgreRoot.h"
 #include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusSupport.h"
 
 #include <iostream>
 
@@ -53,7 +54,7 @@ namespace Ogre {
                         "GL3PlusHardwareCounterBuffer::GL3PlusHardwareCounterBuffer");
         }
 
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ATOMIC_COUNTER_BUFFER, mBufferId);
         OGRE_CHECK_GL_ERROR(glBufferData(GL_ATOMIC_COUNTER_BUFFER, mSizeInBytes, NULL, GL_DYNAMIC_DRAW));
 
         std::cout << "creating Counter buffer = " << name << " " << mBufferId << std::endl;
@@ -61,7 +62,7 @@ namespace Ogre {
 
     GL3PlusHardwareCounterBuffer::~GL3PlusHardwareCounterBuffer()
     {
-        OGRE_CHECK_GL_ERROR(glDeleteBuffers(1, &mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->deleteGLBuffer(GL_ATOMIC_COUNTER_BUFFER, mBufferId);
     }
 
     void GL3PlusHardwareCounterBuffer::setGLBufferBinding(GLint binding)
@@ -69,7 +70,7 @@ namespace Ogre {
         mBinding = binding;
 
         // Attach the buffer to the UBO binding
-        OGRE_CHECK_GL_ERROR(glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, mBinding, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBufferBase(GL_ATOMIC_COUNTER_BUFFER, mBinding, mBufferId);
     }
 
     void* GL3PlusHardwareCounterBuffer::lockImpl(size_t offset,
@@ -87,7 +88,7 @@ namespace Ogre {
         void* retPtr = 0;
 
         // Use glMapBuffer
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ATOMIC_COUNTER_BUFFER, mBufferId);
 
         if (mUsage & HBU_WRITE_ONLY)
         {
@@ -125,7 +126,7 @@ namespace Ogre {
 
     void GL3PlusHardwareCounterBuffer::unlockImpl(void)
     {
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ATOMIC_COUNTER_BUFFER, mBufferId);
 
         if (mUsage & HBU_WRITE_ONLY)
         {
@@ -139,7 +140,7 @@ namespace Ogre {
                             "Buffer data corrupted, please reload",
                             "GL3PlusHardwareCounterBuffer::unlock");
             }
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
 
         mIsLocked = false;
     }
@@ -147,7 +148,7 @@ namespace Ogre {
     void GL3PlusHardwareCounterBuffer::readData(size_t offset, size_t length, void* pDest)
     {
         // get data from the real buffer
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ATOMIC_COUNTER_BUFFER, mBufferId);
 
         OGRE_CHECK_GL_ERROR(glGetBufferSubData(GL_ATOMIC_COUNTER_BUFFER, offset, length, pDest));
     }
@@ -157,7 +158,7 @@ namespace Ogre {
                                                  const void* pSource,
                                                  bool discardWholeBuffer)
     {
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ATOMIC_COUNTER_BUFFER, mBufferId);
 
         if (offset == 0 && length == mSizeInBytes)
         {
@@ -187,21 +188,21 @@ namespace Ogre {
         else
         {
             // Unbind the current buffer
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
 
             // Zero out this(destination) buffer
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, mBufferId));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ATOMIC_COUNTER_BUFFER, mBufferId);
             OGRE_CHECK_GL_ERROR(glBufferData(GL_ATOMIC_COUNTER_BUFFER, length, 0, GL3PlusHardwareBufferManager::getGLUsage(mUsage)));
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
 
             // Do it the fast way.
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_READ_BUFFER, static_cast<GL3PlusHardwareCounterBuffer &>(srcBuffer).getGLBufferId()));
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_WRITE_BUFFER, mBufferId));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_COPY_READ_BUFFER, static_cast<GL3PlusHardwareCounterBuffer &>(srcBuffer).getGLBufferId());
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_COPY_WRITE_BUFFER, mBufferId);
 
             OGRE_CHECK_GL_ERROR(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, srcOffset, dstOffset, length));
 
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_READ_BUFFER, 0));
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_COPY_READ_BUFFER, 0);
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_COPY_WRITE_BUFFER, 0);
         }
     }
 
@@ -30,6 +30,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreGL3PlusHardwareBufferManager.h"
 #include "OgreGL3PlusRenderSystem.h"
 #include "OgreRoot.h"
+#include "OgreGL3PlusSupport.h"
 
 namespace Ogre {
 
@@ -51,7 +52,7 @@ namespace Ogre {
                         "GL3PlusHardwareIndexBuffer::GL3PlusHardwareIndexBuffer");
         }
 
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
 
         OGRE_CHECK_GL_ERROR(glBufferData(GL_ELEMENT_ARRAY_BUFFER, mSizeInBytes, NULL,
                                          GL3PlusHardwareBufferManager::getGLUsage(usage)));
@@ -60,7 +61,7 @@ namespace Ogre {
 
     GL3PlusHardwareIndexBuffer::~GL3PlusHardwareIndexBuffer()
     {
-        OGRE_CHECK_GL_ERROR(glDeleteBuffers(1, &mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->deleteGLBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
     }
 
     void* GL3PlusHardwareIndexBuffer::lockImpl(size_t offset,
@@ -77,7 +78,7 @@ namespace Ogre {
         void* retPtr = 0;
         GLenum access = 0;
 
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
 
         // Use glMapBuffer
         if (mUsage & HBU_WRITE_ONLY)
@@ -136,7 +137,7 @@ namespace Ogre {
         }
         else
         {
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
 
             if (mUsage & HBU_WRITE_ONLY)
             {
@@ -151,7 +152,7 @@ namespace Ogre {
                             "Buffer data corrupted, please reload",
                             "GL3PlusHardwareIndexBuffer::unlock");
             }
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         }
         mIsLocked = false;
     }
@@ -169,7 +170,7 @@ namespace Ogre {
         }
         else
         {
-            OGRE_CHECK_GL_ERROR(glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, mBufferId ));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer( GL_ELEMENT_ARRAY_BUFFER, mBufferId );
             OGRE_CHECK_GL_ERROR(glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset, length, pDest));
         }
     }
@@ -178,7 +179,7 @@ namespace Ogre {
                                                const void* pSource,
                                                bool discardWholeBuffer)
     {
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
 
         // Update the shadow buffer
         if (mUseShadowBuffer)
@@ -218,21 +219,21 @@ namespace Ogre {
         else
         {
             // Unbind the current buffer
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
             // Zero out this(destination) buffer
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
             OGRE_CHECK_GL_ERROR(glBufferData(GL_ELEMENT_ARRAY_BUFFER, length, 0, GL3PlusHardwareBufferManager::getGLUsage(mUsage)));
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
             // Do it the fast way.
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_READ_BUFFER, static_cast<GL3PlusHardwareIndexBuffer &>(srcBuffer).getGLBufferId()));
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_WRITE_BUFFER, mBufferId));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_COPY_READ_BUFFER, static_cast<GL3PlusHardwareIndexBuffer &>(srcBuffer).getGLBufferId());
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_COPY_WRITE_BUFFER, mBufferId);
 
             OGRE_CHECK_GL_ERROR(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, srcOffset, dstOffset, length));
 
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_READ_BUFFER, 0));
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_COPY_READ_BUFFER, 0);
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_COPY_WRITE_BUFFER, 0);
         }
     }
 
@@ -243,7 +244,7 @@ namespace Ogre {
             const void *srcData = mShadowBuffer->lock(mLockStart, mLockSize,
                                                       HBL_READ_ONLY);
 
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferId);
 
             // Update whole buffer if possible, otherwise normal
             if (mLockStart == 0 && mLockSize == mSizeInBytes)
@@ -30,6 +30,7 @@
 #include "OgreGL3PlusHardwareShaderStorageBuffer.h"
 #include "OgreRoot.h"
 #include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusSupport.h"
 
 namespace Ogre {
     GL3PlusHardwareShaderStorageBuffer::GL3PlusHardwareShaderStorageBuffer(
@@ -48,7 +49,7 @@ namespace Ogre {
                         "GL3PlusHardwareShaderStorageBuffer::GL3PlusHardwareShaderStorageBuffer");
         }
 
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_SHADER_STORAGE_BUFFER, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_SHADER_STORAGE_BUFFER, mBufferId);
         OGRE_CHECK_GL_ERROR(glBufferData(GL_SHADER_STORAGE_BUFFER, mSizeInBytes, NULL,
                                          GL3PlusHardwareBufferManager::getGLUsage(usage)));
 
@@ -57,7 +58,7 @@ namespace Ogre {
 
     GL3PlusHardwareShaderStorageBuffer::~GL3PlusHardwareShaderStorageBuffer()
     {
-        OGRE_CHECK_GL_ERROR(glDeleteBuffers(1, &mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->deleteGLBuffer(GL_SHADER_STORAGE_BUFFER, mBufferId);
     }
 
     void GL3PlusHardwareShaderStorageBuffer::setGLBufferBinding(GLint binding)
@@ -65,7 +66,7 @@ namespace Ogre {
         mBinding = binding;
 
         // Attach the buffer to the UBO binding
-        OGRE_CHECK_GL_ERROR(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, mBinding, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBufferBase(GL_SHADER_STORAGE_BUFFER, mBinding, mBufferId);
     }
 
     void* GL3PlusHardwareShaderStorageBuffer::lockImpl(size_t offset,
@@ -83,7 +84,7 @@ namespace Ogre {
         void* retPtr = 0;
 
         // Use glMapBuffer
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_SHADER_STORAGE_BUFFER, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_SHADER_STORAGE_BUFFER, mBufferId);
 
         if (mUsage & HBU_WRITE_ONLY)
         {
@@ -122,7 +123,7 @@ namespace Ogre {
 
     void GL3PlusHardwareShaderStorageBuffer::unlockImpl(void)
     {
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_SHADER_STORAGE_BUFFER, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_SHADER_STORAGE_BUFFER, mBufferId);
 
         if (mUsage & HBU_WRITE_ONLY)
         {
@@ -137,7 +138,7 @@ namespace Ogre {
                         "Buffer data corrupted, please reload",
                         "GL3PlusHardwareShaderStorageBuffer::unlock");
         }
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
         mIsLocked = false;
     }
@@ -145,7 +146,7 @@ namespace Ogre {
     void GL3PlusHardwareShaderStorageBuffer::readData(size_t offset, size_t length, void* pDest)
     {
         // Get data from the real buffer
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_SHADER_STORAGE_BUFFER, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_SHADER_STORAGE_BUFFER, mBufferId);
 
         //FIXME May not be implemented for GL_SHADER_STORAGE_BUFFER?
         OGRE_CHECK_GL_ERROR(glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, length, pDest));
@@ -156,7 +157,7 @@ namespace Ogre {
                                                        const void* pSource,
                                                        bool discardWholeBuffer)
     {
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_SHADER_STORAGE_BUFFER, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_SHADER_STORAGE_BUFFER, mBufferId);
 
         if (offset == 0 && length == mSizeInBytes)
         {
@@ -185,22 +186,22 @@ namespace Ogre {
         else
         {
             // Unbind the current buffer
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
             // Zero out this(destination) buffer
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_SHADER_STORAGE_BUFFER, mBufferId));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_SHADER_STORAGE_BUFFER, mBufferId);
             OGRE_CHECK_GL_ERROR(glBufferData(GL_SHADER_STORAGE_BUFFER, length, 0, GL3PlusHardwareBufferManager::getGLUsage(mUsage)));
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
             // Do it the fast way.
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_READ_BUFFER, static_cast<GL3PlusHardwareShaderStorageBuffer &>(srcBuffer).getGLBufferId()));
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_WRITE_BUFFER, mBufferId));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_COPY_READ_BUFFER, static_cast<GL3PlusHardwareShaderStorageBuffer &>(srcBuffer).getGLBufferId());
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_COPY_WRITE_BUFFER, mBufferId);
 
             //FIXME Perhaps not implemented for shader storage buffers?
             OGRE_CHECK_GL_ERROR(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, srcOffset, dstOffset, length));
 
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_READ_BUFFER, 0));
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_COPY_READ_BUFFER, 0);
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_COPY_WRITE_BUFFER, 0);
         }
     }
 }
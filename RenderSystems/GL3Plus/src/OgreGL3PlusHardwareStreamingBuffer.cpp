@@ -0,0 +1,102 @@
+/*
+  -----------------------------------------------------------------------------
+  This source file is part of OGRE
+  (Object-oriented Graphics Rendering Engine)
+  For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in
+  all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+  THE SOFTWARE.
+  -----------------------------------------------------------------------------
+*/
+
+#include "OgreGL3PlusHardwareStreamingBuffer.h"
+#include "OgreGL3PlusHardwareIndexBuffer.h"
+#include "OgreGL3PlusHardwareVertexBuffer.h"
+#include "OgreGL3PlusStateCacheManager.h"
+#include "OgreRoot.h"
+#include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusSupport.h"
+
+namespace Ogre {
+
+    GL3PlusHardwareStreamingBuffer::GL3PlusHardwareStreamingBuffer(
+        const HardwareVertexBufferSharedPtr& buffer, void* data)
+        : HardwareStreamingBuffer(buffer, data)
+        , mTarget(GL_ARRAY_BUFFER)
+        , mBufferId(static_cast<GL3PlusHardwareVertexBuffer*>(buffer.get())->getGLBufferId())
+    {
+    }
+
+    GL3PlusHardwareStreamingBuffer::GL3PlusHardwareStreamingBuffer(
+        const HardwareIndexBufferSharedPtr& buffer, void* data)
+        : HardwareStreamingBuffer(buffer, data)
+        , mTarget(GL_ELEMENT_ARRAY_BUFFER)
+        , mBufferId(static_cast<GL3PlusHardwareIndexBuffer*>(buffer.get())->getGLBufferId())
+    {
+    }
+
+    GL3PlusHardwareStreamingBuffer::~GL3PlusHardwareStreamingBuffer()
+    {
+        for (PendingFrameList::iterator i = mPendingFrames.begin(); i != mPendingFrames.end(); ++i)
+        {
+            if (i->fence)
+                deleteFence(i->fence);
+        }
+        mPendingFrames.clear();
+
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(mTarget, mBufferId);
+        OGRE_CHECK_GL_ERROR(glUnmapBuffer(mTarget));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(mTarget, 0);
+    }
+
+    void* GL3PlusHardwareStreamingBuffer::createFence(void)
+    {
+        GLsync fence;
+        OGRE_CHECK_GL_ERROR(fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        return fence;
+    }
+
+    bool GL3PlusHardwareStreamingBuffer::isFenceSignalled(void* fence)
+    {
+        GLenum result;
+        OGRE_CHECK_GL_ERROR(result = glClientWaitSync(static_cast<GLsync>(fence), 0, 0));
+        return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+    }
+
+    void GL3PlusHardwareStreamingBuffer::waitFence(void* fence)
+    {
+        // Flush on the first wait so the fence is guaranteed to be reached
+        GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        for (;;)
+        {
+            GLenum result;
+            OGRE_CHECK_GL_ERROR(result = glClientWaitSync(static_cast<GLsync>(fence), flags, 1000000));
+            if (result != GL_TIMEOUT_EXPIRED)
+                break;
+            flags = 0;
+        }
+    }
+
+    void GL3PlusHardwareStreamingBuffer::deleteFence(void* fence)
+    {
+        OGRE_CHECK_GL_ERROR(glDeleteSync(static_cast<GLsync>(fence)));
+    }
+
+}
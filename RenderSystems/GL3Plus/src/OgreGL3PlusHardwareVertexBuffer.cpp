@@ -30,6 +30,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreGL3PlusHardwareVertexBuffer.h"
 #include "OgreRoot.h"
 #include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusSupport.h"
 
 namespace Ogre {
 
@@ -51,17 +52,17 @@ namespace Ogre {
                         "GL3PlusHardwareVertexBuffer::GL3PlusHardwareVertexBuffer");
         }
 
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ARRAY_BUFFER, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ARRAY_BUFFER, mBufferId);
         OGRE_CHECK_GL_ERROR(glBufferData(GL_ARRAY_BUFFER, mSizeInBytes, NULL,
                                          GL3PlusHardwareBufferManager::getGLUsage(usage)));
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ARRAY_BUFFER, 0));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ARRAY_BUFFER, 0);
 
         //        std::cerr << "creating vertex buffer = " << mBufferId << std::endl;
     }
 
     GL3PlusHardwareVertexBuffer::~GL3PlusHardwareVertexBuffer()
     {
-        OGRE_CHECK_GL_ERROR(glDeleteBuffers(1, &mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->deleteGLBuffer(GL_ARRAY_BUFFER, mBufferId);
     }
 
     void* GL3PlusHardwareVertexBuffer::lockImpl(size_t offset,
@@ -79,7 +80,7 @@ namespace Ogre {
         void* retPtr = 0;
 
         // Use glMapBuffer
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ARRAY_BUFFER, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ARRAY_BUFFER, mBufferId);
 
         if (mUsage & HBU_WRITE_ONLY)
         {
@@ -139,7 +140,7 @@ namespace Ogre {
         }
         else
         {
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ARRAY_BUFFER, mBufferId));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ARRAY_BUFFER, mBufferId);
 
             if (mUsage & HBU_WRITE_ONLY)
             {
@@ -154,7 +155,7 @@ namespace Ogre {
                             "Buffer data corrupted, please reload",
                             "GL3PlusHardwareVertexBuffer::unlock");
             }
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ARRAY_BUFFER, 0));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ARRAY_BUFFER, 0);
         }
 
         mIsLocked = false;
@@ -171,7 +172,7 @@ namespace Ogre {
         else
         {
             // get data from the real buffer
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ARRAY_BUFFER, mBufferId));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ARRAY_BUFFER, mBufferId);
 
             OGRE_CHECK_GL_ERROR(glGetBufferSubData(GL_ARRAY_BUFFER, offset, length, pDest));
         }
@@ -182,7 +183,7 @@ namespace Ogre {
                                                 const void* pSource,
                                                 bool discardWholeBuffer)
     {
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ARRAY_BUFFER, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ARRAY_BUFFER, mBufferId);
 
         // Update the shadow buffer
         if(mUseShadowBuffer)
@@ -221,21 +222,21 @@ namespace Ogre {
         else
         {
             // Unbind the current buffer
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ARRAY_BUFFER, 0));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ARRAY_BUFFER, 0);
 
             // Zero out this(destination) buffer
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ARRAY_BUFFER, mBufferId));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ARRAY_BUFFER, mBufferId);
             OGRE_CHECK_GL_ERROR(glBufferData(GL_ARRAY_BUFFER, length, 0, GL3PlusHardwareBufferManager::getGLUsage(mUsage)));
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ARRAY_BUFFER, 0));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ARRAY_BUFFER, 0);
 
             // Do it the fast way.
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_READ_BUFFER, static_cast<GL3PlusHardwareVertexBuffer &>(srcBuffer).getGLBufferId()));
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_WRITE_BUFFER, mBufferId));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_COPY_READ_BUFFER, static_cast<GL3PlusHardwareVertexBuffer &>(srcBuffer).getGLBufferId());
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_COPY_WRITE_BUFFER, mBufferId);
 
             OGRE_CHECK_GL_ERROR(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, srcOffset, dstOffset, length));
 
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_READ_BUFFER, 0));
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_COPY_READ_BUFFER, 0);
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_COPY_WRITE_BUFFER, 0);
         }
     }
 
@@ -247,7 +248,7 @@ namespace Ogre {
                                                       mLockSize,
                                                       HBL_READ_ONLY);
 
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ARRAY_BUFFER, mBufferId));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_ARRAY_BUFFER, mBufferId);
 
             // Update whole buffer if possible, otherwise normal
             if (mLockStart == 0 && mLockSize == mSizeInBytes)
@@ -131,7 +131,9 @@ namespace Ogre {
           mGLSLShaderFactory(0),
           mHardwareBufferManager(0),
           mRTTManager(0),
-          mActiveTextureUnit(0)
+          mStateCacheManager(0),
+          mMultiDrawDataBuffer(0),
+          mMultiDrawIndirectBuffer(0)
     {
         size_t i;
 
@@ -403,6 +405,16 @@ namespace Ogre {
             rsc->setCapability(RSC_GLSL_SSO_REDECLARE);
         }
 
+        // Multi draw needs storage buffers for the per draw data and the
+        // draw parameters to index it in the shader
+        if ((mGLSupport->hasMinGLVersion(4, 3) ||
+             (mGLSupport->checkExtension("GL_ARB_multi_draw_indirect") &&
+              mGLSupport->checkExtension("GL_ARB_shader_storage_buffer_object"))) &&
+            (mGLSupport->hasMinGLVersion(4, 6) || mGLSupport->checkExtension("GL_ARB_shader_draw_parameters")))
+        {
+            rsc->setCapability(RSC_MULTI_DRAW_INDIRECT);
+        }
+
         // Vertex/Fragment Programs
         rsc->setCapability(RSC_VERTEX_PROGRAM);
         rsc->setCapability(RSC_FRAGMENT_PROGRAM);
@@ -596,6 +608,17 @@ namespace Ogre {
         }
         mBackgroundContextList.clear();
 
+        if (mMultiDrawDataBuffer)
+        {
+            mStateCacheManager->deleteGLBuffer(GL_SHADER_STORAGE_BUFFER, mMultiDrawDataBuffer);
+            mMultiDrawDataBuffer = 0;
+        }
+        if (mMultiDrawIndirectBuffer)
+        {
+            mStateCacheManager->deleteGLBuffer(GL_DRAW_INDIRECT_BUFFER, mMultiDrawIndirectBuffer);
+            mMultiDrawIndirectBuffer = 0;
+        }
+
         mGLSupport->stop();
         mStopRendering = true;
 
@@ -866,11 +889,11 @@ namespace Ogre {
             // val[2] = quadratic * correction;
             // val[3] = 1;
 
-            OGRE_CHECK_GL_ERROR(glEnable(GL_PROGRAM_POINT_SIZE));
+            mStateCacheManager->setEnabled(GL_PROGRAM_POINT_SIZE, true);
         }
         else
         {
-            OGRE_CHECK_GL_ERROR(glDisable(GL_PROGRAM_POINT_SIZE));
+            mStateCacheManager->setEnabled(GL_PROGRAM_POINT_SIZE, false);
         }
 
         OGRE_CHECK_GL_ERROR(glPointSize(size));
@@ -886,7 +909,7 @@ namespace Ogre {
     {
         GL3PlusTexturePtr tex = texPtr.staticCast<GL3PlusTexture>();
 
-        if (!activateGLTextureUnit(stage))
+        if (!mStateCacheManager->activateGLTextureUnit(stage))
             return;
 
         if (enabled)
@@ -906,20 +929,20 @@ namespace Ogre {
 
             if (!tex.isNull())
             {
-                OGRE_CHECK_GL_ERROR(glBindTexture( mTextureTypes[stage], tex->getGLID() ));
+                mStateCacheManager->bindGLTexture( mTextureTypes[stage], tex->getGLID() );
             }
             else
             {
-                OGRE_CHECK_GL_ERROR(glBindTexture( mTextureTypes[stage], static_cast<GL3PlusTextureManager*>(mTextureManager)->getWarningTextureID() ));
+                mStateCacheManager->bindGLTexture( mTextureTypes[stage], static_cast<GL3PlusTextureManager*>(mTextureManager)->getWarningTextureID() );
             }
         }
         else
         {
             // Bind zero texture.
-            OGRE_CHECK_GL_ERROR(glBindTexture(GL_TEXTURE_2D, 0));
+            mStateCacheManager->bindGLTexture(GL_TEXTURE_2D, 0);
         }
 
-        activateGLTextureUnit(0);
+        mStateCacheManager->activateGLTextureUnit(0);
     }
 
     void GL3PlusRenderSystem::_setVertexTexture( size_t unit, const TexturePtr &tex )
@@ -970,31 +993,31 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::_setTextureAddressingMode(size_t stage, const TextureUnitState::UVWAddressingMode& uvw)
     {
-        if (!activateGLTextureUnit(stage))
+        if (!mStateCacheManager->activateGLTextureUnit(stage))
             return;
-        OGRE_CHECK_GL_ERROR(glTexParameteri( mTextureTypes[stage], GL_TEXTURE_WRAP_S, getTextureAddressingMode(uvw.u)));
-        OGRE_CHECK_GL_ERROR(glTexParameteri( mTextureTypes[stage], GL_TEXTURE_WRAP_T, getTextureAddressingMode(uvw.v)));
-        OGRE_CHECK_GL_ERROR(glTexParameteri( mTextureTypes[stage], GL_TEXTURE_WRAP_R, getTextureAddressingMode(uvw.w)));
+        mStateCacheManager->setTexParameteri( mTextureTypes[stage], GL_TEXTURE_WRAP_S, getTextureAddressingMode(uvw.u));
+        mStateCacheManager->setTexParameteri( mTextureTypes[stage], GL_TEXTURE_WRAP_T, getTextureAddressingMode(uvw.v));
+        mStateCacheManager->setTexParameteri( mTextureTypes[stage], GL_TEXTURE_WRAP_R, getTextureAddressingMode(uvw.w));
 
-        activateGLTextureUnit(0);
+        mStateCacheManager->activateGLTextureUnit(0);
     }
 
     void GL3PlusRenderSystem::_setTextureBorderColour(size_t stage, const ColourValue& colour)
     {
         GLfloat border[4] = { colour.r, colour.g, colour.b, colour.a };
-        if (activateGLTextureUnit(stage))
+        if (mStateCacheManager->activateGLTextureUnit(stage))
         {
             OGRE_CHECK_GL_ERROR(glTexParameterfv( mTextureTypes[stage], GL_TEXTURE_BORDER_COLOR, border));
-            activateGLTextureUnit(0);
+            mStateCacheManager->activateGLTextureUnit(0);
         }
     }
 
     void GL3PlusRenderSystem::_setTextureMipmapBias(size_t stage, float bias)
     {
-        if (activateGLTextureUnit(stage))
+        if (mStateCacheManager->activateGLTextureUnit(stage))
         {
-            OGRE_CHECK_GL_ERROR(glTexParameterf(mTextureTypes[stage], GL_TEXTURE_LOD_BIAS, bias));
-            activateGLTextureUnit(0);
+            mStateCacheManager->setTexParameterf(mTextureTypes[stage], GL_TEXTURE_LOD_BIAS, bias);
+            mStateCacheManager->activateGLTextureUnit(0);
         }
     }
 
@@ -1034,12 +1057,12 @@ namespace Ogre {
         GLenum destBlend = getBlendMode(destFactor);
         if (sourceFactor == SBF_ONE && destFactor == SBF_ZERO)
         {
-            OGRE_CHECK_GL_ERROR(glDisable(GL_BLEND));
+            mStateCacheManager->setEnabled(GL_BLEND, false);
         }
         else
         {
-            OGRE_CHECK_GL_ERROR(glEnable(GL_BLEND));
-            OGRE_CHECK_GL_ERROR(glBlendFunc(sourceBlend, destBlend));
+            mStateCacheManager->setEnabled(GL_BLEND, true);
+            mStateCacheManager->setBlendFunc(sourceBlend, destBlend);
         }
 
         GLint func = GL_FUNC_ADD;
@@ -1062,7 +1085,7 @@ namespace Ogre {
             break;
         }
 
-        OGRE_CHECK_GL_ERROR(glBlendEquation(func));
+        mStateCacheManager->setBlendEquation(func);
     }
 
     void GL3PlusRenderSystem::_setSeparateSceneBlending(
@@ -1078,12 +1101,12 @@ namespace Ogre {
         if (sourceFactor == SBF_ONE && destFactor == SBF_ZERO &&
             sourceFactorAlpha == SBF_ONE && destFactorAlpha == SBF_ZERO)
         {
-            OGRE_CHECK_GL_ERROR(glDisable(GL_BLEND));
+            mStateCacheManager->setEnabled(GL_BLEND, false);
         }
         else
         {
-            OGRE_CHECK_GL_ERROR(glEnable(GL_BLEND));
-            OGRE_CHECK_GL_ERROR(glBlendFuncSeparate(sourceBlend, destBlend, sourceBlendAlpha, destBlendAlpha));
+            mStateCacheManager->setEnabled(GL_BLEND, true);
+            mStateCacheManager->setBlendFunc(sourceBlend, destBlend, sourceBlendAlpha, destBlendAlpha);
         }
 
         GLint func = GL_FUNC_ADD, alphaFunc = GL_FUNC_ADD;
@@ -1126,32 +1149,19 @@ namespace Ogre {
             break;
         }
 
-        OGRE_CHECK_GL_ERROR(glBlendEquationSeparate(func, alphaFunc));
+        mStateCacheManager->setBlendEquation(func, alphaFunc);
     }
 
     void GL3PlusRenderSystem::_setAlphaRejectSettings(CompareFunction func, unsigned char value, bool alphaToCoverage)
     {
         bool a2c = false;
-        static bool lasta2c = false;
 
         if (func != CMPF_ALWAYS_PASS)
         {
             a2c = alphaToCoverage;
         }
 
-        if (a2c != lasta2c)
-        {
-            if (a2c)
-            {
-                OGRE_CHECK_GL_ERROR(glEnable(GL_SAMPLE_ALPHA_TO_COVERAGE));
-            }
-            else
-            {
-                OGRE_CHECK_GL_ERROR(glDisable(GL_SAMPLE_ALPHA_TO_COVERAGE));
-            }
-
-            lasta2c = a2c;
-        }
+        mStateCacheManager->setEnabled(GL_SAMPLE_ALPHA_TO_COVERAGE, a2c);
     }
 
     void GL3PlusRenderSystem::_setViewport(Viewport *vp)
@@ -1185,10 +1195,10 @@ namespace Ogre {
                 y = target->getHeight() - h - y;
             }
 
-            OGRE_CHECK_GL_ERROR(glViewport(x, y, w, h));
+            mStateCacheManager->setViewport(x, y, w, h);
 
             // Configure the viewport clipping
-            OGRE_CHECK_GL_ERROR(glScissor(x, y, w, h));
+            mStateCacheManager->setScissor(x, y, w, h);
 
             vp->_clearUpdatedFlag();
         }
@@ -1202,16 +1212,16 @@ namespace Ogre {
                         "GL3PlusRenderSystem::_beginFrame");
 
         mScissorsEnabled = true;
-        OGRE_CHECK_GL_ERROR(glEnable(GL_SCISSOR_TEST));
+        mStateCacheManager->setEnabled(GL_SCISSOR_TEST, true);
     }
 
     void GL3PlusRenderSystem::_endFrame(void)
     {
         // Deactivate the viewport clipping.
         mScissorsEnabled = false;
-        OGRE_CHECK_GL_ERROR(glDisable(GL_SCISSOR_TEST));
+        mStateCacheManager->setEnabled(GL_SCISSOR_TEST, false);
 
-        OGRE_CHECK_GL_ERROR(glDisable(GL_DEPTH_CLAMP));
+        mStateCacheManager->setEnabled(GL_DEPTH_CLAMP, false);
 
         // unbind GPU programs at end of frame
         // this is mostly to avoid holding bound programs that might get deleted
@@ -1243,7 +1253,7 @@ namespace Ogre {
         switch( mode )
         {
         case CULL_NONE:
-            OGRE_CHECK_GL_ERROR(glDisable(GL_CULL_FACE));
+            mStateCacheManager->setEnabled(GL_CULL_FACE, false);
             return;
 
         default:
@@ -1273,8 +1283,8 @@ namespace Ogre {
             break;
         }
 
-        OGRE_CHECK_GL_ERROR(glEnable(GL_CULL_FACE));
-        OGRE_CHECK_GL_ERROR(glCullFace(cullMode));
+        mStateCacheManager->setEnabled(GL_CULL_FACE, true);
+        mStateCacheManager->setCullFace(cullMode);
     }
 
     void GL3PlusRenderSystem::_setDepthBufferParams(bool depthTest, bool depthWrite, CompareFunction depthFunction)
@@ -1288,19 +1298,19 @@ namespace Ogre {
     {
         if (enabled)
         {
-            OGRE_CHECK_GL_ERROR(glClearDepth(1.0));
-            OGRE_CHECK_GL_ERROR(glEnable(GL_DEPTH_TEST));
+            mStateCacheManager->setClearDepth(1.0);
+            mStateCacheManager->setEnabled(GL_DEPTH_TEST, true);
         }
         else
         {
-            OGRE_CHECK_GL_ERROR(glDisable(GL_DEPTH_TEST));
+            mStateCacheManager->setEnabled(GL_DEPTH_TEST, false);
         }
     }
 
     void GL3PlusRenderSystem::_setDepthBufferWriteEnabled(bool enabled)
     {
         GLboolean flag = enabled ? GL_TRUE : GL_FALSE;
-        OGRE_CHECK_GL_ERROR(glDepthMask(flag));
+        mStateCacheManager->setDepthMask(flag);
 
         // Store for reference in _beginFrame
         mDepthWrite = enabled;
@@ -1308,7 +1318,7 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::_setDepthBufferFunction(CompareFunction func)
     {
-        OGRE_CHECK_GL_ERROR(glDepthFunc(convertCompareFunction(func)));
+        mStateCacheManager->setDepthFunc(convertCompareFunction(func));
     }
 
     void GL3PlusRenderSystem::_setDepthBias(float constantBias, float slopeScaleBias)
@@ -1316,22 +1326,22 @@ namespace Ogre {
         //FIXME glPolygonOffset currently is buggy in GL3+ RS but not GL RS.
         if (constantBias != 0 || slopeScaleBias != 0)
         {
-            OGRE_CHECK_GL_ERROR(glEnable(GL_POLYGON_OFFSET_FILL));
-            OGRE_CHECK_GL_ERROR(glEnable(GL_POLYGON_OFFSET_POINT));
-            OGRE_CHECK_GL_ERROR(glEnable(GL_POLYGON_OFFSET_LINE));
-            OGRE_CHECK_GL_ERROR(glPolygonOffset(-slopeScaleBias, -constantBias));
+            mStateCacheManager->setEnabled(GL_POLYGON_OFFSET_FILL, true);
+            mStateCacheManager->setEnabled(GL_POLYGON_OFFSET_POINT, true);
+            mStateCacheManager->setEnabled(GL_POLYGON_OFFSET_LINE, true);
+            mStateCacheManager->setPolygonOffset(-slopeScaleBias, -constantBias);
         }
         else
         {
-            OGRE_CHECK_GL_ERROR(glDisable(GL_POLYGON_OFFSET_FILL));
-            OGRE_CHECK_GL_ERROR(glDisable(GL_POLYGON_OFFSET_POINT));
-            OGRE_CHECK_GL_ERROR(glDisable(GL_POLYGON_OFFSET_LINE));
+            mStateCacheManager->setEnabled(GL_POLYGON_OFFSET_FILL, false);
+            mStateCacheManager->setEnabled(GL_POLYGON_OFFSET_POINT, false);
+            mStateCacheManager->setEnabled(GL_POLYGON_OFFSET_LINE, false);
         }
     }
 
     void GL3PlusRenderSystem::_setColourBufferWriteEnabled(bool red, bool green, bool blue, bool alpha)
     {
-        OGRE_CHECK_GL_ERROR(glColorMask(red, green, blue, alpha));
+        mStateCacheManager->setColourMask(red, green, blue, alpha);
 
         // record this
         mColourWrite[0] = red;
@@ -1364,18 +1374,18 @@ namespace Ogre {
             mPolygonMode = GL_FILL;
             break;
         }
-        OGRE_CHECK_GL_ERROR(glPolygonMode(GL_FRONT_AND_BACK, mPolygonMode));
+        mStateCacheManager->setPolygonMode(mPolygonMode);
     }
 
     void GL3PlusRenderSystem::setStencilCheckEnabled(bool enabled)
     {
         if (enabled)
         {
-            OGRE_CHECK_GL_ERROR(glEnable(GL_STENCIL_TEST));
+            mStateCacheManager->setEnabled(GL_STENCIL_TEST, true);
         }
         else
         {
-            OGRE_CHECK_GL_ERROR(glDisable(GL_STENCIL_TEST));
+            mStateCacheManager->setEnabled(GL_STENCIL_TEST, false);
         }
     }
 
@@ -1401,30 +1411,28 @@ namespace Ogre {
             flip = (mInvertVertexWinding && !mActiveRenderTarget->requiresTextureFlipping()) ||
                 (!mInvertVertexWinding && mActiveRenderTarget->requiresTextureFlipping());
             // Back
-            OGRE_CHECK_GL_ERROR(glStencilMaskSeparate(GL_BACK, writeMask));
-            OGRE_CHECK_GL_ERROR(glStencilFuncSeparate(GL_BACK, convertCompareFunction(func), refValue, compareMask));
-            OGRE_CHECK_GL_ERROR(glStencilOpSeparate(GL_BACK,
-                                                    convertStencilOp(stencilFailOp, !flip),
-                                                    convertStencilOp(depthFailOp, !flip),
-                                                    convertStencilOp(passOp, !flip)));
+            mStateCacheManager->setStencilMask(writeMask, GL_BACK);
+            mStateCacheManager->setStencilFunc(convertCompareFunction(func), refValue, compareMask, GL_BACK);
+            mStateCacheManager->setStencilOp(convertStencilOp(stencilFailOp, !flip),
+                                             convertStencilOp(depthFailOp, !flip),
+                                             convertStencilOp(passOp, !flip), GL_BACK);
 
             // Front
-            OGRE_CHECK_GL_ERROR(glStencilMaskSeparate(GL_FRONT, writeMask));
-            OGRE_CHECK_GL_ERROR(glStencilFuncSeparate(GL_FRONT, convertCompareFunction(func), refValue, compareMask));
-            OGRE_CHECK_GL_ERROR(glStencilOpSeparate(GL_FRONT,
-                                                    convertStencilOp(stencilFailOp, flip),
-                                                    convertStencilOp(depthFailOp, flip),
-                                                    convertStencilOp(passOp, flip)));
+            mStateCacheManager->setStencilMask(writeMask, GL_FRONT);
+            mStateCacheManager->setStencilFunc(convertCompareFunction(func), refValue, compareMask, GL_FRONT);
+            mStateCacheManager->setStencilOp(convertStencilOp(stencilFailOp, flip),
+                                             convertStencilOp(depthFailOp, flip),
+                                             convertStencilOp(passOp, flip), GL_FRONT);
         }
         else
         {
             flip = false;
-            OGRE_CHECK_GL_ERROR(glStencilMask(writeMask));
-            OGRE_CHECK_GL_ERROR(glStencilFunc(convertCompareFunction(func), refValue, compareMask));
-            OGRE_CHECK_GL_ERROR(glStencilOp(
+            mStateCacheManager->setStencilMask(writeMask);
+            mStateCacheManager->setStencilFunc(convertCompareFunction(func), refValue, compareMask);
+            mStateCacheManager->setStencilOp(
                 convertStencilOp(stencilFailOp, flip),
                 convertStencilOp(depthFailOp, flip),
-                convertStencilOp(passOp, flip)));
+                convertStencilOp(passOp, flip));
         }
     }
 
@@ -1472,7 +1480,7 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::_setTextureUnitFiltering(size_t unit, FilterType ftype, FilterOptions fo)
     {
-        if (!activateGLTextureUnit(unit))
+        if (!mStateCacheManager->activateGLTextureUnit(unit))
             return;
 
         switch (ftype)
@@ -1481,9 +1489,9 @@ namespace Ogre {
             mMinFilter = fo;
 
             // Combine with existing mip filter
-            OGRE_CHECK_GL_ERROR(glTexParameteri(mTextureTypes[unit],
-                                                GL_TEXTURE_MIN_FILTER,
-                                                getCombinedMinMipFilter()));
+            mStateCacheManager->setTexParameteri(mTextureTypes[unit],
+                                                 GL_TEXTURE_MIN_FILTER,
+                                                 getCombinedMinMipFilter());
             break;
 
         case FT_MAG:
@@ -1491,15 +1499,15 @@ namespace Ogre {
             {
             case FO_ANISOTROPIC: // GL treats linear and aniso the same
             case FO_LINEAR:
-                OGRE_CHECK_GL_ERROR(glTexParameteri(mTextureTypes[unit],
-                                                    GL_TEXTURE_MAG_FILTER,
-                                                    GL_LINEAR));
+                mStateCacheManager->setTexParameteri(mTextureTypes[unit],
+                                                     GL_TEXTURE_MAG_FILTER,
+                                                     GL_LINEAR);
                 break;
             case FO_POINT:
             case FO_NONE:
-                OGRE_CHECK_GL_ERROR(glTexParameteri(mTextureTypes[unit],
-                                                    GL_TEXTURE_MAG_FILTER,
-                                                    GL_NEAREST));
+                mStateCacheManager->setTexParameteri(mTextureTypes[unit],
+                                                     GL_TEXTURE_MAG_FILTER,
+                                                     GL_NEAREST);
                 break;
             }
             break;
@@ -1507,13 +1515,13 @@ namespace Ogre {
             mMipFilter = fo;
 
             // Combine with existing min filter
-            OGRE_CHECK_GL_ERROR(glTexParameteri(mTextureTypes[unit],
-                                                GL_TEXTURE_MIN_FILTER,
-                                                getCombinedMinMipFilter()));
+            mStateCacheManager->setTexParameteri(mTextureTypes[unit],
+                                                 GL_TEXTURE_MIN_FILTER,
+                                                 getCombinedMinMipFilter());
             break;
         }
 
-        activateGLTextureUnit(0);
+        mStateCacheManager->activateGLTextureUnit(0);
     }
 
     GLfloat GL3PlusRenderSystem::_getCurrentAnisotropy(size_t unit)
@@ -1543,14 +1551,13 @@ namespace Ogre {
         if (!mCurrentCapabilities->hasCapability(RSC_ANISOTROPY))
             return;
 
-        if (!activateGLTextureUnit(unit))
+        if (!mStateCacheManager->activateGLTextureUnit(unit))
             return;
 
         maxAnisotropy = std::min<uint>(mLargestSupportedAnisotropy, maxAnisotropy);
-        if (_getCurrentAnisotropy(unit) != maxAnisotropy)
-            OGRE_CHECK_GL_ERROR(glTexParameteri(mTextureTypes[unit], GL_TEXTURE_MAX_ANISOTROPY_EXT, maxAnisotropy));
+        mStateCacheManager->setTexParameteri(mTextureTypes[unit], GL_TEXTURE_MAX_ANISOTROPY_EXT, maxAnisotropy);
 
-        activateGLTextureUnit(0);
+        mStateCacheManager->activateGLTextureUnit(0);
     }
 
     void GL3PlusRenderSystem::_render(const RenderOperation& op)
@@ -1572,79 +1579,9 @@ namespace Ogre {
             numberOfInstances *= getGlobalNumberOfInstances();
         }
 
-        // Get vertex array organization.
-        const VertexDeclaration::VertexElementList& decl =
-            op.vertexData->vertexDeclaration->getElements();
-        VertexDeclaration::VertexElementList::const_iterator elemIter, elemEnd;
-        elemEnd = decl.end();
-
-        // Bind VAO (set of per-vertex attributes: position, normal, etc.).
-        bool updateVAO = true;
-        if (mCurrentCapabilities->hasCapability(RSC_SEPARATE_SHADER_OBJECTS))
-        {
-            GLSLSeparableProgram* separableProgram =
-                GLSLSeparableProgramManager::getSingleton().getCurrentSeparableProgram();
-            if (separableProgram)
-            {
-                if (!op.renderToVertexBuffer)
-                {
-                    separableProgram->activate();
-                }
-
-                updateVAO = !separableProgram->getVertexArrayObject()->isInitialised();
-
-                separableProgram->getVertexArrayObject()->bind();
-            }
-            else
-            {
-                Ogre::LogManager::getSingleton().logMessage(
-                    "ERROR: Failed to create separable program.", LML_CRITICAL);
-            }
-        }
-        else
-        {
-            GLSLMonolithicProgram* monolithicProgram = GLSLMonolithicProgramManager::getSingleton().getActiveMonolithicProgram();
-            if (monolithicProgram)
-            {
-                updateVAO = !monolithicProgram->getVertexArrayObject()->isInitialised();
-
-                monolithicProgram->getVertexArrayObject()->bind();
-            }
-            else
-            {
-                Ogre::LogManager::getSingleton().logMessage(
-                    "ERROR: Failed to create monolithic program.", LML_CRITICAL);
-            }
-        }
-
-        // Bind the appropriate VBOs to the active attributes of the VAO.
-        for (elemIter = decl.begin(); elemIter != elemEnd; ++elemIter)
-        {
-            const VertexElement & elem = *elemIter;
-            uint16 source = elem.getSource();
-
-            if (!op.vertexData->vertexBufferBinding->isBufferBound(source))
-                continue; // Skip unbound elements.
+        bool updateVAO = bindVertexData(op, op.vertexData->vertexStart, true);
 
-            HardwareVertexBufferSharedPtr vertexBuffer =
-                op.vertexData->vertexBufferBinding->getBuffer(source);
-
-            bindVertexElementToGpu(elem, vertexBuffer, op.vertexData->vertexStart,
-                                   mRenderAttribsBound, mRenderInstanceAttribsBound, updateVAO);
-        }
-
-        if ( !globalInstanceVertexBuffer.isNull() && globalVertexDeclaration != NULL )
-        {
-            elemEnd = globalVertexDeclaration->getElements().end();
-            for (elemIter = globalVertexDeclaration->getElements().begin(); elemIter != elemEnd; ++elemIter)
-            {
-                const VertexElement & elem = *elemIter;
-                bindVertexElementToGpu(elem, globalInstanceVertexBuffer, 0,
-                                       mRenderAttribsBound, mRenderInstanceAttribsBound, updateVAO);
-            }
-        }
-
-        activateGLTextureUnit(0);
+        mStateCacheManager->activateGLTextureUnit(0);
 
         // Launch compute shader job(s).
         if (mCurrentComputeShader) // && mComputeProgramPosition == CP_PRERENDER && mComputeProgramExecutions <= compute_execution_cap)
@@ -1664,32 +1601,7 @@ namespace Ogre {
 
 
         // Determine the correct primitive type to render.
-        GLint primType;
-        // Use adjacency if there is a geometry program and it requested adjacency info.
-        bool useAdjacency = (mGeometryProgramBound && mCurrentGeometryShader && mCurrentGeometryShader->isAdjacencyInfoRequired());
-        switch (op.operationType)
-        {
-        case RenderOperation::OT_POINT_LIST:
-            primType = GL_POINTS;
-            break;
-        case RenderOperation::OT_LINE_LIST:
-            primType = useAdjacency ? GL_LINES_ADJACENCY : GL_LINES;
-            break;
-        case RenderOperation::OT_LINE_STRIP:
-            primType = useAdjacency ? GL_LINE_STRIP_ADJACENCY : GL_LINE_STRIP;
-            break;
-        default:
-        case RenderOperation::OT_TRIANGLE_LIST:
-            primType = useAdjacency ? GL_TRIANGLES_ADJACENCY : GL_TRIANGLES;
-            break;
-        case RenderOperation::OT_TRIANGLE_STRIP:
-            primType = useAdjacency ? GL_TRIANGLE_STRIP_ADJACENCY : GL_TRIANGLE_STRIP;
-            break;
-        case RenderOperation::OT_TRIANGLE_FAN:
-            primType = GL_TRIANGLE_FAN;
-            break;
-        }
-
+        GLint primType = getGLPrimitiveType(op.operationType);
 
         // Bind atomic counter buffers.
         // if (Root::getSingleton().getRenderSystem()->getCapabilities()->hasCapability(RSC_ATOMIC_COUNTERS))
@@ -1745,8 +1657,8 @@ namespace Ogre {
 
             if (op.useIndexes)
             {
-                OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,
-                                                 static_cast<GL3PlusHardwareIndexBuffer*>(op.indexData->indexBuffer.get())->getGLBufferId()));
+                mStateCacheManager->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER,
+                                                 static_cast<GL3PlusHardwareIndexBuffer*>(op.indexData->indexBuffer.get())->getGLBufferId());
                 void *pBufferData = GL_BUFFER_OFFSET(op.indexData->indexStart *
                                                      op.indexData->indexBuffer->getIndexSize());
                 GLuint indexEnd = op.indexData->indexCount - op.indexData->indexStart;
@@ -1764,8 +1676,8 @@ namespace Ogre {
         }
         else if (op.useIndexes)
         {
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,
-                                             static_cast<GL3PlusHardwareIndexBuffer*>(op.indexData->indexBuffer.get())->getGLBufferId()));
+            mStateCacheManager->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER,
+                                             static_cast<GL3PlusHardwareIndexBuffer*>(op.indexData->indexBuffer.get())->getGLBufferId());
 
             void *pBufferData = GL_BUFFER_OFFSET(op.indexData->indexStart *
                                                  op.indexData->indexBuffer->getIndexSize());
@@ -1783,28 +1695,16 @@ namespace Ogre {
                                   mDerivedDepthBiasSlopeScale);
                 }
 
+                // vertexStart is already applied to the attribute pointers in
+                // bindVertexElementToGpu, so no base vertex must be passed here
                 GLuint indexEnd = op.indexData->indexCount - op.indexData->indexStart;
                 if (hasInstanceData)
                 {
-                    if (mGLSupport->checkExtension("GL_ARB_draw_elements_base_vertex") || mHasGL32)
-                    {
-                        OGRE_CHECK_GL_ERROR(glDrawElementsInstancedBaseVertex(primType, op.indexData->indexCount, indexType, pBufferData, numberOfInstances, op.vertexData->vertexStart));
-                    }
-                    else
-                    {
-                        OGRE_CHECK_GL_ERROR(glDrawElementsInstanced(primType, op.indexData->indexCount, indexType, pBufferData, numberOfInstances));
-                    }
+                    OGRE_CHECK_GL_ERROR(glDrawElementsInstanced(primType, op.indexData->indexCount, indexType, pBufferData, numberOfInstances));
                 }
                 else
                 {
-                    if (mGLSupport->checkExtension("GL_ARB_draw_elements_base_vertex") || mHasGL32)
-                    {
-                        OGRE_CHECK_GL_ERROR(glDrawRangeElementsBaseVertex(primType, op.indexData->indexStart, indexEnd, op.indexData->indexCount, indexType, pBufferData, op.vertexData->vertexStart));
-                    }
-                    else
-                    {
-                        OGRE_CHECK_GL_ERROR(glDrawRangeElements(primType, op.indexData->indexStart, indexEnd, op.indexData->indexCount, indexType, pBufferData));
-                    }
+                    OGRE_CHECK_GL_ERROR(glDrawRangeElements(primType, op.indexData->indexStart, indexEnd, op.indexData->indexCount, indexType, pBufferData));
                 }
             } while (updatePassIterationRenderState());
         }
@@ -1831,6 +1731,203 @@ namespace Ogre {
             } while (updatePassIterationRenderState());
         }
 
+        unbindVertexData(updateVAO);
+    }
+
+    void GL3PlusRenderSystem::_renderMultiDraw(const RenderOperation* ops, const Matrix4* worldMatrices, size_t count)
+    {
+        // Call super class.
+        RenderSystem::_renderMultiDraw(ops, worldMatrices, count);
+
+        const RenderOperation& op = ops[0];
+
+        // Per draw data, column major as GLSL expects by default
+        mMultiDrawData.resize(count * 16);
+        float* data = &mMultiDrawData[0];
+        for (size_t i = 0; i < count; ++i, data += 16)
+        {
+            const Matrix4& m = worldMatrices[i];
+            for (size_t col = 0; col < 4; ++col)
+                for (size_t row = 0; row < 4; ++row)
+                    data[col * 4 + row] = static_cast<float>(m[row][col]);
+        }
+
+        if (!mMultiDrawDataBuffer)
+            OGRE_CHECK_GL_ERROR(glGenBuffers(1, &mMultiDrawDataBuffer));
+        mStateCacheManager->bindGLBuffer(GL_SHADER_STORAGE_BUFFER, mMultiDrawDataBuffer);
+        OGRE_CHECK_GL_ERROR(glBufferData(GL_SHADER_STORAGE_BUFFER, mMultiDrawData.size() * sizeof(float),
+                                         &mMultiDrawData[0], GL_STREAM_DRAW));
+        mStateCacheManager->bindGLBufferBase(GL_SHADER_STORAGE_BUFFER, OGRE_GL3PLUS_MULTI_DRAW_BINDING,
+                                             mMultiDrawDataBuffer);
+
+        // Draw commands, the base instance is the index of the per draw data
+        // so it can be read as gl_BaseInstanceARB as well as gl_DrawIDARB
+        mMultiDrawCommands.clear();
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (op.useIndexes)
+            {
+                // DrawElementsIndirectCommand
+                mMultiDrawCommands.push_back(static_cast<GLuint>(ops[i].indexData->indexCount));
+                mMultiDrawCommands.push_back(1);
+                mMultiDrawCommands.push_back(static_cast<GLuint>(ops[i].indexData->indexStart));
+                mMultiDrawCommands.push_back(static_cast<GLuint>(ops[i].vertexData->vertexStart));
+                mMultiDrawCommands.push_back(static_cast<GLuint>(i));
+            }
+            else
+            {
+                // DrawArraysIndirectCommand
+                mMultiDrawCommands.push_back(static_cast<GLuint>(ops[i].vertexData->vertexCount));
+                mMultiDrawCommands.push_back(1);
+                mMultiDrawCommands.push_back(static_cast<GLuint>(ops[i].vertexData->vertexStart));
+                mMultiDrawCommands.push_back(static_cast<GLuint>(i));
+            }
+        }
+
+        if (!mMultiDrawIndirectBuffer)
+            OGRE_CHECK_GL_ERROR(glGenBuffers(1, &mMultiDrawIndirectBuffer));
+        mStateCacheManager->bindGLBuffer(GL_DRAW_INDIRECT_BUFFER, mMultiDrawIndirectBuffer);
+        OGRE_CHECK_GL_ERROR(glBufferData(GL_DRAW_INDIRECT_BUFFER, mMultiDrawCommands.size() * sizeof(GLuint),
+                                         &mMultiDrawCommands[0], GL_STREAM_DRAW));
+
+        // The vertex starts are part of the commands, the global instance
+        // buffer would be indexed by the base instance so it is left out
+        bool updateVAO = bindVertexData(op, 0, false);
+
+        mStateCacheManager->activateGLTextureUnit(0);
+
+        GLint primType = getGLPrimitiveType(op.operationType);
+        if (mCurrentDomainShader)
+            primType = GL_PATCHES;
+
+        if (op.useIndexes)
+        {
+            mStateCacheManager->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER,
+                                             static_cast<GL3PlusHardwareIndexBuffer*>(op.indexData->indexBuffer.get())->getGLBufferId());
+            GLenum indexType = (op.indexData->indexBuffer->getType() == HardwareIndexBuffer::IT_16BIT) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+            OGRE_CHECK_GL_ERROR(glMultiDrawElementsIndirect(primType, indexType, 0, static_cast<GLsizei>(count), 0));
+        }
+        else
+        {
+            OGRE_CHECK_GL_ERROR(glMultiDrawArraysIndirect(primType, 0, static_cast<GLsizei>(count), 0));
+        }
+
+        unbindVertexData(updateVAO);
+    }
+
+    GLint GL3PlusRenderSystem::getGLPrimitiveType(RenderOperation::OperationType type) const
+    {
+        GLint primType;
+        // Use adjacency if there is a geometry program and it requested adjacency info.
+        bool useAdjacency = (mGeometryProgramBound && mCurrentGeometryShader && mCurrentGeometryShader->isAdjacencyInfoRequired());
+        switch (type)
+        {
+        case RenderOperation::OT_POINT_LIST:
+            primType = GL_POINTS;
+            break;
+        case RenderOperation::OT_LINE_LIST:
+            primType = useAdjacency ? GL_LINES_ADJACENCY : GL_LINES;
+            break;
+        case RenderOperation::OT_LINE_STRIP:
+            primType = useAdjacency ? GL_LINE_STRIP_ADJACENCY : GL_LINE_STRIP;
+            break;
+        default:
+        case RenderOperation::OT_TRIANGLE_LIST:
+            primType = useAdjacency ? GL_TRIANGLES_ADJACENCY : GL_TRIANGLES;
+            break;
+        case RenderOperation::OT_TRIANGLE_STRIP:
+            primType = useAdjacency ? GL_TRIANGLE_STRIP_ADJACENCY : GL_TRIANGLE_STRIP;
+            break;
+        case RenderOperation::OT_TRIANGLE_FAN:
+            primType = GL_TRIANGLE_FAN;
+            break;
+        }
+
+        return primType;
+    }
+
+    bool GL3PlusRenderSystem::bindVertexData(const RenderOperation& op, size_t vertexStart,
+                                             bool bindGlobalInstanceData)
+    {
+        // Get vertex array organization.
+        const VertexDeclaration::VertexElementList& decl =
+            op.vertexData->vertexDeclaration->getElements();
+        VertexDeclaration::VertexElementList::const_iterator elemIter, elemEnd;
+        elemEnd = decl.end();
+
+        // Bind VAO (set of per-vertex attributes: position, normal, etc.).
+        bool updateVAO = true;
+        if (mCurrentCapabilities->hasCapability(RSC_SEPARATE_SHADER_OBJECTS))
+        {
+            GLSLSeparableProgram* separableProgram =
+                GLSLSeparableProgramManager::getSingleton().getCurrentSeparableProgram();
+            if (separableProgram)
+            {
+                if (!op.renderToVertexBuffer)
+                {
+                    separableProgram->activate();
+                }
+
+                updateVAO = !separableProgram->getVertexArrayObject()->isInitialised();
+
+                separableProgram->getVertexArrayObject()->bind();
+            }
+            else
+            {
+                Ogre::LogManager::getSingleton().logMessage(
+                    "ERROR: Failed to create separable program.", LML_CRITICAL);
+            }
+        }
+        else
+        {
+            GLSLMonolithicProgram* monolithicProgram = GLSLMonolithicProgramManager::getSingleton().getActiveMonolithicProgram();
+            if (monolithicProgram)
+            {
+                updateVAO = !monolithicProgram->getVertexArrayObject()->isInitialised();
+
+                monolithicProgram->getVertexArrayObject()->bind();
+            }
+            else
+            {
+                Ogre::LogManager::getSingleton().logMessage(
+                    "ERROR: Failed to create monolithic program.", LML_CRITICAL);
+            }
+        }
+
+        // Bind the appropriate VBOs to the active attributes of the VAO.
+        for (elemIter = decl.begin(); elemIter != elemEnd; ++elemIter)
+        {
+            const VertexElement & elem = *elemIter;
+            uint16 source = elem.getSource();
+
+            if (!op.vertexData->vertexBufferBinding->isBufferBound(source))
+                continue; // Skip unbound elements.
+
+            HardwareVertexBufferSharedPtr vertexBuffer =
+                op.vertexData->vertexBufferBinding->getBuffer(source);
+
+            bindVertexElementToGpu(elem, vertexBuffer, vertexStart,
+                                   mRenderAttribsBound, mRenderInstanceAttribsBound, updateVAO);
+        }
+
+        HardwareVertexBufferSharedPtr globalInstanceVertexBuffer = getGlobalInstanceVertexBuffer();
+        VertexDeclaration* globalVertexDeclaration = getGlobalInstanceVertexBufferVertexDeclaration();
+        if ( bindGlobalInstanceData && !globalInstanceVertexBuffer.isNull() && globalVertexDeclaration != NULL )
+        {
+            elemEnd = globalVertexDeclaration->getElements().end();
+            for (elemIter = globalVertexDeclaration->getElements().begin(); elemIter != elemEnd; ++elemIter)
+            {
+                const VertexElement & elem = *elemIter;
+                bindVertexElementToGpu(elem, globalInstanceVertexBuffer, 0,
+                                       mRenderAttribsBound, mRenderInstanceAttribsBound, updateVAO);
+            }
+        }
+
+        return updateVAO;
+    }
+
+    void GL3PlusRenderSystem::unbindVertexData(bool updateVAO)
+    {
         // Unbind VAO (if updated).
         if (updateVAO)
         {
@@ -1854,7 +1951,7 @@ namespace Ogre {
 
             // Unbind the vertex array object.
             // Marks the end of what state will be included.
-            OGRE_CHECK_GL_ERROR(glBindVertexArray(0));
+            mStateCacheManager->bindGLVertexArray(0);
         }
 
 
@@ -1876,7 +1973,7 @@ namespace Ogre {
 
         if (enabled)
         {
-            OGRE_CHECK_GL_ERROR(glEnable(GL_SCISSOR_TEST));
+            mStateCacheManager->setEnabled(GL_SCISSOR_TEST, true);
             // NB GL uses width / height rather than right / bottom
             x = left;
             if (flipping)
@@ -1885,14 +1982,14 @@ namespace Ogre {
                 y = targetHeight - bottom;
             w = right - left;
             h = bottom - top;
-            OGRE_CHECK_GL_ERROR(glScissor(static_cast<GLsizei>(x),
-                                          static_cast<GLsizei>(y),
-                                          static_cast<GLsizei>(w),
-                                          static_cast<GLsizei>(h)));
+            mStateCacheManager->setScissor(static_cast<GLsizei>(x),
+                                           static_cast<GLsizei>(y),
+                                           static_cast<GLsizei>(w),
+                                           static_cast<GLsizei>(h));
         }
         else
         {
-            OGRE_CHECK_GL_ERROR(glDisable(GL_SCISSOR_TEST));
+            mStateCacheManager->setEnabled(GL_SCISSOR_TEST, false);
             // GL requires you to reset the scissor when disabling
             w = mActiveViewport->getActualWidth();
             h = mActiveViewport->getActualHeight();
@@ -1901,10 +1998,10 @@ namespace Ogre {
                 y = mActiveViewport->getActualTop();
             else
                 y = targetHeight - mActiveViewport->getActualTop() - h;
-            OGRE_CHECK_GL_ERROR(glScissor(static_cast<GLsizei>(x),
-                                          static_cast<GLsizei>(y),
-                                          static_cast<GLsizei>(w),
-                                          static_cast<GLsizei>(h)));
+            mStateCacheManager->setScissor(static_cast<GLsizei>(x),
+                                           static_cast<GLsizei>(y),
+                                           static_cast<GLsizei>(w),
+                                           static_cast<GLsizei>(h));
         }
     }
 
@@ -1922,9 +2019,9 @@ namespace Ogre {
             // Enable buffer for writing if it isn't
             if (colourMask)
             {
-                OGRE_CHECK_GL_ERROR(glColorMask(true, true, true, true));
+                mStateCacheManager->setColourMask(true, true, true, true);
             }
-            OGRE_CHECK_GL_ERROR(glClearColor(colour.r, colour.g, colour.b, colour.a));
+            mStateCacheManager->setClearColour(colour.r, colour.g, colour.b, colour.a);
         }
         if (buffers & FBT_DEPTH)
         {
@@ -1932,15 +2029,15 @@ namespace Ogre {
             // Enable buffer for writing if it isn't
             if (!mDepthWrite)
             {
-                OGRE_CHECK_GL_ERROR(glDepthMask(GL_TRUE));
+                mStateCacheManager->setDepthMask(GL_TRUE);
             }
-            OGRE_CHECK_GL_ERROR(glClearDepth(depth));
+            mStateCacheManager->setClearDepth(depth);
         }
         if (buffers & FBT_STENCIL)
         {
             flags |= GL_STENCIL_BUFFER_BIT;
             // Enable buffer for writing if it isn't
-            OGRE_CHECK_GL_ERROR(glStencilMask(0xFFFFFFFF));
+            mStateCacheManager->setStencilMask(0xFFFFFFFF);
             OGRE_CHECK_GL_ERROR(glClearStencil(stencil));
         }
 
@@ -1948,19 +2045,25 @@ namespace Ogre {
         // relied on scissor box bounds.
         if (!mScissorsEnabled)
         {
-            OGRE_CHECK_GL_ERROR(glEnable(GL_SCISSOR_TEST));
+            mStateCacheManager->setEnabled(GL_SCISSOR_TEST, true);
         }
 
         // Sets the scissor box as same as viewport
         GLint viewport[4], scissor[4];
-        OGRE_CHECK_GL_ERROR(glGetIntegerv(GL_VIEWPORT, viewport));
-        OGRE_CHECK_GL_ERROR(glGetIntegerv(GL_SCISSOR_BOX, scissor));
+        memcpy(viewport, mStateCacheManager->getViewport(), sizeof(viewport));
+        memcpy(scissor, mStateCacheManager->getScissor(), sizeof(scissor));
+        if (viewport[2] < 0 || scissor[2] < 0)
+        {
+            // Not set through the state cache yet, ask GL
+            OGRE_CHECK_GL_ERROR(glGetIntegerv(GL_VIEWPORT, viewport));
+            OGRE_CHECK_GL_ERROR(glGetIntegerv(GL_SCISSOR_BOX, scissor));
+        }
         bool scissorBoxDifference =
             viewport[0] != scissor[0] || viewport[1] != scissor[1] ||
             viewport[2] != scissor[2] || viewport[3] != scissor[3];
         if (scissorBoxDifference)
         {
-            OGRE_CHECK_GL_ERROR(glScissor(viewport[0], viewport[1], viewport[2], viewport[3]));
+            mStateCacheManager->setScissor(viewport[0], viewport[1], viewport[2], viewport[3]);
         }
 
         // Clear buffers
@@ -1969,29 +2072,29 @@ namespace Ogre {
         // Restore scissor box
         if (scissorBoxDifference)
         {
-            OGRE_CHECK_GL_ERROR(glScissor(scissor[0], scissor[1], scissor[2], scissor[3]));
+            mStateCacheManager->setScissor(scissor[0], scissor[1], scissor[2], scissor[3]);
         }
 
         // Restore scissor test
         if (!mScissorsEnabled)
         {
-            OGRE_CHECK_GL_ERROR(glDisable(GL_SCISSOR_TEST));
+            mStateCacheManager->setEnabled(GL_SCISSOR_TEST, false);
         }
 
         // Reset buffer write state
         if (!mDepthWrite && (buffers & FBT_DEPTH))
         {
-            OGRE_CHECK_GL_ERROR(glDepthMask(GL_FALSE));
+            mStateCacheManager->setDepthMask(GL_FALSE);
         }
 
         if (colourMask && (buffers & FBT_COLOUR))
         {
-            OGRE_CHECK_GL_ERROR(glColorMask(mColourWrite[0], mColourWrite[1], mColourWrite[2], mColourWrite[3]));
+            mStateCacheManager->setColourMask(mColourWrite[0], mColourWrite[1], mColourWrite[2], mColourWrite[3]);
         }
 
         if (buffers & FBT_STENCIL)
         {
-            OGRE_CHECK_GL_ERROR(glStencilMask(mStencilWriteMask));
+            mStateCacheManager->setStencilMask(mStencilWriteMask);
         }
     }
 
@@ -2022,6 +2125,9 @@ namespace Ogre {
         mCurrentContext = context;
         mCurrentContext->setCurrent();
 
+        // Each context has its own state, so it needs its own cache
+        switchContextCache(mCurrentContext);
+
         // Check if the context has already done one-time initialisation
         if (!mCurrentContext->getInitialized())
         {
@@ -2044,11 +2150,11 @@ namespace Ogre {
             mCurrentComputeShader->bind();
 
         // Must reset depth/colour write mask to according with user desired, otherwise,
-        // clearFrameBuffer would be wrong because the value we are recorded may be
-        // difference with the really state stored in GL context.
-        OGRE_CHECK_GL_ERROR(glDepthMask(mDepthWrite));
-        OGRE_CHECK_GL_ERROR(glColorMask(mColourWrite[0], mColourWrite[1], mColourWrite[2], mColourWrite[3]));
-        OGRE_CHECK_GL_ERROR(glStencilMask(mStencilWriteMask));
+        // clearFrameBuffer would be wrong because the state cache of a new context
+        // starts with the GL defaults.
+        mStateCacheManager->setDepthMask(mDepthWrite);
+        mStateCacheManager->setColourMask(mColourWrite[0], mColourWrite[1], mColourWrite[2], mColourWrite[3]);
+        mStateCacheManager->setStencilMask(mStencilWriteMask);
     }
 
     void GL3PlusRenderSystem::_unregisterContext(GL3PlusContext *context)
@@ -2070,11 +2176,55 @@ namespace Ogre {
                 mMainContext = 0;
             }
         }
+
+        unregisterContextCache(context);
+    }
+
+    void GL3PlusRenderSystem::switchContextCache(GL3PlusContext* context)
+    {
+        CachesMap::iterator it = mCaches.find(context);
+        if (it != mCaches.end())
+        {
+            // Already have a cache for this context
+            mStateCacheManager = &it->second;
+        }
+        else
+        {
+            // No cache for this context yet
+            mStateCacheManager = &mCaches[context];
+            mStateCacheManager->initializeCache();
+        }
+
+        mGLSupport->setStateCacheManager(mStateCacheManager);
+    }
+
+    void GL3PlusRenderSystem::unregisterContextCache(GL3PlusContext* context)
+    {
+        CachesMap::iterator it = mCaches.find(context);
+        if (it != mCaches.end())
+        {
+            if (mStateCacheManager == &it->second)
+                mStateCacheManager = NULL;
+            mCaches.erase(it);
+        }
+
+        // Always keep a valid cache, even if no contexts are left.
+        // The hardware buffer and texture managers may still delete GL
+        // objects through it during shutdown.
+        if (!mStateCacheManager)
+        {
+            // Therefore we add a "dummy" cache if none are left
+            if (mCaches.empty())
+                mCaches[0];
+            mStateCacheManager = &mCaches.begin()->second;
+        }
+
+        mGLSupport->setStateCacheManager(mStateCacheManager);
     }
 
     void GL3PlusRenderSystem::_oneTimeContextInitialization()
     {
-        OGRE_CHECK_GL_ERROR(glDisable(GL_DITHER));
+        mStateCacheManager->setEnabled(GL_DITHER, false);
 
         // Check for FSAA
         // Enable the extension if it was enabled by the GL3PlusSupport
@@ -2082,7 +2232,7 @@ namespace Ogre {
         OGRE_CHECK_GL_ERROR(glGetIntegerv(GL_SAMPLE_BUFFERS, (GLint*)&fsaa_active));
         if (fsaa_active)
         {
-            OGRE_CHECK_GL_ERROR(glEnable(GL_MULTISAMPLE));
+            mStateCacheManager->setEnabled(GL_MULTISAMPLE, true);
             LogManager::getSingleton().logMessage("Using FSAA.");
         }
 
@@ -2094,7 +2244,7 @@ namespace Ogre {
         if (mGLSupport->checkExtension("GL_ARB_seamless_cube_map") || mHasGL32)
         {
             // Enable seamless cube maps
-            OGRE_CHECK_GL_ERROR(glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS));
+            mStateCacheManager->setEnabled(GL_TEXTURE_CUBE_MAP_SEAMLESS, true);
         }
 
         if (mGLSupport->checkExtension("GL_ARB_provoking_vertex") || mHasGL32)
@@ -2106,8 +2256,8 @@ namespace Ogre {
         if (mGLSupport->checkExtension("GL_KHR_debug") || mHasGL43)
         {
 #if OGRE_DEBUG_MODE && ENABLE_GL_DEBUG_OUTPUT
-            OGRE_CHECK_GL_ERROR(glEnable(GL_DEBUG_OUTPUT));
-            OGRE_CHECK_GL_ERROR(glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS));
+            mStateCacheManager->setEnabled(GL_DEBUG_OUTPUT, true);
+            mStateCacheManager->setEnabled(GL_DEBUG_OUTPUT_SYNCHRONOUS, true);
             OGRE_CHECK_GL_ERROR(glDebugMessageCallbackARB(&GLDebugCallback, NULL));
             OGRE_CHECK_GL_ERROR(glDebugMessageControlARB(GL_DEBUG_SOURCE_THIRD_PARTY, GL_DEBUG_TYPE_OTHER, GL_DONT_CARE, 0, NULL, GL_TRUE));
 #endif
@@ -2135,6 +2285,9 @@ namespace Ogre {
         // Setup GL3PlusSupport
         mGLSupport->initialiseExtensions();
 
+        // Set up the state cache of the main context
+        switchContextCache(mCurrentContext);
+
         mHasGL32 = mGLSupport->hasMinGLVersion(3, 2);
         mHasGL43 = mGLSupport->hasMinGLVersion(4, 3);
 
@@ -2177,7 +2330,7 @@ namespace Ogre {
             // Enable / disable sRGB states
             if (target->isHardwareGammaEnabled())
             {
-                OGRE_CHECK_GL_ERROR(glEnable(GL_FRAMEBUFFER_SRGB));
+                mStateCacheManager->setEnabled(GL_FRAMEBUFFER_SRGB, true);
 
                 // Note: could test GL_FRAMEBUFFER_SRGB_CAPABLE here before
                 // enabling, but GL spec says incapable surfaces ignore the setting
@@ -2185,7 +2338,7 @@ namespace Ogre {
             }
             else
             {
-                OGRE_CHECK_GL_ERROR(glDisable(GL_FRAMEBUFFER_SRGB));
+                mStateCacheManager->setEnabled(GL_FRAMEBUFFER_SRGB, false);
             }
         }
     }
@@ -2486,7 +2639,7 @@ namespace Ogre {
 
     void GL3PlusRenderSystem::setClipPlanesImpl(const Ogre::PlaneList& planeList)
     {
-        OGRE_CHECK_GL_ERROR(glEnable(GL_DEPTH_CLAMP));
+        mStateCacheManager->setEnabled(GL_DEPTH_CLAMP, true);
     }
 
     void GL3PlusRenderSystem::registerThread()
@@ -2574,36 +2727,6 @@ namespace Ogre {
                                  eventName.c_str());
     }
 
-    bool GL3PlusRenderSystem::activateGLTextureUnit(size_t unit)
-    {
-        if (mActiveTextureUnit != unit)
-        {
-            if (unit < getCapabilities()->getNumTextureUnits())
-            {
-                OGRE_CHECK_GL_ERROR(glActiveTexture(static_cast<uint32>(GL_TEXTURE0 + unit)));
-                mActiveTextureUnit = static_cast<GLenum>(unit);
-                return true;
-            }
-            else if (!unit)
-            {
-                //FIXME If the above case fails, should this case ever be taken?
-                // Also switch to (unit == number) unless not operation is actually
-                // faster on some architectures.
-
-                // Always OK to use the first unit.
-                return true;
-            }
-            else
-            {
-                return false;
-            }
-        }
-        else
-        {
-            return true;
-        }
-    }
-
     void GL3PlusRenderSystem::bindVertexElementToGpu( const VertexElement &elem,
                                                       HardwareVertexBufferSharedPtr vertexBuffer, const size_t vertexStart,
                                                       vector<GLuint>::type &attribsBound,
@@ -2615,8 +2738,8 @@ namespace Ogre {
         // FIXME: Having this commented out fixes some rendering issues but leaves VAO's useless
         // if (updateVAO)
         {
-            OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ARRAY_BUFFER,
-                                             hwGlBuffer->getGLBufferId()));
+            mStateCacheManager->bindGLBuffer(GL_ARRAY_BUFFER,
+                                             hwGlBuffer->getGLBufferId());
             void* pBufferData = GL_BUFFER_OFFSET(elem.getOffset());
 
             if (vertexStart)
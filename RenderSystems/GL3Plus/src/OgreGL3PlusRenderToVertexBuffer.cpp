@@ -39,6 +39,8 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreGLSLSeparableProgramManager.h"
 #include "OgreStringConverter.h"
 #include "OgreTechnique.h"
+#include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusSupport.h"
 #include <iostream>
 
 namespace Ogre {
@@ -254,7 +256,7 @@ namespace Ogre {
         // size_t targetBufferIndex = mSourceBufferIndex == 0 ? 0 : 1;
 
         // Disable rasterization.
-        OGRE_CHECK_GL_ERROR(glEnable(GL_RASTERIZER_DISCARD));
+        getGL3PlusSupportRef()->getStateCacheManager()->setEnabled(GL_RASTERIZER_DISCARD, true);
 
         // Bind shader parameters.
         RenderSystem* targetRenderSystem = Root::getSingleton().getRenderSystem();
@@ -281,7 +283,7 @@ namespace Ogre {
         // Bind source vertex array + target tranform feedback buffer.
         GL3PlusHardwareVertexBuffer* targetVertexBuffer = static_cast<GL3PlusHardwareVertexBuffer*>(mVertexBuffers[mTargetBufferIndex].getPointer());
         // OGRE_CHECK_GL_ERROR(glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, VertexBuffer[mTargetBufferIndex]));
-        OGRE_CHECK_GL_ERROR(glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, targetVertexBuffer->getGLBufferId()));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, targetVertexBuffer->getGLBufferId());
         // OGRE_CHECK_GL_ERROR(glBindVertexArray(VertexArray[mSourceBufferIndex]));
         if (Root::getSingleton().getRenderSystem()->getCapabilities()->hasCapability(RSC_SEPARATE_SHADER_OBJECTS))
         {
@@ -333,7 +335,7 @@ namespace Ogre {
         mTargetBufferIndex = mTargetBufferIndex == 0 ? 1 : 0;
 
         // Enable rasterization.
-        OGRE_CHECK_GL_ERROR(glDisable(GL_RASTERIZER_DISCARD));
+        getGL3PlusSupportRef()->getStateCacheManager()->setEnabled(GL_RASTERIZER_DISCARD, false);
 
         // Clear the reset flag.
         mResetRequested = false;
@@ -39,6 +39,8 @@
 #include "OgreGLSLMonolithicProgramManager.h"
 #include "OgreGLSLSeparableProgram.h"
 #include "OgreGLSLSeparableProgramManager.h"
+#include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusSupport.h"
 
 namespace Ogre {
 
@@ -51,7 +53,7 @@ namespace Ogre {
         // devise mWidth, mHeight and mDepth and mFormat
         GLint value = 0;
 
-        OGRE_CHECK_GL_ERROR(glBindTexture(mTarget, mTextureID));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLTexture(mTarget, mTextureID);
 
         // Get face identifier
         mFaceTarget = mTarget;
@@ -139,12 +141,12 @@ namespace Ogre {
 
     void GL3PlusTextureBuffer::upload(const PixelBox &data, const Image::Box &dest)
     {
-        OGRE_CHECK_GL_ERROR(glBindTexture(mTarget, mTextureID));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLTexture(mTarget, mTextureID);
 
         OGRE_CHECK_GL_ERROR(glGenBuffers(1, &mBufferId));
 
         // Use PBO as a texture buffer.
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_PIXEL_UNPACK_BUFFER, mBufferId);
 
         // Calculate size for all mip levels of the texture.
         size_t dataSize = 0;
@@ -311,8 +313,8 @@ namespace Ogre {
         }
 
         // Delete PBO.
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
-        OGRE_CHECK_GL_ERROR(glDeleteBuffers(1, &mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        getGL3PlusSupportRef()->getStateCacheManager()->deleteGLBuffer(GL_PIXEL_UNPACK_BUFFER, mBufferId);
         mBufferId = 0;
 
         // Restore defaults.
@@ -333,7 +335,7 @@ namespace Ogre {
 
         // Upload data to PBO
         OGRE_CHECK_GL_ERROR(glGenBuffers(1, &mBufferId));
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_PIXEL_PACK_BUFFER, mBufferId);
 
         OGRE_CHECK_GL_ERROR(glBufferData(GL_PIXEL_PACK_BUFFER, mSizeInBytes, NULL,
                                          GL3PlusHardwareBufferManager::getGLUsage(mUsage)));
@@ -347,7 +349,7 @@ namespace Ogre {
         //        << " format: " << PixelUtil::getFormatName(mFormat);
         //        LogManager::getSingleton().logMessage(LML_NORMAL, str.str());
 
-        OGRE_CHECK_GL_ERROR(glBindTexture(mTarget, mTextureID));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLTexture(mTarget, mTextureID);
         if (PixelUtil::isCompressed(data.format))
         {
             if (data.format != mFormat || !data.isConsecutive())
@@ -422,8 +424,8 @@ namespace Ogre {
         }
 
         // Delete PBO
-        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
-        OGRE_CHECK_GL_ERROR(glDeleteBuffers(1, &mBufferId));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        getGL3PlusSupportRef()->getStateCacheManager()->deleteGLBuffer(GL_PIXEL_PACK_BUFFER, mBufferId);
         mBufferId = 0;
     }
 
@@ -438,7 +440,7 @@ namespace Ogre {
 
     void GL3PlusTextureBuffer::copyFromFramebuffer(uint32 zoffset)
     {
-        OGRE_CHECK_GL_ERROR(glBindTexture(mTarget, mTextureID));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLTexture(mTarget, mTextureID);
         switch(mTarget)
         {
         case GL_TEXTURE_1D:
@@ -519,9 +521,9 @@ namespace Ogre {
             // If target format not directly supported, create intermediate texture
             GLenum tempFormat = GL3PlusPixelUtil::getClosestGLInternalFormat(fboMan->getSupportedAlternative(mFormat));
             OGRE_CHECK_GL_ERROR(glGenTextures(1, &tempTex));
-            OGRE_CHECK_GL_ERROR(glBindTexture(GL_TEXTURE_2D, tempTex));
-            OGRE_CHECK_GL_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0));
-            OGRE_CHECK_GL_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLTexture(GL_TEXTURE_2D, tempTex);
+            getGL3PlusSupportRef()->getStateCacheManager()->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+            getGL3PlusSupportRef()->getStateCacheManager()->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
 
             // Allocate temporary texture of the size of the destination area
             OGRE_CHECK_GL_ERROR(glTexImage2D(GL_TEXTURE_2D, 0, tempFormat,
@@ -533,12 +535,12 @@ namespace Ogre {
             OGRE_CHECK_GL_ERROR(glCheckFramebufferStatus(GL_FRAMEBUFFER));
 
             // Set viewport to size of destination slice
-            OGRE_CHECK_GL_ERROR(glViewport(0, 0, dstBox.getWidth(), dstBox.getHeight()));
+            getGL3PlusSupportRef()->getStateCacheManager()->setViewport(0, 0, dstBox.getWidth(), dstBox.getHeight());
         }
         else
         {
             // We are going to bind directly, so set viewport to size and position of destination slice
-            OGRE_CHECK_GL_ERROR(glViewport(dstBox.left, dstBox.top, dstBox.getWidth(), dstBox.getHeight()));
+            getGL3PlusSupportRef()->getStateCacheManager()->setViewport(dstBox.left, dstBox.top, dstBox.getWidth(), dstBox.getHeight());
         }
 
         // Process each destination slice
@@ -596,13 +598,13 @@ namespace Ogre {
             // Generate mipmaps
             if (mUsage & TU_AUTOMIPMAP)
             {
-                OGRE_CHECK_GL_ERROR(glBindTexture(mTarget, mTextureID));
+                getGL3PlusSupportRef()->getStateCacheManager()->bindGLTexture(mTarget, mTextureID);
                 OGRE_CHECK_GL_ERROR(glGenerateMipmap(mTarget));
             }
         }
 
         // Reset source texture to sane state
-        OGRE_CHECK_GL_ERROR(glBindTexture(src->mTarget, src->mTextureID));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLTexture(src->mTarget, src->mTextureID);
 
         if (mFormat == PF_DEPTH)
         {
@@ -621,7 +623,7 @@ namespace Ogre {
 
         // Restore old framebuffer
         OGRE_CHECK_GL_ERROR(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, oldfb));
-        OGRE_CHECK_GL_ERROR(glDeleteTextures(1, &tempTex));
+        getGL3PlusSupportRef()->getStateCacheManager()->deleteGLTexture(tempTex);
     }
 
     void GL3PlusTextureBuffer::_bindToFramebuffer(GLenum attachment, uint32 zoffset, GLenum which)
@@ -629,7 +631,7 @@ namespace Ogre {
         assert(zoffset < mDepth);
         assert(which == GL_READ_FRAMEBUFFER || which == GL_DRAW_FRAMEBUFFER || which == GL_FRAMEBUFFER);
 
-        OGRE_CHECK_GL_ERROR(glBindTexture(mTarget, mTextureID));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLTexture(mTarget, mTextureID);
         switch(mTarget)
         {
         case GL_TEXTURE_1D:
@@ -697,11 +699,11 @@ namespace Ogre {
         OGRE_CHECK_GL_ERROR(glGenTextures(1, &id));
 
         // Set texture type
-        OGRE_CHECK_GL_ERROR(glBindTexture(target, id));
+        getGL3PlusSupportRef()->getStateCacheManager()->bindGLTexture(target, id);
 
         // Set automatic mipmap generation; nice for minimisation
-        OGRE_CHECK_GL_ERROR(glTexParameteri(target, GL_TEXTURE_BASE_LEVEL, 0));
-        OGRE_CHECK_GL_ERROR(glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, 1000));
+        getGL3PlusSupportRef()->getStateCacheManager()->setTexParameteri(target, GL_TEXTURE_BASE_LEVEL, 0);
+        getGL3PlusSupportRef()->getStateCacheManager()->setTexParameteri(target, GL_TEXTURE_MAX_LEVEL, 1000);
 
         GLenum internalFormat = GL3PlusPixelUtil::getGLInternalFormat(src.format);
 
@@ -741,7 +743,7 @@ namespace Ogre {
         blitFromTexture(&tex, tempTarget, dstBox);
 
         // Delete temp texture
-        OGRE_CHECK_GL_ERROR(glDeleteTextures(1, &id));
+        getGL3PlusSupportRef()->getStateCacheManager()->deleteGLTexture(id);
     }
 
 
@@ -30,6 +30,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreGL3PlusRenderTexture.h"
 #include "OgreRoot.h"
 #include "OgreRenderSystem.h"
+#include "OgreGL3PlusStateCacheManager.h"
 
 namespace Ogre {
     GL3PlusTextureManager::GL3PlusTextureManager(GL3PlusSupport& support)
@@ -47,7 +48,7 @@ namespace Ogre {
         ResourceGroupManager::getSingleton()._unregisterResourceManager(mResourceType);
 
         // Delete warning texture
-        OGRE_CHECK_GL_ERROR(glDeleteTextures(1, &mWarningTextureID));
+        mGLSupport.getStateCacheManager()->deleteGLTexture(mWarningTextureID);
     }
 
     Resource* GL3PlusTextureManager::createImpl(const String& name, ResourceHandle handle,
@@ -98,9 +99,9 @@ namespace Ogre {
 
         // Create GL resource
         OGRE_CHECK_GL_ERROR(glGenTextures(1, &mWarningTextureID));
-        OGRE_CHECK_GL_ERROR(glBindTexture(GL_TEXTURE_2D, mWarningTextureID));
-        OGRE_CHECK_GL_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0));
-        OGRE_CHECK_GL_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
+        mGLSupport.getStateCacheManager()->bindGLTexture(GL_TEXTURE_2D, mWarningTextureID);
+        mGLSupport.getStateCacheManager()->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+        mGLSupport.getStateCacheManager()->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
         OGRE_CHECK_GL_ERROR(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, (void*)data));
 
         // Free memory
@@ -27,6 +27,9 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 */
 #include "OgreGL3PlusVertexArrayObject.h"
 #include "OgreLogManager.h"
+#include "OgreGL3PlusRenderSystem.h"
+#include "OgreGL3PlusSupport.h"
+#include "OgreRoot.h"
 
 namespace Ogre {
 
@@ -49,7 +52,7 @@ namespace Ogre {
     {
         if (mVAO)
         {
-            OGRE_CHECK_GL_ERROR(glDeleteVertexArrays(1, &mVAO));
+            getGL3PlusSupportRef()->getStateCacheManager()->deleteGLVertexArray(mVAO);
             mVAO = 0;
         }
     }
@@ -59,7 +62,7 @@ namespace Ogre {
     {
         if (mVAO)
         {
-            OGRE_CHECK_GL_ERROR(glBindVertexArray(mVAO));
+            getGL3PlusSupportRef()->getStateCacheManager()->bindGLVertexArray(mVAO);
         }
     }
 
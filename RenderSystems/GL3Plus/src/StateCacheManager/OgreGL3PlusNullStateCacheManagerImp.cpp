@@ -0,0 +1,375 @@
+/*
+ -----------------------------------------------------------------------------
+ This source file is part of OGRE
+ (Object-oriented Graphics Rendering Engine)
+ For the latest info, see http://www.ogre3d.org/
+
+ Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "OgreStableHeaders.h"
+#include "OgreGL3PlusStateCacheManager.h"
+#include "OgreGL3PlusRenderSystem.h"
+#include "OgreLogManager.h"
+#include "OgreRoot.h"
+
+namespace Ogre {
+
+    GL3PlusStateCacheManager::GL3PlusStateCacheManager(void)
+    {
+        clearCache();
+        resetStats();
+    }
+
+    GL3PlusStateCacheManager::~GL3PlusStateCacheManager(void)
+    {
+    }
+
+    void GL3PlusStateCacheManager::initializeCache()
+    {
+        OGRE_CHECK_GL_ERROR(glBlendEquation(GL_FUNC_ADD));
+
+        OGRE_CHECK_GL_ERROR(glBlendFunc(GL_ONE, GL_ZERO));
+
+        OGRE_CHECK_GL_ERROR(glCullFace(mCullFace));
+
+        OGRE_CHECK_GL_ERROR(glDepthFunc(mDepthFunc));
+
+        OGRE_CHECK_GL_ERROR(glDepthMask(mDepthMask));
+
+        OGRE_CHECK_GL_ERROR(glStencilMask(0xFFFFFFFF));
+
+        OGRE_CHECK_GL_ERROR(glClearDepth(mClearDepth));
+
+        OGRE_CHECK_GL_ERROR(glBindVertexArray(0));
+
+        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ARRAY_BUFFER, 0));
+
+        OGRE_CHECK_GL_ERROR(glUseProgram(0));
+
+        OGRE_CHECK_GL_ERROR(glActiveTexture(GL_TEXTURE0));
+
+        OGRE_CHECK_GL_ERROR(glClearColor(mClearColour[0], mClearColour[1], mClearColour[2], mClearColour[3]));
+
+        OGRE_CHECK_GL_ERROR(glColorMask(mColourMask[0], mColourMask[1], mColourMask[2], mColourMask[3]));
+    }
+
+    void GL3PlusStateCacheManager::clearCache()
+    {
+        mDepthMask = GL_TRUE;
+        mPolygonMode = GL_FILL;
+        mCullFace = GL_BACK;
+        mDepthFunc = GL_LESS;
+        mActiveTextureUnit = 0;
+        mClearDepth = 1.0;
+
+        mClearColour[0] = mClearColour[1] = mClearColour[2] = mClearColour[3] = 0.0f;
+        mColourMask[0] = mColourMask[1] = mColourMask[2] = mColourMask[3] = GL_TRUE;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            mViewport[i] = -1;
+            mScissor[i] = -1;
+        }
+    }
+
+    void GL3PlusStateCacheManager::resetStats(void)
+    {
+        memset(&mStats, 0, sizeof(Stats));
+    }
+
+    void GL3PlusStateCacheManager::bindGLBuffer(GLenum target, GLuint buffer, bool force)
+    {
+        // Update GL
+        notifyIssued(SCC_BUFFER);
+        if (target == GL_FRAMEBUFFER)
+        {
+            OGRE_CHECK_GL_ERROR(glBindFramebuffer(target, buffer));
+        }
+        else if (target == GL_RENDERBUFFER)
+        {
+            OGRE_CHECK_GL_ERROR(glBindRenderbuffer(target, buffer));
+        }
+        else
+        {
+            OGRE_CHECK_GL_ERROR(glBindBuffer(target, buffer));
+        }
+    }
+
+    void GL3PlusStateCacheManager::bindGLBufferBase(GLenum target, GLuint index, GLuint buffer)
+    {
+        notifyIssued(SCC_BUFFER);
+        OGRE_CHECK_GL_ERROR(glBindBufferBase(target, index, buffer));
+    }
+
+    void GL3PlusStateCacheManager::deleteGLBuffer(GLenum target, GLuint buffer)
+    {
+        // Buffer name 0 is reserved and we should never try to delete it
+        if (buffer == 0)
+            return;
+
+        if (target == GL_FRAMEBUFFER)
+        {
+            OGRE_CHECK_GL_ERROR(glDeleteFramebuffers(1, &buffer));
+        }
+        else if (target == GL_RENDERBUFFER)
+        {
+            OGRE_CHECK_GL_ERROR(glDeleteRenderbuffers(1, &buffer));
+        }
+        else
+        {
+            OGRE_CHECK_GL_ERROR(glDeleteBuffers(1, &buffer));
+        }
+    }
+
+    void GL3PlusStateCacheManager::bindGLVertexArray(GLuint vao)
+    {
+        notifyIssued(SCC_VERTEX_ARRAY);
+        OGRE_CHECK_GL_ERROR(glBindVertexArray(vao));
+    }
+
+    void GL3PlusStateCacheManager::deleteGLVertexArray(GLuint vao)
+    {
+        if (vao == 0)
+            return;
+
+        OGRE_CHECK_GL_ERROR(glDeleteVertexArrays(1, &vao));
+    }
+
+    void GL3PlusStateCacheManager::bindGLTexture(GLenum target, GLuint texture)
+    {
+        // Update GL
+        notifyIssued(SCC_TEXTURE);
+        OGRE_CHECK_GL_ERROR(glBindTexture(target, texture));
+    }
+
+    void GL3PlusStateCacheManager::deleteGLTexture(GLuint texture)
+    {
+        if (texture == 0)
+            return;
+
+        OGRE_CHECK_GL_ERROR(glDeleteTextures(1, &texture));
+    }
+
+    void GL3PlusStateCacheManager::invalidateStateForTexture(GLuint texture)
+    {
+    }
+
+    void GL3PlusStateCacheManager::setTexParameteri(GLenum target, GLenum pname, GLint param)
+    {
+        // Update GL
+        notifyIssued(SCC_SAMPLER);
+        OGRE_CHECK_GL_ERROR(glTexParameteri(target, pname, param));
+    }
+
+    void GL3PlusStateCacheManager::setTexParameterf(GLenum target, GLenum pname, GLfloat param)
+    {
+        // Update GL
+        notifyIssued(SCC_SAMPLER);
+        OGRE_CHECK_GL_ERROR(glTexParameterf(target, pname, param));
+    }
+
+    bool GL3PlusStateCacheManager::activateGLTextureUnit(size_t unit)
+    {
+        if (unit < Root::getSingleton().getRenderSystem()->getCapabilities()->getNumTextureUnits())
+        {
+            notifyIssued(SCC_TEXTURE);
+            OGRE_CHECK_GL_ERROR(glActiveTexture(static_cast<uint32>(GL_TEXTURE0 + unit)));
+            mActiveTextureUnit = unit;
+            return true;
+        }
+        else if (!unit)
+        {
+            // Always OK to use the first unit.
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    void GL3PlusStateCacheManager::bindGLProgram(GLuint program)
+    {
+        notifyIssued(SCC_PROGRAM);
+        OGRE_CHECK_GL_ERROR(glUseProgram(program));
+    }
+
+    void GL3PlusStateCacheManager::bindGLProgramPipeline(GLuint pipeline)
+    {
+        notifyIssued(SCC_PROGRAM);
+        OGRE_CHECK_GL_ERROR(glBindProgramPipeline(pipeline));
+    }
+
+    void GL3PlusStateCacheManager::deleteGLProgramPipeline(GLuint pipeline)
+    {
+        if (pipeline == 0)
+            return;
+
+        OGRE_CHECK_GL_ERROR(glDeleteProgramPipelines(1, &pipeline));
+    }
+
+    void GL3PlusStateCacheManager::setBlendEquation(GLenum eq)
+    {
+        notifyIssued(SCC_BLEND);
+        OGRE_CHECK_GL_ERROR(glBlendEquation(eq));
+    }
+
+    void GL3PlusStateCacheManager::setBlendEquation(GLenum eqRGB, GLenum eqAlpha)
+    {
+        notifyIssued(SCC_BLEND);
+        OGRE_CHECK_GL_ERROR(glBlendEquationSeparate(eqRGB, eqAlpha));
+    }
+
+    void GL3PlusStateCacheManager::setBlendFunc(GLenum source, GLenum dest)
+    {
+        notifyIssued(SCC_BLEND);
+        OGRE_CHECK_GL_ERROR(glBlendFunc(source, dest));
+    }
+
+    void GL3PlusStateCacheManager::setBlendFunc(GLenum source, GLenum dest, GLenum sourceAlpha, GLenum destAlpha)
+    {
+        notifyIssued(SCC_BLEND);
+        OGRE_CHECK_GL_ERROR(glBlendFuncSeparate(source, dest, sourceAlpha, destAlpha));
+    }
+
+    void GL3PlusStateCacheManager::setDepthMask(GLboolean mask)
+    {
+        mDepthMask = mask;
+
+        notifyIssued(SCC_DEPTH);
+        OGRE_CHECK_GL_ERROR(glDepthMask(mask));
+    }
+
+    void GL3PlusStateCacheManager::setDepthFunc(GLenum func)
+    {
+        mDepthFunc = func;
+
+        notifyIssued(SCC_DEPTH);
+        OGRE_CHECK_GL_ERROR(glDepthFunc(func));
+    }
+
+    void GL3PlusStateCacheManager::setClearDepth(GLclampd depth)
+    {
+        mClearDepth = depth;
+
+        notifyIssued(SCC_DEPTH);
+        OGRE_CHECK_GL_ERROR(glClearDepth(depth));
+    }
+
+    void GL3PlusStateCacheManager::setPolygonOffset(GLfloat factor, GLfloat units)
+    {
+        notifyIssued(SCC_DEPTH);
+        OGRE_CHECK_GL_ERROR(glPolygonOffset(factor, units));
+    }
+
+    void GL3PlusStateCacheManager::setClearColour(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
+    {
+        mClearColour[0] = red;
+        mClearColour[1] = green;
+        mClearColour[2] = blue;
+        mClearColour[3] = alpha;
+
+        notifyIssued(SCC_BLEND);
+        OGRE_CHECK_GL_ERROR(glClearColor(mClearColour[0], mClearColour[1], mClearColour[2], mClearColour[3]));
+    }
+
+    void GL3PlusStateCacheManager::setColourMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+    {
+        mColourMask[0] = red;
+        mColourMask[1] = green;
+        mColourMask[2] = blue;
+        mColourMask[3] = alpha;
+
+        notifyIssued(SCC_BLEND);
+        OGRE_CHECK_GL_ERROR(glColorMask(mColourMask[0], mColourMask[1], mColourMask[2], mColourMask[3]));
+    }
+
+    void GL3PlusStateCacheManager::setStencilMask(GLuint mask, GLenum face)
+    {
+        notifyIssued(SCC_STENCIL);
+        OGRE_CHECK_GL_ERROR(glStencilMaskSeparate(face, mask));
+    }
+
+    void GL3PlusStateCacheManager::setStencilFunc(GLenum func, GLint ref, GLuint mask, GLenum face)
+    {
+        notifyIssued(SCC_STENCIL);
+        OGRE_CHECK_GL_ERROR(glStencilFuncSeparate(face, func, ref, mask));
+    }
+
+    void GL3PlusStateCacheManager::setStencilOp(GLenum stencilFail, GLenum depthFail, GLenum depthPass, GLenum face)
+    {
+        notifyIssued(SCC_STENCIL);
+        OGRE_CHECK_GL_ERROR(glStencilOpSeparate(face, stencilFail, depthFail, depthPass));
+    }
+
+    void GL3PlusStateCacheManager::setEnabled(GLenum flag, bool enabled)
+    {
+        notifyIssued(SCC_RASTER);
+        if (enabled)
+        {
+            OGRE_CHECK_GL_ERROR(glEnable(flag));
+        }
+        else
+        {
+            OGRE_CHECK_GL_ERROR(glDisable(flag));
+        }
+    }
+
+    void GL3PlusStateCacheManager::setPolygonMode(GLenum mode)
+    {
+        mPolygonMode = mode;
+
+        notifyIssued(SCC_RASTER);
+        OGRE_CHECK_GL_ERROR(glPolygonMode(GL_FRONT_AND_BACK, mode));
+    }
+
+    void GL3PlusStateCacheManager::setCullFace(GLenum face)
+    {
+        mCullFace = face;
+
+        notifyIssued(SCC_RASTER);
+        OGRE_CHECK_GL_ERROR(glCullFace(face));
+    }
+
+    void GL3PlusStateCacheManager::setViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        mViewport[0] = x;
+        mViewport[1] = y;
+        mViewport[2] = width;
+        mViewport[3] = height;
+
+        notifyIssued(SCC_VIEWPORT);
+        OGRE_CHECK_GL_ERROR(glViewport(x, y, width, height));
+    }
+
+    void GL3PlusStateCacheManager::setScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        mScissor[0] = x;
+        mScissor[1] = y;
+        mScissor[2] = width;
+        mScissor[3] = height;
+
+        notifyIssued(SCC_VIEWPORT);
+        OGRE_CHECK_GL_ERROR(glScissor(x, y, width, height));
+    }
+}
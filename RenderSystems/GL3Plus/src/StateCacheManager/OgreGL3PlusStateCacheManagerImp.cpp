@@ -0,0 +1,773 @@
+/*
+ -----------------------------------------------------------------------------
+ This source file is part of OGRE
+ (Object-oriented Graphics Rendering Engine)
+ For the latest info, see http://www.ogre3d.org/
+
+ Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ -----------------------------------------------------------------------------
+ */
+
+#include "OgreStableHeaders.h"
+#include "OgreGL3PlusStateCacheManager.h"
+#include "OgreGL3PlusRenderSystem.h"
+#include "OgreLogManager.h"
+#include "OgreRoot.h"
+
+namespace Ogre {
+
+    GL3PlusStateCacheManager::GL3PlusStateCacheManager(void)
+    {
+        clearCache();
+        resetStats();
+    }
+
+    GL3PlusStateCacheManager::~GL3PlusStateCacheManager(void)
+    {
+    }
+
+    void GL3PlusStateCacheManager::initializeCache()
+    {
+        OGRE_CHECK_GL_ERROR(glBlendEquation(GL_FUNC_ADD));
+
+        OGRE_CHECK_GL_ERROR(glBlendFunc(GL_ONE, GL_ZERO));
+
+        OGRE_CHECK_GL_ERROR(glCullFace(mCullFace));
+
+        OGRE_CHECK_GL_ERROR(glDepthFunc(mDepthFunc));
+
+        OGRE_CHECK_GL_ERROR(glDepthMask(mDepthMask));
+
+        OGRE_CHECK_GL_ERROR(glStencilMask(0xFFFFFFFF));
+
+        OGRE_CHECK_GL_ERROR(glStencilFunc(GL_ALWAYS, 0, 0xFFFFFFFF));
+
+        OGRE_CHECK_GL_ERROR(glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP));
+
+        OGRE_CHECK_GL_ERROR(glClearDepth(mClearDepth));
+
+        OGRE_CHECK_GL_ERROR(glPolygonMode(GL_FRONT_AND_BACK, mPolygonMode));
+
+        OGRE_CHECK_GL_ERROR(glPolygonOffset(mPolygonOffsetFactor, mPolygonOffsetUnits));
+
+        OGRE_CHECK_GL_ERROR(glBindVertexArray(0));
+
+        OGRE_CHECK_GL_ERROR(glBindBuffer(GL_ARRAY_BUFFER, 0));
+
+        OGRE_CHECK_GL_ERROR(glUseProgram(0));
+
+        OGRE_CHECK_GL_ERROR(glActiveTexture(GL_TEXTURE0));
+
+        OGRE_CHECK_GL_ERROR(glClearColor(mClearColour[0], mClearColour[1], mClearColour[2], mClearColour[3]));
+
+        OGRE_CHECK_GL_ERROR(glColorMask(mColourMask[0], mColourMask[1], mColourMask[2], mColourMask[3]));
+    }
+
+    void GL3PlusStateCacheManager::clearCache()
+    {
+        mDepthMask = GL_TRUE;
+        mPolygonMode = GL_FILL;
+        mBlendEquationRGB = GL_FUNC_ADD;
+        mBlendEquationAlpha = GL_FUNC_ADD;
+        mCullFace = GL_BACK;
+        mDepthFunc = GL_LESS;
+        mPolygonOffsetFactor = 0.0f;
+        mPolygonOffsetUnits = 0.0f;
+        mVertexArray = 0;
+        mProgram = 0;
+        mProgramPipeline = 0;
+        mActiveTextureUnit = 0;
+        mClearDepth = 1.0;
+
+        // Initialize our cache variables and also the GL so that the
+        // stored values match the GL state
+        mBlendFuncSource = GL_ONE;
+        mBlendFuncDest = GL_ZERO;
+        mBlendFuncSourceAlpha = GL_ONE;
+        mBlendFuncDestAlpha = GL_ZERO;
+
+        mClearColour[0] = mClearColour[1] = mClearColour[2] = mClearColour[3] = 0.0f;
+        mColourMask[0] = mColourMask[1] = mColourMask[2] = mColourMask[3] = GL_TRUE;
+
+        for (int i = 0; i < 2; ++i)
+        {
+            mStencilFaces[i].func = GL_ALWAYS;
+            mStencilFaces[i].ref = 0;
+            mStencilFaces[i].valueMask = 0xFFFFFFFF;
+            mStencilFaces[i].writeMask = 0xFFFFFFFF;
+            mStencilFaces[i].stencilFail = GL_KEEP;
+            mStencilFaces[i].depthFail = GL_KEEP;
+            mStencilFaces[i].depthPass = GL_KEEP;
+        }
+
+        // The viewport and scissor box depend on the drawable, a negative
+        // size makes sure the first call is never skipped
+        for (int i = 0; i < 4; ++i)
+        {
+            mViewport[i] = -1;
+            mScissor[i] = -1;
+        }
+
+        mActiveBufferMap.clear();
+        mTexUnitsMap.clear();
+        mBoundTextures.clear();
+        mBoolStateMap.clear();
+    }
+
+    void GL3PlusStateCacheManager::resetStats(void)
+    {
+        memset(&mStats, 0, sizeof(Stats));
+    }
+
+    void GL3PlusStateCacheManager::bindGLBuffer(GLenum target, GLuint buffer, bool force)
+    {
+        bool update = false;
+        BindBufferMap::iterator i = mActiveBufferMap.find(target);
+        if (i == mActiveBufferMap.end())
+        {
+            // Haven't cached this state yet.  Insert it into the map
+            mActiveBufferMap.insert(BindBufferMap::value_type(target, buffer));
+            update = true;
+        }
+        else if ((*i).second != buffer || force) // Update the cached value if needed
+        {
+            (*i).second = buffer;
+            update = true;
+        }
+
+        // Update GL
+        if (update)
+        {
+            notifyIssued(SCC_BUFFER);
+            if (target == GL_FRAMEBUFFER)
+            {
+                OGRE_CHECK_GL_ERROR(glBindFramebuffer(target, buffer));
+            }
+            else if (target == GL_RENDERBUFFER)
+            {
+                OGRE_CHECK_GL_ERROR(glBindRenderbuffer(target, buffer));
+            }
+            else
+            {
+                OGRE_CHECK_GL_ERROR(glBindBuffer(target, buffer));
+            }
+        }
+        else
+        {
+            notifyRedundant(SCC_BUFFER);
+        }
+    }
+
+    void GL3PlusStateCacheManager::bindGLBufferBase(GLenum target, GLuint index, GLuint buffer)
+    {
+        notifyIssued(SCC_BUFFER);
+        OGRE_CHECK_GL_ERROR(glBindBufferBase(target, index, buffer));
+        mActiveBufferMap[target] = buffer;
+    }
+
+    void GL3PlusStateCacheManager::deleteGLBuffer(GLenum target, GLuint buffer)
+    {
+        // Buffer name 0 is reserved and we should never try to delete it
+        if (buffer == 0)
+            return;
+
+        if (target == GL_FRAMEBUFFER)
+        {
+            OGRE_CHECK_GL_ERROR(glDeleteFramebuffers(1, &buffer));
+        }
+        else if (target == GL_RENDERBUFFER)
+        {
+            OGRE_CHECK_GL_ERROR(glDeleteRenderbuffers(1, &buffer));
+        }
+        else
+        {
+            OGRE_CHECK_GL_ERROR(glDeleteBuffers(1, &buffer));
+        }
+
+        // GL unbinds a deleted buffer from every target it is bound to,
+        // update the cached values to match
+        for (BindBufferMap::iterator i = mActiveBufferMap.begin(); i != mActiveBufferMap.end(); ++i)
+        {
+            if ((*i).second == buffer)
+                (*i).second = 0;
+        }
+    }
+
+    void GL3PlusStateCacheManager::bindGLVertexArray(GLuint vao)
+    {
+        if (mVertexArray != vao)
+        {
+            mVertexArray = vao;
+            notifyIssued(SCC_VERTEX_ARRAY);
+            OGRE_CHECK_GL_ERROR(glBindVertexArray(vao));
+
+            // The element array binding is part of the vertex array object state
+            mActiveBufferMap.erase(GL_ELEMENT_ARRAY_BUFFER);
+        }
+        else
+        {
+            notifyRedundant(SCC_VERTEX_ARRAY);
+        }
+    }
+
+    void GL3PlusStateCacheManager::deleteGLVertexArray(GLuint vao)
+    {
+        if (vao == 0)
+            return;
+
+        OGRE_CHECK_GL_ERROR(glDeleteVertexArrays(1, &vao));
+
+        if (mVertexArray == vao)
+        {
+            // Deleting the bound vertex array reverts to the default one
+            mVertexArray = 0;
+            mActiveBufferMap.erase(GL_ELEMENT_ARRAY_BUFFER);
+        }
+    }
+
+    void GL3PlusStateCacheManager::bindGLTexture(GLenum target, GLuint texture)
+    {
+        if (mBoundTextures.size() <= mActiveTextureUnit)
+        {
+            TextureBinding unknown = { 0, 0 };
+            mBoundTextures.resize(mActiveTextureUnit + 1, unknown);
+        }
+
+        TextureBinding& binding = mBoundTextures[mActiveTextureUnit];
+        if (binding.target == target && binding.texture == texture)
+        {
+            notifyRedundant(SCC_TEXTURE);
+            return;
+        }
+
+        binding.target = target;
+        binding.texture = texture;
+
+        // Update GL
+        notifyIssued(SCC_TEXTURE);
+        OGRE_CHECK_GL_ERROR(glBindTexture(target, texture));
+    }
+
+    void GL3PlusStateCacheManager::deleteGLTexture(GLuint texture)
+    {
+        if (texture == 0)
+            return;
+
+        OGRE_CHECK_GL_ERROR(glDeleteTextures(1, &texture));
+        invalidateStateForTexture(texture);
+    }
+
+    void GL3PlusStateCacheManager::invalidateStateForTexture(GLuint texture)
+    {
+        mTexUnitsMap.erase(texture);
+
+        // Names are reused, so do not keep units pointing at a deleted texture
+        for (size_t i = 0; i < mBoundTextures.size(); ++i)
+        {
+            if (mBoundTextures[i].texture == texture)
+                mBoundTextures[i].texture = 0;
+        }
+    }
+
+    void GL3PlusStateCacheManager::setTexParameteri(GLenum target, GLenum pname, GLint param)
+    {
+        // Parameters belong to the texture object, only cache them when we
+        // know which texture they end up on
+        if (mBoundTextures.size() <= mActiveTextureUnit ||
+            mBoundTextures[mActiveTextureUnit].target != target ||
+            mBoundTextures[mActiveTextureUnit].texture == 0)
+        {
+            notifyIssued(SCC_SAMPLER);
+            OGRE_CHECK_GL_ERROR(glTexParameteri(target, pname, param));
+            return;
+        }
+
+        TexParameteriMap& myMap = mTexUnitsMap[mBoundTextures[mActiveTextureUnit].texture].mTexParameteriMap;
+        TexParameteriMap::iterator i = myMap.find(pname);
+
+        if (i == myMap.end())
+        {
+            // Haven't cached this state yet.  Insert it into the map
+            myMap.insert(TexParameteriMap::value_type(pname, param));
+        }
+        else if ((*i).second != param)
+        {
+            // Update the cached value if needed
+            (*i).second = param;
+        }
+        else
+        {
+            notifyRedundant(SCC_SAMPLER);
+            return;
+        }
+
+        // Update GL
+        notifyIssued(SCC_SAMPLER);
+        OGRE_CHECK_GL_ERROR(glTexParameteri(target, pname, param));
+    }
+
+    void GL3PlusStateCacheManager::setTexParameterf(GLenum target, GLenum pname, GLfloat param)
+    {
+        if (mBoundTextures.size() <= mActiveTextureUnit ||
+            mBoundTextures[mActiveTextureUnit].target != target ||
+            mBoundTextures[mActiveTextureUnit].texture == 0)
+        {
+            notifyIssued(SCC_SAMPLER);
+            OGRE_CHECK_GL_ERROR(glTexParameterf(target, pname, param));
+            return;
+        }
+
+        TexParameterfMap& myMap = mTexUnitsMap[mBoundTextures[mActiveTextureUnit].texture].mTexParameterfMap;
+        TexParameterfMap::iterator i = myMap.find(pname);
+
+        if (i == myMap.end())
+        {
+            // Haven't cached this state yet.  Insert it into the map
+            myMap.insert(TexParameterfMap::value_type(pname, param));
+        }
+        else if ((*i).second != param)
+        {
+            // Update the cached value if needed
+            (*i).second = param;
+        }
+        else
+        {
+            notifyRedundant(SCC_SAMPLER);
+            return;
+        }
+
+        // Update GL
+        notifyIssued(SCC_SAMPLER);
+        OGRE_CHECK_GL_ERROR(glTexParameterf(target, pname, param));
+    }
+
+    bool GL3PlusStateCacheManager::activateGLTextureUnit(size_t unit)
+    {
+        if (mActiveTextureUnit == unit)
+        {
+            notifyRedundant(SCC_TEXTURE);
+            return true;
+        }
+
+        if (unit < Root::getSingleton().getRenderSystem()->getCapabilities()->getNumTextureUnits())
+        {
+            notifyIssued(SCC_TEXTURE);
+            OGRE_CHECK_GL_ERROR(glActiveTexture(static_cast<uint32>(GL_TEXTURE0 + unit)));
+            mActiveTextureUnit = unit;
+            return true;
+        }
+        else if (!unit)
+        {
+            // Always OK to use the first unit.
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    void GL3PlusStateCacheManager::bindGLProgram(GLuint program)
+    {
+        if (mProgram != program)
+        {
+            mProgram = program;
+            notifyIssued(SCC_PROGRAM);
+            OGRE_CHECK_GL_ERROR(glUseProgram(program));
+        }
+        else
+        {
+            notifyRedundant(SCC_PROGRAM);
+        }
+    }
+
+    void GL3PlusStateCacheManager::bindGLProgramPipeline(GLuint pipeline)
+    {
+        if (mProgramPipeline != pipeline)
+        {
+            mProgramPipeline = pipeline;
+            notifyIssued(SCC_PROGRAM);
+            OGRE_CHECK_GL_ERROR(glBindProgramPipeline(pipeline));
+        }
+        else
+        {
+            notifyRedundant(SCC_PROGRAM);
+        }
+    }
+
+    void GL3PlusStateCacheManager::deleteGLProgramPipeline(GLuint pipeline)
+    {
+        if (pipeline == 0)
+            return;
+
+        OGRE_CHECK_GL_ERROR(glDeleteProgramPipelines(1, &pipeline));
+
+        // Deleting the bound pipeline reverts the binding to zero
+        if (mProgramPipeline == pipeline)
+            mProgramPipeline = 0;
+    }
+
+    void GL3PlusStateCacheManager::setBlendEquation(GLenum eq)
+    {
+        if (mBlendEquationRGB != eq || mBlendEquationAlpha != eq)
+        {
+            mBlendEquationRGB = eq;
+            mBlendEquationAlpha = eq;
+
+            notifyIssued(SCC_BLEND);
+            OGRE_CHECK_GL_ERROR(glBlendEquation(eq));
+        }
+        else
+        {
+            notifyRedundant(SCC_BLEND);
+        }
+    }
+
+    void GL3PlusStateCacheManager::setBlendEquation(GLenum eqRGB, GLenum eqAlpha)
+    {
+        if (mBlendEquationRGB != eqRGB || mBlendEquationAlpha != eqAlpha)
+        {
+            mBlendEquationRGB = eqRGB;
+            mBlendEquationAlpha = eqAlpha;
+
+            notifyIssued(SCC_BLEND);
+            OGRE_CHECK_GL_ERROR(glBlendEquationSeparate(eqRGB, eqAlpha));
+        }
+        else
+        {
+            notifyRedundant(SCC_BLEND);
+        }
+    }
+
+    void GL3PlusStateCacheManager::setBlendFunc(GLenum source, GLenum dest)
+    {
+        if (mBlendFuncSource != source || mBlendFuncDest != dest ||
+            mBlendFuncSourceAlpha != source || mBlendFuncDestAlpha != dest)
+        {
+            mBlendFuncSource = source;
+            mBlendFuncDest = dest;
+            mBlendFuncSourceAlpha = source;
+            mBlendFuncDestAlpha = dest;
+
+            notifyIssued(SCC_BLEND);
+            OGRE_CHECK_GL_ERROR(glBlendFunc(source, dest));
+        }
+        else
+        {
+            notifyRedundant(SCC_BLEND);
+        }
+    }
+
+    void GL3PlusStateCacheManager::setBlendFunc(GLenum source, GLenum dest, GLenum sourceAlpha, GLenum destAlpha)
+    {
+        if (mBlendFuncSource != source || mBlendFuncDest != dest ||
+            mBlendFuncSourceAlpha != sourceAlpha || mBlendFuncDestAlpha != destAlpha)
+        {
+            mBlendFuncSource = source;
+            mBlendFuncDest = dest;
+            mBlendFuncSourceAlpha = sourceAlpha;
+            mBlendFuncDestAlpha = destAlpha;
+
+            notifyIssued(SCC_BLEND);
+            OGRE_CHECK_GL_ERROR(glBlendFuncSeparate(source, dest, sourceAlpha, destAlpha));
+        }
+        else
+        {
+            notifyRedundant(SCC_BLEND);
+        }
+    }
+
+    void GL3PlusStateCacheManager::setDepthMask(GLboolean mask)
+    {
+        if (mDepthMask != mask)
+        {
+            mDepthMask = mask;
+
+            notifyIssued(SCC_DEPTH);
+            OGRE_CHECK_GL_ERROR(glDepthMask(mask));
+        }
+        else
+        {
+            notifyRedundant(SCC_DEPTH);
+        }
+    }
+
+    void GL3PlusStateCacheManager::setDepthFunc(GLenum func)
+    {
+        if (mDepthFunc != func)
+        {
+            mDepthFunc = func;
+
+            notifyIssued(SCC_DEPTH);
+            OGRE_CHECK_GL_ERROR(glDepthFunc(func));
+        }
+        else
+        {
+            notifyRedundant(SCC_DEPTH);
+        }
+    }
+
+    void GL3PlusStateCacheManager::setClearDepth(GLclampd depth)
+    {
+        if (mClearDepth != depth)
+        {
+            mClearDepth = depth;
+
+            notifyIssued(SCC_DEPTH);
+            OGRE_CHECK_GL_ERROR(glClearDepth(depth));
+        }
+        else
+        {
+            notifyRedundant(SCC_DEPTH);
+        }
+    }
+
+    void GL3PlusStateCacheManager::setPolygonOffset(GLfloat factor, GLfloat units)
+    {
+        if (mPolygonOffsetFactor != factor || mPolygonOffsetUnits != units)
+        {
+            mPolygonOffsetFactor = factor;
+            mPolygonOffsetUnits = units;
+
+            notifyIssued(SCC_DEPTH);
+            OGRE_CHECK_GL_ERROR(glPolygonOffset(factor, units));
+        }
+        else
+        {
+            notifyRedundant(SCC_DEPTH);
+        }
+    }
+
+    void GL3PlusStateCacheManager::setClearColour(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
+    {
+        if ((mClearColour[0] != red) ||
+            (mClearColour[1] != green) ||
+            (mClearColour[2] != blue) ||
+            (mClearColour[3] != alpha))
+        {
+            mClearColour[0] = red;
+            mClearColour[1] = green;
+            mClearColour[2] = blue;
+            mClearColour[3] = alpha;
+
+            notifyIssued(SCC_BLEND);
+            OGRE_CHECK_GL_ERROR(glClearColor(mClearColour[0], mClearColour[1], mClearColour[2], mClearColour[3]));
+        }
+        else
+        {
+            notifyRedundant(SCC_BLEND);
+        }
+    }
+
+    void GL3PlusStateCacheManager::setColourMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+    {
+        if ((mColourMask[0] != red) ||
+            (mColourMask[1] != green) ||
+            (mColourMask[2] != blue) ||
+            (mColourMask[3] != alpha))
+        {
+            mColourMask[0] = red;
+            mColourMask[1] = green;
+            mColourMask[2] = blue;
+            mColourMask[3] = alpha;
+
+            notifyIssued(SCC_BLEND);
+            OGRE_CHECK_GL_ERROR(glColorMask(mColourMask[0], mColourMask[1], mColourMask[2], mColourMask[3]));
+        }
+        else
+        {
+            notifyRedundant(SCC_BLEND);
+        }
+    }
+
+    void GL3PlusStateCacheManager::setStencilMask(GLuint mask, GLenum face)
+    {
+        bool front = face != GL_BACK;
+        bool back = face != GL_FRONT;
+        if ((front && mStencilFaces[0].writeMask != mask) ||
+            (back && mStencilFaces[1].writeMask != mask))
+        {
+            if (front)
+                mStencilFaces[0].writeMask = mask;
+            if (back)
+                mStencilFaces[1].writeMask = mask;
+
+            notifyIssued(SCC_STENCIL);
+            OGRE_CHECK_GL_ERROR(glStencilMaskSeparate(face, mask));
+        }
+        else
+        {
+            notifyRedundant(SCC_STENCIL);
+        }
+    }
+
+    void GL3PlusStateCacheManager::setStencilFunc(GLenum func, GLint ref, GLuint mask, GLenum face)
+    {
+        bool front = face != GL_BACK;
+        bool back = face != GL_FRONT;
+        bool changed = false;
+        for (int i = 0; i < 2; ++i)
+        {
+            if ((i == 0 && !front) || (i == 1 && !back))
+                continue;
+
+            StencilFaceState& state = mStencilFaces[i];
+            if (state.func != func || state.ref != ref || state.valueMask != mask)
+            {
+                state.func = func;
+                state.ref = ref;
+                state.valueMask = mask;
+                changed = true;
+            }
+        }
+
+        if (changed)
+        {
+            notifyIssued(SCC_STENCIL);
+            OGRE_CHECK_GL_ERROR(glStencilFuncSeparate(face, func, ref, mask));
+        }
+        else
+        {
+            notifyRedundant(SCC_STENCIL);
+        }
+    }
+
+    void GL3PlusStateCacheManager::setStencilOp(GLenum stencilFail, GLenum depthFail, GLenum depthPass, GLenum face)
+    {
+        bool front = face != GL_BACK;
+        bool back = face != GL_FRONT;
+        bool changed = false;
+        for (int i = 0; i < 2; ++i)
+        {
+            if ((i == 0 && !front) || (i == 1 && !back))
+                continue;
+
+            StencilFaceState& state = mStencilFaces[i];
+            if (state.stencilFail != stencilFail || state.depthFail != depthFail || state.depthPass != depthPass)
+            {
+                state.stencilFail = stencilFail;
+                state.depthFail = depthFail;
+                state.depthPass = depthPass;
+                changed = true;
+            }
+        }
+
+        if (changed)
+        {
+            notifyIssued(SCC_STENCIL);
+            OGRE_CHECK_GL_ERROR(glStencilOpSeparate(face, stencilFail, depthFail, depthPass));
+        }
+        else
+        {
+            notifyRedundant(SCC_STENCIL);
+        }
+    }
+
+    void GL3PlusStateCacheManager::setEnabled(GLenum flag, bool enabled)
+    {
+        GLbooleanStateMap::iterator it = mBoolStateMap.find(flag);
+        if (it != mBoolStateMap.end() && it->second == enabled)
+        {
+            notifyRedundant(SCC_RASTER);
+            return;
+        }
+
+        mBoolStateMap[flag] = enabled;
+
+        notifyIssued(SCC_RASTER);
+        if (enabled)
+        {
+            OGRE_CHECK_GL_ERROR(glEnable(flag));
+        }
+        else
+        {
+            OGRE_CHECK_GL_ERROR(glDisable(flag));
+        }
+    }
+
+    void GL3PlusStateCacheManager::setPolygonMode(GLenum mode)
+    {
+        if (mPolygonMode != mode)
+        {
+            mPolygonMode = mode;
+
+            notifyIssued(SCC_RASTER);
+            OGRE_CHECK_GL_ERROR(glPolygonMode(GL_FRONT_AND_BACK, mode));
+        }
+        else
+        {
+            notifyRedundant(SCC_RASTER);
+        }
+    }
+
+    void GL3PlusStateCacheManager::setCullFace(GLenum face)
+    {
+        if (mCullFace != face)
+        {
+            mCullFace = face;
+
+            notifyIssued(SCC_RASTER);
+            OGRE_CHECK_GL_ERROR(glCullFace(face));
+        }
+        else
+        {
+            notifyRedundant(SCC_RASTER);
+        }
+    }
+
+    void GL3PlusStateCacheManager::setViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        if (mViewport[0] != x || mViewport[1] != y ||
+            mViewport[2] != width || mViewport[3] != height)
+        {
+            mViewport[0] = x;
+            mViewport[1] = y;
+            mViewport[2] = width;
+            mViewport[3] = height;
+
+            notifyIssued(SCC_VIEWPORT);
+            OGRE_CHECK_GL_ERROR(glViewport(x, y, width, height));
+        }
+        else
+        {
+            notifyRedundant(SCC_VIEWPORT);
+        }
+    }
+
+    void GL3PlusStateCacheManager::setScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        if (mScissor[0] != x || mScissor[1] != y ||
+            mScissor[2] != width || mScissor[3] != height)
+        {
+            mScissor[0] = x;
+            mScissor[1] = y;
+            mScissor[2] = width;
+            mScissor[3] = height;
+
+            notifyIssued(SCC_VIEWPORT);
+            OGRE_CHECK_GL_ERROR(glScissor(x, y, width, height));
+        }
+        else
+        {
+            notifyRedundant(SCC_VIEWPORT);
+        }
+    }
+}
@@ -46,6 +46,16 @@ struct GLUniformReference
     GpuProgramType mSourceProgType;
     /// The constant definition it relates to
     const GpuConstantDefinition* mConstantDef;
+    /// The parameters the value was last uploaded from
+    const GpuProgramParameters* mLastParams;
+    /// Index of the auto constant behind the value in mLastParams, if there is one
+    size_t mAutoConstantIndex;
+    /// Update stamp of that auto constant when the value was last uploaded
+    uint64 mLastStamp;
+
+    GLUniformReference()
+        : mLocation(-1), mSourceProgType(GPT_VERTEX_PROGRAM), mConstantDef(0), mLastParams(0)
+        , mAutoConstantIndex(std::numeric_limits<size_t>::max()), mLastStamp(0) {}
 };
 typedef vector<GLUniformReference>::type GLUniformReferenceList;
 typedef GLUniformReferenceList::iterator GLUniformReferenceIterator;
@@ -141,6 +151,17 @@ protected:
 
     VertexElementSemantic getAttributeSemanticEnum(String type);
     const char * getAttributeSemanticString(VertexElementSemantic semantic);
+
+    /** Checks whether a uniform still holds the value of an auto constant.
+        @remarks
+            This is the case if it was last uploaded from the same parameters and the
+            auto constant was not written since, see GpuProgramParameters::_updateAutoParams.
+            Uniforms not backed by an auto constant are never up to date. If the uniform is
+            not up to date it is assumed the caller uploads it right away.
+    */
+    static bool isUniformUpToDate(GLUniformReference& ref, const GpuProgramParameters* params);
+    /// Gets the number of bytes uploaded for a uniform
+    static size_t getUniformBytes(const GpuConstantDefinition* def);
 };
 
 } /* namespace Ogre */
@@ -66,6 +66,54 @@ const char* GLSLProgramCommon::getAttributeSemanticString(VertexElementSemantic
     return 0;
 }
 
+bool GLSLProgramCommon::isUniformUpToDate(GLUniformReference& ref, const GpuProgramParameters* params)
+{
+    const GpuProgramParameters::AutoConstantList& autos = params->getAutoConstantList();
+    const GpuConstantDefinition* def = ref.mConstantDef;
+    const size_t noAuto = std::numeric_limits<size_t>::max();
+
+    bool resolve = ref.mLastParams != params;
+    if (!resolve && ref.mAutoConstantIndex != noAuto)
+    {
+        // The auto constants may have been changed since
+        resolve = ref.mAutoConstantIndex >= autos.size() ||
+            autos[ref.mAutoConstantIndex].physicalIndex != def->physicalIndex;
+    }
+
+    if (resolve)
+    {
+        ref.mLastParams = params;
+        ref.mAutoConstantIndex = noAuto;
+        // Autos are always floating point
+        if (def->isFloat())
+        {
+            for (size_t i = 0; i < autos.size(); ++i)
+            {
+                if (autos[i].physicalIndex == def->physicalIndex)
+                {
+                    ref.mAutoConstantIndex = i;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (ref.mAutoConstantIndex == noAuto)
+        return false;
+
+    uint64 stamp = autos[ref.mAutoConstantIndex].updateStamp;
+    if (!resolve && stamp && stamp == ref.mLastStamp)
+        return true;
+
+    ref.mLastStamp = stamp;
+    return false;
+}
+
+size_t GLSLProgramCommon::getUniformBytes(const GpuConstantDefinition* def)
+{
+    return def->elementSize * def->arraySize * (def->isDouble() ? sizeof(double) : sizeof(float));
+}
+
 void GLSLProgramCommon::extractLayoutQualifiers(void)
 {
     // Format is:
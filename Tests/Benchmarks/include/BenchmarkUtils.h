@@ -0,0 +1,70 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef TESTS_BENCHMARKS_INCLUDE_BENCHMARKUTILS_H_
+#define TESTS_BENCHMARKS_INCLUDE_BENCHMARKUTILS_H_
+
+#include "OgreRenderable.h"
+#include "OgreCamera.h"
+#include "OgreMatrix4.h"
+
+/// Deterministic random numbers in [-1, 1], so every run sees the same data
+inline float benchmarkRandom(Ogre::uint32& seed)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return (float)(seed >> 8) / (float)(1 << 24) * 2.0f - 1.0f;
+}
+
+/// Renderable which is only ever queued and sorted, never drawn
+class BenchmarkRenderable : public Ogre::Renderable
+{
+public:
+    BenchmarkRenderable(const Ogre::MaterialPtr& material, const Ogre::Vector3& position)
+        : mMaterial(material), mPosition(position)
+    {
+        mTransform.makeTrans(position);
+    }
+
+    const Ogre::MaterialPtr& getMaterial(void) const { return mMaterial; }
+    void getRenderOperation(Ogre::RenderOperation& op) {}
+    void getWorldTransforms(Ogre::Matrix4* xform) const { *xform = mTransform; }
+    Ogre::Real getSquaredViewDepth(const Ogre::Camera* cam) const
+    {
+        return mPosition.squaredDistance(cam->getDerivedPosition());
+    }
+    const Ogre::LightList& getLights(void) const { return mLights; }
+
+    void setLights(const Ogre::LightList& lights) { mLights = lights; }
+
+private:
+    Ogre::MaterialPtr mMaterial;
+    Ogre::Vector3 mPosition;
+    Ogre::Matrix4 mTransform;
+    Ogre::LightList mLights;
+};
+
+#endif /* TESTS_BENCHMARKS_INCLUDE_BENCHMARKUTILS_H_ */
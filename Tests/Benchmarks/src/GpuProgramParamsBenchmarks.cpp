@@ -0,0 +1,140 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <benchmark/benchmark.h>
+
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneNode.h"
+#include "OgreLight.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgreGpuProgramParams.h"
+#include "OgreAutoParamDataSource.h"
+#include "BenchmarkUtils.h"
+
+using namespace Ogre;
+
+namespace {
+    struct AutoConstant
+    {
+        const char* name;
+        GpuConstantType type;
+        GpuProgramParameters::AutoConstantType acType;
+    };
+
+    /// What a typical per pixel lit vertex/fragment program pair binds
+    const AutoConstant autoConstants[] = {
+        { "world", GCT_MATRIX_4X4, GpuProgramParameters::ACT_WORLD_MATRIX },
+        { "worldView", GCT_MATRIX_4X4, GpuProgramParameters::ACT_WORLDVIEW_MATRIX },
+        { "worldViewProj", GCT_MATRIX_4X4, GpuProgramParameters::ACT_WORLDVIEWPROJ_MATRIX },
+        { "inverseTransposeWorld", GCT_MATRIX_4X4, GpuProgramParameters::ACT_INVERSE_TRANSPOSE_WORLD_MATRIX },
+        { "viewProj", GCT_MATRIX_4X4, GpuProgramParameters::ACT_VIEWPROJ_MATRIX },
+        { "cameraPosition", GCT_FLOAT4, GpuProgramParameters::ACT_CAMERA_POSITION_OBJECT_SPACE },
+        { "lightPosition", GCT_FLOAT4, GpuProgramParameters::ACT_LIGHT_POSITION_OBJECT_SPACE },
+        { "lightDiffuse", GCT_FLOAT4, GpuProgramParameters::ACT_LIGHT_DIFFUSE_COLOUR },
+        { "ambient", GCT_FLOAT4, GpuProgramParameters::ACT_AMBIENT_LIGHT_COLOUR },
+        { "surfaceDiffuse", GCT_FLOAT4, GpuProgramParameters::ACT_SURFACE_DIFFUSE_COLOUR }
+    };
+    const size_t numAutoConstants = sizeof(autoConstants) / sizeof(autoConstants[0]);
+
+    GpuProgramParametersSharedPtr createAutoParams()
+    {
+        GpuNamedConstantsPtr namedConstants(OGRE_NEW GpuNamedConstants);
+        for (size_t i = 0; i < numAutoConstants; ++i)
+        {
+            GpuConstantDefinition def;
+            def.constType = autoConstants[i].type;
+            def.elementSize = GpuConstantDefinition::getElementSize(def.constType, false);
+            def.arraySize = 1;
+            def.physicalIndex = namedConstants->floatBufferSize;
+            def.logicalIndex = i;
+            namedConstants->map[autoConstants[i].name] = def;
+            namedConstants->floatBufferSize += def.elementSize;
+        }
+
+        GpuProgramParametersSharedPtr params(OGRE_NEW GpuProgramParameters);
+        params->_setNamedConstants(namedConstants);
+        for (size_t i = 0; i < numAutoConstants; ++i)
+            params->setNamedAutoConstant(autoConstants[i].name, autoConstants[i].acType);
+        return params;
+    }
+}
+
+//--------------------------------------------------------------------------
+static void updateAutoParams(benchmark::State& state, bool newRenderable)
+{
+    const uint16 variability = (uint16)state.range(0);
+
+    SceneManager* sceneMgr = Root::getSingleton().createSceneManager(ST_GENERIC);
+    Camera* camera = sceneMgr->createCamera("BenchmarkCamera");
+    camera->setPosition(Vector3(0, 50, 500));
+    camera->lookAt(Vector3::ZERO);
+
+    Light* light = sceneMgr->createLight("BenchmarkLight");
+    sceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(100, 200, 0))->attachObject(light);
+    LightList lights;
+    lights.push_back(light);
+
+    MaterialPtr material = MaterialManager::getSingleton().getByName("BaseWhite");
+    BenchmarkRenderable renderable(material, Vector3(10, 0, -20));
+    renderable.setLights(lights);
+
+    AutoParamDataSource source;
+    source.setCurrentSceneManager(sceneMgr);
+    source.setCurrentCamera(camera, false);
+    source.setCurrentLightList(&lights);
+    source.setCurrentPass(material->getTechnique(0)->getPass(0));
+    source.setAmbientLightColour(ColourValue(0.2f, 0.2f, 0.2f));
+
+    GpuProgramParametersSharedPtr params = createAutoParams();
+    source.setCurrentRenderable(&renderable);
+    params->_updateAutoParams(&source, variability);
+    while (state.KeepRunning())
+    {
+        // A new renderable invalidates all the cached derived matrices
+        if (newRenderable)
+            source.setCurrentRenderable(&renderable);
+        params->_updateAutoParams(&source, variability);
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    Root::getSingleton().destroySceneManager(sceneMgr);
+}
+//--------------------------------------------------------------------------
+static void BM_UpdateAutoParams(benchmark::State& state)
+{
+    updateAutoParams(state, true);
+}
+BENCHMARK(BM_UpdateAutoParams)->Arg(GPV_PER_OBJECT)->Arg(GPV_ALL);
+//--------------------------------------------------------------------------
+static void BM_UpdateAutoParamsUnchanged(benchmark::State& state)
+{
+    // Binding the same parameters again without any source data changing
+    updateAutoParams(state, false);
+}
+BENCHMARK(BM_UpdateAutoParamsUnchanged)->Arg(GPV_PER_OBJECT)->Arg(GPV_ALL);
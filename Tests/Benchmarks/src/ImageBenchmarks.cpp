@@ -0,0 +1,159 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <benchmark/benchmark.h>
+
+#include "OgreImage.h"
+#include "OgrePixelFormat.h"
+#include "OgreBitwise.h"
+#include "BenchmarkUtils.h"
+
+using namespace Ogre;
+
+namespace {
+    /// Random pixel data, kept in [0, 1] for floating point formats
+    void fillPixels(vector<uchar>::type& data, PixelFormat format, uint32& seed)
+    {
+        if (format == PF_FLOAT16_RGB || format == PF_FLOAT16_RGBA)
+        {
+            uint16* values = reinterpret_cast<uint16*>(&data[0]);
+            for (size_t i = 0; i < data.size() / sizeof(uint16); ++i)
+                values[i] = Bitwise::floatToHalf(benchmarkRandom(seed) * 0.5f + 0.5f);
+        }
+        else if (PixelUtil::isFloatingPoint(format))
+        {
+            float* values = reinterpret_cast<float*>(&data[0]);
+            for (size_t i = 0; i < data.size() / sizeof(float); ++i)
+                values[i] = benchmarkRandom(seed) * 0.5f + 0.5f;
+        }
+        else
+        {
+            for (size_t i = 0; i < data.size(); ++i)
+                data[i] = (uchar)(benchmarkRandom(seed) * 127.5f + 127.5f);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------
+static void BM_ImageScale(benchmark::State& state)
+{
+    const PixelFormat format = (PixelFormat)state.range(0);
+    const Image::Filter filter = (Image::Filter)state.range(1);
+    PixelUtil::setNumWorkerThreads(state.range(2));
+    // Not an integer ratio, so the filters have to interpolate
+    const uint32 srcSize = 1024, dstSize = 700;
+    uint32 seed = 4;
+
+    vector<uchar>::type src(PixelUtil::getMemorySize(srcSize, srcSize, 1, format));
+    vector<uchar>::type dst(PixelUtil::getMemorySize(dstSize, dstSize, 1, format));
+    fillPixels(src, format, seed);
+    PixelBox srcBox(srcSize, srcSize, 1, format, &src[0]);
+    PixelBox dstBox(dstSize, dstSize, 1, format, &dst[0]);
+
+    while (state.KeepRunning())
+        Image::scale(srcBox, dstBox, filter);
+    PixelUtil::setNumWorkerThreads(0);
+    state.SetItemsProcessed(state.iterations() * dstSize * dstSize);
+    state.SetLabel(PixelUtil::getFormatName(format));
+}
+// Items are destination pixels; the last argument is PixelUtil's worker thread count
+BENCHMARK(BM_ImageScale)
+    ->Args({PF_A8R8G8B8, Image::FILTER_NEAREST, 0})
+    ->Args({PF_A8R8G8B8, Image::FILTER_BILINEAR, 0})
+    ->Args({PF_A8R8G8B8, Image::FILTER_BILINEAR, 4})
+    ->Args({PF_R8G8B8, Image::FILTER_BILINEAR, 0})
+    ->Args({PF_R5G6B5, Image::FILTER_BILINEAR, 0})
+    ->Args({PF_FLOAT32_RGBA, Image::FILTER_BILINEAR, 0})
+    ->Unit(benchmark::kMicrosecond)->UseRealTime();
+//--------------------------------------------------------------------------
+static void BM_BulkPixelConversion(benchmark::State& state)
+{
+    const PixelFormat srcFormat = (PixelFormat)state.range(0);
+    const PixelFormat dstFormat = (PixelFormat)state.range(1);
+    PixelUtil::setNumWorkerThreads(state.range(2));
+    // Large enough to be split up between threads
+    const uint32 size = 1024;
+    uint32 seed = 5;
+
+    vector<uchar>::type src(PixelUtil::getMemorySize(size, size, 1, srcFormat));
+    vector<uchar>::type dst(PixelUtil::getMemorySize(size, size, 1, dstFormat));
+    fillPixels(src, srcFormat, seed);
+    PixelBox srcBox(size, size, 1, srcFormat, &src[0]);
+    PixelBox dstBox(size, size, 1, dstFormat, &dst[0]);
+
+    while (state.KeepRunning())
+        PixelUtil::bulkPixelConversion(srcBox, dstBox);
+    PixelUtil::setNumWorkerThreads(0);
+    state.SetItemsProcessed(state.iterations() * size * size);
+    state.SetBytesProcessed(state.iterations() * src.size());
+    state.SetLabel(PixelUtil::getFormatName(srcFormat) + " -> " + PixelUtil::getFormatName(dstFormat));
+}
+// Conversions with an optimised path first, then ones going through unpackColour/packColour.
+// Items are pixels; the last argument is PixelUtil's worker thread count
+BENCHMARK(BM_BulkPixelConversion)
+    ->Args({PF_A8R8G8B8, PF_A8B8G8R8, 0})
+    ->Args({PF_R8G8B8A8, PF_B8G8R8A8, 0})
+    ->Args({PF_R8G8B8, PF_A8R8G8B8, 0})
+    ->Args({PF_B8G8R8, PF_R8G8B8A8, 0})
+    ->Args({PF_FLOAT32_RGBA, PF_FLOAT16_RGBA, 0})
+    ->Args({PF_FLOAT16_RGBA, PF_FLOAT32_RGBA, 0})
+    ->Args({PF_A8R8G8B8, PF_R5G6B5, 0})
+    ->Args({PF_A8R8G8B8, PF_R5G6B5, 4})
+    ->Args({PF_A8R8G8B8, PF_FLOAT32_RGBA, 0})
+    ->Args({PF_A8R8G8B8, PF_FLOAT32_RGBA, 4})
+    ->Args({PF_FLOAT32_RGB, PF_R8G8B8, 0})
+    ->Unit(benchmark::kMicrosecond)->UseRealTime();
+//--------------------------------------------------------------------------
+static void BM_ImageGenerateMipmaps(benchmark::State& state)
+{
+    const PixelFormat format = (PixelFormat)state.range(0);
+    const bool gammaCorrected = state.range(1) != 0;
+    PixelUtil::setNumWorkerThreads(state.range(2));
+    const uint32 size = 2048;
+    uint32 seed = 6;
+
+    vector<uchar>::type src(PixelUtil::getMemorySize(size, size, 1, format));
+    fillPixels(src, format, seed);
+    Image image;
+
+    while (state.KeepRunning())
+    {
+        image.loadDynamicImage(&src[0], size, size, 1, format);
+        image.generateMipmaps(gammaCorrected);
+    }
+    PixelUtil::setNumWorkerThreads(0);
+    state.SetItemsProcessed(state.iterations() * size * size);
+    state.SetLabel(PixelUtil::getFormatName(format) + (gammaCorrected ? " gamma corrected" : ""));
+}
+// Items are top level pixels; the last argument is PixelUtil's worker thread count
+BENCHMARK(BM_ImageGenerateMipmaps)
+    ->Args({PF_A8R8G8B8, 0, 0})
+    ->Args({PF_A8R8G8B8, 0, 4})
+    ->Args({PF_A8R8G8B8, 1, 0})
+    ->Args({PF_R8G8B8, 0, 0})
+    ->Args({PF_FLOAT32_RGBA, 0, 0})
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,101 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <benchmark/benchmark.h>
+
+#include "OgreMesh.h"
+#include "OgreMeshManager.h"
+#include "OgreMeshSerializer.h"
+#include "OgreSubMesh.h"
+#include "OgreHardwareBufferManager.h"
+#include "OgreDataStream.h"
+#include "OgreStringConverter.h"
+
+using namespace Ogre;
+
+namespace {
+    size_t getBufferSizes(const VertexData* vertexData)
+    {
+        size_t size = 0;
+        const VertexBufferBinding::VertexBufferBindingMap& bindings =
+            vertexData->vertexBufferBinding->getBindings();
+        VertexBufferBinding::VertexBufferBindingMap::const_iterator i;
+        for (i = bindings.begin(); i != bindings.end(); ++i)
+            size += i->second->getSizeInBytes();
+        return size;
+    }
+}
+
+//--------------------------------------------------------------------------
+static void BM_MeshSerializerImport(benchmark::State& state)
+{
+    const int segments = (int)state.range(0);
+    const String& group = ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME;
+
+    MeshPtr mesh = MeshManager::getSingleton().createPlane(
+        "Benchmark/Plane" + StringConverter::toString(segments), group,
+        Plane(Vector3::UNIT_Y, 0), 1000, 1000, segments, segments, true, 2, 1, 1, Vector3::UNIT_Z);
+    mesh->buildEdgeList();
+
+    // Buffers, plus edge list entries which are well under 128 bytes per triangle
+    size_t capacity = 64 * 1024 + getBufferSizes(mesh->sharedVertexData);
+    for (unsigned short i = 0; i < mesh->getNumSubMeshes(); ++i)
+    {
+        const IndexData* indexData = mesh->getSubMesh(i)->indexData;
+        capacity += indexData->indexBuffer->getSizeInBytes() + indexData->indexCount / 3 * 128;
+    }
+    MemoryDataStream* memStream = OGRE_NEW MemoryDataStream(capacity);
+    DataStreamPtr stream(memStream);
+    MeshSerializer serializer;
+    serializer.exportMesh(mesh.get(), stream);
+    const size_t size = stream->tell();
+    MeshManager::getSingleton().remove(mesh->getHandle());
+    mesh.setNull();
+    if (size == capacity)
+    {
+        state.SkipWithError("Export buffer too small");
+        return;
+    }
+
+    DataStreamPtr input(OGRE_NEW MemoryDataStream(memStream->getPtr(), size, false, true));
+    while (state.KeepRunning())
+    {
+        state.PauseTiming();
+        MeshPtr dest = MeshManager::getSingleton().createManual("Benchmark/Import", group);
+        input->seek(0);
+        state.ResumeTiming();
+
+        serializer.importMesh(input, dest.get());
+
+        state.PauseTiming();
+        MeshManager::getSingleton().remove(dest->getHandle());
+        dest.setNull();
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_MeshSerializerImport)->Arg(64)->Arg(200)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,84 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <benchmark/benchmark.h>
+
+#include "OgreOptimisedUtil.h"
+#include "OgreMatrix4.h"
+#include "BenchmarkUtils.h"
+
+using namespace Ogre;
+
+//--------------------------------------------------------------------------
+static void BM_SoftwareVertexSkinning(benchmark::State& state)
+{
+    const size_t numVertices = (size_t)state.range(0);
+    const size_t numWeights = (size_t)state.range(1);
+    const size_t numBones = 64;
+    uint32 seed = 3;
+
+    OGRE_SIMD_ALIGNED_DECL(Matrix4, matrices[numBones]);
+    const Matrix4* blendMatrices[numBones];
+    for (size_t i = 0; i < numBones; ++i)
+    {
+        Quaternion q(benchmarkRandom(seed), benchmarkRandom(seed), benchmarkRandom(seed), benchmarkRandom(seed));
+        q.normalise();
+        matrices[i].makeTransform(Vector3(benchmarkRandom(seed), benchmarkRandom(seed), benchmarkRandom(seed)),
+            Vector3::UNIT_SCALE, q);
+        blendMatrices[i] = &matrices[i];
+    }
+
+    // Interleaved position and normal, the usual layout of a skinned mesh
+    vector<float>::type src(numVertices * 6), dst(numVertices * 6);
+    vector<float>::type weights(numVertices * numWeights);
+    vector<unsigned char>::type indices(numVertices * numWeights);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = benchmarkRandom(seed);
+    for (size_t v = 0; v < numVertices; ++v)
+    {
+        for (size_t w = 0; w < numWeights; ++w)
+        {
+            weights[v * numWeights + w] = 1.0f / numWeights;
+            indices[v * numWeights + w] = (unsigned char)((v / 16 + w) % numBones);
+        }
+    }
+
+    OptimisedUtil* util = OptimisedUtil::getImplementation();
+    while (state.KeepRunning())
+    {
+        util->softwareVertexSkinning(
+            &src[0], &dst[0], &src[3], &dst[3],
+            &weights[0], &indices[0], blendMatrices,
+            6 * sizeof(float), 6 * sizeof(float), 6 * sizeof(float), 6 * sizeof(float),
+            numWeights * sizeof(float), numWeights, numWeights, numVertices);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * numVertices);
+}
+BENCHMARK(BM_SoftwareVertexSkinning)
+    ->Args({1 << 10, 1})->Args({1 << 10, 4})
+    ->Args({1 << 16, 2})->Args({1 << 16, 4});
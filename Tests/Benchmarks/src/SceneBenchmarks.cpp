@@ -0,0 +1,154 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <benchmark/benchmark.h>
+
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneNode.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreRenderQueueSortingGrouping.h"
+#include "OgreStringConverter.h"
+#include "BenchmarkUtils.h"
+
+using namespace Ogre;
+
+namespace {
+    /// Builds a tree with a fan out of 4, returns the number of nodes created
+    size_t buildHierarchy(SceneNode* parent, int depth, uint32& seed)
+    {
+        size_t count = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            SceneNode* node = parent->createChildSceneNode(
+                Vector3(benchmarkRandom(seed), benchmarkRandom(seed), benchmarkRandom(seed)) * 10,
+                Quaternion(Degree(Real(30 * i)), Vector3::UNIT_Y));
+            node->setScale(Vector3(1 + benchmarkRandom(seed) * 0.5f));
+            ++count;
+            if (depth > 1)
+                count += buildHierarchy(node, depth - 1, seed);
+        }
+        return count;
+    }
+}
+
+//--------------------------------------------------------------------------
+static void BM_NodeUpdate(benchmark::State& state)
+{
+    SceneManager* sceneMgr = Root::getSingleton().createSceneManager(ST_GENERIC);
+    SceneNode* top = sceneMgr->getRootSceneNode()->createChildSceneNode();
+    uint32 seed = 1;
+    size_t numNodes = buildHierarchy(top, (int)state.range(0), seed);
+
+    while (state.KeepRunning())
+    {
+        // Moving the top node invalidates every derived transform below it
+        top->yaw(Degree(0.5f));
+        top->_update(true, false);
+    }
+    state.SetItemsProcessed(state.iterations() * numNodes);
+
+    Root::getSingleton().destroySceneManager(sceneMgr);
+}
+BENCHMARK(BM_NodeUpdate)->Arg(4)->Arg(6)->Arg(8)->Unit(benchmark::kMicrosecond);
+//--------------------------------------------------------------------------
+/// Fills and sorts the collections, the scene and the camera do not change between fills
+static void renderQueueSort(benchmark::State& state, bool retained)
+{
+    const size_t numRenderables = (size_t)state.range(0);
+    const size_t numMaterials = 32;
+
+    SceneManager* sceneMgr = Root::getSingleton().createSceneManager(ST_GENERIC);
+    Camera* camera = sceneMgr->createCamera("BenchmarkCamera");
+    camera->setPosition(Vector3(0, 50, 500));
+    camera->lookAt(Vector3::ZERO);
+
+    // Distinct textures give the passes distinct hashes to group by
+    vector<MaterialPtr>::type materials;
+    for (size_t i = 0; i < numMaterials; ++i)
+    {
+        MaterialPtr mat = MaterialManager::getSingleton().create(
+            "Benchmark/RenderQueue/" + StringConverter::toString(i),
+            ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME).staticCast<Material>();
+        mat->getTechnique(0)->getPass(0)->createTextureUnitState(
+            "benchmark" + StringConverter::toString(i) + ".png");
+        materials.push_back(mat);
+    }
+
+    uint32 seed = 2;
+    vector<BenchmarkRenderable*>::type renderables;
+    for (size_t i = 0; i < numRenderables; ++i)
+    {
+        Vector3 pos(benchmarkRandom(seed), benchmarkRandom(seed), benchmarkRandom(seed));
+        renderables.push_back(new BenchmarkRenderable(materials[i % numMaterials], pos * 1000));
+    }
+
+    // Same organisation as the solid and transparent lists of a RenderPriorityGroup
+    QueuedRenderableCollection solids, transparents;
+    solids.addOrganisationMode(QueuedRenderableCollection::OM_PASS_GROUP);
+    transparents.addOrganisationMode(QueuedRenderableCollection::OM_SORT_DESCENDING);
+    solids.setRetainedMode(retained);
+    transparents.setRetainedMode(retained);
+
+    while (state.KeepRunning())
+    {
+        solids.clear();
+        transparents.clear();
+        for (size_t i = 0; i < numRenderables; ++i)
+        {
+            BenchmarkRenderable* rend = renderables[i];
+            Pass* pass = rend->getMaterial()->getTechnique(0)->getPass(0);
+            if (i % 4 == 0)
+                transparents.addRenderable(pass, rend);
+            else
+                solids.addRenderable(pass, rend);
+        }
+        solids.sort(camera);
+        transparents.sort(camera);
+    }
+    state.SetItemsProcessed(state.iterations() * numRenderables);
+
+    for (size_t i = 0; i < numRenderables; ++i)
+        delete renderables[i];
+    for (size_t i = 0; i < numMaterials; ++i)
+        MaterialManager::getSingleton().remove(materials[i]->getHandle());
+    Root::getSingleton().destroySceneManager(sceneMgr);
+}
+//--------------------------------------------------------------------------
+static void BM_RenderQueueSort(benchmark::State& state)
+{
+    renderQueueSort(state, false);
+}
+BENCHMARK(BM_RenderQueueSort)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 17)->Unit(benchmark::kMicrosecond);
+//--------------------------------------------------------------------------
+static void BM_RenderQueueSortRetained(benchmark::State& state)
+{
+    renderQueueSort(state, true);
+}
+BENCHMARK(BM_RenderQueueSortRetained)->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 17)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,93 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <benchmark/benchmark.h>
+
+#include "OgreRoot.h"
+#include "Threading/OgreDefaultWorkQueue.h"
+#include "Threading/OgreWorkStealingQueue.h"
+
+using namespace Ogre;
+
+namespace {
+    /// Small amount of arithmetic per request, so queueing costs dominate
+    class BenchmarkRequestHandler : public WorkQueue::RequestHandler
+    {
+    public:
+        WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+        {
+            uint32 seed = any_cast<uint32>(req->getData());
+            for (int i = 0; i < 256; ++i)
+                seed = seed * 1664525u + 1013904223u;
+            return OGRE_NEW WorkQueue::Response(req, true, Any(seed));
+        }
+    };
+
+    class BenchmarkResponseHandler : public WorkQueue::ResponseHandler
+    {
+    public:
+        BenchmarkResponseHandler() : count(0) {}
+        void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ) { ++count; }
+
+        size_t count;
+    };
+}
+//--------------------------------------------------------------------------
+/// Round trip of a burst of requests from several channels, range is the worker count
+template <typename QueueType> static void BM_WorkQueueThroughput(benchmark::State& state)
+{
+    const size_t numRequests = 4096;
+    const uint16 numChannels = 4;
+
+    QueueType queue("Benchmark");
+    queue.setWorkerThreadCount((size_t)state.range(0));
+    queue.setResponseProcessingTimeLimit(0);
+    BenchmarkRequestHandler requestHandler;
+    BenchmarkResponseHandler responseHandler;
+    for (uint16 channel = 0; channel < numChannels; ++channel)
+    {
+        queue.addRequestHandler(channel, &requestHandler);
+        queue.addResponseHandler(channel, &responseHandler);
+    }
+    queue.startup();
+
+    while (state.KeepRunning())
+    {
+        responseHandler.count = 0;
+        for (size_t i = 0; i < numRequests; ++i)
+            queue.addRequest((uint16)(i % numChannels), 0, Any((uint32)i));
+        while (responseHandler.count < numRequests)
+            queue.processResponses();
+    }
+    state.SetItemsProcessed(state.iterations() * numRequests);
+
+    queue.shutdown();
+}
+BENCHMARK_TEMPLATE(BM_WorkQueueThroughput, DefaultWorkQueue)->Arg(1)->Arg(2)->Arg(4)->Arg(8)
+    ->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_WorkQueueThroughput, WorkStealingQueue)->Arg(1)->Arg(2)->Arg(4)->Arg(8)
+    ->Unit(benchmark::kMicrosecond)->UseRealTime();
@@ -0,0 +1,79 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <benchmark/benchmark.h>
+
+#include "OgreRoot.h"
+#include "OgreLogManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreDefaultHardwareBufferManager.h"
+
+#include <cstring>
+
+using namespace Ogre;
+
+int main(int argc, char *argv[])
+{
+    // Write JSON results unless another output was asked for, so that runs
+    // can be diffed with tools/compare.py from Google Benchmark
+    vector<char*>::type args(argv, argv + argc);
+    bool hasOutput = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strncmp(argv[i], "--benchmark_out=", 16) == 0)
+            hasOutput = true;
+    }
+    char defaultOutput[] = "--benchmark_out=OgreBenchmarks.json";
+    char defaultFormat[] = "--benchmark_out_format=json";
+    if (!hasOutput)
+    {
+        args.push_back(defaultOutput);
+        args.push_back(defaultFormat);
+    }
+    int numArgs = (int)args.size();
+    args.push_back(0);
+
+    benchmark::Initialize(&numArgs, &args[0]);
+    if (benchmark::ReportUnrecognizedArguments(numArgs, &args[0]))
+        return 1;
+
+    LogManager* logMgr = new LogManager();
+    logMgr->createLog("OgreBenchmarks.log", true, false);
+    logMgr->setLogDetail(LL_LOW);
+
+    // Headless: no render system, buffers live in system memory
+    Root* root = new Root("");
+    DefaultHardwareBufferManager* hbm = new DefaultHardwareBufferManager;
+    MaterialManager::getSingleton().initialise();
+
+    benchmark::RunSpecifiedBenchmarks();
+
+    delete hbm;
+    delete root;
+    delete logMgr;
+    return 0;
+}
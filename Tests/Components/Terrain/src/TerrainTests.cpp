@@ -27,9 +27,15 @@ THE SOFTWARE.
 */
 #include "TerrainTests.h"
 #include "OgreTerrain.h"
+#include "OgreTerrainGroup.h"
+#include "OgreTerrainQuadTreeNode.h"
+#include "OgreTerrainLodManager.h"
+#include "OgreStreamSerialiser.h"
+#include "OgreDefaultHardwareBufferManager.h"
 #include "OgreConfigFile.h"
 #include "OgreResourceGroupManager.h"
 #include "OgreLogManager.h"
+#include "OgreMaterialManager.h"
 
 #if OGRE_PLATFORM == OGRE_PLATFORM_APPLE
 #include "macUtils.h"
@@ -103,3 +109,528 @@ TEST_F(TerrainTests, create)
     ASSERT_TRUE(1);
 }
 //--------------------------------------------------------------------------
+TEST_F(TerrainTests, horizonLightmapMatchesRayCasts)
+{
+    mTerrainOpts->setLightMapSize(128);
+    mTerrainOpts->setLightMapDirection(Vector3(1, -0.3f, 0.4f).normalisedCopy());
+
+    Terrain* t = OGRE_NEW Terrain(mSceneMgr);
+    Image img;
+    img.load("terrain.png", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    Terrain::ImportData imp;
+    imp.inputImage = &img;
+    imp.terrainSize = 513;
+    imp.worldSize = 1000;
+    imp.inputScale = 600;
+    imp.minBatchSize = 33;
+    imp.maxBatchSize = 65;
+    t->prepare(imp);
+
+    Rect finalRect;
+    PixelBox* lightmap = t->calculateLightmap(Rect(0, 0, 513, 513), Rect(), finalRect);
+    ASSERT_EQ(128, finalRect.width());
+    ASSERT_EQ(128, finalRect.height());
+
+    // Same sampling as the ray cast version, on a subset of the texels
+    const Vector3& lightVec = mTerrainOpts->getLightMapDirection();
+    Real heightPad = (t->getMaxHeight() - t->getMinHeight()) * 1.0e-3f;
+    size_t samples = 0, matches = 0, shadowed = 0;
+    for (long y = 0; y < 128; y += 3)
+    {
+        for (long x = 0; x < 128; x += 3)
+        {
+            Real tx = x / 127.0f, ty = y / 127.0f;
+            Vector3 wpos;
+            t->getPosition(tx, ty, t->getHeightAtTerrainPosition(tx, ty) + heightPad, &wpos);
+            bool rayShadowed = t->rayIntersects(Ray(wpos, -lightVec), true, 1000).first;
+            bool horizonShadowed = static_cast<uint8*>(lightmap->data)[(127 - y) * 128 + x] == 0;
+
+            ++samples;
+            matches += rayShadowed == horizonShadowed;
+            shadowed += horizonShadowed;
+        }
+    }
+    EXPECT_GT(shadowed, samples / 20);
+    EXPECT_LT(shadowed, samples - samples / 20);
+    EXPECT_GT(matches, samples * 95 / 100);
+
+    // Splitting the lines over threads must not change anything
+    mTerrainOpts->setNumWorkerThreads(4);
+    PixelBox* threaded = t->calculateLightmap(Rect(0, 0, 513, 513), Rect(), finalRect);
+    EXPECT_EQ(0, memcmp(lightmap->data, threaded->data, 128 * 128));
+
+    OGRE_FREE(lightmap->data, MEMCATEGORY_GENERAL);
+    OGRE_DELETE lightmap;
+    OGRE_FREE(threaded->data, MEMCATEGORY_GENERAL);
+    OGRE_DELETE threaded;
+    OGRE_DELETE t;
+}
+//--------------------------------------------------------------------------
+namespace
+{
+    void getMaxHeightDeltas(TerrainQuadTreeNode* node, vector<Real>::type& deltas)
+    {
+        for (uint16 i = 0; i < node->getLodCount(); ++i)
+            deltas.push_back(node->getLodLevel(i)->calcMaxHeightDelta);
+        if (!node->isLeaf())
+        {
+            for (unsigned short i = 0; i < 4; ++i)
+                getMaxHeightDeltas(node->getChild(i), deltas);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, derivedDataIndependentOfThreads)
+{
+    Terrain* t = OGRE_NEW Terrain(mSceneMgr);
+    Image img;
+    img.load("terrain.png", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    Terrain::ImportData imp;
+    imp.inputImage = &img;
+    imp.terrainSize = 513;
+    imp.worldSize = 1000;
+    imp.inputScale = 600;
+    imp.minBatchSize = 33;
+    imp.maxBatchSize = 65;
+    t->prepare(imp);
+
+    const long size = t->getSize();
+    vector<float>::type deltas(t->getDeltaData(), t->getDeltaData() + size * size);
+    vector<Real>::type maxDeltas;
+    getMaxHeightDeltas(t->getQuadTree(), maxDeltas);
+
+    Rect finalRect;
+    PixelBox* normals = t->calculateNormals(Rect(0, 0, size, size), finalRect);
+    ASSERT_EQ(size, finalRect.width());
+
+    // Normals are the average of the 8 tris around each vertex
+    for (long y = 0; y < size; y += 7)
+    {
+        for (long x = 0; x < size; x += 7)
+        {
+            Vector3 centre, adjacent[8];
+            t->getPointFromSelfOrNeighbour(x,     y,     &centre);
+            t->getPointFromSelfOrNeighbour(x + 1, y,     &adjacent[0]);
+            t->getPointFromSelfOrNeighbour(x + 1, y + 1, &adjacent[1]);
+            t->getPointFromSelfOrNeighbour(x,     y + 1, &adjacent[2]);
+            t->getPointFromSelfOrNeighbour(x - 1, y + 1, &adjacent[3]);
+            t->getPointFromSelfOrNeighbour(x - 1, y,     &adjacent[4]);
+            t->getPointFromSelfOrNeighbour(x - 1, y - 1, &adjacent[5]);
+            t->getPointFromSelfOrNeighbour(x,     y - 1, &adjacent[6]);
+            t->getPointFromSelfOrNeighbour(x + 1, y - 1, &adjacent[7]);
+
+            Vector3 expected = Vector3::ZERO;
+            for (int i = 0; i < 8; ++i)
+                expected += Plane(centre, adjacent[i], adjacent[(i + 1) % 8]).normal;
+            expected.normalise();
+
+            const uint8* actual = static_cast<uint8*>(normals->data) + ((size - y - 1) * size + x) * 3;
+            for (int i = 0; i < 3; ++i)
+                EXPECT_NEAR((expected[i] + 1.0f) * 0.5f * 255.0f, actual[i], 1.0f);
+        }
+    }
+
+    // Splitting the rows over threads must not change anything
+    mTerrainOpts->setNumWorkerThreads(4);
+    t->calculateHeightDeltas(Rect(0, 0, size, size));
+    EXPECT_EQ(0, memcmp(&deltas[0], t->getDeltaData(), size * size * sizeof(float)));
+    vector<Real>::type threadedMaxDeltas;
+    getMaxHeightDeltas(t->getQuadTree(), threadedMaxDeltas);
+    EXPECT_TRUE(maxDeltas == threadedMaxDeltas);
+
+    PixelBox* threaded = t->calculateNormals(Rect(0, 0, size, size), finalRect);
+    EXPECT_EQ(0, memcmp(normals->data, threaded->data, size * size * 3));
+
+    OGRE_FREE(normals->data, MEMCATEGORY_GENERAL);
+    OGRE_DELETE normals;
+    OGRE_FREE(threaded->data, MEMCATEGORY_GENERAL);
+    OGRE_DELETE threaded;
+    OGRE_DELETE t;
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, batchedHeightsMatchSingleQueries)
+{
+    Terrain* t = OGRE_NEW Terrain(mSceneMgr);
+    Image img;
+    img.load("terrain.png", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    Terrain::ImportData imp;
+    imp.inputImage = &img;
+    imp.terrainSize = 513;
+    imp.worldSize = 1000;
+    imp.inputScale = 600;
+    imp.minBatchSize = 33;
+    imp.maxBatchSize = 65;
+    t->prepare(imp);
+
+    // Including some just off the edges
+    vector<Vector3>::type positions;
+    for (int i = 0; i < 1001; ++i)
+        positions.push_back(Vector3(Math::RangeRandom(-510, 510), 0, Math::RangeRandom(-510, 510)));
+    positions.push_back(Vector3(-500, 0, 500));
+    positions.push_back(Vector3(500, 0, -500));
+
+    vector<float>::type heights(positions.size());
+    t->getHeightsAtWorldPositions(&positions[0], positions.size(), &heights[0]);
+    for (size_t i = 0; i < positions.size(); ++i)
+        EXPECT_NEAR(t->getHeightAtWorldPosition(positions[i]), heights[i], 1e-2f);
+
+    OGRE_DELETE t;
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, rayIntersectsFindsFirstHit)
+{
+    Terrain* t = OGRE_NEW Terrain(mSceneMgr);
+    Image img;
+    img.load("terrain.png", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    Terrain::ImportData imp;
+    imp.inputImage = &img;
+    imp.terrainSize = 513;
+    imp.worldSize = 1000;
+    imp.inputScale = 600;
+    imp.minBatchSize = 33;
+    imp.maxBatchSize = 65;
+    t->prepare(imp);
+
+    // Mostly shallow rays, like line of sight checks, which cross many quads
+    size_t hits = 0;
+    for (int i = 0; i < 500; ++i)
+    {
+        Vector3 origin(Math::RangeRandom(-490, 490), 0, Math::RangeRandom(-490, 490));
+        origin.y = t->getHeightAtWorldPosition(origin) + Math::RangeRandom(1, 100);
+        Vector3 dir(Math::RangeRandom(-1, 1), Math::RangeRandom(-0.3f, 0.05f), Math::RangeRandom(-1, 1));
+        dir.normalise();
+        Ray ray(origin, dir);
+
+        std::pair<bool, Vector3> result = t->rayIntersects(ray);
+        Real hitDistance = result.first ? origin.distance(result.second) : 1e6f;
+        if (result.first)
+        {
+            ++hits;
+            EXPECT_NEAR(t->getHeightAtWorldPosition(result.second), result.second.y, 0.1f);
+        }
+
+        // The ray must stay above the terrain up to the hit
+        for (Real d = 1; d < hitDistance - 1; d += 0.5f)
+        {
+            Vector3 pos = ray.getPoint(d);
+            if (Math::Abs(pos.x) > 500 || Math::Abs(pos.z) > 500)
+                break;
+            ASSERT_GT(pos.y, t->getHeightAtWorldPosition(pos) - 0.1f);
+        }
+    }
+    EXPECT_GT(hits, 100u);
+
+    OGRE_DELETE t;
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, rayIntersectsReportsMisses)
+{
+    Terrain* t = OGRE_NEW Terrain(mSceneMgr);
+    Image img;
+    img.load("terrain.png", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    Terrain::ImportData imp;
+    imp.inputImage = &img;
+    imp.terrainSize = 513;
+    imp.worldSize = 1000;
+    imp.inputScale = 600;
+    imp.minBatchSize = 33;
+    imp.maxBatchSize = 65;
+    t->prepare(imp);
+
+    // Rays starting just above the terrain and leaving upwards stay inside the
+    // terrain bounds for a while, some of them without ever touching it
+    size_t tested = 0;
+    for (int i = 0; i < 500; ++i)
+    {
+        Vector3 origin(Math::RangeRandom(-490, 490), 0, Math::RangeRandom(-490, 490));
+        origin.y = t->getHeightAtWorldPosition(origin) + 1;
+        if (origin.y > t->getMaxHeight() - 50)
+            continue;
+        Vector3 dir(Math::RangeRandom(-1, 1), Math::RangeRandom(0.2f, 0.5f), Math::RangeRandom(-1, 1));
+        dir.normalise();
+        Ray ray(origin, dir);
+
+        bool clear = true;
+        for (Real d = 0.5f; clear; d += 0.5f)
+        {
+            Vector3 pos = ray.getPoint(d);
+            if (Math::Abs(pos.x) > 500 || Math::Abs(pos.z) > 500 || pos.y > t->getMaxHeight())
+                break;
+            clear = pos.y > t->getHeightAtWorldPosition(pos) + 0.5f;
+        }
+        if (!clear)
+            continue;
+
+        ++tested;
+        EXPECT_FALSE(t->rayIntersects(ray).first);
+        EXPECT_FALSE(t->rayIntersects(ray, false, 10).first);
+    }
+    EXPECT_GT(tested, 50u);
+
+    // Pointing away from the terrain altogether
+    EXPECT_FALSE(t->rayIntersects(Ray(Vector3(0, 1000, 0), Vector3::UNIT_Y)).first);
+    EXPECT_FALSE(t->rayIntersects(Ray(Vector3(2000, 0, 0), Vector3::UNIT_X)).first);
+
+    OGRE_DELETE t;
+}
+//--------------------------------------------------------------------------
+namespace
+{
+    /** Generates empty materials, so that terrains can be loaded without a
+        render system.
+    */
+    class EmptyMaterialGenerator : public TerrainMaterialGenerator
+    {
+    public:
+        class EmptyProfile : public Profile
+        {
+        public:
+            EmptyProfile(TerrainMaterialGenerator* parent)
+                : Profile(parent, "Empty", "Materials without techniques") {}
+            bool isVertexCompressionSupported() const { return false; }
+            MaterialPtr generate(const Terrain* terrain)
+            {
+                MaterialManager& mgr = MaterialManager::getSingleton();
+                MaterialPtr mat = mgr.getByName(terrain->getMaterialName());
+                if (mat.isNull())
+                {
+                    mat = mgr.create(terrain->getMaterialName(),
+                        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+                }
+                mat->removeAllTechniques();
+                return mat;
+            }
+            MaterialPtr generateForCompositeMap(const Terrain* terrain) { return generate(terrain); }
+            void setLightmapEnabled(bool enabled) {}
+            uint8 getMaxLayers(const Terrain* terrain) const { return 1; }
+            void updateParams(const MaterialPtr& mat, const Terrain* terrain) {}
+            void updateParamsForCompositeMap(const MaterialPtr& mat, const Terrain* terrain) {}
+            void requestOptions(Terrain* terrain)
+            {
+                terrain->_setMorphRequired(false);
+                terrain->_setNormalMapRequired(false);
+                terrain->_setLightMapRequired(false);
+                terrain->_setCompositeMapRequired(false);
+            }
+        };
+
+        EmptyMaterialGenerator()
+        {
+            mProfiles.push_back(OGRE_NEW EmptyProfile(this));
+            setActiveProfile(mProfiles.back());
+        }
+    };
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, groupBatchQueriesMatchSingleQueries)
+{
+    // software buffers, since there is no render system
+    DefaultHardwareBufferManager* bufMgr = OGRE_NEW DefaultHardwareBufferManager();
+    mTerrainOpts->setDefaultMaterialGenerator(
+        TerrainMaterialGeneratorPtr(OGRE_NEW EmptyMaterialGenerator()));
+
+    Image img;
+    img.load("terrain.png", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    // Three slots from the image, one flat and one left empty, along with
+    // the space around them
+    TerrainGroup* group = OGRE_NEW TerrainGroup(mSceneMgr, Terrain::ALIGN_X_Z, 513, 1000);
+    Terrain::ImportData& imp = group->getDefaultImportSettings();
+    imp.inputScale = 600;
+    imp.minBatchSize = 33;
+    imp.maxBatchSize = 65;
+    group->defineTerrain(0, 0, &img);
+    group->defineTerrain(1, 0, &img);
+    group->defineTerrain(0, 1, &img);
+    group->defineTerrain(1, 1, 150.0f);
+    group->defineTerrain(2, 1, &img);
+    group->loadAllTerrains(true);
+    ASSERT_TRUE(group->getTerrain(0, 0)->isLoaded());
+    ASSERT_TRUE(group->getTerrain(1, 1)->isLoaded());
+
+    // Enough of each to be split over the threads
+    vector<Vector3>::type positions;
+    for (int i = 0; i < 5000; ++i)
+        positions.push_back(Vector3(Math::RangeRandom(-700, 2700), 0, Math::RangeRandom(-1700, 700)));
+    vector<Ray>::type rays;
+    for (int i = 0; i < 500; ++i)
+    {
+        Vector3 origin(Math::RangeRandom(-500, 2500), 0, Math::RangeRandom(-1500, 500));
+        origin.y = group->getHeightAtWorldPosition(origin) + Math::RangeRandom(1, 300);
+        Vector3 dir(Math::RangeRandom(-1, 1), Math::RangeRandom(-0.3f, 0.05f), Math::RangeRandom(-1, 1));
+        rays.push_back(Ray(origin, dir.normalisedCopy()));
+    }
+
+    for (int threads = 0; threads < 2; ++threads)
+    {
+        mTerrainOpts->setNumWorkerThreads(threads * 4);
+
+        vector<float>::type heights(positions.size());
+        vector<Terrain*>::type terrains(positions.size());
+        group->getHeightsAtWorldPositions(&positions[0], positions.size(), &heights[0], &terrains[0]);
+        size_t resolved = 0;
+        for (size_t i = 0; i < positions.size(); ++i)
+        {
+            Terrain* terrain = 0;
+            EXPECT_NEAR(group->getHeightAtWorldPosition(positions[i], &terrain), heights[i], 1e-2f);
+            EXPECT_EQ(terrain, terrains[i]);
+            resolved += terrain != 0;
+        }
+        EXPECT_GT(resolved, positions.size() / 4);
+        EXPECT_LT(resolved, positions.size());
+
+        vector<TerrainGroup::RayResult>::type results(rays.size());
+        group->rayIntersects(&rays[0], rays.size(), &results[0]);
+        size_t hits = 0;
+        for (size_t i = 0; i < rays.size(); ++i)
+        {
+            TerrainGroup::RayResult expected = group->rayIntersects(rays[i]);
+            ASSERT_EQ(expected.hit, results[i].hit);
+            EXPECT_EQ(expected.terrain, results[i].terrain);
+            EXPECT_EQ(expected.position, results[i].position);
+            hits += expected.hit;
+        }
+        EXPECT_GT(hits, rays.size() / 10);
+        EXPECT_LT(hits, rays.size());
+    }
+
+    OGRE_DELETE group;
+    OGRE_DELETE bufMgr;
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, lodDataRoundTrip)
+{
+    Terrain* t = OGRE_NEW Terrain(mSceneMgr);
+    Image img;
+    img.load("terrain.png", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    Terrain::ImportData imp;
+    imp.inputImage = &img;
+    imp.terrainSize = 513;
+    imp.worldSize = 1000;
+    imp.inputScale = 600;
+    imp.minBatchSize = 33;
+    imp.maxBatchSize = 65;
+    t->prepare(imp);
+
+    const long size = t->getSize();
+    float* heights = t->getHeightData();
+    float* deltas = const_cast<float*>(t->getDeltaData());
+    vector<float>::type savedHeights(heights, heights + size * size);
+    vector<float>::type savedDeltas(deltas, deltas + size * size);
+
+    // Just the parts of the terrain file the LOD manager reads
+    const String filename = "TerrainTests_lodData.dat";
+    {
+        DataStreamPtr out = mRoot->createFileStream(filename,
+            ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true);
+        StreamSerialiser ser(out);
+        ser.writeChunkBegin(Terrain::TERRAIN_CHUNK_ID, Terrain::TERRAIN_CHUNK_VERSION);
+        ser.writeChunkBegin(Terrain::TERRAINGENERALINFO_CHUNK_ID, Terrain::TERRAINGENERALINFO_CHUNK_VERSION);
+        ser.writeChunkEnd(Terrain::TERRAINGENERALINFO_CHUNK_ID);
+        TerrainLodManager::saveLodData(ser, t);
+        ser.writeChunkEnd(Terrain::TERRAIN_CHUNK_ID);
+    }
+
+    // Read from the file, then from memory where blocks are decompressed in place
+    DataStreamPtr fileStream = mRoot->openFileStream(filename);
+    DataStreamPtr streams[2] = { mRoot->openFileStream(filename),
+        DataStreamPtr(OGRE_NEW MemoryDataStream(fileStream)) };
+    for (int s = 0; s < 2; ++s)
+    {
+        memset(heights, 0, size * size * sizeof(float));
+        memset(deltas, 0, size * size * sizeof(float));
+
+        // Just the lower levels, only every 4th vertex is there
+        TerrainLodManager lodManager(t, streams[s]);
+        lodManager.readLodData(t->getNumLodLevels() - 1, 2);
+        for (long y = 0; y < size; ++y)
+        {
+            for (long x = 0; x < size; ++x)
+            {
+                float expected = (x % 4 || y % 4) ? 0 : savedHeights[y * size + x];
+                ASSERT_EQ(expected, heights[y * size + x]);
+            }
+        }
+
+        lodManager.readLodData(1, 0);
+        EXPECT_EQ(0, memcmp(&savedHeights[0], heights, size * size * sizeof(float)));
+        EXPECT_EQ(0, memcmp(&savedDeltas[0], deltas, size * size * sizeof(float)));
+    }
+
+    OGRE_DELETE t;
+    std::remove(filename.c_str());
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, sharedGridMatchesVertexData)
+{
+    // software buffers, since there is no render system
+    DefaultHardwareBufferManager* bufMgr = OGRE_NEW DefaultHardwareBufferManager();
+
+    Terrain* t = OGRE_NEW Terrain(mSceneMgr);
+    Image img;
+    img.load("terrain.png", ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+
+    Terrain::ImportData imp;
+    imp.inputImage = &img;
+    imp.terrainSize = 513;
+    imp.worldSize = 1000;
+    imp.minBatchSize = 33;
+    imp.maxBatchSize = 65;
+    t->prepare(imp);
+
+    const uint16 vdatasize = 65, inc = 2, numSkirtRowsCols = 3, skirtRowColSkip = 32;
+    Terrain::GpuBufferAllocator* alloc = t->getGpuBufferAllocator();
+    HardwareVertexBufferSharedPtr grid = alloc->getSharedGridVertexBuffer(t, vdatasize, inc, 
+        numSkirtRowsCols, skirtRowColSkip);
+    EXPECT_EQ(grid.get(), alloc->getSharedGridVertexBuffer(t, vdatasize, inc, 
+        numSkirtRowsCols, skirtRowColSkip).get());
+    ASSERT_EQ(size_t(vdatasize * vdatasize + numSkirtRowsCols * vdatasize * 2), grid->getNumVertices());
+
+    // The same grid must do for vertex data anywhere it could be placed
+    const int16* pBase = static_cast<const int16*>(grid->lock(HardwareBuffer::HBL_READ_ONLY));
+    const long extent = (vdatasize - 1) * inc;
+    for (long offY = 0; offY < 512; offY += extent)
+    {
+        for (long offX = 0; offX < 512; offX += extent)
+        {
+            for (uint16 y = 0; y < vdatasize; ++y)
+            {
+                for (uint16 x = 0; x < vdatasize; ++x)
+                {
+                    const int16* pV = pBase + (y * vdatasize + x) * 4;
+                    ASSERT_EQ(x * inc, pV[0]);
+                    ASSERT_EQ(y * inc, pV[1]);
+                    ASSERT_EQ(0, pV[2]);
+                    ASSERT_EQ(t->getLODLevelWhenVertexEliminated(offX + pV[0], offY + pV[1]) - 1, pV[3]);
+                }
+            }
+        }
+    }
+    // Skirts line up with the main vertices which the index buffers join them to
+    for (uint16 i = 0; i < vdatasize * vdatasize; i += 7)
+    {
+        for (int isCol = 0; isCol < 2; ++isCol)
+        {
+            uint16 row = i / vdatasize, col = i % vdatasize;
+            if ((isCol ? col : row) % skirtRowColSkip)
+                continue;
+            const int16* pMain = pBase + i * 4;
+            const int16* pSkirt = pBase + Terrain::_calcSkirtVertexIndex(i, vdatasize, isCol != 0, 
+                numSkirtRowsCols, skirtRowColSkip) * 4;
+            EXPECT_EQ(pMain[0], pSkirt[0]);
+            EXPECT_EQ(pMain[1], pSkirt[1]);
+            EXPECT_EQ(1, pSkirt[2]);
+        }
+    }
+    grid->unlock();
+    grid.setNull();
+
+    OGRE_DELETE t;
+    OGRE_DELETE bufMgr;
+}
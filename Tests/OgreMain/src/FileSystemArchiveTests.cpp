@@ -277,6 +277,29 @@ TEST_F(FileSystemArchiveTests,FileRead)
     EXPECT_TRUE(stream->eof());
 }
 //--------------------------------------------------------------------------
+TEST_F(FileSystemArchiveTests,MemoryMappedRead)
+{
+    FileSystemArchive arch(mTestPath, "FileSystem", true);
+    arch.load();
+
+    FileSystemArchive::setMemoryMapping(true);
+    DataStreamPtr stream = arch.open("rootfile.txt");
+    FileSystemArchive::setMemoryMapping(false);
+
+    MemoryDataStream* memStream = dynamic_cast<MemoryDataStream*>(stream.get());
+    ASSERT_TRUE(memStream != 0);
+    EXPECT_EQ(mFileSizeRoot1, stream->size());
+    EXPECT_EQ(String("this is line 1 in file 1"), String((const char*)memStream->getCurrentPtr(), 24));
+    EXPECT_EQ(String("this is line 1 in file 1"), stream->getLine());
+    stream->skipLine();
+    stream->skipLine();
+    stream->skipLine();
+    EXPECT_EQ(String("this is line 5 in file 1"), stream->getLine());
+    EXPECT_EQ(BLANKSTRING, stream->getLine()); // blank at end of file
+    EXPECT_TRUE(stream->eof());
+    EXPECT_FALSE(stream->isWriteable());
+}
+//--------------------------------------------------------------------------
 TEST_F(FileSystemArchiveTests,ReadInterleave)
 {
     // Test overlapping reads from same archive
@@ -0,0 +1,136 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <Ogre.h>
+#include "RootWithoutRenderSystemFixture.h"
+#include "OgreAutoParamDataSource.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture GpuProgramParamsTests;
+
+namespace {
+    GpuProgramParametersSharedPtr createAutoParams()
+    {
+        const char* names[] = { "world", "ambient", "iteration" };
+        const GpuConstantType types[] = { GCT_MATRIX_4X4, GCT_FLOAT4, GCT_FLOAT1 };
+
+        GpuNamedConstantsPtr namedConstants(OGRE_NEW GpuNamedConstants);
+        for (size_t i = 0; i < 3; ++i)
+        {
+            GpuConstantDefinition def;
+            def.constType = types[i];
+            def.elementSize = GpuConstantDefinition::getElementSize(def.constType, false);
+            def.arraySize = 1;
+            def.physicalIndex = namedConstants->floatBufferSize;
+            def.logicalIndex = i;
+            namedConstants->map[names[i]] = def;
+            namedConstants->floatBufferSize += def.elementSize;
+        }
+
+        GpuProgramParametersSharedPtr params(OGRE_NEW GpuProgramParameters);
+        params->_setNamedConstants(namedConstants);
+        params->setNamedAutoConstant("world", GpuProgramParameters::ACT_WORLD_MATRIX);
+        params->setNamedAutoConstant("ambient", GpuProgramParameters::ACT_AMBIENT_LIGHT_COLOUR);
+        params->setNamedAutoConstant("iteration", GpuProgramParameters::ACT_PASS_ITERATION_NUMBER);
+        return params;
+    }
+
+    uint64 getStamp(const GpuProgramParametersSharedPtr& params, const String& name)
+    {
+        return params->findAutoConstantEntry(name)->updateStamp;
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(GpuProgramParamsTests, UpdateAutoParamsOnlyForChangedSources)
+{
+    GpuProgramParametersSharedPtr params = createAutoParams();
+    Matrix4 world = Matrix4::getTrans(1, 2, 3);
+    AutoParamDataSource source;
+    source.setWorldMatrices(&world, 1);
+    source.setAmbientLightColour(ColourValue::Red);
+
+    params->_updateAutoParams(&source, GPV_ALL);
+    uint64 worldStamp = getStamp(params, "world");
+    uint64 ambientStamp = getStamp(params, "ambient");
+    uint64 iterationStamp = getStamp(params, "iteration");
+    EXPECT_NE(0u, worldStamp);
+    EXPECT_NE(0u, ambientStamp);
+    EXPECT_EQ(3, params->getFloatPointer(params->_findNamedConstantDefinition("world")->physicalIndex)[11]);
+
+    // Nothing changed, only the untracked pass iteration number is written again
+    params->_updateAutoParams(&source, GPV_ALL);
+    EXPECT_EQ(worldStamp, getStamp(params, "world"));
+    EXPECT_EQ(ambientStamp, getStamp(params, "ambient"));
+    EXPECT_LT(iterationStamp, getStamp(params, "iteration"));
+
+    // Setting the same ambient colour again is no change either
+    source.setAmbientLightColour(ColourValue::Red);
+    params->_updateAutoParams(&source, GPV_ALL);
+    EXPECT_EQ(ambientStamp, getStamp(params, "ambient"));
+
+    source.setAmbientLightColour(ColourValue::Blue);
+    params->_updateAutoParams(&source, GPV_ALL);
+    EXPECT_EQ(worldStamp, getStamp(params, "world"));
+    EXPECT_LT(ambientStamp, getStamp(params, "ambient"));
+    const float* ambient = params->getFloatPointer(params->_findNamedConstantDefinition("ambient")->physicalIndex);
+    EXPECT_EQ(ColourValue::Blue, ColourValue(ambient[0], ambient[1], ambient[2], ambient[3]));
+    ambientStamp = getStamp(params, "ambient");
+
+    world = Matrix4::getTrans(4, 5, 6);
+    source.setWorldMatrices(&world, 1);
+    params->_updateAutoParams(&source, GPV_ALL);
+    EXPECT_LT(worldStamp, getStamp(params, "world"));
+    EXPECT_EQ(ambientStamp, getStamp(params, "ambient"));
+    EXPECT_EQ(6, params->getFloatPointer(params->_findNamedConstantDefinition("world")->physicalIndex)[11]);
+    worldStamp = getStamp(params, "world");
+
+    // Versions of another source can't be compared, everything is written again
+    AutoParamDataSource otherSource;
+    otherSource.setWorldMatrices(&world, 1);
+    otherSource.setAmbientLightColour(ColourValue::Green);
+    params->_updateAutoParams(&otherSource, GPV_ALL);
+    EXPECT_LT(worldStamp, getStamp(params, "world"));
+    EXPECT_LT(ambientStamp, getStamp(params, "ambient"));
+}
+//--------------------------------------------------------------------------
+TEST_F(GpuProgramParamsTests, ResetAutoConstantIsWrittenAgain)
+{
+    GpuProgramParametersSharedPtr params = createAutoParams();
+    Matrix4 world = Matrix4::IDENTITY;
+    AutoParamDataSource source;
+    source.setWorldMatrices(&world, 1);
+
+    params->_updateAutoParams(&source, GPV_ALL);
+    EXPECT_NE(0u, getStamp(params, "ambient"));
+
+    // A different auto constant in the same slot has to be calculated on the next update
+    params->setNamedAutoConstant("ambient", GpuProgramParameters::ACT_FOG_COLOUR);
+    EXPECT_EQ(0u, getStamp(params, "ambient"));
+    params->_updateAutoParams(&source, GPV_ALL);
+    EXPECT_NE(0u, getStamp(params, "ambient"));
+}
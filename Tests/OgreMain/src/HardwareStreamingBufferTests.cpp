@@ -0,0 +1,297 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreHardwareStreamingBuffer.h"
+#include "OgreBillboardChain.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+namespace {
+    /// Streaming buffer whose frames stay busy until signalled by the test
+    class FencedStreamingBuffer : public HardwareStreamingBuffer
+    {
+    public:
+        FencedStreamingBuffer(const HardwareVertexBufferSharedPtr& buffer, void* data)
+            : HardwareStreamingBuffer(buffer, data), nextFence(1) {}
+
+        ~FencedStreamingBuffer()
+        {
+            for (PendingFrameList::iterator i = mPendingFrames.begin(); i != mPendingFrames.end(); ++i)
+                deleteFence(i->fence);
+        }
+
+        void* createFence(void)
+        {
+            live.insert(nextFence);
+            return reinterpret_cast<void*>(nextFence++);
+        }
+        bool isFenceSignalled(void* fence) { return signalled.count(reinterpret_cast<size_t>(fence)) != 0; }
+        void waitFence(void* fence) { waited.push_back(reinterpret_cast<size_t>(fence)); }
+        void deleteFence(void* fence) { live.erase(reinterpret_cast<size_t>(fence)); }
+
+        size_t nextFence;
+        set<size_t>::type live;
+        set<size_t>::type signalled;
+        vector<size_t>::type waited;
+    };
+}
+
+class HardwareStreamingBufferTests : public ::testing::Test
+{
+public:
+    void SetUp()
+    {
+        mMgr = OGRE_NEW DefaultHardwareBufferManagerBase();
+        mBuffer = mMgr->createVertexBuffer(16, 100, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
+        mData = static_cast<unsigned char*>(mBuffer->lock(HardwareBuffer::HBL_NORMAL));
+        mBuffer->unlock();
+    }
+    void TearDown()
+    {
+        mBuffer.setNull();
+        OGRE_DELETE mMgr;
+    }
+
+    DefaultHardwareBufferManagerBase* mMgr;
+    HardwareVertexBufferSharedPtr mBuffer;
+    unsigned char* mData;
+};
+
+TEST_F(HardwareStreamingBufferTests, ManagerCreatesOneRingPerVertexSize)
+{
+    mMgr->setStreamingBufferSize(1600);
+    HardwareStreamingBuffer* a = mMgr->getStreamingBuffer(16);
+    ASSERT_TRUE(a != 0);
+    EXPECT_EQ(a, mMgr->getStreamingBuffer(16));
+    EXPECT_EQ(16U, a->getElementSize());
+    EXPECT_EQ(100U, a->getNumElements());
+
+    HardwareStreamingBuffer* b = mMgr->getStreamingBuffer(32);
+    ASSERT_TRUE(b != 0);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(50U, b->getNumElements());
+
+    // Larger than the whole ring
+    EXPECT_TRUE(mMgr->getStreamingBuffer(3200) == 0);
+}
+
+TEST_F(HardwareStreamingBufferTests, ManagerCreatesOneRingPerIndexType)
+{
+    mMgr->setStreamingBufferSize(1600);
+    HardwareStreamingBuffer* a = mMgr->getStreamingIndexBuffer(HardwareIndexBuffer::IT_16BIT);
+    ASSERT_TRUE(a != 0);
+    EXPECT_EQ(a, mMgr->getStreamingIndexBuffer(HardwareIndexBuffer::IT_16BIT));
+    EXPECT_TRUE(a->getVertexBuffer().isNull());
+    ASSERT_FALSE(a->getIndexBuffer().isNull());
+    EXPECT_EQ(HardwareIndexBuffer::IT_16BIT, a->getIndexBuffer()->getType());
+    EXPECT_EQ(800U, a->getNumElements());
+
+    HardwareStreamingBuffer* b = mMgr->getStreamingIndexBuffer(HardwareIndexBuffer::IT_32BIT);
+    ASSERT_TRUE(b != 0);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(4U, b->getElementSize());
+    EXPECT_EQ(400U, b->getNumElements());
+
+    // Index and vertex rings are separate even for the same element size
+    EXPECT_NE(b, mMgr->getStreamingBuffer(4));
+}
+
+TEST_F(HardwareStreamingBufferTests, IndexRangesAreAddressedInIndexes)
+{
+    HardwareIndexBufferSharedPtr indexes =
+        mMgr->createIndexBuffer(HardwareIndexBuffer::IT_16BIT, 100, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
+    unsigned char* data = static_cast<unsigned char*>(indexes->lock(HardwareBuffer::HBL_NORMAL));
+    indexes->unlock();
+
+    HardwareStreamingBuffer buf(indexes, data);
+    size_t start;
+    EXPECT_EQ(data, buf.allocate(30, start));
+    EXPECT_EQ(data + 30 * 2, buf.allocate(30, start));
+    EXPECT_EQ(30U, start);
+    EXPECT_TRUE(buf.allocate(41, start) == 0);
+}
+
+TEST_F(HardwareStreamingBufferTests, AllocatesConsecutiveRanges)
+{
+    HardwareStreamingBuffer buf(mBuffer, mData);
+    size_t start = 99;
+
+    EXPECT_EQ(mData, buf.allocate(10, start));
+    EXPECT_EQ(0U, start);
+    EXPECT_EQ(mData + 10 * 16, buf.allocate(20, start));
+    EXPECT_EQ(10U, start);
+    EXPECT_EQ(30U, buf.getUsedElements());
+
+    EXPECT_TRUE(buf.allocate(0, start) == 0);
+    EXPECT_TRUE(buf.allocate(101, start) == 0);
+}
+
+TEST_F(HardwareStreamingBufferTests, NeverOverwritesCurrentFrame)
+{
+    HardwareStreamingBuffer buf(mBuffer, mData);
+    size_t start;
+
+    ASSERT_TRUE(buf.allocate(60, start) != 0);
+    EXPECT_TRUE(buf.allocate(60, start) == 0);
+    ASSERT_TRUE(buf.allocate(40, start) != 0);
+    EXPECT_EQ(60U, start);
+    EXPECT_TRUE(buf.allocate(1, start) == 0);
+
+    // Without fences the frame is reusable straight after it ended
+    buf._endFrame();
+    EXPECT_EQ(0U, buf.getUsedElements());
+    EXPECT_EQ(mData, buf.allocate(100, start));
+}
+
+TEST_F(HardwareStreamingBufferTests, WrapsAroundBusyFrames)
+{
+    FencedStreamingBuffer buf(mBuffer, mData);
+    size_t start;
+
+    ASSERT_TRUE(buf.allocate(40, start) != 0);
+    buf._endFrame();
+    ASSERT_TRUE(buf.allocate(40, start) != 0);
+    EXPECT_EQ(40U, start);
+    buf._endFrame();
+    EXPECT_EQ(80U, buf.getUsedElements());
+
+    // First frame done, the next range doesn't fit at the end so it wraps
+    buf.signalled.insert(1);
+    buf._endFrame();
+    EXPECT_EQ(40U, buf.getUsedElements());
+    EXPECT_EQ(mData, buf.allocate(30, start));
+    EXPECT_EQ(0U, start);
+    // The skipped end of the ring is accounted to the current frame
+    EXPECT_EQ(90U, buf.getUsedElements());
+    EXPECT_TRUE(buf.waited.empty());
+
+    // Going past the second frame has to wait for it
+    EXPECT_EQ(mData + 30 * 16, buf.allocate(30, start));
+    EXPECT_EQ(30U, start);
+    ASSERT_EQ(1U, buf.waited.size());
+    EXPECT_EQ(2U, buf.waited[0]);
+    EXPECT_EQ(0U, buf.live.count(2));
+
+    // But never for the frame being built
+    EXPECT_TRUE(buf.allocate(50, start) == 0);
+    EXPECT_EQ(1U, buf.waited.size());
+}
+
+TEST_F(HardwareStreamingBufferTests, EmptyFramesAreNotFenced)
+{
+    FencedStreamingBuffer buf(mBuffer, mData);
+    buf._endFrame();
+    buf._endFrame();
+    EXPECT_EQ(1U, buf.nextFence);
+    EXPECT_TRUE(buf.live.empty());
+}
+
+namespace {
+    /// Exposes the index update of a chain
+    class IndexedChain : public BillboardChain
+    {
+    public:
+        IndexedChain(const String& name, bool dynamic) : BillboardChain(name, 4, 1, true, true, dynamic)
+        {
+            for (int i = 0; i < 3; ++i)
+                addChainElement(0, Element(Vector3(Real(i), 0, 0), 1, 0, ColourValue::White, Quaternion::IDENTITY));
+        }
+
+        using BillboardChain::updateIndexBuffer;
+        const IndexData* getIndexData() const { return mIndexData; }
+        const HardwareIndexBufferSharedPtr& getOwnIndexBuffer() const { return mIndexBuffer; }
+    };
+}
+
+class StreamedBillboardChainTests : public RootWithoutRenderSystemFixture
+{
+public:
+    void SetUp()
+    {
+        RootWithoutRenderSystemFixture::SetUp();
+        mDynamic = OGRE_NEW IndexedChain("dynamic", true);
+        mStatic = OGRE_NEW IndexedChain("static", false);
+    }
+    void TearDown()
+    {
+        OGRE_DELETE mDynamic;
+        OGRE_DELETE mStatic;
+        RootWithoutRenderSystemFixture::TearDown();
+    }
+
+    IndexedChain* mDynamic;
+    IndexedChain* mStatic;
+};
+
+TEST_F(StreamedBillboardChainTests, DynamicChainStreamsIndexes)
+{
+    HardwareStreamingBuffer* ring =
+        HardwareBufferManager::getSingleton().getStreamingIndexBuffer(HardwareIndexBuffer::IT_16BIT);
+    ASSERT_TRUE(ring != 0);
+
+    mDynamic->updateIndexBuffer();
+    mStatic->updateIndexBuffer();
+    const IndexData* streamed = mDynamic->getIndexData();
+    const IndexData* own = mStatic->getIndexData();
+    EXPECT_EQ(ring->getIndexBuffer(), streamed->indexBuffer);
+    EXPECT_EQ(mStatic->getOwnIndexBuffer(), own->indexBuffer);
+    ASSERT_EQ(12U, own->indexCount);
+    ASSERT_EQ(own->indexCount, streamed->indexCount);
+    EXPECT_EQ(12U, ring->getUsedElements());
+
+    // Static chains keep writing their own buffer, with the same indexes
+    const uint16* expected = static_cast<const uint16*>(
+        own->indexBuffer->lock(HardwareBuffer::HBL_READ_ONLY));
+    const uint16* actual = static_cast<const uint16*>(streamed->indexBuffer->lock(
+        streamed->indexStart * 2, streamed->indexCount * 2, HardwareBuffer::HBL_READ_ONLY));
+    for (size_t i = 0; i < own->indexCount; ++i)
+        EXPECT_EQ(expected[i], actual[i]);
+    streamed->indexBuffer->unlock();
+    own->indexBuffer->unlock();
+
+    // Streamed indexes only last a frame, so every update writes them again
+    mDynamic->updateIndexBuffer();
+    EXPECT_EQ(12U, mDynamic->getIndexData()->indexStart);
+    EXPECT_EQ(24U, ring->getUsedElements());
+    HardwareBufferManager::getSingleton()._endStreamingFrame();
+    EXPECT_EQ(0U, ring->getUsedElements());
+}
+
+TEST_F(StreamedBillboardChainTests, FallsBackToOwnBufferWhenRingIsFull)
+{
+    // Too small for the 12 indexes of the chain
+    HardwareBufferManager::getSingleton().setStreamingBufferSize(16);
+
+    mDynamic->updateIndexBuffer();
+    const IndexData* indexData = mDynamic->getIndexData();
+    EXPECT_EQ(mDynamic->getOwnIndexBuffer(), indexData->indexBuffer);
+    EXPECT_EQ(0U, indexData->indexStart);
+    EXPECT_EQ(12U, indexData->indexCount);
+}
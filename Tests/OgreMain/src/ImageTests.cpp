@@ -0,0 +1,143 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "OgreImage.h"
+#include "OgreMath.h"
+#include "OgreColourValue.h"
+
+using namespace Ogre;
+
+namespace {
+    /// Image of the given size filled with random bytes
+    void createRandomImage(Image& image, uint32 width, uint32 height, PixelFormat format, size_t numFaces = 1)
+    {
+        size_t size = Image::calculateSize(0, numFaces, width, height, 1, format);
+        uchar* data = OGRE_ALLOC_T(uchar, size, MEMCATEGORY_GENERAL);
+        for (size_t i = 0; i < size; ++i)
+            data[i] = (uchar)rand();
+        image.loadDynamicImage(data, width, height, 1, format, true, numFaces);
+    }
+}
+//--------------------------------------------------------------------------
+TEST(ImageTests, GenerateMipmapsBuildsFullChain)
+{
+    Image image;
+    createRandomImage(image, 37, 10, PF_A8R8G8B8, 6);
+    Image original = image;
+
+    ASSERT_TRUE(image.generateMipmaps());
+    // 37x10, 18x5, 9x2, 4x1, 2x1, 1x1
+    EXPECT_EQ(5u, image.getNumMipmaps());
+    EXPECT_EQ(Image::calculateSize(5, 6, 37, 10, 1, PF_A8R8G8B8), image.getSize());
+
+    for (size_t face = 0; face < 6; ++face)
+    {
+        // Top level kept
+        PixelBox top = image.getPixelBox(face, 0);
+        EXPECT_EQ(0, memcmp(original.getPixelBox(face, 0).data, top.data, top.getConsecutiveSize()));
+
+        // Every level averages 2x2 pixels of the one above, dropping odd rows and columns
+        for (size_t mip = 1; mip <= image.getNumMipmaps(); ++mip)
+        {
+            PixelBox src = image.getPixelBox(face, mip - 1);
+            PixelBox dst = image.getPixelBox(face, mip);
+            const uchar* s = static_cast<const uchar*>(src.data);
+            const uchar* d = static_cast<const uchar*>(dst.data);
+            for (size_t y = 0; y < dst.getHeight(); ++y)
+            {
+                size_t y1 = std::min<size_t>(2 * y, src.getHeight() - 1), y2 = std::min<size_t>(2 * y + 1, src.getHeight() - 1);
+                for (size_t x = 0; x < dst.getWidth(); ++x)
+                {
+                    size_t x1 = std::min<size_t>(2 * x, src.getWidth() - 1), x2 = std::min<size_t>(2 * x + 1, src.getWidth() - 1);
+                    for (size_t k = 0; k < 4; ++k)
+                    {
+                        int sum = s[(y1 * src.getWidth() + x1) * 4 + k] + s[(y1 * src.getWidth() + x2) * 4 + k] +
+                            s[(y2 * src.getWidth() + x1) * 4 + k] + s[(y2 * src.getWidth() + x2) * 4 + k];
+                        ASSERT_EQ((sum + 2) / 4, d[(y * dst.getWidth() + x) * 4 + k])
+                            << "face " << face << " mip " << mip << " at " << x << "," << y;
+                    }
+                }
+            }
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST(ImageTests, GenerateMipmapsGammaCorrected)
+{
+    // Black and white checkerboard with a 50% alpha
+    Image image;
+    createRandomImage(image, 16, 16, PF_A8B8G8R8);
+    for (size_t y = 0; y < 16; ++y)
+        for (size_t x = 0; x < 16; ++x)
+            image.setColourAt((x + y) % 2 ? ColourValue(1, 1, 1, 0.5f) : ColourValue(0, 0, 0, 0.5f), x, y, 0);
+    Image linear = image;
+
+    ASSERT_TRUE(image.generateMipmaps(true));
+    ASSERT_TRUE(linear.generateMipmaps(false));
+
+    // Averaging in linear space gives a brighter grey, alpha is untouched
+    uchar expected = (uchar)(255 * (1.055f * Math::Pow(0.5f, 1 / 2.4f) - 0.055f) + 0.5f);
+    const uchar* gamma = static_cast<const uchar*>(image.getPixelBox(0, 1).data);
+    EXPECT_NEAR(expected, gamma[0], 1);
+    EXPECT_NEAR(expected, gamma[1], 1);
+    EXPECT_NEAR(expected, gamma[2], 1);
+    EXPECT_EQ(128, gamma[3]);
+
+    const uchar* plain = static_cast<const uchar*>(linear.getPixelBox(0, 1).data);
+    EXPECT_EQ(128, plain[0]);
+    EXPECT_EQ(128, plain[3]);
+}
+//--------------------------------------------------------------------------
+TEST(ImageTests, GenerateMipmapsThreaded)
+{
+    const PixelFormat formats[] = { PF_R8G8B8A8, PF_R8G8B8, PF_FLOAT32_RGB, PF_R5G6B5 };
+    for (size_t i = 0; i < 4; ++i)
+    {
+        Image serial;
+        createRandomImage(serial, 1024, 700, formats[i]);
+        Image threaded = serial;
+
+        ASSERT_TRUE(serial.generateMipmaps());
+        PixelUtil::setNumWorkerThreads(4);
+        ASSERT_TRUE(threaded.generateMipmaps());
+        PixelUtil::setNumWorkerThreads(0);
+
+        ASSERT_EQ(serial.getSize(), threaded.getSize());
+        EXPECT_EQ(0, memcmp(serial.getData(), threaded.getData(), serial.getSize()))
+            << PixelUtil::getFormatName(formats[i]);
+    }
+}
+//--------------------------------------------------------------------------
+TEST(ImageTests, GenerateMipmapsRejectsCompressed)
+{
+    Image image;
+    image.loadDynamicImage(OGRE_ALLOC_T(uchar, 8, MEMCATEGORY_GENERAL), 4, 4, 1, PF_DXT1, true);
+    EXPECT_FALSE(image.generateMipmaps());
+    EXPECT_EQ(0u, image.getNumMipmaps());
+}
+//--------------------------------------------------------------------------
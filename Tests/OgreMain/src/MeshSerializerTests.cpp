@@ -45,6 +45,7 @@ THE SOFTWARE.
 #include "OgreMaterialManager.h"
 #include "OgreLodStrategyManager.h"
 #include "OgreSkeleton.h"
+#include "OgreTimer.h"
 
 
 //#define I_HAVE_LOT_OF_FREE_TIME
@@ -225,6 +226,107 @@ TEST_F(MeshSerializerTests,Mesh_Version_1_3)
     testMesh(MESH_VERSION_1_0);
 }
 //--------------------------------------------------------------------------
+namespace {
+    /// Starts measuring the peak memory use of the process anew, if supported
+    void resetPeakMemory()
+    {
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX
+        std::ofstream clearRefs("/proc/self/clear_refs");
+        clearRefs << "5";
+#endif
+    }
+
+    /// Peak resident set size in kB since the last resetPeakMemory, 0 if unknown
+    size_t getPeakMemory()
+    {
+#if OGRE_PLATFORM == OGRE_PLATFORM_LINUX
+        std::ifstream status("/proc/self/status");
+        String line;
+        while (std::getline(status, line))
+        {
+            if (StringUtil::startsWith(line, "VmHWM:", false))
+                return StringConverter::parseUnsignedLong(line.substr(6));
+        }
+#endif
+        return 0;
+    }
+
+    /// Imports the file of a mesh into a new mesh, opened as a mapped file or as a file stream
+    MeshPtr importMeshFile(MeshSerializer& serializer, Mesh* source, bool mapped,
+        const String& name)
+    {
+        FileSystemArchive::setMemoryMapping(mapped);
+        DataStreamPtr stream = ResourceGroupManager::getSingleton().openResource(
+            source->getName(), source->getGroup());
+        FileSystemArchive::setMemoryMapping(false);
+        EXPECT_EQ(mapped, dynamic_cast<MemoryMappedDataStream*>(stream.get()) != 0);
+
+        MeshManager::getSingleton().remove(name);
+        MeshPtr mesh = MeshManager::getSingleton().createManual(name, source->getGroup());
+        serializer.importMesh(stream, mesh.get());
+        return mesh;
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(MeshSerializerTests,Mesh_MemoryMapped)
+{
+    MeshSerializer serializer;
+    serializer.exportMesh(mOrigMesh.get(), mMeshFullPath);
+
+    // A file stream has to be read into locked buffers
+    MeshPtr streamed = importMeshFile(serializer, mMesh.get(), false, "Streamed.mesh");
+    EXPECT_EQ(0u, serializer.getNumDirectBufferReads());
+
+    // The vertex and index data of a mapped file go straight to the buffers
+    size_t numBuffers = mOrigMesh->sharedVertexData ?
+        mOrigMesh->sharedVertexData->vertexBufferBinding->getBufferCount() : 0;
+    for (unsigned short i = 0; i < mOrigMesh->getNumSubMeshes(); ++i)
+    {
+        SubMesh* sub = mOrigMesh->getSubMesh(i);
+        if (!sub->useSharedVertices)
+            numBuffers += sub->vertexData->vertexBufferBinding->getBufferCount();
+        if (sub->indexData->indexCount)
+            ++numBuffers;
+    }
+    ASSERT_GT(numBuffers, 0u);
+    MeshPtr mesh = importMeshFile(serializer, mMesh.get(), true, "Mapped.mesh");
+    EXPECT_GE(serializer.getNumDirectBufferReads(), numBuffers);
+    assertMeshClone(streamed.get(), mesh.get());
+
+    // Unless the data needs endian conversion
+    serializer.exportMesh(mOrigMesh.get(), mMeshFullPath,
+        OGRE_ENDIAN == OGRE_ENDIAN_BIG ? Serializer::ENDIAN_LITTLE : Serializer::ENDIAN_BIG);
+    mesh = importMeshFile(serializer, mMesh.get(), true, "Mapped.mesh");
+    EXPECT_EQ(0u, serializer.getNumDirectBufferReads());
+    assertMeshClone(streamed.get(), mesh.get());
+
+    MeshManager::getSingleton().remove(mesh->getHandle());
+    MeshManager::getSingleton().remove(streamed->getHandle());
+
+    // Report the cost of loading through a file stream and from the mapped file
+    serializer.exportMesh(mOrigMesh.get(), mMeshFullPath);
+    const int numLoads = 10;
+    Timer timer;
+    for (int mapped = 0; mapped < 2; ++mapped)
+    {
+        FileSystemArchive::setMemoryMapping(mapped != 0);
+        resetPeakMemory();
+        timer.reset();
+        for (int i = 0; i < numLoads; ++i)
+            mMesh->reload();
+        unsigned long loadTime = timer.getMicroseconds() / numLoads;
+        size_t peakMemory = getPeakMemory();
+        FileSystemArchive::setMemoryMapping(false);
+
+        assertMeshClone(mOrigMesh.get(), mMesh.get());
+
+        const char* mode = mapped ? "Mapped" : "Streamed";
+        RecordProperty(String(mode) + "LoadMicroseconds", static_cast<int>(loadTime));
+        if (peakMemory)
+            RecordProperty(String(mode) + "PeakMemoryKB", static_cast<int>(peakMemory));
+    }
+}
+//--------------------------------------------------------------------------
 #ifdef I_HAVE_LOT_OF_FREE_TIME
 TEST_F(MeshSerializerTests,Mesh_Version_1_2)
 {
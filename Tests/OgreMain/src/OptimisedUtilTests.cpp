@@ -0,0 +1,361 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "OgreOptimisedUtil.h"
+#include "OgreMatrix4.h"
+#include "OgreVector4.h"
+#include "OgrePlane.h"
+#include "OgrePlatformInformation.h"
+
+using namespace Ogre;
+
+// Every SIMD implementation which is built in and supported by the CPU is
+// checked against the general one. Vertex counts are not multiples of the
+// SIMD widths so the remainder paths run too.
+
+static const float TOLERANCE = 1e-4f;
+// The SSE implementation normalises through the 12 bit _mm_rsqrt_ps estimate
+static const float RSQRT_TOLERANCE = 1e-3f;
+
+//--------------------------------------------------------------------------
+struct NamedImplementation
+{
+    const char* name;
+    OptimisedUtil* impl;
+};
+typedef vector<NamedImplementation>::type ImplementationList;
+//--------------------------------------------------------------------------
+static ImplementationList getSIMDImplementations()
+{
+    const NamedImplementation all[] = {
+        { "SSE", OptimisedUtil::_getImplementation(OptimisedUtil::IMPL_SSE) },
+        { "AVX2", OptimisedUtil::_getImplementation(OptimisedUtil::IMPL_AVX2) }
+    };
+    ImplementationList ret;
+    for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); ++i)
+    {
+        if (all[i].impl)
+            ret.push_back(all[i]);
+    }
+    return ret;
+}
+//--------------------------------------------------------------------------
+static OptimisedUtil* getGeneral()
+{
+    return OptimisedUtil::_getImplementation(OptimisedUtil::IMPL_GENERAL);
+}
+//--------------------------------------------------------------------------
+static float randomFloat(uint32& seed)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return (float)(seed >> 8) / (float)(1 << 24) * 2.0f - 1.0f;
+}
+//--------------------------------------------------------------------------
+static Matrix4 randomAffineMatrix(uint32& seed)
+{
+    Quaternion q(randomFloat(seed), randomFloat(seed), randomFloat(seed), randomFloat(seed));
+    q.normalise();
+    Matrix4 m;
+    m.makeTransform(Vector3(randomFloat(seed), randomFloat(seed), randomFloat(seed)) * 10,
+        Vector3(1.5f), q);
+    return m;
+}
+//--------------------------------------------------------------------------
+static void expectFloatsNear(const float* expected, const float* actual, size_t count,
+    float tolerance = TOLERANCE)
+{
+    for (size_t i = 0; i < count; ++i)
+        EXPECT_NEAR(expected[i], actual[i], tolerance * std::max(1.0f, Math::Abs(expected[i])));
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,GeneralAlwaysAvailable)
+{
+    EXPECT_TRUE(getGeneral() != 0);
+    EXPECT_TRUE(OptimisedUtil::getImplementation() != 0);
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,SoftwareVertexSkinning)
+{
+    const size_t numVertices = 37;
+    const size_t numWeights = 3;
+    uint32 seed = 1;
+
+    OGRE_SIMD_ALIGNED_DECL(Matrix4, matrices[4]);
+    const Matrix4* blendMatrices[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        matrices[i] = randomAffineMatrix(seed);
+        blendMatrices[i] = &matrices[i];
+    }
+
+    // Shared position/normal buffer, separate weights and indices
+    vector<float>::type src(numVertices * 6);
+    vector<float>::type weights(numVertices * numWeights);
+    vector<unsigned char>::type indices(numVertices * numWeights);
+    for (size_t v = 0; v < numVertices; ++v)
+    {
+        for (int i = 0; i < 6; ++i)
+            src[v * 6 + i] = randomFloat(seed) * 5;
+        float total = 0;
+        for (size_t w = 0; w < numWeights; ++w)
+        {
+            // Some zero weights, which have to be skipped
+            float weight = (v + w) % 4 == 0 ? 0 : Math::Abs(randomFloat(seed)) + 0.1f;
+            weights[v * numWeights + w] = weight;
+            indices[v * numWeights + w] = (unsigned char)((v + w) % 4);
+            total += weight;
+        }
+        for (size_t w = 0; w < numWeights; ++w)
+            weights[v * numWeights + w] /= total;
+    }
+
+    // Positions and normals, then positions only
+    for (int withNormals = 1; withNormals >= 0; --withNormals)
+    {
+        vector<float>::type expected(numVertices * 6), actual(numVertices * 6);
+        getGeneral()->softwareVertexSkinning(
+            &src[0], &expected[0], withNormals ? &src[3] : 0, &expected[3],
+            &weights[0], &indices[0], blendMatrices,
+            6 * sizeof(float), 6 * sizeof(float), 6 * sizeof(float), 6 * sizeof(float),
+            numWeights * sizeof(float), numWeights, numWeights, numVertices);
+
+        ImplementationList impls = getSIMDImplementations();
+        for (size_t i = 0; i < impls.size(); ++i)
+        {
+            SCOPED_TRACE(impls[i].name);
+            std::fill(actual.begin(), actual.end(), 0.0f);
+            impls[i].impl->softwareVertexSkinning(
+                &src[0], &actual[0], withNormals ? &src[3] : 0, &actual[3],
+                &weights[0], &indices[0], blendMatrices,
+                6 * sizeof(float), 6 * sizeof(float), 6 * sizeof(float), 6 * sizeof(float),
+                numWeights * sizeof(float), numWeights, numWeights, numVertices);
+            for (size_t v = 0; v < numVertices; ++v)
+            {
+                expectFloatsNear(&expected[v * 6], &actual[v * 6], 3);
+                if (withNormals)
+                    expectFloatsNear(&expected[v * 6 + 3], &actual[v * 6 + 3], 3, RSQRT_TOLERANCE);
+            }
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,SoftwareVertexMorph)
+{
+    const size_t numVertices = 29;
+    const Real t = 0.3f;
+    uint32 seed = 2;
+
+    // Packed positions only, then interleaved positions and normals
+    for (int stride = 3; stride <= 6; stride += 3)
+    {
+        bool morphNormals = stride == 6;
+        vector<float>::type src1(numVertices * stride), src2(numVertices * stride);
+        vector<float>::type expected(numVertices * stride), actual(numVertices * stride);
+        for (size_t i = 0; i < src1.size(); ++i)
+        {
+            src1[i] = randomFloat(seed) * 10;
+            src2[i] = randomFloat(seed) * 10;
+        }
+
+        getGeneral()->softwareVertexMorph(
+            t, &src1[0], &src2[0], &expected[0],
+            stride * sizeof(float), stride * sizeof(float), stride * sizeof(float),
+            numVertices, morphNormals);
+
+        ImplementationList impls = getSIMDImplementations();
+        for (size_t i = 0; i < impls.size(); ++i)
+        {
+            SCOPED_TRACE(impls[i].name);
+            std::fill(actual.begin(), actual.end(), 0.0f);
+            impls[i].impl->softwareVertexMorph(
+                t, &src1[0], &src2[0], &actual[0],
+                stride * sizeof(float), stride * sizeof(float), stride * sizeof(float),
+                numVertices, morphNormals);
+            expectFloatsNear(&expected[0], &actual[0], expected.size());
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,ConcatenateAffineMatrices)
+{
+    const size_t numMatrices = 11;
+    uint32 seed = 3;
+
+    OGRE_SIMD_ALIGNED_DECL(Matrix4, src[numMatrices]);
+    OGRE_SIMD_ALIGNED_DECL(Matrix4, expected[numMatrices]);
+    OGRE_SIMD_ALIGNED_DECL(Matrix4, actual[numMatrices]);
+    Matrix4 base = randomAffineMatrix(seed);
+    for (size_t i = 0; i < numMatrices; ++i)
+        src[i] = randomAffineMatrix(seed);
+
+    getGeneral()->concatenateAffineMatrices(base, src, expected, numMatrices);
+
+    ImplementationList impls = getSIMDImplementations();
+    for (size_t i = 0; i < impls.size(); ++i)
+    {
+        SCOPED_TRACE(impls[i].name);
+        impls[i].impl->concatenateAffineMatrices(base, src, actual, numMatrices);
+        for (size_t m = 0; m < numMatrices; ++m)
+        {
+            for (int r = 0; r < 4; ++r)
+            {
+                for (int c = 0; c < 4; ++c)
+                    EXPECT_NEAR(expected[m][r][c], actual[m][r][c], TOLERANCE * 100);
+            }
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,FaceNormalsAndLightFacing)
+{
+    const size_t numPositions = 20;
+    const size_t numTriangles = 29;
+    uint32 seed = 4;
+
+    vector<float>::type positions(numPositions * 3);
+    for (size_t i = 0; i < positions.size(); ++i)
+        positions[i] = randomFloat(seed) * 10;
+
+    vector<EdgeData::Triangle>::type triangles(numTriangles);
+    for (size_t i = 0; i < numTriangles; ++i)
+    {
+        triangles[i].vertIndex[0] = i % numPositions;
+        triangles[i].vertIndex[1] = (i * 7 + 1) % numPositions;
+        triangles[i].vertIndex[2] = (i * 3 + 5) % numPositions;
+    }
+
+    const Vector4 lightPos(3, -2, 5, 1);
+    OGRE_SIMD_ALIGNED_DECL(Vector4, expectedNormals[numTriangles]);
+    OGRE_SIMD_ALIGNED_DECL(Vector4, actualNormals[numTriangles]);
+    char expectedFacings[numTriangles], actualFacings[numTriangles];
+    getGeneral()->calculateFaceNormals(&positions[0], &triangles[0], expectedNormals, numTriangles);
+    getGeneral()->calculateLightFacing(lightPos, expectedNormals, expectedFacings, numTriangles);
+
+    ImplementationList impls = getSIMDImplementations();
+    for (size_t i = 0; i < impls.size(); ++i)
+    {
+        SCOPED_TRACE(impls[i].name);
+        impls[i].impl->calculateFaceNormals(&positions[0], &triangles[0], actualNormals, numTriangles);
+        for (size_t f = 0; f < numTriangles; ++f)
+            expectFloatsNear(expectedNormals[f].ptr(), actualNormals[f].ptr(), 4);
+
+        // Same normals in, so that only the facing test is compared
+        impls[i].impl->calculateLightFacing(lightPos, expectedNormals, actualFacings, numTriangles);
+        for (size_t f = 0; f < numTriangles; ++f)
+        {
+            // Rounding may differ for faces edge on to the light
+            if (Math::Abs(lightPos.dotProduct(expectedNormals[f])) > TOLERANCE)
+            {
+                EXPECT_EQ(expectedFacings[f] != 0, actualFacings[f] != 0);
+            }
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,ExtrudeVertices)
+{
+    const size_t numVertices = 19;
+    const Real extrudeDist = 100;
+    uint32 seed = 5;
+
+    vector<float>::type src(numVertices * 3), expected(numVertices * 3), actual(numVertices * 3);
+    for (size_t i = 0; i < src.size(); ++i)
+        src[i] = randomFloat(seed) * 10;
+
+    // Directional, then point light
+    const Vector4 lights[2] = { Vector4(1, -3, 2, 0), Vector4(4, 5, -6, 1) };
+    for (int l = 0; l < 2; ++l)
+    {
+        getGeneral()->extrudeVertices(lights[l], extrudeDist, &src[0], &expected[0], numVertices);
+
+        ImplementationList impls = getSIMDImplementations();
+        for (size_t i = 0; i < impls.size(); ++i)
+        {
+            SCOPED_TRACE(impls[i].name);
+            std::fill(actual.begin(), actual.end(), 0.0f);
+            impls[i].impl->extrudeVertices(lights[l], extrudeDist, &src[0], &actual[0], numVertices);
+            expectFloatsNear(&expected[0], &actual[0], expected.size(), RSQRT_TOLERANCE);
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,CullAxisAlignedBoxes)
+{
+    const size_t numBoxes = 37;
+    const size_t boxStride = 40;
+    uint32 seed = 6;
+
+    OGRE_SIMD_ALIGNED_DECL(float, boxes[6 * boxStride]);
+    for (size_t i = 0; i < 6 * boxStride; ++i)
+        boxes[i] = i < 3 * boxStride ? randomFloat(seed) * 20 : Math::Abs(randomFloat(seed)) * 3;
+
+    // A box around the origin
+    Plane planes[6];
+    for (int p = 0; p < 6; ++p)
+    {
+        Vector3 normal = Vector3::ZERO;
+        normal[p / 2] = (p % 2) ? -1 : 1;
+        planes[p] = Plane(normal, -8);
+    }
+
+    unsigned char expected[numBoxes], actual[numBoxes];
+    size_t expectedVisible = getGeneral()->cullAxisAlignedBoxes(
+        planes, 6, boxes, boxStride, expected, numBoxes);
+    // Both outcomes must be covered
+    EXPECT_GT(expectedVisible, 0u);
+    EXPECT_LT(expectedVisible, numBoxes);
+
+    ImplementationList impls = getSIMDImplementations();
+    for (size_t i = 0; i < impls.size(); ++i)
+    {
+        SCOPED_TRACE(impls[i].name);
+        memset(actual, 0xff, sizeof(actual));
+        EXPECT_EQ(expectedVisible, impls[i].impl->cullAxisAlignedBoxes(
+            planes, 6, boxes, boxStride, actual, numBoxes));
+        for (size_t b = 0; b < numBoxes; ++b)
+            EXPECT_EQ(expected[b], actual[b]);
+    }
+}
+//--------------------------------------------------------------------------
+TEST(OptimisedUtilTests,AVXFeaturesImplyOSSupport)
+{
+#if OGRE_CPU == OGRE_CPU_X86
+    // AVX2 and FMA are only reported together with usable AVX state
+    uint features = PlatformInformation::getCpuFeatures();
+    if (features & (PlatformInformation::CPU_FEATURE_AVX2 | PlatformInformation::CPU_FEATURE_FMA))
+    {
+        EXPECT_TRUE((features & PlatformInformation::CPU_FEATURE_AVX) != 0);
+    }
+    // The AVX2 implementation is never handed out without CPU support
+    if ((features & (PlatformInformation::CPU_FEATURE_AVX2 | PlatformInformation::CPU_FEATURE_FMA)) !=
+        (PlatformInformation::CPU_FEATURE_AVX2 | PlatformInformation::CPU_FEATURE_FMA))
+    {
+        EXPECT_TRUE(OptimisedUtil::_getImplementation(OptimisedUtil::IMPL_AVX2) == 0);
+    }
+#endif
+}
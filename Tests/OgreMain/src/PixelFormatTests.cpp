@@ -26,6 +26,7 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "PixelFormatTests.h"
+#include "OgreImage.h"
 #include <cstdlib>
 #include <iomanip>
 
@@ -223,3 +224,89 @@ TEST_F(PixelFormatTests,BulkConversion)
 }
 //--------------------------------------------------------------------------
 
+TEST_F(PixelFormatTests,FloatHalfConversion)
+{
+    // Mostly ordinary values, with a few tiny and huge ones in between
+    float* values = reinterpret_cast<float*>(mRandomData);
+    for(int x=0; x<mSize/4; x++)
+        values[x] = (rand() % 2001 - 1000) * 0.0625f;
+    values[5] = 0.0f;
+    values[17] = 1e-6f;
+    values[42] = -1e-9f;
+    values[99] = 1e6f;
+
+    testCase(PF_FLOAT32_R, PF_FLOAT16_R);
+    testCase(PF_FLOAT32_GR, PF_FLOAT16_GR);
+    testCase(PF_FLOAT32_RGB, PF_FLOAT16_RGB);
+    testCase(PF_FLOAT32_RGBA, PF_FLOAT16_RGBA);
+
+    // Random bits make for plenty of denormals, infinities and NaNs
+    srand(1);
+    for(int x=0; x<mSize; x++)
+        mRandomData[x] = (uint8)rand();
+
+    testCase(PF_FLOAT16_R, PF_FLOAT32_R);
+    testCase(PF_FLOAT16_GR, PF_FLOAT32_GR);
+    testCase(PF_FLOAT16_RGB, PF_FLOAT32_RGB);
+    testCase(PF_FLOAT16_RGBA, PF_FLOAT32_RGBA);
+}
+//--------------------------------------------------------------------------
+TEST_F(PixelFormatTests,ThreadedConversion)
+{
+    const uint32 width = 1000, height = 700;
+    vector<uint8>::type src(width * height * 4), dst1(width * height * 4), dst2(width * height * 4);
+    for(size_t x=0; x<src.size(); x++)
+        src[x] = (uint8)rand();
+
+    const PixelFormat formats[][2] = {
+        {PF_R8G8B8, PF_A8B8G8R8}, {PF_A8R8G8B8, PF_R8G8B8A8}, {PF_A8R8G8B8, PF_R5G6B5}};
+    for(size_t i=0; i<3; i++)
+    {
+        // Convert a sub-box, so the bands don't start at the top of the image.
+        // Same as converting on a single thread, which BulkConversion checks
+        PixelBox srcBox = PixelBox(width, height, 1, formats[i][0], &src[0]).getSubVolume(
+            Box(3, 5, width - 2, height - 1), false);
+        PixelBox dstBox = PixelBox(width, height, 1, formats[i][1], &dst1[0]).getSubVolume(
+            Box(1, 2, width - 4, height - 4), false);
+        PixelBox refBox = PixelBox(width, height, 1, formats[i][1], &dst2[0]).getSubVolume(
+            Box(1, 2, width - 4, height - 4), false);
+
+        PixelUtil::setNumWorkerThreads(4);
+        PixelUtil::bulkPixelConversion(srcBox, dstBox);
+        PixelUtil::setNumWorkerThreads(0);
+        PixelUtil::bulkPixelConversion(srcBox, refBox);
+
+        EXPECT_TRUE(dst1 == dst2) << PixelUtil::getFormatName(formats[i][0]) << "->"
+            << PixelUtil::getFormatName(formats[i][1]);
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(PixelFormatTests,BilinearScale)
+{
+    const uint32 srcWidth = 333, srcHeight = 1001, dstWidth = 1024, dstHeight = 700;
+    vector<uint8>::type src(srcWidth * srcHeight * 4), dst(dstWidth * dstHeight * 4);
+    for(size_t x=0; x<src.size(); x++)
+        src[x] = (uint8)rand();
+
+    // Threaded and possibly SIMD four channel scale
+    PixelUtil::setNumWorkerThreads(4);
+    Image::scale(PixelBox(srcWidth, srcHeight, 1, PF_A8R8G8B8, &src[0]),
+        PixelBox(dstWidth, dstHeight, 1, PF_A8R8G8B8, &dst[0]), Image::FILTER_BILINEAR);
+    PixelUtil::setNumWorkerThreads(0);
+
+    // Must match scaling every channel on its own
+    vector<uint8>::type srcChannel(srcWidth * srcHeight), dstChannel(dstWidth * dstHeight);
+    for(size_t k=0; k<4; k++)
+    {
+        for(size_t x=0; x<srcChannel.size(); x++)
+            srcChannel[x] = src[x * 4 + k];
+        Image::scale(PixelBox(srcWidth, srcHeight, 1, PF_L8, &srcChannel[0]),
+            PixelBox(dstWidth, dstHeight, 1, PF_L8, &dstChannel[0]), Image::FILTER_BILINEAR);
+
+        size_t mismatches = 0;
+        for(size_t x=0; x<dstChannel.size(); x++)
+            mismatches += dstChannel[x] != dst[x * 4 + k];
+        EXPECT_EQ(0u, mismatches) << "channel " << k;
+    }
+}
+//--------------------------------------------------------------------------
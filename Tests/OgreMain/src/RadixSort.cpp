@@ -71,6 +71,15 @@ public:
     }
 };
 //--------------------------------------------------------------------------
+class Uint64SortFunctor
+{
+public:
+    uint64 operator()(const uint64& p) const
+    {
+        return p;
+    }
+};
+//--------------------------------------------------------------------------
 TEST_F(RadixSortTests,FloatVector)
 {
     std::vector<float> container;
@@ -203,5 +212,29 @@ TEST_F(RadixSortTests,IntVector)
     }
 }
 //--------------------------------------------------------------------------
+TEST_F(RadixSortTests,Uint64Vector)
+{
+    std::vector<uint64> container;
+    RadixSort<std::vector<uint64>, uint64, uint64> sorter;
+
+    // Packed keys, the middle bytes are the same for all of them
+    for (int i = 0; i < 1000; ++i)
+    {
+        uint64 high = (uint64)Math::RangeRandom(0, 1e9);
+        uint64 low = (uint64)Math::RangeRandom(0, 255);
+        container.push_back((high << 32) | 0x00ABCD00 | low);
+    }
+
+    sorter.sort(container, Uint64SortFunctor());
+
+    std::vector<uint64>::iterator v = container.begin();
+    uint64 lastValue = *v++;
+    for (;v != container.end(); ++v)
+    {
+        EXPECT_TRUE(*v >= lastValue);
+        lastValue = *v;
+    }
+}
+//--------------------------------------------------------------------------
 
 
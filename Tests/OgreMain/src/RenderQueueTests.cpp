@@ -0,0 +1,233 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "RootWithoutRenderSystemFixture.h"
+#include "OgreRenderQueueSortingGrouping.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgreSceneManager.h"
+#include "OgreCamera.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture RenderQueueTests;
+
+namespace {
+    /// Renderable which is only ever queued, never drawn
+    class TestRenderable : public Renderable
+    {
+    public:
+        TestRenderable(const MaterialPtr& material, const Vector3& position)
+            : mPosition(position), mMaterial(material) {}
+
+        const MaterialPtr& getMaterial(void) const { return mMaterial; }
+        void getRenderOperation(RenderOperation& op) {}
+        void getWorldTransforms(Matrix4* xform) const { xform->makeTrans(mPosition); }
+        Real getSquaredViewDepth(const Camera* cam) const
+        {
+            return mPosition.squaredDistance(cam->getDerivedPosition());
+        }
+        const LightList& getLights(void) const { return mLights; }
+
+        Vector3 mPosition;
+
+    private:
+        MaterialPtr mMaterial;
+        LightList mLights;
+    };
+
+    typedef std::pair<const Pass*, Renderable*> VisitedPair;
+
+    /// Records the visited pairs and how often each pass was visited
+    class RecordingVisitor : public QueuedRenderableVisitor
+    {
+    public:
+        RecordingVisitor() : mPass(0) {}
+
+        void visit(RenderablePass* rp) { visited.push_back(VisitedPair(rp->pass, rp->renderable)); }
+        bool visit(const Pass* p)
+        {
+            mPass = p;
+            ++passVisits[p];
+            return true;
+        }
+        void visit(Renderable* r) { visited.push_back(VisitedPair(mPass, r)); }
+
+        vector<VisitedPair>::type visited;
+        map<const Pass*, int>::type passVisits;
+
+    private:
+        const Pass* mPass;
+    };
+
+    class RetainedQueueTest
+    {
+    public:
+        RetainedQueueTest()
+        {
+            mSceneMgr = Root::getSingleton().createSceneManager(ST_GENERIC);
+            mCamera = mSceneMgr->createCamera("Camera");
+            mCamera->setPosition(Vector3(0, 0, 500));
+
+            for (int i = 0; i < 4; ++i)
+            {
+                MaterialPtr mat = MaterialManager::getSingleton().create(
+                    "RenderQueueTests/" + StringConverter::toString(i),
+                    ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME).staticCast<Material>();
+                mat->getTechnique(0)->getPass(0)->createTextureUnitState(
+                    "test" + StringConverter::toString(i) + ".png");
+                // Unloaded materials do not update their hashes on their own
+                mat->getTechnique(0)->getPass(0)->_recalculateHash();
+                mMaterials.push_back(mat);
+            }
+            for (int i = 0; i < 40; ++i)
+            {
+                mRenderables.push_back(new TestRenderable(mMaterials[i % 4],
+                    Vector3(0, (Real)(i % 7), (Real)(i * 37 % 101))));
+            }
+        }
+
+        ~RetainedQueueTest()
+        {
+            for (size_t i = 0; i < mRenderables.size(); ++i)
+                delete mRenderables[i];
+            Root::getSingleton().destroySceneManager(mSceneMgr);
+        }
+
+        /// Fills both collections with every renderable but the excluded ones
+        void fill(QueuedRenderableCollection& a, QueuedRenderableCollection& b, size_t excludeFrom,
+            size_t excludeTo)
+        {
+            a.clear();
+            b.clear();
+            for (size_t i = 0; i < mRenderables.size(); ++i)
+            {
+                if (i >= excludeFrom && i < excludeTo)
+                    continue;
+                Pass* pass = mRenderables[i]->getMaterial()->getTechnique(0)->getPass(0);
+                a.addRenderable(pass, mRenderables[i]);
+                b.addRenderable(pass, mRenderables[i]);
+            }
+            a.sort(mCamera);
+            b.sort(mCamera);
+        }
+
+        SceneManager* mSceneMgr;
+        Camera* mCamera;
+        vector<MaterialPtr>::type mMaterials;
+        vector<TestRenderable*>::type mRenderables;
+    };
+}
+//--------------------------------------------------------------------------
+TEST_F(RenderQueueTests,RetainedPassGroups)
+{
+    RetainedQueueTest test;
+    QueuedRenderableCollection rebuilt, retained;
+    rebuilt.addOrganisationMode(QueuedRenderableCollection::OM_PASS_GROUP);
+    retained.addOrganisationMode(QueuedRenderableCollection::OM_PASS_GROUP);
+    retained.setRetainedMode(true);
+
+    // Unchanged, then some renderables gone, then back in a different order
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        if (frame == 2)
+            std::reverse(test.mRenderables.begin(), test.mRenderables.end());
+        test.fill(rebuilt, retained, frame == 1 ? 10 : 0, frame == 1 ? 25 : 0);
+
+        RecordingVisitor expected, actual;
+        rebuilt.acceptVisitor(&expected, QueuedRenderableCollection::OM_PASS_GROUP);
+        retained.acceptVisitor(&actual, QueuedRenderableCollection::OM_PASS_GROUP);
+
+        // Same pairs, every pass visited once, near objects first within a pass
+        ASSERT_EQ(expected.visited.size(), actual.visited.size());
+        std::sort(expected.visited.begin(), expected.visited.end());
+        vector<VisitedPair>::type sorted = actual.visited;
+        std::sort(sorted.begin(), sorted.end());
+        EXPECT_TRUE(expected.visited == sorted);
+        EXPECT_TRUE(expected.passVisits == actual.passVisits);
+        for (size_t i = 1; i < actual.visited.size(); ++i)
+        {
+            if (actual.visited[i].first != actual.visited[i - 1].first)
+                continue;
+            EXPECT_LE(actual.visited[i - 1].second->getSquaredViewDepth(test.mCamera) * 0.99f,
+                actual.visited[i].second->getSquaredViewDepth(test.mCamera));
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(RenderQueueTests,RetainedDepthSort)
+{
+    RetainedQueueTest test;
+    QueuedRenderableCollection rebuilt, retained;
+    rebuilt.addOrganisationMode(QueuedRenderableCollection::OM_SORT_DESCENDING);
+    retained.addOrganisationMode(QueuedRenderableCollection::OM_SORT_DESCENDING);
+    retained.setRetainedMode(true);
+
+    // The second fill sees the scene from the other side
+    for (int frame = 0; frame < 2; ++frame)
+    {
+        if (frame == 1)
+            test.mCamera->setPosition(Vector3(0, 0, -500));
+        test.fill(rebuilt, retained, 0, 0);
+
+        RecordingVisitor expected, actual;
+        rebuilt.acceptVisitor(&expected, QueuedRenderableCollection::OM_SORT_ASCENDING);
+        retained.acceptVisitor(&actual, QueuedRenderableCollection::OM_SORT_ASCENDING);
+        ASSERT_EQ(expected.visited.size(), actual.visited.size());
+        for (size_t i = 0; i < actual.visited.size(); ++i)
+        {
+            EXPECT_EQ(expected.visited[i].second->getSquaredViewDepth(test.mCamera),
+                actual.visited[i].second->getSquaredViewDepth(test.mCamera));
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(RenderQueueTests,RetainedClearAndRemovePass)
+{
+    RetainedQueueTest test;
+    QueuedRenderableCollection retained;
+    retained.addOrganisationMode(QueuedRenderableCollection::OM_PASS_GROUP);
+    retained.setRetainedMode(true);
+
+    Pass* removedPass = test.mMaterials[0]->getTechnique(0)->getPass(0);
+    for (size_t i = 0; i < test.mRenderables.size(); ++i)
+        retained.addRenderable(test.mRenderables[i]->getMaterial()->getTechnique(0)->getPass(0),
+            test.mRenderables[i]);
+    retained.sort(test.mCamera);
+    retained.removePassGroup(removedPass);
+
+    RecordingVisitor afterRemove;
+    retained.acceptVisitor(&afterRemove, QueuedRenderableCollection::OM_PASS_GROUP);
+    EXPECT_EQ(test.mRenderables.size() * 3 / 4, afterRemove.visited.size());
+    EXPECT_EQ(0u, afterRemove.passVisits.count(removedPass));
+
+    // Nothing visited until queued again, even without sorting
+    retained.clear();
+    RecordingVisitor afterClear;
+    retained.acceptVisitor(&afterClear, QueuedRenderableCollection::OM_PASS_GROUP);
+    EXPECT_TRUE(afterClear.visited.empty());
+}
@@ -0,0 +1,99 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <Ogre.h>
+#include "RootWithoutRenderSystemFixture.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreMeshManager.h"
+#include "OgreSkeletonManager.h"
+#include "OgreMesh.h"
+#include "OgreSkeleton.h"
+#include "OgreConfigFile.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture ResourceGroupManagerTests;
+
+namespace {
+    const String GROUP_NAME = "ConcurrentPrepare";
+
+    /// Group holding the test model, with both its mesh and its skeleton declared
+    void createModelGroup(FileSystemLayer* fsLayer)
+    {
+        ConfigFile cf;
+        cf.load(fsLayer->getConfigFilePath("resources.cfg"));
+        String modelPath = cf.getSettings("Tests").begin()->second + "/Model1";
+
+        ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+        rgm.createResourceGroup(GROUP_NAME);
+        rgm.addResourceLocation(modelPath, "FileSystem", GROUP_NAME);
+        rgm.declareResource("UniqueModel.MESH", "Mesh", GROUP_NAME);
+        rgm.declareResource("UniqueModel.MESH.skeleton", "Skeleton", GROUP_NAME);
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(ResourceGroupManagerTests, ConcurrentPrepareThenSerialLoad)
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    createModelGroup(mFSLayer);
+    rgm.initialiseResourceGroup(GROUP_NAME);
+    rgm.setNumWorkerThreads(4);
+
+    rgm.prepareResourceGroup(GROUP_NAME);
+    MeshPtr mesh = MeshManager::getSingleton().getByName("UniqueModel.MESH", GROUP_NAME);
+    SkeletonPtr skeleton = SkeletonManager::getSingleton().getByName("UniqueModel.MESH.skeleton", GROUP_NAME);
+    ASSERT_FALSE(mesh.isNull());
+    ASSERT_FALSE(skeleton.isNull());
+    EXPECT_EQ(Resource::LOADSTATE_PREPARED, mesh->getLoadingState());
+    EXPECT_EQ(Resource::LOADSTATE_PREPARED, skeleton->getLoadingState());
+
+    rgm.loadResourceGroup(GROUP_NAME);
+    EXPECT_TRUE(mesh->isLoaded());
+    EXPECT_TRUE(skeleton->isLoaded());
+    EXPECT_GT(mesh->getNumSubMeshes(), 0u);
+    EXPECT_GT(skeleton->getNumBones(), 0u);
+
+    mesh.setNull();
+    skeleton.setNull();
+    rgm.destroyResourceGroup(GROUP_NAME);
+    rgm.setNumWorkerThreads(0);
+}
+//--------------------------------------------------------------------------
+TEST_F(ResourceGroupManagerTests, ConcurrentPrepareFailureIsReported)
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    createModelGroup(mFSLayer);
+    rgm.declareResource("Missing.mesh", "Mesh", GROUP_NAME);
+    rgm.initialiseResourceGroup(GROUP_NAME);
+    rgm.setNumWorkerThreads(4);
+
+    // The workers swallow the error, the serial pass has to raise it
+    EXPECT_THROW(rgm.loadResourceGroup(GROUP_NAME), Exception);
+
+    rgm.destroyResourceGroup(GROUP_NAME);
+    rgm.setNumWorkerThreads(0);
+}
@@ -0,0 +1,605 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <Ogre.h>
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture SceneManagerTests;
+
+namespace {
+    /// Builds identical hierarchies, every node carrying a small object so it has bounds
+    void buildHierarchy(SceneManager* sceneMgr, SceneNode* parent, int depth, vector<SceneNode*>::type& nodes)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            const Real offset = Real(nodes.size() % 7);
+            SceneNode* node = parent->createChildSceneNode(Vector3(offset, Real(i), -offset),
+                Quaternion(Degree(Real(15 * i)), Vector3::UNIT_Y));
+            node->setScale(Vector3(1 + Real(i) / 4));
+
+            ManualObject* obj = sceneMgr->createManualObject();
+            obj->begin("BaseWhite", RenderOperation::OT_POINT_LIST);
+            obj->position(-1, -1, -1);
+            obj->position(1, Real(i), 1);
+            obj->end();
+            node->attachObject(obj);
+
+            nodes.push_back(node);
+            if (depth > 1)
+                buildHierarchy(sceneMgr, node, depth - 1, nodes);
+        }
+    }
+
+    void expectSameState(const vector<SceneNode*>::type& expected, const vector<SceneNode*>::type& actual)
+    {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            EXPECT_EQ(expected[i]->_getDerivedPosition(), actual[i]->_getDerivedPosition());
+            EXPECT_EQ(expected[i]->_getDerivedOrientation(), actual[i]->_getDerivedOrientation());
+            EXPECT_EQ(expected[i]->_getWorldAABB(), actual[i]->_getWorldAABB());
+        }
+    }
+}
+
+TEST_F(SceneManagerTests, ParallelUpdateMatchesSerialUpdate)
+{
+    SceneManager* serialMgr = mRoot->createSceneManager(ST_GENERIC);
+    SceneManager* parallelMgr = mRoot->createSceneManager(ST_GENERIC);
+    parallelMgr->setNumWorkerThreads(3);
+    parallelMgr->setParallelUpdateDepth(2);
+
+    vector<SceneNode*>::type serialNodes, parallelNodes;
+    buildHierarchy(serialMgr, serialMgr->getRootSceneNode(), 4, serialNodes);
+    buildHierarchy(parallelMgr, parallelMgr->getRootSceneNode(), 4, parallelNodes);
+
+    serialMgr->_updateSceneGraph(NULL);
+    parallelMgr->_updateSceneGraph(NULL);
+    expectSameState(serialNodes, parallelNodes);
+    EXPECT_EQ(serialMgr->getRootSceneNode()->_getWorldAABB(),
+              parallelMgr->getRootSceneNode()->_getWorldAABB());
+
+    // Move a few nodes above, at and below the split depth so only
+    // selected branches get updated
+    const size_t moved[] = { 0, 2, 7, 85, 200, 339 };
+    for (size_t i = 0; i < sizeof(moved) / sizeof(moved[0]); ++i)
+    {
+        serialNodes[moved[i]]->translate(Vector3(3, -2, 1));
+        parallelNodes[moved[i]]->translate(Vector3(3, -2, 1));
+    }
+
+    serialMgr->_updateSceneGraph(NULL);
+    parallelMgr->_updateSceneGraph(NULL);
+    expectSameState(serialNodes, parallelNodes);
+    EXPECT_EQ(serialMgr->getRootSceneNode()->_getWorldAABB(),
+              parallelMgr->getRootSceneNode()->_getWorldAABB());
+
+    mRoot->destroySceneManager(parallelMgr);
+    mRoot->destroySceneManager(serialMgr);
+}
+
+namespace {
+    void expectNearState(const vector<SceneNode*>::type& expected, const vector<SceneNode*>::type& actual)
+    {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            EXPECT_TRUE(expected[i]->_getDerivedPosition().positionEquals(
+                actual[i]->_getDerivedPosition(), 1e-4f));
+            // Quaternion::equals goes through acos, too coarse for float
+            // rounding near identical rotations, compare the dot product instead
+            EXPECT_NEAR(1, Math::Abs(expected[i]->_getDerivedOrientation().Dot(
+                actual[i]->_getDerivedOrientation())), 1e-6f);
+            EXPECT_TRUE(expected[i]->_getDerivedScale().positionEquals(
+                actual[i]->_getDerivedScale(), 1e-4f));
+
+            const Matrix4& m0 = expected[i]->_getFullTransform();
+            const Matrix4& m1 = actual[i]->_getFullTransform();
+            for (size_t r = 0; r < 4; ++r)
+                for (size_t c = 0; c < 4; ++c)
+                    EXPECT_NEAR(m0[r][c], m1[r][c], 1e-4f);
+        }
+    }
+}
+
+TEST_F(SceneManagerTests, TransformStorageMatchesNodeUpdate)
+{
+    SceneManager* nodeMgr = mRoot->createSceneManager(ST_GENERIC);
+    SceneManager* storageMgr = mRoot->createSceneManager(ST_GENERIC);
+    storageMgr->setTransformStorageEnabled(true);
+    EXPECT_TRUE(storageMgr->isTransformStorageEnabled());
+
+    vector<SceneNode*>::type nodes, storageNodes;
+    buildHierarchy(nodeMgr, nodeMgr->getRootSceneNode(), 4, nodes);
+    buildHierarchy(storageMgr, storageMgr->getRootSceneNode(), 4, storageNodes);
+
+    nodeMgr->_updateSceneGraph(NULL);
+    storageMgr->_updateSceneGraph(NULL);
+    expectNearState(nodes, storageNodes);
+
+    // Local changes, inheritance flags and reparenting across levels
+    vector<SceneNode*>::type* sets[] = { &nodes, &storageNodes };
+    for (size_t s = 0; s < 2; ++s)
+    {
+        vector<SceneNode*>::type& n = *sets[s];
+        n[1]->yaw(Degree(30));
+        n[6]->setInheritOrientation(false);
+        n[90]->setInheritScale(false);
+        n[300]->translate(Vector3(0, 5, 0));
+
+        // Move a whole branch one level up
+        n[22]->getParentSceneNode()->removeChild(n[22]);
+        n[0]->addChild(n[22]);
+    }
+
+    nodeMgr->_updateSceneGraph(NULL);
+    storageMgr->_updateSceneGraph(NULL);
+    expectNearState(nodes, storageNodes);
+
+    // Detached nodes leave the storage, destroyed ones too
+    storageNodes[5]->getParentSceneNode()->removeChild(storageNodes[5]);
+    nodes[5]->getParentSceneNode()->removeChild(nodes[5]);
+    storageMgr->destroySceneNode(storageNodes[340 - 1]);
+    nodeMgr->destroySceneNode(nodes[340 - 1]);
+    storageNodes.pop_back();
+    nodes.pop_back();
+
+    nodeMgr->_updateSceneGraph(NULL);
+    storageMgr->_updateSceneGraph(NULL);
+    expectNearState(nodes, storageNodes);
+
+    // Changes made after the bulk update fall back to the per node path
+    nodes[3]->roll(Degree(10));
+    storageNodes[3]->roll(Degree(10));
+    expectNearState(nodes, storageNodes);
+
+    storageMgr->setTransformStorageEnabled(false);
+    EXPECT_FALSE(storageMgr->isTransformStorageEnabled());
+
+    mRoot->destroySceneManager(storageMgr);
+    mRoot->destroySceneManager(nodeMgr);
+}
+
+TEST_F(SceneManagerTests, TransformStorageKeepsLocalTransform)
+{
+    SceneManager* sceneMgr = mRoot->createSceneManager(ST_GENERIC);
+    SceneNode* node = sceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(1, 2, 3));
+    node->setScale(2, 2, 2);
+    node->roll(Degree(45));
+    const Quaternion orientation = node->getOrientation();
+
+    // Registering moves the local transform into the storage
+    sceneMgr->setTransformStorageEnabled(true);
+    EXPECT_EQ(Vector3(1, 2, 3), node->getPosition());
+    EXPECT_EQ(orientation, node->getOrientation());
+    EXPECT_EQ(Vector3(2, 2, 2), node->getScale());
+
+    // Enough siblings to grow the level and to move the slot on removal
+    vector<SceneNode*>::type siblings;
+    SceneNode* first = sceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(4, 5, 6));
+    for (int i = 0; i < 100; ++i)
+        siblings.push_back(sceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(Real(i), 0, 0)));
+    node->translate(Vector3(1, 1, 1));
+    EXPECT_EQ(Vector3(2, 3, 4), node->getPosition());
+    EXPECT_EQ(Vector3(2, 2, 2), node->getScale());
+
+    sceneMgr->destroySceneNode(first);
+    EXPECT_EQ(Vector3(99, 0, 0), siblings.back()->getPosition());
+    sceneMgr->_updateSceneGraph(NULL);
+    EXPECT_EQ(Vector3(2, 3, 4), node->_getDerivedPosition());
+    EXPECT_EQ(Vector3(99, 0, 0), siblings.back()->_getDerivedPosition());
+
+    // Detached nodes and disabling the storage hand the transform back
+    sceneMgr->getRootSceneNode()->removeChild(siblings[10]);
+    EXPECT_EQ(Vector3(10, 0, 0), siblings[10]->getPosition());
+    sceneMgr->setTransformStorageEnabled(false);
+    EXPECT_EQ(Vector3(2, 3, 4), node->getPosition());
+    EXPECT_EQ(orientation, node->getOrientation());
+    EXPECT_EQ(Vector3(2, 2, 2), node->getScale());
+
+    sceneMgr->getRootSceneNode()->addChild(siblings[10]);
+    mRoot->destroySceneManager(sceneMgr);
+}
+
+TEST_F(SceneManagerTests, TransformStorageWithParallelUpdate)
+{
+    SceneManager* serialMgr = mRoot->createSceneManager(ST_GENERIC);
+    SceneManager* parallelMgr = mRoot->createSceneManager(ST_GENERIC);
+    parallelMgr->setTransformStorageEnabled(true);
+    parallelMgr->setNumWorkerThreads(3);
+    parallelMgr->setParallelUpdateDepth(2);
+
+    vector<SceneNode*>::type serialNodes, parallelNodes;
+    buildHierarchy(serialMgr, serialMgr->getRootSceneNode(), 4, serialNodes);
+    buildHierarchy(parallelMgr, parallelMgr->getRootSceneNode(), 4, parallelNodes);
+
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        for (size_t i = frame; i < serialNodes.size(); i += 7)
+        {
+            serialNodes[i]->translate(Vector3(1, 0, -1));
+            parallelNodes[i]->translate(Vector3(1, 0, -1));
+            serialNodes[i]->pitch(Degree(5));
+            parallelNodes[i]->pitch(Degree(5));
+        }
+        serialMgr->_updateSceneGraph(NULL);
+        parallelMgr->_updateSceneGraph(NULL);
+        expectNearState(serialNodes, parallelNodes);
+    }
+
+    mRoot->destroySceneManager(parallelMgr);
+    mRoot->destroySceneManager(serialMgr);
+}
+
+TEST_F(SceneManagerTests, BatchedCullingMatchesCameraVisibility)
+{
+    SceneManager* sceneMgr = mRoot->createSceneManager(ST_GENERIC);
+    sceneMgr->setBatchedCullingEnabled(true);
+
+    // A grid of nodes around the camera, each with a child further out, carrying
+    // hidden objects so they have bounds without adding anything to the queue
+    vector<SceneNode*>::type nodes;
+    for (int x = -20; x < 20; ++x)
+    {
+        for (int z = -20; z < 20; ++z)
+        {
+            SceneNode* node = sceneMgr->getRootSceneNode()->createChildSceneNode(
+                Vector3(Real(x * 10), Real((x + z) % 5), Real(z * 10)));
+            nodes.push_back(node);
+            nodes.push_back(node->createChildSceneNode(Vector3(3, 0, -7)));
+        }
+    }
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        ManualObject* obj = sceneMgr->createManualObject();
+        obj->begin("BaseWhite", RenderOperation::OT_POINT_LIST);
+        obj->position(-1, -1, -1);
+        obj->position(1, 1, 1);
+        obj->end();
+        obj->setVisible(false);
+        nodes[i]->attachObject(obj);
+    }
+    sceneMgr->_updateSceneGraph(NULL);
+
+    Camera* cam = sceneMgr->createCamera("Cam");
+    cam->setNearClipDistance(1);
+    cam->setFarClipDistance(150);
+    cam->yaw(Degree(30));
+
+    unsigned int expectedVisible = 0;
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        if (cam->isVisible(nodes[i]->_getWorldAABB()))
+            ++expectedVisible;
+    }
+    ASSERT_GT(expectedVisible, 0u);
+    ASSERT_LT(expectedVisible, nodes.size());
+
+    // Enough boxes to be split among the worker threads
+    sceneMgr->setNumWorkerThreads(3);
+    sceneMgr->_findVisibleObjects(cam, NULL, false);
+    EXPECT_EQ(expectedVisible, cam->_getNumVisibleNodes());
+    EXPECT_EQ(nodes.size() - expectedVisible, cam->_getNumCulledNodes());
+
+    sceneMgr->setNumWorkerThreads(0);
+    sceneMgr->_findVisibleObjects(cam, NULL, false);
+    EXPECT_EQ(expectedVisible, cam->_getNumVisibleNodes());
+    EXPECT_EQ(nodes.size() - expectedVisible, cam->_getNumCulledNodes());
+
+    // Infinite far plane
+    cam->setFarClipDistance(0);
+    expectedVisible = 0;
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        if (cam->isVisible(nodes[i]->_getWorldAABB()))
+            ++expectedVisible;
+    }
+    sceneMgr->_findVisibleObjects(cam, NULL, false);
+    EXPECT_EQ(expectedVisible, cam->_getNumVisibleNodes());
+
+    mRoot->destroySceneManager(sceneMgr);
+}
+
+namespace {
+    /// A strip of vertices skinned to the two bones of an animated skeleton
+    MeshPtr createSkinnedMesh(size_t numVertices)
+    {
+        SkeletonPtr skel = SkeletonManager::getSingleton().create("SkinnedStrip.skeleton",
+            ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, true);
+        Bone* root = skel->createBone("Root");
+        Bone* tip = root->createChild(1, Vector3(0, 5, 0));
+        skel->setBindingPose();
+
+        Animation* anim = skel->createAnimation("Bend", 1);
+        NodeAnimationTrack* rootTrack = anim->createNodeTrack(root->getHandle(), root);
+        NodeAnimationTrack* tipTrack = anim->createNodeTrack(tip->getHandle(), tip);
+        for (int k = 0; k <= 2; ++k)
+        {
+            TransformKeyFrame* key = rootTrack->createNodeKeyFrame(Real(k) / 2);
+            key->setTranslate(Vector3(Real(k), 0, 0));
+            key = tipTrack->createNodeKeyFrame(Real(k) / 2);
+            key->setRotation(Quaternion(Degree(Real(40 * k)), Vector3::UNIT_Z));
+        }
+
+        MeshPtr mesh = MeshManager::getSingleton().createManual("SkinnedStrip.mesh",
+            ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME);
+        mesh->sharedVertexData = OGRE_NEW VertexData();
+        VertexDeclaration* decl = mesh->sharedVertexData->vertexDeclaration;
+        decl->addElement(0, 0, VET_FLOAT3, VES_POSITION);
+        decl->addElement(0, sizeof(float) * 3, VET_FLOAT3, VES_NORMAL);
+        HardwareVertexBufferSharedPtr vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+            decl->getVertexSize(0), numVertices, HardwareBuffer::HBU_STATIC, true);
+        mesh->sharedVertexData->vertexBufferBinding->setBinding(0, vbuf);
+        mesh->sharedVertexData->vertexCount = numVertices;
+
+        float* data = static_cast<float*>(vbuf->lock(HardwareBuffer::HBL_DISCARD));
+        for (size_t v = 0; v < numVertices; ++v)
+        {
+            const Real height = Real(v) * 10 / numVertices;
+            *data++ = Real(v % 3) - 1; *data++ = height; *data++ = 0;
+            *data++ = 0; *data++ = 0; *data++ = 1;
+
+            VertexBoneAssignment vba;
+            vba.vertexIndex = static_cast<unsigned int>(v);
+            vba.boneIndex = root->getHandle();
+            vba.weight = 1 - height / 10;
+            mesh->addBoneAssignment(vba);
+            vba.boneIndex = tip->getHandle();
+            vba.weight = height / 10;
+            mesh->addBoneAssignment(vba);
+        }
+        vbuf->unlock();
+
+        SubMesh* sub = mesh->createSubMesh();
+        sub->useSharedVertices = true;
+        sub->indexData->indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+            HardwareIndexBuffer::IT_16BIT, 3, HardwareBuffer::HBU_STATIC, true);
+        sub->indexData->indexCount = 3;
+        uint16 indices[3] = { 0, 1, 2 };
+        sub->indexData->indexBuffer->writeData(0, sizeof(indices), indices);
+
+        mesh->_setBounds(AxisAlignedBox(-10, -10, -10, 10, 20, 10));
+        mesh->setSkeletonName(skel->getName());
+        mesh->_compileBoneAssignments();
+        return mesh;
+    }
+
+    vector<float>::type getSkinnedPositions(Entity* entity)
+    {
+        const VertexData* data = entity->_getSkelAnimVertexData();
+        const VertexElement* posElem = data->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        HardwareVertexBufferSharedPtr buf = data->vertexBufferBinding->getBuffer(posElem->getSource());
+
+        vector<float>::type positions;
+        unsigned char* vertex = static_cast<unsigned char*>(buf->lock(HardwareBuffer::HBL_READ_ONLY));
+        for (size_t v = 0; v < data->vertexCount; ++v, vertex += buf->getVertexSize())
+        {
+            float* pos;
+            posElem->baseVertexPointerToElement(vertex, &pos);
+            positions.insert(positions.end(), pos, pos + 3);
+        }
+        buf->unlock();
+        return positions;
+    }
+}
+
+TEST_F(SceneManagerTests, ParallelAnimationMatchesSerialAnimation)
+{
+    // Enough vertices for the skinning of one entity to be split
+    MeshPtr mesh = createSkinnedMesh(5000);
+
+    SceneManager* serialMgr = mRoot->createSceneManager(ST_GENERIC);
+    SceneManager* parallelMgr = mRoot->createSceneManager(ST_GENERIC);
+    parallelMgr->setNumWorkerThreads(3);
+    EXPECT_FALSE(parallelMgr->isParallelAnimationEnabled());
+    parallelMgr->setParallelAnimationEnabled(true);
+
+    SceneManager* mgrs[] = { serialMgr, parallelMgr };
+    vector<Entity*>::type entities[2];
+    Camera* cams[2];
+    for (int m = 0; m < 2; ++m)
+    {
+        for (int i = 0; i < 6; ++i)
+        {
+            Entity* entity = mgrs[m]->createEntity(mesh);
+            mgrs[m]->getRootSceneNode()->createChildSceneNode(
+                Vector3(Real(i * 20 - 50), 0, -100))->attachObject(entity);
+            AnimationState* state = entity->getAnimationState("Bend");
+            state->setEnabled(true);
+            state->setTimePosition(Real(i) / 6);
+            entities[m].push_back(entity);
+        }
+        cams[m] = mgrs[m]->createCamera("Cam");
+        cams[m]->setNearClipDistance(1);
+    }
+
+    for (int frame = 0; frame < 2; ++frame)
+    {
+        serialMgr->_updateSceneGraph(cams[0]);
+        parallelMgr->_updateSceneGraph(cams[1]);
+        parallelMgr->_updateAnimations(cams[1]);
+
+        for (size_t i = 0; i < entities[0].size(); ++i)
+        {
+            entities[0][i]->_updateAnimation();
+            // Already skinned by the worker threads
+            vector<float>::type parallelPositions = getSkinnedPositions(entities[1][i]);
+            EXPECT_EQ(getSkinnedPositions(entities[0][i]), parallelPositions);
+
+            // Nothing left to do on the rendering thread
+            entities[1][i]->_updateAnimation();
+            EXPECT_EQ(parallelPositions, getSkinnedPositions(entities[1][i]));
+        }
+
+        mRoot->_fireFrameRenderingQueued();
+        for (int m = 0; m < 2; ++m)
+        {
+            for (size_t i = 0; i < entities[m].size(); ++i)
+                entities[m][i]->getAnimationState("Bend")->addTime(Real(0.3));
+        }
+    }
+
+    mRoot->destroySceneManager(parallelMgr);
+    mRoot->destroySceneManager(serialMgr);
+
+    // Before the buffer manager goes away
+    SkeletonManager::getSingleton().remove(mesh->getSkeletonName());
+    MeshManager::getSingleton().remove(mesh->getHandle());
+}
+
+namespace {
+    /// Counts how often the entities are scanned for animation candidates
+    class CountingSceneManager : public DefaultSceneManager
+    {
+    public:
+        CountingSceneManager() : DefaultSceneManager("Counting"), mCollected(0) {}
+
+        int mCollected;
+        const vector<Entity*>::type& getAnimationCandidates() const { return mAnimationCandidates; }
+
+    protected:
+        void collectAnimationCandidates(void)
+        {
+            ++mCollected;
+            DefaultSceneManager::collectAnimationCandidates();
+        }
+    };
+}
+
+TEST_F(SceneManagerTests, AnimationCandidatesAreCollectedOncePerFrame)
+{
+    MeshPtr mesh = createSkinnedMesh(10);
+    MeshPtr plane = MeshManager::getSingleton().createPlane("StillPlane.mesh",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, Plane(Vector3::UNIT_Z, 0), 10, 10);
+    {
+        CountingSceneManager sceneMgr;
+        sceneMgr.setNumWorkerThreads(2);
+        sceneMgr.setParallelAnimationEnabled(true);
+
+        SceneNode* root = sceneMgr.getRootSceneNode();
+        Entity* skinned = sceneMgr.createEntity(mesh);
+        root->createChildSceneNode(Vector3(0, 0, -100))->attachObject(skinned);
+        root->createChildSceneNode(Vector3(0, 0, -100))->attachObject(sceneMgr.createEntity(plane));
+        Camera* front = sceneMgr.createCamera("Front");
+        Camera* back = sceneMgr.createCamera("Back");
+        back->yaw(Degree(180));
+        sceneMgr._updateSceneGraph(front);
+
+        // One scan serves every camera of the frame
+        sceneMgr._updateAnimations(front);
+        sceneMgr._updateAnimations(back);
+        EXPECT_EQ(1, sceneMgr.mCollected);
+        ASSERT_EQ(1u, sceneMgr.getAnimationCandidates().size());
+        EXPECT_EQ(skinned, sceneMgr.getAnimationCandidates()[0]);
+
+        mRoot->_fireFrameRenderingQueued();
+        sceneMgr._updateAnimations(front);
+        EXPECT_EQ(2, sceneMgr.mCollected);
+
+        // Adding or removing entities does not wait for the next frame
+        Entity* other = sceneMgr.createEntity(mesh);
+        sceneMgr._updateAnimations(front);
+        EXPECT_EQ(3, sceneMgr.mCollected);
+        EXPECT_EQ(2u, sceneMgr.getAnimationCandidates().size());
+        sceneMgr.destroyEntity(other);
+        sceneMgr._updateAnimations(front);
+        EXPECT_EQ(4, sceneMgr.mCollected);
+        EXPECT_EQ(1u, sceneMgr.getAnimationCandidates().size());
+    }
+
+    SkeletonManager::getSingleton().remove(mesh->getSkeletonName());
+    MeshManager::getSingleton().remove(mesh->getHandle());
+    MeshManager::getSingleton().remove(plane->getHandle());
+}
+
+namespace {
+    /// Exposes the multi draw batching checks
+    class MultiDrawSceneManager : public DefaultSceneManager
+    {
+    public:
+        MultiDrawSceneManager() : DefaultSceneManager("MultiDraw") {}
+        using SceneManager::isMultiDrawCandidate;
+        using SceneManager::isMultiDrawCompatible;
+    };
+}
+
+TEST_F(SceneManagerTests, MultiDrawBatchesOnlySharedBuffers)
+{
+    MultiDrawSceneManager sceneMgr;
+    sceneMgr.setFlipCullingOnNegativeScale(true);
+
+    MeshPtr plane = MeshManager::getSingleton().createPlane("MultiDrawPlane.mesh",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, Plane(Vector3::UNIT_Z, 0), 10, 10);
+    MeshPtr otherPlane = MeshManager::getSingleton().createPlane("MultiDrawOtherPlane.mesh",
+        ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, Plane(Vector3::UNIT_Z, 0), 10, 10);
+
+    SceneNode* root = sceneMgr.getRootSceneNode();
+    Entity* a = sceneMgr.createEntity(plane);
+    Entity* b = sceneMgr.createEntity(plane);
+    Entity* c = sceneMgr.createEntity(otherPlane);
+    Entity* mirrored = sceneMgr.createEntity(plane);
+    root->createChildSceneNode(Vector3(1, 0, 0))->attachObject(a);
+    root->createChildSceneNode(Vector3(0, 0, 5))->attachObject(b);
+    root->createChildSceneNode()->attachObject(c);
+    SceneNode* mirroredNode = root->createChildSceneNode();
+    mirroredNode->setScale(-1, 1, 1);
+    mirroredNode->attachObject(mirrored);
+    sceneMgr._updateSceneGraph(NULL);
+
+    // No supported techniques without a render system
+    const Pass* pass = MaterialManager::getSingleton().getByName("BaseWhite")->getTechnique(0)->getPass(0);
+
+    // Same vertex and index buffers, only the world matrix differs
+    EXPECT_TRUE(sceneMgr.isMultiDrawCompatible(pass, a->getSubEntity(0), b->getSubEntity(0), false));
+    // Equal layout but buffers of their own
+    EXPECT_FALSE(sceneMgr.isMultiDrawCompatible(pass, a->getSubEntity(0), c->getSubEntity(0), false));
+    // Would need the culling mode flipped
+    EXPECT_FALSE(sceneMgr.isMultiDrawCompatible(pass, a->getSubEntity(0), mirrored->getSubEntity(0), false));
+    sceneMgr.setFlipCullingOnNegativeScale(false);
+    EXPECT_TRUE(sceneMgr.isMultiDrawCompatible(pass, a->getSubEntity(0), mirrored->getSubEntity(0), false));
+
+    // Fixed function passes have no way to read the per draw data
+    EXPECT_FALSE(pass->hasVertexProgram());
+    EXPECT_FALSE(sceneMgr.isMultiDrawCandidate(pass, a->getSubEntity(0)));
+
+    sceneMgr.clearScene();
+    MeshManager::getSingleton().remove(plane->getHandle());
+    MeshManager::getSingleton().remove(otherPlane->getHandle());
+}
+
+TEST_F(SceneManagerTests, MultiDrawIsOptInPerQueueGroup)
+{
+    SceneManager* sceneMgr = mRoot->createSceneManager(ST_GENERIC);
+    RenderQueueGroup* group = sceneMgr->getRenderQueue()->getQueueGroup(RENDER_QUEUE_MAIN);
+    EXPECT_FALSE(group->getMultiDrawEnabled());
+    group->setMultiDrawEnabled(true);
+    EXPECT_TRUE(group->getMultiDrawEnabled());
+    EXPECT_FALSE(sceneMgr->getRenderQueue()->getQueueGroup(RENDER_QUEUE_OVERLAY)->getMultiDrawEnabled());
+    mRoot->destroySceneManager(sceneMgr);
+}
@@ -0,0 +1,375 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include "RootWithoutRenderSystemFixture.h"
+#include "OgreScriptCompiler.h"
+#include "OgreScriptParser.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgrePass.h"
+#include "OgreStringConverter.h"
+
+using namespace Ogre;
+
+namespace {
+    const String CACHE_FILE = "ScriptCompilerTests.cache";
+    const String SCRIPT =
+        "import * from \"base.material\"\n"
+        "material Test : Base\n"
+        "{\n"
+        "    set $diffuse \"1 0 0\"\n"
+        "    technique\n"
+        "    {\n"
+        "        pass { diffuse $diffuse }\n"
+        "    }\n"
+        "}\n";
+
+    ConcreteNodeListPtr parse(const String& str)
+    {
+        ScriptLexer lexer;
+        ScriptParser parser;
+        return parser.parse(lexer.tokenize(str, "test.material"));
+    }
+
+    void expectEqualNodes(const ConcreteNodeList& expected, const ConcreteNodeList& actual,
+        const ConcreteNode* parent)
+    {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (ConcreteNodeList::const_iterator e = expected.begin(), a = actual.begin();
+            e != expected.end(); ++e, ++a)
+        {
+            EXPECT_EQ((*e)->token, (*a)->token);
+            EXPECT_EQ((*e)->file, (*a)->file);
+            EXPECT_EQ((*e)->line, (*a)->line);
+            EXPECT_EQ((*e)->type, (*a)->type);
+            EXPECT_EQ(parent, (*a)->parent);
+            expectEqualNodes((*e)->children, (*a)->children, (*a).get());
+        }
+    }
+
+    const String SCRIPT_DIR = "ScriptCompilerTests.scripts";
+    const int NUM_SCRIPTS = 16;
+
+    String scriptFile(int index)
+    {
+        return SCRIPT_DIR + "/parallel" + StringConverter::toString(index) + ".material";
+    }
+
+    /// Directory of small material scripts, the last one importing from the first
+    void writeScripts()
+    {
+        FileSystemLayer::createDirectory(SCRIPT_DIR);
+        for (int i = 0; i < NUM_SCRIPTS; ++i)
+        {
+            std::ofstream out(scriptFile(i).c_str());
+            if (i == NUM_SCRIPTS - 1)
+                out << "import Parallel0 from \"parallel0.material\"\n"
+                    << "material Derived : Parallel0 {}\n";
+            out << "material Parallel" << i << "\n{\n    technique\n    {\n"
+                << "        pass { diffuse " << i << " 0 0 }\n    }\n}\n";
+        }
+    }
+
+    void removeScripts()
+    {
+        for (int i = 0; i < NUM_SCRIPTS; ++i)
+            FileSystemLayer::removeFile(scriptFile(i));
+        FileSystemLayer::removeDirectory(SCRIPT_DIR);
+    }
+
+    /// Skips every odd script and records the script events in the order they happen
+    class ScriptEventRecorder : public ResourceGroupListener, public ResourceLoadingListener
+    {
+    public:
+        StringVector events;
+
+        size_t find(const String& event) const
+        {
+            return std::find(events.begin(), events.end(), event) - events.begin();
+        }
+
+        void scriptParseStarted(const String& scriptName, bool& skipThisScript)
+        {
+            skipThisScript = StringConverter::parseInt(
+                scriptName.substr(8, scriptName.find('.') - 8)) % 2 == 1;
+            events.push_back("start " + scriptName);
+        }
+        void scriptParseEnded(const String& scriptName, bool skipped)
+        {
+            events.push_back("end " + scriptName);
+        }
+        void resourceStreamOpened(const String& name, const String& group, Resource* resource,
+            DataStreamPtr& dataStream)
+        {
+            events.push_back("open " + name);
+        }
+
+        void resourceGroupScriptingStarted(const String& groupName, size_t scriptCount) {}
+        void resourceGroupScriptingEnded(const String& groupName) {}
+        void resourceGroupLoadStarted(const String& groupName, size_t resourceCount) {}
+        void resourceLoadStarted(const ResourcePtr& resource) {}
+        void resourceLoadEnded(void) {}
+        void worldGeometryStageStarted(const String& description) {}
+        void worldGeometryStageEnded(void) {}
+        void resourceGroupLoadEnded(const String& groupName) {}
+        DataStreamPtr resourceLoading(const String& name, const String& group, Resource* resource)
+        {
+            return DataStreamPtr();
+        }
+        bool resourceCollision(Resource* resource, ResourceManager* resourceManager)
+        {
+            return false;
+        }
+    };
+
+    const String TREE_DIR = "ScriptCompilerTests.trees";
+    const String TREE_GROUP = "CachedTrees";
+
+    void writeBaseScript(const String& ambient)
+    {
+        std::ofstream out((TREE_DIR + "/base.material").c_str());
+        out << "material Base\n{\n    receive_shadows off\n    technique\n    {\n"
+            << "        pass { ambient " << ambient << " }\n    }\n}\n";
+    }
+
+    /// Compiles SCRIPT the way resource group initialisation does, returning its material
+    MaterialPtr compileScript()
+    {
+        MaterialManager::getSingleton().remove("Test");
+        DataStreamPtr stream(OGRE_NEW MemoryDataStream("test.material",
+            const_cast<char*>(SCRIPT.data()), SCRIPT.size(), false, true));
+        ScriptCompilerManager::getSingleton().parseScript(stream, TREE_GROUP);
+        return MaterialManager::getSingleton().getByName("Test", TREE_GROUP);
+    }
+
+    bool fileExists(const String& name)
+    {
+        FILE* f = fopen(name.c_str(), "rb");
+        if (f)
+            fclose(f);
+        return f != 0;
+    }
+}
+
+class ScriptCompilerTests : public RootWithoutRenderSystemFixture
+{
+public:
+    void SetUp()
+    {
+        RootWithoutRenderSystemFixture::SetUp();
+        std::remove(CACHE_FILE.c_str());
+        mManager = ScriptCompilerManager::getSingletonPtr();
+        mManager->setScriptCacheFile(CACHE_FILE);
+    }
+    void TearDown()
+    {
+        mManager->setScriptCacheFile(BLANKSTRING);
+        std::remove(CACHE_FILE.c_str());
+        RootWithoutRenderSystemFixture::TearDown();
+    }
+
+    ScriptCompilerManager* mManager;
+};
+//--------------------------------------------------------------------------
+TEST_F(ScriptCompilerTests, CachedScriptMatchesParser)
+{
+    ConcreteNodeListPtr expected = parse(SCRIPT);
+
+    // First call fills the cache, second one is restored from it
+    expectEqualNodes(*expected, *mManager->_parseScript(SCRIPT, "test.material"), 0);
+    expectEqualNodes(*expected, *mManager->_parseScript(SCRIPT, "test.material"), 0);
+}
+//--------------------------------------------------------------------------
+TEST_F(ScriptCompilerTests, CacheIsRestoredFromFile)
+{
+    mManager->_parseScript(SCRIPT, "test.material");
+    mManager->saveScriptCache();
+    ASSERT_TRUE(fileExists(CACHE_FILE));
+
+    // Reload, then remove the file: a cache hit leaves nothing to save
+    mManager->setScriptCacheFile(CACHE_FILE);
+    std::remove(CACHE_FILE.c_str());
+    expectEqualNodes(*parse(SCRIPT), *mManager->_parseScript(SCRIPT, "test.material"), 0);
+    mManager->saveScriptCache();
+    EXPECT_FALSE(fileExists(CACHE_FILE));
+}
+//--------------------------------------------------------------------------
+TEST_F(ScriptCompilerTests, ChangedScriptIsReparsed)
+{
+    mManager->_parseScript(SCRIPT, "test.material");
+    mManager->saveScriptCache();
+    mManager->setScriptCacheFile(CACHE_FILE);
+
+    String changed = SCRIPT;
+    changed.replace(changed.find("1 0 0"), 5, "0 1 0");
+    expectEqualNodes(*parse(changed), *mManager->_parseScript(changed, "test.material"), 0);
+
+    // The stale entry was replaced, so the cache needs writing again
+    std::remove(CACHE_FILE.c_str());
+    mManager->saveScriptCache();
+    EXPECT_TRUE(fileExists(CACHE_FILE));
+}
+//--------------------------------------------------------------------------
+TEST_F(ScriptCompilerTests, ParallelParsingTranslatesAllScripts)
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    writeScripts();
+    rgm.setNumWorkerThreads(4);
+    rgm.createResourceGroup("ParallelScripts", false);
+    rgm.addResourceLocation(SCRIPT_DIR, "FileSystem", "ParallelScripts");
+    rgm.initialiseResourceGroup("ParallelScripts");
+    rgm.setNumWorkerThreads(0);
+
+    for (int i = 0; i < NUM_SCRIPTS; ++i)
+    {
+        MaterialPtr mat = MaterialManager::getSingleton().getByName(
+            "Parallel" + StringConverter::toString(i), "ParallelScripts");
+        ASSERT_FALSE(mat.isNull());
+        EXPECT_EQ(ColourValue(Real(i), 0, 0), mat->getTechnique(0)->getPass(0)->getDiffuse());
+    }
+    MaterialPtr derived = MaterialManager::getSingleton().getByName("Derived", "ParallelScripts");
+    ASSERT_FALSE(derived.isNull());
+    EXPECT_EQ(ColourValue::Black, derived->getTechnique(0)->getPass(0)->getDiffuse());
+
+    rgm.destroyResourceGroup("ParallelScripts");
+    removeScripts();
+}
+//--------------------------------------------------------------------------
+TEST_F(ScriptCompilerTests, ParallelParsingOpensScriptsAfterSkipCheck)
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    ScriptEventRecorder recorder;
+    writeScripts();
+    rgm.setNumWorkerThreads(2);
+    rgm.addResourceGroupListener(&recorder);
+    rgm.setLoadingListener(&recorder);
+    rgm.createResourceGroup("ParallelScripts", false);
+    rgm.addResourceLocation(SCRIPT_DIR, "FileSystem", "ParallelScripts");
+    rgm.initialiseResourceGroup("ParallelScripts");
+    rgm.setLoadingListener(0);
+    rgm.removeResourceGroupListener(&recorder);
+    rgm.setNumWorkerThreads(0);
+
+    for (int i = 0; i < NUM_SCRIPTS; ++i)
+    {
+        String name = "parallel" + StringConverter::toString(i) + ".material";
+        size_t start = recorder.find("start " + name);
+        size_t open = recorder.find("open " + name);
+        size_t end = recorder.find("end " + name);
+        ASSERT_LT(start, end);
+        if (i % 2 == 1)
+        {
+            EXPECT_EQ(recorder.events.size(), open);
+        }
+        else
+        {
+            EXPECT_LT(start, open);
+            EXPECT_LT(open, end);
+        }
+        EXPECT_EQ(i % 2 == 1, MaterialManager::getSingleton().getByName(
+            "Parallel" + StringConverter::toString(i), "ParallelScripts").isNull());
+    }
+
+    // Scripts are opened in batches, not all before the first one is parsed
+    int opened = 0;
+    for (StringVector::iterator e = recorder.events.begin();
+        e != recorder.events.end() && !StringUtil::startsWith(*e, "end ", false); ++e)
+    {
+        if (StringUtil::startsWith(*e, "open ", false))
+            ++opened;
+    }
+    EXPECT_GT(opened, 0);
+    EXPECT_LT(opened, NUM_SCRIPTS / 2);
+
+    rgm.destroyResourceGroup("ParallelScripts");
+    removeScripts();
+}
+//--------------------------------------------------------------------------
+TEST_F(ScriptCompilerTests, CachedTreeMatchesCompile)
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    FileSystemLayer::createDirectory(TREE_DIR);
+    writeBaseScript("0 0 1");
+    rgm.createResourceGroup(TREE_GROUP, false);
+    rgm.addResourceLocation(TREE_DIR, "FileSystem", TREE_GROUP);
+
+    MaterialPtr mat = compileScript();
+    ASSERT_FALSE(mat.isNull());
+    mManager->saveScriptCache();
+
+    // Restored from the cache file, a cache hit leaves nothing to save
+    mManager->setScriptCacheFile(CACHE_FILE);
+    std::remove(CACHE_FILE.c_str());
+    MaterialPtr cached = compileScript();
+    mManager->saveScriptCache();
+    EXPECT_FALSE(fileExists(CACHE_FILE));
+
+    ASSERT_FALSE(cached.isNull());
+    EXPECT_NE(mat.get(), cached.get());
+    EXPECT_FALSE(cached->getReceiveShadows());
+    Pass* pass = cached->getTechnique(0)->getPass(0);
+    EXPECT_EQ(ColourValue(1, 0, 0), pass->getDiffuse());
+    EXPECT_EQ(ColourValue(0, 0, 1), pass->getAmbient());
+
+    rgm.destroyResourceGroup(TREE_GROUP);
+    FileSystemLayer::removeFile(TREE_DIR + "/base.material");
+    FileSystemLayer::removeDirectory(TREE_DIR);
+}
+//--------------------------------------------------------------------------
+TEST_F(ScriptCompilerTests, ChangedImportInvalidatesTree)
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    FileSystemLayer::createDirectory(TREE_DIR);
+    writeBaseScript("0 0 1");
+    rgm.createResourceGroup(TREE_GROUP, false);
+    rgm.addResourceLocation(TREE_DIR, "FileSystem", TREE_GROUP);
+
+    compileScript();
+    mManager->saveScriptCache();
+    mManager->setScriptCacheFile(CACHE_FILE);
+
+    // The script itself is unchanged, only the material it inherits from
+    writeBaseScript("0 1 0");
+    MaterialPtr mat = compileScript();
+    ASSERT_FALSE(mat.isNull());
+    EXPECT_EQ(ColourValue(0, 1, 0), mat->getTechnique(0)->getPass(0)->getAmbient());
+
+    // The tree built against the changed import replaced the stale one
+    std::remove(CACHE_FILE.c_str());
+    mManager->saveScriptCache();
+    EXPECT_TRUE(fileExists(CACHE_FILE));
+
+    rgm.destroyResourceGroup(TREE_GROUP);
+    FileSystemLayer::removeFile(TREE_DIR + "/base.material");
+    FileSystemLayer::removeDirectory(TREE_DIR);
+}
+//--------------------------------------------------------------------------
@@ -0,0 +1,220 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "RootWithoutRenderSystemFixture.h"
+#include "OgreTextureStreamer.h"
+#include "OgreTextureManager.h"
+#include "OgreHardwarePixelBuffer.h"
+#include "OgreRoot.h"
+#include "OgreTimer.h"
+
+using namespace Ogre;
+
+namespace {
+    /// Pixel buffer which ignores whatever is uploaded to it
+    class NullPixelBuffer : public HardwarePixelBuffer
+    {
+    public:
+        NullPixelBuffer(uint32 width, uint32 height, PixelFormat format)
+            : HardwarePixelBuffer(width, height, 1, format, HBU_STATIC, false, false) {}
+
+        void blitFromMemory(const PixelBox& src, const Image::Box& dstBox) {}
+        void blitToMemory(const Image::Box& srcBox, const PixelBox& dst) {}
+
+    protected:
+        PixelBox lockImpl(const Image::Box& lockBox, LockOptions options) { return PixelBox(); }
+        void unlockImpl(void) {}
+    };
+
+    /// Texture living in system memory only
+    class NullTexture : public Texture
+    {
+    public:
+        NullTexture(ResourceManager* creator, const String& name, ResourceHandle handle,
+            const String& group, bool isManual, ManualResourceLoader* loader)
+            : Texture(creator, name, handle, group, isManual, loader) {}
+        ~NullTexture() { unload(); }
+
+        HardwarePixelBufferSharedPtr getBuffer(size_t face, size_t mipmap) { return mSurfaces.at(mipmap); }
+
+    protected:
+        void loadImpl(void) {}
+        void createInternalResourcesImpl(void)
+        {
+            for (uint32 mip = 0; mip <= mNumMipmaps; ++mip)
+            {
+                mSurfaces.push_back(HardwarePixelBufferSharedPtr(OGRE_NEW NullPixelBuffer(
+                    std::max<uint32>(mWidth >> mip, 1), std::max<uint32>(mHeight >> mip, 1), mFormat)));
+            }
+        }
+        void freeInternalResourcesImpl(void) { mSurfaces.clear(); }
+
+        vector<HardwarePixelBufferSharedPtr>::type mSurfaces;
+    };
+
+    class NullTextureManager : public TextureManager
+    {
+    public:
+        NullTextureManager()
+        {
+            mResourceType = "Texture";
+            ResourceGroupManager::getSingleton()._registerResourceManager(mResourceType, this);
+        }
+        ~NullTextureManager()
+        {
+            removeAll();
+            ResourceGroupManager::getSingleton()._unregisterResourceManager(mResourceType);
+        }
+
+        PixelFormat getNativeFormat(TextureType ttype, PixelFormat format, int usage) { return format; }
+        bool isHardwareFilteringSupported(TextureType ttype, PixelFormat format, int usage,
+            bool preciseFormatOnly = false) { return true; }
+
+    protected:
+        Resource* createImpl(const String& name, ResourceHandle handle, const String& group,
+            bool isManual, ManualResourceLoader* loader, const NameValuePairList* createParams)
+        {
+            return OGRE_NEW NullTexture(this, name, handle, group, isManual, loader);
+        }
+    };
+
+    const String TEXTURE_NAME = "flare_alpha.dds";
+
+    /// Group of its own holding the sample texture, so it can be streamed more than once
+    void createTextureGroup(const String& group)
+    {
+        ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+        FileInfoListPtr files = rgm.findResourceFileInfo(
+            ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME, TEXTURE_NAME);
+        ASSERT_FALSE(files->empty());
+
+        rgm.createResourceGroup(group, false);
+        rgm.addResourceLocation(files->front().archive->getName() + "/" + files->front().path,
+            "FileSystem", group);
+        rgm.initialiseResourceGroup(group);
+    }
+}
+
+class TextureStreamerTests : public RootWithoutRenderSystemFixture
+{
+public:
+    void SetUp()
+    {
+        RootWithoutRenderSystemFixture::SetUp();
+        mTextureMgr = OGRE_NEW NullTextureManager();
+        mStreamer = TextureStreamer::getSingletonPtr();
+        mStreamer->initialise();
+        Root::getSingleton().getWorkQueue()->startup();
+
+        createTextureGroup("StreamedA");
+        createTextureGroup("StreamedB");
+        mStreamer->setMipTailSize(64);
+    }
+    void TearDown()
+    {
+        mStreamer->shutdown();
+        Root::getSingleton().getWorkQueue()->shutdown();
+        OGRE_DELETE mTextureMgr;
+        RootWithoutRenderSystemFixture::TearDown();
+    }
+
+    /// Processes responses until the texture reaches the given level or a second passes
+    void waitForMip(const TexturePtr& tex, uint8 mip)
+    {
+        Timer timer;
+        while (mStreamer->getResidentMip(tex) != mip && timer.getMilliseconds() < 1000)
+            Root::getSingleton().getWorkQueue()->processResponses();
+    }
+
+    NullTextureManager* mTextureMgr;
+    TextureStreamer* mStreamer;
+};
+//--------------------------------------------------------------------------
+TEST_F(TextureStreamerTests, LoadsMipTailOnly)
+{
+    TexturePtr tex = mStreamer->createStreamedTexture(TEXTURE_NAME, "StreamedA");
+    tex->load();
+
+    // 256x256 with 8 mipmaps, so the tail starts at the third level
+    EXPECT_TRUE(mStreamer->isStreamedTexture(tex.get()));
+    EXPECT_EQ(2, mStreamer->getResidentMip(tex));
+    EXPECT_EQ(64u, tex->getWidth());
+    EXPECT_EQ(64u, tex->getHeight());
+    EXPECT_EQ(6u, tex->getNumMipmaps());
+}
+//--------------------------------------------------------------------------
+TEST_F(TextureStreamerTests, DemandStreamsDetailedLevels)
+{
+    TexturePtr tex = mStreamer->createStreamedTexture(TEXTURE_NAME, "StreamedA");
+    tex->load();
+
+    // Nothing visible, nothing to stream
+    mStreamer->_update();
+    EXPECT_EQ(2, mStreamer->getResidentMip(tex));
+
+    // 100 pixels on screen need the 128x128 level
+    mStreamer->_notifyTextureDemand(tex.get(), 100);
+    mStreamer->_update();
+    waitForMip(tex, 1);
+    EXPECT_EQ(1, mStreamer->getResidentMip(tex));
+    EXPECT_EQ(128u, tex->getWidth());
+    EXPECT_EQ(7u, tex->getNumMipmaps());
+
+    mStreamer->_notifyTextureDemand(tex.get(), 1000);
+    mStreamer->_update();
+    waitForMip(tex, 0);
+    EXPECT_EQ(0, mStreamer->getResidentMip(tex));
+    EXPECT_EQ(256u, tex->getWidth());
+}
+//--------------------------------------------------------------------------
+TEST_F(TextureStreamerTests, BudgetEvictsLeastRecentlyUsed)
+{
+    TexturePtr first = mStreamer->createStreamedTexture(TEXTURE_NAME, "StreamedA");
+    TexturePtr second = mStreamer->createStreamedTexture(TEXTURE_NAME, "StreamedB");
+    first->load();
+    second->load();
+
+    mStreamer->_notifyTextureDemand(first.get(), 1000);
+    mStreamer->_update();
+    waitForMip(first, 0);
+    ASSERT_EQ(0, mStreamer->getResidentMip(first));
+
+    // Room for one of the two at full detail only
+    size_t budget = mStreamer->getResidentMemory();
+    mStreamer->setMemoryBudget(budget);
+
+    mStreamer->_notifyTextureDemand(second.get(), 1000);
+    mStreamer->_update();
+    waitForMip(second, 0);
+    waitForMip(first, 2);
+
+    EXPECT_EQ(0, mStreamer->getResidentMip(second));
+    EXPECT_EQ(2, mStreamer->getResidentMip(first));
+    EXPECT_LE(mStreamer->getResidentMemory(), budget);
+}
+//--------------------------------------------------------------------------
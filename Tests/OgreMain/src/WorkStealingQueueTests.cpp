@@ -0,0 +1,211 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <Ogre.h>
+#include "RootWithoutRenderSystemFixture.h"
+#include "Threading/OgreWorkStealingQueue.h"
+#include "OgreTimer.h"
+
+using namespace Ogre;
+
+typedef RootWithoutRenderSystemFixture WorkStealingQueueTests;
+
+namespace {
+    /// Doubles the request data, failing the given number of times first
+    class DoublingHandler : public WorkQueue::RequestHandler
+    {
+    public:
+        DoublingHandler() : failuresLeft(0) {}
+
+        WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+        {
+            int value = any_cast<int>(req->getData());
+            {
+                OGRE_LOCK_MUTEX(mutex);
+                handled.push_back(value);
+                if (failuresLeft)
+                {
+                    --failuresLeft;
+                    return OGRE_NEW WorkQueue::Response(req, false, Any());
+                }
+            }
+            return OGRE_NEW WorkQueue::Response(req, true, Any(value * 2));
+        }
+
+        OGRE_MUTEX(mutex);
+        vector<int>::type handled;
+        int failuresLeft;
+    };
+
+    class SummingHandler : public WorkQueue::ResponseHandler
+    {
+    public:
+        SummingHandler() : count(0), sum(0) {}
+
+        void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
+        {
+            ++count;
+            if (res->succeeded())
+                sum += any_cast<int>(res->getData());
+        }
+
+        size_t count;
+        int sum;
+    };
+
+    /// Processes responses until the expected number arrived or a second passed
+    void waitForResponses(WorkQueue& queue, SummingHandler& handler, size_t count)
+    {
+        Timer timer;
+        while (handler.count < count && timer.getMilliseconds() < 1000)
+            queue.processResponses();
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(WorkStealingQueueTests, ProcessesAllRequests)
+{
+    WorkStealingQueue queue("Test");
+    queue.setWorkerThreadCount(4);
+    queue.setResponseProcessingTimeLimit(0);
+    DoublingHandler requestHandler;
+    SummingHandler responseHandler;
+    queue.addRequestHandler(0, &requestHandler);
+    queue.addResponseHandler(0, &responseHandler);
+    queue.startup();
+
+    // More than the rings hold, so some go through the overflow queue
+    const int numRequests = 5000;
+    for (int i = 0; i < numRequests; ++i)
+        queue.addRequest(0, 0, Any(i));
+
+    waitForResponses(queue, responseHandler, numRequests);
+    EXPECT_EQ((size_t)numRequests, responseHandler.count);
+    EXPECT_EQ(numRequests * (numRequests - 1), responseHandler.sum);
+
+    queue.shutdown();
+}
+//--------------------------------------------------------------------------
+TEST_F(WorkStealingQueueTests, HigherPriorityLanesFirst)
+{
+    // No threads, the requests are processed by hand
+    WorkStealingQueue queue("Test");
+    queue.setWorkerThreadCount(0);
+    queue.setChannelPriority(1, WorkStealingQueue::PRIORITY_HIGH);
+    queue.setChannelPriority(2, WorkStealingQueue::PRIORITY_LOW);
+    EXPECT_EQ(WorkStealingQueue::PRIORITY_NORMAL, queue.getChannelPriority(0));
+    DoublingHandler requestHandler;
+    for (uint16 channel = 0; channel < 3; ++channel)
+        queue.addRequestHandler(channel, &requestHandler);
+    queue.startup();
+
+    queue.addRequest(2, 0, Any(20));
+    queue.addRequest(0, 0, Any(0));
+    queue.addRequest(1, 0, Any(10));
+    queue.addRequest(0, 0, Any(1));
+    for (int i = 0; i < 4; ++i)
+        queue._processNextRequest();
+
+    ASSERT_EQ(4u, requestHandler.handled.size());
+    EXPECT_EQ(10, requestHandler.handled[0]);
+    EXPECT_EQ(0, requestHandler.handled[1]);
+    EXPECT_EQ(1, requestHandler.handled[2]);
+    EXPECT_EQ(20, requestHandler.handled[3]);
+
+    queue.shutdown();
+}
+//--------------------------------------------------------------------------
+TEST_F(WorkStealingQueueTests, AbortedRequestsAreSkipped)
+{
+    WorkStealingQueue queue("Test");
+    queue.setWorkerThreadCount(0);
+    DoublingHandler requestHandler;
+    SummingHandler responseHandler;
+    queue.addRequestHandler(0, &requestHandler);
+    queue.addRequestHandler(1, &requestHandler);
+    queue.addResponseHandler(0, &responseHandler);
+    queue.startup();
+
+    queue.addRequest(0, 0, Any(1));
+    WorkQueue::RequestID aborted = queue.addRequest(0, 0, Any(2));
+    queue.addRequest(1, 0, Any(3));
+    queue.addRequest(0, 0, Any(4));
+    queue.abortRequest(aborted);
+    queue.abortRequestsByChannel(1);
+    // Requests added after the abort are not affected
+    queue.addRequest(1, 0, Any(5));
+    for (int i = 0; i < 5; ++i)
+        queue._processNextRequest();
+
+    ASSERT_EQ(3u, requestHandler.handled.size());
+    EXPECT_EQ(1, requestHandler.handled[0]);
+    EXPECT_EQ(4, requestHandler.handled[1]);
+    EXPECT_EQ(5, requestHandler.handled[2]);
+
+    // Responses of an aborted channel are not handed out any more
+    queue.abortRequestsByChannel(0);
+    queue.processResponses();
+    EXPECT_EQ(0u, responseHandler.count);
+
+    queue.shutdown();
+}
+//--------------------------------------------------------------------------
+TEST_F(WorkStealingQueueTests, FailedRequestsAreRetried)
+{
+    WorkStealingQueue queue("Test");
+    queue.setWorkerThreadCount(2);
+    DoublingHandler requestHandler;
+    requestHandler.failuresLeft = 2;
+    SummingHandler responseHandler;
+    queue.addRequestHandler(0, &requestHandler);
+    queue.addResponseHandler(0, &responseHandler);
+    queue.startup();
+
+    queue.addRequest(0, 0, Any(21), 2);
+    waitForResponses(queue, responseHandler, 1);
+    EXPECT_EQ(1u, responseHandler.count);
+    EXPECT_EQ(42, responseHandler.sum);
+    EXPECT_EQ(3u, requestHandler.handled.size());
+
+    queue.shutdown();
+}
+//--------------------------------------------------------------------------
+TEST_F(WorkStealingQueueTests, SynchronousRequests)
+{
+    WorkStealingQueue queue("Test");
+    queue.setWorkerThreadCount(1);
+    DoublingHandler requestHandler;
+    SummingHandler responseHandler;
+    queue.addRequestHandler(0, &requestHandler);
+    queue.addResponseHandler(0, &responseHandler);
+    queue.startup();
+
+    queue.addRequest(0, 0, Any(5), 0, true);
+    EXPECT_EQ(1u, responseHandler.count);
+    EXPECT_EQ(10, responseHandler.sum);
+
+    queue.shutdown();
+}
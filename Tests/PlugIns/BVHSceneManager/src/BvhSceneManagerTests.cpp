@@ -0,0 +1,312 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <Ogre.h>
+#include "RootWithoutRenderSystemFixture.h"
+#include "OgreWireBoundingBox.h"
+#include "OgreBvhSceneManager.h"
+
+using namespace Ogre;
+
+// The BvhSceneManager must give the same culling and query results as the
+// default SceneManager, which tests every object, on the same scene.
+
+namespace {
+    typedef vector<String>::type NameList;
+    typedef set<std::pair<String, String> >::type NamePairSet;
+
+    /// Records the objects and bounding boxes found visible. Queued renderables
+    /// are rejected, so no technique, which needs a render system, is looked at.
+    class QueuedListener : public RenderQueue::RenderableListener, public MovableObject::Listener
+    {
+    public:
+        NameList objects;
+        size_t boundingBoxes;
+
+        QueuedListener() : boundingBoxes(0) {}
+
+        bool objectRendering(const MovableObject* object, const Camera* cam)
+        {
+            objects.push_back(object->getName());
+            return true;
+        }
+
+        bool renderableQueued(Renderable* rend, uint8 groupID, ushort priority,
+            Technique** ppTech, RenderQueue* pQueue)
+        {
+            if (dynamic_cast<WireBoundingBox*>(rend))
+                ++boundingBoxes;
+            return false;
+        }
+    };
+
+    class NameCollector : public SceneQueryListener, public IntersectionSceneQueryListener
+    {
+    public:
+        NameList names;
+        vector<std::pair<String, String> >::type pairs;
+
+        bool queryResult(MovableObject* object)
+        {
+            names.push_back(object->getName());
+            return true;
+        }
+        bool queryResult(SceneQuery::WorldFragment* fragment) { return true; }
+        bool queryResult(MovableObject* first, MovableObject* second)
+        {
+            pairs.push_back(std::make_pair(first->getName(), second->getName()));
+            return true;
+        }
+        bool queryResult(MovableObject* movable, SceneQuery::WorldFragment* fragment) { return true; }
+    };
+
+    NameList sorted(NameList names)
+    {
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+    /// Pairs without their order, the default query doesn't order them like the Bvh
+    NamePairSet unordered(const vector<std::pair<String, String> >::type& pairs)
+    {
+        NamePairSet ret;
+        for (size_t i = 0; i < pairs.size(); ++i)
+            ret.insert(std::make_pair(std::min(pairs[i].first, pairs[i].second),
+                std::max(pairs[i].first, pairs[i].second)));
+        return ret;
+    }
+}
+
+class BvhSceneManagerTests : public RootWithoutRenderSystemFixture
+{
+public:
+    BvhSceneManagerFactory mFactory;
+    SceneManager* mDefaultMgr;
+    SceneManager* mBvhMgr;
+
+    void SetUp()
+    {
+        RootWithoutRenderSystemFixture::SetUp();
+        mRoot->addSceneManagerFactory(&mFactory);
+        mDefaultMgr = mRoot->createSceneManager(ST_GENERIC);
+        mBvhMgr = mRoot->createSceneManager(BvhSceneManagerFactory::FACTORY_TYPE_NAME);
+        populate(mDefaultMgr);
+        populate(mBvhMgr);
+    }
+
+    void TearDown()
+    {
+        mRoot->destroySceneManager(mBvhMgr);
+        mRoot->destroySceneManager(mDefaultMgr);
+        mRoot->removeSceneManagerFactory(&mFactory);
+        RootWithoutRenderSystemFixture::TearDown();
+    }
+
+    /// Boxes of varying size spread over the scene, some of them child nodes
+    void populate(SceneManager* sceneMgr)
+    {
+        uint32 seed = 7;
+        vector<SceneNode*>::type nodes;
+        for (int i = 0; i < 150; ++i)
+        {
+            SceneNode* parent = (i % 5 == 4) ? nodes[i / 2] : sceneMgr->getRootSceneNode();
+            // Named, the update order follows the names
+            SceneNode* node = parent->createChildSceneNode("Node" + StringConverter::toString(i),
+                Vector3(random(seed) * 100, random(seed) * 100, random(seed) * 100));
+            if (i % 11 == 0)
+                node->hideBoundingBox(true);
+
+            const Real size = 1 + Math::Abs(random(seed)) * 8;
+            ManualObject* obj = sceneMgr->createManualObject("Object" + StringConverter::toString(i));
+            obj->begin("BaseWhite", RenderOperation::OT_POINT_LIST);
+            obj->position(-size, -size, -size);
+            obj->position(size, size, size);
+            obj->end();
+            obj->setQueryFlags(i % 3 ? 1 : 2);
+            node->attachObject(obj);
+            nodes.push_back(node);
+        }
+        sceneMgr->_updateSceneGraph(NULL);
+    }
+
+    static Real random(uint32& seed)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        return (Real)(seed >> 8) / (Real)(1 << 24) * 2 - 1;
+    }
+
+    void cull(SceneManager* sceneMgr, QueuedListener& listener)
+    {
+        Camera* cam = sceneMgr->createCamera("Camera");
+        cam->setPosition(20, -10, 150);
+        cam->lookAt(-10, 5, 0);
+        cam->setNearClipDistance(1);
+        cam->setFarClipDistance(180);
+
+        SceneManager::MovableObjectIterator it =
+            sceneMgr->getMovableObjectIterator(ManualObjectFactory::FACTORY_TYPE_NAME);
+        while (it.hasMoreElements())
+            it.getNext()->setListener(&listener);
+
+        sceneMgr->showBoundingBoxes(true);
+        sceneMgr->getRenderQueue()->setRenderableListener(&listener);
+        sceneMgr->_updateSceneGraph(cam);
+        sceneMgr->_findVisibleObjects(cam, NULL, false);
+        sceneMgr->getRenderQueue()->setRenderableListener(NULL);
+        sceneMgr->getRenderQueue()->clear();
+        sceneMgr->destroyCamera(cam);
+
+        it = sceneMgr->getMovableObjectIterator(ManualObjectFactory::FACTORY_TYPE_NAME);
+        while (it.hasMoreElements())
+            it.getNext()->setListener(NULL);
+    }
+};
+//--------------------------------------------------------------------------
+TEST_F(BvhSceneManagerTests,CullingMatchesDefault)
+{
+    QueuedListener expected, actual;
+    cull(mDefaultMgr, expected);
+    cull(mBvhMgr, actual);
+
+    // Some objects are culled, others not
+    EXPECT_FALSE(expected.objects.empty());
+    EXPECT_LT(expected.objects.size(), 150u);
+    EXPECT_EQ(sorted(expected.objects), sorted(actual.objects));
+
+    // Nodes hiding their bounding box do so with showBoundingBoxes on too
+    EXPECT_LT(expected.boundingBoxes, expected.objects.size());
+    EXPECT_EQ(expected.boundingBoxes, actual.boundingBoxes);
+}
+//--------------------------------------------------------------------------
+TEST_F(BvhSceneManagerTests,VolumeQueriesMatchDefault)
+{
+    const AxisAlignedBox box(Vector3(-40, -20, -60), Vector3(30, 50, 10));
+    const Sphere sphere(Vector3(10, -30, 20), 45);
+    PlaneBoundedVolumeList volumes(2);
+    volumes[0].planes.push_back(Plane(Vector3::UNIT_X, -20));
+    volumes[0].planes.push_back(Plane(Vector3::UNIT_Y, 10));
+    volumes[1].planes.push_back(Plane(-Vector3::UNIT_X, -30));
+    volumes[1].planes.push_back(Plane(Vector3::UNIT_Z, 0));
+
+    for (uint32 mask = 1; mask <= 3; ++mask)
+    {
+        SCOPED_TRACE(mask);
+        NameCollector expected[3], actual[3];
+        SceneManager* mgrs[2] = { mDefaultMgr, mBvhMgr };
+        NameCollector* collectors[2] = { expected, actual };
+        for (int m = 0; m < 2; ++m)
+        {
+            SceneQuery* queries[3] = {
+                mgrs[m]->createAABBQuery(box, mask),
+                mgrs[m]->createSphereQuery(sphere, mask),
+                mgrs[m]->createPlaneBoundedVolumeQuery(volumes, mask) };
+            static_cast<AxisAlignedBoxSceneQuery*>(queries[0])->execute(&collectors[m][0]);
+            static_cast<SphereSceneQuery*>(queries[1])->execute(&collectors[m][1]);
+            static_cast<PlaneBoundedVolumeListSceneQuery*>(queries[2])->execute(&collectors[m][2]);
+            for (int q = 0; q < 3; ++q)
+                mgrs[m]->destroyQuery(queries[q]);
+        }
+
+        for (int q = 0; q < 3; ++q)
+        {
+            if (mask == 3)
+            {
+                EXPECT_FALSE(expected[q].names.empty());
+            }
+            EXPECT_EQ(sorted(expected[q].names), sorted(actual[q].names));
+        }
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(BvhSceneManagerTests,RayQueryMatchesDefault)
+{
+    // Aimed at objects from outside and inside the scene
+    const Vector3 target1 = mDefaultMgr->getManualObject("Object10")->getWorldBoundingBox().getCenter();
+    const Vector3 target2 = mDefaultMgr->getManualObject("Object77")->getWorldBoundingBox().getCenter();
+    const Ray rays[] = {
+        Ray(Vector3(-150, -10, 0), (target1 - Vector3(-150, -10, 0)).normalisedCopy()),
+        Ray(Vector3::ZERO, target2.normalisedCopy()),
+        // Misses everything
+        Ray(Vector3(0, 200, 0), Vector3::UNIT_Y)
+    };
+    for (size_t r = 0; r < sizeof(rays) / sizeof(rays[0]); ++r)
+    {
+        SCOPED_TRACE(r);
+        RaySceneQuery* expectedQuery = mDefaultMgr->createRayQuery(rays[r]);
+        RaySceneQuery* actualQuery = mBvhMgr->createRayQuery(rays[r]);
+        expectedQuery->setSortByDistance(true);
+        actualQuery->setSortByDistance(true);
+
+        const RaySceneQueryResult& expected = expectedQuery->execute();
+        const RaySceneQueryResult& actual = actualQuery->execute();
+        EXPECT_EQ(r == 2, expected.empty());
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            EXPECT_EQ(expected[i].movable->getName(), actual[i].movable->getName());
+            EXPECT_FLOAT_EQ(expected[i].distance, actual[i].distance);
+        }
+
+        mDefaultMgr->destroyQuery(expectedQuery);
+        mBvhMgr->destroyQuery(actualQuery);
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(BvhSceneManagerTests,IntersectionQueryMatchesDefault)
+{
+    NameCollector expected, actual;
+    IntersectionSceneQuery* expectedQuery = mDefaultMgr->createIntersectionQuery();
+    IntersectionSceneQuery* actualQuery = mBvhMgr->createIntersectionQuery();
+    expectedQuery->execute(static_cast<IntersectionSceneQueryListener*>(&expected));
+    actualQuery->execute(static_cast<IntersectionSceneQueryListener*>(&actual));
+    mDefaultMgr->destroyQuery(expectedQuery);
+    mBvhMgr->destroyQuery(actualQuery);
+
+    EXPECT_FALSE(expected.pairs.empty());
+    // Every pair once
+    EXPECT_EQ(actual.pairs.size(), unordered(actual.pairs).size());
+    EXPECT_EQ(unordered(expected.pairs), unordered(actual.pairs));
+}
+//--------------------------------------------------------------------------
+TEST_F(BvhSceneManagerTests,IntersectionQueryIsDeterministic)
+{
+    // Same scene in another manager, so all nodes live at other addresses
+    SceneManager* otherMgr = mRoot->createSceneManager(BvhSceneManagerFactory::FACTORY_TYPE_NAME);
+    populate(otherMgr);
+
+    NameCollector first, second;
+    IntersectionSceneQuery* query = mBvhMgr->createIntersectionQuery();
+    query->execute(static_cast<IntersectionSceneQueryListener*>(&first));
+    mBvhMgr->destroyQuery(query);
+    query = otherMgr->createIntersectionQuery();
+    query->execute(static_cast<IntersectionSceneQueryListener*>(&second));
+    otherMgr->destroyQuery(query);
+    mRoot->destroySceneManager(otherMgr);
+
+    // Including the order of the objects within each pair
+    EXPECT_EQ(first.pairs, second.pairs);
+}
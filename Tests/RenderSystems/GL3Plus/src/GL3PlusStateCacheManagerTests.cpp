@@ -0,0 +1,342 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+#include "OgreGL3PlusStateCacheManager.h"
+
+using namespace Ogre;
+
+// The state cache implementation is built into the tests with the GL entry
+// points it uses replaced by stubs, which only count the calls. So no
+// context is needed.
+
+namespace {
+    typedef map<String, size_t>::type CallCountMap;
+    CallCountMap gCalls;
+
+    size_t calls(const String& name)
+    {
+        CallCountMap::const_iterator i = gCalls.find(name);
+        return i == gCalls.end() ? 0 : i->second;
+    }
+
+    size_t totalCalls()
+    {
+        size_t ret = 0;
+        for (CallCountMap::const_iterator i = gCalls.begin(); i != gCalls.end(); ++i)
+            ret += i->second;
+        return ret;
+    }
+}
+
+#define GL_STUB(name, type, params) \
+    static void APIENTRY stub##name params { ++gCalls["gl" #name]; } \
+    type gl3w##name = stub##name;
+
+GL_STUB(ActiveTexture, PFNGLACTIVETEXTUREPROC, (GLenum))
+GL_STUB(BindBuffer, PFNGLBINDBUFFERPROC, (GLenum, GLuint))
+GL_STUB(BindBufferBase, PFNGLBINDBUFFERBASEPROC, (GLenum, GLuint, GLuint))
+GL_STUB(BindFramebuffer, PFNGLBINDFRAMEBUFFERPROC, (GLenum, GLuint))
+GL_STUB(BindProgramPipeline, PFNGLBINDPROGRAMPIPELINEPROC, (GLuint))
+GL_STUB(BindRenderbuffer, PFNGLBINDRENDERBUFFERPROC, (GLenum, GLuint))
+GL_STUB(BindTexture, PFNGLBINDTEXTUREPROC, (GLenum, GLuint))
+GL_STUB(BindVertexArray, PFNGLBINDVERTEXARRAYPROC, (GLuint))
+GL_STUB(BlendEquation, PFNGLBLENDEQUATIONPROC, (GLenum))
+GL_STUB(BlendEquationSeparate, PFNGLBLENDEQUATIONSEPARATEPROC, (GLenum, GLenum))
+GL_STUB(BlendFunc, PFNGLBLENDFUNCPROC, (GLenum, GLenum))
+GL_STUB(BlendFuncSeparate, PFNGLBLENDFUNCSEPARATEPROC, (GLenum, GLenum, GLenum, GLenum))
+GL_STUB(ClearColor, PFNGLCLEARCOLORPROC, (GLfloat, GLfloat, GLfloat, GLfloat))
+GL_STUB(ClearDepth, PFNGLCLEARDEPTHPROC, (GLdouble))
+GL_STUB(ColorMask, PFNGLCOLORMASKPROC, (GLboolean, GLboolean, GLboolean, GLboolean))
+GL_STUB(CullFace, PFNGLCULLFACEPROC, (GLenum))
+GL_STUB(DeleteBuffers, PFNGLDELETEBUFFERSPROC, (GLsizei, const GLuint*))
+GL_STUB(DeleteFramebuffers, PFNGLDELETEFRAMEBUFFERSPROC, (GLsizei, const GLuint*))
+GL_STUB(DeleteProgramPipelines, PFNGLDELETEPROGRAMPIPELINESPROC, (GLsizei, const GLuint*))
+GL_STUB(DeleteRenderbuffers, PFNGLDELETERENDERBUFFERSPROC, (GLsizei, const GLuint*))
+GL_STUB(DeleteTextures, PFNGLDELETETEXTURESPROC, (GLsizei, const GLuint*))
+GL_STUB(DeleteVertexArrays, PFNGLDELETEVERTEXARRAYSPROC, (GLsizei, const GLuint*))
+GL_STUB(DepthFunc, PFNGLDEPTHFUNCPROC, (GLenum))
+GL_STUB(DepthMask, PFNGLDEPTHMASKPROC, (GLboolean))
+GL_STUB(Disable, PFNGLDISABLEPROC, (GLenum))
+GL_STUB(Enable, PFNGLENABLEPROC, (GLenum))
+GL_STUB(PolygonMode, PFNGLPOLYGONMODEPROC, (GLenum, GLenum))
+GL_STUB(PolygonOffset, PFNGLPOLYGONOFFSETPROC, (GLfloat, GLfloat))
+GL_STUB(Scissor, PFNGLSCISSORPROC, (GLint, GLint, GLsizei, GLsizei))
+GL_STUB(StencilFunc, PFNGLSTENCILFUNCPROC, (GLenum, GLint, GLuint))
+GL_STUB(StencilFuncSeparate, PFNGLSTENCILFUNCSEPARATEPROC, (GLenum, GLenum, GLint, GLuint))
+GL_STUB(StencilMask, PFNGLSTENCILMASKPROC, (GLuint))
+GL_STUB(StencilMaskSeparate, PFNGLSTENCILMASKSEPARATEPROC, (GLenum, GLuint))
+GL_STUB(StencilOp, PFNGLSTENCILOPPROC, (GLenum, GLenum, GLenum))
+GL_STUB(StencilOpSeparate, PFNGLSTENCILOPSEPARATEPROC, (GLenum, GLenum, GLenum, GLenum))
+GL_STUB(TexParameterf, PFNGLTEXPARAMETERFPROC, (GLenum, GLenum, GLfloat))
+GL_STUB(TexParameteri, PFNGLTEXPARAMETERIPROC, (GLenum, GLenum, GLint))
+GL_STUB(UseProgram, PFNGLUSEPROGRAMPROC, (GLuint))
+GL_STUB(Viewport, PFNGLVIEWPORTPROC, (GLint, GLint, GLsizei, GLsizei))
+
+#undef GL_STUB
+
+class GL3PlusStateCacheManagerTests : public ::testing::Test
+{
+public:
+    GL3PlusStateCacheManager* mCache;
+
+    void SetUp()
+    {
+        mCache = OGRE_NEW GL3PlusStateCacheManager();
+        mCache->initializeCache();
+        mCache->resetStats();
+        gCalls.clear();
+    }
+
+    void TearDown()
+    {
+        OGRE_DELETE mCache;
+    }
+
+    size_t issued(GL3PlusStateCacheManager::StateCategory category) const
+    {
+        return mCache->getStats().issuedCalls[category];
+    }
+
+    size_t redundant(GL3PlusStateCacheManager::StateCategory category) const
+    {
+        return mCache->getStats().redundantCalls[category];
+    }
+};
+//--------------------------------------------------------------------------
+TEST_F(GL3PlusStateCacheManagerTests,InitialStateIsNotSetAgain)
+{
+    // initializeCache has put GL in the cached default state
+    mCache->setBlendFunc(GL_ONE, GL_ZERO);
+    mCache->setBlendEquation(GL_FUNC_ADD);
+    mCache->setDepthMask(GL_TRUE);
+    mCache->setDepthFunc(GL_LESS);
+    mCache->setCullFace(GL_BACK);
+    mCache->setPolygonMode(GL_FILL);
+    mCache->setColourMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    mCache->setClearColour(0, 0, 0, 0);
+    mCache->setStencilMask(0xFFFFFFFF);
+    mCache->setStencilFunc(GL_ALWAYS, 0, 0xFFFFFFFF);
+    mCache->setStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    mCache->bindGLProgram(0);
+    mCache->bindGLVertexArray(0);
+
+    EXPECT_EQ(0u, totalCalls());
+    EXPECT_EQ(4u, redundant(GL3PlusStateCacheManager::SCC_BLEND));
+    EXPECT_EQ(3u, redundant(GL3PlusStateCacheManager::SCC_STENCIL));
+    EXPECT_EQ(0u, issued(GL3PlusStateCacheManager::SCC_BLEND));
+}
+//--------------------------------------------------------------------------
+TEST_F(GL3PlusStateCacheManagerTests,RedundantBindsAreSkipped)
+{
+    mCache->bindGLBuffer(GL_ARRAY_BUFFER, 5);
+    mCache->bindGLBuffer(GL_ARRAY_BUFFER, 5);
+    mCache->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, 5);
+    mCache->bindGLBuffer(GL_ARRAY_BUFFER, 6);
+    EXPECT_EQ(3u, calls("glBindBuffer"));
+    EXPECT_EQ(3u, issued(GL3PlusStateCacheManager::SCC_BUFFER));
+    EXPECT_EQ(1u, redundant(GL3PlusStateCacheManager::SCC_BUFFER));
+
+    // Forcing always reaches GL
+    mCache->bindGLBuffer(GL_ARRAY_BUFFER, 6, true);
+    EXPECT_EQ(4u, calls("glBindBuffer"));
+
+    mCache->bindGLBuffer(GL_FRAMEBUFFER, 2);
+    mCache->bindGLBuffer(GL_FRAMEBUFFER, 2);
+    EXPECT_EQ(1u, calls("glBindFramebuffer"));
+
+    mCache->bindGLProgram(3);
+    mCache->bindGLProgram(3);
+    mCache->bindGLProgramPipeline(4);
+    mCache->bindGLProgramPipeline(4);
+    EXPECT_EQ(1u, calls("glUseProgram"));
+    EXPECT_EQ(1u, calls("glBindProgramPipeline"));
+    EXPECT_EQ(2u, issued(GL3PlusStateCacheManager::SCC_PROGRAM));
+    EXPECT_EQ(2u, redundant(GL3PlusStateCacheManager::SCC_PROGRAM));
+
+    mCache->bindGLTexture(GL_TEXTURE_2D, 7);
+    mCache->bindGLTexture(GL_TEXTURE_2D, 7);
+    // Same name on another target is another binding
+    mCache->bindGLTexture(GL_TEXTURE_3D, 7);
+    EXPECT_EQ(2u, calls("glBindTexture"));
+    EXPECT_EQ(1u, redundant(GL3PlusStateCacheManager::SCC_TEXTURE));
+}
+//--------------------------------------------------------------------------
+TEST_F(GL3PlusStateCacheManagerTests,RedundantStateIsSkipped)
+{
+    mCache->setEnabled(GL_BLEND, true);
+    mCache->setEnabled(GL_BLEND, true);
+    mCache->setEnabled(GL_BLEND, false);
+    mCache->setEnabled(GL_BLEND, false);
+    EXPECT_EQ(1u, calls("glEnable"));
+    EXPECT_EQ(1u, calls("glDisable"));
+    EXPECT_EQ(2u, issued(GL3PlusStateCacheManager::SCC_RASTER));
+    EXPECT_EQ(2u, redundant(GL3PlusStateCacheManager::SCC_RASTER));
+
+    mCache->setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    mCache->setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    // Same colour factors, other alpha ones
+    mCache->setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ZERO);
+    EXPECT_EQ(1u, calls("glBlendFunc"));
+    EXPECT_EQ(1u, calls("glBlendFuncSeparate"));
+
+    mCache->setDepthFunc(GL_LEQUAL);
+    mCache->setDepthFunc(GL_LEQUAL);
+    mCache->setPolygonOffset(1, 2);
+    mCache->setPolygonOffset(1, 2);
+    EXPECT_EQ(1u, calls("glDepthFunc"));
+    EXPECT_EQ(1u, calls("glPolygonOffset"));
+    EXPECT_EQ(2u, issued(GL3PlusStateCacheManager::SCC_DEPTH));
+    EXPECT_EQ(2u, redundant(GL3PlusStateCacheManager::SCC_DEPTH));
+}
+//--------------------------------------------------------------------------
+TEST_F(GL3PlusStateCacheManagerTests,StencilFacesAreTrackedSeparately)
+{
+    mCache->setStencilFunc(GL_EQUAL, 1, 0xFF, GL_FRONT);
+    mCache->setStencilFunc(GL_EQUAL, 1, 0xFF, GL_FRONT);
+    EXPECT_EQ(1u, calls("glStencilFuncSeparate"));
+
+    // The back face still has the default state
+    mCache->setStencilFunc(GL_EQUAL, 1, 0xFF, GL_FRONT_AND_BACK);
+    EXPECT_EQ(2u, calls("glStencilFuncSeparate"));
+    mCache->setStencilFunc(GL_EQUAL, 1, 0xFF, GL_BACK);
+    EXPECT_EQ(2u, calls("glStencilFuncSeparate"));
+
+    mCache->setStencilOp(GL_KEEP, GL_INCR_WRAP, GL_KEEP, GL_BACK);
+    mCache->setStencilOp(GL_KEEP, GL_DECR_WRAP, GL_KEEP, GL_FRONT);
+    mCache->setStencilOp(GL_KEEP, GL_INCR_WRAP, GL_KEEP, GL_BACK);
+    EXPECT_EQ(2u, calls("glStencilOpSeparate"));
+
+    EXPECT_EQ(4u, issued(GL3PlusStateCacheManager::SCC_STENCIL));
+    EXPECT_EQ(3u, redundant(GL3PlusStateCacheManager::SCC_STENCIL));
+}
+//--------------------------------------------------------------------------
+TEST_F(GL3PlusStateCacheManagerTests,ViewportIsAlwaysSetFirst)
+{
+    // The cache can't know the viewport of a new drawable
+    mCache->setViewport(0, 0, 640, 480);
+    mCache->setViewport(0, 0, 640, 480);
+    mCache->setScissor(0, 0, 640, 480);
+    mCache->setScissor(10, 0, 630, 480);
+    EXPECT_EQ(1u, calls("glViewport"));
+    EXPECT_EQ(2u, calls("glScissor"));
+    EXPECT_EQ(3u, issued(GL3PlusStateCacheManager::SCC_VIEWPORT));
+    EXPECT_EQ(1u, redundant(GL3PlusStateCacheManager::SCC_VIEWPORT));
+
+    const GLint expected[4] = { 10, 0, 630, 480 };
+    EXPECT_TRUE(std::equal(expected, expected + 4, mCache->getScissor()));
+}
+//--------------------------------------------------------------------------
+TEST_F(GL3PlusStateCacheManagerTests,DeletingInvalidatesBindings)
+{
+    mCache->bindGLBuffer(GL_ARRAY_BUFFER, 5);
+    mCache->bindGLBuffer(GL_UNIFORM_BUFFER, 5);
+    mCache->deleteGLBuffer(GL_ARRAY_BUFFER, 5);
+    EXPECT_EQ(1u, calls("glDeleteBuffers"));
+
+    // GL unbinds the buffer from every target, so a new buffer reusing the name has to be bound
+    mCache->bindGLBuffer(GL_ARRAY_BUFFER, 5);
+    mCache->bindGLBuffer(GL_UNIFORM_BUFFER, 5);
+    EXPECT_EQ(4u, calls("glBindBuffer"));
+
+    // Indexed binds replace the generic binding
+    mCache->bindGLBufferBase(GL_UNIFORM_BUFFER, 0, 8);
+    mCache->bindGLBuffer(GL_UNIFORM_BUFFER, 5);
+    EXPECT_EQ(5u, calls("glBindBuffer"));
+
+    // The element array binding belongs to the vertex array object
+    mCache->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, 9);
+    mCache->bindGLVertexArray(1);
+    mCache->bindGLBuffer(GL_ELEMENT_ARRAY_BUFFER, 9);
+    EXPECT_EQ(7u, calls("glBindBuffer"));
+    mCache->deleteGLVertexArray(1);
+    mCache->bindGLVertexArray(0);
+    EXPECT_EQ(1u, calls("glBindVertexArray"));
+
+    mCache->bindGLTexture(GL_TEXTURE_2D, 7);
+    mCache->deleteGLTexture(7);
+    mCache->bindGLTexture(GL_TEXTURE_2D, 7);
+    EXPECT_EQ(2u, calls("glBindTexture"));
+
+    mCache->bindGLProgramPipeline(4);
+    mCache->deleteGLProgramPipeline(4);
+    mCache->bindGLProgramPipeline(4);
+    EXPECT_EQ(2u, calls("glBindProgramPipeline"));
+}
+//--------------------------------------------------------------------------
+TEST_F(GL3PlusStateCacheManagerTests,TextureParametersFollowTheTexture)
+{
+    mCache->bindGLTexture(GL_TEXTURE_2D, 7);
+    mCache->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    mCache->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    mCache->setTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_LOD_BIAS, 0.5f);
+    mCache->setTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_LOD_BIAS, 0.5f);
+    EXPECT_EQ(1u, calls("glTexParameteri"));
+    EXPECT_EQ(1u, calls("glTexParameterf"));
+
+    // Another texture has its own parameters
+    mCache->bindGLTexture(GL_TEXTURE_2D, 8);
+    mCache->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    EXPECT_EQ(2u, calls("glTexParameteri"));
+
+    // Back on the first one, which still has them
+    mCache->bindGLTexture(GL_TEXTURE_2D, 7);
+    mCache->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    EXPECT_EQ(2u, calls("glTexParameteri"));
+
+    // Unless it has been invalidated
+    mCache->invalidateStateForTexture(7);
+    mCache->bindGLTexture(GL_TEXTURE_2D, 7);
+    mCache->setTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    EXPECT_EQ(3u, calls("glTexParameteri"));
+
+    // Parameters for a target with nothing known bound always reach GL
+    mCache->setTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    mCache->setTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    EXPECT_EQ(5u, calls("glTexParameteri"));
+}
+//--------------------------------------------------------------------------
+TEST_F(GL3PlusStateCacheManagerTests,ClearingForgetsEverything)
+{
+    mCache->bindGLBuffer(GL_ARRAY_BUFFER, 5);
+    mCache->setEnabled(GL_DEPTH_TEST, true);
+    mCache->setDepthFunc(GL_GREATER);
+    mCache->clearCache();
+    gCalls.clear();
+
+    mCache->bindGLBuffer(GL_ARRAY_BUFFER, 5);
+    mCache->setEnabled(GL_DEPTH_TEST, true);
+    mCache->setDepthFunc(GL_GREATER);
+    EXPECT_EQ(3u, totalCalls());
+
+    mCache->resetStats();
+    for (int i = 0; i < GL3PlusStateCacheManager::SCC_COUNT; ++i)
+    {
+        EXPECT_EQ(0u, mCache->getStats().issuedCalls[i]);
+        EXPECT_EQ(0u, mCache->getStats().redundantCalls[i]);
+    }
+}